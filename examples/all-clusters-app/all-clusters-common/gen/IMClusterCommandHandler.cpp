@@ -28,6 +28,7 @@
 #include "util.h"
 
 #include <app/InteractionModelEngine.h>
+#include <app/util/ClusterDispatchTable.h>
 
 // Currently we need some work to keep compatible with ember lib.
 #include <util/ember-compatibility-functions.h>
@@ -2496,64 +2497,50 @@ void DispatchServerCommand(app::Command * command, CommandId commandId, Endpoint
 
 } // namespace clusters
 
+namespace {
+
+using ServerCommandDispatcher = void (*)(app::Command *, CommandId, EndpointId, TLV::TLVReader &);
+
+constexpr ClusterDispatchEntry<ServerCommandDispatcher> kServerClusterEntries[] = {
+    { ZCL_BARRIER_CONTROL_CLUSTER_ID, clusters::BarrierControl::DispatchServerCommand },
+    { ZCL_BASIC_CLUSTER_ID, clusters::Basic::DispatchServerCommand },
+    { ZCL_BINDING_CLUSTER_ID, clusters::Binding::DispatchServerCommand },
+    { ZCL_COLOR_CONTROL_CLUSTER_ID, clusters::ColorControl::DispatchServerCommand },
+    { ZCL_CONTENT_LAUNCH_CLUSTER_ID, clusters::ContentLaunch::DispatchServerCommand },
+    { ZCL_DOOR_LOCK_CLUSTER_ID, clusters::DoorLock::DispatchServerCommand },
+    { ZCL_GENERAL_COMMISSIONING_CLUSTER_ID, clusters::GeneralCommissioning::DispatchServerCommand },
+    { ZCL_GROUPS_CLUSTER_ID, clusters::Groups::DispatchServerCommand },
+    { ZCL_IAS_ZONE_CLUSTER_ID, clusters::IasZone::DispatchServerCommand },
+    { ZCL_IDENTIFY_CLUSTER_ID, clusters::Identify::DispatchServerCommand },
+    { ZCL_LEVEL_CONTROL_CLUSTER_ID, clusters::LevelControl::DispatchServerCommand },
+    { ZCL_LOW_POWER_CLUSTER_ID, clusters::LowPower::DispatchServerCommand },
+    { ZCL_MEDIA_PLAYBACK_CLUSTER_ID, clusters::MediaPlayback::DispatchServerCommand },
+    { ZCL_ON_OFF_CLUSTER_ID, clusters::OnOff::DispatchServerCommand },
+    { ZCL_SCENES_CLUSTER_ID, clusters::Scenes::DispatchServerCommand },
+    EndOfClusterDispatchTable<ServerCommandDispatcher>(),
+};
+
+constexpr auto kServerClusters = MakeClusterDispatchTable(kServerClusterEntries);
+static_assert(kServerClusters.IsValid(), "A cluster dispatch table is not closed or lists a cluster twice");
+
+} // namespace
+
 void DispatchSingleClusterCommand(chip::ClusterId aClusterId, chip::CommandId aCommandId, chip::EndpointId aEndPointId,
                                   chip::TLV::TLVReader & aReader, Command * apCommandObj)
 {
     ChipLogDetail(Zcl, "Received Cluster Command: Cluster=%" PRIx16 " Command=%" PRIx8 " Endpoint=%" PRIx8, aClusterId, aCommandId,
                   aEndPointId);
     Compatibility::SetupEmberAfObjects(apCommandObj, aClusterId, aCommandId, aEndPointId);
-    switch (aClusterId)
+    const ClusterDispatchEntry<ServerCommandDispatcher> * cluster = kServerClusters.Find(aClusterId);
+    if (cluster != nullptr)
+    {
+        cluster->mHandler(apCommandObj, aCommandId, aEndPointId, aReader);
+    }
+    else
     {
-    case ZCL_BARRIER_CONTROL_CLUSTER_ID:
-        clusters::BarrierControl::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_BASIC_CLUSTER_ID:
-        clusters::Basic::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_BINDING_CLUSTER_ID:
-        clusters::Binding::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_COLOR_CONTROL_CLUSTER_ID:
-        clusters::ColorControl::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_CONTENT_LAUNCH_CLUSTER_ID:
-        clusters::ContentLaunch::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_DOOR_LOCK_CLUSTER_ID:
-        clusters::DoorLock::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_GENERAL_COMMISSIONING_CLUSTER_ID:
-        clusters::GeneralCommissioning::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_GROUPS_CLUSTER_ID:
-        clusters::Groups::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_IAS_ZONE_CLUSTER_ID:
-        clusters::IasZone::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_IDENTIFY_CLUSTER_ID:
-        clusters::Identify::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_LEVEL_CONTROL_CLUSTER_ID:
-        clusters::LevelControl::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_LOW_POWER_CLUSTER_ID:
-        clusters::LowPower::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_MEDIA_PLAYBACK_CLUSTER_ID:
-        clusters::MediaPlayback::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_ON_OFF_CLUSTER_ID:
-        clusters::OnOff::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    case ZCL_SCENES_CLUSTER_ID:
-        clusters::Scenes::DispatchServerCommand(apCommandObj, aCommandId, aEndPointId, aReader);
-        break;
-    default:
         // Unrecognized cluster ID, error status will apply.
         // TODO: Encode response for Cluster not found
         ChipLogError(Zcl, "Unknown cluster %" PRIx16, aClusterId);
-        break;
     }
     Compatibility::ResetEmberAfObjects();
 }
@@ -26,6 +26,8 @@
 #include "command-id.h"
 #include "util.h"
 
+#include <app/util/ClusterDispatchTable.h>
+
 using namespace chip;
 
 EmberAfStatus emberAfApplicationBasicClusterServerCommandParse(EmberAfClusterCommand * cmd);
@@ -66,84 +68,65 @@ static EmberAfStatus status(bool wasHandled, bool clusterExists, bool mfgSpecifi
     }
 }
 
+// A cluster without enabled commands has a null parser.
+using ClusterCommandParser = EmberAfStatus (*)(EmberAfClusterCommand * cmd);
+
+static constexpr app::ClusterDispatchEntry<ClusterCommandParser> kClientClusterEntries[] = {
+    app::EndOfClusterDispatchTable<ClusterCommandParser>(),
+};
+
+static constexpr app::ClusterDispatchEntry<ClusterCommandParser> kServerClusterEntries[] = {
+    { ZCL_APPLICATION_BASIC_CLUSTER_ID, nullptr },
+    { ZCL_BARRIER_CONTROL_CLUSTER_ID, emberAfBarrierControlClusterServerCommandParse },
+    { ZCL_BASIC_CLUSTER_ID, emberAfBasicClusterServerCommandParse },
+    { ZCL_BINDING_CLUSTER_ID, emberAfBindingClusterServerCommandParse },
+    { ZCL_COLOR_CONTROL_CLUSTER_ID, emberAfColorControlClusterServerCommandParse },
+    { ZCL_CONTENT_LAUNCH_CLUSTER_ID, emberAfContentLaunchClusterServerCommandParse },
+    { ZCL_DOOR_LOCK_CLUSTER_ID, emberAfDoorLockClusterServerCommandParse },
+    { ZCL_GENERAL_COMMISSIONING_CLUSTER_ID, emberAfGeneralCommissioningClusterServerCommandParse },
+    { ZCL_GROUPS_CLUSTER_ID, emberAfGroupsClusterServerCommandParse },
+    { ZCL_IAS_ZONE_CLUSTER_ID, emberAfIasZoneClusterServerCommandParse },
+    { ZCL_IDENTIFY_CLUSTER_ID, emberAfIdentifyClusterServerCommandParse },
+    { ZCL_LEVEL_CONTROL_CLUSTER_ID, emberAfLevelControlClusterServerCommandParse },
+    { ZCL_LOW_POWER_CLUSTER_ID, emberAfLowPowerClusterServerCommandParse },
+    { ZCL_MEDIA_PLAYBACK_CLUSTER_ID, emberAfMediaPlaybackClusterServerCommandParse },
+    { ZCL_ON_OFF_CLUSTER_ID, emberAfOnOffClusterServerCommandParse },
+    { ZCL_SCENES_CLUSTER_ID, emberAfScenesClusterServerCommandParse },
+    { ZCL_TEMP_MEASUREMENT_CLUSTER_ID, nullptr },
+    app::EndOfClusterDispatchTable<ClusterCommandParser>(),
+};
+
+static constexpr auto kClientClusters = app::MakeClusterDispatchTable(kClientClusterEntries);
+static constexpr auto kServerClusters = app::MakeClusterDispatchTable(kServerClusterEntries);
+static_assert(kClientClusters.IsValid(), "A client cluster dispatch table is not closed or lists a cluster twice");
+static_assert(kServerClusters.IsValid(), "A server cluster dispatch table is not closed or lists a cluster twice");
+
 // Main command parsing controller.
 EmberAfStatus emberAfClusterSpecificCommandParse(EmberAfClusterCommand * cmd)
 {
-    EmberAfStatus result = status(false, false, cmd->mfgSpecific);
+    const app::ClusterDispatchEntry<ClusterCommandParser> * cluster = nullptr;
     if (cmd->direction == (uint8_t) ZCL_DIRECTION_SERVER_TO_CLIENT &&
         emberAfContainsClientWithMfgCode(cmd->apsFrame->destinationEndpoint, cmd->apsFrame->clusterId, cmd->mfgCode))
     {
-        switch (cmd->apsFrame->clusterId)
-        {
-        default:
-            // Unrecognized cluster ID, error status will apply.
-            break;
-        }
+        cluster = kClientClusters.Find(cmd->apsFrame->clusterId);
     }
     else if (cmd->direction == (uint8_t) ZCL_DIRECTION_CLIENT_TO_SERVER &&
              emberAfContainsServerWithMfgCode(cmd->apsFrame->destinationEndpoint, cmd->apsFrame->clusterId, cmd->mfgCode))
     {
-        switch (cmd->apsFrame->clusterId)
-        {
-        case ZCL_APPLICATION_BASIC_CLUSTER_ID:
-            // No commands are enabled for cluster Application Basic
-            result = status(false, true, cmd->mfgSpecific);
-            break;
-        case ZCL_BARRIER_CONTROL_CLUSTER_ID:
-            result = emberAfBarrierControlClusterServerCommandParse(cmd);
-            break;
-        case ZCL_BASIC_CLUSTER_ID:
-            result = emberAfBasicClusterServerCommandParse(cmd);
-            break;
-        case ZCL_BINDING_CLUSTER_ID:
-            result = emberAfBindingClusterServerCommandParse(cmd);
-            break;
-        case ZCL_COLOR_CONTROL_CLUSTER_ID:
-            result = emberAfColorControlClusterServerCommandParse(cmd);
-            break;
-        case ZCL_CONTENT_LAUNCH_CLUSTER_ID:
-            result = emberAfContentLaunchClusterServerCommandParse(cmd);
-            break;
-        case ZCL_DOOR_LOCK_CLUSTER_ID:
-            result = emberAfDoorLockClusterServerCommandParse(cmd);
-            break;
-        case ZCL_GENERAL_COMMISSIONING_CLUSTER_ID:
-            result = emberAfGeneralCommissioningClusterServerCommandParse(cmd);
-            break;
-        case ZCL_GROUPS_CLUSTER_ID:
-            result = emberAfGroupsClusterServerCommandParse(cmd);
-            break;
-        case ZCL_IAS_ZONE_CLUSTER_ID:
-            result = emberAfIasZoneClusterServerCommandParse(cmd);
-            break;
-        case ZCL_IDENTIFY_CLUSTER_ID:
-            result = emberAfIdentifyClusterServerCommandParse(cmd);
-            break;
-        case ZCL_LEVEL_CONTROL_CLUSTER_ID:
-            result = emberAfLevelControlClusterServerCommandParse(cmd);
-            break;
-        case ZCL_LOW_POWER_CLUSTER_ID:
-            result = emberAfLowPowerClusterServerCommandParse(cmd);
-            break;
-        case ZCL_MEDIA_PLAYBACK_CLUSTER_ID:
-            result = emberAfMediaPlaybackClusterServerCommandParse(cmd);
-            break;
-        case ZCL_ON_OFF_CLUSTER_ID:
-            result = emberAfOnOffClusterServerCommandParse(cmd);
-            break;
-        case ZCL_SCENES_CLUSTER_ID:
-            result = emberAfScenesClusterServerCommandParse(cmd);
-            break;
-        case ZCL_TEMP_MEASUREMENT_CLUSTER_ID:
-            // No commands are enabled for cluster Temperature Measurement
-            result = status(false, true, cmd->mfgSpecific);
-            break;
-        default:
-            // Unrecognized cluster ID, error status will apply.
-            break;
-        }
+        cluster = kServerClusters.Find(cmd->apsFrame->clusterId);
+    }
+
+    if (cluster == nullptr)
+    {
+        // Unrecognized cluster ID, error status will apply.
+        return status(false, false, cmd->mfgSpecific);
+    }
+    if (cluster->mHandler == nullptr)
+    {
+        // No commands are enabled for the cluster.
+        return status(false, true, cmd->mfgSpecific);
     }
-    return result;
+    return cluster->mHandler(cmd);
 }
 
 // Cluster specific command parsing
@@ -21,6 +21,7 @@
 
 #include "af.h"
 #include "gen/attribute-id.h"
+#include "gen/attribute-type.h"
 #include "gen/cluster-id.h"
 #include <app/chip-zcl-zpro-codec.h>
 #include <app/util/af-types.h>
@@ -37,6 +38,7 @@
 #include "Server.h"
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
 using namespace chip;
@@ -44,6 +46,116 @@ using namespace chip::Inet;
 using namespace chip::Transport;
 using namespace chip::DeviceLayer;
 
+namespace {
+
+// The bridged lights take the dynamic endpoints, numbered after the fixed ones.
+constexpr uint8_t kNumBridgedLights               = CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT;
+constexpr EndpointId kFirstBridgedLightEndpointId = FIXED_ENDPOINT_COUNT;
+constexpr uint16_t kOnOffLightDeviceId            = 0x0100;
+constexpr uint8_t kOnOffLightDeviceVersion        = 1;
+constexpr uint16_t kOnOffClusterRevision          = 2;
+
+static_assert(kNumBridgedLights > 0, "The bridge needs dynamic endpoints for its bridged lights");
+
+// Every bridged light has the same clusters. Their attributes are served from the state the bridge
+// keeps for the light, so they take no room in the attribute storage.
+EmberAfAttributeMetadata bridgedOnOffAttributes[] = {
+    { ZCL_ON_OFF_ATTRIBUTE_ID, ZCL_BOOLEAN_ATTRIBUTE_TYPE, 1, ATTRIBUTE_MASK_EXTERNAL_STORAGE, { (uint8_t *) 0x00 } },
+    { ZCL_CLUSTER_REVISION_SERVER_ATTRIBUTE_ID, ZCL_INT16U_ATTRIBUTE_TYPE, 2, ATTRIBUTE_MASK_EXTERNAL_STORAGE, { (uint8_t *) 2 } },
+};
+
+EmberAfCluster bridgedLightClusters[] = {
+    { ZCL_ON_OFF_CLUSTER_ID, bridgedOnOffAttributes, ArraySize(bridgedOnOffAttributes), 0, CLUSTER_MASK_SERVER, nullptr },
+};
+
+EmberAfEndpointType bridgedLightEndpointType = { bridgedLightClusters, ArraySize(bridgedLightClusters), 0 };
+
+/**
+ *  The state of a bridged light, which serves the On/Off cluster of its endpoint.
+ */
+class BridgedLight : public EmberAfAttributeAccessor
+{
+public:
+    explicit BridgedLight(EndpointId endpoint) : EmberAfAttributeAccessor(endpoint, ZCL_ON_OFF_CLUSTER_ID) {}
+
+    void ReadAttributes(EndpointId endpoint, EmberAfAttributeReadRecord * records, uint16_t count) override
+    {
+        for (uint16_t i = 0; i < count; i++)
+        {
+            EmberAfAttributeReadRecord & record = records[i];
+            const uint8_t on                    = mOn ? 1 : 0;
+
+            if (record.metadata == nullptr)
+            {
+                continue;
+            }
+
+            switch (record.attributeId)
+            {
+            case ZCL_ON_OFF_ATTRIBUTE_ID:
+                record.status = CopyValue(record, &on, sizeof(on));
+                break;
+            case ZCL_CLUSTER_REVISION_SERVER_ATTRIBUTE_ID:
+                record.status = CopyValue(record, &kOnOffClusterRevision, sizeof(kOnOffClusterRevision));
+                break;
+            default:
+                record.status = EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
+                break;
+            }
+        }
+    }
+
+    EmberAfStatus WriteAttribute(EndpointId endpoint, EmberAfAttributeMetadata * metadata, uint8_t * buffer) override
+    {
+        if (metadata->attributeId != ZCL_ON_OFF_ATTRIBUTE_ID)
+        {
+            return EMBER_ZCL_STATUS_READ_ONLY;
+        }
+        mOn = (buffer[0] != 0);
+        return EMBER_ZCL_STATUS_SUCCESS;
+    }
+
+private:
+    static EmberAfStatus CopyValue(EmberAfAttributeReadRecord & record, const void * value, uint16_t size)
+    {
+        if (record.bufferSize < size)
+        {
+            return EMBER_ZCL_STATUS_INSUFFICIENT_SPACE;
+        }
+        memcpy(record.buffer, value, size);
+        return EMBER_ZCL_STATUS_SUCCESS;
+    }
+
+    bool mOn = false;
+};
+
+BridgedLight * bridgedLights[kNumBridgedLights];
+
+void AddBridgedLights()
+{
+    for (uint8_t i = 0; i < kNumBridgedLights; i++)
+    {
+        EndpointId endpoint = static_cast<EndpointId>(kFirstBridgedLightEndpointId + i);
+        EmberAfStatus status;
+
+        bridgedLights[i] = chip::Platform::New<BridgedLight>(endpoint);
+        if (bridgedLights[i] == nullptr || !emberAfRegisterAttributeAccessor(bridgedLights[i]))
+        {
+            ChipLogError(DeviceLayer, "Failed to create bridged light on endpoint %d", endpoint);
+            continue;
+        }
+
+        status = emberAfSetDynamicEndpoint(i, endpoint, &bridgedLightEndpointType, kOnOffLightDeviceId, kOnOffLightDeviceVersion,
+                                           nullptr);
+        if (status != EMBER_ZCL_STATUS_SUCCESS)
+        {
+            ChipLogError(DeviceLayer, "Failed to add bridged light on endpoint %d: 0x%02x", endpoint, status);
+        }
+    }
+}
+
+} // namespace
+
 void emberAfPostAttributeChangeCallback(EndpointId endpoint, ClusterId clusterId, AttributeId attributeId, uint8_t mask,
                                         uint16_t manufacturerCode, uint8_t type, uint8_t size, uint8_t * value)
 {
@@ -59,6 +171,12 @@ void emberAfPostAttributeChangeCallback(EndpointId endpoint, ClusterId clusterId
         return;
     }
 
+    if (endpoint >= kFirstBridgedLightEndpointId)
+    {
+        ChipLogProgress(Zcl, "Bridged light on endpoint %d turned %s", endpoint, *value ? "on" : "off");
+        return;
+    }
+
     if (*value)
     {
         LightingMgr().InitiateAction(LightingManager::ON_ACTION);
@@ -179,8 +297,12 @@ int main(int argc, char * argv[])
     // Init ZCL Data Model and CHIP App Server
     InitServer();
 
+    AddBridgedLights();
+
     chip::DeviceLayer::PlatformMgr().RunEventLoop();
 
+    ShutdownServer();
+
 exit:
     if (err != CHIP_NO_ERROR)
     {
@@ -28,6 +28,7 @@
 #include "util.h"
 
 #include <app/InteractionModelEngine.h>
+#include <app/util/ClusterDispatchTable.h>
 
 // Currently we need some work to keep compatible with ember lib.
 #include <util/ember-compatibility-functions.h>
@@ -1412,19 +1413,35 @@ void DispatchClientCommand(app::Command * command, CommandId commandId, Endpoint
 
 } // namespace clusters
 
+namespace {
+
+using ServerCommandDispatcher = void (*)(app::Command *, CommandId, EndpointId, TLV::TLVReader &);
+
+constexpr ClusterDispatchEntry<ServerCommandDispatcher> kServerClusterEntries[] = {
+    EndOfClusterDispatchTable<ServerCommandDispatcher>(),
+};
+
+constexpr auto kServerClusters = MakeClusterDispatchTable(kServerClusterEntries);
+static_assert(kServerClusters.IsValid(), "A cluster dispatch table is not closed or lists a cluster twice");
+
+} // namespace
+
 void DispatchSingleClusterCommand(chip::ClusterId aClusterId, chip::CommandId aCommandId, chip::EndpointId aEndPointId,
                                   chip::TLV::TLVReader & aReader, Command * apCommandObj)
 {
     ChipLogDetail(Zcl, "Received Cluster Command: Cluster=%" PRIx16 " Command=%" PRIx8 " Endpoint=%" PRIx8, aClusterId, aCommandId,
                   aEndPointId);
     Compatibility::SetupEmberAfObjects(apCommandObj, aClusterId, aCommandId, aEndPointId);
-    switch (aClusterId)
+    const ClusterDispatchEntry<ServerCommandDispatcher> * cluster = kServerClusters.Find(aClusterId);
+    if (cluster != nullptr)
+    {
+        cluster->mHandler(apCommandObj, aCommandId, aEndPointId, aReader);
+    }
+    else
     {
-    default:
         // Unrecognized cluster ID, error status will apply.
         // TODO: Encode response for Cluster not found
         ChipLogError(Zcl, "Unknown cluster %" PRIx16, aClusterId);
-        break;
     }
     Compatibility::ResetEmberAfObjects();
 }
@@ -26,6 +26,8 @@
 #include "command-id.h"
 #include "util.h"
 
+#include <app/util/ClusterDispatchTable.h>
+
 using namespace chip;
 
 EmberAfStatus emberAfApplicationBasicClusterClientCommandParse(EmberAfClusterCommand * cmd);
@@ -65,88 +67,64 @@ static EmberAfStatus status(bool wasHandled, bool clusterExists, bool mfgSpecifi
     }
 }
 
+// A cluster without enabled commands has a null parser.
+using ClusterCommandParser = EmberAfStatus (*)(EmberAfClusterCommand * cmd);
+
+static constexpr app::ClusterDispatchEntry<ClusterCommandParser> kClientClusterEntries[] = {
+    { ZCL_APPLICATION_BASIC_CLUSTER_ID, nullptr },
+    { ZCL_BARRIER_CONTROL_CLUSTER_ID, nullptr },
+    { ZCL_BASIC_CLUSTER_ID, nullptr },
+    { ZCL_BINDING_CLUSTER_ID, nullptr },
+    { ZCL_COLOR_CONTROL_CLUSTER_ID, nullptr },
+    { ZCL_CONTENT_LAUNCH_CLUSTER_ID, emberAfContentLaunchClusterClientCommandParse },
+    { ZCL_DOOR_LOCK_CLUSTER_ID, emberAfDoorLockClusterClientCommandParse },
+    { ZCL_GENERAL_COMMISSIONING_CLUSTER_ID, emberAfGeneralCommissioningClusterClientCommandParse },
+    { ZCL_GROUPS_CLUSTER_ID, emberAfGroupsClusterClientCommandParse },
+    { ZCL_IDENTIFY_CLUSTER_ID, emberAfIdentifyClusterClientCommandParse },
+    { ZCL_LEVEL_CONTROL_CLUSTER_ID, nullptr },
+    { ZCL_LOW_POWER_CLUSTER_ID, nullptr },
+    { ZCL_MEDIA_PLAYBACK_CLUSTER_ID, emberAfMediaPlaybackClusterClientCommandParse },
+    { ZCL_ON_OFF_CLUSTER_ID, nullptr },
+    { ZCL_SCENES_CLUSTER_ID, emberAfScenesClusterClientCommandParse },
+    { ZCL_TEMP_MEASUREMENT_CLUSTER_ID, nullptr },
+    app::EndOfClusterDispatchTable<ClusterCommandParser>(),
+};
+
+static constexpr app::ClusterDispatchEntry<ClusterCommandParser> kServerClusterEntries[] = {
+    app::EndOfClusterDispatchTable<ClusterCommandParser>(),
+};
+
+static constexpr auto kClientClusters = app::MakeClusterDispatchTable(kClientClusterEntries);
+static constexpr auto kServerClusters = app::MakeClusterDispatchTable(kServerClusterEntries);
+static_assert(kClientClusters.IsValid(), "A client cluster dispatch table is not closed or lists a cluster twice");
+static_assert(kServerClusters.IsValid(), "A server cluster dispatch table is not closed or lists a cluster twice");
+
 // Main command parsing controller.
 EmberAfStatus emberAfClusterSpecificCommandParse(EmberAfClusterCommand * cmd)
 {
-    EmberAfStatus result = status(false, false, cmd->mfgSpecific);
+    const app::ClusterDispatchEntry<ClusterCommandParser> * cluster = nullptr;
     if (cmd->direction == (uint8_t) ZCL_DIRECTION_SERVER_TO_CLIENT &&
         emberAfContainsClientWithMfgCode(cmd->apsFrame->destinationEndpoint, cmd->apsFrame->clusterId, cmd->mfgCode))
     {
-        switch (cmd->apsFrame->clusterId)
-        {
-        case ZCL_APPLICATION_BASIC_CLUSTER_ID:
-            // No commands are enabled for cluster Application Basic
-            result = status(false, true, cmd->mfgSpecific);
-            break;
-        case ZCL_BARRIER_CONTROL_CLUSTER_ID:
-            // No commands are enabled for cluster Barrier Control
-            result = status(false, true, cmd->mfgSpecific);
-            break;
-        case ZCL_BASIC_CLUSTER_ID:
-            // No commands are enabled for cluster Basic
-            result = status(false, true, cmd->mfgSpecific);
-            break;
-        case ZCL_BINDING_CLUSTER_ID:
-            // No commands are enabled for cluster Binding
-            result = status(false, true, cmd->mfgSpecific);
-            break;
-        case ZCL_COLOR_CONTROL_CLUSTER_ID:
-            // No commands are enabled for cluster Color Control
-            result = status(false, true, cmd->mfgSpecific);
-            break;
-        case ZCL_CONTENT_LAUNCH_CLUSTER_ID:
-            result = emberAfContentLaunchClusterClientCommandParse(cmd);
-            break;
-        case ZCL_DOOR_LOCK_CLUSTER_ID:
-            result = emberAfDoorLockClusterClientCommandParse(cmd);
-            break;
-        case ZCL_GENERAL_COMMISSIONING_CLUSTER_ID:
-            result = emberAfGeneralCommissioningClusterClientCommandParse(cmd);
-            break;
-        case ZCL_GROUPS_CLUSTER_ID:
-            result = emberAfGroupsClusterClientCommandParse(cmd);
-            break;
-        case ZCL_IDENTIFY_CLUSTER_ID:
-            result = emberAfIdentifyClusterClientCommandParse(cmd);
-            break;
-        case ZCL_LEVEL_CONTROL_CLUSTER_ID:
-            // No commands are enabled for cluster Level Control
-            result = status(false, true, cmd->mfgSpecific);
-            break;
-        case ZCL_LOW_POWER_CLUSTER_ID:
-            // No commands are enabled for cluster Low Power
-            result = status(false, true, cmd->mfgSpecific);
-            break;
-        case ZCL_MEDIA_PLAYBACK_CLUSTER_ID:
-            result = emberAfMediaPlaybackClusterClientCommandParse(cmd);
-            break;
-        case ZCL_ON_OFF_CLUSTER_ID:
-            // No commands are enabled for cluster On/off
-            result = status(false, true, cmd->mfgSpecific);
-            break;
-        case ZCL_SCENES_CLUSTER_ID:
-            result = emberAfScenesClusterClientCommandParse(cmd);
-            break;
-        case ZCL_TEMP_MEASUREMENT_CLUSTER_ID:
-            // No commands are enabled for cluster Temperature Measurement
-            result = status(false, true, cmd->mfgSpecific);
-            break;
-        default:
-            // Unrecognized cluster ID, error status will apply.
-            break;
-        }
+        cluster = kClientClusters.Find(cmd->apsFrame->clusterId);
     }
     else if (cmd->direction == (uint8_t) ZCL_DIRECTION_CLIENT_TO_SERVER &&
              emberAfContainsServerWithMfgCode(cmd->apsFrame->destinationEndpoint, cmd->apsFrame->clusterId, cmd->mfgCode))
     {
-        switch (cmd->apsFrame->clusterId)
-        {
-        default:
-            // Unrecognized cluster ID, error status will apply.
-            break;
-        }
+        cluster = kServerClusters.Find(cmd->apsFrame->clusterId);
+    }
+
+    if (cluster == nullptr)
+    {
+        // Unrecognized cluster ID, error status will apply.
+        return status(false, false, cmd->mfgSpecific);
+    }
+    if (cluster->mHandler == nullptr)
+    {
+        // No commands are enabled for the cluster.
+        return status(false, true, cmd->mfgSpecific);
     }
-    return result;
+    return cluster->mHandler(cmd);
 }
 
 // Cluster specific command parsing
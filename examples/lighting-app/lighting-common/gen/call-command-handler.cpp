@@ -26,6 +26,8 @@
 #include "command-id.h"
 #include "util.h"
 
+#include <app/util/ClusterDispatchTable.h>
+
 using namespace chip;
 
 EmberAfStatus emberAfLevelControlClusterServerCommandParse(EmberAfClusterCommand * cmd);
@@ -52,40 +54,51 @@ static EmberAfStatus status(bool wasHandled, bool clusterExists, bool mfgSpecifi
     }
 }
 
+// A cluster without enabled commands has a null parser.
+using ClusterCommandParser = EmberAfStatus (*)(EmberAfClusterCommand * cmd);
+
+static constexpr app::ClusterDispatchEntry<ClusterCommandParser> kClientClusterEntries[] = {
+    app::EndOfClusterDispatchTable<ClusterCommandParser>(),
+};
+
+static constexpr app::ClusterDispatchEntry<ClusterCommandParser> kServerClusterEntries[] = {
+    { ZCL_LEVEL_CONTROL_CLUSTER_ID, emberAfLevelControlClusterServerCommandParse },
+    { ZCL_NETWORK_COMMISSIONING_CLUSTER_ID, emberAfNetworkCommissioningClusterServerCommandParse },
+    { ZCL_ON_OFF_CLUSTER_ID, emberAfOnOffClusterServerCommandParse },
+    app::EndOfClusterDispatchTable<ClusterCommandParser>(),
+};
+
+static constexpr auto kClientClusters = app::MakeClusterDispatchTable(kClientClusterEntries);
+static constexpr auto kServerClusters = app::MakeClusterDispatchTable(kServerClusterEntries);
+static_assert(kClientClusters.IsValid(), "A client cluster dispatch table is not closed or lists a cluster twice");
+static_assert(kServerClusters.IsValid(), "A server cluster dispatch table is not closed or lists a cluster twice");
+
 // Main command parsing controller.
 EmberAfStatus emberAfClusterSpecificCommandParse(EmberAfClusterCommand * cmd)
 {
-    EmberAfStatus result = status(false, false, cmd->mfgSpecific);
+    const app::ClusterDispatchEntry<ClusterCommandParser> * cluster = nullptr;
     if (cmd->direction == (uint8_t) ZCL_DIRECTION_SERVER_TO_CLIENT &&
         emberAfContainsClientWithMfgCode(cmd->apsFrame->destinationEndpoint, cmd->apsFrame->clusterId, cmd->mfgCode))
     {
-        switch (cmd->apsFrame->clusterId)
-        {
-        default:
-            // Unrecognized cluster ID, error status will apply.
-            break;
-        }
+        cluster = kClientClusters.Find(cmd->apsFrame->clusterId);
     }
     else if (cmd->direction == (uint8_t) ZCL_DIRECTION_CLIENT_TO_SERVER &&
              emberAfContainsServerWithMfgCode(cmd->apsFrame->destinationEndpoint, cmd->apsFrame->clusterId, cmd->mfgCode))
     {
-        switch (cmd->apsFrame->clusterId)
-        {
-        case ZCL_LEVEL_CONTROL_CLUSTER_ID:
-            result = emberAfLevelControlClusterServerCommandParse(cmd);
-            break;
-        case ZCL_NETWORK_COMMISSIONING_CLUSTER_ID:
-            result = emberAfNetworkCommissioningClusterServerCommandParse(cmd);
-            break;
-        case ZCL_ON_OFF_CLUSTER_ID:
-            result = emberAfOnOffClusterServerCommandParse(cmd);
-            break;
-        default:
-            // Unrecognized cluster ID, error status will apply.
-            break;
-        }
+        cluster = kServerClusters.Find(cmd->apsFrame->clusterId);
+    }
+
+    if (cluster == nullptr)
+    {
+        // Unrecognized cluster ID, error status will apply.
+        return status(false, false, cmd->mfgSpecific);
+    }
+    if (cluster->mHandler == nullptr)
+    {
+        // No commands are enabled for the cluster.
+        return status(false, true, cmd->mfgSpecific);
     }
-    return result;
+    return cluster->mHandler(cmd);
 }
 
 // Cluster specific command parsing
@@ -196,6 +196,8 @@ int main(int argc, char * argv[])
 
     chip::DeviceLayer::PlatformMgr().RunEventLoop();
 
+    ShutdownServer();
+
 exit:
     if (err != CHIP_NO_ERROR)
     {
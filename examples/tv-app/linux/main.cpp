@@ -65,6 +65,8 @@ int main(int argc, char * argv[])
 
     chip::DeviceLayer::PlatformMgr().RunEventLoop();
 
+    ShutdownServer();
+
 exit:
     if (err != CHIP_NO_ERROR)
     {
@@ -0,0 +1,91 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the attribute paths used by the read interaction:
+ *      a path as requested, possibly with wildcards, and the concrete
+ *      attributes it resolves to.
+ *
+ */
+
+#pragma once
+
+#include <core/CHIPCore.h>
+#include <support/BitFlags.h>
+#include <util/basic-types.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * A single attribute of a single endpoint.
+ */
+struct ConcreteAttributePath
+{
+    chip::EndpointId EndpointId;
+    chip::ClusterId ClusterId;
+    chip::AttributeId FieldId;
+};
+
+/**
+ * An attribute path as found in a ReadRequest. A field that is not flagged as valid is a wildcard.
+ */
+struct AttributePathParams
+{
+    enum class Flags : uint8_t
+    {
+        kEndpointIdValid = 0x01, /**< Set when the EndpointId field is valid */
+        kClusterIdValid  = 0x02, /**< Set when the ClusterId field is valid */
+        kFieldIdValid    = 0x04, /**< Set when the FieldId field is valid */
+    };
+
+    AttributePathParams() : EndpointId(0), ClusterId(0), FieldId(0) {}
+
+    AttributePathParams(chip::EndpointId endpointId, chip::ClusterId clusterId, chip::AttributeId fieldId,
+                        const BitFlags<Flags> & flags) :
+        EndpointId(endpointId),
+        ClusterId(clusterId), FieldId(fieldId), PathFlags(flags)
+    {}
+
+    bool Matches(const ConcreteAttributePath & aPath) const
+    {
+        return (!PathFlags.Has(Flags::kEndpointIdValid) || aPath.EndpointId == EndpointId) &&
+            (!PathFlags.Has(Flags::kClusterIdValid) || aPath.ClusterId == ClusterId) &&
+            (!PathFlags.Has(Flags::kFieldIdValid) || aPath.FieldId == FieldId);
+    }
+
+    chip::EndpointId EndpointId;
+    chip::ClusterId ClusterId;
+    chip::AttributeId FieldId;
+    BitFlags<Flags> PathFlags;
+};
+
+/**
+ * The position reached while resolving an AttributePathParams, so that the resolution of a
+ * wildcard path can stop when a report is full and resume in the next one.
+ */
+struct AttributePathCursor
+{
+    uint8_t EndpointIndex   = 0;
+    uint8_t ClusterIndex    = 0;
+    uint16_t AttributeIndex = 0;
+};
+
+} // namespace app
+} // namespace chip
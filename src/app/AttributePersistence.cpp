@@ -0,0 +1,233 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the write-behind persistence of attribute values.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "AttributePersistence.h"
+
+#include <support/ErrorStr.h>
+#include <support/ReturnMacros.h>
+#include <support/logging/CHIPLogging.h>
+
+namespace chip {
+namespace app {
+
+namespace {
+AttributePersistence sAttributePersistence;
+
+bool PathEqual(const ConcreteAttributePath & aLeft, const ConcreteAttributePath & aRight)
+{
+    return aLeft.EndpointId == aRight.EndpointId && aLeft.ClusterId == aRight.ClusterId && aLeft.FieldId == aRight.FieldId;
+}
+} // namespace
+
+AttributePersistence * AttributePersistence::GetInstance()
+{
+    return &sAttributePersistence;
+}
+
+CHIP_ERROR AttributePersistence::Init(PersistentStorageDelegate * apStorage, System::Layer * apSystemLayer,
+                                      uint32_t aFlushIntervalMs)
+{
+    VerifyOrReturnError(mpStorage == nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(apStorage != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mpStorage        = apStorage;
+    mpSystemLayer    = apSystemLayer;
+    mFlushIntervalMs = aFlushIntervalMs;
+    mPendingCount    = 0;
+    return CHIP_NO_ERROR;
+}
+
+void AttributePersistence::Shutdown()
+{
+    VerifyOrReturn(mpStorage != nullptr);
+
+    CHIP_ERROR err = Flush();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DataManagement, "Dropping %u journaled attribute values: %s", static_cast<unsigned>(mPendingCount),
+                     ErrorStr(err));
+    }
+
+    if (mpSystemLayer != nullptr)
+    {
+        mpSystemLayer->CancelTimer(OnTimer, this);
+    }
+    mPendingCount = 0;
+    mpStorage     = nullptr;
+    mpSystemLayer = nullptr;
+}
+
+CHIP_ERROR AttributePersistence::Save(const ConcreteAttributePath & aPath, const uint8_t * apValue, uint16_t aSize)
+{
+    VerifyOrReturnError(mpStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    JournalEntry * entry = FindEntry(aPath);
+
+    if (aSize > sizeof(entry->mValue))
+    {
+        // A pending value must not overwrite this one at the next flush.
+        if (entry != nullptr)
+        {
+            RemoveEntry(entry);
+        }
+        return WriteValue(aPath, apValue, aSize);
+    }
+
+    if (entry == nullptr)
+    {
+        if (mPendingCount == CHIP_CONFIG_ATTRIBUTE_JOURNAL_SIZE)
+        {
+            // Values that cannot be written stay pending; when none could, this one goes straight to storage.
+            Flush();
+            if (mPendingCount == CHIP_CONFIG_ATTRIBUTE_JOURNAL_SIZE)
+            {
+                return WriteValue(aPath, apValue, aSize);
+            }
+        }
+
+        if (mPendingCount == 0 && mpSystemLayer != nullptr)
+        {
+            mpSystemLayer->StartTimer(mFlushIntervalMs, OnTimer, this);
+        }
+        entry        = &mEntries[mPendingCount++];
+        entry->mPath = aPath;
+    }
+
+    entry->mSize = aSize;
+    if (apValue != nullptr)
+    {
+        memcpy(entry->mValue, apValue, aSize);
+    }
+    else
+    {
+        // Attributes without a default value are all zeroes.
+        memset(entry->mValue, 0, aSize);
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AttributePersistence::Load(const ConcreteAttributePath & aPath, uint8_t * apValue, uint16_t aSize)
+{
+    VerifyOrReturnError(mpStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    const JournalEntry * entry = FindEntry(aPath);
+    if (entry != nullptr)
+    {
+        VerifyOrReturnError(entry->mSize == aSize, CHIP_ERROR_KEY_NOT_FOUND);
+        memcpy(apValue, entry->mValue, aSize);
+        return CHIP_NO_ERROR;
+    }
+
+    char key[kKeyLength];
+    uint16_t size = aSize;
+    MakeKey(aPath, key);
+    ReturnErrorOnFailure(mpStorage->GetKeyValue(key, apValue, size));
+    // A value of another size was saved by a build where the attribute had another type.
+    VerifyOrReturnError(size == aSize, CHIP_ERROR_KEY_NOT_FOUND);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AttributePersistence::Flush()
+{
+    CHIP_ERROR firstErr = CHIP_NO_ERROR;
+    size_t kept         = 0;
+
+    VerifyOrReturnError(mpStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    for (size_t i = 0; i < mPendingCount; i++)
+    {
+        CHIP_ERROR err = WriteValue(mEntries[i].mPath, mEntries[i].mValue, mEntries[i].mSize);
+        if (err != CHIP_NO_ERROR)
+        {
+            firstErr = (firstErr == CHIP_NO_ERROR) ? err : firstErr;
+            if (kept != i)
+            {
+                mEntries[kept] = mEntries[i];
+            }
+            kept++;
+        }
+    }
+    mPendingCount = kept;
+
+    if (mpSystemLayer != nullptr)
+    {
+        mpSystemLayer->CancelTimer(OnTimer, this);
+        if (mPendingCount > 0)
+        {
+            mpSystemLayer->StartTimer(mFlushIntervalMs, OnTimer, this);
+        }
+    }
+    return firstErr;
+}
+
+void AttributePersistence::MakeKey(const ConcreteAttributePath & aPath, char (&aKey)[kKeyLength])
+{
+    snprintf(aKey, sizeof(aKey), "a/%02X%04X%04X", aPath.EndpointId, aPath.ClusterId, aPath.FieldId);
+}
+
+void AttributePersistence::OnTimer(System::Layer * apSystemLayer, void * apAppState, System::Error aError)
+{
+    AttributePersistence * persistence = static_cast<AttributePersistence *>(apAppState);
+
+    CHIP_ERROR err = persistence->Flush();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DataManagement, "Failed to flush journaled attribute values: %s", ErrorStr(err));
+    }
+}
+
+AttributePersistence::JournalEntry * AttributePersistence::FindEntry(const ConcreteAttributePath & aPath)
+{
+    for (size_t i = 0; i < mPendingCount; i++)
+    {
+        if (PathEqual(mEntries[i].mPath, aPath))
+        {
+            return &mEntries[i];
+        }
+    }
+    return nullptr;
+}
+
+void AttributePersistence::RemoveEntry(JournalEntry * apEntry)
+{
+    // Journal order does not matter: the last entry fills the hole.
+    *apEntry = mEntries[--mPendingCount];
+}
+
+CHIP_ERROR AttributePersistence::WriteValue(const ConcreteAttributePath & aPath, const uint8_t * apValue, uint16_t aSize)
+{
+    char key[kKeyLength];
+    uint8_t zeroes[CHIP_CONFIG_ATTRIBUTE_JOURNAL_MAX_VALUE_SIZE] = { 0 };
+
+    // Attributes without a default value are all zeroes.
+    VerifyOrReturnError(apValue != nullptr || aSize <= sizeof(zeroes), CHIP_ERROR_INVALID_ARGUMENT);
+    MakeKey(aPath, key);
+    return mpStorage->SetKeyValue(key, (apValue != nullptr) ? apValue : zeroes, aSize);
+}
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,125 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the write-behind persistence of attribute values.
+ *      Saved values are journaled in memory, where a later value of the same
+ *      attribute replaces the pending one, and are written to persistent
+ *      storage when the journal is flushed: at most a flush interval after the
+ *      first pending value, when the journal fills up, or at shutdown. A light
+ *      stepping its level ten times a second thus costs one storage write per
+ *      flush interval instead of one per step.
+ *
+ */
+
+#pragma once
+
+#include <app/AttributePathParams.h>
+#include <core/CHIPCore.h>
+#include <core/CHIPPersistentStorageDelegate.h>
+#include <system/SystemLayer.h>
+
+namespace chip {
+namespace app {
+
+class AttributePersistence
+{
+public:
+    static AttributePersistence * GetInstance(void);
+
+    /**
+     *  Initialize the journal.
+     *
+     *  @param[in]    apStorage         The storage the values are written to. Only its synchronous
+     *                                  API is used.
+     *  @param[in]    apSystemLayer     The layer arming the flush timer. Without one, values are only
+     *                                  written by Flush(), when the journal is full and at Shutdown().
+     *  @param[in]    aFlushIntervalMs  The longest a value waits in the journal.
+     *
+     *  @retval #CHIP_ERROR_INCORRECT_STATE If the journal is already initialized.
+     *  @retval #CHIP_ERROR_INVALID_ARGUMENT If apStorage is null.
+     *  @retval #CHIP_NO_ERROR On success.
+     */
+    CHIP_ERROR Init(PersistentStorageDelegate * apStorage, System::Layer * apSystemLayer,
+                    uint32_t aFlushIntervalMs = CHIP_CONFIG_ATTRIBUTE_JOURNAL_FLUSH_INTERVAL_MS);
+
+    /**
+     *  Flush the journal and release the storage.
+     */
+    void Shutdown();
+
+    bool IsValid() const { return mpStorage != nullptr; }
+
+    /**
+     *  Journal the new value of an attribute, replacing its pending value if any. A value larger
+     *  than CHIP_CONFIG_ATTRIBUTE_JOURNAL_MAX_VALUE_SIZE, or one that finds the journal full even
+     *  after a flush, is written to storage right away.
+     *
+     *  @retval #CHIP_ERROR_INCORRECT_STATE If the journal is not initialized.
+     *  @retval other Errors from writing to storage.
+     */
+    CHIP_ERROR Save(const ConcreteAttributePath & aPath, const uint8_t * apValue, uint16_t aSize);
+
+    /**
+     *  Read the last saved value of an attribute, pending or already written to storage.
+     *
+     *  @retval #CHIP_ERROR_INCORRECT_STATE If the journal is not initialized.
+     *  @retval #CHIP_ERROR_KEY_NOT_FOUND If the saved value is not aSize bytes long.
+     *  @retval #CHIP_NO_ERROR On success.
+     *  @retval other Errors from reading storage, such as a missing key.
+     */
+    CHIP_ERROR Load(const ConcreteAttributePath & aPath, uint8_t * apValue, uint16_t aSize);
+
+    /**
+     *  Write every pending value to storage. Values that fail to be written stay pending.
+     *
+     *  @return The first error from writing to storage, or CHIP_NO_ERROR.
+     */
+    CHIP_ERROR Flush();
+
+    size_t GetPendingCount() const { return mPendingCount; }
+
+private:
+    struct JournalEntry
+    {
+        ConcreteAttributePath mPath;
+        uint16_t mSize;
+        uint8_t mValue[CHIP_CONFIG_ATTRIBUTE_JOURNAL_MAX_VALUE_SIZE];
+    };
+
+    // "a/" followed by the endpoint, cluster and attribute ids in hex, short enough for the
+    // 15 character keys of the most constrained key value stores.
+    static constexpr size_t kKeyLength = sizeof("a/EECCCCAAAA");
+
+    static void MakeKey(const ConcreteAttributePath & aPath, char (&aKey)[kKeyLength]);
+    static void OnTimer(System::Layer * apSystemLayer, void * apAppState, System::Error aError);
+
+    JournalEntry * FindEntry(const ConcreteAttributePath & aPath);
+    void RemoveEntry(JournalEntry * apEntry);
+    CHIP_ERROR WriteValue(const ConcreteAttributePath & aPath, const uint8_t * apValue, uint16_t aSize);
+
+    JournalEntry mEntries[CHIP_CONFIG_ATTRIBUTE_JOURNAL_SIZE];
+    size_t mPendingCount                  = 0;
+    PersistentStorageDelegate * mpStorage = nullptr;
+    System::Layer * mpSystemLayer         = nullptr;
+    uint32_t mFlushIntervalMs             = 0;
+};
+
+} // namespace app
+} // namespace chip
@@ -182,20 +182,7 @@ CHIP_ERROR Command::AddCommand(CommandParams & aCommandParams)
     {
         CommandDataElement::Builder commandDataElement =
             mInvokeCommandBuilder.GetCommandListBuilder().CreateCommandDataElementBuilder();
-        CommandPath::Builder commandPath = commandDataElement.CreateCommandPathBuilder();
-        if (aCommandParams.Flags.Has(CommandPathFlags::kEndpointIdValid))
-        {
-            commandPath.EndpointId(aCommandParams.EndpointId);
-        }
-
-        if (aCommandParams.Flags.Has(CommandPathFlags::kGroupIdValid))
-        {
-            commandPath.GroupId(aCommandParams.GroupId);
-        }
-
-        commandPath.ClusterId(aCommandParams.ClusterId).CommandId(aCommandParams.CommandId).EndOfCommandPath();
-
-        err = commandPath.GetError();
+        err = AddCommandPath(commandDataElement, aCommandParams);
         SuccessOrExit(err);
 
         if (apCommandLen > 0)
@@ -229,7 +216,7 @@ CHIP_ERROR Command::AddStatusCode(const uint16_t aGeneralCode, const uint32_t aP
     err = statusElementBuilder.Init(mInvokeCommandBuilder.GetWriter());
     SuccessOrExit(err);
 
-    statusElementBuilder.EncodeStatusElement(aGeneralCode, aProtocolId, aProtocolCode, aProtocolCode).EndOfStatusElement();
+    statusElementBuilder.EncodeStatusElement(aGeneralCode, aProtocolId, aProtocolCode, aClusterId).EndOfStatusElement();
     err = statusElementBuilder.GetError();
 
     MoveToState(CommandState::AddCommand);
@@ -239,6 +226,52 @@ exit:
     return err;
 }
 
+CHIP_ERROR Command::AddStatusCode(const CommandParams & aCommandParams, const uint16_t aGeneralCode, const uint32_t aProtocolId,
+                                  const uint16_t aProtocolCode)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    CommandDataElement::Builder commandDataElement =
+        mInvokeCommandBuilder.GetCommandListBuilder().CreateCommandDataElementBuilder();
+
+    err = AddCommandPath(commandDataElement, aCommandParams);
+    SuccessOrExit(err);
+
+    {
+        StatusElement::Builder & statusElement = commandDataElement.CreateStatusElementBuilder();
+        statusElement.EncodeStatusElement(aGeneralCode, aProtocolId, aProtocolCode, aCommandParams.ClusterId).EndOfStatusElement();
+        err = statusElement.GetError();
+        SuccessOrExit(err);
+    }
+
+    commandDataElement.EndOfCommandDataElement();
+    err = commandDataElement.GetError();
+    SuccessOrExit(err);
+
+    MoveToState(CommandState::AddCommand);
+
+exit:
+    ChipLogFunctError(err);
+    return err;
+}
+
+CHIP_ERROR Command::AddCommandPath(CommandDataElement::Builder & aCommandDataElement, const CommandParams & aCommandParams)
+{
+    CommandPath::Builder commandPath = aCommandDataElement.CreateCommandPathBuilder();
+    if (aCommandParams.Flags.Has(CommandPathFlags::kEndpointIdValid))
+    {
+        commandPath.EndpointId(aCommandParams.EndpointId);
+    }
+
+    if (aCommandParams.Flags.Has(CommandPathFlags::kGroupIdValid))
+    {
+        commandPath.GroupId(aCommandParams.GroupId);
+    }
+
+    commandPath.ClusterId(aCommandParams.ClusterId).CommandId(aCommandParams.CommandId).EndOfCommandPath();
+
+    return commandPath.GetError();
+}
+
 CHIP_ERROR Command::ClearExistingExchangeContext()
 {
     // Discard any existing exchange context. Effectively we can only have one Echo exchange with
@@ -122,6 +122,13 @@ public:
     CHIP_ERROR AddStatusCode(const uint16_t aGeneralCode, const uint32_t aProtocolId, const uint16_t aProtocolCode,
                              const chip::ClusterId aClusterId);
 
+    /**
+     * Add a CommandDataElement that only carries a status for the command at [aCommandParams], so the status of each
+     * command of a batch can be told apart in the response.
+     */
+    CHIP_ERROR AddStatusCode(const CommandParams & aCommandParams, const uint16_t aGeneralCode, const uint32_t aProtocolId,
+                             const uint16_t aProtocolCode);
+
     /**
      * Gets the inner exchange context object, without ownership.
      *
@@ -135,13 +142,17 @@ public:
 
     virtual ~Command() = default;
 
-    bool IsFree() const { return (nullptr == mpExchangeCtx); };
+    /**
+     * Whether the object can be handed out by the InteractionModelEngine: it is not initialized, or has been shut down.
+     */
+    bool IsFree() const { return mState == CommandState::Uninitialized; };
     virtual CHIP_ERROR ProcessCommandDataElement(CommandDataElement::Parser & aCommandElement) = 0;
 
 protected:
     CHIP_ERROR ClearExistingExchangeContext();
     void MoveToState(const CommandState aTargetState);
     CHIP_ERROR ProcessCommandMessage(System::PacketBufferHandle && payload, CommandRoleId aCommandRoleId);
+    CHIP_ERROR AddCommandPath(CommandDataElement::Builder & aCommandDataElement, const CommandParams & aCommandParams);
     void ClearState();
     const char * GetStateStr() const;
 
@@ -152,7 +163,7 @@ protected:
 private:
     chip::System::PacketBufferHandle mpBufHandle;
     InvokeCommand::Builder mInvokeCommandBuilder;
-    CommandState mState;
+    CommandState mState = CommandState::Uninitialized;
 
     chip::System::PacketBufferHandle mCommandDataBuf;
     chip::System::PacketBufferTLVWriter mCommandMessageWriter;
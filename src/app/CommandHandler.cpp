@@ -27,6 +27,8 @@
 #include "CommandSender.h"
 #include "InteractionModelEngine.h"
 
+#include <protocols/common/Constants.h>
+#include <support/ErrorStr.h>
 #include <support/ReturnMacros.h>
 
 namespace chip {
@@ -42,12 +44,19 @@ void CommandHandler::OnMessageReceived(Messaging::ExchangeContext * ec, const Pa
 
     mpExchangeCtx = ec;
 
+    // Every CommandDataElement of the CommandList is executed in this pass, and the responses they add are
+    // aggregated into the single response sent below.
     err = ProcessCommandMessage(std::move(payload), CommandRoleId::HandlerId);
     SuccessOrExit(err);
 
-    SendCommandResponse();
+    err = SendCommandResponse();
 
 exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        // Give the handler back to the engine's pool.
+        Shutdown();
+    }
     ChipLogFunctError(err);
 }
 
@@ -76,29 +85,42 @@ CHIP_ERROR CommandHandler::ProcessCommandDataElement(CommandDataElement::Parser
     CHIP_ERROR err = CHIP_NO_ERROR;
     CommandPath::Parser commandPath;
     chip::TLV::TLVReader commandDataReader;
-    chip::ClusterId clusterId;
-    chip::CommandId commandId;
-    chip::EndpointId endpointId;
+    CommandParams commandParams(0, 0, 0, 0, BitFlags<CommandPathFlags>(CommandPathFlags::kEndpointIdValid));
+
+    err = aCommandElement.GetCommandPath(&commandPath);
+    SuccessOrExit(err);
+
+    err = commandPath.GetClusterId(&commandParams.ClusterId);
+    SuccessOrExit(err);
 
-    ReturnErrorOnFailure(aCommandElement.GetCommandPath(&commandPath));
-    ReturnErrorOnFailure(commandPath.GetClusterId(&clusterId));
-    ReturnErrorOnFailure(commandPath.GetCommandId(&commandId));
-    ReturnErrorOnFailure(commandPath.GetEndpointId(&endpointId));
+    err = commandPath.GetCommandId(&commandParams.CommandId);
+    SuccessOrExit(err);
+
+    err = commandPath.GetEndpointId(&commandParams.EndpointId);
+    SuccessOrExit(err);
 
     err = aCommandElement.GetData(&commandDataReader);
     if (CHIP_END_OF_TLV == err)
     {
         // Empty Command, Add status code in invoke command response, notify cluster handler to hand it further.
-        err = CHIP_NO_ERROR;
-        ChipLogDetail(DataManagement, "Add Status code for empty command, cluster Id is %d", clusterId);
+        ChipLogDetail(DataManagement, "Add Status code for empty command, cluster Id is %d", commandParams.ClusterId);
         // Todo: Define ProtocolCode for StatusCode.
-        AddStatusCode(COMMON_STATUS_SUCCESS, chip::Protocols::kProtocol_Protocol_Common, 0, clusterId);
+        err = AddStatusCode(commandParams, COMMON_STATUS_SUCCESS, chip::Protocols::kProtocol_Protocol_Common, 0);
     }
     else if (CHIP_NO_ERROR == err)
     {
-        DispatchSingleClusterCommand(clusterId, commandId, endpointId, commandDataReader, this);
+        DispatchSingleClusterCommand(commandParams.ClusterId, commandParams.CommandId, commandParams.EndpointId,
+                                     commandDataReader, this);
     }
 
+exit:
+    if ((CHIP_NO_ERROR != err) && (CHIP_ERROR_BUFFER_TOO_SMALL != err) && (CHIP_ERROR_NO_MEMORY != err))
+    {
+        // A malformed command gets a failure status in its own response element; the rest of the batch still runs.
+        ChipLogError(DataManagement, "Malformed command for cluster %d: %s", commandParams.ClusterId, ErrorStr(err));
+        err = AddStatusCode(commandParams, static_cast<uint16_t>(Protocols::Common::StatusCode::InvalidArgument),
+                            chip::Protocols::kProtocol_Protocol_Common, 0);
+    }
     return err;
 }
 } // namespace app
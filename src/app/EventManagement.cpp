@@ -0,0 +1,450 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the store of the events emitted by the device.
+ *
+ */
+
+#include <cinttypes>
+
+#include "EventManagement.h"
+
+#include <app/MessageDef/EventDataElement.h>
+#include <support/ErrorStr.h>
+#include <support/ReturnMacros.h>
+#include <support/logging/CHIPLogging.h>
+#include <system/SystemLayer.h>
+
+namespace chip {
+namespace app {
+
+namespace {
+// Context tags of the fields of an event stored in a buffer.
+enum
+{
+    kTag_DeltaNumber          = 0,
+    kTag_DeltaSystemTimestamp = 1,
+    kTag_EndpointId           = 2,
+    kTag_ClusterId            = 3,
+    kTag_EventId              = 4,
+    kTag_Data                 = 5,
+};
+
+EventManagement sEventManagement;
+} // namespace
+
+EventManagement * EventManagement::GetInstance()
+{
+    return &sEventManagement;
+}
+
+CHIP_ERROR EventManagement::Init(const LogStorageResources * apResources)
+{
+    VerifyOrReturnError(!mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(apResources != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    for (size_t i = 0; i < kNumPriorityLevels; i++)
+    {
+        const LogStorageResources & resources = apResources[i];
+
+        VerifyOrReturnError(resources.mpBuffer != nullptr && resources.mBufferSize > 0, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(resources.mpIndex != nullptr && resources.mIndexSize > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    }
+
+    for (size_t i = 0; i < kNumPriorityLevels; i++)
+    {
+        mBuffers[i]            = EventBuffer();
+        mBuffers[i].mBuffer    = TLV::CHIPCircularTLVBuffer(apResources[i].mpBuffer, apResources[i].mBufferSize);
+        mBuffers[i].mpIndex    = apResources[i].mpIndex;
+        mBuffers[i].mIndexSize = apResources[i].mIndexSize;
+    }
+
+    mNextEventNumber = 0;
+    mInitialized     = true;
+    return CHIP_NO_ERROR;
+}
+
+void EventManagement::Shutdown()
+{
+    for (size_t i = 0; i < kNumPriorityLevels; i++)
+    {
+        mBuffers[i] = EventBuffer();
+    }
+    mInitialized = false;
+}
+
+CHIP_ERROR EventManagement::LogEvent(const EventOptions & aOptions, EventWriterFunct aWriter, void * apContext,
+                                     EventNumber & aEventNumber)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    uint64_t timestampMs;
+    uint32_t requiredSpace;
+    uint32_t offset;
+    bool wasEmpty;
+
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(static_cast<size_t>(aOptions.mPriority) < kNumPriorityLevels, CHIP_ERROR_INVALID_ARGUMENT);
+
+    EventBuffer & buffer = mBuffers[static_cast<size_t>(aOptions.mPriority)];
+    timestampMs          = (aOptions.mSystemTimestampMs != 0) ? aOptions.mSystemTimestampMs : System::Layer::GetClock_MonotonicMS();
+
+    // Evictions are done up front rather than by the writer, so the event that follows the evicted
+    // one can be read to rebase the buffer on it.
+    requiredSpace = min(static_cast<uint32_t>(CHIP_CONFIG_EVENT_SIZE_RESERVE), buffer.mBuffer.GetQueueSize());
+    ReturnErrorOnFailure(EnsureSpace(buffer, requiredSpace));
+
+    while (true)
+    {
+        const TLV::CHIPCircularTLVBuffer checkpoint = buffer.mBuffer;
+
+        wasEmpty = buffer.IsEmpty();
+        offset   = buffer.OffsetOf(buffer.mBuffer.QueueTail());
+
+        err = WriteEvent(buffer, aOptions, mNextEventNumber, timestampMs, aWriter, apContext);
+        if (CHIP_NO_ERROR == err)
+        {
+            break;
+        }
+
+        // Drop whatever part of the event made it into the buffer.
+        buffer.mBuffer = checkpoint;
+        VerifyOrReturnError(CHIP_ERROR_BUFFER_TOO_SMALL == err || CHIP_ERROR_NO_MEMORY == err, err);
+        VerifyOrReturnError(!buffer.IsEmpty(), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+        requiredSpace = min(buffer.mBuffer.AvailableDataLength() + CHIP_CONFIG_EVENT_SIZE_INCREMENT, buffer.mBuffer.GetQueueSize());
+        ReturnErrorOnFailure(EnsureSpace(buffer, requiredSpace));
+    }
+
+    if (wasEmpty)
+    {
+        buffer.mFirstNumber      = mNextEventNumber;
+        buffer.mFirstTimestampMs = timestampMs;
+    }
+    buffer.mLastNumber      = mNextEventNumber;
+    buffer.mLastTimestampMs = timestampMs;
+
+    if (wasEmpty || ++buffer.mUnindexedCount >= CHIP_CONFIG_EVENT_LOGGING_INDEX_STRIDE)
+    {
+        AddIndexEntry(buffer, EventIndexEntry{ mNextEventNumber, timestampMs, offset });
+        buffer.mUnindexedCount = 0;
+    }
+
+    aEventNumber = mNextEventNumber++;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR EventManagement::WriteEvent(EventBuffer & aBuffer, const EventOptions & aOptions, EventNumber aNumber,
+                                       uint64_t aTimestampMs, EventWriterFunct aWriter, void * apContext)
+{
+    TLV::TLVWriter writer;
+    TLV::TLVType outerType;
+    TLV::TLVType dataType;
+    uint64_t deltaNumber   = 0;
+    int64_t deltaTimestamp = 0;
+
+    // The first event of a buffer is an anchor: its absolute number and timestamp are kept aside.
+    if (!aBuffer.IsEmpty())
+    {
+        deltaNumber    = aNumber - aBuffer.mLastNumber;
+        deltaTimestamp = static_cast<int64_t>(aTimestampMs - aBuffer.mLastTimestampMs);
+    }
+
+    // Limiting the writer to the free space keeps it from evicting anything itself.
+    ReturnErrorOnFailure(writer.Init(aBuffer.mBuffer, aBuffer.mBuffer.AvailableDataLength()));
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag, TLV::kTLVType_Structure, outerType));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(kTag_DeltaNumber), deltaNumber));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(kTag_DeltaSystemTimestamp), deltaTimestamp));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(kTag_EndpointId), aOptions.mEndpointId));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(kTag_ClusterId), aOptions.mClusterId));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(kTag_EventId), aOptions.mEventId));
+    ReturnErrorOnFailure(writer.StartContainer(TLV::ContextTag(kTag_Data), TLV::kTLVType_Structure, dataType));
+    if (aWriter != nullptr)
+    {
+        ReturnErrorOnFailure(aWriter(writer, apContext));
+    }
+    ReturnErrorOnFailure(writer.EndContainer(dataType));
+    ReturnErrorOnFailure(writer.EndContainer(outerType));
+    return writer.Finalize();
+}
+
+CHIP_ERROR EventManagement::EnsureSpace(EventBuffer & aBuffer, uint32_t aRequiredSpace)
+{
+    while (aBuffer.mBuffer.AvailableDataLength() < aRequiredSpace)
+    {
+        VerifyOrReturnError(!aBuffer.IsEmpty(), CHIP_ERROR_BUFFER_TOO_SMALL);
+        ReturnErrorOnFailure(EvictOldestEvent(aBuffer));
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR EventManagement::EvictOldestEvent(EventBuffer & aBuffer)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    TLV::CircularTLVReader reader;
+    TLV::TLVReader dataReader;
+    EventHeader next;
+
+    reader.Init(aBuffer.mBuffer);
+    ReturnErrorOnFailure(reader.Next());
+    ReturnErrorOnFailure(reader.Skip());
+
+    // The event after the evicted one becomes the anchor of the buffer.
+    next.mNumber            = aBuffer.mFirstNumber;
+    next.mSystemTimestampMs = aBuffer.mFirstTimestampMs;
+    err                     = reader.Next();
+    if (CHIP_NO_ERROR == err)
+    {
+        err = DecodeEvent(reader, false, next, dataReader);
+    }
+    VerifyOrReturnError(CHIP_NO_ERROR == err || CHIP_END_OF_TLV == err, err);
+
+    ReturnErrorOnFailure(aBuffer.mBuffer.EvictHead());
+
+    if (aBuffer.IsEmpty())
+    {
+        aBuffer.mIndexFirst     = 0;
+        aBuffer.mIndexCount     = 0;
+        aBuffer.mUnindexedCount = 0;
+        return CHIP_NO_ERROR;
+    }
+
+    aBuffer.mFirstNumber      = next.mNumber;
+    aBuffer.mFirstTimestampMs = next.mSystemTimestampMs;
+
+    while (aBuffer.mIndexCount > 0 && aBuffer.IndexEntry(0).mNumber < aBuffer.mFirstNumber)
+    {
+        aBuffer.mIndexFirst = static_cast<uint16_t>((aBuffer.mIndexFirst + 1) % aBuffer.mIndexSize);
+        aBuffer.mIndexCount--;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void EventManagement::AddIndexEntry(EventBuffer & aBuffer, const EventIndexEntry & aEntry)
+{
+    if (aBuffer.mIndexCount == aBuffer.mIndexSize)
+    {
+        // The oldest events stay reachable from the head of the buffer.
+        aBuffer.mIndexFirst = static_cast<uint16_t>((aBuffer.mIndexFirst + 1) % aBuffer.mIndexSize);
+        aBuffer.mIndexCount--;
+    }
+
+    aBuffer.IndexEntry(aBuffer.mIndexCount) = aEntry;
+    aBuffer.mIndexCount++;
+}
+
+void EventManagement::Seek(EventBuffer & aBuffer, EventNumber aEventNumber, TLV::CHIPCircularTLVBuffer & aView,
+                           EventHeader & aHeader)
+{
+    const uint32_t headOffset = aBuffer.OffsetOf(aBuffer.mBuffer.QueueHead());
+    const uint32_t queueSize  = aBuffer.mBuffer.GetQueueSize();
+    uint32_t offset           = headOffset;
+    uint16_t low              = 0;
+    uint16_t high             = aBuffer.mIndexCount;
+
+    aHeader.mNumber            = aBuffer.mFirstNumber;
+    aHeader.mSystemTimestampMs = aBuffer.mFirstTimestampMs;
+
+    // Find the last index entry numbered aEventNumber or below.
+    while (low < high)
+    {
+        const uint16_t middle = static_cast<uint16_t>(low + (high - low) / 2);
+
+        if (aBuffer.IndexEntry(middle).mNumber <= aEventNumber)
+        {
+            low = static_cast<uint16_t>(middle + 1);
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if (low > 0)
+    {
+        const EventIndexEntry & entry = aBuffer.IndexEntry(static_cast<uint16_t>(low - 1));
+
+        aHeader.mNumber            = entry.mNumber;
+        aHeader.mSystemTimestampMs = entry.mSystemTimestampMs;
+        offset                     = entry.mOffset;
+    }
+
+    aView = TLV::CHIPCircularTLVBuffer(aBuffer.mBuffer.GetQueue(), queueSize, aBuffer.mBuffer.GetQueue() + offset,
+                                       aBuffer.mBuffer.DataLength() - (offset + queueSize - headOffset) % queueSize);
+}
+
+CHIP_ERROR EventManagement::FetchEventsSince(EventList::Builder & aEventList, PriorityLevel aPriority, EventNumber & aEventNumber,
+                                             uint32_t aMaxLength, size_t & aEventCount)
+{
+    CHIP_ERROR err          = CHIP_NO_ERROR;
+    TLV::TLVWriter * writer = aEventList.GetWriter();
+    TLV::CHIPCircularTLVBuffer view(nullptr, 0);
+    TLV::CircularTLVReader reader;
+    EventHeader header;
+    uint64_t previousTimestampMs = 0;
+    size_t encodedCount          = 0;
+    bool isAnchor                = true;
+
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(static_cast<size_t>(aPriority) < kNumPriorityLevels, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(writer != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    EventBuffer & buffer = mBuffers[static_cast<size_t>(aPriority)];
+    if (buffer.IsEmpty() || aEventNumber > buffer.mLastNumber)
+    {
+        return CHIP_END_OF_TLV;
+    }
+
+    Seek(buffer, aEventNumber, view, header);
+    header.mPriority = aPriority;
+    reader.Init(view);
+
+    while (CHIP_NO_ERROR == (err = reader.Next()))
+    {
+        TLV::TLVReader dataReader;
+        TLV::TLVWriter checkpoint;
+
+        ReturnErrorOnFailure(DecodeEvent(reader, isAnchor, header, dataReader));
+        isAnchor = false;
+
+        if (header.mNumber < aEventNumber)
+        {
+            continue;
+        }
+
+        checkpoint = *writer;
+        err        = EncodeEvent(aEventList, header, (encodedCount > 0) ? &previousTimestampMs : nullptr, dataReader);
+        if (CHIP_NO_ERROR == err && writer->GetLengthWritten() > aMaxLength)
+        {
+            err = CHIP_ERROR_BUFFER_TOO_SMALL;
+        }
+
+        if (CHIP_NO_ERROR != err)
+        {
+            // Drop the partially encoded element.
+            *writer = checkpoint;
+
+            if ((CHIP_ERROR_BUFFER_TOO_SMALL == err || CHIP_ERROR_NO_MEMORY == err) && aEventCount > 0)
+            {
+                // The list is full: this event starts the next one.
+                aEventNumber = header.mNumber;
+                return CHIP_ERROR_BUFFER_TOO_SMALL;
+            }
+
+            ChipLogError(EventLogging, "Skipping event 0x%" PRIx64 ": %s", header.mNumber, ErrorStr(err));
+            aEventNumber = header.mNumber + 1;
+            continue;
+        }
+
+        previousTimestampMs = header.mSystemTimestampMs;
+        encodedCount++;
+        aEventCount++;
+        aEventNumber = header.mNumber + 1;
+    }
+
+    return err;
+}
+
+EventNumber EventManagement::GetFirstEventNumber(PriorityLevel aPriority) const
+{
+    const EventBuffer & buffer = mBuffers[static_cast<size_t>(aPriority)];
+
+    return buffer.IsEmpty() ? mNextEventNumber : buffer.mFirstNumber;
+}
+
+CHIP_ERROR EventManagement::DecodeEvent(TLV::TLVReader & aReader, bool aIsAnchor, EventHeader & aHeader,
+                                        TLV::TLVReader & aDataReader)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    TLV::TLVType outerType;
+    uint64_t deltaNumber   = 0;
+    int64_t deltaTimestamp = 0;
+
+    VerifyOrReturnError(TLV::kTLVType_Structure == aReader.GetType(), CHIP_ERROR_WRONG_TLV_TYPE);
+    ReturnErrorOnFailure(aReader.EnterContainer(outerType));
+
+    while (CHIP_NO_ERROR == (err = aReader.Next()))
+    {
+        switch (TLV::TagNumFromTag(aReader.GetTag()))
+        {
+        case kTag_DeltaNumber:
+            ReturnErrorOnFailure(aReader.Get(deltaNumber));
+            break;
+        case kTag_DeltaSystemTimestamp:
+            ReturnErrorOnFailure(aReader.Get(deltaTimestamp));
+            break;
+        case kTag_EndpointId:
+            ReturnErrorOnFailure(aReader.Get(aHeader.mEndpointId));
+            break;
+        case kTag_ClusterId:
+            ReturnErrorOnFailure(aReader.Get(aHeader.mClusterId));
+            break;
+        case kTag_EventId:
+            ReturnErrorOnFailure(aReader.Get(aHeader.mEventId));
+            break;
+        case kTag_Data:
+            aDataReader.Init(aReader);
+            break;
+        default:
+            break;
+        }
+    }
+    VerifyOrReturnError(CHIP_END_OF_TLV == err, err);
+
+    if (!aIsAnchor)
+    {
+        aHeader.mNumber += deltaNumber;
+        aHeader.mSystemTimestampMs += static_cast<uint64_t>(deltaTimestamp);
+    }
+
+    return aReader.ExitContainer(outerType);
+}
+
+CHIP_ERROR EventManagement::EncodeEvent(EventList::Builder & aEventList, const EventHeader & aHeader,
+                                        const uint64_t * apPreviousTimestampMs, TLV::TLVReader & aDataReader)
+{
+    EventDataElement::Builder eventDataElement;
+
+    ReturnErrorOnFailure(eventDataElement.Init(aEventList.GetWriter()));
+
+    EventPath::Builder eventPath = eventDataElement.CreateEventPathBuilder();
+    eventPath.EndpointId(aHeader.mEndpointId).ClusterId(aHeader.mClusterId).EventId(aHeader.mEventId).EndOfEventPath();
+    ReturnErrorOnFailure(eventPath.GetError());
+
+    eventDataElement.PriorityLevel(static_cast<uint8_t>(aHeader.mPriority));
+    eventDataElement.Number(aHeader.mNumber);
+    if (apPreviousTimestampMs != nullptr && aHeader.mSystemTimestampMs >= *apPreviousTimestampMs)
+    {
+        eventDataElement.DeltaSystemTimestamp(aHeader.mSystemTimestampMs - *apPreviousTimestampMs);
+    }
+    else
+    {
+        eventDataElement.SystemTimestamp(aHeader.mSystemTimestampMs);
+    }
+    ReturnErrorOnFailure(eventDataElement.GetError());
+
+    ReturnErrorOnFailure(
+        eventDataElement.GetWriter()->CopyElement(TLV::ContextTag(EventDataElement::kCsTag_Data), aDataReader));
+
+    return eventDataElement.EndOfEventDataElement().GetError();
+}
+
+} // namespace app
+} // namespace chip
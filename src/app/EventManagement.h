@@ -0,0 +1,218 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the store of the events emitted by the device. Each
+ *      priority level logs into its own circular TLV buffer, so a burst of debug
+ *      events never evicts a critical one. Within a buffer, every event records
+ *      its number and system timestamp as deltas from the previous event, and a
+ *      sparse index of absolute numbers lets a reader start from any event number
+ *      after a binary search instead of a scan of the whole buffer.
+ *
+ */
+
+#pragma once
+
+#include <app/MessageDef/EventList.h>
+#include <app/util/basic-types.h>
+#include <core/CHIPCircularTLVBuffer.h>
+#include <core/CHIPCore.h>
+#include <core/CHIPEventLoggingConfig.h>
+#include <core/CHIPTLV.h>
+#include <support/CodeUtils.h>
+
+namespace chip {
+namespace app {
+
+/**
+ *  Event numbers are shared by every priority level: they increase by one with every event logged.
+ */
+typedef uint64_t EventNumber;
+
+enum class PriorityLevel : uint8_t
+{
+    Debug    = 0,
+    Info     = 1,
+    Critical = 2,
+};
+
+constexpr size_t kNumPriorityLevels = 3;
+
+struct EventOptions
+{
+    EndpointId mEndpointId  = 0;
+    ClusterId mClusterId    = 0;
+    EventId mEventId        = 0;
+    PriorityLevel mPriority = PriorityLevel::Info;
+    // System time of the event, in milliseconds. Zero stamps the event with the current time.
+    uint64_t mSystemTimestampMs = 0;
+};
+
+/**
+ *  Write the data of an event. aWriter is positioned inside the Data structure of the event.
+ */
+typedef CHIP_ERROR (*EventWriterFunct)(TLV::TLVWriter & aWriter, void * apContext);
+
+struct EventIndexEntry
+{
+    EventNumber mNumber;
+    uint64_t mSystemTimestampMs;
+    // Offset of the event in the buffer of its priority level.
+    uint32_t mOffset;
+};
+
+/**
+ *  The storage of one priority level, provided by the application. The index needs about one
+ *  entry for every CHIP_CONFIG_EVENT_LOGGING_INDEX_STRIDE events the buffer holds; when it is too
+ *  small, the oldest events are only reached by decoding from the head of the buffer.
+ */
+struct LogStorageResources
+{
+    uint8_t * mpBuffer        = nullptr;
+    uint32_t mBufferSize      = 0;
+    EventIndexEntry * mpIndex = nullptr;
+    uint16_t mIndexSize       = 0;
+};
+
+class EventManagement
+{
+public:
+    static EventManagement * GetInstance(void);
+
+    /**
+     *  Initialize the store with the storage of every priority level, indexed by PriorityLevel.
+     *
+     *  @retval #CHIP_ERROR_INCORRECT_STATE If the store is already initialized.
+     *  @retval #CHIP_ERROR_INVALID_ARGUMENT If a priority level has no buffer or no index.
+     *  @retval #CHIP_NO_ERROR On success.
+     */
+    CHIP_ERROR Init(const LogStorageResources * apResources);
+
+    void Shutdown();
+
+    bool IsValid() const { return mInitialized; }
+
+    /**
+     *  Log an event into the buffer of its priority level, evicting the oldest events of that
+     *  level as needed.
+     *
+     *  @param[in]    aOptions      The path, priority and timestamp of the event.
+     *  @param[in]    aWriter       The function writing the data of the event.
+     *  @param[in]    apContext     The context passed to aWriter.
+     *  @param[out]   aEventNumber  The number given to the event.
+     *
+     *  @retval #CHIP_ERROR_INCORRECT_STATE If the store is not initialized.
+     *  @retval #CHIP_ERROR_BUFFER_TOO_SMALL If the event does not fit even in an empty buffer.
+     *  @retval #CHIP_NO_ERROR On success.
+     */
+    CHIP_ERROR LogEvent(const EventOptions & aOptions, EventWriterFunct aWriter, void * apContext, EventNumber & aEventNumber);
+
+    /**
+     *  Append to an EventList the events of a priority level numbered aEventNumber or above, oldest
+     *  first. The first event appended carries its absolute system timestamp and the following ones
+     *  a delta from the previous one. An event that would take the length written past aMaxLength
+     *  is rolled back and ends the call, unless the list is empty: an event that does not fit even
+     *  then is left out.
+     *
+     *  @param[in]    aEventList    The list the events are appended to.
+     *  @param[in]    aPriority     The priority level to read.
+     *  @param[in,out] aEventNumber The number of the first event to append. On return, the number
+     *                              to resume from.
+     *  @param[in]    aMaxLength    The most bytes the writer of aEventList may have written.
+     *  @param[in,out] aEventCount  The number of elements already in the list, incremented for
+     *                              every event appended.
+     *
+     *  @retval #CHIP_END_OF_TLV Every event of the priority level has been appended.
+     *  @retval #CHIP_ERROR_BUFFER_TOO_SMALL The list is full and events are left to append.
+     *  @retval other Errors from decoding the buffer or writing the list.
+     */
+    CHIP_ERROR FetchEventsSince(EventList::Builder & aEventList, PriorityLevel aPriority, EventNumber & aEventNumber,
+                                uint32_t aMaxLength, size_t & aEventCount);
+
+    /**
+     *  The number of the oldest event still held for a priority level, or of the next event to be
+     *  logged when the level holds none.
+     */
+    EventNumber GetFirstEventNumber(PriorityLevel aPriority) const;
+
+    EventNumber GetNextEventNumber() const { return mNextEventNumber; }
+
+private:
+    struct EventBuffer
+    {
+        TLV::CHIPCircularTLVBuffer mBuffer = TLV::CHIPCircularTLVBuffer(nullptr, 0);
+        // Absolute number and timestamp of the oldest and of the newest event in the buffer.
+        EventNumber mFirstNumber   = 0;
+        EventNumber mLastNumber    = 0;
+        uint64_t mFirstTimestampMs = 0;
+        uint64_t mLastTimestampMs  = 0;
+        // Circular array of index entries, in increasing event number.
+        EventIndexEntry * mpIndex = nullptr;
+        uint16_t mIndexSize       = 0;
+        uint16_t mIndexFirst      = 0;
+        uint16_t mIndexCount      = 0;
+        // Events logged since the newest index entry.
+        uint16_t mUnindexedCount = 0;
+
+        bool IsEmpty() const { return mBuffer.DataLength() == 0; }
+        uint32_t OffsetOf(const uint8_t * apPosition) const
+        {
+            return static_cast<uint32_t>(apPosition - mBuffer.GetQueue()) % mBuffer.GetQueueSize();
+        }
+        EventIndexEntry & IndexEntry(uint16_t aIndex) { return mpIndex[(mIndexFirst + aIndex) % mIndexSize]; }
+    };
+
+    // The header of an event read back from a buffer.
+    struct EventHeader
+    {
+        EventNumber mNumber         = 0;
+        uint64_t mSystemTimestampMs = 0;
+        EndpointId mEndpointId      = 0;
+        ClusterId mClusterId        = 0;
+        EventId mEventId            = 0;
+        PriorityLevel mPriority     = PriorityLevel::Info;
+    };
+
+    CHIP_ERROR WriteEvent(EventBuffer & aBuffer, const EventOptions & aOptions, EventNumber aNumber, uint64_t aTimestampMs,
+                          EventWriterFunct aWriter, void * apContext);
+    CHIP_ERROR EnsureSpace(EventBuffer & aBuffer, uint32_t aRequiredSpace);
+    CHIP_ERROR EvictOldestEvent(EventBuffer & aBuffer);
+    void AddIndexEntry(EventBuffer & aBuffer, const EventIndexEntry & aEntry);
+
+    /**
+     *  Set aView to read from the last anchor at or before aEventNumber: the oldest event of the
+     *  buffer or an indexed one. aHeader holds the absolute number and timestamp of that event.
+     */
+    void Seek(EventBuffer & aBuffer, EventNumber aEventNumber, TLV::CHIPCircularTLVBuffer & aView, EventHeader & aHeader);
+
+    /**
+     *  Decode the header of the event the reader is positioned on, applying its deltas to aHeader
+     *  unless the event is an anchor, and leave aDataReader positioned on its data.
+     */
+    static CHIP_ERROR DecodeEvent(TLV::TLVReader & aReader, bool aIsAnchor, EventHeader & aHeader, TLV::TLVReader & aDataReader);
+    static CHIP_ERROR EncodeEvent(EventList::Builder & aEventList, const EventHeader & aHeader,
+                                  const uint64_t * apPreviousTimestampMs, TLV::TLVReader & aDataReader);
+
+    EventBuffer mBuffers[kNumPriorityLevels];
+    EventNumber mNextEventNumber = 0;
+    bool mInitialized            = false;
+};
+
+} // namespace app
+} // namespace chip
@@ -29,6 +29,8 @@
 #include "CommandHandler.h"
 #include "CommandSender.h"
 #include "InteractionModelEngine.h"
+#include "ReadClient.h"
+#include "ReadHandler.h"
 
 namespace chip {
 namespace app {
@@ -68,16 +70,36 @@ CHIP_ERROR InteractionModelEngine::Init(Messaging::ExchangeManager * apExchangeM
     err = mpExchangeMgr->RegisterUnsolicitedMessageHandlerForProtocol(Protocols::kProtocol_InteractionModel, this);
     SuccessOrExit(err);
 
+    err = mSubscriptionEngine.Init(apExchangeMgr);
+    SuccessOrExit(err);
+
 exit:
     return err;
 }
 
 void InteractionModelEngine::Shutdown()
 {
-    for (size_t i = 0; i < CHIP_MAX_NUM_COMMAND_HANDLER_OBJECTS; ++i)
+    for (size_t i = 0; i < CHIP_IM_MAX_NUM_COMMAND_HANDLER; ++i)
     {
         mCommandHandlerObjs[i].Shutdown();
     }
+
+    for (size_t i = 0; i < CHIP_IM_MAX_NUM_COMMAND_SENDER; ++i)
+    {
+        mCommandSenderObjs[i].Shutdown();
+    }
+
+    for (ReadHandler & readHandler : mReadHandlers)
+    {
+        readHandler.Shutdown();
+    }
+
+    for (ReadClient & readClient : mReadClients)
+    {
+        readClient.Shutdown();
+    }
+
+    mSubscriptionEngine.Shutdown();
 }
 
 CHIP_ERROR InteractionModelEngine::NewCommandSender(CommandSender ** const apComandSender)
@@ -85,13 +107,12 @@ CHIP_ERROR InteractionModelEngine::NewCommandSender(CommandSender ** const apCom
     CHIP_ERROR err  = CHIP_ERROR_NO_MEMORY;
     *apComandSender = nullptr;
 
-    for (size_t i = 0; i < CHIP_MAX_NUM_COMMAND_SENDER_OBJECTS; ++i)
+    for (size_t i = 0; i < CHIP_IM_MAX_NUM_COMMAND_SENDER; ++i)
     {
-        if (mCommandHandlerObjs[i].IsFree())
+        if (mCommandSenderObjs[i].IsFree())
         {
             *apComandSender = &mCommandSenderObjs[i];
             err             = mCommandSenderObjs[i].Init(mpExchangeMgr);
-            SuccessOrExit(err);
             if (CHIP_NO_ERROR != err)
             {
                 *apComandSender = nullptr;
@@ -105,6 +126,27 @@ exit:
     return err;
 }
 
+CHIP_ERROR InteractionModelEngine::NewReadClient(ReadClient ** const apReadClient, ReadClient::Callback * apCallback)
+{
+    CHIP_ERROR err = CHIP_ERROR_NO_MEMORY;
+    *apReadClient  = nullptr;
+
+    for (ReadClient & readClient : mReadClients)
+    {
+        if (readClient.IsFree())
+        {
+            err = readClient.Init(mpExchangeMgr, apCallback);
+            if (CHIP_NO_ERROR == err)
+            {
+                *apReadClient = &readClient;
+            }
+            break;
+        }
+    }
+
+    return err;
+}
+
 void InteractionModelEngine::OnUnknownMsgType(Messaging::ExchangeContext * apEc, const PacketHeader & aPacketHeader,
                                               const PayloadHeader & aPayloadHeader, System::PacketBufferHandle aPayload)
 {
@@ -152,7 +194,7 @@ void InteractionModelEngine::OnInvokeCommandRequest(Messaging::ExchangeContext *
         }
     }
 
-    for (size_t i = 0; i < CHIP_MAX_NUM_COMMAND_HANDLER_OBJECTS; ++i)
+    for (size_t i = 0; i < CHIP_IM_MAX_NUM_COMMAND_HANDLER; ++i)
     {
         if (mCommandHandlerObjs[i].IsFree())
         {
@@ -165,6 +207,46 @@ void InteractionModelEngine::OnInvokeCommandRequest(Messaging::ExchangeContext *
         }
     }
 
+    if (commandServer == nullptr)
+    {
+        ChipLogError(DataManagement, "No free command handler, dropping invoke request");
+    }
+
+exit:
+    ChipLogFunctError(err);
+
+    if (nullptr != apEc)
+    {
+        apEc->Abort();
+        apEc = NULL;
+    }
+}
+
+void InteractionModelEngine::OnReadRequest(Messaging::ExchangeContext * apEc, const PacketHeader & aPacketHeader,
+                                           const PayloadHeader & aPayloadHeader, System::PacketBufferHandle aPayload)
+{
+    CHIP_ERROR err            = CHIP_NO_ERROR;
+    ReadHandler * readHandler = nullptr;
+
+    for (ReadHandler & handler : mReadHandlers)
+    {
+        if (handler.IsFree())
+        {
+            readHandler = &handler;
+            err         = readHandler->Init(mpExchangeMgr);
+            SuccessOrExit(err);
+            // The handler owns the exchange from now on, even if the request turns out to be malformed.
+            err  = readHandler->OnReadRequest(apEc, std::move(aPayload));
+            apEc = nullptr;
+            break;
+        }
+    }
+
+    if (readHandler == nullptr)
+    {
+        ChipLogError(DataManagement, "No free read handler, dropping read request");
+    }
+
 exit:
     ChipLogFunctError(err);
 
@@ -182,6 +264,10 @@ void InteractionModelEngine::OnMessageReceived(Messaging::ExchangeContext * apEc
     {
         OnInvokeCommandRequest(apEc, aPacketHeader, aPayloadHeader, std::move(aPayload));
     }
+    else if (aPayloadHeader.HasMessageType(Protocols::InteractionModel::MsgType::ReadRequest))
+    {
+        OnReadRequest(apEc, aPacketHeader, aPayloadHeader, std::move(aPayload));
+    }
     else
     {
         OnUnknownMsgType(apEc, aPacketHeader, aPayloadHeader, std::move(aPayload));
@@ -206,5 +292,23 @@ DispatchSingleClusterCommand(chip::ClusterId aClusterId, chip::CommandId aComman
         "Default DispatchSingleClusterCommand is called, this should be replaced by actual dispatched for cluster commands");
 }
 
+// The default implementations for applications that do not link the ember compatibility layer: such a
+// device has no attribute to report.
+bool __attribute__((weak))
+FindNextAttribute(const AttributePathParams & aPath, AttributePathCursor & aCursor, ConcreteAttributePath & aAttribute)
+{
+    return false;
+}
+
+CHIP_ERROR __attribute__((weak))
+ReadSingleAttributeData(const ConcreteAttributePath & aPath, TLV::TLVWriter & aWriter, uint64_t aTag)
+{
+    return CHIP_ERROR_NOT_IMPLEMENTED;
+}
+
+void __attribute__((weak)) PrefetchAttributeData(const ConcreteAttributePath * apPaths, size_t aPathCount) {}
+
+void __attribute__((weak)) ReleaseAttributeData() {}
+
 } // namespace app
 } // namespace chip
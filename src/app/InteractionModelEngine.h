@@ -29,7 +29,6 @@
 #define _CHIP_INTERACTION_MODEL_ENGINE_H
 
 #include <core/CHIPCore.h>
-#include <map>
 #include <messaging/ExchangeContext.h>
 #include <messaging/ExchangeMgr.h>
 #include <messaging/Flags.h>
@@ -40,12 +39,13 @@
 #include <support/logging/CHIPLogging.h>
 #include <system/SystemPacketBuffer.h>
 
+#include <app/AttributePathParams.h>
 #include <app/Command.h>
 #include <app/CommandHandler.h>
 #include <app/CommandSender.h>
-
-#define CHIP_MAX_NUM_COMMAND_HANDLER_OBJECTS 1
-#define CHIP_MAX_NUM_COMMAND_SENDER_OBJECTS 1
+#include <app/ReadClient.h>
+#include <app/ReadHandler.h>
+#include <app/SubscriptionEngine.h>
 
 namespace chip {
 namespace app {
@@ -53,8 +53,6 @@ namespace app {
 constexpr size_t kMaxSecureSduLength  = 1024;
 constexpr uint32_t kImMesssageTimeout = 20;
 
-typedef void (*CommandCbFunct)(chip::TLV::TLVReader & aReader, Command * apCommandObj);
-
 /**
  * @class InteractionModelEngine
  *
@@ -140,20 +138,39 @@ public:
 
     void Shutdown();
 
-    CHIP_ERROR DeregisterClusterCommandHandler(chip::ClusterId aClusterId, chip::CommandId aCommandId,
-                                               Command::CommandRoleId aCommandRoleId);
-    CHIP_ERROR RegisterClusterCommandHandler(chip::ClusterId aClusterId, chip::CommandId aCommandId,
-                                             Command::CommandRoleId aCommandRoleId, CommandCbFunct aDispatcher);
-
     Messaging::ExchangeManager * GetExchangeManager(void) const { return mpExchangeMgr; };
 
+    /**
+     *  Retrieve a free CommandSender from the pool and initialize it. The sender is returned to the pool
+     *  when its owner calls CommandSender::Shutdown().
+     *
+     *  @retval #CHIP_ERROR_NO_MEMORY If every CommandSender is in use.
+     *  @retval #CHIP_NO_ERROR On success.
+     */
     CHIP_ERROR NewCommandSender(CommandSender ** const apComandSender);
 
+    /**
+     *  Retrieve a free ReadClient from the pool and initialize it. The client is returned to the pool
+     *  once its read completes or when its owner calls ReadClient::Shutdown().
+     *
+     *  @retval #CHIP_ERROR_NO_MEMORY If every ReadClient is in use.
+     *  @retval #CHIP_NO_ERROR On success.
+     */
+    CHIP_ERROR NewReadClient(ReadClient ** const apReadClient, ReadClient::Callback * apCallback);
+
+    /**
+     *  The engine reporting attribute changes to subscribers. Attribute storage calls its MarkDirty
+     *  whenever an attribute is written.
+     */
+    SubscriptionEngine & GetSubscriptionEngine() { return mSubscriptionEngine; }
+
 private:
     void OnUnknownMsgType(Messaging::ExchangeContext * apEc, const PacketHeader & aPacketHeader,
                           const PayloadHeader & aPayloadHeader, System::PacketBufferHandle aPayload);
     void OnInvokeCommandRequest(Messaging::ExchangeContext * apEc, const PacketHeader & aPacketHeader,
                                 const PayloadHeader & aPayloadHeader, System::PacketBufferHandle aPayload);
+    void OnReadRequest(Messaging::ExchangeContext * apEc, const PacketHeader & aPacketHeader, const PayloadHeader & aPayloadHeader,
+                       System::PacketBufferHandle aPayload);
     void OnMessageReceived(Messaging::ExchangeContext * apEc, const PacketHeader & aPacketHeader,
                            const PayloadHeader & aPayloadHeader, System::PacketBufferHandle aPayload);
     void OnResponseTimeout(Messaging::ExchangeContext * ec);
@@ -161,13 +178,48 @@ private:
     Messaging::ExchangeManager * mpExchangeMgr = nullptr;
     void * mpAppState                          = nullptr;
     EventCallback mEventCallback;
-    CommandHandler mCommandHandlerObjs[CHIP_MAX_NUM_COMMAND_HANDLER_OBJECTS];
-    CommandSender mCommandSenderObjs[CHIP_MAX_NUM_COMMAND_SENDER_OBJECTS];
+    CommandHandler mCommandHandlerObjs[CHIP_IM_MAX_NUM_COMMAND_HANDLER];
+    CommandSender mCommandSenderObjs[CHIP_IM_MAX_NUM_COMMAND_SENDER];
+    ReadHandler mReadHandlers[CHIP_IM_MAX_NUM_READ_HANDLER];
+    ReadClient mReadClients[CHIP_IM_MAX_NUM_READ_CLIENT];
+    SubscriptionEngine mSubscriptionEngine;
 };
 
+/**
+ *  Dispatch a received cluster command to its handler. This is implemented by the generated
+ *  IMClusterCommandHandler.cpp, which finds the cluster in a table sorted at compile time.
+ */
 void DispatchSingleClusterCommand(chip::ClusterId aClusterId, chip::CommandId aCommandId, chip::EndpointId aEndPointId,
                                   chip::TLV::TLVReader & aReader, Command * apCommandObj);
 
+/**
+ *  Resolve the next attribute covered by aPath, starting from aCursor which is advanced past it.
+ *  This is implemented by the ember compatibility layer, which walks the enabled endpoints and
+ *  their server clusters.
+ *
+ *  @return false once every attribute covered by the path has been returned.
+ */
+bool FindNextAttribute(const AttributePathParams & aPath, AttributePathCursor & aCursor, ConcreteAttributePath & aAttribute);
+
+/**
+ *  Encode the value of an attribute as the element aTag of aWriter.
+ */
+CHIP_ERROR ReadSingleAttributeData(const ConcreteAttributePath & aPath, TLV::TLVWriter & aWriter, uint64_t aTag);
+
+/**
+ *  Announce the attributes a report is about to encode with ReadSingleAttributeData, all of one
+ *  cluster on one endpoint. When the cluster is served by an attribute accessor, the ember
+ *  compatibility layer reads them with a single call to it and keeps the values until
+ *  ReleaseAttributeData() is called. This is only a hint: an attribute that was not prefetched is
+ *  read when it is encoded.
+ */
+void PrefetchAttributeData(const ConcreteAttributePath * apPaths, size_t aPathCount);
+
+/**
+ *  Drop the values kept by PrefetchAttributeData(), before they go stale.
+ */
+void ReleaseAttributeData();
+
 } // namespace app
 } // namespace chip
 
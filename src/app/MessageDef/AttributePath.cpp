@@ -151,17 +151,8 @@ CHIP_ERROR AttributePath::Parser::CheckSchemaValidity() const
     // if we have exhausted this container
     if (CHIP_END_OF_TLV == err)
     {
-        // check for required fields:
-        const uint16_t RequiredFields = (1 << kCsTag_EndpointId) | (1 << kCsTag_ClusterId);
-
-        if ((TagPresenceMask & RequiredFields) == RequiredFields)
-        {
-            err = CHIP_NO_ERROR;
-        }
-        else
-        {
-            err = CHIP_ERROR_IM_MALFORMED_ATTRIBUTE_PATH;
-        }
+        // Every field is optional: a field left out of a path in a ReadRequest is a wildcard.
+        err = CHIP_NO_ERROR;
     }
     SuccessOrExit(err);
 
@@ -0,0 +1,390 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the client side of a CHIP IM read interaction.
+ *
+ */
+
+#include "ReadClient.h"
+#include "InteractionModelEngine.h"
+
+#include <app/MessageDef/ReadRequest.h>
+#include <app/MessageDef/ReportData.h>
+#include <protocols/interaction_model/Constants.h>
+#include <system/TLVPacketBufferBackingStore.h>
+
+namespace chip {
+namespace app {
+
+CHIP_ERROR ReadClient::Init(Messaging::ExchangeManager * apExchangeMgr, Callback * apCallback)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    // Error if already initialized.
+    VerifyOrExit(mState == ClientState::Uninitialized, err = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(mpExchangeCtx == nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+
+    mpExchangeMgr = apExchangeMgr;
+    mpCallback    = apCallback;
+    MoveToState(ClientState::Initialized);
+
+exit:
+    ChipLogFunctError(err);
+    return err;
+}
+
+void ReadClient::Shutdown()
+{
+    VerifyOrExit(mState != ClientState::Uninitialized, );
+
+    ClearExistingExchangeContext();
+    mpExchangeMgr = nullptr;
+    mpCallback    = nullptr;
+    MoveToState(ClientState::Uninitialized);
+
+exit:
+    return;
+}
+
+CHIP_ERROR ReadClient::SendReadRequest(NodeId aNodeId, Transport::AdminId aAdminId, const AttributePathParams * apPaths,
+                                       size_t aPathCount)
+{
+    return SendReadRequest(aNodeId, aAdminId, apPaths, aPathCount, Optional<EventNumber>::Missing());
+}
+
+CHIP_ERROR ReadClient::SendReadRequest(NodeId aNodeId, Transport::AdminId aAdminId, const AttributePathParams * apPaths,
+                                       size_t aPathCount, EventNumber aEventNumber)
+{
+    return SendReadRequest(aNodeId, aAdminId, apPaths, aPathCount, Optional<EventNumber>::Value(aEventNumber));
+}
+
+CHIP_ERROR ReadClient::SendReadRequest(NodeId aNodeId, Transport::AdminId aAdminId, const AttributePathParams * apPaths,
+                                       size_t aPathCount, const Optional<EventNumber> & aEventNumber)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    System::PacketBufferHandle request;
+
+    VerifyOrExit(mState == ClientState::Initialized, err = CHIP_ERROR_INCORRECT_STATE);
+
+    err = BuildReadRequest(apPaths, aPathCount, aEventNumber, request);
+    SuccessOrExit(err);
+
+    // TODO: Hard code keyID to 0 to unblock IM end-to-end test. Complete solution is tracked in issue:4451
+    mpExchangeCtx = mpExchangeMgr->NewContext({ aNodeId, 0, aAdminId }, this);
+    VerifyOrExit(mpExchangeCtx != nullptr, err = CHIP_ERROR_NO_MEMORY);
+    mpExchangeCtx->SetResponseTimeout(kImMesssageTimeout);
+
+    err = mpExchangeCtx->SendMessage(Protocols::InteractionModel::MsgType::ReadRequest, std::move(request),
+                                     Messaging::SendFlags(Messaging::SendMessageFlags::kExpectResponse));
+    SuccessOrExit(err);
+    MoveToState(ClientState::AwaitingReport);
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        ClearExistingExchangeContext();
+    }
+    ChipLogFunctError(err);
+
+    return err;
+}
+
+CHIP_ERROR ReadClient::BuildReadRequest(const AttributePathParams * apPaths, size_t aPathCount,
+                                        const Optional<EventNumber> & aEventNumber, System::PacketBufferHandle & aRequest)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    System::PacketBufferTLVWriter writer;
+    ReadRequest::Builder readRequestBuilder;
+
+    aRequest = System::PacketBufferHandle::New(kMaxSecureSduLength);
+    VerifyOrExit(!aRequest.IsNull(), err = CHIP_ERROR_NO_MEMORY);
+
+    writer.Init(std::move(aRequest));
+    err = readRequestBuilder.Init(&writer);
+    SuccessOrExit(err);
+
+    {
+        AttributePathList::Builder & attributePathList = readRequestBuilder.CreateAttributePathListBuilder();
+        SuccessOrExit(err = readRequestBuilder.GetError());
+
+        for (size_t i = 0; i < aPathCount; i++)
+        {
+            const AttributePathParams & path     = apPaths[i];
+            AttributePath::Builder & pathBuilder = attributePathList.CreateAttributePathBuilder();
+            SuccessOrExit(err = attributePathList.GetError());
+
+            // A field left out of the path is a wildcard.
+            if (path.PathFlags.Has(AttributePathParams::Flags::kEndpointIdValid))
+            {
+                pathBuilder.EndpointId(path.EndpointId);
+            }
+            if (path.PathFlags.Has(AttributePathParams::Flags::kClusterIdValid))
+            {
+                pathBuilder.ClusterId(path.ClusterId);
+            }
+            if (path.PathFlags.Has(AttributePathParams::Flags::kFieldIdValid))
+            {
+                VerifyOrExit(path.FieldId <= UINT8_MAX, err = CHIP_ERROR_INVALID_ARGUMENT);
+                pathBuilder.FieldId(static_cast<uint8_t>(path.FieldId));
+            }
+            pathBuilder.EndOfAttributePath();
+            SuccessOrExit(err = pathBuilder.GetError());
+        }
+
+        attributePathList.EndOfAttributePathList();
+        SuccessOrExit(err = attributePathList.GetError());
+    }
+
+    // The handler reports every event logged since aEventNumber, so no event path is sent.
+    if (aEventNumber.HasValue())
+    {
+        readRequestBuilder.EventNumber(aEventNumber.Value());
+        SuccessOrExit(err = readRequestBuilder.GetError());
+    }
+
+    readRequestBuilder.EndOfReadRequest();
+    SuccessOrExit(err = readRequestBuilder.GetError());
+
+    err = writer.Finalize(&aRequest);
+    SuccessOrExit(err);
+
+exit:
+    ChipLogFunctError(err);
+    return err;
+}
+
+void ReadClient::OnMessageReceived(Messaging::ExchangeContext * apExchangeContext, const PacketHeader & aPacketHeader,
+                                   const PayloadHeader & aPayloadHeader, System::PacketBufferHandle aPayload)
+{
+    CHIP_ERROR err      = CHIP_NO_ERROR;
+    bool moreChunks     = false;
+    Callback * callback = mpCallback;
+
+    VerifyOrDie(apExchangeContext == mpExchangeCtx);
+
+    VerifyOrExit(aPayloadHeader.HasMessageType(Protocols::InteractionModel::MsgType::ReportData),
+                 err = CHIP_ERROR_INVALID_MESSAGE_TYPE);
+
+    err = ProcessReportData(std::move(aPayload), moreChunks);
+    SuccessOrExit(err);
+
+    if (moreChunks)
+    {
+        // The handler sends the following chunks on the same exchange. Receiving this one stopped the
+        // response timer, so it is armed again for the next one.
+        err = mpExchangeCtx->ExpectResponse();
+        ExitNow();
+    }
+
+    // The exchange is closed rather than aborted so the last chunk still gets acknowledged.
+    mpExchangeCtx->Close();
+    mpExchangeCtx = nullptr;
+
+exit:
+    if (err != CHIP_NO_ERROR || !moreChunks)
+    {
+        Shutdown();
+        if (callback != nullptr)
+        {
+            callback->OnReadDone(this, err);
+        }
+    }
+}
+
+void ReadClient::OnResponseTimeout(Messaging::ExchangeContext * apExchangeContext)
+{
+    Callback * callback = mpCallback;
+
+    ChipLogProgress(DataManagement, "Time out! failed to receive report data from Exchange: %d",
+                    apExchangeContext->GetExchangeId());
+    Shutdown();
+    if (callback != nullptr)
+    {
+        callback->OnReadDone(this, CHIP_ERROR_TIMEOUT);
+    }
+}
+
+CHIP_ERROR ReadClient::ProcessReportData(System::PacketBufferHandle && aPayload, bool & aMoreChunks)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    System::PacketBufferTLVReader reader;
+    ReportData::Parser report;
+
+    aMoreChunks = false;
+
+    reader.Init(std::move(aPayload));
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    err = report.Init(reader);
+    SuccessOrExit(err);
+
+#if CHIP_CONFIG_IM_ENABLE_SCHEMA_CHECK
+    err = report.CheckSchemaValidity();
+    SuccessOrExit(err);
+#endif
+
+    err = report.GetMoreChunkedMessages(&aMoreChunks);
+    if (CHIP_END_OF_TLV == err)
+    {
+        aMoreChunks = false;
+        err         = CHIP_NO_ERROR;
+    }
+    SuccessOrExit(err);
+
+    err = ProcessAttributeDataList(report);
+    SuccessOrExit(err);
+
+    err = ProcessEventDataList(report);
+    SuccessOrExit(err);
+
+exit:
+    ChipLogFunctError(err);
+    return err;
+}
+
+CHIP_ERROR ReadClient::ProcessAttributeDataList(ReportData::Parser & aReport)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    TLV::TLVReader attributeDataListReader;
+    AttributeDataList::Parser attributeDataList;
+
+    err = aReport.GetAttributeDataList(&attributeDataList);
+    if (CHIP_END_OF_TLV == err)
+    {
+        ExitNow(err = CHIP_NO_ERROR);
+    }
+    SuccessOrExit(err);
+
+    attributeDataList.GetReader(&attributeDataListReader);
+    while (CHIP_NO_ERROR == (err = attributeDataListReader.Next()))
+    {
+        AttributeDataElement::Parser element;
+        AttributePath::Parser path;
+        ConcreteAttributePath attribute;
+        TLV::TLVReader dataReader;
+        uint8_t fieldId;
+
+        err = element.Init(attributeDataListReader);
+        SuccessOrExit(err);
+
+        err = element.GetAttributePath(&path);
+        SuccessOrExit(err);
+
+        err = path.GetEndpointId(&attribute.EndpointId);
+        SuccessOrExit(err);
+
+        err = path.GetClusterId(&attribute.ClusterId);
+        SuccessOrExit(err);
+
+        err = path.GetFieldId(&fieldId);
+        SuccessOrExit(err);
+        attribute.FieldId = fieldId;
+
+        err = element.GetData(&dataReader);
+        SuccessOrExit(err);
+
+        if (mpCallback != nullptr)
+        {
+            mpCallback->OnAttributeData(this, attribute, dataReader);
+        }
+    }
+
+    if (CHIP_END_OF_TLV == err)
+    {
+        err = CHIP_NO_ERROR;
+    }
+
+exit:
+    return err;
+}
+
+CHIP_ERROR ReadClient::ProcessEventDataList(ReportData::Parser & aReport)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    TLV::TLVReader eventDataListReader;
+    EventList::Parser eventDataList;
+
+    err = aReport.GetEventDataList(&eventDataList);
+    if (CHIP_END_OF_TLV == err)
+    {
+        ExitNow(err = CHIP_NO_ERROR);
+    }
+    SuccessOrExit(err);
+
+    eventDataList.GetReader(&eventDataListReader);
+    while (CHIP_NO_ERROR == (err = eventDataListReader.Next()))
+    {
+        EventDataElement::Parser element;
+
+        err = element.Init(eventDataListReader);
+        SuccessOrExit(err);
+
+        if (mpCallback != nullptr)
+        {
+            mpCallback->OnEventData(this, element);
+        }
+    }
+
+    if (CHIP_END_OF_TLV == err)
+    {
+        err = CHIP_NO_ERROR;
+    }
+
+exit:
+    return err;
+}
+
+void ReadClient::ClearExistingExchangeContext()
+{
+    // Discard any existing exchange context. Effectively we can only have one IM exchange with
+    // a single node at any one time.
+    if (mpExchangeCtx != nullptr)
+    {
+        mpExchangeCtx->Abort();
+        mpExchangeCtx = nullptr;
+    }
+}
+
+const char * ReadClient::GetStateStr() const
+{
+#if CHIP_DETAIL_LOGGING
+    switch (mState)
+    {
+    case ClientState::Uninitialized:
+        return "Uninitialized";
+
+    case ClientState::Initialized:
+        return "Initialized";
+
+    case ClientState::AwaitingReport:
+        return "AwaitingReport";
+    }
+#endif // CHIP_DETAIL_LOGGING
+    return "N/A";
+}
+
+void ReadClient::MoveToState(const ClientState aTargetState)
+{
+    mState = aTargetState;
+    ChipLogDetail(DataManagement, "IM RC moving to [%s]", GetStateStr());
+}
+
+} // namespace app
+} // namespace chip
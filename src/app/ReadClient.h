@@ -0,0 +1,154 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the client side of a CHIP IM read interaction: it
+ *      sends a ReadRequest and reassembles the ReportData chunks sent back.
+ *
+ */
+
+#pragma once
+
+#include <app/AttributePathParams.h>
+#include <app/EventManagement.h>
+#include <app/MessageDef/EventDataElement.h>
+#include <app/MessageDef/ReportData.h>
+#include <core/CHIPCore.h>
+#include <core/CHIPTLV.h>
+#include <core/Optional.h>
+#include <messaging/ExchangeContext.h>
+#include <messaging/ExchangeMgr.h>
+#include <support/CodeUtils.h>
+#include <support/logging/CHIPLogging.h>
+#include <system/SystemPacketBuffer.h>
+#include <transport/AdminPairingTable.h>
+
+namespace chip {
+namespace app {
+
+class ReadClient : public Messaging::ExchangeDelegate
+{
+public:
+    class Callback
+    {
+    public:
+        virtual ~Callback() = default;
+
+        /**
+         *  Called for every attribute of the report. aReader is positioned on the attribute data
+         *  and is only valid for the duration of the call.
+         */
+        virtual void OnAttributeData(const ReadClient * apReadClient, const ConcreteAttributePath & aPath,
+                                     TLV::TLVReader & aReader) = 0;
+
+        /**
+         *  Called for every event of the report, for reads that requested events. aEvent is only
+         *  valid for the duration of the call; its number is where a later read can resume from.
+         */
+        virtual void OnEventData(const ReadClient * apReadClient, EventDataElement::Parser & aEvent) {}
+
+        /**
+         *  Called once the last chunk of the report has been processed, or when the read fails. The
+         *  client has been shut down when this is called.
+         */
+        virtual void OnReadDone(ReadClient * apReadClient, CHIP_ERROR aError) = 0;
+    };
+
+    /**
+     *  Initialize the ReadClient. Within the lifetime of this instance, this method is invoked
+     *  once after object construction until a call to Shutdown is made to terminate the instance.
+     *
+     *  @param[in]    apExchangeMgr    A pointer to the ExchangeManager object.
+     *  @param[in]    apCallback       The callback receiving the attribute data.
+     *
+     *  @retval #CHIP_ERROR_INCORRECT_STATE If the client is in use.
+     *  @retval #CHIP_NO_ERROR On success.
+     */
+    CHIP_ERROR Init(Messaging::ExchangeManager * apExchangeMgr, Callback * apCallback);
+
+    /**
+     *  Shutdown the ReadClient. This terminates this instance of the object, releases all held
+     *  resources and gives the client back to the InteractionModelEngine.
+     */
+    void Shutdown();
+
+    /**
+     *  Send a ReadRequest for the given attribute paths. The attribute data is delivered to the
+     *  callback as the chunks of the report arrive.
+     *
+     *  @retval #CHIP_ERROR_INCORRECT_STATE If a read is already in progress.
+     *  @retval #CHIP_ERROR_NO_MEMORY If no exchange or buffer is available.
+     *  @retval #CHIP_NO_ERROR On success.
+     */
+    CHIP_ERROR SendReadRequest(NodeId aNodeId, Transport::AdminId aAdminId, const AttributePathParams * apPaths,
+                               size_t aPathCount);
+
+    /**
+     *  Send a ReadRequest for the given attribute paths and for the events of every priority level
+     *  numbered aEventNumber or above. The events are delivered to Callback::OnEventData.
+     */
+    CHIP_ERROR SendReadRequest(NodeId aNodeId, Transport::AdminId aAdminId, const AttributePathParams * apPaths,
+                               size_t aPathCount, EventNumber aEventNumber);
+
+    void OnMessageReceived(Messaging::ExchangeContext * apExchangeContext, const PacketHeader & aPacketHeader,
+                           const PayloadHeader & aPayloadHeader, System::PacketBufferHandle aPayload) override;
+    void OnResponseTimeout(Messaging::ExchangeContext * apExchangeContext) override;
+
+    /**
+     *  Whether the client can be handed out by the InteractionModelEngine.
+     */
+    bool IsFree() const { return mState == ClientState::Uninitialized; }
+
+    virtual ~ReadClient() = default;
+
+protected:
+    enum class ClientState
+    {
+        Uninitialized = 0, //< The client has not been initialized
+        Initialized,       //< The client has been initialized and is ready for a read
+        AwaitingReport,    //< The client has sent a request and is waiting for report chunks
+    };
+
+    CHIP_ERROR BuildReadRequest(const AttributePathParams * apPaths, size_t aPathCount, const Optional<EventNumber> & aEventNumber,
+                                System::PacketBufferHandle & aRequest);
+
+    /**
+     *  Deliver the attribute data and the events of one ReportData chunk to the callback.
+     *
+     *  @param[out]   aMoreChunks    Set when the chunk has MoreChunkedMessages set.
+     */
+    CHIP_ERROR ProcessReportData(System::PacketBufferHandle && aPayload, bool & aMoreChunks);
+
+private:
+    CHIP_ERROR SendReadRequest(NodeId aNodeId, Transport::AdminId aAdminId, const AttributePathParams * apPaths,
+                               size_t aPathCount, const Optional<EventNumber> & aEventNumber);
+    CHIP_ERROR ProcessAttributeDataList(ReportData::Parser & aReport);
+    CHIP_ERROR ProcessEventDataList(ReportData::Parser & aReport);
+    void ClearExistingExchangeContext();
+    void MoveToState(const ClientState aTargetState);
+    const char * GetStateStr() const;
+
+    Messaging::ExchangeManager * mpExchangeMgr = nullptr;
+    Messaging::ExchangeContext * mpExchangeCtx = nullptr;
+    Callback * mpCallback                      = nullptr;
+    ClientState mState                         = ClientState::Uninitialized;
+};
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,532 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the object serving a CHIP IM ReadRequest.
+ *
+ */
+
+#include <cinttypes>
+
+#include "ReadHandler.h"
+#include "InteractionModelEngine.h"
+
+#include <app/MessageDef/ReadRequest.h>
+#include <app/MessageDef/ReportData.h>
+#include <protocols/interaction_model/Constants.h>
+#include <support/ErrorStr.h>
+#include <support/ReturnMacros.h>
+#include <system/TLVPacketBufferBackingStore.h>
+
+namespace chip {
+namespace app {
+
+namespace {
+// Bytes left free in every chunk to close the AttributeDataList and the ReportData and to encode
+// MoreChunkedMessages. The buffer may be larger than a message, so the length written is checked too.
+constexpr uint32_t kReservedSizeForEndOfReport = 4;
+} // namespace
+
+CHIP_ERROR ReadHandler::Init(Messaging::ExchangeManager * apExchangeMgr)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    // Error if already initialized.
+    VerifyOrExit(mState == HandlerState::Uninitialized, err = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(mpExchangeCtx == nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+
+    mpExchangeMgr = apExchangeMgr;
+    MoveToState(HandlerState::Initialized);
+
+exit:
+    ChipLogFunctError(err);
+    return err;
+}
+
+void ReadHandler::Shutdown()
+{
+    VerifyOrExit(mState != HandlerState::Uninitialized, );
+
+    if (mpExchangeCtx != nullptr)
+    {
+        mpExchangeCtx->SetReliableMessageDelegate(nullptr);
+        mpExchangeCtx->Abort();
+        mpExchangeCtx = nullptr;
+    }
+
+    mRequest         = nullptr;
+    mPathsExhausted  = true;
+    mEventsExhausted = true;
+    mCursor          = AttributePathCursor();
+    mpExchangeMgr    = nullptr;
+    MoveToState(HandlerState::Uninitialized);
+
+exit:
+    return;
+}
+
+CHIP_ERROR ReadHandler::OnReadRequest(Messaging::ExchangeContext * apExchangeContext, System::PacketBufferHandle aPayload)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    mpExchangeCtx = apExchangeContext;
+    mpExchangeCtx->SetDelegate(this);
+    mpExchangeCtx->SetReliableMessageDelegate(this);
+
+    err = ProcessReadRequest(std::move(aPayload));
+    SuccessOrExit(err);
+
+    err = SendReportChunks();
+    SuccessOrExit(err);
+
+exit:
+    ChipLogFunctError(err);
+    if (err != CHIP_NO_ERROR)
+    {
+        Shutdown();
+    }
+    return err;
+}
+
+CHIP_ERROR ReadHandler::SendReportChunks()
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    // All chunks go on the same exchange: a whole-device read takes a single exchange.
+    while (HasMoreChunks())
+    {
+        System::PacketBufferHandle report;
+
+        err = BuildNextReport(report);
+        SuccessOrExit(err);
+
+        err = mpExchangeCtx->SendMessage(Protocols::InteractionModel::MsgType::ReportData, std::move(report),
+                                         Messaging::SendFlags(Messaging::SendMessageFlags::kNone));
+        SuccessOrExit(err);
+
+        // Without reliable messaging nothing is retained, and the chunks can go back to back.
+        if (HasMoreChunks() &&
+            mpExchangeMgr->GetReliableMessageMgr()->HasRetransEntries(mpExchangeCtx->GetReliableMessageContext()))
+        {
+            ExitNow();
+        }
+    }
+
+    // Let the exchange complete the delivery of the last chunk.
+    mpExchangeCtx->SetReliableMessageDelegate(nullptr);
+    mpExchangeCtx->Close();
+    mpExchangeCtx = nullptr;
+    Shutdown();
+
+exit:
+    return err;
+}
+
+void ReadHandler::OnMessageReceived(Messaging::ExchangeContext * apExchangeContext, const PacketHeader & aPacketHeader,
+                                    const PayloadHeader & aPayloadHeader, System::PacketBufferHandle aPayload)
+{
+    ChipLogDetail(DataManagement, "Unexpected message on read exchange: %d", apExchangeContext->GetExchangeId());
+}
+
+void ReadHandler::OnResponseTimeout(Messaging::ExchangeContext * apExchangeContext)
+{
+    ChipLogProgress(DataManagement, "Time out! failed to deliver report on exchange: %d", apExchangeContext->GetExchangeId());
+    Shutdown();
+}
+
+void ReadHandler::OnSendError(CHIP_ERROR aError)
+{
+    ChipLogError(DataManagement, "Failed to deliver report chunk: %s", ErrorStr(aError));
+    Shutdown();
+}
+
+void ReadHandler::OnAckRcvd()
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    VerifyOrExit(mpExchangeCtx != nullptr && HasMoreChunks(), );
+
+    err = SendReportChunks();
+
+exit:
+    ChipLogFunctError(err);
+    if (err != CHIP_NO_ERROR)
+    {
+        Shutdown();
+    }
+}
+
+CHIP_ERROR ReadHandler::ProcessReadRequest(System::PacketBufferHandle && aPayload)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    TLV::TLVReader reader;
+    ReadRequest::Parser readRequestParser;
+    AttributePathList::Parser attributePathListParser;
+
+    VerifyOrExit(mState == HandlerState::Initialized, err = CHIP_ERROR_INCORRECT_STATE);
+
+    mRequest = std::move(aPayload);
+    reader.Init(mRequest->Start(), mRequest->DataLength());
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    err = readRequestParser.Init(reader);
+    SuccessOrExit(err);
+
+#if CHIP_CONFIG_IM_ENABLE_SCHEMA_CHECK
+    err = readRequestParser.CheckSchemaValidity();
+    SuccessOrExit(err);
+#endif
+
+    // A request with an EventNumber gets every event logged since, whatever its event paths.
+    err = readRequestParser.GetEventNumber(&mRequestedEventNumber);
+    if (CHIP_NO_ERROR == err)
+    {
+        mEventNumber        = mRequestedEventNumber;
+        mEventPriorityIndex = 0;
+        mEventsExhausted    = !EventManagement::GetInstance()->IsValid();
+    }
+    else if (CHIP_END_OF_TLV == err)
+    {
+        mEventsExhausted = true;
+        err              = CHIP_NO_ERROR;
+    }
+    SuccessOrExit(err);
+
+    err = readRequestParser.GetAttributePathList(&attributePathListParser);
+    if (CHIP_END_OF_TLV == err)
+    {
+        // A request for events only: the report carries no attribute list.
+        mPathsExhausted = true;
+        MoveToState(HandlerState::Reporting);
+        ExitNow(err = CHIP_NO_ERROR);
+    }
+    SuccessOrExit(err);
+
+    attributePathListParser.GetReader(&mPathListReader);
+    mPathsExhausted = false;
+    MoveToState(HandlerState::Reporting);
+
+    err = MoveToNextPath();
+    if (CHIP_END_OF_TLV == err)
+    {
+        mPathsExhausted = true;
+        err             = CHIP_NO_ERROR;
+    }
+
+exit:
+    ChipLogFunctError(err);
+    return err;
+}
+
+CHIP_ERROR ReadHandler::MoveToNextPath()
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    AttributePath::Parser path;
+    uint8_t fieldId;
+
+    mCurrentPath = AttributePathParams();
+    mCursor      = AttributePathCursor();
+
+    // CHIP_END_OF_TLV once every path has been resolved.
+    err = mPathListReader.Next();
+    SuccessOrExit(err);
+
+    VerifyOrExit(TLV::AnonymousTag == mPathListReader.GetTag(), err = CHIP_ERROR_INVALID_TLV_TAG);
+    VerifyOrExit(TLV::kTLVType_List == mPathListReader.GetType(), err = CHIP_ERROR_WRONG_TLV_TYPE);
+
+    err = path.Init(mPathListReader);
+    SuccessOrExit(err);
+
+    // An absent field is a wildcard.
+    err = path.GetEndpointId(&mCurrentPath.EndpointId);
+    if (CHIP_NO_ERROR == err)
+    {
+        mCurrentPath.PathFlags.Set(AttributePathParams::Flags::kEndpointIdValid);
+    }
+    VerifyOrExit(CHIP_NO_ERROR == err || CHIP_END_OF_TLV == err, );
+
+    err = path.GetClusterId(&mCurrentPath.ClusterId);
+    if (CHIP_NO_ERROR == err)
+    {
+        mCurrentPath.PathFlags.Set(AttributePathParams::Flags::kClusterIdValid);
+    }
+    VerifyOrExit(CHIP_NO_ERROR == err || CHIP_END_OF_TLV == err, );
+
+    err = path.GetFieldId(&fieldId);
+    if (CHIP_NO_ERROR == err)
+    {
+        mCurrentPath.FieldId = fieldId;
+        mCurrentPath.PathFlags.Set(AttributePathParams::Flags::kFieldIdValid);
+    }
+    VerifyOrExit(CHIP_NO_ERROR == err || CHIP_END_OF_TLV == err, );
+
+    err = CHIP_NO_ERROR;
+
+exit:
+    if (CHIP_END_OF_TLV != err)
+    {
+        ChipLogFunctError(err);
+    }
+    return err;
+}
+
+CHIP_ERROR ReadHandler::BuildNextReport(System::PacketBufferHandle & aReport)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    System::PacketBufferTLVWriter writer;
+    ReportData::Builder reportDataBuilder;
+    size_t attributeCount = 0;
+    size_t prefetchedLeft = 0;
+    bool moreChunks       = false;
+
+    VerifyOrExit(mState == HandlerState::Reporting, err = CHIP_ERROR_INCORRECT_STATE);
+
+    aReport = System::PacketBufferHandle::New(kMaxSecureSduLength);
+    VerifyOrExit(!aReport.IsNull(), err = CHIP_ERROR_NO_MEMORY);
+
+    writer.Init(std::move(aReport));
+    err = reportDataBuilder.Init(&writer);
+    SuccessOrExit(err);
+
+    {
+        const TLV::TLVWriter listCheckpoint            = writer;
+        AttributeDataList::Builder & attributeDataList = reportDataBuilder.CreateAttributeDataListBuilder();
+        SuccessOrExit(err = reportDataBuilder.GetError());
+
+        while (!mPathsExhausted)
+        {
+            const AttributePathCursor cursor = mCursor;
+            ConcreteAttributePath attribute;
+
+            if (!FindNextAttribute(mCurrentPath, mCursor, attribute))
+            {
+                err = MoveToNextPath();
+                if (CHIP_END_OF_TLV == err)
+                {
+                    mPathsExhausted = true;
+                    err             = CHIP_NO_ERROR;
+                    break;
+                }
+                SuccessOrExit(err);
+                continue;
+            }
+
+            if (prefetchedLeft == 0)
+            {
+                prefetchedLeft = PrefetchCluster(attribute);
+            }
+            prefetchedLeft--;
+
+            const ChunkEncodeResult result = EncodeAttributeDataInChunk(writer, attributeDataList, attribute, attributeCount == 0);
+            if (ChunkEncodeResult::ChunkFull == result)
+            {
+                mCursor    = cursor;
+                moreChunks = true;
+                break;
+            }
+            if (ChunkEncodeResult::Encoded == result)
+            {
+                attributeCount++;
+            }
+        }
+
+        err = EndAttributeDataList(writer, listCheckpoint, attributeDataList, attributeCount);
+        SuccessOrExit(err);
+    }
+
+    if (!moreChunks && !mEventsExhausted)
+    {
+        const TLV::TLVWriter listCheckpoint = writer;
+        EventList::Builder & eventDataList  = reportDataBuilder.CreateEventDataListBuilder();
+        size_t elementCount                 = attributeCount;
+        SuccessOrExit(err = reportDataBuilder.GetError());
+
+        while (mEventPriorityIndex < kNumPriorityLevels)
+        {
+            const PriorityLevel priority = static_cast<PriorityLevel>(kNumPriorityLevels - 1 - mEventPriorityIndex);
+
+            err = EventManagement::GetInstance()->FetchEventsSince(eventDataList, priority, mEventNumber,
+                                                                   kMaxSecureSduLength - kReservedSizeForEndOfReport, elementCount);
+            if (CHIP_ERROR_BUFFER_TOO_SMALL == err)
+            {
+                // The chunk is full: the next one resumes from mEventNumber.
+                moreChunks = true;
+                err        = CHIP_NO_ERROR;
+                break;
+            }
+            if (CHIP_END_OF_TLV == err)
+            {
+                mEventPriorityIndex++;
+                mEventNumber = mRequestedEventNumber;
+                err          = CHIP_NO_ERROR;
+                continue;
+            }
+            SuccessOrExit(err);
+        }
+        mEventsExhausted = (mEventPriorityIndex == kNumPriorityLevels);
+
+        if (elementCount == attributeCount)
+        {
+            static_cast<TLV::TLVWriter &>(writer) = listCheckpoint;
+        }
+        else
+        {
+            eventDataList.EndOfEventList();
+            SuccessOrExit(err = eventDataList.GetError());
+        }
+    }
+
+    if (moreChunks)
+    {
+        reportDataBuilder.MoreChunkedMessages(true);
+    }
+    reportDataBuilder.EndOfReportData();
+    SuccessOrExit(err = reportDataBuilder.GetError());
+
+    err = writer.Finalize(&aReport);
+    SuccessOrExit(err);
+
+    if (!moreChunks)
+    {
+        MoveToState(HandlerState::Reported);
+    }
+
+exit:
+    ReleaseAttributeData();
+    ChipLogFunctError(err);
+    return err;
+}
+
+size_t ReadHandler::PrefetchCluster(const ConcreteAttributePath & aFirst)
+{
+    ConcreteAttributePath paths[CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES];
+    AttributePathCursor cursor = mCursor;
+    size_t count               = 0;
+
+    // Look ahead along the current path for the attributes that follow in the same cluster.
+    paths[count++] = aFirst;
+    while (count < CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES && FindNextAttribute(mCurrentPath, cursor, paths[count]) &&
+           paths[count].EndpointId == aFirst.EndpointId && paths[count].ClusterId == aFirst.ClusterId)
+    {
+        count++;
+    }
+
+    PrefetchAttributeData(paths, count);
+    return count;
+}
+
+CHIP_ERROR ReadHandler::EncodeAttributeData(AttributeDataList::Builder & aAttributeDataList, const ConcreteAttributePath & aPath)
+{
+    AttributeDataElement::Builder attributeDataElement;
+
+    // The field id is a single byte on the wire.
+    VerifyOrReturnError(aPath.FieldId <= UINT8_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+
+    ReturnErrorOnFailure(attributeDataElement.Init(aAttributeDataList.GetWriter()));
+
+    AttributePath::Builder attributePath = attributeDataElement.CreateAttributePathBuilder();
+    attributePath.EndpointId(aPath.EndpointId)
+        .ClusterId(aPath.ClusterId)
+        .FieldId(static_cast<uint8_t>(aPath.FieldId))
+        .EndOfAttributePath();
+    ReturnErrorOnFailure(attributePath.GetError());
+
+    // Attribute storage does not version cluster data yet.
+    attributeDataElement.DataVersion(0);
+    ReturnErrorOnFailure(attributeDataElement.GetError());
+
+    ReturnErrorOnFailure(
+        ReadSingleAttributeData(aPath, *attributeDataElement.GetWriter(), TLV::ContextTag(AttributeDataElement::kCsTag_Data)));
+
+    return attributeDataElement.EndOfAttributeDataElement().GetError();
+}
+
+ReadHandler::ChunkEncodeResult ReadHandler::EncodeAttributeDataInChunk(TLV::TLVWriter & aWriter,
+                                                                      AttributeDataList::Builder & aAttributeDataList,
+                                                                      const ConcreteAttributePath & aPath, bool aChunkEmpty)
+{
+    const TLV::TLVWriter checkpoint = aWriter;
+    CHIP_ERROR err                  = EncodeAttributeData(aAttributeDataList, aPath);
+
+    if (CHIP_NO_ERROR == err &&
+        (aWriter.GetRemainingFreeLength() < kReservedSizeForEndOfReport ||
+         aWriter.GetLengthWritten() + kReservedSizeForEndOfReport > kMaxSecureSduLength))
+    {
+        err = CHIP_ERROR_BUFFER_TOO_SMALL;
+    }
+    if (CHIP_NO_ERROR == err)
+    {
+        return ChunkEncodeResult::Encoded;
+    }
+
+    // Drop the partially encoded element.
+    aWriter = checkpoint;
+
+    if ((CHIP_ERROR_BUFFER_TOO_SMALL == err || CHIP_ERROR_NO_MEMORY == err) && !aChunkEmpty)
+    {
+        return ChunkEncodeResult::ChunkFull;
+    }
+
+    ChipLogError(DataManagement, "Skipping attribute 0x%" PRIx16 " of cluster 0x%" PRIx16 " on endpoint %" PRIu8 ": %s",
+                 aPath.FieldId, aPath.ClusterId, aPath.EndpointId, ErrorStr(err));
+    return ChunkEncodeResult::Skipped;
+}
+
+CHIP_ERROR ReadHandler::EndAttributeDataList(TLV::TLVWriter & aWriter, const TLV::TLVWriter & aListStart,
+                                             AttributeDataList::Builder & aAttributeDataList, size_t aAttributeCount)
+{
+    if (aAttributeCount == 0)
+    {
+        aWriter = aListStart;
+        return CHIP_NO_ERROR;
+    }
+
+    return aAttributeDataList.EndOfAttributeDataList().GetError();
+}
+
+const char * ReadHandler::GetStateStr() const
+{
+#if CHIP_DETAIL_LOGGING
+    switch (mState)
+    {
+    case HandlerState::Uninitialized:
+        return "Uninitialized";
+
+    case HandlerState::Initialized:
+        return "Initialized";
+
+    case HandlerState::Reporting:
+        return "Reporting";
+
+    case HandlerState::Reported:
+        return "Reported";
+    }
+#endif // CHIP_DETAIL_LOGGING
+    return "N/A";
+}
+
+void ReadHandler::MoveToState(const HandlerState aTargetState)
+{
+    mState = aTargetState;
+    ChipLogDetail(DataManagement, "IM RH moving to [%s]", GetStateStr());
+}
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,171 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the object serving a CHIP IM ReadRequest: it
+ *      resolves the requested attribute paths and streams the attribute
+ *      data into as many ReportData chunks as needed.
+ *
+ */
+
+#pragma once
+
+#include <app/AttributePathParams.h>
+#include <app/EventManagement.h>
+#include <app/MessageDef/AttributeDataList.h>
+#include <core/CHIPCore.h>
+#include <core/CHIPTLV.h>
+#include <messaging/ExchangeContext.h>
+#include <messaging/ExchangeMgr.h>
+#include <support/CodeUtils.h>
+#include <support/logging/CHIPLogging.h>
+#include <system/SystemPacketBuffer.h>
+
+namespace chip {
+namespace app {
+
+class ReadHandler : public Messaging::ExchangeDelegate, public Messaging::ReliableMessageDelegate
+{
+public:
+    /**
+     *  Initialize the ReadHandler. Within the lifetime of this instance, this method is invoked
+     *  once after object construction until a call to Shutdown is made to terminate the instance.
+     *
+     *  @param[in]    apExchangeMgr    A pointer to the ExchangeManager object.
+     *
+     *  @retval #CHIP_ERROR_INCORRECT_STATE If the handler is in use.
+     *  @retval #CHIP_NO_ERROR On success.
+     */
+    CHIP_ERROR Init(Messaging::ExchangeManager * apExchangeMgr);
+
+    /**
+     *  Shutdown the ReadHandler. This terminates this instance of the object, releases all held
+     *  resources and gives the handler back to the InteractionModelEngine.
+     */
+    void Shutdown();
+
+    /**
+     *  Serve a ReadRequest. The chunks of the report are sent on apExchangeContext one at a time:
+     *  every chunk holds a retransmission table entry until it is acknowledged, so the next one is
+     *  only sent once the acknowledgement arrives. The handler shuts down once the last chunk,
+     *  without MoreChunkedMessages, has been sent.
+     */
+    CHIP_ERROR OnReadRequest(Messaging::ExchangeContext * apExchangeContext, System::PacketBufferHandle aPayload);
+
+    void OnMessageReceived(Messaging::ExchangeContext * apExchangeContext, const PacketHeader & aPacketHeader,
+                           const PayloadHeader & aPayloadHeader, System::PacketBufferHandle aPayload) override;
+    void OnResponseTimeout(Messaging::ExchangeContext * apExchangeContext) override;
+
+    // Messaging::ReliableMessageDelegate Implementation
+    void OnSendError(CHIP_ERROR aError) override;
+    void OnAckRcvd() override;
+
+    /**
+     *  Whether the handler can be handed out by the InteractionModelEngine.
+     */
+    bool IsFree() const { return mState == HandlerState::Uninitialized; }
+
+    /**
+     *  Append the AttributeDataElement of one attribute to a report. On failure the writer of the
+     *  list may hold a partial element, which the caller rolls back.
+     */
+    static CHIP_ERROR EncodeAttributeData(AttributeDataList::Builder & aAttributeDataList, const ConcreteAttributePath & aPath);
+
+    enum class ChunkEncodeResult
+    {
+        Encoded,   //< The attribute is in the chunk
+        ChunkFull, //< The chunk is full: the attribute starts the next one
+        Skipped,   //< The attribute cannot be read, or does not fit even in an empty chunk: it is left out
+    };
+
+    /**
+     *  Append one attribute to the AttributeDataList of a report chunk written by aWriter, keeping
+     *  room to end the report. A partially encoded element is rolled back.
+     *
+     *  @param[in]    aChunkEmpty  Whether no attribute is in the chunk yet.
+     */
+    static ChunkEncodeResult EncodeAttributeDataInChunk(TLV::TLVWriter & aWriter, AttributeDataList::Builder & aAttributeDataList,
+                                                        const ConcreteAttributePath & aPath, bool aChunkEmpty);
+
+    /**
+     *  End the AttributeDataList of a report chunk. An empty list is not a valid one: when no
+     *  attribute made it into the chunk, aWriter is rolled back to aListStart instead.
+     */
+    static CHIP_ERROR EndAttributeDataList(TLV::TLVWriter & aWriter, const TLV::TLVWriter & aListStart,
+                                           AttributeDataList::Builder & aAttributeDataList, size_t aAttributeCount);
+
+    virtual ~ReadHandler() = default;
+
+protected:
+    enum class HandlerState
+    {
+        Uninitialized = 0, //< The handler has not been initialized
+        Initialized,       //< The handler has been initialized and is ready
+        Reporting,         //< The handler has parsed a request and has more data to report
+        Reported,          //< The last chunk of the report has been built
+    };
+
+    CHIP_ERROR ProcessReadRequest(System::PacketBufferHandle && aPayload);
+
+    /**
+     *  Build the next ReportData chunk, with as much attribute data as fits in a message, then the
+     *  events asked for once every attribute has been reported. The chunk has MoreChunkedMessages
+     *  set when attributes or events are left for another one.
+     */
+    CHIP_ERROR BuildNextReport(System::PacketBufferHandle & aReport);
+
+    bool HasMoreChunks() const { return mState == HandlerState::Reporting; }
+
+private:
+    /**
+     *  Send chunks until one waits for an acknowledgement, or until the last one was sent, after
+     *  which the handler shuts down.
+     */
+    CHIP_ERROR SendReportChunks();
+
+    CHIP_ERROR MoveToNextPath();
+
+    /**
+     *  Prefetch aFirst, which was just found along the current path, and the attributes of the same
+     *  cluster that follow it. Returns the number of attributes announced.
+     */
+    size_t PrefetchCluster(const ConcreteAttributePath & aFirst);
+
+    void MoveToState(const HandlerState aTargetState);
+    const char * GetStateStr() const;
+
+    Messaging::ExchangeManager * mpExchangeMgr = nullptr;
+    Messaging::ExchangeContext * mpExchangeCtx = nullptr;
+
+    // The request is kept until the last chunk is built: mPathListReader reads from it.
+    System::PacketBufferHandle mRequest;
+    TLV::TLVReader mPathListReader;
+    AttributePathParams mCurrentPath;
+    AttributePathCursor mCursor;
+    bool mPathsExhausted = true;
+    // Events are reported from mRequestedEventNumber for every priority level, critical first.
+    EventNumber mRequestedEventNumber = 0;
+    EventNumber mEventNumber          = 0;
+    size_t mEventPriorityIndex        = 0;
+    bool mEventsExhausted             = true;
+    HandlerState mState               = HandlerState::Uninitialized;
+};
+
+} // namespace app
+} // namespace chip
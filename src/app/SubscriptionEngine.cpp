@@ -0,0 +1,482 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the engine reporting attribute changes to
+ *      subscribers.
+ *
+ */
+
+#include <cinttypes>
+#include <string.h>
+
+#include "InteractionModelEngine.h"
+#include "ReadHandler.h"
+#include "SubscriptionEngine.h"
+
+#include <app/MessageDef/ReportData.h>
+#include <protocols/interaction_model/Constants.h>
+#include <support/ErrorStr.h>
+#include <support/ReturnMacros.h>
+#include <system/TLVPacketBufferBackingStore.h>
+#include <transport/SecureSessionMgr.h>
+
+namespace chip {
+namespace app {
+
+static_assert(CHIP_IM_MAX_NUM_SUBSCRIPTIONS <= 32, "A subscription is a bit of an index entry");
+
+namespace {
+bool PathLess(const ConcreteAttributePath & aLeft, const ConcreteAttributePath & aRight)
+{
+    if (aLeft.EndpointId != aRight.EndpointId)
+    {
+        return aLeft.EndpointId < aRight.EndpointId;
+    }
+    if (aLeft.ClusterId != aRight.ClusterId)
+    {
+        return aLeft.ClusterId < aRight.ClusterId;
+    }
+    return aLeft.FieldId < aRight.FieldId;
+}
+
+bool PathEqual(const ConcreteAttributePath & aLeft, const ConcreteAttributePath & aRight)
+{
+    return aLeft.EndpointId == aRight.EndpointId && aLeft.ClusterId == aRight.ClusterId && aLeft.FieldId == aRight.FieldId;
+}
+} // namespace
+
+CHIP_ERROR SubscriptionEngine::Init(Messaging::ExchangeManager * apExchangeMgr)
+{
+    // Error if already initialized.
+    VerifyOrReturnError(mpExchangeMgr == nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    mpExchangeMgr = apExchangeMgr;
+    return CHIP_NO_ERROR;
+}
+
+void SubscriptionEngine::Shutdown()
+{
+    if (mpExchangeMgr != nullptr && mpExchangeMgr->GetSessionMgr() != nullptr &&
+        mpExchangeMgr->GetSessionMgr()->SystemLayer() != nullptr)
+    {
+        mpExchangeMgr->GetSessionMgr()->SystemLayer()->CancelTimer(OnTimer, this);
+    }
+
+    for (Subscription & subscription : mSubscriptions)
+    {
+        subscription = Subscription();
+    }
+    mIndexSize    = 0;
+    mpExchangeMgr = nullptr;
+}
+
+CHIP_ERROR SubscriptionEngine::Subscribe(NodeId aNodeId, Transport::AdminId aAdminId, const AttributePathParams * apPaths,
+                                         size_t aPathCount, uint16_t aMinIntervalSeconds, uint16_t aMaxIntervalSeconds,
+                                         uint8_t * apSubscriptionId)
+{
+    CHIP_ERROR err        = CHIP_NO_ERROR;
+    const uint64_t nowMs  = System::Layer::GetClock_MonotonicMS();
+    uint8_t id            = 0;
+    Subscription * pEntry = nullptr;
+
+    VerifyOrReturnError(aMaxIntervalSeconds > 0 && aMinIntervalSeconds <= aMaxIntervalSeconds, CHIP_ERROR_INVALID_ARGUMENT);
+
+    for (; id < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; id++)
+    {
+        if (!mSubscriptions[id].mInUse)
+        {
+            pEntry = &mSubscriptions[id];
+            break;
+        }
+    }
+    VerifyOrReturnError(pEntry != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    pEntry->mNodeId        = aNodeId;
+    pEntry->mAdminId       = aAdminId;
+    pEntry->mMinIntervalMs = aMinIntervalSeconds * 1000u;
+    pEntry->mMaxIntervalMs = aMaxIntervalSeconds * 1000u;
+    pEntry->mDirtyCount    = 0;
+    pEntry->mInUse         = true;
+    // The first report, which carries every subscribed attribute, goes out right away.
+    pEntry->mEarliestReportMs = nowMs;
+    pEntry->mLatestReportMs   = nowMs;
+
+    for (size_t i = 0; i < aPathCount; i++)
+    {
+        AttributePathCursor cursor;
+        ConcreteAttributePath attribute;
+
+        while (FindNextAttribute(apPaths[i], cursor, attribute))
+        {
+            err = AddToIndex(attribute, id);
+            SuccessOrExit(err);
+        }
+    }
+
+    *apSubscriptionId = id;
+    ScheduleRun(nowMs);
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        RemoveFromIndex(id);
+        *pEntry = Subscription();
+    }
+    ChipLogFunctError(err);
+    return err;
+}
+
+CHIP_ERROR SubscriptionEngine::Unsubscribe(uint8_t aSubscriptionId)
+{
+    VerifyOrReturnError(aSubscriptionId < CHIP_IM_MAX_NUM_SUBSCRIPTIONS && mSubscriptions[aSubscriptionId].mInUse,
+                        CHIP_ERROR_INVALID_ARGUMENT);
+
+    RemoveFromIndex(aSubscriptionId);
+    mSubscriptions[aSubscriptionId] = Subscription();
+    return CHIP_NO_ERROR;
+}
+
+void SubscriptionEngine::MarkDirty(const ConcreteAttributePath & aPath)
+{
+    IndexEntry * entry = FindIndexEntry(aPath);
+    VerifyOrReturn(entry != nullptr);
+
+    SubscriptionMask newlyDirty = entry->mSubscriptions & ~entry->mDirty;
+    VerifyOrReturn(newlyDirty != 0);
+    entry->mDirty |= newlyDirty;
+
+    bool reschedule = false;
+    for (uint8_t id = 0; newlyDirty != 0; id++, newlyDirty >>= 1)
+    {
+        if (newlyDirty & 1)
+        {
+            // A subscription that had nothing to report may now be due sooner than the scheduled run.
+            reschedule |= (mSubscriptions[id].mDirtyCount++ == 0);
+        }
+    }
+
+    if (reschedule)
+    {
+        ScheduleRun(System::Layer::GetClock_MonotonicMS());
+    }
+}
+
+void SubscriptionEngine::OnMessageReceived(Messaging::ExchangeContext * apExchangeContext, const PacketHeader & aPacketHeader,
+                                           const PayloadHeader & aPayloadHeader, System::PacketBufferHandle aPayload)
+{
+    ChipLogDetail(DataManagement, "Unexpected message on report exchange: %d", apExchangeContext->GetExchangeId());
+}
+
+void SubscriptionEngine::OnResponseTimeout(Messaging::ExchangeContext * apExchangeContext)
+{
+    ChipLogProgress(DataManagement, "Time out! failed to deliver report on exchange: %d", apExchangeContext->GetExchangeId());
+}
+
+void SubscriptionEngine::Run(uint64_t aNowMs)
+{
+    for (uint8_t id = 0; id < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; id++)
+    {
+        Subscription & subscription = mSubscriptions[id];
+
+        if (!subscription.mInUse || !IsReportDue(subscription, aNowMs))
+        {
+            continue;
+        }
+
+        CHIP_ERROR err = SendReport(id);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(DataManagement, "Failed to send report of subscription %u: %s", id, ErrorStr(err));
+        }
+
+        // A subscriber that cannot be reached is retried at its next interval rather than right away.
+        subscription.mEarliestReportMs = aNowMs + subscription.mMinIntervalMs;
+        subscription.mLatestReportMs   = aNowMs + subscription.mMaxIntervalMs;
+    }
+
+    ScheduleRun(aNowMs);
+}
+
+CHIP_ERROR SubscriptionEngine::BuildReport(uint8_t aSubscriptionId, uint16_t & aIndex, System::PacketBufferHandle & aReport,
+                                           bool & aMoreChunks)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    System::PacketBufferTLVWriter writer;
+    ReportData::Builder reportDataBuilder;
+    const SubscriptionMask mask = static_cast<SubscriptionMask>(1u << aSubscriptionId);
+    uint16_t dirtyLeft          = mSubscriptions[aSubscriptionId].mDirtyCount;
+    size_t attributeCount       = 0;
+    size_t prefetchedLeft       = 0;
+
+    aMoreChunks = false;
+
+    aReport = System::PacketBufferHandle::New(kMaxSecureSduLength);
+    VerifyOrExit(!aReport.IsNull(), err = CHIP_ERROR_NO_MEMORY);
+
+    writer.Init(std::move(aReport));
+    err = reportDataBuilder.Init(&writer);
+    SuccessOrExit(err);
+
+    reportDataBuilder.SubscriptionId(aSubscriptionId);
+
+    {
+        const TLV::TLVWriter listCheckpoint            = writer;
+        AttributeDataList::Builder & attributeDataList = reportDataBuilder.CreateAttributeDataListBuilder();
+        SuccessOrExit(err = reportDataBuilder.GetError());
+
+        // Only the index is walked: its dirty bits are the dirty set of every subscription. They are
+        // left set here, the previous chunks having been cleared once sent.
+        for (; aIndex < mIndexSize && dirtyLeft > 0; aIndex++)
+        {
+            const IndexEntry & entry = mIndex[aIndex];
+
+            if ((entry.mDirty & mask) == 0)
+            {
+                continue;
+            }
+
+            if (prefetchedLeft == 0)
+            {
+                prefetchedLeft = PrefetchCluster(aIndex, mask);
+            }
+            prefetchedLeft--;
+
+            const ReadHandler::ChunkEncodeResult result =
+                ReadHandler::EncodeAttributeDataInChunk(writer, attributeDataList, entry.mPath, attributeCount == 0);
+            if (ReadHandler::ChunkEncodeResult::ChunkFull == result)
+            {
+                aMoreChunks = true;
+                break;
+            }
+            if (ReadHandler::ChunkEncodeResult::Encoded == result)
+            {
+                attributeCount++;
+            }
+            dirtyLeft--;
+        }
+
+        // A keep-alive report, or one whose attributes were all skipped, carries no list.
+        err = ReadHandler::EndAttributeDataList(writer, listCheckpoint, attributeDataList, attributeCount);
+        SuccessOrExit(err);
+    }
+
+    if (aMoreChunks)
+    {
+        reportDataBuilder.MoreChunkedMessages(true);
+    }
+    reportDataBuilder.EndOfReportData();
+    SuccessOrExit(err = reportDataBuilder.GetError());
+
+    err = writer.Finalize(&aReport);
+    SuccessOrExit(err);
+
+exit:
+    ReleaseAttributeData();
+    ChipLogFunctError(err);
+    return err;
+}
+
+void SubscriptionEngine::ClearDirty(uint8_t aSubscriptionId, uint16_t aFirstIndex, uint16_t aEndIndex)
+{
+    const SubscriptionMask mask = static_cast<SubscriptionMask>(1u << aSubscriptionId);
+    Subscription & subscription = mSubscriptions[aSubscriptionId];
+
+    for (uint16_t i = aFirstIndex; i < aEndIndex; i++)
+    {
+        if (mIndex[i].mDirty & mask)
+        {
+            mIndex[i].mDirty &= static_cast<SubscriptionMask>(~mask);
+            subscription.mDirtyCount--;
+        }
+    }
+}
+
+size_t SubscriptionEngine::PrefetchCluster(uint16_t aFirstIndex, SubscriptionMask aMask)
+{
+    const ConcreteAttributePath & first = mIndex[aFirstIndex].mPath;
+    ConcreteAttributePath paths[CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES];
+    size_t count = 0;
+
+    // The index is sorted: the attributes of a cluster are next to each other.
+    for (uint16_t i = aFirstIndex; i < mIndexSize && count < CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES; i++)
+    {
+        const IndexEntry & entry = mIndex[i];
+        if (entry.mPath.EndpointId != first.EndpointId || entry.mPath.ClusterId != first.ClusterId)
+        {
+            break;
+        }
+        if (entry.mDirty & aMask)
+        {
+            paths[count++] = entry.mPath;
+        }
+    }
+
+    PrefetchAttributeData(paths, count);
+    return count;
+}
+
+CHIP_ERROR SubscriptionEngine::SendReport(uint8_t aSubscriptionId)
+{
+    CHIP_ERROR err                            = CHIP_NO_ERROR;
+    const Subscription & subscription         = mSubscriptions[aSubscriptionId];
+    Messaging::ExchangeContext * pExchangeCtx = nullptr;
+    uint16_t next                             = 0;
+    bool moreChunks                           = true;
+
+    VerifyOrExit(mpExchangeMgr != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+
+    // TODO: Hard code keyID to 0 to unblock IM end-to-end test. Complete solution is tracked in issue:4451
+    pExchangeCtx = mpExchangeMgr->NewContext({ subscription.mNodeId, 0, subscription.mAdminId }, this);
+    VerifyOrExit(pExchangeCtx != nullptr, err = CHIP_ERROR_NO_MEMORY);
+
+    while (moreChunks)
+    {
+        System::PacketBufferHandle report;
+        const uint16_t first = next;
+
+        err = BuildReport(aSubscriptionId, next, report, moreChunks);
+        SuccessOrExit(err);
+
+        err = pExchangeCtx->SendMessage(Protocols::InteractionModel::MsgType::ReportData, std::move(report),
+                                        Messaging::SendFlags(Messaging::SendMessageFlags::kNone));
+        SuccessOrExit(err);
+
+        // Attributes of a chunk that could not be sent stay dirty for the next report.
+        ClearDirty(aSubscriptionId, first, next);
+    }
+
+    pExchangeCtx->Close();
+    pExchangeCtx = nullptr;
+
+exit:
+    if (pExchangeCtx != nullptr)
+    {
+        pExchangeCtx->Abort();
+    }
+    ChipLogFunctError(err);
+    return err;
+}
+
+void SubscriptionEngine::OnTimer(System::Layer * apSystemLayer, void * apAppState, System::Error aError)
+{
+    static_cast<SubscriptionEngine *>(apAppState)->Run(System::Layer::GetClock_MonotonicMS());
+}
+
+SubscriptionEngine::IndexEntry * SubscriptionEngine::FindIndexEntry(const ConcreteAttributePath & aPath)
+{
+    uint16_t low  = 0;
+    uint16_t high = mIndexSize;
+
+    while (low < high)
+    {
+        const uint16_t mid = static_cast<uint16_t>(low + (high - low) / 2);
+        if (PathLess(mIndex[mid].mPath, aPath))
+        {
+            low = static_cast<uint16_t>(mid + 1);
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return (low < mIndexSize && PathEqual(mIndex[low].mPath, aPath)) ? &mIndex[low] : nullptr;
+}
+
+CHIP_ERROR SubscriptionEngine::AddToIndex(const ConcreteAttributePath & aPath, uint8_t aSubscriptionId)
+{
+    const SubscriptionMask mask = static_cast<SubscriptionMask>(1u << aSubscriptionId);
+    uint16_t position           = 0;
+
+    while (position < mIndexSize && PathLess(mIndex[position].mPath, aPath))
+    {
+        position++;
+    }
+
+    if (position == mIndexSize || !PathEqual(mIndex[position].mPath, aPath))
+    {
+        VerifyOrReturnError(mIndexSize < CHIP_IM_MAX_NUM_SUBSCRIBED_ATTRIBUTES, CHIP_ERROR_NO_MEMORY);
+        memmove(&mIndex[position + 1], &mIndex[position], (mIndexSize - position) * sizeof(mIndex[0]));
+        mIndex[position] = { aPath, 0, 0 };
+        mIndexSize++;
+    }
+
+    // A path listed twice, or overlapping wildcards, watch the attribute once.
+    if ((mIndex[position].mSubscriptions & mask) == 0)
+    {
+        mIndex[position].mSubscriptions |= mask;
+        mIndex[position].mDirty |= mask;
+        mSubscriptions[aSubscriptionId].mDirtyCount++;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void SubscriptionEngine::RemoveFromIndex(uint8_t aSubscriptionId)
+{
+    const SubscriptionMask mask = static_cast<SubscriptionMask>(~(1u << aSubscriptionId));
+    uint16_t kept               = 0;
+
+    for (uint16_t i = 0; i < mIndexSize; i++)
+    {
+        IndexEntry entry = mIndex[i];
+
+        entry.mSubscriptions &= mask;
+        entry.mDirty &= mask;
+        if (entry.mSubscriptions != 0)
+        {
+            mIndex[kept++] = entry;
+        }
+    }
+
+    mIndexSize = kept;
+}
+
+bool SubscriptionEngine::IsReportDue(const Subscription & aSubscription, uint64_t aNowMs) const
+{
+    return (aSubscription.mDirtyCount > 0 && aNowMs >= aSubscription.mEarliestReportMs) || aNowMs >= aSubscription.mLatestReportMs;
+}
+
+void SubscriptionEngine::ScheduleRun(uint64_t aNowMs)
+{
+    uint64_t nextRunMs = UINT64_MAX;
+
+    for (const Subscription & subscription : mSubscriptions)
+    {
+        if (subscription.mInUse)
+        {
+            const uint64_t dueMs = (subscription.mDirtyCount > 0) ? subscription.mEarliestReportMs : subscription.mLatestReportMs;
+            nextRunMs            = (dueMs < nextRunMs) ? dueMs : nextRunMs;
+        }
+    }
+
+    VerifyOrReturn(mpExchangeMgr != nullptr && mpExchangeMgr->GetSessionMgr() != nullptr);
+    System::Layer * systemLayer = mpExchangeMgr->GetSessionMgr()->SystemLayer();
+    VerifyOrReturn(systemLayer != nullptr);
+
+    systemLayer->CancelTimer(OnTimer, this);
+    VerifyOrReturn(nextRunMs != UINT64_MAX);
+
+    const uint64_t delayMs = (nextRunMs > aNowMs) ? nextRunMs - aNowMs : 0;
+    systemLayer->StartTimer(static_cast<uint32_t>(delayMs < UINT32_MAX ? delayMs : UINT32_MAX), OnTimer, this);
+}
+
+} // namespace app
+} // namespace chip
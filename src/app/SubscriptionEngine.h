@@ -0,0 +1,161 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the engine reporting attribute changes to
+ *      subscribers. Each subscribed attribute is listed once in an index
+ *      sorted by path, holding the set of subscriptions watching it and the
+ *      set of those that have not been sent its latest value yet. A change
+ *      costs a lookup in the index, and each subscription gets a single
+ *      ReportData with all its changed attributes once its minimum interval
+ *      has elapsed.
+ *
+ */
+
+#pragma once
+
+#include <app/AttributePathParams.h>
+#include <core/CHIPCore.h>
+#include <messaging/ExchangeContext.h>
+#include <messaging/ExchangeMgr.h>
+#include <support/CodeUtils.h>
+#include <support/logging/CHIPLogging.h>
+#include <system/SystemLayer.h>
+#include <system/SystemPacketBuffer.h>
+#include <transport/AdminPairingTable.h>
+
+namespace chip {
+namespace app {
+
+class SubscriptionEngine : public Messaging::ExchangeDelegate
+{
+public:
+    CHIP_ERROR Init(Messaging::ExchangeManager * apExchangeMgr);
+
+    /**
+     *  Drop every subscription and stop reporting.
+     */
+    void Shutdown();
+
+    /**
+     *  Subscribe a node to the attributes covered by the given paths. Wildcard paths are resolved
+     *  once, when the subscription is made. The first report of the subscription carries every
+     *  attribute it covers.
+     *
+     *  @param[in]    aMinIntervalSeconds  The shortest time between two reports of the subscription.
+     *  @param[in]    aMaxIntervalSeconds  The longest time without a report: an empty report is
+     *                                     sent when no attribute changed in that time.
+     *  @param[out]   apSubscriptionId     The id of the subscription, carried by its reports.
+     *
+     *  @retval #CHIP_ERROR_NO_MEMORY If there is no free subscription or the index is full.
+     *  @retval #CHIP_ERROR_INVALID_ARGUMENT If the intervals are inconsistent.
+     *  @retval #CHIP_NO_ERROR On success.
+     */
+    CHIP_ERROR Subscribe(NodeId aNodeId, Transport::AdminId aAdminId, const AttributePathParams * apPaths, size_t aPathCount,
+                         uint16_t aMinIntervalSeconds, uint16_t aMaxIntervalSeconds, uint8_t * apSubscriptionId);
+
+    CHIP_ERROR Unsubscribe(uint8_t aSubscriptionId);
+
+    /**
+     *  Record that the value of an attribute changed. Every subscription watching the attribute
+     *  reports it in its next ReportData, once, however many times it changes before then.
+     */
+    void MarkDirty(const ConcreteAttributePath & aPath);
+
+    void OnMessageReceived(Messaging::ExchangeContext * apExchangeContext, const PacketHeader & aPacketHeader,
+                           const PayloadHeader & aPayloadHeader, System::PacketBufferHandle aPayload) override;
+    void OnResponseTimeout(Messaging::ExchangeContext * apExchangeContext) override;
+
+    virtual ~SubscriptionEngine() = default;
+
+protected:
+    typedef uint32_t SubscriptionMask;
+
+    struct Subscription
+    {
+        NodeId mNodeId              = kUndefinedNodeId;
+        Transport::AdminId mAdminId = Transport::kUndefinedAdminId;
+        uint32_t mMinIntervalMs     = 0;
+        uint32_t mMaxIntervalMs     = 0;
+        // Changes are not reported before mEarliestReportMs, and a report is sent at mLatestReportMs
+        // even if nothing changed.
+        uint64_t mEarliestReportMs = 0;
+        uint64_t mLatestReportMs   = 0;
+        // Number of entries of the index that are dirty for this subscription.
+        uint16_t mDirtyCount = 0;
+        bool mInUse          = false;
+    };
+
+    struct IndexEntry
+    {
+        ConcreteAttributePath mPath;
+        SubscriptionMask mSubscriptions;
+        SubscriptionMask mDirty;
+    };
+
+    /**
+     *  Send the reports that are due at aNowMs and schedule the next run.
+     */
+    void Run(uint64_t aNowMs);
+
+    /**
+     *  Build a ReportData with as many dirty attributes of a subscription as fit in a message,
+     *  starting at the index entry aIndex. aIndex is moved to the entry the next chunk starts at, and
+     *  aMoreChunks is set when there is one. The attributes stay dirty until ClearDirty is called.
+     */
+    CHIP_ERROR BuildReport(uint8_t aSubscriptionId, uint16_t & aIndex, System::PacketBufferHandle & aReport, bool & aMoreChunks);
+
+    /**
+     *  Clear the dirty bits of a subscription on the index entries [aFirstIndex, aEndIndex), once
+     *  the chunk built from them was handed to the exchange.
+     */
+    void ClearDirty(uint8_t aSubscriptionId, uint16_t aFirstIndex, uint16_t aEndIndex);
+
+    /**
+     *  Send every chunk of a report to the subscriber.
+     */
+    virtual CHIP_ERROR SendReport(uint8_t aSubscriptionId);
+
+    const Subscription & GetSubscription(uint8_t aSubscriptionId) const { return mSubscriptions[aSubscriptionId]; }
+
+private:
+    static void OnTimer(System::Layer * apSystemLayer, void * apAppState, System::Error aError);
+
+    IndexEntry * FindIndexEntry(const ConcreteAttributePath & aPath);
+
+    /**
+     *  Prefetch the attribute of the index entry aFirstIndex and the attributes of the same cluster
+     *  that follow it and are dirty for aMask. Returns the number of attributes announced.
+     */
+    size_t PrefetchCluster(uint16_t aFirstIndex, SubscriptionMask aMask);
+
+    CHIP_ERROR AddToIndex(const ConcreteAttributePath & aPath, uint8_t aSubscriptionId);
+    void RemoveFromIndex(uint8_t aSubscriptionId);
+    bool IsReportDue(const Subscription & aSubscription, uint64_t aNowMs) const;
+    void ScheduleRun(uint64_t aNowMs);
+
+    Messaging::ExchangeManager * mpExchangeMgr = nullptr;
+    Subscription mSubscriptions[CHIP_IM_MAX_NUM_SUBSCRIPTIONS];
+    // Sorted by endpoint, cluster and attribute.
+    IndexEntry mIndex[CHIP_IM_MAX_NUM_SUBSCRIBED_ATTRIBUTES];
+    uint16_t mIndexSize = 0;
+};
+
+} // namespace app
+} // namespace chip
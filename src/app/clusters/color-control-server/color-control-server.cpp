@@ -42,6 +42,7 @@
 #include <app/util/af.h>
 
 #include <app/util/af-event.h>
+#include <app/util/af-transition.h>
 #include <app/util/attribute-storage.h>
 #include <assert.h>
 
@@ -56,10 +57,6 @@
 
 using namespace chip;
 
-#define COLOR_TEMP_CONTROL emberAfPluginColorControlServerTempTransitionEventControl
-#define COLOR_XY_CONTROL emberAfPluginColorControlServerXyTransitionEventControl
-#define COLOR_HSV_CONTROL emberAfPluginColorControlServerHueSatTransitionEventControl
-
 // move mode
 enum
 {
@@ -88,11 +85,13 @@ enum
     TEMPERATURE_TO_TEMPERATURE = 0x22
 };
 
+// Color transitions run on the shared transition scheduler. These events are
+// still listed in the generated event table, and bring the transitions up to
+// date when they fire.
 EmberEventControl emberAfPluginColorControlServerTempTransitionEventControl;
 EmberEventControl emberAfPluginColorControlServerXyTransitionEventControl;
 EmberEventControl emberAfPluginColorControlServerHueSatTransitionEventControl;
 
-#define UPDATE_TIME_MS 100
 #define TRANSITION_TIME_1S 10
 #define MIN_CIE_XY_VALUE 0
 // this value comes directly from the ZCL specification table 5.3
@@ -101,6 +100,8 @@ EmberEventControl emberAfPluginColorControlServerHueSatTransitionEventControl;
 #define MAX_TEMPERATURE_VALUE 0xfeff
 #define MIN_HUE_VALUE 0
 #define MAX_HUE_VALUE 254
+// hues are on a circle of MAX_HUE_VALUE + 1 values
+#define HUE_MODULO (MAX_HUE_VALUE + 1)
 #define MIN_SATURATION_VALUE 0
 #define MAX_SATURATION_VALUE 254
 #define HALF_MAX_UINT8T 127
@@ -110,62 +111,34 @@ EmberEventControl emberAfPluginColorControlServerHueSatTransitionEventControl;
 
 #define REPORT_FAILED 0xFF
 
-typedef struct
-{
-    uint8_t initialHue;
-    uint8_t currentHue;
-    uint8_t finalHue;
-    uint16_t stepsRemaining;
-    uint16_t stepsTotal;
-    EndpointId endpoint;
-    bool up;
-    bool repeat;
-} ColorHueTransitionState;
-
-static ColorHueTransitionState colorHueTransitionState;
-
-typedef struct
-{
-    uint16_t initialValue;
-    uint16_t currentValue;
-    uint16_t finalValue;
-    uint16_t stepsRemaining;
-    uint16_t stepsTotal;
-    uint16_t lowLimit;
-    uint16_t highLimit;
-    EndpointId endpoint;
-} Color16uTransitionState;
-
-static Color16uTransitionState colorXTransitionState;
-static Color16uTransitionState colorYTransitionState;
-
-static Color16uTransitionState colorTempTransitionState;
-
-static Color16uTransitionState colorSaturationTransitionState;
-
 // Forward declarations:
-static bool computeNewColor16uValue(Color16uTransitionState * p);
-static void stopAllColorTransitions(void);
+static void startTransition(EndpointId endpoint, AttributeId attributeId, EmberAfAttributeType attributeType,
+                            uint16_t initialValue, int32_t delta, uint16_t transitionTime, uint16_t modulo, bool repeat);
+static void transitionCallback(EndpointId endpoint, ClusterId clusterId, uint32_t remainingMs);
+static void stopAllColorTransitions(EndpointId endpoint);
 static void handleModeSwitch(EndpointId endpoint, uint8_t newColorMode);
 static bool shouldExecuteIfOff(EndpointId endpoint, uint8_t optionMask, uint8_t optionOverride);
 
 #ifdef EMBER_AF_PLUGIN_COLOR_CONTROL_SERVER_HSV
-static uint8_t addHue(uint8_t hue1, uint8_t hue2);
-static uint8_t subtractHue(uint8_t hue1, uint8_t hue2);
 static uint8_t addSaturation(uint8_t saturation1, uint8_t saturation2);
 static uint8_t subtractSaturation(uint8_t saturation1, uint8_t saturation2);
-static void initHueSat(EndpointId endpoint);
+static void startHueTransition(EndpointId endpoint, uint8_t initialHue, int32_t delta, uint16_t transitionTime, bool repeat);
+static void startSaturationTransition(EndpointId endpoint, uint8_t initialSaturation, uint8_t finalSaturation,
+                                      uint16_t transitionTime);
+static uint8_t hueDistance(uint8_t fromHue, uint8_t toHue);
 static uint8_t readHue(EndpointId endpoint);
 static uint8_t readSaturation(EndpointId endpoint);
 #endif
 
 #ifdef EMBER_AF_PLUGIN_COLOR_CONTROL_SERVER_XY
+static void startColorXyTransition(EndpointId endpoint, uint16_t colorX, uint16_t colorY, uint16_t transitionTime);
 static uint16_t findNewColorValueFromStep(uint16_t oldValue, int16_t step);
+static uint16_t findNewColorValueFromRate(uint16_t oldValue, int16_t rate, uint16_t transitionTime);
 static uint16_t readColorX(EndpointId endpoint);
 static uint16_t readColorY(EndpointId endpoint);
 #endif
 
-static uint16_t computeTransitionTimeFromStateAndRate(Color16uTransitionState * p, uint16_t rate);
+static uint16_t computeTransitionTimeFromRate(uint16_t currentValue, uint16_t finalValue, uint16_t rate);
 
 // convenient token handling functions
 static uint8_t readColorMode(EndpointId endpoint)
@@ -390,37 +363,24 @@ bool emberAfColorControlClusterMoveToHueAndSaturationCallback(uint8_t hue, uint8
     }
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_HSV);
 
-    // now, kick off the state machine.
-    initHueSat(endpoint);
-
-    colorHueTransitionState.initialHue     = currentHue;
-    colorHueTransitionState.currentHue     = currentHue;
-    colorHueTransitionState.finalHue       = hue;
-    colorHueTransitionState.stepsRemaining = transitionTime;
-    colorHueTransitionState.stepsTotal     = transitionTime;
-    colorHueTransitionState.endpoint       = endpoint;
-    colorHueTransitionState.up             = moveUp;
-    colorHueTransitionState.repeat         = false;
-
-    colorSaturationTransitionState.initialValue   = readSaturation(endpoint);
-    colorSaturationTransitionState.currentValue   = readSaturation(endpoint);
-    colorSaturationTransitionState.finalValue     = saturation;
-    colorSaturationTransitionState.stepsRemaining = transitionTime;
-    colorSaturationTransitionState.stepsTotal     = transitionTime;
-    colorSaturationTransitionState.endpoint       = endpoint;
-    colorSaturationTransitionState.lowLimit       = MIN_SATURATION_VALUE;
-    colorSaturationTransitionState.highLimit      = MAX_SATURATION_VALUE;
+    // now, kick off the transitions.
+    if (moveUp)
+    {
+        startHueTransition(endpoint, currentHue, hueDistance(currentHue, hue), transitionTime, false);
+    }
+    else
+    {
+        startHueTransition(endpoint, currentHue, -hueDistance(hue, currentHue), transitionTime, false);
+    }
+    startSaturationTransition(endpoint, readSaturation(endpoint), saturation, transitionTime);
 
     writeRemainingTime(endpoint, transitionTime);
 
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_HSV_CONTROL, UPDATE_TIME_MS);
-
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
 }
@@ -428,6 +388,7 @@ bool emberAfColorControlClusterMoveToHueAndSaturationCallback(uint8_t hue, uint8
 bool emberAfColorControlClusterMoveHueCallback(uint8_t moveMode, uint8_t rate, uint8_t optionsMask, uint8_t optionsOverride)
 {
     EndpointId endpoint = emberAfCurrentEndpoint();
+    int32_t delta;
 
     if (!shouldExecuteIfOff(endpoint, optionsMask, optionsOverride))
     {
@@ -436,7 +397,7 @@ bool emberAfColorControlClusterMoveHueCallback(uint8_t moveMode, uint8_t rate, u
     }
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     if (moveMode == EMBER_ZCL_HUE_MOVE_MODE_STOP)
     {
@@ -444,42 +405,30 @@ bool emberAfColorControlClusterMoveHueCallback(uint8_t moveMode, uint8_t rate, u
         return true;
     }
 
-    // Handle color mode transition, if necessary.
-    handleModeSwitch(endpoint, COLOR_MODE_HSV);
-
-    // now, kick off the state machine.
-    initHueSat(endpoint);
-
-    colorHueTransitionState.initialHue = readHue(endpoint);
-    colorHueTransitionState.currentHue = readHue(endpoint);
     if (moveMode == EMBER_ZCL_HUE_MOVE_MODE_UP)
     {
-        colorHueTransitionState.finalHue = addHue(readHue(endpoint), rate);
-        colorHueTransitionState.up       = true;
+        delta = rate;
     }
     else if (moveMode == EMBER_ZCL_HUE_MOVE_MODE_DOWN)
     {
-        colorHueTransitionState.finalHue = subtractHue(readHue(endpoint), rate);
-        colorHueTransitionState.up       = false;
+        delta = -rate;
     }
     else
     {
         emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_MALFORMED_COMMAND);
         return true;
     }
-    colorHueTransitionState.stepsRemaining = TRANSITION_TIME_1S;
-    colorHueTransitionState.stepsTotal     = TRANSITION_TIME_1S;
-    colorHueTransitionState.endpoint       = endpoint;
-    colorHueTransitionState.repeat         = true;
+
+    // Handle color mode transition, if necessary.
+    handleModeSwitch(endpoint, COLOR_MODE_HSV);
+
+    // now, kick off the transition: rate steps every second, until stopped.
+    startHueTransition(endpoint, readHue(endpoint), delta, TRANSITION_TIME_1S, true);
+
     // hue movement can last forever.  Indicate this with a remaining time of
     // maxint.
     writeRemainingTime(endpoint, MAX_INT16U_VALUE);
 
-    colorSaturationTransitionState.stepsRemaining = 0;
-
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_HSV_CONTROL, UPDATE_TIME_MS);
-
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
 }
@@ -495,9 +444,11 @@ bool emberAfColorControlClusterMoveSaturationCallback(uint8_t moveMode, uint8_t
     }
 
     uint16_t transitionTime;
+    uint8_t currentSaturation;
+    uint8_t finalSaturation;
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     if (moveMode == EMBER_ZCL_SATURATION_MOVE_MODE_STOP || rate == 0)
     {
@@ -508,35 +459,22 @@ bool emberAfColorControlClusterMoveSaturationCallback(uint8_t moveMode, uint8_t
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_HSV);
 
-    // now, kick off the state machine.
-    initHueSat(endpoint);
-
-    colorHueTransitionState.stepsRemaining = 0;
-
-    colorSaturationTransitionState.initialValue = readSaturation(endpoint);
-    colorSaturationTransitionState.currentValue = readSaturation(endpoint);
+    // now, kick off the transition.
+    currentSaturation = readSaturation(endpoint);
     if (moveMode == EMBER_ZCL_SATURATION_MOVE_MODE_UP)
     {
-        colorSaturationTransitionState.finalValue = MAX_SATURATION_VALUE;
+        finalSaturation = MAX_SATURATION_VALUE;
     }
     else
     {
-        colorSaturationTransitionState.finalValue = MIN_SATURATION_VALUE;
+        finalSaturation = MIN_SATURATION_VALUE;
     }
 
-    transitionTime = computeTransitionTimeFromStateAndRate(&colorSaturationTransitionState, rate);
-
-    colorSaturationTransitionState.stepsRemaining = transitionTime;
-    colorSaturationTransitionState.stepsTotal     = transitionTime;
-    colorSaturationTransitionState.endpoint       = endpoint;
-    colorSaturationTransitionState.lowLimit       = MIN_SATURATION_VALUE;
-    colorSaturationTransitionState.highLimit      = MAX_SATURATION_VALUE;
+    transitionTime = computeTransitionTimeFromRate(currentSaturation, finalSaturation, rate);
+    startSaturationTransition(endpoint, currentSaturation, finalSaturation, transitionTime);
 
     writeRemainingTime(endpoint, transitionTime);
 
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_HSV_CONTROL, UPDATE_TIME_MS);
-
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
 }
@@ -606,30 +544,23 @@ bool emberAfColorControlClusterMoveToHueCallback(uint8_t hue, uint8_t hueMoveMod
     }
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_HSV);
 
-    // now, kick off the state machine.
-    initHueSat(endpoint);
-
-    colorHueTransitionState.initialHue     = readHue(endpoint);
-    colorHueTransitionState.currentHue     = readHue(endpoint);
-    colorHueTransitionState.finalHue       = hue;
-    colorHueTransitionState.stepsRemaining = transitionTime;
-    colorHueTransitionState.stepsTotal     = transitionTime;
-    colorHueTransitionState.endpoint       = endpoint;
-    colorHueTransitionState.up             = (direction == MOVE_MODE_UP);
-    colorHueTransitionState.repeat         = false;
-
-    colorSaturationTransitionState.stepsRemaining = 0;
+    // now, kick off the transition.
+    if (direction == MOVE_MODE_UP)
+    {
+        startHueTransition(endpoint, currentHue, hueDistance(currentHue, hue), transitionTime, false);
+    }
+    else
+    {
+        startHueTransition(endpoint, currentHue, -hueDistance(hue, currentHue), transitionTime, false);
+    }
 
     writeRemainingTime(endpoint, transitionTime);
 
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_HSV_CONTROL, UPDATE_TIME_MS);
-
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
 }
@@ -659,30 +590,16 @@ bool emberAfColorControlClusterMoveToSaturationCallback(uint8_t saturation, uint
     }
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_HSV);
 
-    // now, kick off the state machine.
-    initHueSat(endpoint);
-
-    colorHueTransitionState.stepsRemaining = 0;
-
-    colorSaturationTransitionState.initialValue   = readSaturation(endpoint);
-    colorSaturationTransitionState.currentValue   = readSaturation(endpoint);
-    colorSaturationTransitionState.finalValue     = saturation;
-    colorSaturationTransitionState.stepsRemaining = transitionTime;
-    colorSaturationTransitionState.stepsTotal     = transitionTime;
-    colorSaturationTransitionState.endpoint       = endpoint;
-    colorSaturationTransitionState.lowLimit       = MIN_SATURATION_VALUE;
-    colorSaturationTransitionState.highLimit      = MAX_SATURATION_VALUE;
+    // now, kick off the transition.
+    startSaturationTransition(endpoint, readSaturation(endpoint), saturation, transitionTime);
 
     writeRemainingTime(endpoint, transitionTime);
 
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_HSV_CONTROL, UPDATE_TIME_MS);
-
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
 }
@@ -706,7 +623,7 @@ bool emberAfColorControlClusterStepHueCallback(uint8_t stepMode, uint8_t stepSiz
     }
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     if (stepMode == MOVE_MODE_STOP)
     {
@@ -717,34 +634,18 @@ bool emberAfColorControlClusterStepHueCallback(uint8_t stepMode, uint8_t stepSiz
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_HSV);
 
-    // now, kick off the state machine.
-    initHueSat(endpoint);
-
-    colorHueTransitionState.initialHue = currentHue;
-    colorHueTransitionState.currentHue = currentHue;
-
+    // now, kick off the transition.
     if (stepMode == MOVE_MODE_UP)
     {
-        colorHueTransitionState.finalHue = addHue(currentHue, stepSize);
-        colorHueTransitionState.up       = true;
+        startHueTransition(endpoint, currentHue, stepSize, transitionTime, false);
     }
     else
     {
-        colorHueTransitionState.finalHue = subtractHue(currentHue, stepSize);
-        colorHueTransitionState.up       = false;
+        startHueTransition(endpoint, currentHue, -stepSize, transitionTime, false);
     }
-    colorHueTransitionState.stepsRemaining = transitionTime;
-    colorHueTransitionState.stepsTotal     = transitionTime;
-    colorHueTransitionState.endpoint       = endpoint;
-    colorHueTransitionState.repeat         = false;
-
-    colorSaturationTransitionState.stepsRemaining = 0;
 
     writeRemainingTime(endpoint, transitionTime);
 
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_HSV_CONTROL, UPDATE_TIME_MS);
-
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
 }
@@ -761,6 +662,7 @@ bool emberAfColorControlClusterStepSaturationCallback(uint8_t stepMode, uint8_t
     }
 
     uint8_t currentSaturation = readSaturation(endpoint);
+    uint8_t finalSaturation;
 
     if (transitionTime == 0)
     {
@@ -768,7 +670,7 @@ bool emberAfColorControlClusterStepSaturationCallback(uint8_t stepMode, uint8_t
     }
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     if (stepMode == MOVE_MODE_STOP)
     {
@@ -779,33 +681,19 @@ bool emberAfColorControlClusterStepSaturationCallback(uint8_t stepMode, uint8_t
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_HSV);
 
-    // now, kick off the state machine.
-    initHueSat(endpoint);
-
-    colorHueTransitionState.stepsRemaining = 0;
-
-    colorSaturationTransitionState.initialValue = currentSaturation;
-    colorSaturationTransitionState.currentValue = currentSaturation;
-
+    // now, kick off the transition.
     if (stepMode == MOVE_MODE_UP)
     {
-        colorSaturationTransitionState.finalValue = addSaturation(currentSaturation, stepSize);
+        finalSaturation = addSaturation(currentSaturation, stepSize);
     }
     else
     {
-        colorSaturationTransitionState.finalValue = subtractSaturation(currentSaturation, stepSize);
+        finalSaturation = subtractSaturation(currentSaturation, stepSize);
     }
-    colorSaturationTransitionState.stepsRemaining = transitionTime;
-    colorSaturationTransitionState.stepsTotal     = transitionTime;
-    colorSaturationTransitionState.endpoint       = endpoint;
-    colorSaturationTransitionState.lowLimit       = MIN_SATURATION_VALUE;
-    colorSaturationTransitionState.highLimit      = MAX_SATURATION_VALUE;
+    startSaturationTransition(endpoint, currentSaturation, finalSaturation, transitionTime);
 
     writeRemainingTime(endpoint, transitionTime);
 
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_HSV_CONTROL, UPDATE_TIME_MS);
-
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
 }
@@ -835,18 +723,24 @@ static uint8_t subtractSaturation(uint8_t saturation1, uint8_t saturation2)
     return static_cast<uint8_t>(saturation1 - saturation2);
 }
 
-// any time we call a hue or saturation transition, we need to assume certain
-// things about the hue and saturation data structures.  This function will
-// properly initialize them.
-static void initHueSat(EndpointId endpoint)
+static void startHueTransition(EndpointId endpoint, uint8_t initialHue, int32_t delta, uint16_t transitionTime, bool repeat)
 {
-    colorHueTransitionState.stepsRemaining = 0;
-    colorHueTransitionState.currentHue     = readHue(endpoint);
-    colorHueTransitionState.endpoint       = endpoint;
+    startTransition(endpoint, ZCL_COLOR_CONTROL_CURRENT_HUE_ATTRIBUTE_ID, ZCL_INT8U_ATTRIBUTE_TYPE, initialHue, delta,
+                    transitionTime, HUE_MODULO, repeat);
+}
 
-    colorSaturationTransitionState.stepsRemaining = 0;
-    colorSaturationTransitionState.currentValue   = readSaturation(endpoint);
-    colorSaturationTransitionState.endpoint       = endpoint;
+static void startSaturationTransition(EndpointId endpoint, uint8_t initialSaturation, uint8_t finalSaturation,
+                                      uint16_t transitionTime)
+{
+    startTransition(endpoint, ZCL_COLOR_CONTROL_CURRENT_SATURATION_ATTRIBUTE_ID, ZCL_INT8U_ATTRIBUTE_TYPE, initialSaturation,
+                    finalSaturation - initialSaturation, transitionTime, 0, false);
+}
+
+// The distance from one hue up to another, going round the hue circle if
+// needed.
+static uint8_t hueDistance(uint8_t fromHue, uint8_t toHue)
+{
+    return static_cast<uint8_t>((toHue + HUE_MODULO - fromHue) % HUE_MODULO);
 }
 
 static uint8_t readHue(EndpointId endpoint)
@@ -898,35 +792,16 @@ bool emberAfColorControlClusterMoveToColorCallback(uint16_t colorX, uint16_t col
     }
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_CIE_XY);
 
-    // now, kick off the state machine.
-    colorXTransitionState.initialValue   = readColorX(endpoint);
-    colorXTransitionState.currentValue   = readColorX(endpoint);
-    colorXTransitionState.finalValue     = colorX;
-    colorXTransitionState.stepsRemaining = transitionTime;
-    colorXTransitionState.stepsTotal     = transitionTime;
-    colorXTransitionState.endpoint       = endpoint;
-    colorXTransitionState.lowLimit       = MIN_CIE_XY_VALUE;
-    colorXTransitionState.highLimit      = MAX_CIE_XY_VALUE;
-
-    colorYTransitionState.initialValue   = readColorY(endpoint);
-    colorYTransitionState.currentValue   = readColorY(endpoint);
-    colorYTransitionState.finalValue     = colorY;
-    colorYTransitionState.stepsRemaining = transitionTime;
-    colorYTransitionState.stepsTotal     = transitionTime;
-    colorYTransitionState.endpoint       = endpoint;
-    colorYTransitionState.lowLimit       = MIN_CIE_XY_VALUE;
-    colorYTransitionState.highLimit      = MAX_CIE_XY_VALUE;
+    // now, kick off the transitions.
+    startColorXyTransition(endpoint, colorX, colorY, transitionTime);
 
     writeRemainingTime(endpoint, transitionTime);
 
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_XY_CONTROL, UPDATE_TIME_MS);
-
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
 }
@@ -941,11 +816,11 @@ bool emberAfColorControlClusterMoveColorCallback(int16_t rateX, int16_t rateY, u
         return true;
     }
 
-    uint16_t transitionTimeX, transitionTimeY;
-    uint16_t unsignedRate;
+    uint16_t transitionTimeX, transitionTimeY, transitionTime;
+    uint16_t currentX, currentY, limitX, limitY;
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     if (rateX == 0 && rateY == 0)
     {
@@ -956,56 +831,28 @@ bool emberAfColorControlClusterMoveColorCallback(int16_t rateX, int16_t rateY, u
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_CIE_XY);
 
-    // now, kick off the state machine.
-    colorXTransitionState.initialValue = readColorX(endpoint);
-    colorXTransitionState.currentValue = colorXTransitionState.initialValue;
-    if (rateX > 0)
-    {
-        colorXTransitionState.finalValue = MAX_CIE_XY_VALUE;
-        unsignedRate                     = (uint16_t) rateX;
-    }
-    else
-    {
-        colorXTransitionState.finalValue = MIN_CIE_XY_VALUE;
-        unsignedRate                     = (uint16_t)(rateX * -1);
-    }
-    transitionTimeX                      = computeTransitionTimeFromStateAndRate(&colorXTransitionState, unsignedRate);
-    colorXTransitionState.stepsRemaining = transitionTimeX;
-    colorXTransitionState.stepsTotal     = transitionTimeX;
-    colorXTransitionState.endpoint       = endpoint;
-    colorXTransitionState.lowLimit       = MIN_CIE_XY_VALUE;
-    colorXTransitionState.highLimit      = MAX_CIE_XY_VALUE;
-
-    colorYTransitionState.initialValue = readColorY(endpoint);
-    colorYTransitionState.currentValue = colorYTransitionState.initialValue;
-    if (rateY > 0)
-    {
-        colorYTransitionState.finalValue = MAX_CIE_XY_VALUE;
-        unsignedRate                     = (uint16_t) rateY;
-    }
-    else
-    {
-        colorYTransitionState.finalValue = MIN_CIE_XY_VALUE;
-        unsignedRate                     = (uint16_t)(rateY * -1);
-    }
-    transitionTimeY                      = computeTransitionTimeFromStateAndRate(&colorYTransitionState, unsignedRate);
-    colorYTransitionState.stepsRemaining = transitionTimeY;
-    colorYTransitionState.stepsTotal     = transitionTimeY;
-    colorYTransitionState.endpoint       = endpoint;
-    colorYTransitionState.lowLimit       = MIN_CIE_XY_VALUE;
-    colorYTransitionState.highLimit      = MAX_CIE_XY_VALUE;
+    // Both coordinates move at their own rate until the first of them
+    // reaches its limit.
+    currentX        = readColorX(endpoint);
+    currentY        = readColorY(endpoint);
+    limitX          = (rateX > 0) ? MAX_CIE_XY_VALUE : MIN_CIE_XY_VALUE;
+    limitY          = (rateY > 0) ? MAX_CIE_XY_VALUE : MIN_CIE_XY_VALUE;
+    transitionTimeX = computeTransitionTimeFromRate(currentX, limitX, static_cast<uint16_t>((rateX > 0) ? rateX : -rateX));
+    transitionTimeY = computeTransitionTimeFromRate(currentY, limitY, static_cast<uint16_t>((rateY > 0) ? rateY : -rateY));
+    transitionTime  = (transitionTimeX < transitionTimeY) ? transitionTimeX : transitionTimeY;
 
-    if (transitionTimeX < transitionTimeY)
+    // now, kick off the transitions.
+    if (transitionTimeX > transitionTime)
     {
-        writeRemainingTime(endpoint, transitionTimeX);
+        limitX = findNewColorValueFromRate(currentX, rateX, transitionTime);
     }
-    else
+    if (transitionTimeY > transitionTime)
     {
-        writeRemainingTime(endpoint, transitionTimeY);
+        limitY = findNewColorValueFromRate(currentY, rateY, transitionTime);
     }
+    startColorXyTransition(endpoint, limitX, limitY, transitionTime);
 
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_XY_CONTROL, UPDATE_TIME_MS);
+    writeRemainingTime(endpoint, transitionTime);
 
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
@@ -1031,39 +878,48 @@ bool emberAfColorControlClusterStepColorCallback(int16_t stepX, int16_t stepY, u
     }
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_CIE_XY);
 
-    // now, kick off the state machine.
-    colorXTransitionState.initialValue   = readColorX(endpoint);
-    colorXTransitionState.currentValue   = readColorX(endpoint);
-    colorXTransitionState.finalValue     = colorX;
-    colorXTransitionState.stepsRemaining = transitionTime;
-    colorXTransitionState.stepsTotal     = transitionTime;
-    colorXTransitionState.endpoint       = endpoint;
-    colorXTransitionState.lowLimit       = MIN_CIE_XY_VALUE;
-    colorXTransitionState.highLimit      = MAX_CIE_XY_VALUE;
-
-    colorYTransitionState.initialValue   = readColorY(endpoint);
-    colorYTransitionState.currentValue   = readColorY(endpoint);
-    colorYTransitionState.finalValue     = colorY;
-    colorYTransitionState.stepsRemaining = transitionTime;
-    colorYTransitionState.stepsTotal     = transitionTime;
-    colorYTransitionState.endpoint       = endpoint;
-    colorYTransitionState.lowLimit       = MIN_CIE_XY_VALUE;
-    colorYTransitionState.highLimit      = MAX_CIE_XY_VALUE;
+    // now, kick off the transitions.
+    startColorXyTransition(endpoint, colorX, colorY, transitionTime);
 
     writeRemainingTime(endpoint, transitionTime);
 
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_XY_CONTROL, UPDATE_TIME_MS);
-
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
 }
 
+static void startColorXyTransition(EndpointId endpoint, uint16_t colorX, uint16_t colorY, uint16_t transitionTime)
+{
+    uint16_t currentX = readColorX(endpoint);
+    uint16_t currentY = readColorY(endpoint);
+
+    startTransition(endpoint, ZCL_COLOR_CONTROL_CURRENT_X_ATTRIBUTE_ID, ZCL_INT16U_ATTRIBUTE_TYPE, currentX, colorX - currentX,
+                    transitionTime, 0, false);
+    startTransition(endpoint, ZCL_COLOR_CONTROL_CURRENT_Y_ATTRIBUTE_ID, ZCL_INT16U_ATTRIBUTE_TYPE, currentY, colorY - currentY,
+                    transitionTime, 0, false);
+}
+
+// The value reached moving at rate per second for transitionTime tenths of a
+// second.
+static uint16_t findNewColorValueFromRate(uint16_t oldValue, int16_t rate, uint16_t transitionTime)
+{
+    int32_t step = static_cast<int32_t>(rate) * transitionTime / TRANSITION_TIME_1S;
+
+    if (step > INT16_MAX)
+    {
+        step = INT16_MAX;
+    }
+    else if (step < INT16_MIN)
+    {
+        step = INT16_MIN;
+    }
+    return findNewColorValueFromStep(oldValue, static_cast<int16_t>(step));
+}
+
 static uint16_t findNewColorValueFromStep(uint16_t oldValue, int16_t step)
 {
     uint16_t newValue;
@@ -1119,6 +975,14 @@ static uint16_t readColorY(EndpointId endpoint)
 
 #ifdef EMBER_AF_PLUGIN_COLOR_CONTROL_SERVER_TEMP
 
+static void startColorTemperatureTransition(EndpointId endpoint, uint16_t colorTemperature, uint16_t transitionTime)
+{
+    uint16_t currentColorTemperature = readColorTemperature(endpoint);
+
+    startTransition(endpoint, ZCL_COLOR_CONTROL_COLOR_TEMPERATURE_ATTRIBUTE_ID, ZCL_INT16U_ATTRIBUTE_TYPE, currentColorTemperature,
+                    colorTemperature - currentColorTemperature, transitionTime, 0, false);
+}
+
 static void moveToColorTemp(EndpointId endpoint, uint16_t colorTemperature, uint16_t transitionTime)
 {
     uint16_t temperatureMin = readColorTemperatureMin(endpoint);
@@ -1130,7 +994,7 @@ static void moveToColorTemp(EndpointId endpoint, uint16_t colorTemperature, uint
     }
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_TEMPERATURE);
@@ -1145,18 +1009,8 @@ static void moveToColorTemp(EndpointId endpoint, uint16_t colorTemperature, uint
         colorTemperature = temperatureMax;
     }
 
-    // now, kick off the state machine.
-    colorTempTransitionState.initialValue   = readColorTemperature(endpoint);
-    colorTempTransitionState.currentValue   = readColorTemperature(endpoint);
-    colorTempTransitionState.finalValue     = colorTemperature;
-    colorTempTransitionState.stepsRemaining = transitionTime;
-    colorTempTransitionState.stepsTotal     = transitionTime;
-    colorTempTransitionState.endpoint       = endpoint;
-    colorTempTransitionState.lowLimit       = temperatureMin;
-    colorTempTransitionState.highLimit      = temperatureMax;
-
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_TEMP_CONTROL, UPDATE_TIME_MS);
+    // now, kick off the transition.
+    startColorTemperatureTransition(endpoint, colorTemperature, transitionTime);
 }
 
 bool emberAfColorControlClusterMoveToColorTemperatureCallback(uint16_t colorTemperature, uint16_t transitionTime,
@@ -1191,9 +1045,11 @@ bool emberAfColorControlClusterMoveColorTemperatureCallback(uint8_t moveMode, ui
     uint16_t tempPhysicalMin = readColorTemperatureMin(endpoint);
     uint16_t tempPhysicalMax = readColorTemperatureMax(endpoint);
     uint16_t transitionTime;
+    uint16_t currentColorTemperature;
+    uint16_t finalColorTemperature;
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     if (moveMode == MOVE_MODE_STOP)
     {
@@ -1219,43 +1075,35 @@ bool emberAfColorControlClusterMoveColorTemperatureCallback(uint8_t moveMode, ui
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_TEMPERATURE);
 
-    // now, kick off the state machine.
-    colorTempTransitionState.initialValue = readColorTemperature(endpoint);
-    colorTempTransitionState.currentValue = readColorTemperature(endpoint);
+    // now, kick off the transition.
+    currentColorTemperature = readColorTemperature(endpoint);
     if (moveMode == MOVE_MODE_UP)
     {
         if (tempPhysicalMax > colorTemperatureMaximum)
         {
-            colorTempTransitionState.finalValue = colorTemperatureMaximum;
+            finalColorTemperature = colorTemperatureMaximum;
         }
         else
         {
-            colorTempTransitionState.finalValue = tempPhysicalMax;
+            finalColorTemperature = tempPhysicalMax;
         }
     }
     else
     {
         if (tempPhysicalMin < colorTemperatureMinimum)
         {
-            colorTempTransitionState.finalValue = colorTemperatureMinimum;
+            finalColorTemperature = colorTemperatureMinimum;
         }
         else
         {
-            colorTempTransitionState.finalValue = tempPhysicalMin;
+            finalColorTemperature = tempPhysicalMin;
         }
     }
-    transitionTime                          = computeTransitionTimeFromStateAndRate(&colorTempTransitionState, rate);
-    colorTempTransitionState.stepsRemaining = transitionTime;
-    colorTempTransitionState.stepsTotal     = transitionTime;
-    colorTempTransitionState.endpoint       = endpoint;
-    colorTempTransitionState.lowLimit       = colorTemperatureMinimum;
-    colorTempTransitionState.highLimit      = colorTemperatureMaximum;
+    transitionTime = computeTransitionTimeFromRate(currentColorTemperature, finalColorTemperature, rate);
+    startColorTemperatureTransition(endpoint, finalColorTemperature, transitionTime);
 
     writeRemainingTime(endpoint, transitionTime);
 
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_TEMP_CONTROL, UPDATE_TIME_MS);
-
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
 }
@@ -1281,7 +1129,7 @@ bool emberAfColorControlClusterStepColorTemperatureCallback(uint8_t stepMode, ui
     }
 
     // New command.  Need to stop any active transitions.
-    stopAllColorTransitions();
+    stopAllColorTransitions(endpoint);
 
     if (stepMode == MOVE_MODE_STOP)
     {
@@ -1301,28 +1149,20 @@ bool emberAfColorControlClusterStepColorTemperatureCallback(uint8_t stepMode, ui
     // Handle color mode transition, if necessary.
     handleModeSwitch(endpoint, COLOR_MODE_TEMPERATURE);
 
-    // now, kick off the state machine.
-    colorTempTransitionState.initialValue = readColorTemperature(endpoint);
-    colorTempTransitionState.currentValue = readColorTemperature(endpoint);
+    // now, kick off the transition.
     if (stepMode == MOVE_MODE_UP)
     {
-        colorTempTransitionState.finalValue = static_cast<uint16_t>(readColorTemperature(endpoint) + stepSize);
+        startColorTemperatureTransition(endpoint, static_cast<uint16_t>(readColorTemperature(endpoint) + stepSize),
+                                        transitionTime);
     }
     else
     {
-        colorTempTransitionState.finalValue = static_cast<uint16_t>(readColorTemperature(endpoint) - stepSize);
+        startColorTemperatureTransition(endpoint, static_cast<uint16_t>(readColorTemperature(endpoint) - stepSize),
+                                        transitionTime);
     }
-    colorTempTransitionState.stepsRemaining = transitionTime;
-    colorTempTransitionState.stepsTotal     = transitionTime;
-    colorTempTransitionState.endpoint       = endpoint;
-    colorTempTransitionState.lowLimit       = colorTemperatureMinimum;
-    colorTempTransitionState.highLimit      = colorTemperatureMaximum;
 
     writeRemainingTime(endpoint, transitionTime);
 
-    // kick off the state machine:
-    emberEventControlSetDelayMS(&COLOR_TEMP_CONTROL, UPDATE_TIME_MS);
-
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
     return true;
 }
@@ -1404,7 +1244,7 @@ bool emberAfColorControlClusterStopMoveStepCallback(uint8_t optionsMask, uint8_t
 
     if (shouldExecuteIfOff(endpoint, optionsMask, optionsOverride))
     {
-        stopAllColorTransitions();
+        stopAllColorTransitions(endpoint);
     }
 
     emberAfSendImmediateDefaultResponse(EMBER_ZCL_STATUS_SUCCESS);
@@ -1413,16 +1253,73 @@ bool emberAfColorControlClusterStopMoveStepCallback(uint8_t optionsMask, uint8_t
 
 // **************** transition state machines ***********
 
-static void stopAllColorTransitions(void)
+static void stopAllColorTransitions(EndpointId endpoint)
 {
-    emberEventControlSetInactive(&COLOR_TEMP_CONTROL);
-    emberEventControlSetInactive(&COLOR_XY_CONTROL);
-    emberEventControlSetInactive(&COLOR_HSV_CONTROL);
+    emberAfStopTransitions(endpoint, ZCL_COLOR_CONTROL_CLUSTER_ID);
 }
 
 void emberAfPluginColorControlServerStopTransition(void)
 {
-    stopAllColorTransitions();
+    uint8_t i;
+
+    for (i = 0; i < emberAfEndpointCount(); i++)
+    {
+        stopAllColorTransitions(emberAfEndpointFromIndex(i));
+    }
+}
+
+// Moves an attribute by delta over transitionTime tenths of a second on the
+// shared transition scheduler, which calls transitionCallback on each tick.
+static void startTransition(EndpointId endpoint, AttributeId attributeId, EmberAfAttributeType attributeType,
+                            uint16_t initialValue, int32_t delta, uint16_t transitionTime, uint16_t modulo, bool repeat)
+{
+    EmberAfTransition transition;
+
+    transition.endpoint      = endpoint;
+    transition.clusterId     = ZCL_COLOR_CONTROL_CLUSTER_ID;
+    transition.attributeId   = attributeId;
+    transition.attributeType = attributeType;
+    transition.startValue    = initialValue;
+    transition.delta         = delta;
+    transition.durationMs    = static_cast<uint32_t>(transitionTime) * MILLISECOND_TICKS_PER_SECOND / TRANSITION_TIME_1S;
+    transition.modulo        = modulo;
+    transition.repeat        = repeat;
+    transition.callback      = transitionCallback;
+
+    if (emberAfStartTransition(&transition) != EMBER_SUCCESS)
+    {
+        emberAfColorControlClusterPrintln("ERR: starting transition of attribute 0x%2x", attributeId);
+    }
+}
+
+// Called once per tick with the attributes of all of the transitions of the
+// endpoint already written.
+static void transitionCallback(EndpointId endpoint, ClusterId clusterId, uint32_t remainingMs)
+{
+    uint32_t remainingTime;
+
+    // A Move Hue keeps the maxint remaining time it started with.
+    if (remainingMs != EMBER_AF_TRANSITION_FOREVER)
+    {
+        remainingTime = (remainingMs + (MILLISECOND_TICKS_PER_SECOND / TRANSITION_TIME_1S) - 1) /
+            (MILLISECOND_TICKS_PER_SECOND / TRANSITION_TIME_1S);
+        writeRemainingTime(endpoint, (remainingTime > MAX_INT16U_VALUE) ? MAX_INT16U_VALUE : (uint16_t) remainingTime);
+    }
+
+    switch (readColorMode(endpoint))
+    {
+    case COLOR_MODE_HSV:
+        emberAfPluginColorControlServerComputePwmFromHsvCallback(endpoint);
+        break;
+    case COLOR_MODE_CIE_XY:
+        emberAfPluginColorControlServerComputePwmFromXyCallback(endpoint);
+        break;
+    case COLOR_MODE_TEMPERATURE:
+        emberAfPluginColorControlServerComputePwmFromTempCallback(endpoint);
+        break;
+    default:
+        break;
+    }
 }
 
 // The specification says that if we are transitioning from one color mode
@@ -1478,178 +1375,12 @@ static void handleModeSwitch(EndpointId endpoint, uint8_t newColorMode)
     }
 }
 
-static uint8_t addHue(uint8_t hue1, uint8_t hue2)
-{
-    uint16_t hue16;
-
-    hue16 = ((uint16_t) hue1);
-    hue16 = static_cast<uint16_t>(hue16 + static_cast<uint16_t>(hue2));
-
-    if (hue16 > MAX_HUE_VALUE)
-    {
-        hue16 = static_cast<uint16_t>(hue16 - MAX_HUE_VALUE);
-    }
-
-    return ((uint8_t) hue16);
-}
-
-static uint8_t subtractHue(uint8_t hue1, uint8_t hue2)
-{
-    uint16_t hue16;
-
-    hue16 = ((uint16_t) hue1);
-    if (hue2 > hue1)
-    {
-        hue16 = static_cast<uint16_t>(hue16 + MAX_HUE_VALUE);
-    }
-
-    hue16 = static_cast<uint16_t>(hue16 - static_cast<uint16_t>(hue2));
-
-    return ((uint8_t) hue16);
-}
-
-static bool computeNewHueValue(ColorHueTransitionState * p)
-{
-    uint32_t newHue32;
-    uint8_t newHue;
-
-    // exit with a false if hue is not currently moving
-    if (p->stepsRemaining == 0)
-    {
-        return false;
-    }
-
-    (p->stepsRemaining)--;
-
-    if (p->repeat == false)
-    {
-        writeRemainingTime(p->endpoint, p->stepsRemaining);
-    }
-
-    // are we going up or down?
-    if (p->finalHue == p->currentHue)
-    {
-        // do nothing
-    }
-    else if (p->up)
-    {
-        newHue32 = (uint32_t) subtractHue(p->finalHue, p->initialHue);
-        newHue32 *= ((uint32_t)(p->stepsRemaining));
-        newHue32 /= ((uint32_t)(p->stepsTotal));
-        p->currentHue = subtractHue((uint8_t) p->finalHue, (uint8_t) newHue32);
-    }
-    else
-    {
-        newHue32 = (uint32_t) subtractHue(p->initialHue, p->finalHue);
-        newHue32 *= ((uint32_t)(p->stepsRemaining));
-        newHue32 /= ((uint32_t)(p->stepsTotal));
-
-        p->currentHue = addHue((uint8_t) p->finalHue, (uint8_t) newHue32);
-    }
-
-    if (p->stepsRemaining == 0)
-    {
-        if (p->repeat == false)
-        {
-            // we are performing a move to and not a move.
-            return true;
-        }
-        else
-        {
-            // we are performing a Hue move.  Need to compute the new values for the
-            // next move period.
-            if (p->up)
-            {
-                newHue = subtractHue(p->finalHue, p->initialHue);
-                newHue = addHue(p->finalHue, newHue);
-
-                p->initialHue = p->finalHue;
-                p->finalHue   = newHue;
-            }
-            else
-            {
-                newHue = subtractHue(p->initialHue, p->finalHue);
-                newHue = subtractHue(p->finalHue, newHue);
-
-                p->initialHue = p->finalHue;
-                p->finalHue   = newHue;
-            }
-            p->stepsRemaining = TRANSITION_TIME_1S;
-        }
-    }
-    return false;
-}
-
 void emberAfPluginColorControlServerHueSatTransitionEventHandler(void)
 {
-    EndpointId endpoint = colorHueTransitionState.endpoint;
-    bool limitReached1, limitReached2;
-
-    limitReached1 = computeNewHueValue(&colorHueTransitionState);
-    limitReached2 = computeNewColor16uValue(&colorSaturationTransitionState);
-
-    if (limitReached1 || limitReached2)
-    {
-        stopAllColorTransitions();
-    }
-    else
-    {
-        emberEventControlSetDelayMS(&COLOR_HSV_CONTROL, UPDATE_TIME_MS);
-    }
-
-    writeHue(colorHueTransitionState.endpoint, colorHueTransitionState.currentHue);
-    writeSaturation(colorSaturationTransitionState.endpoint, (uint8_t) colorSaturationTransitionState.currentValue);
-
-    emberAfColorControlClusterPrintln("Hue %d Saturation %d endpoint %d", colorHueTransitionState.currentHue,
-                                      colorSaturationTransitionState.currentValue, endpoint);
-
-    emberAfPluginColorControlServerComputePwmFromHsvCallback(endpoint);
+    emberAfAdvanceTransitions();
 }
 
-// Return value of true means we need to stop.
-static bool computeNewColor16uValue(Color16uTransitionState * p)
-{
-    uint32_t newValue32u;
-
-    if (p->stepsRemaining == 0)
-    {
-        return false;
-    }
-
-    (p->stepsRemaining)--;
-
-    writeRemainingTime(p->endpoint, p->stepsRemaining);
-
-    // handle sign
-    if (p->finalValue == p->currentValue)
-    {
-        // do nothing
-    }
-    else if (p->finalValue > p->initialValue)
-    {
-        newValue32u = ((uint32_t)(p->finalValue - p->initialValue));
-        newValue32u *= ((uint32_t)(p->stepsRemaining));
-        newValue32u /= ((uint32_t)(p->stepsTotal));
-        p->currentValue = static_cast<uint16_t>(p->finalValue - static_cast<uint16_t>(newValue32u));
-    }
-    else
-    {
-        newValue32u = ((uint32_t)(p->initialValue - p->finalValue));
-        newValue32u *= ((uint32_t)(p->stepsRemaining));
-        newValue32u /= ((uint32_t)(p->stepsTotal));
-        p->currentValue = static_cast<uint16_t>(p->finalValue + static_cast<uint16_t>(newValue32u));
-    }
-
-    if (p->stepsRemaining == 0)
-    {
-        // we have completed our move.
-        return true;
-    }
-
-    return false;
-}
-
-static uint16_t computeTransitionTimeFromStateAndRate(Color16uTransitionState * p, uint16_t rate)
+static uint16_t computeTransitionTimeFromRate(uint16_t currentValue, uint16_t finalValue, uint16_t rate)
 {
     uint32_t transitionTime;
     uint16_t max, min;
@@ -1659,15 +1390,15 @@ static uint16_t computeTransitionTimeFromStateAndRate(Color16uTransitionState *
         return MAX_INT16U_VALUE;
     }
 
-    if (p->currentValue > p->finalValue)
+    if (currentValue > finalValue)
     {
-        max = p->currentValue;
-        min = p->finalValue;
+        max = currentValue;
+        min = finalValue;
     }
     else
     {
-        max = p->finalValue;
-        min = p->currentValue;
+        max = finalValue;
+        min = currentValue;
     }
 
     transitionTime = max - min;
@@ -1684,54 +1415,12 @@ static uint16_t computeTransitionTimeFromStateAndRate(Color16uTransitionState *
 
 void emberAfPluginColorControlServerXyTransitionEventHandler(void)
 {
-    EndpointId endpoint = colorXTransitionState.endpoint;
-    bool limitReachedX, limitReachedY;
-
-    // compute new values for X and Y.
-    limitReachedX = computeNewColor16uValue(&colorXTransitionState);
-
-    limitReachedY = computeNewColor16uValue(&colorYTransitionState);
-
-    if (limitReachedX || limitReachedY)
-    {
-        stopAllColorTransitions();
-    }
-    else
-    {
-        emberEventControlSetDelayMS(&COLOR_XY_CONTROL, UPDATE_TIME_MS);
-    }
-
-    // update the attributes
-    writeColorX(colorXTransitionState.endpoint, colorXTransitionState.currentValue);
-    writeColorY(colorXTransitionState.endpoint, colorYTransitionState.currentValue);
-
-    emberAfColorControlClusterPrintln("Color X %d Color Y %d", colorXTransitionState.currentValue,
-                                      colorYTransitionState.currentValue);
-
-    emberAfPluginColorControlServerComputePwmFromXyCallback(endpoint);
+    emberAfAdvanceTransitions();
 }
 
 void emberAfPluginColorControlServerTempTransitionEventHandler(void)
 {
-    EndpointId endpoint = colorTempTransitionState.endpoint;
-    bool limitReached;
-
-    limitReached = computeNewColor16uValue(&colorTempTransitionState);
-
-    if (limitReached)
-    {
-        stopAllColorTransitions();
-    }
-    else
-    {
-        emberEventControlSetDelayMS(&COLOR_TEMP_CONTROL, UPDATE_TIME_MS);
-    }
-
-    writeColorTemperature(colorTempTransitionState.endpoint, colorTempTransitionState.currentValue);
-
-    emberAfColorControlClusterPrintln("Color Temperature %d", colorTempTransitionState.currentValue);
-
-    emberAfPluginColorControlServerComputePwmFromTempCallback(endpoint);
+    emberAfAdvanceTransitions();
 }
 
 static bool shouldExecuteIfOff(EndpointId endpoint, uint8_t optionMask, uint8_t optionOverride)
@@ -44,6 +44,9 @@
 // this file contains all the common includes for clusters in the util
 #include <app/util/af.h>
 
+#include <app/util/af-transition.h>
+#include <app/util/attribute-storage.h>
+
 #include "gen/af-structs.h"
 #include "gen/attribute-id.h"
 #include "gen/attribute-type.h"
@@ -66,8 +69,6 @@
 #include "app/framework/plugin/zll-level-control-server/zll-level-control-server.h"
 #endif // EMBER_AF_PLUGIN_ZLL_LEVEL_CONTROL_SERVER
 
-#include <assert.h>
-
 using namespace chip;
 
 #ifdef ZCL_USING_LEVEL_CONTROL_CLUSTER_START_UP_CURRENT_LEVEL_ATTRIBUTE
@@ -101,12 +102,12 @@ typedef struct
     bool useOnLevel;
     uint8_t onLevel;
     uint16_t storedLevel;
-    uint32_t eventDurationMs;
     uint32_t transitionTimeMs;
-    uint32_t elapsedTimeMs;
 } EmberAfLevelControlState;
 
-static EmberAfLevelControlState stateTable[EMBER_AF_LEVEL_CONTROL_CLUSTER_SERVER_ENDPOINT_COUNT];
+// Indexed by endpoint index, so that endpoints registered at runtime have a
+// state too.
+static EmberAfLevelControlState stateTable[MAX_ENDPOINT_COUNT];
 
 static EmberAfLevelControlState * getState(EndpointId endpoint);
 
@@ -118,7 +119,7 @@ static void stepHandler(CommandId commandId, uint8_t stepMode, uint8_t stepSize,
 static void stopHandler(CommandId commandId, uint8_t optionMask, uint8_t optionOverride);
 
 static void setOnOffValue(EndpointId endpoint, bool onOff);
-static void writeRemainingTime(EndpointId endpoint, uint16_t remainingTimeMs);
+static void writeRemainingTime(EndpointId endpoint, uint32_t remainingTimeMs);
 static bool shouldExecuteIfOff(EndpointId endpoint, CommandId commandId, uint8_t optionMask, uint8_t optionOverride);
 
 #if defined(ZCL_USING_LEVEL_CONTROL_CLUSTER_OPTIONS_ATTRIBUTE) && defined(EMBER_AF_PLUGIN_COLOR_CONTROL_SERVER_TEMP)
@@ -128,19 +129,54 @@ static void reallyUpdateCoupledColorTemp(EndpointId endpoint);
 #define updateCoupledColorTemp(endpoint)
 #endif // LEVEL...OPTIONS_ATTRIBUTE && COLOR...SERVER_TEMP
 
-static void schedule(EndpointId endpoint, uint32_t delayMs)
+static void transitionCallback(EndpointId endpoint, ClusterId clusterId, uint32_t remainingMs);
+
+// Moves CurrentLevel from currentLevel to state->moveToLevel over
+// state->transitionTimeMs on the shared transition scheduler.
+static EmberAfStatus schedule(EndpointId endpoint, EmberAfLevelControlState * state, uint8_t currentLevel)
 {
-    emberAfScheduleServerTickExtended(endpoint, ZCL_LEVEL_CONTROL_CLUSTER_ID, delayMs, EMBER_AF_LONG_POLL, EMBER_AF_OK_TO_SLEEP);
+    EmberAfTransition transition;
+
+#if !defined(ZCL_USING_LEVEL_CONTROL_CLUSTER_OPTIONS_ATTRIBUTE) && defined(EMBER_AF_PLUGIN_ZLL_LEVEL_CONTROL_SERVER)
+    if (emberAfPluginZllLevelControlServerIgnoreMoveToLevelMoveStepStop(endpoint, state->commandId))
+    {
+        return EMBER_ZCL_STATUS_SUCCESS;
+    }
+#endif
+
+    transition.endpoint      = endpoint;
+    transition.clusterId     = ZCL_LEVEL_CONTROL_CLUSTER_ID;
+    transition.attributeId   = ZCL_CURRENT_LEVEL_ATTRIBUTE_ID;
+    transition.attributeType = ZCL_INT8U_ATTRIBUTE_TYPE;
+    transition.startValue    = currentLevel;
+    transition.delta         = state->moveToLevel - currentLevel;
+    transition.durationMs    = state->transitionTimeMs;
+    transition.modulo        = 0;
+    transition.repeat        = false;
+    transition.callback      = transitionCallback;
+
+    if (emberAfStartTransition(&transition) != EMBER_SUCCESS)
+    {
+        return EMBER_ZCL_STATUS_INSUFFICIENT_SPACE;
+    }
+    writeRemainingTime(endpoint, state->transitionTimeMs);
+    return EMBER_ZCL_STATUS_SUCCESS;
 }
 
 static void deactivate(EndpointId endpoint)
 {
-    emberAfDeactivateServerTick(endpoint, ZCL_LEVEL_CONTROL_CLUSTER_ID);
+    emberAfStopTransitions(endpoint, ZCL_LEVEL_CONTROL_CLUSTER_ID);
 }
 
 static EmberAfLevelControlState * getState(EndpointId endpoint)
 {
-    uint8_t ep = emberAfFindClusterServerEndpointIndex(endpoint, ZCL_LEVEL_CONTROL_CLUSTER_ID);
+    uint8_t ep;
+
+    if (!emberAfContainsServer(endpoint, ZCL_LEVEL_CONTROL_CLUSTER_ID))
+    {
+        return NULL;
+    }
+    ep = emberAfIndexFromEndpoint(endpoint);
     return (ep == 0xFF ? NULL : &stateTable[ep]);
 }
 
@@ -163,7 +199,14 @@ static void reallyUpdateCoupledColorTemp(EndpointId endpoint)
 }
 #endif // LEVEL...OPTIONS_ATTRIBUTE && COLOR...SERVER_TEMP
 
+// Level transitions run on the shared transition scheduler, which calls
+// transitionCallback. A scheduled cluster tick brings them up to date.
 void emberAfLevelControlClusterServerTickCallback(EndpointId endpoint)
+{
+    emberAfAdvanceTransitions();
+}
+
+static void transitionCallback(EndpointId endpoint, ClusterId clusterId, uint32_t remainingMs)
 {
     EmberAfLevelControlState * state = getState(endpoint);
     EmberAfStatus status;
@@ -174,69 +217,36 @@ void emberAfLevelControlClusterServerTickCallback(EndpointId endpoint)
         return;
     }
 
-    state->elapsedTimeMs += state->eventDurationMs;
+    updateCoupledColorTemp(endpoint);
 
-#if !defined(ZCL_USING_LEVEL_CONTROL_CLUSTER_OPTIONS_ATTRIBUTE) && defined(EMBER_AF_PLUGIN_ZLL_LEVEL_CONTROL_SERVER)
-    if (emberAfPluginZllLevelControlServerIgnoreMoveToLevelMoveStepStop(endpoint, state->commandId))
+#ifdef EMBER_AF_PLUGIN_SCENES
+    // The level has changed, so the scene is no longer valid.
+    if (emberAfContainsServer(endpoint, ZCL_SCENES_CLUSTER_ID))
     {
-        return;
+        emberAfScenesClusterMakeInvalidCallback(endpoint);
     }
 #endif
 
-    // Read the attribute; print error message and return if it can't be read
-    status = emberAfReadServerAttribute(endpoint, ZCL_LEVEL_CONTROL_CLUSTER_ID, ZCL_CURRENT_LEVEL_ATTRIBUTE_ID,
-                                        (uint8_t *) &currentLevel, sizeof(currentLevel));
-    if (status != EMBER_ZCL_STATUS_SUCCESS)
+    if (remainingMs != 0)
     {
-        emberAfLevelControlClusterPrintln("ERR: reading current level %x", status);
-        writeRemainingTime(endpoint, 0);
+        writeRemainingTime(endpoint, remainingMs);
         return;
     }
 
-    emberAfLevelControlClusterPrint("Event: move from %d", currentLevel);
-
-    // adjust by the proper amount, either up or down
-    if (state->transitionTimeMs == 0)
-    {
-        // Immediate, not over a time interval.
-        currentLevel = state->moveToLevel;
-    }
-    else if (state->increasing)
-    {
-        assert(currentLevel < MAX_LEVEL);
-        assert(currentLevel < state->moveToLevel);
-        currentLevel++;
-    }
-    else
-    {
-        assert(MIN_LEVEL < currentLevel);
-        assert(state->moveToLevel < currentLevel);
-        currentLevel--;
-    }
-
-    emberAfLevelControlClusterPrint(" to %d ", currentLevel);
-    emberAfLevelControlClusterPrintln("(diff %c1)", state->increasing ? '+' : '-');
-
-    status = emberAfWriteServerAttribute(endpoint, ZCL_LEVEL_CONTROL_CLUSTER_ID, ZCL_CURRENT_LEVEL_ATTRIBUTE_ID,
-                                         (uint8_t *) &currentLevel, ZCL_INT8U_ATTRIBUTE_TYPE);
+    // Read the attribute; print error message and return if it can't be read
+    status = emberAfReadServerAttribute(endpoint, ZCL_LEVEL_CONTROL_CLUSTER_ID, ZCL_CURRENT_LEVEL_ATTRIBUTE_ID,
+                                        (uint8_t *) &currentLevel, sizeof(currentLevel));
     if (status != EMBER_ZCL_STATUS_SUCCESS)
     {
-        emberAfLevelControlClusterPrintln("ERR: writing current level %x", status);
+        emberAfLevelControlClusterPrintln("ERR: reading current level %x", status);
         writeRemainingTime(endpoint, 0);
         return;
     }
 
-    updateCoupledColorTemp(endpoint);
+    emberAfLevelControlClusterPrintln("Event: moved to %d", currentLevel);
 
-#ifdef EMBER_AF_PLUGIN_SCENES
-    // The level has changed, so the scene is no longer valid.
-    if (emberAfContainsServer(endpoint, ZCL_SCENES_CLUSTER_ID))
-    {
-        emberAfScenesClusterMakeInvalidCallback(endpoint);
-    }
-#endif
-
-    // Are we at the requested level?
+    // Are we at the requested level?  The transition stops short of it only
+    // when the level could not be written.
     if (currentLevel == state->moveToLevel)
     {
         if (state->commandId == ZCL_MOVE_TO_LEVEL_WITH_ON_OFF_COMMAND_ID || state->commandId == ZCL_MOVE_WITH_ON_OFF_COMMAND_ID ||
@@ -274,16 +284,11 @@ void emberAfLevelControlClusterServerTickCallback(EndpointId endpoint)
                 }
             }
         }
-        writeRemainingTime(endpoint, 0);
-    }
-    else
-    {
-        writeRemainingTime(endpoint, static_cast<uint16_t>(state->transitionTimeMs - state->elapsedTimeMs));
-        schedule(endpoint, state->eventDurationMs);
     }
+    writeRemainingTime(endpoint, 0);
 }
 
-static void writeRemainingTime(EndpointId endpoint, uint16_t remainingTimeMs)
+static void writeRemainingTime(EndpointId endpoint, uint32_t remainingTimeMs)
 {
 #ifdef ZCL_USING_LEVEL_CONTROL_CLUSTER_LEVEL_CONTROL_REMAINING_TIME_ATTRIBUTE
     // Convert milliseconds to tenths of a second, rounding any fractional value
@@ -301,7 +306,8 @@ static void writeRemainingTime(EndpointId endpoint, uint16_t remainingTimeMs)
     //
     // This is done to ensure that the attribute, in tenths of a second, only
     // goes to zero when the remaining time in milliseconds is actually zero.
-    uint16_t remainingTimeDs = (remainingTimeMs + 99) / 100;
+    uint32_t remainingTimeDs32 = (remainingTimeMs + 99) / 100;
+    uint16_t remainingTimeDs   = (remainingTimeDs32 > MAX_INT16U_VALUE) ? MAX_INT16U_VALUE : (uint16_t) remainingTimeDs32;
     EmberStatus status =
         emberAfWriteServerAttribute(endpoint, ZCL_LEVEL_CONTROL_CLUSTER_ID, ZCL_LEVEL_CONTROL_REMAINING_TIME_ATTRIBUTE_ID,
                                     (uint8_t *) &remainingTimeDs, ZCL_INT16U_ATTRIBUTE_TYPE);
@@ -476,7 +482,6 @@ static void moveToLevelHandler(CommandId commandId, uint8_t level, uint16_t tran
     EmberAfLevelControlState * state = getState(endpoint);
     EmberAfStatus status;
     uint8_t currentLevel;
-    uint8_t actualStepSize;
 
     if (state == NULL)
     {
@@ -534,12 +539,10 @@ static void moveToLevelHandler(CommandId commandId, uint8_t level, uint16_t tran
             goto send_default_response;
         }
         state->increasing = true;
-        actualStepSize    = static_cast<uint8_t>(state->moveToLevel - currentLevel);
     }
     else
     {
         state->increasing = false;
-        actualStepSize    = static_cast<uint8_t>(currentLevel - state->moveToLevel);
     }
 
     // If the Transition time field takes the value 0xFFFF, then the time taken
@@ -575,19 +578,13 @@ static void moveToLevelHandler(CommandId commandId, uint8_t level, uint16_t tran
         state->transitionTimeMs = (transitionTimeDs * MILLISECOND_TICKS_PER_SECOND / 10);
     }
 
-    // The duration between events will be the transition time divided by the
-    // distance we must move.
-    state->eventDurationMs = state->transitionTimeMs / actualStepSize;
-    state->elapsedTimeMs   = 0;
-
     // OnLevel is not used for Move commands.
     state->useOnLevel = false;
 
     state->storedLevel = storedLevel;
 
     // The setup was successful, so mark the new state as active and return.
-    schedule(endpoint, state->eventDurationMs);
-    status = EMBER_ZCL_STATUS_SUCCESS;
+    status = schedule(endpoint, state, currentLevel);
 
 #ifdef EMBER_AF_PLUGIN_ZLL_LEVEL_CONTROL_SERVER
     if (commandId == ZCL_MOVE_TO_LEVEL_WITH_ON_OFF_COMMAND_ID)
@@ -682,7 +679,7 @@ static void moveHandler(CommandId commandId, uint8_t moveMode, uint8_t rate, uin
         if (status != EMBER_ZCL_STATUS_SUCCESS)
         {
             emberAfLevelControlClusterPrintln("ERR: reading default move rate %x", status);
-            state->eventDurationMs = FASTEST_TRANSITION_TIME_MS;
+            state->transitionTimeMs = difference * FASTEST_TRANSITION_TIME_MS;
         }
         else
         {
@@ -692,23 +689,19 @@ static void moveHandler(CommandId commandId, uint8_t moveMode, uint8_t rate, uin
                 status = EMBER_ZCL_STATUS_SUCCESS;
                 goto send_default_response;
             }
-            state->eventDurationMs = MILLISECOND_TICKS_PER_SECOND / defaultMoveRate;
+            state->transitionTimeMs = difference * MILLISECOND_TICKS_PER_SECOND / defaultMoveRate;
         }
     }
     else
     {
-        state->eventDurationMs = MILLISECOND_TICKS_PER_SECOND / rate;
+        state->transitionTimeMs = difference * MILLISECOND_TICKS_PER_SECOND / rate;
     }
 
-    state->transitionTimeMs = difference * state->eventDurationMs;
-    state->elapsedTimeMs    = 0;
-
     // OnLevel is not used for Move commands.
     state->useOnLevel = false;
 
     // The setup was successful, so mark the new state as active and return.
-    schedule(endpoint, state->eventDurationMs);
-    status = EMBER_ZCL_STATUS_SUCCESS;
+    status = schedule(endpoint, state, currentLevel);
 
 send_default_response:
     emberAfSendImmediateDefaultResponse(status);
@@ -818,17 +811,11 @@ static void stepHandler(CommandId commandId, uint8_t stepMode, uint8_t stepSize,
         }
     }
 
-    // The duration between events will be the transition time divided by the
-    // distance we must move.
-    state->eventDurationMs = state->transitionTimeMs / actualStepSize;
-    state->elapsedTimeMs   = 0;
-
     // OnLevel is not used for Step commands.
     state->useOnLevel = false;
 
     // The setup was successful, so mark the new state as active and return.
-    schedule(endpoint, state->eventDurationMs);
-    status = EMBER_ZCL_STATUS_SUCCESS;
+    status = schedule(endpoint, state, currentLevel);
 
 send_default_response:
     emberAfSendImmediateDefaultResponse(status);
@@ -939,8 +926,7 @@ void emberAfOnOffClusterLevelControlEffectCallback(EndpointId endpoint, bool new
                            temporaryCurrentLevelCache);
 
         // "If OnLevel is not defined, set the CurrentLevel to the stored level."
-        // The emberAfLevelControlClusterServerTickCallback implementation handles
-        // this.
+        // transitionCallback handles this.
     }
 }
 
@@ -17,6 +17,8 @@
 
 #include <app/server/Server.h>
 
+#include <app/AttributePersistence.h>
+#include <app/EventManagement.h>
 #include <app/InteractionModelEngine.h>
 #include <app/server/DataModelHandler.h>
 #include <app/server/EchoHandler.h>
@@ -413,6 +415,50 @@ Messaging::ExchangeManager gExchangeMgr;
 ServerCallback gCallbacks;
 SecurePairingUsingTestSecret gTestPairing;
 
+#if defined(CHIP_APP_USE_INTERACTION_MODEL) && (CHIP_DEVICE_CONFIG_EVENT_LOGGING_INFO_BUFFER_SIZE > 0) &&                          \
+    (CHIP_DEVICE_CONFIG_EVENT_LOGGING_DEBUG_BUFFER_SIZE > 0)
+#define CHIP_SERVER_EVENT_LOGGING 1
+
+// Index entries for a buffer of aBufferSize bytes, assuming events of about 32 bytes.
+constexpr uint16_t EventIndexSize(uint32_t aBufferSize)
+{
+    return static_cast<uint16_t>(aBufferSize / (CHIP_CONFIG_EVENT_LOGGING_INDEX_STRIDE * 32) + 1);
+}
+
+constexpr uint32_t kEventBufferSizes[app::kNumPriorityLevels] = {
+    CHIP_DEVICE_CONFIG_EVENT_LOGGING_DEBUG_BUFFER_SIZE, // PriorityLevel::Debug
+    CHIP_DEVICE_CONFIG_EVENT_LOGGING_INFO_BUFFER_SIZE,  // PriorityLevel::Info
+    CHIP_DEVICE_CONFIG_EVENT_LOGGING_CRIT_BUFFER_SIZE,  // PriorityLevel::Critical
+};
+
+uint8_t gDebugEventBuffer[kEventBufferSizes[0]];
+uint8_t gInfoEventBuffer[kEventBufferSizes[1]];
+uint8_t gCritEventBuffer[kEventBufferSizes[2]];
+app::EventIndexEntry gDebugEventIndex[EventIndexSize(kEventBufferSizes[0])];
+app::EventIndexEntry gInfoEventIndex[EventIndexSize(kEventBufferSizes[1])];
+app::EventIndexEntry gCritEventIndex[EventIndexSize(kEventBufferSizes[2])];
+
+CHIP_ERROR InitEventLogging()
+{
+    app::LogStorageResources resources[app::kNumPriorityLevels];
+
+    resources[0].mpBuffer = gDebugEventBuffer;
+    resources[0].mpIndex  = gDebugEventIndex;
+    resources[1].mpBuffer = gInfoEventBuffer;
+    resources[1].mpIndex  = gInfoEventIndex;
+    resources[2].mpBuffer = gCritEventBuffer;
+    resources[2].mpIndex  = gCritEventIndex;
+
+    for (size_t i = 0; i < app::kNumPriorityLevels; i++)
+    {
+        resources[i].mBufferSize = kEventBufferSizes[i];
+        resources[i].mIndexSize  = EventIndexSize(kEventBufferSizes[i]);
+    }
+
+    return app::EventManagement::GetInstance()->Init(resources);
+}
+#endif
+
 } // namespace
 
 SecureSessionMgr & chip::SessionManager()
@@ -463,6 +509,10 @@ void InitServer(AppDelegate * delegate)
 
     chip::Platform::MemoryInit();
 
+    // Persisted attribute values are loaded when the data model is initialized.
+    err = chip::app::AttributePersistence::GetInstance()->Init(&gServerStorage, &DeviceLayer::SystemLayer);
+    SuccessOrExit(err);
+
     InitDataModelHandler();
     gCallbacks.SetDelegate(delegate);
 
@@ -491,6 +541,12 @@ void InitServer(AppDelegate * delegate)
 #endif
 
 #if defined(CHIP_APP_USE_INTERACTION_MODEL)
+#if CHIP_SERVER_EVENT_LOGGING
+    // Events logged from now on can be read by any client of the engine.
+    err = InitEventLogging();
+    SuccessOrExit(err);
+#endif
+
     err = chip::app::InteractionModelEngine::GetInstance()->Init(&gExchangeMgr);
     SuccessOrExit(err);
 #endif
@@ -542,6 +598,14 @@ exit:
     }
 }
 
+void ShutdownServer()
+{
+    chip::app::AttributePersistence::GetInstance()->Shutdown();
+#if CHIP_SERVER_EVENT_LOGGING
+    chip::app::EventManagement::GetInstance()->Shutdown();
+#endif
+}
+
 CHIP_ERROR AddTestPairing()
 {
     CHIP_ERROR err               = CHIP_NO_ERROR;
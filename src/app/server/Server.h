@@ -37,6 +37,13 @@ using DemoTransportMgr = chip::TransportMgr<chip::Transport::UDP>;
  */
 void InitServer(AppDelegate * delegate = nullptr);
 
+/**
+ * Write the journaled attribute values to persistent storage before the
+ * application exits. Applications whose event loop returns call this after it;
+ * on devices that run until reset, the journal is only flushed periodically.
+ */
+void ShutdownServer();
+
 CHIP_ERROR AddTestPairing();
 
 chip::Transport::AdminPairingTable & GetGlobalAdminPairingTable();
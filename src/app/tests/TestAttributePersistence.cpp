@@ -0,0 +1,220 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the write-behind persistence of
+ *      attribute values.
+ *
+ */
+
+#include <string.h>
+
+#include <app/AttributePersistence.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+namespace chip {
+namespace app {
+
+namespace {
+
+constexpr size_t kMaxKeys = 2 * CHIP_CONFIG_ATTRIBUTE_JOURNAL_SIZE;
+
+class TestStorage : public PersistentStorageDelegate
+{
+public:
+    void SetDelegate(PersistentStorageResultDelegate * delegate) override {}
+    void GetKeyValue(const char * key) override {}
+    void SetKeyValue(const char * key, const char * value) override {}
+    void DeleteKeyValue(const char * key) override {}
+
+    CHIP_ERROR GetKeyValue(const char * key, void * buffer, uint16_t & size) override
+    {
+        const Entry * entry = Find(key);
+        if (entry == nullptr)
+        {
+            return CHIP_ERROR_KEY_NOT_FOUND;
+        }
+        memcpy(buffer, entry->mValue, (entry->mSize < size) ? entry->mSize : size);
+        size = entry->mSize;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR SetKeyValue(const char * key, const void * value, uint16_t size) override
+    {
+        Entry * entry = Find(key);
+
+        if (mFail)
+        {
+            return CHIP_ERROR_PERSISTED_STORAGE_FAILED;
+        }
+        if (entry == nullptr)
+        {
+            entry = &mEntries[mCount++];
+            strcpy(entry->mKey, key);
+        }
+        memcpy(entry->mValue, value, size);
+        entry->mSize = size;
+        mWrites++;
+        return CHIP_NO_ERROR;
+    }
+
+    size_t mWrites = 0;
+    bool mFail     = false;
+
+private:
+    struct Entry
+    {
+        char mKey[16];
+        uint8_t mValue[32];
+        uint16_t mSize;
+    };
+
+    Entry * Find(const char * key)
+    {
+        for (size_t i = 0; i < mCount; i++)
+        {
+            if (strcmp(mEntries[i].mKey, key) == 0)
+            {
+                return &mEntries[i];
+            }
+        }
+        return nullptr;
+    }
+
+    Entry mEntries[kMaxKeys];
+    size_t mCount = 0;
+};
+
+void TestCoalescing(nlTestSuite * apSuite, void * apContext)
+{
+    TestStorage storage;
+    AttributePersistence persistence;
+    const ConcreteAttributePath level = { 1, 0x0008, 0x0000 };
+    const ConcreteAttributePath onOff = { 1, 0x0006, 0x0000 };
+    uint8_t value                     = 0;
+
+    NL_TEST_ASSERT(apSuite, persistence.Save(level, &value, 1) == CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(apSuite, persistence.Init(&storage, nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, persistence.Init(&storage, nullptr) == CHIP_ERROR_INCORRECT_STATE);
+
+    // a transition stepping through 100 levels journals a single value
+    for (value = 1; value <= 100; value++)
+    {
+        NL_TEST_ASSERT(apSuite, persistence.Save(level, &value, 1) == CHIP_NO_ERROR);
+    }
+    value = 1;
+    NL_TEST_ASSERT(apSuite, persistence.Save(onOff, &value, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, persistence.GetPendingCount() == 2);
+    NL_TEST_ASSERT(apSuite, storage.mWrites == 0);
+
+    // pending values are loaded before they reach storage
+    NL_TEST_ASSERT(apSuite, persistence.Load(level, &value, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, value == 100);
+
+    NL_TEST_ASSERT(apSuite, persistence.Flush() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, persistence.GetPendingCount() == 0);
+    NL_TEST_ASSERT(apSuite, storage.mWrites == 2);
+
+    value = 0;
+    NL_TEST_ASSERT(apSuite, persistence.Load(level, &value, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, value == 100);
+    NL_TEST_ASSERT(apSuite, persistence.Load(onOff, &value, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, value == 1);
+
+    // a value saved with another size is not loaded
+    uint16_t wide = 0;
+    NL_TEST_ASSERT(apSuite, persistence.Load(level, reinterpret_cast<uint8_t *>(&wide), 2) == CHIP_ERROR_KEY_NOT_FOUND);
+    NL_TEST_ASSERT(apSuite, persistence.Load({ 2, 0x0008, 0x0000 }, &value, 1) == CHIP_ERROR_KEY_NOT_FOUND);
+
+    // shutdown writes what is still pending
+    value = 42;
+    NL_TEST_ASSERT(apSuite, persistence.Save(level, &value, 1) == CHIP_NO_ERROR);
+    persistence.Shutdown();
+    NL_TEST_ASSERT(apSuite, !persistence.IsValid());
+    NL_TEST_ASSERT(apSuite, storage.mWrites == 3);
+
+    NL_TEST_ASSERT(apSuite, persistence.Init(&storage, nullptr) == CHIP_NO_ERROR);
+    value = 0;
+    NL_TEST_ASSERT(apSuite, persistence.Load(level, &value, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, value == 42);
+    persistence.Shutdown();
+}
+
+void TestFullJournal(nlTestSuite * apSuite, void * apContext)
+{
+    TestStorage storage;
+    AttributePersistence persistence;
+    uint8_t value = 7;
+    uint8_t large[CHIP_CONFIG_ATTRIBUTE_JOURNAL_MAX_VALUE_SIZE + 1];
+
+    NL_TEST_ASSERT(apSuite, persistence.Init(&storage, nullptr) == CHIP_NO_ERROR);
+
+    for (uint16_t i = 0; i < CHIP_CONFIG_ATTRIBUTE_JOURNAL_SIZE; i++)
+    {
+        NL_TEST_ASSERT(apSuite, persistence.Save({ 1, 0x0006, i }, &value, 1) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(apSuite, storage.mWrites == 0);
+
+    // the next attribute flushes the journal to make room
+    NL_TEST_ASSERT(apSuite, persistence.Save({ 2, 0x0006, 0 }, &value, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, storage.mWrites == CHIP_CONFIG_ATTRIBUTE_JOURNAL_SIZE);
+    NL_TEST_ASSERT(apSuite, persistence.GetPendingCount() == 1);
+
+    // values too large for the journal are written through, replacing a pending value
+    memset(large, 0x5A, sizeof(large));
+    NL_TEST_ASSERT(apSuite, persistence.Save({ 2, 0x0006, 0 }, large, sizeof(large)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, persistence.GetPendingCount() == 0);
+    NL_TEST_ASSERT(apSuite, storage.mWrites == CHIP_CONFIG_ATTRIBUTE_JOURNAL_SIZE + 1);
+
+    // values that fail to be written stay pending
+    NL_TEST_ASSERT(apSuite, persistence.Save({ 3, 0x0006, 0 }, nullptr, 1) == CHIP_NO_ERROR);
+    storage.mFail = true;
+    NL_TEST_ASSERT(apSuite, persistence.Flush() == CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+    NL_TEST_ASSERT(apSuite, persistence.GetPendingCount() == 1);
+    storage.mFail = false;
+    NL_TEST_ASSERT(apSuite, persistence.Flush() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, persistence.GetPendingCount() == 0);
+
+    value = 7;
+    NL_TEST_ASSERT(apSuite, persistence.Load({ 3, 0x0006, 0 }, &value, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, value == 0);
+
+    persistence.Shutdown();
+}
+
+} // namespace
+} // namespace app
+} // namespace chip
+
+namespace {
+const nlTest sTests[] = { NL_TEST_DEF("TestCoalescing", chip::app::TestCoalescing),
+                          NL_TEST_DEF("TestFullJournal", chip::app::TestFullJournal), NL_TEST_SENTINEL() };
+} // namespace
+
+int TestAttributePersistence()
+{
+    nlTestSuite theSuite = { "AttributePersistence", &sTests[0], nullptr, nullptr };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestAttributePersistence)
@@ -0,0 +1,119 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the cluster dispatch tables used
+ *      by the generated command handlers.
+ *
+ */
+
+#include <app/util/ClusterDispatchTable.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+using TestHandler = int (*)();
+
+int HandleOnOff()
+{
+    return 6;
+}
+
+int HandleLevelControl()
+{
+    return 8;
+}
+
+int HandleNetworkCommissioning()
+{
+    return 0xAAAA;
+}
+
+// listed out of order, as the generator does
+constexpr ClusterDispatchEntry<TestHandler> kEntries[] = {
+    { 0x0008, HandleLevelControl },
+    { 0xAAAA, HandleNetworkCommissioning },
+    { 0x0003, nullptr },
+    { 0x0006, HandleOnOff },
+    EndOfClusterDispatchTable<TestHandler>(),
+};
+
+constexpr ClusterDispatchEntry<TestHandler> kEmptyEntries[] = {
+    EndOfClusterDispatchTable<TestHandler>(),
+};
+
+constexpr ClusterDispatchEntry<TestHandler> kDuplicateEntries[] = {
+    { 0x0006, HandleOnOff },
+    { 0x0006, HandleLevelControl },
+    EndOfClusterDispatchTable<TestHandler>(),
+};
+
+constexpr ClusterDispatchEntry<TestHandler> kOpenEntries[] = {
+    { 0x0006, HandleOnOff },
+};
+
+constexpr auto kTable      = MakeClusterDispatchTable(kEntries);
+constexpr auto kEmptyTable = MakeClusterDispatchTable(kEmptyEntries);
+
+static_assert(kTable.IsValid(), "Table should be valid");
+static_assert(kEmptyTable.IsValid(), "Empty table should be valid");
+static_assert(!MakeClusterDispatchTable(kDuplicateEntries).IsValid(), "Duplicate cluster should be rejected");
+static_assert(!MakeClusterDispatchTable(kOpenEntries).IsValid(), "Table without end entry should be rejected");
+
+void TestFind(nlTestSuite * apSuite, void * apContext)
+{
+    const ClusterId kListed[] = { 0x0006, 0x0008, 0xAAAA };
+    const ClusterDispatchEntry<TestHandler> * entry;
+
+    for (ClusterId clusterId : kListed)
+    {
+        entry = kTable.Find(clusterId);
+        NL_TEST_ASSERT(apSuite, entry != nullptr && entry->mClusterId == clusterId);
+        NL_TEST_ASSERT(apSuite, entry != nullptr && entry->mHandler() == clusterId);
+    }
+
+    // a known cluster without enabled commands
+    entry = kTable.Find(0x0003);
+    NL_TEST_ASSERT(apSuite, entry != nullptr && entry->mHandler == nullptr);
+
+    NL_TEST_ASSERT(apSuite, kTable.Find(0x0000) == nullptr);
+    NL_TEST_ASSERT(apSuite, kTable.Find(0x0007) == nullptr);
+    NL_TEST_ASSERT(apSuite, kTable.Find(0xFFFF) == nullptr);
+    NL_TEST_ASSERT(apSuite, kEmptyTable.Find(0x0006) == nullptr);
+    NL_TEST_ASSERT(apSuite, kEmptyTable.Find(0xFFFF) == nullptr);
+}
+
+const nlTest sTests[] = { NL_TEST_DEF("TestFind", TestFind), NL_TEST_SENTINEL() };
+
+} // namespace
+
+int TestClusterDispatchTable()
+{
+    nlTestSuite theSuite = { "ClusterDispatchTable", &sTests[0], nullptr, nullptr };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestClusterDispatchTable)
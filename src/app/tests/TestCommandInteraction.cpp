@@ -0,0 +1,238 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for processing batched invoke
+ *      command requests in CommandHandler.
+ *
+ */
+
+#include <app/CommandHandler.h>
+#include <app/CommandSender.h>
+#include <app/InteractionModelEngine.h>
+#include <core/CHIPTLV.h>
+#include <support/CHIPMem.h>
+#include <support/ReturnMacros.h>
+#include <support/UnitTestRegistration.h>
+#include <system/SystemPacketBuffer.h>
+#include <system/TLVPacketBufferBackingStore.h>
+
+#include <nlunit-test.h>
+
+namespace chip {
+namespace app {
+
+namespace {
+
+constexpr ClusterId kTestClusterId = 6;
+constexpr CommandId kTestCommandId = 2;
+constexpr EndpointId kTestEndpoint = 1;
+
+size_t gDispatchedCommands = 0;
+
+/// Exposes the message of a command object without an exchange.
+template <typename T>
+class TestCommand : public T
+{
+public:
+    using Command::ProcessCommandMessage;
+
+    CHIP_ERROR TakeMessage(System::PacketBufferHandle & aMessage)
+    {
+        ReturnErrorOnFailure(this->FinalizeCommandsMessage());
+        aMessage = std::move(this->mCommandMessageBuf);
+        return CHIP_NO_ERROR;
+    }
+};
+
+CHIP_ERROR AddCommandWithData(Command & aCommand, const Command::CommandParams & aParams, uint8_t aValue)
+{
+    TLV::TLVType dummyType;
+    TLV::TLVWriter & writer = aCommand.CreateCommandDataElementTLVWriter();
+
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag, TLV::kTLVType_Structure, dummyType));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(1), aValue));
+    ReturnErrorOnFailure(writer.EndContainer(dummyType));
+    ReturnErrorOnFailure(writer.Finalize());
+
+    Command::CommandParams params = aParams;
+    return aCommand.AddCommand(params);
+}
+
+CHIP_ERROR AddEmptyCommand(Command & aCommand, Command::CommandParams aParams)
+{
+    TLV::TLVWriter & writer = aCommand.CreateCommandDataElementTLVWriter();
+    ReturnErrorOnFailure(writer.Finalize());
+    return aCommand.AddCommand(aParams);
+}
+
+struct ResponseCounts
+{
+    size_t data;
+    size_t statuses;
+    size_t failures;
+};
+
+CHIP_ERROR CountResponses(System::PacketBufferHandle && aResponse, ResponseCounts & aCounts)
+{
+    System::PacketBufferTLVReader reader;
+    TLV::TLVReader commandListReader;
+    InvokeCommand::Parser invokeCommandParser;
+    CommandList::Parser commandListParser;
+    CHIP_ERROR err;
+
+    aCounts = {};
+
+    reader.Init(std::move(aResponse));
+    ReturnErrorOnFailure(reader.Next());
+    ReturnErrorOnFailure(invokeCommandParser.Init(reader));
+    ReturnErrorOnFailure(invokeCommandParser.GetCommandList(&commandListParser));
+    commandListParser.GetReader(&commandListReader);
+
+    while (CHIP_NO_ERROR == (err = commandListReader.Next()))
+    {
+        CommandDataElement::Parser commandElement;
+        StatusElement::Parser statusElement;
+        TLV::TLVReader dataReader;
+
+        ReturnErrorOnFailure(commandElement.Init(commandListReader));
+
+        if (commandElement.GetStatusElement(&statusElement) == CHIP_NO_ERROR)
+        {
+            uint16_t generalCode  = 0;
+            uint32_t protocolId   = 0;
+            uint16_t protocolCode = 0;
+            ClusterId clusterId   = 0;
+
+            ReturnErrorOnFailure(statusElement.DecodeStatusElement(&generalCode, &protocolId, &protocolCode, &clusterId));
+            aCounts.statuses++;
+            if (generalCode != COMMON_STATUS_SUCCESS)
+            {
+                aCounts.failures++;
+            }
+        }
+        else if (commandElement.GetData(&dataReader) == CHIP_NO_ERROR)
+        {
+            aCounts.data++;
+        }
+    }
+
+    return (err == CHIP_END_OF_TLV) ? CHIP_NO_ERROR : err;
+}
+
+void TestBatchedInvoke(nlTestSuite * apSuite, void * apContext)
+{
+    TestCommand<CommandSender> sender;
+    TestCommand<CommandHandler> handler;
+    System::PacketBufferHandle request;
+    System::PacketBufferHandle response;
+    ResponseCounts counts;
+
+    const Command::CommandParams valid(kTestEndpoint, 0, kTestClusterId, kTestCommandId,
+                                       BitFlags<Command::CommandPathFlags>(Command::CommandPathFlags::kEndpointIdValid));
+    const Command::CommandParams noEndpoint(0, 0, kTestClusterId, kTestCommandId, BitFlags<Command::CommandPathFlags>());
+
+    NL_TEST_ASSERT(apSuite, sender.Init(nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, AddCommandWithData(sender, valid, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, AddCommandWithData(sender, valid, 2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, AddEmptyCommand(sender, valid) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, AddCommandWithData(sender, noEndpoint, 3) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, AddCommandWithData(sender, valid, 4) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, sender.TakeMessage(request) == CHIP_NO_ERROR);
+
+    gDispatchedCommands = 0;
+    NL_TEST_ASSERT(apSuite, handler.Init(nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, handler.ProcessCommandMessage(std::move(request), Command::CommandRoleId::HandlerId) == CHIP_NO_ERROR);
+
+    // the command without an endpoint is reported and does not stop the ones after it
+    NL_TEST_ASSERT(apSuite, gDispatchedCommands == 3);
+
+    NL_TEST_ASSERT(apSuite, handler.TakeMessage(response) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, CountResponses(std::move(response), counts) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, counts.data == 3);
+    NL_TEST_ASSERT(apSuite, counts.statuses == 2);
+    NL_TEST_ASSERT(apSuite, counts.failures == 1);
+
+    handler.Shutdown();
+    sender.Shutdown();
+}
+
+void TestCommandPool(nlTestSuite * apSuite, void * apContext)
+{
+    InteractionModelEngine engine;
+    CommandSender * senders[CHIP_IM_MAX_NUM_COMMAND_SENDER];
+    CommandSender * extra = nullptr;
+
+    for (CommandSender *& sender : senders)
+    {
+        NL_TEST_ASSERT(apSuite, engine.NewCommandSender(&sender) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, sender != nullptr);
+    }
+    NL_TEST_ASSERT(apSuite, engine.NewCommandSender(&extra) == CHIP_ERROR_NO_MEMORY);
+    NL_TEST_ASSERT(apSuite, extra == nullptr);
+
+    // a sender shut down by its owner goes back to the pool
+    senders[0]->Shutdown();
+    NL_TEST_ASSERT(apSuite, engine.NewCommandSender(&extra) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, extra == senders[0]);
+
+    engine.Shutdown();
+}
+
+int Setup(void * inContext)
+{
+    return (chip::Platform::MemoryInit() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+/// Echoes every dispatched command as a response, as cluster command handlers do.
+void DispatchSingleClusterCommand(ClusterId aClusterId, CommandId aCommandId, EndpointId aEndPointId, TLV::TLVReader & aReader,
+                                  Command * apCommandObj)
+{
+    gDispatchedCommands++;
+
+    const Command::CommandParams params(aEndPointId, 0, aClusterId, aCommandId,
+                                        BitFlags<Command::CommandPathFlags>(Command::CommandPathFlags::kEndpointIdValid));
+    AddCommandWithData(*apCommandObj, params, 0);
+}
+
+} // namespace app
+} // namespace chip
+
+namespace {
+const nlTest sTests[] = { NL_TEST_DEF("TestBatchedInvoke", chip::app::TestBatchedInvoke),
+                          NL_TEST_DEF("TestCommandPool", chip::app::TestCommandPool), NL_TEST_SENTINEL() };
+} // namespace
+
+int TestCommandInteraction()
+{
+    nlTestSuite theSuite = { "CommandInteraction", &sTests[0], chip::app::Setup, chip::app::Teardown };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestCommandInteraction)
@@ -0,0 +1,512 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the event store and for the
+ *      streaming of its events in ReportData messages.
+ *
+ */
+
+#include <app/EventManagement.h>
+#include <app/InteractionModelEngine.h>
+#include <app/MessageDef/EventDataElement.h>
+#include <app/MessageDef/ReadRequest.h>
+#include <app/MessageDef/ReportData.h>
+#include <app/ReadClient.h>
+#include <app/ReadHandler.h>
+#include <core/CHIPTLV.h>
+#include <support/CHIPMem.h>
+#include <support/ReturnMacros.h>
+#include <support/UnitTestRegistration.h>
+#include <system/SystemPacketBuffer.h>
+#include <system/TLVPacketBufferBackingStore.h>
+
+#include <nlunit-test.h>
+
+namespace chip {
+namespace app {
+
+namespace {
+
+constexpr uint32_t kBufferSize = 2048;
+constexpr uint16_t kIndexSize  = 32;
+constexpr size_t kMaxEvents    = 256;
+
+struct TestStorage
+{
+    uint8_t mBuffers[kNumPriorityLevels][kBufferSize];
+    EventIndexEntry mIndexes[kNumPriorityLevels][kIndexSize];
+    LogStorageResources mResources[kNumPriorityLevels];
+
+    /// Gives every priority level aBufferSize bytes and aIndexSize index entries.
+    const LogStorageResources * Get(uint32_t aBufferSize = kBufferSize, uint16_t aIndexSize = kIndexSize)
+    {
+        for (size_t i = 0; i < kNumPriorityLevels; i++)
+        {
+            mResources[i].mpBuffer    = mBuffers[i];
+            mResources[i].mBufferSize = aBufferSize;
+            mResources[i].mpIndex     = mIndexes[i];
+            mResources[i].mIndexSize  = aIndexSize;
+        }
+        return mResources;
+    }
+};
+
+TestStorage gStorage;
+
+CHIP_ERROR WriteValue(TLV::TLVWriter & aWriter, void * apContext)
+{
+    return aWriter.Put(TLV::ContextTag(0), *static_cast<uint32_t *>(apContext));
+}
+
+/// Logs an event whose data is its value, stamped 1000 + 10 * aValue.
+CHIP_ERROR LogValue(EventManagement & aStore, PriorityLevel aPriority, uint32_t aValue, EventNumber & aNumber)
+{
+    EventOptions options;
+
+    options.mEndpointId        = 1;
+    options.mClusterId         = 6;
+    options.mEventId           = 2;
+    options.mPriority          = aPriority;
+    options.mSystemTimestampMs = 1000 + 10 * static_cast<uint64_t>(aValue);
+    return aStore.LogEvent(options, WriteValue, &aValue, aNumber);
+}
+
+struct ParsedEvent
+{
+    EventNumber mNumber;
+    uint64_t mTimestampMs;
+    uint8_t mPriority;
+    uint32_t mValue;
+};
+
+/// Decodes the events of an EventList, resolving delta timestamps.
+CHIP_ERROR ParseEventList(const TLV::TLVReader & aReader, ParsedEvent * apEvents, size_t & aCount)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    EventList::Parser eventList;
+    TLV::TLVReader reader;
+    uint64_t previousTimestampMs = 0;
+
+    ReturnErrorOnFailure(eventList.Init(aReader));
+    ReturnErrorOnFailure(eventList.CheckSchemaValidity());
+    eventList.GetReader(&reader);
+
+    while (CHIP_NO_ERROR == (err = reader.Next()))
+    {
+        EventDataElement::Parser element;
+        TLV::TLVReader data;
+        TLV::TLVType dataType;
+        uint64_t delta;
+
+        VerifyOrReturnError(aCount < kMaxEvents, CHIP_ERROR_NO_MEMORY);
+        ParsedEvent & event = apEvents[aCount++];
+
+        ReturnErrorOnFailure(element.Init(reader));
+        ReturnErrorOnFailure(element.GetNumber(&event.mNumber));
+        ReturnErrorOnFailure(element.GetPriorityLevel(&event.mPriority));
+        if (element.GetSystemTimestamp(&event.mTimestampMs) != CHIP_NO_ERROR)
+        {
+            ReturnErrorOnFailure(element.GetDeltaSystemTimestamp(&delta));
+            event.mTimestampMs = previousTimestampMs + delta;
+        }
+        previousTimestampMs = event.mTimestampMs;
+
+        ReturnErrorOnFailure(element.GetData(&data));
+        ReturnErrorOnFailure(data.EnterContainer(dataType));
+        ReturnErrorOnFailure(data.Next());
+        ReturnErrorOnFailure(data.Get(event.mValue));
+    }
+    return (CHIP_END_OF_TLV == err) ? CHIP_NO_ERROR : err;
+}
+
+/// Fetches the events of a priority level into a list of at most aMaxLength bytes and decodes them.
+CHIP_ERROR Fetch(EventManagement & aStore, PriorityLevel aPriority, EventNumber & aEventNumber, uint32_t aMaxLength,
+                 ParsedEvent * apEvents, size_t & aCount, CHIP_ERROR & aFetchError)
+{
+    uint8_t buffer[kBufferSize];
+    TLV::TLVWriter writer;
+    TLV::TLVReader reader;
+    EventList::Builder eventList;
+    size_t eventCount = 0;
+
+    writer.Init(buffer, sizeof(buffer));
+    ReturnErrorOnFailure(eventList.Init(&writer));
+    aFetchError = aStore.FetchEventsSince(eventList, aPriority, aEventNumber, aMaxLength, eventCount);
+    ReturnErrorOnFailure(eventList.EndOfEventList().GetError());
+    ReturnErrorOnFailure(writer.Finalize());
+
+    reader.Init(buffer, writer.GetLengthWritten());
+    ReturnErrorOnFailure(reader.Next());
+    return ParseEventList(reader, apEvents, aCount);
+}
+
+void TestLogAndFetch(nlTestSuite * apSuite, void * apContext)
+{
+    EventManagement store;
+    EventNumber number;
+    EventNumber from = 0;
+    ParsedEvent events[kMaxEvents];
+    size_t count = 0;
+    CHIP_ERROR fetchError;
+
+    NL_TEST_ASSERT(apSuite, LogValue(store, PriorityLevel::Info, 0, number) == CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(apSuite, store.Init(gStorage.Get()) == CHIP_NO_ERROR);
+
+    // event numbers are shared by the priority levels
+    NL_TEST_ASSERT(apSuite, LogValue(store, PriorityLevel::Info, 0, number) == CHIP_NO_ERROR && number == 0);
+    NL_TEST_ASSERT(apSuite, LogValue(store, PriorityLevel::Critical, 1, number) == CHIP_NO_ERROR && number == 1);
+    NL_TEST_ASSERT(apSuite, LogValue(store, PriorityLevel::Info, 2, number) == CHIP_NO_ERROR && number == 2);
+    NL_TEST_ASSERT(apSuite, LogValue(store, PriorityLevel::Info, 3, number) == CHIP_NO_ERROR && number == 3);
+    NL_TEST_ASSERT(apSuite, store.GetNextEventNumber() == 4);
+    NL_TEST_ASSERT(apSuite, store.GetFirstEventNumber(PriorityLevel::Critical) == 1);
+    NL_TEST_ASSERT(apSuite, store.GetFirstEventNumber(PriorityLevel::Debug) == 4);
+
+    NL_TEST_ASSERT(apSuite, Fetch(store, PriorityLevel::Info, from, kBufferSize, events, count, fetchError) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, fetchError == CHIP_END_OF_TLV);
+    NL_TEST_ASSERT(apSuite, count == 3);
+    NL_TEST_ASSERT(apSuite, from == 4);
+
+    const uint32_t expected[] = { 0, 2, 3 };
+    for (size_t i = 0; i < count; i++)
+    {
+        NL_TEST_ASSERT(apSuite, events[i].mNumber == expected[i]);
+        NL_TEST_ASSERT(apSuite, events[i].mValue == expected[i]);
+        NL_TEST_ASSERT(apSuite, events[i].mTimestampMs == 1000 + 10 * expected[i]);
+        NL_TEST_ASSERT(apSuite, events[i].mPriority == static_cast<uint8_t>(PriorityLevel::Info));
+    }
+
+    // nothing left past the newest event
+    count = 0;
+    NL_TEST_ASSERT(apSuite, Fetch(store, PriorityLevel::Info, from, kBufferSize, events, count, fetchError) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, fetchError == CHIP_END_OF_TLV);
+    NL_TEST_ASSERT(apSuite, count == 0);
+
+    store.Shutdown();
+}
+
+void TestEviction(nlTestSuite * apSuite, void * apContext)
+{
+    EventManagement store;
+    EventNumber number = 0;
+    EventNumber from   = 0;
+    ParsedEvent events[kMaxEvents];
+    size_t count = 0;
+    CHIP_ERROR fetchError;
+
+    NL_TEST_ASSERT(apSuite, store.Init(gStorage.Get(256, 4)) == CHIP_NO_ERROR);
+
+    for (uint32_t value = 0; value < 200; value++)
+    {
+        NL_TEST_ASSERT(apSuite, LogValue(store, PriorityLevel::Debug, value, number) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(apSuite, LogValue(store, PriorityLevel::Critical, 200, number) == CHIP_NO_ERROR);
+
+    // debug events evicted the oldest debug events only
+    const EventNumber first = store.GetFirstEventNumber(PriorityLevel::Debug);
+    NL_TEST_ASSERT(apSuite, first > 0);
+    NL_TEST_ASSERT(apSuite, store.GetFirstEventNumber(PriorityLevel::Critical) == 200);
+
+    // the events left decode to the numbers and timestamps they were logged with
+    NL_TEST_ASSERT(apSuite, Fetch(store, PriorityLevel::Debug, from, kBufferSize, events, count, fetchError) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, fetchError == CHIP_END_OF_TLV);
+    NL_TEST_ASSERT(apSuite, count == 200 - first);
+    for (size_t i = 0; i < count; i++)
+    {
+        NL_TEST_ASSERT(apSuite, events[i].mNumber == first + i);
+        NL_TEST_ASSERT(apSuite, events[i].mValue == first + i);
+        NL_TEST_ASSERT(apSuite, events[i].mTimestampMs == 1000 + 10 * (first + i));
+    }
+
+    store.Shutdown();
+}
+
+void TestSeek(nlTestSuite * apSuite, void * apContext)
+{
+    EventManagement store;
+    EventNumber number;
+    ParsedEvent events[kMaxEvents];
+    CHIP_ERROR fetchError;
+
+    NL_TEST_ASSERT(apSuite, store.Init(gStorage.Get()) == CHIP_NO_ERROR);
+
+    // every third event is an info event
+    for (uint32_t value = 0; value < 90; value++)
+    {
+        const PriorityLevel priority = (value % 3 == 0) ? PriorityLevel::Info : PriorityLevel::Debug;
+        NL_TEST_ASSERT(apSuite, LogValue(store, priority, value, number) == CHIP_NO_ERROR);
+    }
+
+    for (EventNumber start = 0; start < 95; start++)
+    {
+        EventNumber from = start;
+        size_t count     = 0;
+
+        NL_TEST_ASSERT(apSuite, Fetch(store, PriorityLevel::Info, from, kBufferSize, events, count, fetchError) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, fetchError == CHIP_END_OF_TLV);
+
+        // the first event reported is the first info event numbered start or above
+        const EventNumber firstExpected = (start + 2) / 3 * 3;
+        NL_TEST_ASSERT(apSuite, count == ((firstExpected < 90) ? (90 - firstExpected) / 3 : 0));
+        if (count > 0)
+        {
+            NL_TEST_ASSERT(apSuite, events[0].mNumber == firstExpected);
+            NL_TEST_ASSERT(apSuite, events[0].mTimestampMs == 1000 + 10 * firstExpected);
+            NL_TEST_ASSERT(apSuite, events[count - 1].mNumber == 87);
+            NL_TEST_ASSERT(apSuite, events[count - 1].mTimestampMs == 1000 + 10 * 87);
+        }
+    }
+
+    store.Shutdown();
+}
+
+void TestChunkedFetch(nlTestSuite * apSuite, void * apContext)
+{
+    EventManagement store;
+    EventNumber number;
+    EventNumber from = 0;
+    ParsedEvent events[kMaxEvents];
+    size_t count  = 0;
+    size_t chunks = 0;
+    CHIP_ERROR fetchError;
+
+    NL_TEST_ASSERT(apSuite, store.Init(gStorage.Get()) == CHIP_NO_ERROR);
+    for (uint32_t value = 0; value < 50; value++)
+    {
+        NL_TEST_ASSERT(apSuite, LogValue(store, PriorityLevel::Critical, value, number) == CHIP_NO_ERROR);
+    }
+
+    // each call resumes where the previous one stopped
+    do
+    {
+        NL_TEST_ASSERT(apSuite, Fetch(store, PriorityLevel::Critical, from, 128, events, count, fetchError) == CHIP_NO_ERROR);
+        chunks++;
+    } while (fetchError == CHIP_ERROR_BUFFER_TOO_SMALL && chunks < 50);
+
+    NL_TEST_ASSERT(apSuite, fetchError == CHIP_END_OF_TLV);
+    NL_TEST_ASSERT(apSuite, chunks > 1);
+    NL_TEST_ASSERT(apSuite, count == 50);
+    for (size_t i = 0; i < count; i++)
+    {
+        NL_TEST_ASSERT(apSuite, events[i].mNumber == i);
+        NL_TEST_ASSERT(apSuite, events[i].mValue == i);
+    }
+
+    store.Shutdown();
+}
+
+/// Exposes the report building of a ReadHandler without an exchange.
+class TestReadHandler : public ReadHandler
+{
+public:
+    using ReadHandler::BuildNextReport;
+    using ReadHandler::HasMoreChunks;
+    using ReadHandler::ProcessReadRequest;
+};
+
+void TestReadEvents(nlTestSuite * apSuite, void * apContext)
+{
+    EventManagement & store = *EventManagement::GetInstance();
+    TestReadHandler handler;
+    System::PacketBufferTLVWriter writer;
+    System::PacketBufferHandle request;
+    ReadRequest::Builder readRequest;
+    EventNumber number;
+    ParsedEvent events[kMaxEvents];
+    size_t count  = 0;
+    size_t chunks = 0;
+
+    NL_TEST_ASSERT(apSuite, store.Init(gStorage.Get()) == CHIP_NO_ERROR);
+    for (uint32_t value = 0; value < 120; value++)
+    {
+        const PriorityLevel priority = (value % 2 == 0) ? PriorityLevel::Critical : PriorityLevel::Info;
+        NL_TEST_ASSERT(apSuite, LogValue(store, priority, value, number) == CHIP_NO_ERROR);
+    }
+
+    // ask for the events from number 10 on
+    writer.Init(System::PacketBufferHandle::New(kMaxSecureSduLength));
+    NL_TEST_ASSERT(apSuite, readRequest.Init(&writer) == CHIP_NO_ERROR);
+    readRequest.EventNumber(10).EndOfReadRequest();
+    NL_TEST_ASSERT(apSuite, readRequest.GetError() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, writer.Finalize(&request) == CHIP_NO_ERROR);
+
+    NL_TEST_ASSERT(apSuite, handler.Init(nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, handler.ProcessReadRequest(std::move(request)) == CHIP_NO_ERROR);
+
+    while (handler.HasMoreChunks() && chunks < 20)
+    {
+        System::PacketBufferHandle report;
+        System::PacketBufferTLVReader reader;
+        ReportData::Parser reportData;
+        TLV::TLVReader eventListReader;
+        bool moreChunks = false;
+
+        NL_TEST_ASSERT(apSuite, handler.BuildNextReport(report) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, report->DataLength() <= kMaxSecureSduLength);
+        chunks++;
+
+        reader.Init(std::move(report));
+        NL_TEST_ASSERT(apSuite, reader.Next() == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, reportData.Init(reader) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, reportData.CheckSchemaValidity() == CHIP_NO_ERROR);
+        if (reportData.GetMoreChunkedMessages(&moreChunks) != CHIP_NO_ERROR)
+        {
+            moreChunks = false;
+        }
+        NL_TEST_ASSERT(apSuite, moreChunks == handler.HasMoreChunks());
+
+        NL_TEST_ASSERT(apSuite, reportData.GetReaderOnTag(TLV::ContextTag(ReportData::kCsTag_EventDataList), &eventListReader) ==
+                           CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, ParseEventList(eventListReader, events, count) == CHIP_NO_ERROR);
+    }
+
+    handler.Shutdown();
+    store.Shutdown();
+
+    // critical events come first, then info events, each from number 10 on and reported once
+    NL_TEST_ASSERT(apSuite, chunks > 1);
+    NL_TEST_ASSERT(apSuite, count == 110);
+    for (size_t i = 0; i < count; i++)
+    {
+        const bool critical          = i < 55;
+        const EventNumber expected   = 10 + 2 * (critical ? i : i - 55) + (critical ? 0 : 1);
+        const PriorityLevel priority = critical ? PriorityLevel::Critical : PriorityLevel::Info;
+
+        NL_TEST_ASSERT(apSuite, events[i].mNumber == expected);
+        NL_TEST_ASSERT(apSuite, events[i].mValue == expected);
+        NL_TEST_ASSERT(apSuite, events[i].mPriority == static_cast<uint8_t>(priority));
+    }
+}
+
+/// Exposes the request building and report processing of a ReadClient without an exchange.
+class TestReadClient : public ReadClient
+{
+public:
+    using ReadClient::BuildReadRequest;
+    using ReadClient::ProcessReportData;
+};
+
+class EventCallback : public ReadClient::Callback
+{
+public:
+    void OnAttributeData(const ReadClient * apReadClient, const ConcreteAttributePath & aPath, TLV::TLVReader & aReader) override
+    {
+        mAttributeCount++;
+    }
+
+    void OnEventData(const ReadClient * apReadClient, EventDataElement::Parser & aEvent) override
+    {
+        EventNumber number;
+
+        if (aEvent.GetNumber(&number) != CHIP_NO_ERROR || mCount == kMaxEvents)
+        {
+            mErrors++;
+            return;
+        }
+        mNumbers[mCount++] = number;
+    }
+
+    void OnReadDone(ReadClient * apReadClient, CHIP_ERROR aError) override {}
+
+    EventNumber mNumbers[kMaxEvents];
+    size_t mCount          = 0;
+    size_t mErrors         = 0;
+    size_t mAttributeCount = 0;
+};
+
+void TestReadClientEvents(nlTestSuite * apSuite, void * apContext)
+{
+    EventManagement & store = *EventManagement::GetInstance();
+    TestReadHandler handler;
+    TestReadClient client;
+    EventCallback callback;
+    System::PacketBufferHandle request;
+    EventNumber number;
+    size_t chunks = 0;
+
+    NL_TEST_ASSERT(apSuite, store.Init(gStorage.Get()) == CHIP_NO_ERROR);
+    for (uint32_t value = 0; value < 60; value++)
+    {
+        NL_TEST_ASSERT(apSuite, LogValue(store, PriorityLevel::Critical, value, number) == CHIP_NO_ERROR);
+    }
+
+    // the client asks for the events it has not seen yet, and no attribute
+    NL_TEST_ASSERT(apSuite, client.Init(nullptr, &callback) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, client.BuildReadRequest(nullptr, 0, Optional<EventNumber>::Value(25), request) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, handler.Init(nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, handler.ProcessReadRequest(std::move(request)) == CHIP_NO_ERROR);
+
+    while (handler.HasMoreChunks() && chunks < 20)
+    {
+        System::PacketBufferHandle report;
+        bool moreChunks = false;
+
+        NL_TEST_ASSERT(apSuite, handler.BuildNextReport(report) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, client.ProcessReportData(std::move(report), moreChunks) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, moreChunks == handler.HasMoreChunks());
+        chunks++;
+    }
+
+    handler.Shutdown();
+    client.Shutdown();
+    store.Shutdown();
+
+    NL_TEST_ASSERT(apSuite, callback.mErrors == 0);
+    NL_TEST_ASSERT(apSuite, callback.mAttributeCount == 0);
+    NL_TEST_ASSERT(apSuite, callback.mCount == 35);
+    for (size_t i = 0; i < callback.mCount; i++)
+    {
+        NL_TEST_ASSERT(apSuite, callback.mNumbers[i] == 25 + i);
+    }
+}
+
+int Setup(void * inContext)
+{
+    return (chip::Platform::MemoryInit() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+} // namespace app
+} // namespace chip
+
+namespace {
+const nlTest sTests[] = { NL_TEST_DEF("TestLogAndFetch", chip::app::TestLogAndFetch),
+                          NL_TEST_DEF("TestEviction", chip::app::TestEviction),
+                          NL_TEST_DEF("TestSeek", chip::app::TestSeek),
+                          NL_TEST_DEF("TestChunkedFetch", chip::app::TestChunkedFetch),
+                          NL_TEST_DEF("TestReadEvents", chip::app::TestReadEvents),
+                          NL_TEST_DEF("TestReadClientEvents", chip::app::TestReadClientEvents),
+                          NL_TEST_SENTINEL() };
+} // namespace
+
+int TestEventManagement()
+{
+    nlTestSuite theSuite = { "EventManagement", &sTests[0], chip::app::Setup, chip::app::Teardown };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestEventManagement)
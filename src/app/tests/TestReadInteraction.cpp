@@ -0,0 +1,375 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for serving read requests with
+ *      chunked ReportData messages.
+ *
+ */
+
+#include <app/InteractionModelEngine.h>
+#include <app/ReadClient.h>
+#include <app/ReadHandler.h>
+#include <core/CHIPTLV.h>
+#include <support/CHIPMem.h>
+#include <support/ReturnMacros.h>
+#include <support/UnitTestRegistration.h>
+#include <system/SystemPacketBuffer.h>
+
+#include <nlunit-test.h>
+
+#include <stdio.h>
+#include <string.h>
+
+namespace chip {
+namespace app {
+
+namespace {
+
+// A device large enough for a whole-device read to need several chunks.
+constexpr uint8_t kEndpointCount     = 3;
+constexpr uint8_t kClusterCount      = 2;
+constexpr uint16_t kAttributeCount   = 8;
+constexpr ClusterId kClusters[]      = { 6, 8 };
+constexpr EndpointId kFirstEndpoint  = 1;
+constexpr AttributeId kBrokenField   = 5;
+constexpr EndpointId kBrokenEndpoint = 2;
+constexpr size_t kValueLength        = 40;
+
+/// Records the batches of attributes announced with PrefetchAttributeData.
+struct PrefetchLog
+{
+    ConcreteAttributePath mBatch[CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES];
+    size_t mBatchSize    = 0;
+    size_t mBatches      = 0;
+    size_t mMixedBatches = 0;
+    size_t mUnannounced  = 0;
+    size_t mReleases     = 0;
+};
+
+PrefetchLog gPrefetchLog;
+
+/// Exposes the report building of a ReadHandler without an exchange.
+class TestReadHandler : public ReadHandler
+{
+public:
+    using ReadHandler::BuildNextReport;
+    using ReadHandler::HasMoreChunks;
+    using ReadHandler::ProcessReadRequest;
+};
+
+/// Exposes the request building and report processing of a ReadClient without an exchange.
+class TestReadClient : public ReadClient
+{
+public:
+    using ReadClient::BuildReadRequest;
+    using ReadClient::ProcessReportData;
+};
+
+class CountingCallback : public ReadClient::Callback
+{
+public:
+    void OnAttributeData(const ReadClient * apReadClient, const ConcreteAttributePath & aPath, TLV::TLVReader & aReader) override
+    {
+        char expected[kValueLength + 1];
+        char value[kValueLength + 1];
+
+        if (aPath.EndpointId < kFirstEndpoint || aPath.EndpointId >= kFirstEndpoint + kEndpointCount ||
+            aPath.FieldId >= kAttributeCount)
+        {
+            mUnknown++;
+            return;
+        }
+
+        for (uint8_t i = 0; i < kClusterCount; i++)
+        {
+            if (kClusters[i] == aPath.ClusterId)
+            {
+                snprintf(expected, sizeof(expected), "%02u/%04x/%02u:%*s", aPath.EndpointId, aPath.ClusterId, aPath.FieldId,
+                         static_cast<int>(kValueLength - 11), "");
+                if (aReader.GetString(value, sizeof(value)) != CHIP_NO_ERROR || strcmp(value, expected) != 0)
+                {
+                    mBadValues++;
+                }
+                mCounts[aPath.EndpointId - kFirstEndpoint][i][aPath.FieldId]++;
+                return;
+            }
+        }
+        mUnknown++;
+    }
+
+    void OnReadDone(ReadClient * apReadClient, CHIP_ERROR aError) override {}
+
+    uint8_t mCounts[kEndpointCount][kClusterCount][kAttributeCount] = {};
+    size_t mUnknown                                                 = 0;
+    size_t mBadValues                                               = 0;
+};
+
+struct ReadStats
+{
+    size_t chunks;
+    size_t chunksWithMoreFlag;
+    bool lastChunkHasMoreFlag;
+};
+
+/// Serves the request built from aPaths and feeds every chunk of the report to the client.
+CHIP_ERROR RunRead(const AttributePathParams * apPaths, size_t aPathCount, CountingCallback & aCallback, ReadStats & aStats)
+{
+    TestReadHandler handler;
+    TestReadClient client;
+    System::PacketBufferHandle request;
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    aStats = {};
+
+    ReturnErrorOnFailure(client.Init(nullptr, &aCallback));
+    ReturnErrorOnFailure(handler.Init(nullptr));
+    ReturnErrorOnFailure(client.BuildReadRequest(apPaths, aPathCount, Optional<EventNumber>::Missing(), request));
+    ReturnErrorOnFailure(handler.ProcessReadRequest(std::move(request)));
+
+    while (handler.HasMoreChunks() && err == CHIP_NO_ERROR)
+    {
+        System::PacketBufferHandle report;
+        bool moreChunks = false;
+
+        SuccessOrExit(err = handler.BuildNextReport(report));
+        VerifyOrExit(report->DataLength() <= kMaxSecureSduLength, err = CHIP_ERROR_BUFFER_TOO_SMALL);
+        SuccessOrExit(err = client.ProcessReportData(std::move(report), moreChunks));
+
+        aStats.chunks++;
+        aStats.chunksWithMoreFlag += moreChunks ? 1 : 0;
+        aStats.lastChunkHasMoreFlag = moreChunks;
+        VerifyOrExit(moreChunks == handler.HasMoreChunks(), err = CHIP_ERROR_INCORRECT_STATE);
+    }
+
+exit:
+    handler.Shutdown();
+    client.Shutdown();
+    return err;
+}
+
+void TestWholeDeviceRead(nlTestSuite * apSuite, void * apContext)
+{
+    CountingCallback callback;
+    ReadStats stats;
+    const AttributePathParams wildcard;
+
+    NL_TEST_ASSERT(apSuite, RunRead(&wildcard, 1, callback, stats) == CHIP_NO_ERROR);
+
+    // the report does not fit in one message
+    NL_TEST_ASSERT(apSuite, stats.chunks > 1);
+    NL_TEST_ASSERT(apSuite, stats.chunksWithMoreFlag == stats.chunks - 1);
+    NL_TEST_ASSERT(apSuite, !stats.lastChunkHasMoreFlag);
+    NL_TEST_ASSERT(apSuite, callback.mUnknown == 0);
+    NL_TEST_ASSERT(apSuite, callback.mBadValues == 0);
+
+    // every attribute is reported exactly once, except the one that fails to read
+    for (uint8_t endpoint = 0; endpoint < kEndpointCount; endpoint++)
+    {
+        for (uint8_t cluster = 0; cluster < kClusterCount; cluster++)
+        {
+            for (uint16_t field = 0; field < kAttributeCount; field++)
+            {
+                const bool broken = (endpoint + kFirstEndpoint == kBrokenEndpoint && field == kBrokenField);
+                NL_TEST_ASSERT(apSuite, callback.mCounts[endpoint][cluster][field] == (broken ? 0 : 1));
+            }
+        }
+    }
+}
+
+void TestWildcardPaths(nlTestSuite * apSuite, void * apContext)
+{
+    CountingCallback callback;
+    ReadStats stats;
+    const AttributePathParams paths[] = {
+        // one attribute
+        AttributePathParams(3, kClusters[1], 2,
+                            BitFlags<AttributePathParams::Flags>(AttributePathParams::Flags::kEndpointIdValid)
+                                .Set(AttributePathParams::Flags::kClusterIdValid)
+                                .Set(AttributePathParams::Flags::kFieldIdValid)),
+        // one attribute on every endpoint
+        AttributePathParams(0, kClusters[0], 7,
+                            BitFlags<AttributePathParams::Flags>(AttributePathParams::Flags::kClusterIdValid)
+                                .Set(AttributePathParams::Flags::kFieldIdValid)),
+        // a cluster that no endpoint has
+        AttributePathParams(0, 0x0300, 0, BitFlags<AttributePathParams::Flags>(AttributePathParams::Flags::kClusterIdValid)),
+    };
+
+    NL_TEST_ASSERT(apSuite, RunRead(paths, sizeof(paths) / sizeof(paths[0]), callback, stats) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, stats.chunks == 1);
+    NL_TEST_ASSERT(apSuite, !stats.lastChunkHasMoreFlag);
+    NL_TEST_ASSERT(apSuite, callback.mUnknown == 0);
+    NL_TEST_ASSERT(apSuite, callback.mBadValues == 0);
+
+    size_t total = 0;
+    for (auto & endpoint : callback.mCounts)
+    {
+        for (auto & cluster : endpoint)
+        {
+            for (uint8_t count : cluster)
+            {
+                total += count;
+            }
+        }
+    }
+    NL_TEST_ASSERT(apSuite, total == 1 + kEndpointCount);
+    NL_TEST_ASSERT(apSuite, callback.mCounts[2][1][2] == 1);
+    for (uint8_t endpoint = 0; endpoint < kEndpointCount; endpoint++)
+    {
+        NL_TEST_ASSERT(apSuite, callback.mCounts[endpoint][0][7] == 1);
+    }
+}
+
+void TestPrefetch(nlTestSuite * apSuite, void * apContext)
+{
+    CountingCallback callback;
+    ReadStats stats;
+    const AttributePathParams wildcard;
+
+    gPrefetchLog = PrefetchLog();
+    NL_TEST_ASSERT(apSuite, RunRead(&wildcard, 1, callback, stats) == CHIP_NO_ERROR);
+
+    // every attribute is announced before it is encoded, in batches that stay within a cluster
+    NL_TEST_ASSERT(apSuite, gPrefetchLog.mUnannounced == 0);
+    NL_TEST_ASSERT(apSuite, gPrefetchLog.mMixedBatches == 0);
+    NL_TEST_ASSERT(apSuite, gPrefetchLog.mBatches >= kEndpointCount * kClusterCount);
+    NL_TEST_ASSERT(apSuite, gPrefetchLog.mBatches < kEndpointCount * kClusterCount * kAttributeCount);
+
+    // the values are released after every chunk
+    NL_TEST_ASSERT(apSuite, gPrefetchLog.mReleases == stats.chunks);
+    NL_TEST_ASSERT(apSuite, gPrefetchLog.mBatchSize == 0);
+}
+
+void TestReadClientPool(nlTestSuite * apSuite, void * apContext)
+{
+    InteractionModelEngine engine;
+    CountingCallback callback;
+    ReadClient * clients[CHIP_IM_MAX_NUM_READ_CLIENT];
+    ReadClient * extra = nullptr;
+
+    for (ReadClient *& client : clients)
+    {
+        NL_TEST_ASSERT(apSuite, engine.NewReadClient(&client, &callback) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, client != nullptr);
+    }
+    NL_TEST_ASSERT(apSuite, engine.NewReadClient(&extra, &callback) == CHIP_ERROR_NO_MEMORY);
+    NL_TEST_ASSERT(apSuite, extra == nullptr);
+
+    clients[0]->Shutdown();
+    NL_TEST_ASSERT(apSuite, engine.NewReadClient(&extra, &callback) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, extra == clients[0]);
+
+    engine.Shutdown();
+}
+
+int Setup(void * inContext)
+{
+    return (chip::Platform::MemoryInit() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+/// Walks the test device: every endpoint has the same clusters and attributes.
+bool FindNextAttribute(const AttributePathParams & aPath, AttributePathCursor & aCursor, ConcreteAttributePath & aAttribute)
+{
+    for (; aCursor.EndpointIndex < kEndpointCount; aCursor.EndpointIndex++, aCursor.ClusterIndex = 0, aCursor.AttributeIndex = 0)
+    {
+        for (; aCursor.ClusterIndex < kClusterCount; aCursor.ClusterIndex++, aCursor.AttributeIndex = 0)
+        {
+            while (aCursor.AttributeIndex < kAttributeCount)
+            {
+                aAttribute = { static_cast<EndpointId>(kFirstEndpoint + aCursor.EndpointIndex), kClusters[aCursor.ClusterIndex],
+                               aCursor.AttributeIndex++ };
+                if (aPath.Matches(aAttribute))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void PrefetchAttributeData(const ConcreteAttributePath * apPaths, size_t aPathCount)
+{
+    gPrefetchLog.mBatches++;
+    gPrefetchLog.mBatchSize = 0;
+    for (size_t i = 0; i < aPathCount && i < CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES; i++)
+    {
+        if (apPaths[i].EndpointId != apPaths[0].EndpointId || apPaths[i].ClusterId != apPaths[0].ClusterId)
+        {
+            gPrefetchLog.mMixedBatches++;
+        }
+        gPrefetchLog.mBatch[gPrefetchLog.mBatchSize++] = apPaths[i];
+    }
+}
+
+void ReleaseAttributeData()
+{
+    gPrefetchLog.mReleases++;
+    gPrefetchLog.mBatchSize = 0;
+}
+
+CHIP_ERROR ReadSingleAttributeData(const ConcreteAttributePath & aPath, TLV::TLVWriter & aWriter, uint64_t aTag)
+{
+    char value[kValueLength + 1];
+    bool announced = false;
+
+    for (size_t i = 0; i < gPrefetchLog.mBatchSize; i++)
+    {
+        const ConcreteAttributePath & path = gPrefetchLog.mBatch[i];
+        announced |= (path.EndpointId == aPath.EndpointId && path.ClusterId == aPath.ClusterId && path.FieldId == aPath.FieldId);
+    }
+    gPrefetchLog.mUnannounced += announced ? 0 : 1;
+
+    if (aPath.EndpointId == kBrokenEndpoint && aPath.FieldId == kBrokenField)
+    {
+        return CHIP_ERROR_INTERNAL;
+    }
+
+    snprintf(value, sizeof(value), "%02u/%04x/%02u:%*s", aPath.EndpointId, aPath.ClusterId, aPath.FieldId,
+             static_cast<int>(kValueLength - 11), "");
+    return aWriter.PutString(aTag, value);
+}
+
+} // namespace app
+} // namespace chip
+
+namespace {
+const nlTest sTests[] = { NL_TEST_DEF("TestWholeDeviceRead", chip::app::TestWholeDeviceRead),
+                          NL_TEST_DEF("TestWildcardPaths", chip::app::TestWildcardPaths),
+                          NL_TEST_DEF("TestPrefetch", chip::app::TestPrefetch),
+                          NL_TEST_DEF("TestReadClientPool", chip::app::TestReadClientPool), NL_TEST_SENTINEL() };
+} // namespace
+
+int TestReadInteraction()
+{
+    nlTestSuite theSuite = { "ReadInteraction", &sTests[0], chip::app::Setup, chip::app::Teardown };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestReadInteraction)
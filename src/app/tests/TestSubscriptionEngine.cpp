@@ -0,0 +1,334 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for coalescing attribute changes into
+ *      subscription reports.
+ *
+ */
+
+#include <app/InteractionModelEngine.h>
+#include <app/MessageDef/ReportData.h>
+#include <app/ReadClient.h>
+#include <app/SubscriptionEngine.h>
+#include <core/CHIPTLV.h>
+#include <support/CHIPMem.h>
+#include <support/ReturnMacros.h>
+#include <support/UnitTestRegistration.h>
+#include <system/SystemLayer.h>
+#include <system/SystemPacketBuffer.h>
+
+#include <nlunit-test.h>
+
+namespace chip {
+namespace app {
+
+namespace {
+
+// The test device has one endpoint with two clusters of four attributes.
+constexpr EndpointId kEndpoint      = 1;
+constexpr ClusterId kClusters[]     = { 6, 8 };
+constexpr uint8_t kClusterCount     = 2;
+constexpr uint16_t kAttributeCount  = 4;
+constexpr uint16_t kMinIntervalSecs = 2;
+constexpr uint16_t kMaxIntervalSecs = 10;
+
+class ReportCounter : public ReadClient::Callback
+{
+public:
+    void OnAttributeData(const ReadClient * apReadClient, const ConcreteAttributePath & aPath, TLV::TLVReader & aReader) override
+    {
+        mAttributes++;
+        for (uint8_t i = 0; i < kClusterCount; i++)
+        {
+            if (aPath.EndpointId == kEndpoint && aPath.ClusterId == kClusters[i] && aPath.FieldId < kAttributeCount)
+            {
+                mCounts[i][aPath.FieldId]++;
+            }
+        }
+    }
+
+    void OnReadDone(ReadClient * apReadClient, CHIP_ERROR aError) override {}
+
+    void Reset() { *this = ReportCounter(); }
+
+    size_t mAttributes                              = 0;
+    uint8_t mCounts[kClusterCount][kAttributeCount] = {};
+};
+
+/// Decodes ReportData messages as a subscriber would.
+class TestReportReader : public ReadClient
+{
+public:
+    using ReadClient::ProcessReportData;
+};
+
+/// Decodes the reports instead of sending them.
+class TestSubscriptionEngine : public SubscriptionEngine
+{
+public:
+    using SubscriptionEngine::GetSubscription;
+    using SubscriptionEngine::Run;
+
+    CHIP_ERROR SendReport(uint8_t aSubscriptionId) override
+    {
+        TestReportReader reader;
+        uint16_t next   = 0;
+        bool moreChunks = true;
+
+        ReturnErrorOnFailure(reader.Init(nullptr, &mCounters[aSubscriptionId]));
+        mReports[aSubscriptionId]++;
+        while (moreChunks)
+        {
+            System::PacketBufferHandle report;
+            const uint16_t first = next;
+            bool moreInReport    = false;
+
+            ReturnErrorOnFailure(BuildReport(aSubscriptionId, next, report, moreChunks));
+            // as if the exchange could not send the report
+            VerifyOrReturnError(!mFailSend, CHIP_ERROR_NO_MEMORY);
+
+            if (HasAttributeDataList(report))
+            {
+                mAttributeLists[aSubscriptionId]++;
+            }
+            ReturnErrorOnFailure(reader.ProcessReportData(std::move(report), moreInReport));
+            VerifyOrReturnError(moreInReport == moreChunks, CHIP_ERROR_INCORRECT_STATE);
+            ClearDirty(aSubscriptionId, first, next);
+        }
+        reader.Shutdown();
+        return CHIP_NO_ERROR;
+    }
+
+    void ResetCounters()
+    {
+        for (uint8_t i = 0; i < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; i++)
+        {
+            mReports[i]        = 0;
+            mAttributeLists[i] = 0;
+            mCounters[i].Reset();
+        }
+    }
+
+    static bool HasAttributeDataList(const System::PacketBufferHandle & aReport)
+    {
+        TLV::TLVReader reader;
+        ReportData::Parser report;
+        AttributeDataList::Parser attributeDataList;
+
+        reader.Init(aReport->Start(), aReport->DataLength());
+        return reader.Next() == CHIP_NO_ERROR && report.Init(reader) == CHIP_NO_ERROR &&
+            report.GetAttributeDataList(&attributeDataList) == CHIP_NO_ERROR;
+    }
+
+    size_t mReports[CHIP_IM_MAX_NUM_SUBSCRIPTIONS]        = {};
+    size_t mAttributeLists[CHIP_IM_MAX_NUM_SUBSCRIPTIONS] = {};
+    ReportCounter mCounters[CHIP_IM_MAX_NUM_SUBSCRIPTIONS];
+    bool mFailSend = false;
+};
+
+BitFlags<AttributePathParams::Flags> ConcretePathFlags()
+{
+    return BitFlags<AttributePathParams::Flags>(AttributePathParams::Flags::kEndpointIdValid)
+        .Set(AttributePathParams::Flags::kClusterIdValid)
+        .Set(AttributePathParams::Flags::kFieldIdValid);
+}
+
+void TestCoalescedReports(nlTestSuite * apSuite, void * apContext)
+{
+    TestSubscriptionEngine engine;
+    uint8_t wholeCluster  = 0;
+    uint8_t twoAttributes = 0;
+
+    const AttributePathParams clusterPath(kEndpoint, kClusters[0], 0,
+                                          BitFlags<AttributePathParams::Flags>(AttributePathParams::Flags::kEndpointIdValid)
+                                              .Set(AttributePathParams::Flags::kClusterIdValid));
+    const AttributePathParams attributePaths[] = { AttributePathParams(kEndpoint, kClusters[0], 2, ConcretePathFlags()),
+                                                   AttributePathParams(kEndpoint, kClusters[1], 0, ConcretePathFlags()),
+                                                   // listed twice, watched once
+                                                   AttributePathParams(kEndpoint, kClusters[1], 0, ConcretePathFlags()) };
+
+    NL_TEST_ASSERT(apSuite, engine.Init(nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite,
+                   engine.Subscribe(1, 0, &clusterPath, 1, kMinIntervalSecs, kMaxIntervalSecs, &wholeCluster) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite,
+                   engine.Subscribe(2, 0, attributePaths, 3, kMinIntervalSecs, kMaxIntervalSecs, &twoAttributes) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, wholeCluster != twoAttributes);
+
+    // the first report of a subscription carries every attribute it watches
+    const uint64_t startMs = System::Layer::GetClock_MonotonicMS();
+    engine.Run(startMs);
+    NL_TEST_ASSERT(apSuite, engine.mReports[wholeCluster] == 1);
+    NL_TEST_ASSERT(apSuite, engine.mCounters[wholeCluster].mAttributes == kAttributeCount);
+    NL_TEST_ASSERT(apSuite, engine.mAttributeLists[wholeCluster] == 1);
+    NL_TEST_ASSERT(apSuite, engine.mReports[twoAttributes] == 1);
+    NL_TEST_ASSERT(apSuite, engine.mCounters[twoAttributes].mAttributes == 2);
+
+    // changes are held back until the minimum interval has elapsed, then coalesced in one report
+    engine.ResetCounters();
+    for (int i = 0; i < 3; i++)
+    {
+        engine.MarkDirty({ kEndpoint, kClusters[0], 2 });
+    }
+    engine.MarkDirty({ kEndpoint, kClusters[0], 3 });
+    engine.MarkDirty({ kEndpoint, kClusters[1], 0 });
+    engine.MarkDirty({ kEndpoint, kClusters[1], 1 });
+
+    engine.Run(startMs + 1000);
+    NL_TEST_ASSERT(apSuite, engine.mReports[wholeCluster] == 0);
+    NL_TEST_ASSERT(apSuite, engine.mReports[twoAttributes] == 0);
+
+    engine.Run(startMs + kMinIntervalSecs * 1000);
+    NL_TEST_ASSERT(apSuite, engine.mReports[wholeCluster] == 1);
+    NL_TEST_ASSERT(apSuite, engine.mCounters[wholeCluster].mAttributes == 2);
+    NL_TEST_ASSERT(apSuite, engine.mCounters[wholeCluster].mCounts[0][2] == 1);
+    NL_TEST_ASSERT(apSuite, engine.mCounters[wholeCluster].mCounts[0][3] == 1);
+    NL_TEST_ASSERT(apSuite, engine.mReports[twoAttributes] == 1);
+    NL_TEST_ASSERT(apSuite, engine.mCounters[twoAttributes].mAttributes == 2);
+    NL_TEST_ASSERT(apSuite, engine.mCounters[twoAttributes].mCounts[0][2] == 1);
+    NL_TEST_ASSERT(apSuite, engine.mCounters[twoAttributes].mCounts[1][0] == 1);
+
+    // nothing changed: only the maximum interval triggers an empty report
+    engine.ResetCounters();
+    engine.Run(startMs + (kMinIntervalSecs + 1) * 1000);
+    NL_TEST_ASSERT(apSuite, engine.mReports[wholeCluster] == 0);
+    engine.Run(startMs + (kMinIntervalSecs + kMaxIntervalSecs) * 1000);
+    NL_TEST_ASSERT(apSuite, engine.mReports[wholeCluster] == 1);
+    NL_TEST_ASSERT(apSuite, engine.mCounters[wholeCluster].mAttributes == 0);
+    // an empty list is not a valid one
+    NL_TEST_ASSERT(apSuite, engine.mAttributeLists[wholeCluster] == 0);
+
+    // an attribute no longer watched after an unsubscribe is not reported
+    engine.ResetCounters();
+    NL_TEST_ASSERT(apSuite, engine.Unsubscribe(wholeCluster) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, engine.Unsubscribe(wholeCluster) == CHIP_ERROR_INVALID_ARGUMENT);
+    engine.MarkDirty({ kEndpoint, kClusters[0], 3 });
+    engine.MarkDirty({ kEndpoint, kClusters[0], 2 });
+    engine.Run(startMs + (2 * kMinIntervalSecs + kMaxIntervalSecs) * 1000);
+    NL_TEST_ASSERT(apSuite, engine.mReports[wholeCluster] == 0);
+    NL_TEST_ASSERT(apSuite, engine.mReports[twoAttributes] == 1);
+    NL_TEST_ASSERT(apSuite, engine.mCounters[twoAttributes].mAttributes == 1);
+
+    engine.Shutdown();
+}
+
+void TestUnsentReportStaysDirty(nlTestSuite * apSuite, void * apContext)
+{
+    TestSubscriptionEngine engine;
+    const AttributePathParams wildcard;
+    uint8_t id = 0;
+
+    NL_TEST_ASSERT(apSuite, engine.Init(nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, engine.Subscribe(1, 0, &wildcard, 1, kMinIntervalSecs, kMaxIntervalSecs, &id) == CHIP_NO_ERROR);
+
+    // the first report is lost: every attribute is still to be reported
+    const uint64_t startMs = System::Layer::GetClock_MonotonicMS();
+    engine.mFailSend       = true;
+    engine.Run(startMs);
+    NL_TEST_ASSERT(apSuite, engine.mReports[id] == 1);
+    NL_TEST_ASSERT(apSuite, engine.GetSubscription(id).mDirtyCount == kClusterCount * kAttributeCount);
+
+    engine.ResetCounters();
+    engine.mFailSend = false;
+    engine.Run(startMs + kMinIntervalSecs * 1000);
+    NL_TEST_ASSERT(apSuite, engine.mReports[id] == 1);
+    NL_TEST_ASSERT(apSuite, engine.mCounters[id].mAttributes == kClusterCount * kAttributeCount);
+    NL_TEST_ASSERT(apSuite, engine.GetSubscription(id).mDirtyCount == 0);
+
+    engine.Shutdown();
+}
+
+void TestSubscriptionLimits(nlTestSuite * apSuite, void * apContext)
+{
+    TestSubscriptionEngine engine;
+    const AttributePathParams wildcard;
+    uint8_t id;
+
+    NL_TEST_ASSERT(apSuite, engine.Init(nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, engine.Subscribe(1, 0, &wildcard, 1, 5, 1, &id) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    for (uint8_t i = 0; i < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; i++)
+    {
+        NL_TEST_ASSERT(apSuite, engine.Subscribe(1, 0, &wildcard, 1, 0, 1, &id) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, id == i);
+    }
+    NL_TEST_ASSERT(apSuite, engine.Subscribe(1, 0, &wildcard, 1, 0, 1, &id) == CHIP_ERROR_NO_MEMORY);
+
+    // a freed subscription is reused
+    NL_TEST_ASSERT(apSuite, engine.Unsubscribe(1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, engine.Subscribe(1, 0, &wildcard, 1, 0, 1, &id) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, id == 1);
+
+    engine.Shutdown();
+}
+
+int Setup(void * inContext)
+{
+    return (chip::Platform::MemoryInit() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+/// Walks the test device.
+bool FindNextAttribute(const AttributePathParams & aPath, AttributePathCursor & aCursor, ConcreteAttributePath & aAttribute)
+{
+    for (; aCursor.ClusterIndex < kClusterCount; aCursor.ClusterIndex++, aCursor.AttributeIndex = 0)
+    {
+        while (aCursor.AttributeIndex < kAttributeCount)
+        {
+            aAttribute = { kEndpoint, kClusters[aCursor.ClusterIndex], aCursor.AttributeIndex++ };
+            if (aPath.Matches(aAttribute))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+CHIP_ERROR ReadSingleAttributeData(const ConcreteAttributePath & aPath, TLV::TLVWriter & aWriter, uint64_t aTag)
+{
+    return aWriter.Put(aTag, aPath.FieldId);
+}
+
+} // namespace app
+} // namespace chip
+
+namespace {
+const nlTest sTests[] = { NL_TEST_DEF("TestCoalescedReports", chip::app::TestCoalescedReports),
+                          NL_TEST_DEF("TestUnsentReportStaysDirty", chip::app::TestUnsentReportStaysDirty),
+                          NL_TEST_DEF("TestSubscriptionLimits", chip::app::TestSubscriptionLimits), NL_TEST_SENTINEL() };
+} // namespace
+
+int TestSubscriptionEngine()
+{
+    nlTestSuite theSuite = { "SubscriptionEngine", &sTests[0], chip::app::Setup, chip::app::Teardown };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestSubscriptionEngine)
@@ -0,0 +1,143 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the cluster dispatch tables used by the generated
+ *      command handlers. A table is built and sorted by cluster id at compile
+ *      time, so looking up the handler of a cluster is a binary search over
+ *      read-only data instead of a chain of comparisons.
+ *
+ */
+
+#pragma once
+
+#include <app/util/basic-types.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * The handler of every command of one cluster.
+ */
+template <typename Handler>
+struct ClusterDispatchEntry
+{
+    ClusterId mClusterId;
+    Handler mHandler;
+};
+
+/**
+ * Returns the entry closing a generated table. It keeps the table from being empty when no
+ * cluster is listed and is never returned by a lookup.
+ */
+template <typename Handler>
+constexpr ClusterDispatchEntry<Handler> EndOfClusterDispatchTable()
+{
+    return { UINT16_MAX, nullptr };
+}
+
+/**
+ * A read-only table of cluster handlers sorted by cluster id when it is constructed, so the
+ * generator can list the clusters in any order. The last entry given to the table must be
+ * EndOfClusterDispatchTable().
+ */
+template <typename Handler, size_t N>
+class ClusterDispatchTable
+{
+public:
+    constexpr ClusterDispatchTable(const ClusterDispatchEntry<Handler> (&aEntries)[N]) :
+        mEntries{}, mTerminated(aEntries[N - 1].mClusterId == UINT16_MAX && aEntries[N - 1].mHandler == nullptr)
+    {
+        // Stable insertion sort: tables are small and this runs in the compiler. The end entry
+        // stays last even if a cluster uses the largest id.
+        for (size_t i = 0; i < N; i++)
+        {
+            size_t j = i;
+            for (; j > 0 && mEntries[j - 1].mClusterId > aEntries[i].mClusterId; j--)
+            {
+                mEntries[j] = mEntries[j - 1];
+            }
+            mEntries[j] = aEntries[i];
+        }
+    }
+
+    /**
+     * Checks that the table is closed by its end entry and that no cluster is listed twice,
+     * which would make one of its handlers unreachable.
+     */
+    constexpr bool IsValid() const
+    {
+        for (size_t i = 1; i < N - 1; i++)
+        {
+            if (mEntries[i - 1].mClusterId == mEntries[i].mClusterId)
+            {
+                return false;
+            }
+        }
+        return mTerminated;
+    }
+
+    /**
+     * Finds the entry of a cluster. The handler of the entry is null when the cluster is
+     * known but none of its commands is enabled.
+     *
+     * @param[in]  aClusterId  The cluster of the received command.
+     *
+     * @return The entry of the cluster, or nullptr when the cluster is not in the table.
+     */
+    const ClusterDispatchEntry<Handler> * Find(ClusterId aClusterId) const
+    {
+        // the end entry is last and is not searched
+        size_t low  = 0;
+        size_t high = N - 1;
+
+        while (low < high)
+        {
+            const size_t mid = low + (high - low) / 2;
+            if (mEntries[mid].mClusterId < aClusterId)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        return (low < N - 1 && mEntries[low].mClusterId == aClusterId) ? &mEntries[low] : nullptr;
+    }
+
+private:
+    ClusterDispatchEntry<Handler> mEntries[N];
+    bool mTerminated;
+};
+
+/**
+ * Builds a sorted dispatch table from the entries listed by the generator.
+ */
+template <typename Handler, size_t N>
+constexpr ClusterDispatchTable<Handler, N> MakeClusterDispatchTable(const ClusterDispatchEntry<Handler> (&aEntries)[N])
+{
+    return ClusterDispatchTable<Handler, N>(aEntries);
+}
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,340 @@
+/**
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/****************************************************************************
+ * @file
+ * @brief Implements the shared attribute transition scheduler.
+ *******************************************************************************
+ ******************************************************************************/
+
+#include "af-transition.h"
+
+#include "af.h"
+#include "attribute-storage.h"
+
+#include "gen/attribute-type.h"
+
+#include <platform/CHIPDeviceLayer.h>
+#include <system/SystemLayer.h>
+
+using namespace chip;
+
+// Progress through a transition is a Q16 fraction of its duration.
+#define TRANSITION_PROGRESS_SHIFT 16
+
+typedef struct
+{
+    EmberAfTransition transition;
+    uint32_t startTimeMs;
+    uint32_t remainingMs;
+    uint16_t currentValue;
+    bool active;
+    // The callback of the transition is due at the end of the current tick.
+    bool notify;
+} TransitionSlot;
+
+static TransitionSlot slots[EMBER_AF_TRANSITION_TABLE_SIZE];
+
+// Whether the scheduler timer is armed, and whether a tick is in progress;
+// the timer is re-armed at the end of a tick rather than by each start.
+static bool timerArmed;
+static bool inTick;
+
+static void transitionTick(System::Layer * systemLayer, void * appState, System::Error error);
+
+static uint32_t nowMs(void)
+{
+    return static_cast<uint32_t>(System::Layer::GetClock_MonotonicMS());
+}
+
+static void armTimer(uint32_t delayMs)
+{
+    timerArmed = true;
+    DeviceLayer::SystemLayer.StartTimer(delayMs, transitionTick, NULL);
+}
+
+static bool sameCluster(const EmberAfTransition * t, EndpointId endpoint, ClusterId clusterId)
+{
+    return t->endpoint == endpoint && t->clusterId == clusterId;
+}
+
+static uint16_t wrapValue(const EmberAfTransition * t, int64_t value)
+{
+    uint16_t maxValue = (t->attributeType == ZCL_INT8U_ATTRIBUTE_TYPE) ? UINT8_MAX : UINT16_MAX;
+
+    if (t->modulo != 0)
+    {
+        value %= t->modulo;
+        if (value < 0)
+        {
+            value += t->modulo;
+        }
+    }
+    else if (value < 0)
+    {
+        value = 0;
+    }
+    else if (value > maxValue)
+    {
+        value = maxValue;
+    }
+    return static_cast<uint16_t>(value);
+}
+
+uint16_t emAfTransitionValueAt(const EmberAfTransition * transition, uint32_t elapsedMs)
+{
+    uint64_t progress;
+    uint64_t distance;
+    int64_t offset;
+
+    if (transition->durationMs == 0 || elapsedMs >= transition->durationMs)
+    {
+        return wrapValue(transition, static_cast<int64_t>(transition->startValue) + transition->delta);
+    }
+
+    // Interpolate on the magnitude so that rounding is the same in both
+    // directions, rounding both the progress and the value to the nearest.
+    progress = ((static_cast<uint64_t>(elapsedMs) << TRANSITION_PROGRESS_SHIFT) + transition->durationMs / 2) /
+        transition->durationMs;
+    distance = static_cast<uint64_t>(transition->delta < 0 ? -static_cast<int64_t>(transition->delta) : transition->delta);
+    distance = (distance * progress + (1u << (TRANSITION_PROGRESS_SHIFT - 1))) >> TRANSITION_PROGRESS_SHIFT;
+    offset   = (transition->delta < 0) ? -static_cast<int64_t>(distance) : static_cast<int64_t>(distance);
+
+    return wrapValue(transition, static_cast<int64_t>(transition->startValue) + offset);
+}
+
+EmberStatus emberAfStartTransition(const EmberAfTransition * transition)
+{
+    return emAfStartTransitionAt(transition, nowMs());
+}
+
+EmberStatus emAfStartTransitionAt(const EmberAfTransition * transition, uint32_t startTimeMs)
+{
+    TransitionSlot * slot = NULL;
+    uint16_t i;
+
+    if (transition->attributeType != ZCL_INT8U_ATTRIBUTE_TYPE && transition->attributeType != ZCL_INT16U_ATTRIBUTE_TYPE)
+    {
+        return EMBER_BAD_ARGUMENT;
+    }
+
+    for (i = 0; i < EMBER_AF_TRANSITION_TABLE_SIZE; i++)
+    {
+        if (slots[i].active && sameCluster(&slots[i].transition, transition->endpoint, transition->clusterId) &&
+            slots[i].transition.attributeId == transition->attributeId)
+        {
+            slot = &slots[i];
+            break;
+        }
+        if (slot == NULL && !slots[i].active && !slots[i].notify)
+        {
+            slot = &slots[i];
+        }
+    }
+
+    if (slot == NULL)
+    {
+        emberAfCorePrintln("No room to start transition of attribute 0x%2x on endpoint %d", transition->attributeId,
+                           transition->endpoint);
+        return EMBER_TABLE_FULL;
+    }
+
+    slot->transition   = *transition;
+    slot->startTimeMs  = startTimeMs;
+    slot->remainingMs  = transition->durationMs;
+    slot->currentValue = transition->startValue;
+    slot->active       = true;
+    slot->notify       = false;
+
+    // Ticks catch up on elapsed time, so an early tick only applies a
+    // transition without a duration sooner.
+    if (!inTick && (transition->durationMs == 0 || !timerArmed))
+    {
+        armTimer(transition->durationMs == 0 ? 0 : EMBER_AF_TRANSITION_TICK_MS);
+    }
+    return EMBER_SUCCESS;
+}
+
+void emberAfStopTransitions(EndpointId endpoint, ClusterId clusterId)
+{
+    uint16_t i;
+
+    for (i = 0; i < EMBER_AF_TRANSITION_TABLE_SIZE; i++)
+    {
+        if ((slots[i].active || slots[i].notify) && sameCluster(&slots[i].transition, endpoint, clusterId))
+        {
+            slots[i].active = false;
+            slots[i].notify = false;
+        }
+    }
+    // The timer stops by itself at the next tick when nothing is left to run.
+}
+
+bool emberAfTransitionIsActive(EndpointId endpoint, ClusterId clusterId)
+{
+    uint16_t i;
+
+    for (i = 0; i < EMBER_AF_TRANSITION_TABLE_SIZE; i++)
+    {
+        if (slots[i].active && sameCluster(&slots[i].transition, endpoint, clusterId))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void advanceSlot(TransitionSlot * slot, uint32_t now)
+{
+    EmberAfTransition * t = &slot->transition;
+    uint32_t elapsedMs    = now - slot->startTimeMs;
+    uint16_t value;
+    uint8_t value8u;
+    EmberAfStatus status;
+
+    if (t->repeat && t->durationMs != 0 && elapsedMs >= t->durationMs)
+    {
+        // Restart from where the completed periods left off, so that the
+        // interpolation never works on more than one period.
+        uint32_t periods = elapsedMs / t->durationMs;
+        t->startValue    = wrapValue(t, static_cast<int64_t>(t->startValue) + static_cast<int64_t>(t->delta) * periods);
+        slot->startTimeMs += periods * t->durationMs;
+        elapsedMs -= periods * t->durationMs;
+    }
+
+    value = emAfTransitionValueAt(t, elapsedMs);
+    if (value != slot->currentValue)
+    {
+        if (t->attributeType == ZCL_INT8U_ATTRIBUTE_TYPE)
+        {
+            value8u = static_cast<uint8_t>(value);
+            status  = emberAfWriteServerAttribute(t->endpoint, t->clusterId, t->attributeId, &value8u, t->attributeType);
+        }
+        else
+        {
+            status = emberAfWriteServerAttribute(t->endpoint, t->clusterId, t->attributeId, (uint8_t *) &value, t->attributeType);
+        }
+
+        if (status != EMBER_ZCL_STATUS_SUCCESS)
+        {
+            emberAfCorePrintln("ERR: writing attribute 0x%2x on endpoint %d: 0x%x, transition stopped", t->attributeId,
+                               t->endpoint, status);
+            slot->active      = false;
+            slot->remainingMs = 0;
+            slot->notify      = true;
+            return;
+        }
+        slot->currentValue = value;
+    }
+
+    if (t->repeat)
+    {
+        slot->remainingMs = EMBER_AF_TRANSITION_FOREVER;
+    }
+    else if (elapsedMs >= t->durationMs)
+    {
+        slot->active      = false;
+        slot->remainingMs = 0;
+    }
+    else
+    {
+        slot->remainingMs = t->durationMs - elapsedMs;
+    }
+    slot->notify = true;
+}
+
+void emberAfAdvanceTransitions(void)
+{
+    if (!inTick)
+    {
+        emAfTransitionTick(nowMs());
+    }
+}
+
+static void transitionTick(System::Layer * systemLayer, void * appState, System::Error error)
+{
+    emAfTransitionTick(nowMs());
+}
+
+void emAfTransitionTick(uint32_t now)
+{
+    uint32_t delayMs;
+    bool anyActive;
+    uint16_t i, j;
+
+    timerArmed = false;
+    inTick     = true;
+
+    // Write every changed attribute first, so that clusters see the values of
+    // all of their attributes for this tick when their callbacks run.
+    for (i = 0; i < EMBER_AF_TRANSITION_TABLE_SIZE; i++)
+    {
+        if (slots[i].active)
+        {
+            advanceSlot(&slots[i], now);
+        }
+    }
+
+    // Then call back once per endpoint and cluster. Callbacks may start and
+    // stop transitions; started ones are left for the next tick.
+    for (i = 0; i < EMBER_AF_TRANSITION_TABLE_SIZE; i++)
+    {
+        if (slots[i].notify)
+        {
+            EmberAfTransition * t              = &slots[i].transition;
+            EndpointId endpoint                = t->endpoint;
+            ClusterId clusterId                = t->clusterId;
+            EmberAfTransitionCallback callback = t->callback;
+            uint32_t remainingMs               = slots[i].remainingMs;
+
+            slots[i].notify = false;
+            for (j = static_cast<uint16_t>(i + 1); j < EMBER_AF_TRANSITION_TABLE_SIZE; j++)
+            {
+                if (slots[j].notify && sameCluster(&slots[j].transition, endpoint, clusterId))
+                {
+                    remainingMs     = (slots[j].remainingMs > remainingMs) ? slots[j].remainingMs : remainingMs;
+                    slots[j].notify = false;
+                }
+            }
+
+            if (callback != NULL)
+            {
+                callback(endpoint, clusterId, remainingMs);
+            }
+        }
+    }
+
+    inTick    = false;
+    anyActive = false;
+    delayMs   = EMBER_AF_TRANSITION_TICK_MS;
+    for (i = 0; i < EMBER_AF_TRANSITION_TABLE_SIZE; i++)
+    {
+        if (slots[i].active)
+        {
+            anyActive = true;
+            if (slots[i].transition.durationMs == 0)
+            {
+                delayMs = 0;
+            }
+        }
+    }
+
+    if (anyActive)
+    {
+        armTimer(delayMs);
+    }
+}
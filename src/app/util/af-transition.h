@@ -0,0 +1,121 @@
+/**
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/****************************************************************************
+ * @file
+ * @brief Interface for the shared attribute transition scheduler.
+ *
+ * Clusters that move an attribute from one value to another over time, such
+ * as Level Control and Color Control, hand the transition to the scheduler
+ * instead of arming an event per endpoint. A single timer drives every active
+ * transition on every endpoint: on each tick the value of each transition is
+ * interpolated in fixed point from the time elapsed since it started, all
+ * changed attributes are written in one pass, and the callback of each
+ * cluster is then called once per endpoint.
+ *******************************************************************************
+ ******************************************************************************/
+
+#pragma once
+
+#include "af.h"
+#include "attribute-storage.h"
+
+/** The number of transitions that can run at the same time. Color Control
+ * moves up to two attributes per endpoint and Level Control one.
+ */
+#ifndef EMBER_AF_TRANSITION_TABLE_SIZE
+#define EMBER_AF_TRANSITION_TABLE_SIZE (3 * MAX_ENDPOINT_COUNT)
+#endif // EMBER_AF_TRANSITION_TABLE_SIZE
+
+/** The period of the scheduler timer while a transition is running.
+ */
+#ifndef EMBER_AF_TRANSITION_TICK_MS
+#define EMBER_AF_TRANSITION_TICK_MS 100
+#endif // EMBER_AF_TRANSITION_TICK_MS
+
+/** The remaining time passed for transitions that repeat until stopped.
+ */
+#define EMBER_AF_TRANSITION_FOREVER UINT32_MAX
+
+/** @brief Called once per tick for each endpoint and cluster with a running
+ * transition, after the attributes of all transitions have been written.
+ *
+ * @param endpoint The endpoint of the transitions.
+ * @param clusterId The server cluster of the transitions.
+ * @param remainingMs The time left to the longest transition of the cluster
+ * on the endpoint, 0 when the last one has just finished, or
+ * ::EMBER_AF_TRANSITION_FOREVER.
+ */
+typedef void (*EmberAfTransitionCallback)(chip::EndpointId endpoint, chip::ClusterId clusterId, uint32_t remainingMs);
+
+typedef struct
+{
+    chip::EndpointId endpoint;
+    chip::ClusterId clusterId;
+    chip::AttributeId attributeId;
+    /** ZCL_INT8U_ATTRIBUTE_TYPE or ZCL_INT16U_ATTRIBUTE_TYPE. */
+    EmberAfAttributeType attributeType;
+    uint16_t startValue;
+    /** The signed distance travelled over durationMs. */
+    int32_t delta;
+    /** A duration of 0 applies the final value on the next tick. */
+    uint32_t durationMs;
+    /** If not 0, values wrap around modulo this, as hues do. */
+    uint16_t modulo;
+    /** Travel delta again every durationMs until stopped. */
+    bool repeat;
+    EmberAfTransitionCallback callback;
+} EmberAfTransition;
+
+/** @brief Starts a transition, replacing any running one of the same
+ * attribute.
+ *
+ * @return ::EMBER_SUCCESS, ::EMBER_BAD_ARGUMENT for an attribute type other
+ * than an 8 or 16 bit unsigned integer, or ::EMBER_TABLE_FULL.
+ */
+EmberStatus emberAfStartTransition(const EmberAfTransition * transition);
+
+/** @brief Stops the transitions of a cluster on an endpoint, leaving their
+ * attributes at the last value written. The callback is not called.
+ */
+void emberAfStopTransitions(chip::EndpointId endpoint, chip::ClusterId clusterId);
+
+/** @brief Returns true if a transition of the cluster is running on the
+ * endpoint.
+ */
+bool emberAfTransitionIsActive(chip::EndpointId endpoint, chip::ClusterId clusterId);
+
+/** @brief Brings every running transition up to date now, ahead of the
+ * scheduler timer. The Level Control cluster tick and the Color Control
+ * transition events, which the generated event tables still list, call this.
+ * Does nothing when called from a transition callback.
+ */
+void emberAfAdvanceTransitions(void);
+
+/** @brief Returns the value of a transition elapsedMs after it started.
+ */
+uint16_t emAfTransitionValueAt(const EmberAfTransition * transition, uint32_t elapsedMs);
+
+/** @brief Starts a transition as emberAfStartTransition() does, with
+ * startTimeMs as its start time.
+ */
+EmberStatus emAfStartTransitionAt(const EmberAfTransition * transition, uint32_t startTimeMs);
+
+/** @brief Runs a tick of the scheduler at time now: advances the running
+ * transitions, calls their callbacks and re-arms the timer if any is left.
+ */
+void emAfTransitionTick(uint32_t now);
@@ -490,6 +490,8 @@ enum
   EMBER_AF_ENDPOINT_ENABLED  = 0x01,
 };
 
+class EmberAfAttributeAccessor; // Declared in attribute-storage.h
+
 /**
  * @brief Struct that maps actual endpoint type, onto a specific endpoint.
  */
@@ -519,6 +521,14 @@ typedef struct
      * Meta-data about the endpoint
      */
     EmberAfEndpointBitmask bitmask;
+    /**
+     * Storage of the attributes of this endpoint, laid out as in its endpoint type.
+     */
+    uint8_t * attributeStorage;
+    /**
+     * Accessors registered for server clusters of this endpoint.
+     */
+    EmberAfAttributeAccessor * attributeAccessors;
 } EmberAfDefinedEndpoint;
 
 // Cluster specific types
@@ -46,6 +46,8 @@
 #include "gen/attribute-type.h"
 #include "gen/callback.h"
 
+#include <app/AttributePersistence.h>
+
 using namespace chip;
 
 //------------------------------------------------------------------------------
@@ -71,6 +73,22 @@ uint8_t singletonAttributeData[ACTUAL_SINGLETONS_SIZE];
 
 uint8_t emberEndpointCount = 0;
 
+// Index of each endpoint in emAfEndpoints, by endpoint id. An entry is only
+// valid when the endpoint at that index still has the same id, so entries are
+// never cleared and the zero-initialized table is valid before configuration.
+static_assert(sizeof(EndpointId) == 1, "The endpoint index table covers every EndpointId");
+static_assert(MAX_ENDPOINT_COUNT < 0xFF, "0xFF is the invalid endpoint index");
+static uint8_t endpointIndexTable[UINT8_MAX + 1];
+
+// The endpoint type of the free dynamic endpoint slots.
+static EmberAfEndpointType freeEndpointType = { NULL, 0, 0 };
+
+// The accessors registered for an endpoint that is not defined, and those
+// registered for every endpoint. The accessors of a defined endpoint are in its
+// entry of emAfEndpoints. Each list is most recent first.
+static EmberAfAttributeAccessor * detachedAttributeAccessors = NULL;
+static EmberAfAttributeAccessor * wildcardAttributeAccessors = NULL;
+
 // If we have attributes that are more than 2 bytes, then
 // we need this data block for the defaults
 #if (defined(GENERATED_DEFAULTS) && GENERATED_DEFAULTS_COUNT)
@@ -115,6 +133,15 @@ const uint16_t attributeManufacturerCodeCount                   = GENERATED_ATTR
 // Returns endpoint index within a given cluster
 static uint8_t findClusterEndpointIndex(EndpointId endpoint, ClusterId clusterId, uint8_t mask, uint16_t manufacturerCode);
 
+static uint8_t findIndexFromEndpoint(EndpointId endpoint, bool ignoreDisabledEndpoints);
+
+static void clearDynamicEndpointSlot(uint8_t index);
+
+static EmberAfStatus readAttributeFromAccessor(EmberAfAttributeAccessor * accessor, EndpointId endpoint,
+                                               EmberAfAttributeMetadata * am, uint8_t * buffer, uint16_t readLength);
+
+static EmberAfAttributeAccessor ** findAttributeAccessorList(EndpointId endpoint);
+
 //------------------------------------------------------------------------------
 
 // Initial configuration
@@ -130,21 +157,44 @@ void emberAfEndpointConfigure(void)
     uint8_t fixedNetworks[]             = FIXED_NETWORKS;
 #endif
 
+    uint16_t attributeOffsetIndex = 0;
+
     emberEndpointCount = FIXED_ENDPOINT_COUNT;
     for (ep = 0; ep < FIXED_ENDPOINT_COUNT; ep++)
     {
-        emAfEndpoints[ep].endpoint      = endpointNumber(ep);
-        emAfEndpoints[ep].deviceId      = endpointDeviceId(ep);
-        emAfEndpoints[ep].deviceVersion = endpointDeviceVersion(ep);
-        emAfEndpoints[ep].endpointType  = endpointTypeMacro(ep);
-        emAfEndpoints[ep].networkIndex  = endpointNetworkIndex(ep);
-        emAfEndpoints[ep].bitmask       = EMBER_AF_ENDPOINT_ENABLED;
+        emAfEndpoints[ep].endpoint         = endpointNumber(ep);
+        emAfEndpoints[ep].deviceId         = endpointDeviceId(ep);
+        emAfEndpoints[ep].deviceVersion    = endpointDeviceVersion(ep);
+        emAfEndpoints[ep].endpointType     = endpointTypeMacro(ep);
+        emAfEndpoints[ep].networkIndex     = endpointNetworkIndex(ep);
+        emAfEndpoints[ep].bitmask          = EMBER_AF_ENDPOINT_ENABLED;
+        emAfEndpoints[ep].attributeStorage = attributeData + attributeOffsetIndex;
+
+        endpointIndexTable[emAfEndpoints[ep].endpoint] = ep;
+        emAfDetachAttributeAccessors(ep);
+        emAfAttachAttributeAccessors(ep);
+
+        attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emAfEndpoints[ep].endpointType->endpointSize);
+    }
+
+    for (ep = FIXED_ENDPOINT_COUNT; ep < MAX_ENDPOINT_COUNT; ep++)
+    {
+        clearDynamicEndpointSlot(ep);
     }
 }
 
-void emberAfSetEndpointCount(uint8_t dynamicEndpointCount)
+static void clearDynamicEndpointSlot(uint8_t index)
 {
-    emberEndpointCount = static_cast<uint8_t>(FIXED_ENDPOINT_COUNT + dynamicEndpointCount);
+    emAfDetachAttributeAccessors(index);
+
+    // 0xFF is the broadcast endpoint, which no endpoint is registered as.
+    emAfEndpoints[index].endpoint         = 0xFF;
+    emAfEndpoints[index].deviceId         = 0;
+    emAfEndpoints[index].deviceVersion    = 0;
+    emAfEndpoints[index].endpointType     = &freeEndpointType;
+    emAfEndpoints[index].networkIndex     = 0;
+    emAfEndpoints[index].bitmask          = EMBER_AF_ENDPOINT_DISABLED;
+    emAfEndpoints[index].attributeStorage = NULL;
 }
 
 uint8_t emberAfFixedEndpointCount(void)
@@ -332,6 +382,75 @@ void emAfCallInits(void)
     }
 }
 
+EmberAfStatus emberAfSetDynamicEndpoint(uint8_t index, EndpointId id, EmberAfEndpointType * ep, uint16_t deviceId,
+                                        uint8_t deviceVersion, uint8_t * attributeStorage)
+{
+    uint8_t realIndex = static_cast<uint8_t>(FIXED_ENDPOINT_COUNT + index);
+
+    if (index >= CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT || id == EMBER_BROADCAST_ENDPOINT || ep == NULL ||
+        (ep->endpointSize != 0 && attributeStorage == NULL))
+    {
+        return EMBER_ZCL_STATUS_INVALID_VALUE;
+    }
+
+    if (emberAfEndpointIndexIsEnabled(realIndex) || findIndexFromEndpoint(id, false) != 0xFF)
+    {
+        return EMBER_ZCL_STATUS_DUPLICATE_EXISTS;
+    }
+
+    emAfEndpoints[realIndex].endpoint         = id;
+    emAfEndpoints[realIndex].deviceId         = deviceId;
+    emAfEndpoints[realIndex].deviceVersion    = deviceVersion;
+    emAfEndpoints[realIndex].endpointType     = ep;
+    emAfEndpoints[realIndex].networkIndex     = 0;
+    emAfEndpoints[realIndex].bitmask          = EMBER_AF_ENDPOINT_ENABLED;
+    emAfEndpoints[realIndex].attributeStorage = attributeStorage;
+    endpointIndexTable[id]                    = realIndex;
+
+    if (emberEndpointCount <= realIndex)
+    {
+        emberEndpointCount = static_cast<uint8_t>(realIndex + 1);
+    }
+
+    emAfAttachAttributeAccessors(realIndex);
+
+    emAfLoadAttributeDefaults(id, false);
+    emberAfSetDeviceEnabled(id, true);
+    initializeEndpoint(&(emAfEndpoints[realIndex]));
+
+    return EMBER_ZCL_STATUS_SUCCESS;
+}
+
+EmberAfStatus emberAfClearDynamicEndpoint(uint8_t index)
+{
+    uint8_t realIndex = static_cast<uint8_t>(FIXED_ENDPOINT_COUNT + index);
+    EmberAfEndpointType * epType;
+    uint8_t clusterIndex;
+
+    if (index >= CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT || !emberAfEndpointIndexIsEnabled(realIndex))
+    {
+        return EMBER_ZCL_STATUS_NOT_FOUND;
+    }
+
+    epType = emAfEndpoints[realIndex].endpointType;
+    for (clusterIndex = 0; clusterIndex < epType->clusterCount; clusterIndex++)
+    {
+        EmberAfCluster * cluster = &(epType->cluster[clusterIndex]);
+        emberAfDeactivateClusterTick(emAfEndpoints[realIndex].endpoint, cluster->clusterId, emberAfClusterIsClient(cluster));
+    }
+
+    clearDynamicEndpointSlot(realIndex);
+
+    // Shrink the endpoint count down to the last slot still in use.
+    while (emberEndpointCount > FIXED_ENDPOINT_COUNT &&
+           !emberAfEndpointIndexIsEnabled(static_cast<uint8_t>(emberEndpointCount - 1)))
+    {
+        emberEndpointCount--;
+    }
+
+    return EMBER_ZCL_STATUS_SUCCESS;
+}
+
 // Returns the pointer to metadata, or null if it is not found
 EmberAfAttributeMetadata * emberAfLocateAttributeMetadata(EndpointId endpoint, ClusterId clusterId, AttributeId attributeId,
                                                           uint8_t mask, uint16_t manufacturerCode)
@@ -505,104 +624,284 @@ bool emAfMatchAttribute(EmberAfCluster * cluster, EmberAfAttributeMetadata * am,
 EmberAfStatus emAfReadOrWriteAttribute(EmberAfAttributeSearchRecord * attRecord, EmberAfAttributeMetadata ** metadata,
                                        uint8_t * buffer, uint16_t readLength, bool write)
 {
-    uint8_t i;
+    uint8_t endpointIndex         = findIndexFromEndpoint(attRecord->endpoint, true);
     uint16_t attributeOffsetIndex = 0;
+    EmberAfDefinedEndpoint * definedEndpoint;
+    EmberAfEndpointType * endpointType;
+    uint8_t clusterIndex;
 
-    for (i = 0; i < emberAfEndpointCount(); i++)
+    if (endpointIndex == 0xFF)
     {
-        if (emAfEndpoints[i].endpoint == attRecord->endpoint)
-        {
-            EmberAfEndpointType * endpointType = emAfEndpoints[i].endpointType;
-            uint8_t clusterIndex;
-            if (!emberAfEndpointIndexIsEnabled(i))
-            {
-                continue;
-            }
-            for (clusterIndex = 0; clusterIndex < endpointType->clusterCount; clusterIndex++)
+        return EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
+    }
+
+    definedEndpoint = &(emAfEndpoints[endpointIndex]);
+    endpointType    = definedEndpoint->endpointType;
+    for (clusterIndex = 0; clusterIndex < endpointType->clusterCount; clusterIndex++)
+    {
+        EmberAfCluster * cluster = &(endpointType->cluster[clusterIndex]);
+        if (emAfMatchCluster(cluster, attRecord))
+        { // Got the cluster
+            uint16_t attrIndex;
+            for (attrIndex = 0; attrIndex < cluster->attributeCount; attrIndex++)
             {
-                EmberAfCluster * cluster = &(endpointType->cluster[clusterIndex]);
-                if (emAfMatchCluster(cluster, attRecord))
-                { // Got the cluster
-                    uint16_t attrIndex;
-                    for (attrIndex = 0; attrIndex < cluster->attributeCount; attrIndex++)
+                EmberAfAttributeMetadata * am = &(cluster->attributes[attrIndex]);
+                if (emAfMatchAttribute(cluster, am, attRecord))
+                { // Got the attribute
+                    // If passed metadata location is not null, populate
+                    if (metadata != NULL)
                     {
-                        EmberAfAttributeMetadata * am = &(cluster->attributes[attrIndex]);
-                        if (emAfMatchAttribute(cluster, am, attRecord))
-                        { // Got the attribute
-                            // If passed metadata location is not null, populate
-                            if (metadata != NULL)
+                        *metadata = am;
+                    }
+
+                    {
+                        uint8_t * attributeLocation =
+                            (am->mask & ATTRIBUTE_MASK_SINGLETON ? singletonAttributeLocation(am)
+                                                                 : definedEndpoint->attributeStorage + attributeOffsetIndex);
+                        uint8_t *src, *dst;
+                        if (write)
+                        {
+                            src = buffer;
+                            dst = attributeLocation;
+                            if (!emberAfAttributeWriteAccessCallback(attRecord->endpoint, attRecord->clusterId,
+                                                                     emAfGetManufacturerCodeForAttribute(cluster, am),
+                                                                     am->attributeId))
                             {
-                                *metadata = am;
+                                return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
+                            }
+                        }
+                        else
+                        {
+                            if (buffer == NULL)
+                            {
+                                return EMBER_ZCL_STATUS_SUCCESS;
                             }
 
+                            src = attributeLocation;
+                            dst = buffer;
+                            if (!emberAfAttributeReadAccessCallback(attRecord->endpoint, attRecord->clusterId,
+                                                                    emAfGetManufacturerCodeForAttribute(cluster, am),
+                                                                    am->attributeId))
                             {
-                                uint8_t * attributeLocation =
-                                    (am->mask & ATTRIBUTE_MASK_SINGLETON ? singletonAttributeLocation(am)
-                                                                         : attributeData + attributeOffsetIndex);
-                                uint8_t *src, *dst;
-                                if (write)
-                                {
-                                    src = buffer;
-                                    dst = attributeLocation;
-                                    if (!emberAfAttributeWriteAccessCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                             emAfGetManufacturerCodeForAttribute(cluster, am),
-                                                                             am->attributeId))
-                                    {
-                                        return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
-                                    }
-                                }
-                                else
-                                {
-                                    if (buffer == NULL)
-                                    {
-                                        return EMBER_ZCL_STATUS_SUCCESS;
-                                    }
-
-                                    src = attributeLocation;
-                                    dst = buffer;
-                                    if (!emberAfAttributeReadAccessCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                            emAfGetManufacturerCodeForAttribute(cluster, am),
-                                                                            am->attributeId))
-                                    {
-                                        return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
-                                    }
-                                }
-
-                                return (am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE
-                                            ? (write) ? emberAfExternalAttributeWriteCallback(
-                                                            attRecord->endpoint, attRecord->clusterId, am,
-                                                            emAfGetManufacturerCodeForAttribute(cluster, am), buffer)
-                                                      : emberAfExternalAttributeReadCallback(
-                                                            attRecord->endpoint, attRecord->clusterId, am,
-                                                            emAfGetManufacturerCodeForAttribute(cluster, am), buffer,
-                                                            emberAfAttributeSize(am))
-                                            : typeSensitiveMemCopy(dst, src, am, write, readLength));
+                                return EMBER_ZCL_STATUS_NOT_AUTHORIZED;
                             }
                         }
-                        else
-                        { // Not the attribute we are looking for
-                            // Increase the index if attribute is not externally stored
-                            if (!(am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) && !(am->mask & ATTRIBUTE_MASK_SINGLETON))
+
+                        if (emberAfClusterIsServer(cluster))
+                        {
+                            EmberAfAttributeAccessor * accessor =
+                                emberAfFindAttributeAccessor(attRecord->endpoint, attRecord->clusterId);
+                            if (accessor != NULL)
                             {
-                                attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emberAfAttributeSize(am));
+                                return (write ? accessor->WriteAttribute(attRecord->endpoint, am, buffer)
+                                              : readAttributeFromAccessor(accessor, attRecord->endpoint, am, buffer, readLength));
                             }
                         }
+
+                        return (am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE
+                                    ? (write) ? emberAfExternalAttributeWriteCallback(
+                                                    attRecord->endpoint, attRecord->clusterId, am,
+                                                    emAfGetManufacturerCodeForAttribute(cluster, am), buffer)
+                                              : emberAfExternalAttributeReadCallback(
+                                                    attRecord->endpoint, attRecord->clusterId, am,
+                                                    emAfGetManufacturerCodeForAttribute(cluster, am), buffer,
+                                                    emberAfAttributeSize(am))
+                                    : typeSensitiveMemCopy(dst, src, am, write, readLength));
                     }
                 }
                 else
-                { // Not the cluster we are looking for
-                    attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + cluster->clusterSize);
+                { // Not the attribute we are looking for
+                    // Increase the index if attribute is not externally stored
+                    if (!(am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) && !(am->mask & ATTRIBUTE_MASK_SINGLETON))
+                    {
+                        attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emberAfAttributeSize(am));
+                    }
                 }
             }
         }
         else
-        { // Not the endpoint we are looking for
-            attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emAfEndpoints[i].endpointType->endpointSize);
+        { // Not the cluster we are looking for
+            attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + cluster->clusterSize);
         }
     }
     return EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE; // Sorry, attribute was not found.
 }
 
+static EmberAfStatus readAttributeFromAccessor(EmberAfAttributeAccessor * accessor, EndpointId endpoint,
+                                               EmberAfAttributeMetadata * am, uint8_t * buffer, uint16_t readLength)
+{
+    EmberAfAttributeReadRecord record;
+    record.attributeId = am->attributeId;
+    record.buffer      = buffer;
+    // A zero readLength comes from the compatibility wrappers, whose buffer is
+    // sized for the attribute.
+    record.bufferSize = (readLength == 0 ? emberAfAttributeSize(am) : readLength);
+    record.metadata   = am;
+    record.status     = EMBER_ZCL_STATUS_FAILURE;
+    accessor->ReadAttributes(endpoint, &record, 1);
+    return record.status;
+}
+
+// Returns the list the accessors registered for an endpoint are in.
+static EmberAfAttributeAccessor ** findAttributeAccessorList(EndpointId endpoint)
+{
+    uint8_t index;
+
+    if (endpoint == EMBER_BROADCAST_ENDPOINT)
+    {
+        return &wildcardAttributeAccessors;
+    }
+
+    index = findIndexFromEndpoint(endpoint, false);
+    return (index == 0xFF ? &detachedAttributeAccessors : &(emAfEndpoints[index].attributeAccessors));
+}
+
+bool emberAfRegisterAttributeAccessor(EmberAfAttributeAccessor * accessor)
+{
+    EmberAfAttributeAccessor ** list = findAttributeAccessorList(accessor->GetEndpoint());
+    EmberAfAttributeAccessor * other;
+    for (other = *list; other != NULL; other = other->mNext)
+    {
+        if (other == accessor ||
+            (other->GetEndpoint() == accessor->GetEndpoint() && other->GetClusterId() == accessor->GetClusterId()))
+        {
+            return false;
+        }
+    }
+
+    accessor->mNext = *list;
+    *list           = accessor;
+    return true;
+}
+
+void emberAfUnregisterAttributeAccessor(EmberAfAttributeAccessor * accessor)
+{
+    EmberAfAttributeAccessor ** link;
+    for (link = findAttributeAccessorList(accessor->GetEndpoint()); *link != NULL; link = &((*link)->mNext))
+    {
+        if (*link == accessor)
+        {
+            *link           = accessor->mNext;
+            accessor->mNext = NULL;
+            return;
+        }
+    }
+}
+
+EmberAfAttributeAccessor * emberAfFindAttributeAccessor(EndpointId endpoint, ClusterId clusterId)
+{
+    EmberAfAttributeAccessor * accessor;
+
+    if (endpoint != EMBER_BROADCAST_ENDPOINT)
+    {
+        // The list of a defined endpoint only holds its own accessors, usually one or two.
+        for (accessor = *findAttributeAccessorList(endpoint); accessor != NULL; accessor = accessor->mNext)
+        {
+            if (accessor->GetEndpoint() == endpoint && accessor->GetClusterId() == clusterId)
+            {
+                return accessor;
+            }
+        }
+    }
+
+    for (accessor = wildcardAttributeAccessors; accessor != NULL; accessor = accessor->mNext)
+    {
+        if (accessor->GetClusterId() == clusterId)
+        {
+            return accessor;
+        }
+    }
+    return NULL;
+}
+
+void emAfAttachAttributeAccessors(uint8_t index)
+{
+    EmberAfDefinedEndpoint * definedEndpoint = &(emAfEndpoints[index]);
+    EmberAfAttributeAccessor ** link         = &detachedAttributeAccessors;
+
+    while (*link != NULL)
+    {
+        EmberAfAttributeAccessor * accessor = *link;
+        if (accessor->GetEndpoint() == definedEndpoint->endpoint)
+        {
+            *link                               = accessor->mNext;
+            accessor->mNext                     = definedEndpoint->attributeAccessors;
+            definedEndpoint->attributeAccessors = accessor;
+        }
+        else
+        {
+            link = &(accessor->mNext);
+        }
+    }
+}
+
+void emAfDetachAttributeAccessors(uint8_t index)
+{
+    EmberAfDefinedEndpoint * definedEndpoint = &(emAfEndpoints[index]);
+
+    while (definedEndpoint->attributeAccessors != NULL)
+    {
+        EmberAfAttributeAccessor * accessor = definedEndpoint->attributeAccessors;
+        definedEndpoint->attributeAccessors = accessor->mNext;
+        accessor->mNext                     = detachedAttributeAccessors;
+        detachedAttributeAccessors          = accessor;
+    }
+}
+
+void emberAfReadServerAttributes(EndpointId endpoint, ClusterId clusterId, EmberAfAttributeReadRecord * records, uint16_t count)
+{
+    EmberAfAttributeAccessor * accessor = emberAfFindAttributeAccessor(endpoint, clusterId);
+    EmberAfCluster * cluster            = emberAfFindCluster(endpoint, clusterId, CLUSTER_MASK_SERVER);
+    uint16_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        EmberAfAttributeReadRecord * record = &(records[i]);
+        EmberAfAttributeSearchRecord searchRecord;
+        searchRecord.endpoint         = endpoint;
+        searchRecord.clusterId        = clusterId;
+        searchRecord.clusterMask      = CLUSTER_MASK_SERVER;
+        searchRecord.attributeId      = record->attributeId;
+        searchRecord.manufacturerCode = EMBER_AF_NULL_MANUFACTURER_CODE;
+        record->metadata              = NULL;
+
+        if (accessor == NULL || cluster == NULL)
+        {
+            // Read from the attribute storage right away.
+            record->status =
+                emAfReadOrWriteAttribute(&searchRecord, &(record->metadata), record->buffer, record->bufferSize, false);
+            if (record->status != EMBER_ZCL_STATUS_SUCCESS)
+            {
+                record->metadata = NULL;
+            }
+            continue;
+        }
+
+        // Only look the attribute up: the accessor reads every attribute in one call below.
+        emAfReadOrWriteAttribute(&searchRecord, &(record->metadata), NULL, 0, false);
+        if (record->metadata == NULL)
+        {
+            record->status = EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
+        }
+        else if (!emberAfAttributeReadAccessCallback(endpoint, clusterId,
+                                                     emAfGetManufacturerCodeForAttribute(cluster, record->metadata),
+                                                     record->attributeId))
+        {
+            record->metadata = NULL;
+            record->status   = EMBER_ZCL_STATUS_NOT_AUTHORIZED;
+        }
+        else
+        {
+            record->status = EMBER_ZCL_STATUS_FAILURE;
+        }
+    }
+
+    if (accessor != NULL && cluster != NULL)
+    {
+        accessor->ReadAttributes(endpoint, records, count);
+    }
+}
+
 // Check if a cluster is implemented or not. If yes, the cluster is returned.
 // If the cluster is not manufacturerSpecific [ClusterId < FC00] then
 // manufacturerCode argument is ignored otherwise checked.
@@ -777,6 +1076,12 @@ static uint8_t findClusterEndpointIndex(EndpointId endpoint, ClusterId clusterId
         return 0xFF;
     }
 
+    // Cluster state tables are sized for the fixed endpoints only.
+    if (findIndexFromEndpoint(endpoint, false) >= FIXED_ENDPOINT_COUNT)
+    {
+        return 0xFF;
+    }
+
     for (i = 0; i < emberAfEndpointCount(); i++)
     {
         if (emAfEndpoints[i].endpoint == endpoint)
@@ -795,14 +1100,11 @@ static uint8_t findClusterEndpointIndex(EndpointId endpoint, ClusterId clusterId
 
 static uint8_t findIndexFromEndpoint(EndpointId endpoint, bool ignoreDisabledEndpoints)
 {
-    uint8_t epi;
-    for (epi = 0; epi < emberAfEndpointCount(); epi++)
+    uint8_t epi = endpointIndexTable[endpoint];
+    if (epi < emberAfEndpointCount() && emAfEndpoints[epi].endpoint == endpoint &&
+        (!ignoreDisabledEndpoints || emAfEndpoints[epi].bitmask & EMBER_AF_ENDPOINT_ENABLED))
     {
-        if (emAfEndpoints[epi].endpoint == endpoint &&
-            (!ignoreDisabledEndpoints || emAfEndpoints[epi].bitmask & EMBER_AF_ENDPOINT_ENABLED))
-        {
-            return epi;
-        }
+        return epi;
     }
     return 0xFF;
 }
@@ -1065,6 +1367,12 @@ void emAfLoadAttributeDefaults(EndpointId endpoint, bool writeTokens)
         {
             EmberAfCluster * cluster = &(de->endpointType->cluster[clusterI]);
 
+            // The values of a cluster served by an accessor are the application's.
+            if (emberAfClusterIsServer(cluster) && emberAfFindAttributeAccessor(de->endpoint, cluster->clusterId) != NULL)
+            {
+                continue;
+            }
+
             // when the attributeCount is high, the loop takes too long to run and a
             // watchdog kicks in causing a reset. As a workaround, we'll
             // conditionally manually reset the watchdog. 300 sounds like a good
@@ -1145,11 +1453,68 @@ void emAfLoadAttributeDefaults(EndpointId endpoint, bool writeTokens)
 
 void emAfLoadAttributesFromTokens(EndpointId endpoint)
 {
-    // On EZSP host we currently do not support this. We need to come up with some
-    // callbacks.
+    app::AttributePersistence * persistence = app::AttributePersistence::GetInstance();
+    uint8_t ep, clusterI;
+    uint16_t attr;
+    uint8_t epCount = emberAfEndpointCount();
+
+    if (!persistence->IsValid())
+    {
+        // On EZSP host we currently do not support this. We need to come up with some
+        // callbacks.
 #ifndef EZSP_HOST
-    GENERATED_TOKEN_LOADER(endpoint);
+        GENERATED_TOKEN_LOADER(endpoint);
 #endif // EZSP_HOST
+        return;
+    }
+
+    for (ep = 0; ep < epCount; ep++)
+    {
+        EmberAfDefinedEndpoint * de;
+        if (endpoint != EMBER_BROADCAST_ENDPOINT)
+        {
+            ep = emberAfIndexFromEndpoint(endpoint);
+            if (ep == 0xFF)
+            {
+                return;
+            }
+        }
+        de = &(emAfEndpoints[ep]);
+
+        for (clusterI = 0; clusterI < de->endpointType->clusterCount; clusterI++)
+        {
+            EmberAfCluster * cluster = &(de->endpointType->cluster[clusterI]);
+            for (attr = 0; attr < cluster->attributeCount; attr++)
+            {
+                EmberAfAttributeMetadata * am = &(cluster->attributes[attr]);
+                uint8_t value[ATTRIBUTE_LARGEST];
+
+                if (!emberAfAttributeIsTokenized(am) || (am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) ||
+                    emberAfAttributeSize(am) > sizeof(value) ||
+                    persistence->Load({ de->endpoint, cluster->clusterId, am->attributeId }, value, emberAfAttributeSize(am)) !=
+                        CHIP_NO_ERROR)
+                {
+                    continue;
+                }
+
+                EmberAfAttributeSearchRecord record;
+                record.endpoint         = de->endpoint;
+                record.clusterId        = cluster->clusterId;
+                record.clusterMask      = (emberAfAttributeIsClient(am) ? CLUSTER_MASK_CLIENT : CLUSTER_MASK_SERVER);
+                record.attributeId      = am->attributeId;
+                record.manufacturerCode = emAfGetManufacturerCodeForAttribute(cluster, am);
+                emAfReadOrWriteAttribute(&record,
+                                         NULL, // metadata - unused
+                                         value,
+                                         0,     // buffer size - unused
+                                         true); // write?
+            }
+        }
+        if (endpoint != EMBER_BROADCAST_ENDPOINT)
+        {
+            break;
+        }
+    }
 }
 
 // 'data' argument may be null, since we changed the ptrToDefaultValue
@@ -1163,6 +1528,15 @@ void emAfSaveAttributeToToken(uint8_t * data, EndpointId endpoint, ClusterId clu
         return;
     }
 
+    // Attributes stepping through a transition are saved many times a second:
+    // the persistence journal coalesces them into one write per flush.
+    if (app::AttributePersistence::GetInstance()->IsValid())
+    {
+        app::AttributePersistence::GetInstance()->Save({ endpoint, clusterId, metadata->attributeId }, data,
+                                                       emberAfAttributeSize(metadata));
+        return;
+    }
+
 // On EZSP host we currently do not support this. We need to come up with some
 // callbacks.
 #ifndef EZSP_HOST
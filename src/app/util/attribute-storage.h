@@ -44,6 +44,8 @@
 //#include PLATFORM_HEADER
 #include "af.h"
 
+#include <platform/CHIPDeviceConfig.h>
+
 #if !defined(EMBER_SCRIPTED_TEST)
 #include "gen/att-storage.h"
 #endif
@@ -63,9 +65,9 @@
 #include ATTRIBUTE_STORAGE_CONFIGURATION
 #endif
 
-// If we have fixed number of endpoints, then max is the same.
+// The fixed endpoints come first, followed by the slots of the dynamic endpoints.
 #ifdef FIXED_ENDPOINT_COUNT
-#define MAX_ENDPOINT_COUNT FIXED_ENDPOINT_COUNT
+#define MAX_ENDPOINT_COUNT (FIXED_ENDPOINT_COUNT + CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT)
 #endif
 
 #define CLUSTER_TICK_FREQ_ALL (0x00)
@@ -90,6 +92,20 @@ void emAfCallInits(void);
 
 // Initial configuration
 void emberAfEndpointConfigure(void);
+
+// Registers an endpoint in dynamic slot index, which must be less than
+// CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT. The attributes of the endpoint are
+// kept in attributeStorage, which must hold ep->endpointSize bytes and stay valid
+// until the endpoint is cleared. Singleton attributes and per-endpoint cluster
+// state tables sized at compile time are only available on fixed endpoints.
+// The attributes are loaded with their defaults and the cluster init functions
+// are called before this returns.
+EmberAfStatus emberAfSetDynamicEndpoint(uint8_t index, chip::EndpointId id, EmberAfEndpointType * ep, uint16_t deviceId,
+                                        uint8_t deviceVersion, uint8_t * attributeStorage);
+
+// Removes the endpoint registered in dynamic slot index.
+EmberAfStatus emberAfClearDynamicEndpoint(uint8_t index);
+
 bool emberAfExtractCommandIds(bool outgoing, EmberAfClusterCommand * cmd, chip::ClusterId clusterId, uint8_t * buffer,
                               uint16_t bufferLength, uint16_t * bufferIndex, uint8_t startId, uint8_t maxIdCount);
 
@@ -220,3 +236,74 @@ uint8_t emberAfGetClusterCountForEndpoint(chip::EndpointId endpoint);
 EmberAfCluster * emberAfGetClusterByIndex(chip::EndpointId endpoint, uint8_t clusterIndex);
 
 uint16_t emberAfGetDeviceIdForEndpoint(chip::EndpointId endpoint);
+
+// One attribute of a batched read. The caller sets attributeId, buffer and
+// bufferSize; the read sets metadata, leaving it NULL when the attribute does
+// not exist or may not be read, and status.
+typedef struct
+{
+    chip::AttributeId attributeId;
+    uint8_t * buffer;
+    uint16_t bufferSize;
+    EmberAfAttributeMetadata * metadata;
+    EmberAfStatus status;
+} EmberAfAttributeReadRecord;
+
+// Serves the server attributes of a cluster from the application instead of
+// the attribute storage, e.g. a bridge answering from its cache of the bridged
+// devices. The attributes keep their metadata, and usually the
+// ATTRIBUTE_MASK_EXTERNAL_STORAGE mask so that they take no room in the
+// attribute storage. An accessor registered for EMBER_BROADCAST_ENDPOINT
+// serves the cluster on every endpoint that has no accessor of its own.
+class EmberAfAttributeAccessor
+{
+public:
+    EmberAfAttributeAccessor(chip::EndpointId endpoint, chip::ClusterId clusterId) : mEndpoint(endpoint), mClusterId(clusterId) {}
+    virtual ~EmberAfAttributeAccessor() {}
+
+    // Reads the attributes of the records that have metadata into their
+    // buffers, in the same format as the attribute storage, and sets their
+    // status. The other records already carry their status.
+    virtual void ReadAttributes(chip::EndpointId endpoint, EmberAfAttributeReadRecord * records, uint16_t count) = 0;
+
+    // Writes an attribute from a buffer in the format of the attribute storage.
+    // Attributes are read only unless this is overridden.
+    virtual EmberAfStatus WriteAttribute(chip::EndpointId endpoint, EmberAfAttributeMetadata * metadata, uint8_t * buffer)
+    {
+        return EMBER_ZCL_STATUS_READ_ONLY;
+    }
+
+    chip::EndpointId GetEndpoint() const { return mEndpoint; }
+    chip::ClusterId GetClusterId() const { return mClusterId; }
+
+private:
+    friend bool emberAfRegisterAttributeAccessor(EmberAfAttributeAccessor * accessor);
+    friend void emberAfUnregisterAttributeAccessor(EmberAfAttributeAccessor * accessor);
+    friend EmberAfAttributeAccessor * emberAfFindAttributeAccessor(chip::EndpointId endpoint, chip::ClusterId clusterId);
+    friend void emAfAttachAttributeAccessors(uint8_t index);
+    friend void emAfDetachAttributeAccessors(uint8_t index);
+
+    chip::EndpointId mEndpoint;
+    chip::ClusterId mClusterId;
+    EmberAfAttributeAccessor * mNext = nullptr;
+};
+
+// Registers an accessor. Returns false if another accessor is already
+// registered for the same endpoint and cluster.
+bool emberAfRegisterAttributeAccessor(EmberAfAttributeAccessor * accessor);
+void emberAfUnregisterAttributeAccessor(EmberAfAttributeAccessor * accessor);
+
+// Returns the accessor serving a server cluster on an endpoint, or NULL if its
+// attributes are in the attribute storage.
+EmberAfAttributeAccessor * emberAfFindAttributeAccessor(chip::EndpointId endpoint, chip::ClusterId clusterId);
+
+// The accessors of an endpoint are kept with it in emAfEndpoints, so that
+// finding one does not go through every accessor. These move the accessors of
+// the endpoint at index from, and to, those of endpoints not defined yet.
+void emAfAttachAttributeAccessors(uint8_t index);
+void emAfDetachAttributeAccessors(uint8_t index);
+
+// Reads several server attributes of one cluster on one endpoint. When the
+// cluster is served by an accessor, they are read with a single call to it.
+void emberAfReadServerAttributes(chip::EndpointId endpoint, chip::ClusterId clusterId, EmberAfAttributeReadRecord * records,
+                                 uint16_t count);
@@ -49,6 +49,7 @@
 #include "af-main.h"
 #include "app/util/common.h"
 #include "gen/callback.h"
+#include <app/InteractionModelEngine.h>
 
 #ifdef EMBER_AF_PLUGIN_REPORTING
 #include <app/reporting/reporting.h>
@@ -606,6 +607,12 @@ EmberAfStatus emAfWriteAttribute(EndpointId endpoint, ClusterId cluster, Attribu
         emberAfReportingAttributeChangeCallback(endpoint, cluster, attributeID, mask, manufacturerCode, dataType, data);
 #endif // EMBER_AF_PLUGIN_REPORTING
 
+        // Subscribers get the new value in their next report.
+        if (mask == CLUSTER_MASK_SERVER)
+        {
+            app::InteractionModelEngine::GetInstance()->GetSubscriptionEngine().MarkDirty({ endpoint, cluster, attributeID });
+        }
+
         // Post write attribute callback for all attributes changes, regardless
         // of cluster.
         emberAfPostAttributeChangeCallback(endpoint, cluster, attributeID, mask, manufacturerCode, dataType,
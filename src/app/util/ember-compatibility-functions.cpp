@@ -24,11 +24,17 @@
 #include "ember-compatibility-functions.h"
 
 #include <app/Command.h>
+#include <app/InteractionModelEngine.h>
+#include <app/util/attribute-storage.h>
+#include <app/util/attribute-table.h>
 #include <lib/core/CHIPCore.h>
 #include <lib/core/CHIPTLV.h>
 #include <lib/support/CodeUtils.h>
+#include <lib/support/ReturnMacros.h>
 #include <util/util.h>
 
+#include "gen/attribute-type.h"
+
 namespace chip {
 namespace app {
 namespace Compatibility {
@@ -93,5 +99,220 @@ void ResetEmberAfObjects()
 }
 
 } // namespace Compatibility
+
+bool FindNextAttribute(const AttributePathParams & aPath, AttributePathCursor & aCursor, ConcreteAttributePath & aAttribute)
+{
+    for (; aCursor.EndpointIndex < emberAfEndpointCount();
+         aCursor.EndpointIndex++, aCursor.ClusterIndex = 0, aCursor.AttributeIndex = 0)
+    {
+        if (!emberAfEndpointIndexIsEnabled(aCursor.EndpointIndex))
+        {
+            continue;
+        }
+
+        const EndpointId endpoint = emberAfEndpointFromIndex(aCursor.EndpointIndex);
+        if (aPath.PathFlags.Has(AttributePathParams::Flags::kEndpointIdValid) && endpoint != aPath.EndpointId)
+        {
+            continue;
+        }
+
+        const uint8_t clusterCount = emberAfGetClusterCountForEndpoint(endpoint);
+        for (; aCursor.ClusterIndex < clusterCount; aCursor.ClusterIndex++, aCursor.AttributeIndex = 0)
+        {
+            const EmberAfCluster * cluster = emberAfGetClusterByIndex(endpoint, aCursor.ClusterIndex);
+            if (cluster == nullptr || !emberAfClusterIsServer(cluster) ||
+                (aPath.PathFlags.Has(AttributePathParams::Flags::kClusterIdValid) && cluster->clusterId != aPath.ClusterId))
+            {
+                continue;
+            }
+
+            while (aCursor.AttributeIndex < cluster->attributeCount)
+            {
+                aAttribute = { endpoint, cluster->clusterId, cluster->attributes[aCursor.AttributeIndex++].attributeId };
+                if (aPath.Matches(aAttribute))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+namespace {
+
+// Values read ahead by PrefetchAttributeData, packed in sPrefetchBuffer.
+struct PrefetchedAttribute
+{
+    AttributeId mFieldId;
+    EmberAfAttributeType mType;
+    uint16_t mOffset;
+    uint16_t mSize;
+};
+
+EndpointId sPrefetchedEndpoint;
+ClusterId sPrefetchedCluster;
+PrefetchedAttribute sPrefetched[CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES];
+size_t sPrefetchedCount = 0;
+uint8_t sPrefetchBuffer[CHIP_IM_ATTRIBUTE_PREFETCH_BUFFER_SIZE];
+
+const PrefetchedAttribute * FindPrefetchedAttribute(const ConcreteAttributePath & aPath)
+{
+    if (sPrefetchedCount == 0 || aPath.EndpointId != sPrefetchedEndpoint || aPath.ClusterId != sPrefetchedCluster)
+    {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < sPrefetchedCount; i++)
+    {
+        if (sPrefetched[i].mFieldId == aPath.FieldId)
+        {
+            return &sPrefetched[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ *  Encode an attribute value in the format of the attribute storage. aSize is the size of the attribute.
+ */
+CHIP_ERROR EncodeAttributeValue(EmberAfAttributeType aType, const uint8_t * apData, uint16_t aSize, TLV::TLVWriter & aWriter,
+                                uint64_t aTag)
+{
+    uint64_t value = 0;
+
+    switch (aType)
+    {
+    case ZCL_BOOLEAN_ATTRIBUTE_TYPE:
+        return aWriter.PutBoolean(aTag, apData[0] != 0);
+    case ZCL_CHAR_STRING_ATTRIBUTE_TYPE:
+        VerifyOrReturnError(aSize >= 1 && emberAfStringLength(apData) < aSize, CHIP_ERROR_INTERNAL);
+        return aWriter.PutString(aTag, reinterpret_cast<const char *>(apData + 1), emberAfStringLength(apData));
+    case ZCL_OCTET_STRING_ATTRIBUTE_TYPE:
+        VerifyOrReturnError(aSize >= 1 && emberAfStringLength(apData) < aSize, CHIP_ERROR_INTERNAL);
+        return aWriter.PutBytes(aTag, apData + 1, emberAfStringLength(apData));
+    case ZCL_LONG_CHAR_STRING_ATTRIBUTE_TYPE:
+        VerifyOrReturnError(aSize >= 2 && emberAfLongStringLength(apData) <= aSize - 2, CHIP_ERROR_INTERNAL);
+        return aWriter.PutString(aTag, reinterpret_cast<const char *>(apData + 2), emberAfLongStringLength(apData));
+    case ZCL_LONG_OCTET_STRING_ATTRIBUTE_TYPE:
+        VerifyOrReturnError(aSize >= 2 && emberAfLongStringLength(apData) <= aSize - 2, CHIP_ERROR_INTERNAL);
+        return aWriter.PutBytes(aTag, apData + 2, emberAfLongStringLength(apData));
+    default:
+        break;
+    }
+
+    // Anything that is not a number, such as a structured or security key attribute, goes out as raw bytes.
+    if (aSize == 0 || aSize > sizeof(value))
+    {
+        return aWriter.PutBytes(aTag, apData, aSize);
+    }
+
+    for (uint16_t i = 0; i < aSize; i++)
+    {
+#if (BIGENDIAN_CPU)
+        value = (value << 8) | apData[i];
+#else
+        value = (value << 8) | apData[aSize - 1 - i];
+#endif // (BIGENDIAN_CPU)
+    }
+
+    if (emberAfIsTypeSigned(aType))
+    {
+        const unsigned shift = 64u - 8u * aSize;
+        return aWriter.Put(aTag, static_cast<int64_t>(value << shift) >> shift);
+    }
+
+    return aWriter.Put(aTag, value);
+}
+
+} // namespace
+
+void PrefetchAttributeData(const ConcreteAttributePath * apPaths, size_t aPathCount)
+{
+    EmberAfAttributeReadRecord records[CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES];
+    uint16_t recordCount = 0;
+    uint16_t offset      = 0;
+
+    ReleaseAttributeData();
+
+    // Attributes in the attribute storage are cheap to read as they are encoded.
+    VerifyOrReturn(aPathCount > 0 && emberAfFindAttributeAccessor(apPaths[0].EndpointId, apPaths[0].ClusterId) != nullptr);
+
+    for (size_t i = 0; i < aPathCount && recordCount < CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES; i++)
+    {
+        const EmberAfAttributeMetadata * metadata = emberAfLocateAttributeMetadata(
+            apPaths[i].EndpointId, apPaths[i].ClusterId, apPaths[i].FieldId, CLUSTER_MASK_SERVER, EMBER_AF_NULL_MANUFACTURER_CODE);
+        if (metadata == nullptr)
+        {
+            continue;
+        }
+
+        const uint16_t size = emberAfAttributeSize(metadata);
+        if (size > sizeof(sPrefetchBuffer) - offset)
+        {
+            break;
+        }
+
+        records[recordCount].attributeId = apPaths[i].FieldId;
+        records[recordCount].buffer      = &sPrefetchBuffer[offset];
+        records[recordCount].bufferSize  = size;
+        recordCount++;
+        offset = static_cast<uint16_t>(offset + size);
+    }
+
+    emberAfReadServerAttributes(apPaths[0].EndpointId, apPaths[0].ClusterId, records, recordCount);
+
+    sPrefetchedEndpoint = apPaths[0].EndpointId;
+    sPrefetchedCluster  = apPaths[0].ClusterId;
+    for (uint16_t i = 0; i < recordCount; i++)
+    {
+        // A failed read is left to ReadSingleAttributeData, which reports it.
+        if (records[i].status != EMBER_ZCL_STATUS_SUCCESS || records[i].metadata == nullptr)
+        {
+            continue;
+        }
+
+        PrefetchedAttribute & attribute = sPrefetched[sPrefetchedCount++];
+        attribute.mFieldId              = records[i].attributeId;
+        attribute.mType                 = records[i].metadata->attributeType;
+        attribute.mOffset               = static_cast<uint16_t>(records[i].buffer - sPrefetchBuffer);
+        attribute.mSize                 = records[i].bufferSize;
+    }
+}
+
+void ReleaseAttributeData()
+{
+    sPrefetchedCount = 0;
+}
+
+CHIP_ERROR ReadSingleAttributeData(const ConcreteAttributePath & aPath, TLV::TLVWriter & aWriter, uint64_t aTag)
+{
+    uint8_t data[ATTRIBUTE_LARGEST];
+    EmberAfAttributeType dataType;
+
+    const PrefetchedAttribute * prefetched = FindPrefetchedAttribute(aPath);
+    if (prefetched != nullptr)
+    {
+        return EncodeAttributeValue(prefetched->mType, &sPrefetchBuffer[prefetched->mOffset], prefetched->mSize, aWriter, aTag);
+    }
+
+    const EmberAfAttributeMetadata * metadata = emberAfLocateAttributeMetadata(
+        aPath.EndpointId, aPath.ClusterId, aPath.FieldId, CLUSTER_MASK_SERVER, EMBER_AF_NULL_MANUFACTURER_CODE);
+    VerifyOrReturnError(metadata != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+
+    EmberAfStatus status = emAfReadAttribute(aPath.EndpointId, aPath.ClusterId, aPath.FieldId, CLUSTER_MASK_SERVER,
+                                             EMBER_AF_NULL_MANUFACTURER_CODE, data, static_cast<uint16_t>(sizeof(data)), &dataType);
+    VerifyOrReturnError(status == EMBER_ZCL_STATUS_SUCCESS, CHIP_ERROR_INTERNAL);
+
+    uint16_t size = emberAfAttributeSize(metadata);
+    if (size > sizeof(data))
+    {
+        size = static_cast<uint16_t>(sizeof(data));
+    }
+
+    return EncodeAttributeValue(dataType, data, size, aWriter, aTag);
+}
+
 } // namespace app
 } // namespace chip
@@ -0,0 +1,421 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the endpoints and the attribute
+ *      accessors of the attribute storage, against the configuration in
+ *      tests/gen: endpoint 1 is fixed and the test build has
+ *      CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT dynamic slots.
+ *
+ */
+
+#include <app/util/af.h>
+#include <app/util/attribute-storage.h>
+#include <gen/attribute-type.h>
+#include <gen/callback.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+using namespace chip;
+
+namespace {
+
+static_assert(CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT >= 2, "The tests need two dynamic endpoints");
+
+constexpr EndpointId kFixedEndpoint   = 1;
+constexpr EndpointId kFirstEndpoint   = 10;
+constexpr EndpointId kSecondEndpoint  = 11;
+constexpr EndpointId kUnusedEndpoint  = 200;
+constexpr ClusterId kOnOffCluster     = 0x0006;
+constexpr ClusterId kLevelCluster     = 0x0008;
+constexpr AttributeId kOnOffAttribute = 0x0000;
+constexpr AttributeId kRevision       = 0xFFFD;
+constexpr AttributeId kUnknown        = 0x1234;
+constexpr uint16_t kDeviceId          = 0x0100;
+constexpr uint8_t kDeviceVersion      = 1;
+constexpr uint8_t kNoEndpointIndex    = 0xFF;
+
+// An On/off light whose on/off attribute defaults to on.
+EmberAfAttributeMetadata lightOnOffAttributes[] = {
+    { kOnOffAttribute, ZCL_BOOLEAN_ATTRIBUTE_TYPE, 1, 0, { (uint8_t *) 0x01 } },
+    { kRevision, ZCL_INT16U_ATTRIBUTE_TYPE, 2, 0, { (uint8_t *) 2 } },
+};
+
+EmberAfCluster lightClusters[] = {
+    { kOnOffCluster, lightOnOffAttributes, ArraySize(lightOnOffAttributes), 3, CLUSTER_MASK_SERVER, nullptr },
+};
+
+EmberAfEndpointType lightEndpointType = { lightClusters, ArraySize(lightClusters), 3 };
+
+uint8_t gStorage[CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT][3];
+bool gDenyReads = false;
+
+// Serves every attribute with the same one-byte value and counts its calls.
+class TestAccessor : public EmberAfAttributeAccessor
+{
+public:
+    TestAccessor(EndpointId endpoint, ClusterId clusterId, uint8_t value) :
+        EmberAfAttributeAccessor(endpoint, clusterId), mValue(value)
+    {}
+
+    void ReadAttributes(EndpointId endpoint, EmberAfAttributeReadRecord * records, uint16_t count) override
+    {
+        mReadCalls++;
+        mReadCount = count;
+        for (uint16_t i = 0; i < count; i++)
+        {
+            if (records[i].metadata != nullptr)
+            {
+                records[i].buffer[0] = mValue;
+                records[i].status    = EMBER_ZCL_STATUS_SUCCESS;
+            }
+        }
+    }
+
+    uint8_t mValue;
+    uint16_t mReadCalls = 0;
+    uint16_t mReadCount = 0;
+};
+
+EmberAfStatus AddLight(uint8_t index, EndpointId endpoint)
+{
+    return emberAfSetDynamicEndpoint(index, endpoint, &lightEndpointType, kDeviceId, kDeviceVersion, gStorage[index]);
+}
+
+EmberAfStatus ReadOnOff(EndpointId endpoint, uint8_t & value)
+{
+    EmberAfAttributeReadRecord record;
+    record.attributeId = kOnOffAttribute;
+    record.buffer      = &value;
+    record.bufferSize  = sizeof(value);
+    emberAfReadServerAttributes(endpoint, kOnOffCluster, &record, 1);
+    return record.status;
+}
+
+void ClearAll()
+{
+    for (uint8_t i = 0; i < CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT; i++)
+    {
+        emberAfClearDynamicEndpoint(i);
+    }
+}
+
+void TestSetClearEndpoint(nlTestSuite * inSuite, void * inContext)
+{
+    uint8_t value = 0;
+
+    NL_TEST_ASSERT(inSuite, AddLight(0, kFirstEndpoint) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfEndpointCount() == FIXED_ENDPOINT_COUNT + 1);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kFirstEndpoint) == FIXED_ENDPOINT_COUNT);
+    NL_TEST_ASSERT(inSuite, emberAfEndpointFromIndex(FIXED_ENDPOINT_COUNT) == kFirstEndpoint);
+    NL_TEST_ASSERT(inSuite, emberAfFindCluster(kFirstEndpoint, kOnOffCluster, CLUSTER_MASK_SERVER) == &lightClusters[0]);
+
+    // The attributes were loaded with their defaults.
+    NL_TEST_ASSERT(inSuite, ReadOnOff(kFirstEndpoint, value) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, value == 1);
+
+    NL_TEST_ASSERT(inSuite, emberAfClearDynamicEndpoint(0) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfEndpointCount() == FIXED_ENDPOINT_COUNT);
+    NL_TEST_ASSERT(inSuite, emberAfClearDynamicEndpoint(0) == EMBER_ZCL_STATUS_NOT_FOUND);
+
+    // The slot and the endpoint id can be used again.
+    gStorage[0][0] = 0;
+    NL_TEST_ASSERT(inSuite, AddLight(0, kFirstEndpoint) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kFirstEndpoint) == FIXED_ENDPOINT_COUNT);
+    NL_TEST_ASSERT(inSuite, ReadOnOff(kFirstEndpoint, value) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, value == 1);
+
+    ClearAll();
+}
+
+void TestLookupAfterClear(nlTestSuite * inSuite, void * inContext)
+{
+    uint8_t value = 0;
+
+    NL_TEST_ASSERT(inSuite, AddLight(0, kFirstEndpoint) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, AddLight(1, kSecondEndpoint) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfEndpointCount() == FIXED_ENDPOINT_COUNT + 2);
+
+    // Clearing the first slot leaves the count covering the second one.
+    NL_TEST_ASSERT(inSuite, emberAfClearDynamicEndpoint(0) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfEndpointCount() == FIXED_ENDPOINT_COUNT + 2);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kFirstEndpoint) == kNoEndpointIndex);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpointIncludingDisabledEndpoints(kFirstEndpoint) == kNoEndpointIndex);
+    NL_TEST_ASSERT(inSuite, emberAfFindCluster(kFirstEndpoint, kOnOffCluster, CLUSTER_MASK_SERVER) == nullptr);
+    NL_TEST_ASSERT(inSuite, ReadOnOff(kFirstEndpoint, value) == EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kSecondEndpoint) == FIXED_ENDPOINT_COUNT + 1);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kFixedEndpoint) == 0);
+
+    // The cleared id does not find the slot once it holds another endpoint.
+    NL_TEST_ASSERT(inSuite, AddLight(0, kUnusedEndpoint) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kFirstEndpoint) == kNoEndpointIndex);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kUnusedEndpoint) == FIXED_ENDPOINT_COUNT);
+
+    // Clearing the last slot shrinks the count down to the last slot in use.
+    NL_TEST_ASSERT(inSuite, emberAfClearDynamicEndpoint(1) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfEndpointCount() == FIXED_ENDPOINT_COUNT + 1);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kSecondEndpoint) == kNoEndpointIndex);
+
+    ClearAll();
+    NL_TEST_ASSERT(inSuite, emberAfEndpointCount() == FIXED_ENDPOINT_COUNT);
+}
+
+void TestIndexOutOfRange(nlTestSuite * inSuite, void * inContext)
+{
+    const uint8_t outOfRange = CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT;
+
+    NL_TEST_ASSERT(inSuite,
+                   emberAfSetDynamicEndpoint(outOfRange, kFirstEndpoint, &lightEndpointType, kDeviceId, kDeviceVersion,
+                                             gStorage[0]) == EMBER_ZCL_STATUS_INVALID_VALUE);
+    NL_TEST_ASSERT(inSuite, emberAfClearDynamicEndpoint(outOfRange) == EMBER_ZCL_STATUS_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, emberAfClearDynamicEndpoint(0xFF) == EMBER_ZCL_STATUS_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, emberAfEndpointCount() == FIXED_ENDPOINT_COUNT);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kFirstEndpoint) == kNoEndpointIndex);
+
+    // Neither are the broadcast endpoint, a missing type or missing storage.
+    NL_TEST_ASSERT(inSuite, AddLight(0, EMBER_BROADCAST_ENDPOINT) == EMBER_ZCL_STATUS_INVALID_VALUE);
+    NL_TEST_ASSERT(inSuite,
+                   emberAfSetDynamicEndpoint(0, kFirstEndpoint, nullptr, kDeviceId, kDeviceVersion, gStorage[0]) ==
+                       EMBER_ZCL_STATUS_INVALID_VALUE);
+    NL_TEST_ASSERT(inSuite,
+                   emberAfSetDynamicEndpoint(0, kFirstEndpoint, &lightEndpointType, kDeviceId, kDeviceVersion, nullptr) ==
+                       EMBER_ZCL_STATUS_INVALID_VALUE);
+    NL_TEST_ASSERT(inSuite, emberAfEndpointCount() == FIXED_ENDPOINT_COUNT);
+}
+
+void TestDuplicateEndpointId(nlTestSuite * inSuite, void * inContext)
+{
+    NL_TEST_ASSERT(inSuite, AddLight(0, kFirstEndpoint) == EMBER_ZCL_STATUS_SUCCESS);
+
+    // The id of another dynamic endpoint or of a fixed one is taken.
+    NL_TEST_ASSERT(inSuite, AddLight(1, kFirstEndpoint) == EMBER_ZCL_STATUS_DUPLICATE_EXISTS);
+    NL_TEST_ASSERT(inSuite, AddLight(1, kFixedEndpoint) == EMBER_ZCL_STATUS_DUPLICATE_EXISTS);
+
+    // So is a slot in use.
+    NL_TEST_ASSERT(inSuite, AddLight(0, kSecondEndpoint) == EMBER_ZCL_STATUS_DUPLICATE_EXISTS);
+
+    NL_TEST_ASSERT(inSuite, emberAfEndpointCount() == FIXED_ENDPOINT_COUNT + 1);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kFirstEndpoint) == FIXED_ENDPOINT_COUNT);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kSecondEndpoint) == kNoEndpointIndex);
+    NL_TEST_ASSERT(inSuite, emberAfIndexFromEndpoint(kFixedEndpoint) == 0);
+
+    ClearAll();
+}
+
+void TestRegisterAccessor(nlTestSuite * inSuite, void * inContext)
+{
+    TestAccessor accessor(kFixedEndpoint, kOnOffCluster, 0);
+    TestAccessor sameCluster(kFixedEndpoint, kOnOffCluster, 0);
+    TestAccessor otherCluster(kFixedEndpoint, kLevelCluster, 0);
+
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFixedEndpoint, kOnOffCluster) == nullptr);
+    NL_TEST_ASSERT(inSuite, emberAfRegisterAttributeAccessor(&accessor));
+    NL_TEST_ASSERT(inSuite, !emberAfRegisterAttributeAccessor(&accessor));
+    NL_TEST_ASSERT(inSuite, !emberAfRegisterAttributeAccessor(&sameCluster));
+    NL_TEST_ASSERT(inSuite, emberAfRegisterAttributeAccessor(&otherCluster));
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFixedEndpoint, kOnOffCluster) == &accessor);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFixedEndpoint, kLevelCluster) == &otherCluster);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFirstEndpoint, kOnOffCluster) == nullptr);
+
+    emberAfUnregisterAttributeAccessor(&accessor);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFixedEndpoint, kOnOffCluster) == nullptr);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFixedEndpoint, kLevelCluster) == &otherCluster);
+
+    // Unregistering twice does nothing, and the cluster can be served again.
+    emberAfUnregisterAttributeAccessor(&accessor);
+    NL_TEST_ASSERT(inSuite, emberAfRegisterAttributeAccessor(&sameCluster));
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFixedEndpoint, kOnOffCluster) == &sameCluster);
+
+    emberAfUnregisterAttributeAccessor(&sameCluster);
+    emberAfUnregisterAttributeAccessor(&otherCluster);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFixedEndpoint, kLevelCluster) == nullptr);
+}
+
+void TestWildcardAccessor(nlTestSuite * inSuite, void * inContext)
+{
+    TestAccessor wildcard(EMBER_BROADCAST_ENDPOINT, kOnOffCluster, 0);
+    TestAccessor accessor(kFixedEndpoint, kOnOffCluster, 0);
+
+    NL_TEST_ASSERT(inSuite, emberAfRegisterAttributeAccessor(&wildcard));
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFixedEndpoint, kOnOffCluster) == &wildcard);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFirstEndpoint, kOnOffCluster) == &wildcard);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFixedEndpoint, kLevelCluster) == nullptr);
+
+    // The accessor of an endpoint comes before the wildcard.
+    NL_TEST_ASSERT(inSuite, emberAfRegisterAttributeAccessor(&accessor));
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFixedEndpoint, kOnOffCluster) == &accessor);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFirstEndpoint, kOnOffCluster) == &wildcard);
+
+    emberAfUnregisterAttributeAccessor(&accessor);
+    emberAfUnregisterAttributeAccessor(&wildcard);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFixedEndpoint, kOnOffCluster) == nullptr);
+}
+
+void TestAccessorOfDynamicEndpoint(nlTestSuite * inSuite, void * inContext)
+{
+    TestAccessor accessor(kFirstEndpoint, kOnOffCluster, 0x42);
+    uint8_t value = 0;
+
+    // An accessor can be registered before its endpoint, and stays registered
+    // while the endpoint is cleared and set again.
+    NL_TEST_ASSERT(inSuite, emberAfRegisterAttributeAccessor(&accessor));
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFirstEndpoint, kOnOffCluster) == &accessor);
+    NL_TEST_ASSERT(inSuite, AddLight(0, kFirstEndpoint) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFirstEndpoint, kOnOffCluster) == &accessor);
+    NL_TEST_ASSERT(inSuite, ReadOnOff(kFirstEndpoint, value) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, value == 0x42);
+
+    NL_TEST_ASSERT(inSuite, emberAfClearDynamicEndpoint(0) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFirstEndpoint, kOnOffCluster) == &accessor);
+    NL_TEST_ASSERT(inSuite, !emberAfRegisterAttributeAccessor(&accessor));
+
+    // The accessor follows the endpoint id, whatever slot it takes.
+    NL_TEST_ASSERT(inSuite, AddLight(0, kSecondEndpoint) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, AddLight(1, kFirstEndpoint) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kSecondEndpoint, kOnOffCluster) == nullptr);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFirstEndpoint, kOnOffCluster) == &accessor);
+    NL_TEST_ASSERT(inSuite, ReadOnOff(kSecondEndpoint, value) == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, value == 1);
+
+    // Unregistering works whether the endpoint is defined or not.
+    emberAfUnregisterAttributeAccessor(&accessor);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFirstEndpoint, kOnOffCluster) == nullptr);
+    NL_TEST_ASSERT(inSuite, emberAfRegisterAttributeAccessor(&accessor));
+    ClearAll();
+    emberAfUnregisterAttributeAccessor(&accessor);
+    NL_TEST_ASSERT(inSuite, emberAfFindAttributeAccessor(kFirstEndpoint, kOnOffCluster) == nullptr);
+}
+
+void TestReadServerAttributes(nlTestSuite * inSuite, void * inContext)
+{
+    TestAccessor accessor(kFixedEndpoint, kOnOffCluster, 0x42);
+    uint8_t buffers[3][2] = { { 0 } };
+    EmberAfAttributeReadRecord records[3];
+    const AttributeId ids[3] = { kOnOffAttribute, kUnknown, kRevision };
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        records[i].attributeId = ids[i];
+        records[i].buffer      = buffers[i];
+        records[i].bufferSize  = sizeof(buffers[i]);
+    }
+
+    // Without an accessor, the attributes are read from the attribute storage.
+    emberAfReadServerAttributes(kFixedEndpoint, kOnOffCluster, records, 3);
+    NL_TEST_ASSERT(inSuite, records[0].status == EMBER_ZCL_STATUS_SUCCESS && records[0].metadata != nullptr);
+    NL_TEST_ASSERT(inSuite, buffers[0][0] == 0);
+    NL_TEST_ASSERT(inSuite, records[1].status == EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE && records[1].metadata == nullptr);
+    NL_TEST_ASSERT(inSuite, records[2].status == EMBER_ZCL_STATUS_SUCCESS);
+    NL_TEST_ASSERT(inSuite, buffers[2][0] == 2 && buffers[2][1] == 0);
+
+    // With one, they are read with a single call.
+    NL_TEST_ASSERT(inSuite, emberAfRegisterAttributeAccessor(&accessor));
+    emberAfReadServerAttributes(kFixedEndpoint, kOnOffCluster, records, 3);
+    NL_TEST_ASSERT(inSuite, accessor.mReadCalls == 1 && accessor.mReadCount == 3);
+    NL_TEST_ASSERT(inSuite, records[0].status == EMBER_ZCL_STATUS_SUCCESS && buffers[0][0] == 0x42);
+    NL_TEST_ASSERT(inSuite, records[1].status == EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE && records[1].metadata == nullptr);
+    NL_TEST_ASSERT(inSuite, records[2].status == EMBER_ZCL_STATUS_SUCCESS && buffers[2][0] == 0x42);
+
+    // Attributes the application may not read are not passed to the accessor.
+    gDenyReads = true;
+    emberAfReadServerAttributes(kFixedEndpoint, kOnOffCluster, records, 1);
+    gDenyReads = false;
+    NL_TEST_ASSERT(inSuite, accessor.mReadCalls == 2);
+    NL_TEST_ASSERT(inSuite, records[0].status == EMBER_ZCL_STATUS_NOT_AUTHORIZED && records[0].metadata == nullptr);
+
+    // The other clusters are still read from the attribute storage.
+    emberAfReadServerAttributes(kFixedEndpoint, kLevelCluster, records, 1);
+    NL_TEST_ASSERT(inSuite, records[0].status == EMBER_ZCL_STATUS_SUCCESS);
+    emberAfReadServerAttributes(kFirstEndpoint, kOnOffCluster, records, 1);
+    NL_TEST_ASSERT(inSuite, records[0].status == EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE);
+
+    emberAfUnregisterAttributeAccessor(&accessor);
+}
+
+int TestSetup(void * inContext)
+{
+    // As emberAfInit does.
+    emberAfEndpointConfigure();
+    emberAfInitializeAttributes(EMBER_BROADCAST_ENDPOINT);
+    return SUCCESS;
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestSetClearEndpoint", TestSetClearEndpoint),                   //
+    NL_TEST_DEF("TestLookupAfterClear", TestLookupAfterClear),                   //
+    NL_TEST_DEF("TestIndexOutOfRange", TestIndexOutOfRange),                     //
+    NL_TEST_DEF("TestDuplicateEndpointId", TestDuplicateEndpointId),             //
+    NL_TEST_DEF("TestRegisterAccessor", TestRegisterAccessor),                   //
+    NL_TEST_DEF("TestWildcardAccessor", TestWildcardAccessor),                   //
+    NL_TEST_DEF("TestAccessorOfDynamicEndpoint", TestAccessorOfDynamicEndpoint), //
+    NL_TEST_DEF("TestReadServerAttributes", TestReadServerAttributes),           //
+    NL_TEST_SENTINEL()                                                           //
+};
+
+} // namespace
+
+// The callbacks and framework functions the attribute storage calls, which
+// the tests do not otherwise build.
+void emberAfClusterInitCallback(EndpointId endpoint, ClusterId clusterId) {}
+
+bool emberAfAttributeReadAccessCallback(EndpointId endpoint, ClusterId clusterId, uint16_t manufacturerCode, AttributeId attributeId)
+{
+    return !gDenyReads;
+}
+
+bool emberAfAttributeWriteAccessCallback(EndpointId endpoint, ClusterId clusterId, uint16_t manufacturerCode,
+                                         AttributeId attributeId)
+{
+    return true;
+}
+
+EmberAfStatus emberAfExternalAttributeReadCallback(EndpointId endpoint, ClusterId clusterId,
+                                                   EmberAfAttributeMetadata * attributeMetadata, uint16_t manufacturerCode,
+                                                   uint8_t * buffer, uint16_t maxReadLength)
+{
+    return EMBER_ZCL_STATUS_FAILURE;
+}
+
+EmberAfStatus emberAfExternalAttributeWriteCallback(EndpointId endpoint, ClusterId clusterId,
+                                                    EmberAfAttributeMetadata * attributeMetadata, uint16_t manufacturerCode,
+                                                    uint8_t * buffer)
+{
+    return EMBER_ZCL_STATUS_FAILURE;
+}
+
+void emberAfSetDeviceEnabled(EndpointId endpoint, bool enabled) {}
+
+EmberStatus emberAfDeactivateClusterTick(EndpointId endpoint, ClusterId clusterId, bool isClient)
+{
+    return EMBER_SUCCESS;
+}
+
+// The tests have no string attributes.
+void emberAfCopyString(uint8_t * dest, const uint8_t * src, uint8_t size) {}
+void emberAfCopyLongString(uint8_t * dest, const uint8_t * src, uint16_t size) {}
+
+int TestAttributeStorage()
+{
+    nlTestSuite theSuite = { "AttributeStorage", &sTests[0], TestSetup, nullptr };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestAttributeStorage)
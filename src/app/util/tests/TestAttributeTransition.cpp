@@ -0,0 +1,323 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the shared attribute transition
+ *      scheduler.
+ *
+ */
+
+#include <string.h>
+
+#include <app/util/af-transition.h>
+
+#include <app/util/af.h>
+#include <gen/attribute-type.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+using namespace chip;
+
+namespace {
+
+constexpr ClusterId kLevelCluster = 0x0008;
+constexpr ClusterId kColorCluster = 0x0300;
+constexpr uint32_t kStartMs       = 1000;
+
+struct WrittenValue
+{
+    EndpointId endpoint;
+    ClusterId clusterId;
+    AttributeId attributeId;
+    uint16_t value;
+};
+
+struct Callback
+{
+    EndpointId endpoint;
+    ClusterId clusterId;
+    uint32_t remainingMs;
+};
+
+WrittenValue gWrites[16];
+size_t gWriteCount = 0;
+Callback gCallbacks[16];
+size_t gCallbackCount = 0;
+bool gFailWrites      = false;
+
+void Reset()
+{
+    gWriteCount    = 0;
+    gCallbackCount = 0;
+    gFailWrites    = false;
+}
+
+void RecordCallback(EndpointId endpoint, ClusterId clusterId, uint32_t remainingMs)
+{
+    if (gCallbackCount < ArraySize(gCallbacks))
+    {
+        gCallbacks[gCallbackCount++] = { endpoint, clusterId, remainingMs };
+    }
+}
+
+const WrittenValue * LastWrite(EndpointId endpoint, ClusterId clusterId, AttributeId attributeId)
+{
+    for (size_t i = gWriteCount; i > 0; i--)
+    {
+        const WrittenValue & write = gWrites[i - 1];
+        if (write.endpoint == endpoint && write.clusterId == clusterId && write.attributeId == attributeId)
+        {
+            return &write;
+        }
+    }
+    return nullptr;
+}
+
+EmberAfTransition MakeTransition(EmberAfAttributeType type, uint16_t startValue, int32_t delta, uint32_t durationMs,
+                                 uint16_t modulo = 0, bool repeat = false)
+{
+    EmberAfTransition transition = {};
+
+    transition.endpoint      = 1;
+    transition.clusterId     = kLevelCluster;
+    transition.attributeId   = 0;
+    transition.attributeType = type;
+    transition.startValue    = startValue;
+    transition.delta         = delta;
+    transition.durationMs    = durationMs;
+    transition.modulo        = modulo;
+    transition.repeat        = repeat;
+    transition.callback      = RecordCallback;
+    return transition;
+}
+
+void TestInterpolation(nlTestSuite * inSuite, void * inContext)
+{
+    EmberAfTransition up   = MakeTransition(ZCL_INT16U_ATTRIBUTE_TYPE, 1000, 3, 300);
+    EmberAfTransition down = MakeTransition(ZCL_INT16U_ATTRIBUTE_TYPE, 1000, -3, 300);
+
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&up, 0) == 1000);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&down, 0) == 1000);
+
+    // halfway between two values rounds away from the start, the same in both directions
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&up, 50) == 1001);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&down, 50) == 999);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&up, 49) == 1000);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&down, 49) == 1000);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&up, 200) == 1002);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&down, 200) == 998);
+
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&up, 300) == 1003);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&down, 300) == 997);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&up, 5000) == 1003);
+
+    // values without a modulo are clamped to the attribute type
+    EmberAfTransition level = MakeTransition(ZCL_INT8U_ATTRIBUTE_TYPE, 250, 10, 1000);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&level, 1000) == UINT8_MAX);
+    level = MakeTransition(ZCL_INT8U_ATTRIBUTE_TYPE, 5, -10, 1000);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&level, 1000) == 0);
+
+    // long transitions do not overflow
+    EmberAfTransition wide = MakeTransition(ZCL_INT16U_ATTRIBUTE_TYPE, 0, UINT16_MAX, UINT32_MAX - 1);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&wide, UINT32_MAX / 2) == UINT16_MAX / 2 + 1);
+}
+
+void TestHueWrap(nlTestSuite * inSuite, void * inContext)
+{
+    EmberAfTransition up   = MakeTransition(ZCL_INT8U_ATTRIBUTE_TYPE, 250, 10, 1000, 255);
+    EmberAfTransition down = MakeTransition(ZCL_INT8U_ATTRIBUTE_TYPE, 3, -10, 1000, 255);
+
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&up, 400) == 254);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&up, 500) == 0);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&up, 1000) == 5);
+
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&down, 300) == 0);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&down, 400) == 254);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&down, 1000) == 248);
+
+    // a full turn, or more, ends on the start value modulo
+    EmberAfTransition turn = MakeTransition(ZCL_INT16U_ATTRIBUTE_TYPE, 100, 2 * 360 + 10, 1000, 360);
+    NL_TEST_ASSERT(inSuite, emAfTransitionValueAt(&turn, 1000) == 110);
+}
+
+void TestRepeat(nlTestSuite * inSuite, void * inContext)
+{
+    EmberAfTransition hue = MakeTransition(ZCL_INT16U_ATTRIBUTE_TYPE, 0, 100, 1000, 360, true);
+    hue.clusterId         = kColorCluster;
+
+    Reset();
+    NL_TEST_ASSERT(inSuite, emAfStartTransitionAt(&hue, kStartMs) == EMBER_SUCCESS);
+
+    // periods completed between ticks are all accounted for
+    emAfTransitionTick(kStartMs + 2500);
+    NL_TEST_ASSERT(inSuite, LastWrite(1, kColorCluster, 0) != nullptr);
+    NL_TEST_ASSERT(inSuite, LastWrite(1, kColorCluster, 0)->value == 250);
+    NL_TEST_ASSERT(inSuite, gCallbackCount == 1);
+    NL_TEST_ASSERT(inSuite, gCallbacks[0].remainingMs == EMBER_AF_TRANSITION_FOREVER);
+
+    emAfTransitionTick(kStartMs + 10000);
+    NL_TEST_ASSERT(inSuite, LastWrite(1, kColorCluster, 0)->value == 1000 % 360);
+    NL_TEST_ASSERT(inSuite, emberAfTransitionIsActive(1, kColorCluster));
+
+    // a repeating transition only ends when stopped
+    emberAfStopTransitions(1, kColorCluster);
+    NL_TEST_ASSERT(inSuite, !emberAfTransitionIsActive(1, kColorCluster));
+    Reset();
+    emAfTransitionTick(kStartMs + 10100);
+    NL_TEST_ASSERT(inSuite, gWriteCount == 0);
+    NL_TEST_ASSERT(inSuite, gCallbackCount == 0);
+}
+
+void TestZeroDuration(nlTestSuite * inSuite, void * inContext)
+{
+    EmberAfTransition level = MakeTransition(ZCL_INT16U_ATTRIBUTE_TYPE, 100, 900, 0);
+    level.attributeId       = 7;
+
+    Reset();
+    NL_TEST_ASSERT(inSuite, emAfStartTransitionAt(&level, kStartMs) == EMBER_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfTransitionIsActive(1, kLevelCluster));
+
+    // the final value is applied on the next tick, whenever it runs
+    emAfTransitionTick(kStartMs);
+    NL_TEST_ASSERT(inSuite, gWriteCount == 1);
+    NL_TEST_ASSERT(inSuite, LastWrite(1, kLevelCluster, 7)->value == 1000);
+    NL_TEST_ASSERT(inSuite, gCallbackCount == 1);
+    NL_TEST_ASSERT(inSuite, gCallbacks[0].remainingMs == 0);
+    NL_TEST_ASSERT(inSuite, !emberAfTransitionIsActive(1, kLevelCluster));
+
+    // the cluster ticks and events do not wait for the scheduler timer
+    Reset();
+    NL_TEST_ASSERT(inSuite, emberAfStartTransition(&level) == EMBER_SUCCESS);
+    emberAfAdvanceTransitions();
+    NL_TEST_ASSERT(inSuite, LastWrite(1, kLevelCluster, 7) != nullptr);
+    NL_TEST_ASSERT(inSuite, LastWrite(1, kLevelCluster, 7)->value == 1000);
+    NL_TEST_ASSERT(inSuite, !emberAfTransitionIsActive(1, kLevelCluster));
+
+    // a failed write stops the transition and still calls back
+    Reset();
+    gFailWrites = true;
+    NL_TEST_ASSERT(inSuite, emAfStartTransitionAt(&level, kStartMs) == EMBER_SUCCESS);
+    emAfTransitionTick(kStartMs);
+    NL_TEST_ASSERT(inSuite, gCallbackCount == 1);
+    NL_TEST_ASSERT(inSuite, gCallbacks[0].remainingMs == 0);
+    NL_TEST_ASSERT(inSuite, !emberAfTransitionIsActive(1, kLevelCluster));
+    gFailWrites = false;
+}
+
+void TestStartStopReplace(nlTestSuite * inSuite, void * inContext)
+{
+    EmberAfTransition x = MakeTransition(ZCL_INT16U_ATTRIBUTE_TYPE, 0, 1000, 1000);
+    EmberAfTransition y = MakeTransition(ZCL_INT16U_ATTRIBUTE_TYPE, 0, 2000, 2000);
+    x.clusterId         = kColorCluster;
+    y.clusterId         = kColorCluster;
+    y.attributeId       = 1;
+
+    Reset();
+    NL_TEST_ASSERT(inSuite, emAfStartTransitionAt(&x, kStartMs) == EMBER_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emAfStartTransitionAt(&y, kStartMs) == EMBER_SUCCESS);
+    NL_TEST_ASSERT(inSuite, emberAfTransitionIsActive(1, kColorCluster));
+    NL_TEST_ASSERT(inSuite, !emberAfTransitionIsActive(2, kColorCluster));
+
+    // both attributes are written, then the cluster is called back once with the longest remaining time
+    emAfTransitionTick(kStartMs + 500);
+    NL_TEST_ASSERT(inSuite, gWriteCount == 2);
+    NL_TEST_ASSERT(inSuite, LastWrite(1, kColorCluster, 0)->value == 500);
+    NL_TEST_ASSERT(inSuite, LastWrite(1, kColorCluster, 1)->value == 500);
+    NL_TEST_ASSERT(inSuite, gCallbackCount == 1);
+    NL_TEST_ASSERT(inSuite, gCallbacks[0].remainingMs == 1500);
+
+    // starting a transition of an attribute replaces the running one
+    x.startValue = 500;
+    x.delta      = -500;
+    NL_TEST_ASSERT(inSuite, emAfStartTransitionAt(&x, kStartMs + 500) == EMBER_SUCCESS);
+    Reset();
+    emAfTransitionTick(kStartMs + 1500);
+    NL_TEST_ASSERT(inSuite, LastWrite(1, kColorCluster, 0)->value == 0);
+    NL_TEST_ASSERT(inSuite, LastWrite(1, kColorCluster, 1)->value == 1500);
+    NL_TEST_ASSERT(inSuite, gCallbacks[0].remainingMs == 500);
+
+    // stopped transitions keep their last value and are not called back
+    emberAfStopTransitions(1, kColorCluster);
+    NL_TEST_ASSERT(inSuite, !emberAfTransitionIsActive(1, kColorCluster));
+    Reset();
+    emAfTransitionTick(kStartMs + 2000);
+    NL_TEST_ASSERT(inSuite, gWriteCount == 0);
+    NL_TEST_ASSERT(inSuite, gCallbackCount == 0);
+
+    // the table holds one transition per attribute
+    for (uint16_t i = 0; i < EMBER_AF_TRANSITION_TABLE_SIZE; i++)
+    {
+        x.attributeId = i;
+        NL_TEST_ASSERT(inSuite, emAfStartTransitionAt(&x, kStartMs) == EMBER_SUCCESS);
+    }
+    x.attributeId = EMBER_AF_TRANSITION_TABLE_SIZE;
+    NL_TEST_ASSERT(inSuite, emAfStartTransitionAt(&x, kStartMs) == EMBER_TABLE_FULL);
+    x.attributeId = 0;
+    NL_TEST_ASSERT(inSuite, emAfStartTransitionAt(&x, kStartMs) == EMBER_SUCCESS);
+    emberAfStopTransitions(1, kColorCluster);
+    x.attributeId = EMBER_AF_TRANSITION_TABLE_SIZE;
+    NL_TEST_ASSERT(inSuite, emAfStartTransitionAt(&x, kStartMs) == EMBER_SUCCESS);
+    emberAfStopTransitions(1, kColorCluster);
+
+    // only unsigned 8 and 16 bit attributes can transition
+    x.attributeType = ZCL_INT32U_ATTRIBUTE_TYPE;
+    NL_TEST_ASSERT(inSuite, emAfStartTransitionAt(&x, kStartMs) == EMBER_BAD_ARGUMENT);
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestInterpolation", TestInterpolation),       //
+    NL_TEST_DEF("TestHueWrap", TestHueWrap),                   //
+    NL_TEST_DEF("TestRepeat", TestRepeat),                     //
+    NL_TEST_DEF("TestZeroDuration", TestZeroDuration),         //
+    NL_TEST_DEF("TestStartStopReplace", TestStartStopReplace), //
+    NL_TEST_SENTINEL()                                         //
+};
+
+} // namespace
+
+/// Records the values written by the scheduler instead of storing them.
+EmberAfStatus emberAfWriteServerAttribute(EndpointId endpoint, ClusterId cluster, AttributeId attributeID, uint8_t * dataPtr,
+                                          EmberAfAttributeType dataType)
+{
+    uint16_t value = dataPtr[0];
+
+    if (gFailWrites)
+    {
+        return EMBER_ZCL_STATUS_FAILURE;
+    }
+    if (dataType == ZCL_INT16U_ATTRIBUTE_TYPE)
+    {
+        memcpy(&value, dataPtr, sizeof(value));
+    }
+    if (gWriteCount < ArraySize(gWrites))
+    {
+        gWrites[gWriteCount++] = { endpoint, cluster, attributeID, value };
+    }
+    return EMBER_ZCL_STATUS_SUCCESS;
+}
+
+int TestAttributeTransition()
+{
+    nlTestSuite theSuite = { "AttributeTransition", &sTests[0], nullptr, nullptr };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestAttributeTransition)
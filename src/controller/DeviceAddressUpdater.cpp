@@ -24,30 +24,386 @@
 namespace chip {
 namespace Controller {
 
-CHIP_ERROR DeviceAddressUpdater::Init(DeviceController * controller, DeviceAddressUpdateDelegate * delegate)
+namespace {
+
+constexpr uint32_t kRefreshTimerIntervalMs = 1000;
+
+} // namespace
+
+CHIP_ERROR DeviceAddressUpdater::Init(DeviceController * controller, DeviceAddressUpdateDelegate * delegate,
+                                      Mdns::Resolver * resolver)
 {
     VerifyOrReturnError(mController == nullptr, CHIP_ERROR_INCORRECT_STATE);
     VerifyOrReturnError(mDelegate == nullptr, CHIP_ERROR_INCORRECT_STATE);
 
     mController = controller;
     mDelegate   = delegate;
+    mResolver   = (resolver != nullptr) ? resolver : &Mdns::Resolver::Instance();
 
     return CHIP_NO_ERROR;
 }
 
-void DeviceAddressUpdater::OnNodeIdResolved(NodeId nodeId, const Mdns::ResolvedNodeData & nodeData)
+CHIP_ERROR DeviceAddressUpdater::RefreshAddresses(System::Layer * systemLayer, const NodeId * nodeIds, size_t nodeCount,
+                                                  uint64_t fabricId, size_t maxInFlight)
+{
+    VerifyOrReturnError(mController != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(!mRefreshActive, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(nodeIds != nullptr || nodeCount == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(maxInFlight > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mSystemLayer     = systemLayer;
+    mRefreshNodes    = nodeIds;
+    mRefreshCount    = nodeCount;
+    mRefreshNext     = 0;
+    mRefreshFabricId = fabricId;
+    mMaxInFlight     = (maxInFlight < kMaxRefreshInFlight) ? maxInFlight : kMaxRefreshInFlight;
+    mUpdatedCount    = 0;
+    mFailedCount     = 0;
+    mPendingCount    = 0;
+    mLatencyCount    = 0;
+    mMaxLatencyMs    = 0;
+
+    for (size_t i = 0; i < kMaxRefreshInFlight; i++)
+    {
+        mInFlight[i].active = false;
+    }
+    for (size_t i = 0; i < kLatencyBucketCount; i++)
+    {
+        mLatencyBuckets[i] = 0;
+    }
+
+    if (mSystemLayer != nullptr)
+    {
+        ReturnErrorOnFailure(mSystemLayer->StartTimer(kRefreshTimerIntervalMs, HandleRefreshTimer, this));
+    }
+
+    mRefreshActive = true;
+    StartResolves();
+
+    return CHIP_NO_ERROR;
+}
+
+void DeviceAddressUpdater::CancelRefresh()
+{
+    VerifyOrReturn(mRefreshActive);
+
+    for (size_t i = 0; i < kMaxRefreshInFlight; i++)
+    {
+        mInFlight[i].active = false;
+    }
+    mRefreshNext = mRefreshCount;
+
+    FinishRefresh();
+}
+
+void DeviceAddressUpdater::StopRefresh()
+{
+    VerifyOrReturn(mRefreshActive);
+
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(HandleRefreshTimer, this);
+        mSystemLayer = nullptr;
+    }
+    for (size_t i = 0; i < kMaxRefreshInFlight; i++)
+    {
+        mInFlight[i].active = false;
+    }
+    mPendingCount  = 0;
+    mRefreshActive = false;
+    mRefreshNodes  = nullptr;
+}
+
+CHIP_ERROR DeviceAddressUpdater::UpdateDeviceAddress(NodeId nodeId, const Inet::IPAddress & address, uint16_t port,
+                                                     Inet::InterfaceId interfaceId)
+{
+    Device * device = nullptr;
+
+    VerifyOrReturnError(address.Type() != Inet::kIPAddressType_Any, CHIP_ERROR_INVALID_ADDRESS);
+    VerifyOrReturnError(mController != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    ReturnErrorOnFailure(mController->GetDevice(nodeId, &device));
+
+    return device->UpdateAddress(Transport::PeerAddress::UDP(address, port, interfaceId));
+}
+
+bool DeviceAddressUpdater::CompleteInFlight(NodeId nodeId, const PendingUpdate & update)
+{
+    const uint64_t nowMs = System::Layer::GetClock_MonotonicMS();
+    bool found           = false;
+
+    // A node listed more than once may have several resolutions outstanding, which the resolver
+    // answers only once. Completing a batch calls the delegate, which may cancel the refresh.
+    for (size_t i = 0; (i < kMaxRefreshInFlight) && mRefreshActive; i++)
+    {
+        InFlightResolve & resolve = mInFlight[i];
+
+        if (resolve.active && (resolve.nodeId == nodeId))
+        {
+            RecordLatency(nowMs - resolve.startMs);
+            CompleteResolve(resolve, update);
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+bool DeviceAddressUpdater::ReportedByRefresh(NodeId nodeId) const
+{
+    // Nodes before mRefreshNext that are not in flight anymore were already reported
+    for (size_t i = 0; i < mRefreshNext; i++)
+    {
+        if (mRefreshNodes[i] == nodeId)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t DeviceAddressUpdater::InFlightCount() const
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < kMaxRefreshInFlight; i++)
+    {
+        if (mInFlight[i].active)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+void DeviceAddressUpdater::RecordLatency(uint64_t latencyMs)
+{
+    // Bucket b holds latencies of b significant bits, i.e. [2^(b-1), 2^b - 1] ms
+    size_t bucket = 0;
+
+    while ((bucket < kLatencyBucketCount - 1) && ((latencyMs >> bucket) != 0))
+    {
+        bucket++;
+    }
+
+    mLatencyBuckets[bucket]++;
+    mLatencyCount++;
+    mMaxLatencyMs = (latencyMs > mMaxLatencyMs) ? latencyMs : mMaxLatencyMs;
+}
+
+uint32_t DeviceAddressUpdater::LatencyPercentile(size_t percent) const
+{
+    const uint32_t maxMs = static_cast<uint32_t>((mMaxLatencyMs < UINT32_MAX) ? mMaxLatencyMs : UINT32_MAX);
+    const size_t rank    = (mLatencyCount * percent + 99) / 100;
+    size_t seen          = 0;
+
+    if (mLatencyCount == 0)
+    {
+        return 0;
+    }
+
+    for (size_t bucket = 0; bucket < kLatencyBucketCount - 1; bucket++)
+    {
+        seen += mLatencyBuckets[bucket];
+        if (seen >= rank)
+        {
+            const uint32_t upperBound = (1u << bucket) - 1;
+            return (upperBound < maxMs) ? upperBound : maxMs;
+        }
+    }
+
+    return maxMs;
+}
+
+void DeviceAddressUpdater::CompleteResolve(InFlightResolve & resolve, const PendingUpdate & update)
+{
+    resolve.active                   = false;
+    mPendingUpdates[mPendingCount++] = update;
+
+    if (mPendingCount == kRefreshBatchSize)
+    {
+        ApplyPendingUpdates();
+    }
+}
+
+void DeviceAddressUpdater::StartResolves()
+{
+    // Resolvers may answer from their cache before ResolveNodeId returns, which lands here again
+    if (mStartingResolves)
+    {
+        mRestartResolves = true;
+        return;
+    }
+
+    mStartingResolves = true;
+    do
+    {
+        mRestartResolves = false;
+
+        while (mRefreshActive && (mRefreshNext < mRefreshCount) && (InFlightCount() < mMaxInFlight))
+        {
+            InFlightResolve * resolve = nullptr;
+
+            for (size_t i = 0; (i < kMaxRefreshInFlight) && (resolve == nullptr); i++)
+            {
+                resolve = mInFlight[i].active ? nullptr : &mInFlight[i];
+            }
+
+            const NodeId nodeId = mRefreshNodes[mRefreshNext++];
+            resolve->nodeId     = nodeId;
+            resolve->startMs    = System::Layer::GetClock_MonotonicMS();
+            resolve->active     = true;
+
+            CHIP_ERROR error = mResolver->ResolveNodeId(nodeId, mRefreshFabricId, Inet::kIPAddressType_Any);
+
+            // The resolver has no room left: retry once some of our resolutions completed or on the next timer
+            if ((error == CHIP_ERROR_NO_MEMORY) && resolve->active && ((mSystemLayer != nullptr) || (InFlightCount() > 1)))
+            {
+                resolve->active = false;
+                mRefreshNext--;
+                break;
+            }
+
+            if ((error != CHIP_NO_ERROR) && resolve->active)
+            {
+                PendingUpdate update = { nodeId, Inet::IPAddress::Any, 0, INET_NULL_INTERFACEID, error };
+                CompleteResolve(*resolve, update);
+            }
+        }
+    } while (mRestartResolves);
+    mStartingResolves = false;
+
+    FinishRefreshIfDone();
+}
+
+void DeviceAddressUpdater::ApplyPendingUpdates()
 {
-    CHIP_ERROR error = CHIP_NO_ERROR;
-    Device * device  = nullptr;
+    // Delegate callbacks may complete more resolutions, so work on a copy of the batch
+    PendingUpdate updates[kRefreshBatchSize];
+    const size_t count = mPendingCount;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        updates[i] = mPendingUpdates[i];
+    }
+    mPendingCount = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CHIP_ERROR error = updates[i].error;
 
-    VerifyOrExit(nodeData.mAddress.Type() != Inet::kIPAddressType_Any, error = CHIP_ERROR_INVALID_ADDRESS);
-    VerifyOrExit(mController != nullptr, error = CHIP_ERROR_INCORRECT_STATE);
-    SuccessOrExit(error = mController->GetDevice(nodeId, &device));
+        if (error == CHIP_NO_ERROR)
+        {
+            error = UpdateDeviceAddress(updates[i].nodeId, updates[i].address, updates[i].port, updates[i].interfaceId);
+        }
 
-    device->UpdateAddress(Transport::PeerAddress::UDP(nodeData.mAddress, nodeData.mPort, nodeData.mInterfaceId));
+        if (error == CHIP_NO_ERROR)
+        {
+            mUpdatedCount++;
+        }
+        else
+        {
+            mFailedCount++;
+        }
+
+        if (mDelegate != nullptr)
+        {
+            mDelegate->OnAddressUpdateComplete(updates[i].nodeId, error);
+        }
+    }
+
+    if ((count > 0) && (mDelegate != nullptr))
+    {
+        AddressRefreshProgress progress;
+        FillProgress(progress);
+        mDelegate->OnAddressRefreshProgress(progress);
+    }
+}
+
+void DeviceAddressUpdater::FillProgress(AddressRefreshProgress & progress) const
+{
+    progress.total    = mRefreshCount;
+    progress.updated  = mUpdatedCount;
+    progress.failed   = mFailedCount;
+    progress.inFlight = InFlightCount();
+    progress.p50Ms    = LatencyPercentile(50);
+    progress.p90Ms    = LatencyPercentile(90);
+    progress.p99Ms    = LatencyPercentile(99);
+    progress.maxMs    = static_cast<uint32_t>((mMaxLatencyMs < UINT32_MAX) ? mMaxLatencyMs : UINT32_MAX);
+}
+
+void DeviceAddressUpdater::FinishRefreshIfDone()
+{
+    if (mRefreshActive && !mStartingResolves && (mRefreshNext == mRefreshCount) && (InFlightCount() == 0))
+    {
+        FinishRefresh();
+    }
+}
+
+void DeviceAddressUpdater::FinishRefresh()
+{
+    AddressRefreshProgress progress;
+
+    ApplyPendingUpdates();
+
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(HandleRefreshTimer, this);
+        mSystemLayer = nullptr;
+    }
+    mRefreshActive = false;
+    mRefreshNodes  = nullptr;
 
-exit:
     if (mDelegate != nullptr)
+    {
+        FillProgress(progress);
+        mDelegate->OnAddressRefreshComplete(progress);
+    }
+}
+
+void DeviceAddressUpdater::HandleRefreshTimer(System::Layer * systemLayer, void * appState, System::Error error)
+{
+    DeviceAddressUpdater * updater = static_cast<DeviceAddressUpdater *>(appState);
+    const uint64_t nowMs           = System::Layer::GetClock_MonotonicMS();
+
+    VerifyOrReturn(updater->mRefreshActive);
+
+    for (size_t i = 0; i < kMaxRefreshInFlight; i++)
+    {
+        InFlightResolve & resolve = updater->mInFlight[i];
+
+        if (resolve.active && (resolve.startMs + kResolveTimeoutMs <= nowMs))
+        {
+            PendingUpdate update = { resolve.nodeId, Inet::IPAddress::Any, 0, INET_NULL_INTERFACEID, CHIP_ERROR_TIMEOUT };
+            updater->CompleteResolve(resolve, update);
+        }
+    }
+
+    // Report slow progress too, not only full batches
+    updater->ApplyPendingUpdates();
+    updater->StartResolves();
+
+    if (updater->mRefreshActive)
+    {
+        systemLayer->StartTimer(kRefreshTimerIntervalMs, HandleRefreshTimer, updater);
+    }
+}
+
+void DeviceAddressUpdater::OnNodeIdResolved(NodeId nodeId, const Mdns::ResolvedNodeData & nodeData)
+{
+    PendingUpdate update = { nodeId, nodeData.mAddress, nodeData.mPort, nodeData.mInterfaceId, CHIP_NO_ERROR };
+
+    if (mRefreshActive && CompleteInFlight(nodeId, update))
+    {
+        StartResolves();
+        return;
+    }
+
+    CHIP_ERROR error = UpdateDeviceAddress(nodeId, nodeData.mAddress, nodeData.mPort, nodeData.mInterfaceId);
+
+    // A late answer for a node the refresh already reported (e.g. as timed out) only updates the device
+    if ((mDelegate != nullptr) && !(mRefreshActive && ReportedByRefresh(nodeId)))
     {
         mDelegate->OnAddressUpdateComplete(nodeId, error);
     }
@@ -55,7 +411,15 @@ exit:
 
 void DeviceAddressUpdater::OnNodeIdResolutionFailed(NodeId nodeId, CHIP_ERROR error)
 {
-    if (mDelegate != nullptr)
+    PendingUpdate update = { nodeId, Inet::IPAddress::Any, 0, INET_NULL_INTERFACEID, error };
+
+    if (mRefreshActive && CompleteInFlight(nodeId, update))
+    {
+        StartResolves();
+        return;
+    }
+
+    if ((mDelegate != nullptr) && !(mRefreshActive && ReportedByRefresh(nodeId)))
     {
         mDelegate->OnAddressUpdateComplete(nodeId, error);
     }
@@ -20,6 +20,7 @@
 
 #include <mdns/Resolver.h>
 #include <support/DLLUtil.h>
+#include <system/SystemLayer.h>
 #include <transport/raw/MessageHeader.h>
 
 namespace chip {
@@ -27,27 +28,144 @@ namespace Controller {
 
 class DeviceController;
 
+/// State of a bulk address refresh, see DeviceAddressUpdater::RefreshAddresses
+struct AddressRefreshProgress
+{
+    size_t total;    // number of nodes to refresh
+    size_t updated;  // nodes whose address was resolved and applied
+    size_t failed;   // nodes that failed to resolve or to update
+    size_t inFlight; // resolutions currently outstanding
+
+    // Resolution latency percentiles, reported as the upper bound of a power of two bucket
+    uint32_t p50Ms;
+    uint32_t p90Ms;
+    uint32_t p99Ms;
+    uint32_t maxMs; // exact worst latency
+};
+
 /// Callbacks for CHIP device address resolution
 class DLL_EXPORT DeviceAddressUpdateDelegate
 {
 public:
     virtual ~DeviceAddressUpdateDelegate() {}
     virtual void OnAddressUpdateComplete(NodeId nodeId, CHIP_ERROR error) = 0;
+
+    /// Called after each batch of bulk refresh results was applied
+    virtual void OnAddressRefreshProgress(const AddressRefreshProgress & progress) {}
+
+    /// Called once when a bulk refresh finished or was cancelled
+    virtual void OnAddressRefreshComplete(const AddressRefreshProgress & progress) {}
 };
 
 /// Class for updating CHIP devices' addresses based on responses from mDNS Resolver
 class DLL_EXPORT DeviceAddressUpdater : public Mdns::ResolverDelegate
 {
 public:
-    CHIP_ERROR Init(DeviceController * controller, DeviceAddressUpdateDelegate * delegate = nullptr);
+    static constexpr size_t kMaxRefreshInFlight = 16;
+    static constexpr size_t kRefreshBatchSize   = 8;
+    static constexpr uint32_t kResolveTimeoutMs = 10 * 1000;
+
+    /// A refresh still running is dropped without calling the delegate.
+    ~DeviceAddressUpdater() { StopRefresh(); }
+
+    /// Bulk refreshes go through [resolver], or Mdns::Resolver::Instance() if it is null.
+    CHIP_ERROR Init(DeviceController * controller, DeviceAddressUpdateDelegate * delegate = nullptr,
+                    Mdns::Resolver * resolver = nullptr);
+
+    /**
+     * @brief
+     *   Re-resolves the addresses of many nodes, keeping up to maxInFlight resolutions outstanding.
+     *
+     *   The updater must be the delegate of the resolver given to Init. Resolved addresses are applied
+     *   to the controller devices in batches of kRefreshBatchSize, after which the delegate gets
+     *   OnAddressUpdateComplete for every node of the batch and one OnAddressRefreshProgress.
+     *
+     *   When systemLayer is given, resolutions that got no answer within kResolveTimeoutMs fail with
+     *   CHIP_ERROR_TIMEOUT and nodes the resolver had no room for are retried later. Without it, such
+     *   nodes fail with CHIP_ERROR_NO_MEMORY once nothing of this refresh is outstanding anymore.
+     *
+     *   A node listed more than once is reported once per entry; an answer completes all of its
+     *   outstanding entries. Answers arriving for a node after its entries were reported (e.g. after a
+     *   timeout) still update the device, but do not call OnAddressUpdateComplete again while the
+     *   refresh is running.
+     *
+     * @param[in] systemLayer  Layer used for timeouts and retries, may be null
+     * @param[in] nodeIds      Nodes to refresh, must stay valid until the refresh completes
+     * @param[in] nodeCount    Number of entries in nodeIds
+     * @param[in] fabricId     Fabric of all nodes
+     * @param[in] maxInFlight  Limit of outstanding resolutions, at most kMaxRefreshInFlight
+     */
+    CHIP_ERROR RefreshAddresses(System::Layer * systemLayer, const NodeId * nodeIds, size_t nodeCount, uint64_t fabricId,
+                                size_t maxInFlight = kMaxRefreshInFlight);
+
+    /// Stops a bulk refresh. Already resolved results are applied, late answers update devices one by one.
+    void CancelRefresh();
+
+    bool IsRefreshing() const { return mRefreshActive; }
 
 private:
+    static constexpr size_t kLatencyBucketCount = 18; // up to 2^16 ms, last bucket is open-ended
+
+    struct InFlightResolve
+    {
+        NodeId nodeId;
+        uint64_t startMs;
+        bool active;
+    };
+
+    struct PendingUpdate
+    {
+        NodeId nodeId;
+        Inet::IPAddress address;
+        uint16_t port;
+        Inet::InterfaceId interfaceId;
+        CHIP_ERROR error;
+    };
+
     // Mdns::ResolverDelegate Implementation
     void OnNodeIdResolved(NodeId nodeId, const Mdns::ResolvedNodeData & nodeData) override;
     void OnNodeIdResolutionFailed(NodeId nodeId, CHIP_ERROR error) override;
 
+    CHIP_ERROR UpdateDeviceAddress(NodeId nodeId, const Inet::IPAddress & address, uint16_t port, Inet::InterfaceId interfaceId);
+
+    bool CompleteInFlight(NodeId nodeId, const PendingUpdate & update);
+    bool ReportedByRefresh(NodeId nodeId) const;
+    size_t InFlightCount() const;
+    void CompleteResolve(InFlightResolve & resolve, const PendingUpdate & update);
+    void RecordLatency(uint64_t latencyMs);
+    uint32_t LatencyPercentile(size_t percent) const;
+    void StartResolves();
+    void ApplyPendingUpdates();
+    void FillProgress(AddressRefreshProgress & progress) const;
+    void FinishRefreshIfDone();
+    void FinishRefresh();
+    void StopRefresh();
+    static void HandleRefreshTimer(System::Layer * systemLayer, void * appState, System::Error error);
+
     DeviceController * mController          = nullptr;
     DeviceAddressUpdateDelegate * mDelegate = nullptr;
+    Mdns::Resolver * mResolver              = nullptr;
+
+    // Bulk refresh state
+    System::Layer * mSystemLayer = nullptr;
+    const NodeId * mRefreshNodes = nullptr;
+    size_t mRefreshCount         = 0;
+    size_t mRefreshNext          = 0; // index of the next node to resolve
+    uint64_t mRefreshFabricId    = 0;
+    size_t mMaxInFlight          = 0;
+    size_t mUpdatedCount         = 0;
+    size_t mFailedCount          = 0;
+    bool mRefreshActive          = false;
+    bool mStartingResolves       = false; // resolvers may answer synchronously from their cache
+    bool mRestartResolves        = false;
+
+    InFlightResolve mInFlight[kMaxRefreshInFlight];
+    PendingUpdate mPendingUpdates[kRefreshBatchSize];
+    size_t mPendingCount = 0;
+
+    uint32_t mLatencyBuckets[kLatencyBucketCount];
+    size_t mLatencyCount   = 0;
+    uint64_t mMaxLatencyMs = 0;
 };
 
 } // namespace Controller
@@ -49,6 +49,7 @@
 #include <controller/CHIPDeviceController.h>
 #include <controller/DeviceAddressUpdater.h>
 #include <mdns/Resolver.h>
+#include <platform/CHIPDeviceLayer.h>
 #include <support/CHIPMem.h>
 #include <support/CodeUtils.h>
 #include <support/DLLUtil.h>
@@ -283,6 +284,7 @@ CHIP_ERROR pychip_DeviceAddressUpdater_New(chip::Controller::DeviceAddressUpdate
 
     VerifyOrReturnError(addressUpdater.get() != nullptr, CHIP_ERROR_NO_MEMORY);
     ReturnErrorOnFailure(addressUpdater->Init(devCtrl, &sDeviceAddressUpdateDelegate));
+    ReturnErrorOnFailure(Mdns::Resolver::Instance().StartResolver(&DeviceLayer::InetLayer, 0 /* any port */));
     ReturnErrorOnFailure(Mdns::Resolver::Instance().SetResolverDelegate(addressUpdater.get()));
 
     *outAddressUpdater = addressUpdater.release();
@@ -0,0 +1,347 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <controller/CHIPDeviceController.h>
+#include <controller/DeviceAddressUpdater.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+namespace {
+
+using namespace chip;
+using namespace chip::Controller;
+
+constexpr CHIP_ERROR kResolveError = CHIP_ERROR_UNKNOWN_RESOURCE_ID;
+
+/// Queues resolutions until Answer() is called, like a resolver waiting for mDNS responses.
+///
+/// Nodes with an id divisible by 5 fail to resolve. Resolving a node that is already queued
+/// is answered only once, as a resolver only tracks one resolution per node.
+class FakeResolver : public Mdns::Resolver
+{
+public:
+    static constexpr size_t kMaxQueued = 16;
+
+    CHIP_ERROR StartResolver(Inet::InetLayer * inetLayer, uint16_t port) override { return CHIP_NO_ERROR; }
+    CHIP_ERROR SetResolverDelegate(Mdns::ResolverDelegate * delegate) override
+    {
+        mDelegate = delegate;
+        return CHIP_NO_ERROR;
+    }
+    CHIP_ERROR StartCommissionableBrowse(Mdns::BrowseDelegate * delegate) override { return CHIP_NO_ERROR; }
+    CHIP_ERROR StopCommissionableBrowse() override { return CHIP_NO_ERROR; }
+
+    CHIP_ERROR ResolveNodeId(uint64_t nodeId, uint64_t fabricId, Inet::IPAddressType type) override
+    {
+        mResolveCount++;
+
+        if (mAnswerSynchronously)
+        {
+            AnswerNode(nodeId);
+            return CHIP_NO_ERROR;
+        }
+
+        for (size_t i = 0; i < mQueuedCount; i++)
+        {
+            if (mQueued[i] == nodeId)
+            {
+                return CHIP_NO_ERROR;
+            }
+        }
+
+        if (mQueuedCount == mMaxQueued)
+        {
+            return CHIP_ERROR_NO_MEMORY;
+        }
+
+        mQueued[mQueuedCount++] = nodeId;
+        mMaxSeenQueued          = (mQueuedCount > mMaxSeenQueued) ? mQueuedCount : mMaxSeenQueued;
+        return CHIP_NO_ERROR;
+    }
+
+    /// Answers the oldest queued resolution, returns false if none was queued
+    bool Answer()
+    {
+        if (mQueuedCount == 0)
+        {
+            return false;
+        }
+
+        uint64_t nodeId = mQueued[0];
+        for (size_t i = 1; i < mQueuedCount; i++)
+        {
+            mQueued[i - 1] = mQueued[i];
+        }
+        mQueuedCount--;
+
+        AnswerNode(nodeId);
+        return true;
+    }
+
+    void AnswerNode(uint64_t nodeId)
+    {
+        if (nodeId % 5 == 0)
+        {
+            mDelegate->OnNodeIdResolutionFailed(nodeId, kResolveError);
+            return;
+        }
+
+        Mdns::ResolvedNodeData nodeData;
+        nodeData.mAddress     = Inet::IPAddress::MakeLLA(nodeId);
+        nodeData.mPort        = CHIP_PORT;
+        nodeData.mInterfaceId = INET_NULL_INTERFACEID;
+        mDelegate->OnNodeIdResolved(nodeId, nodeData);
+    }
+
+    Mdns::ResolverDelegate * mDelegate = nullptr;
+    uint64_t mQueued[kMaxQueued];
+    size_t mQueuedCount       = 0;
+    size_t mMaxQueued         = kMaxQueued;
+    size_t mMaxSeenQueued     = 0;
+    size_t mResolveCount      = 0;
+    bool mAnswerSynchronously = false;
+};
+
+class RecordingDelegate : public DeviceAddressUpdateDelegate
+{
+public:
+    void OnAddressUpdateComplete(NodeId nodeId, CHIP_ERROR error) override
+    {
+        mUpdateCount++;
+        if (error == kResolveError)
+        {
+            mResolveErrorCount++;
+        }
+    }
+
+    void OnAddressRefreshProgress(const AddressRefreshProgress & progress) override { mProgressCount++; }
+
+    void OnAddressRefreshComplete(const AddressRefreshProgress & progress) override
+    {
+        mCompleteCount++;
+        mLastProgress = progress;
+    }
+
+    size_t mUpdateCount       = 0;
+    size_t mResolveErrorCount = 0;
+    size_t mProgressCount     = 0;
+    size_t mCompleteCount     = 0;
+    AddressRefreshProgress mLastProgress;
+};
+
+// The controller is not initialized: resolved addresses fail to apply with
+// CHIP_ERROR_INCORRECT_STATE, which tells them apart from resolution failures.
+struct TestContext
+{
+    TestContext()
+    {
+        updater.Init(&controller, &delegate, &resolver);
+        resolver.SetResolverDelegate(&updater);
+    }
+
+    DeviceController controller;
+    FakeResolver resolver;
+    RecordingDelegate delegate;
+    DeviceAddressUpdater updater;
+};
+
+void AnswerAll(TestContext & ctx)
+{
+    while (ctx.resolver.Answer())
+    {
+    }
+}
+
+void TestRefreshCompletes(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext ctx;
+    NodeId nodes[20];
+
+    for (size_t i = 0; i < ArraySize(nodes); i++)
+    {
+        nodes[i] = i + 1;
+    }
+
+    NL_TEST_ASSERT(inSuite, ctx.updater.RefreshAddresses(nullptr, nodes, ArraySize(nodes), 1, 4) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.updater.IsRefreshing());
+    NL_TEST_ASSERT(inSuite, ctx.resolver.mQueuedCount == 4);
+    NL_TEST_ASSERT(inSuite, ctx.updater.RefreshAddresses(nullptr, nodes, ArraySize(nodes), 1, 4) == CHIP_ERROR_INCORRECT_STATE);
+
+    AnswerAll(ctx);
+
+    NL_TEST_ASSERT(inSuite, !ctx.updater.IsRefreshing());
+    NL_TEST_ASSERT(inSuite, ctx.resolver.mMaxSeenQueued == 4);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mUpdateCount == 20);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mResolveErrorCount == 4);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mProgressCount == 3); // batches of 8, 8 and 4
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mCompleteCount == 1);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mLastProgress.total == 20);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mLastProgress.updated + ctx.delegate.mLastProgress.failed == 20);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mLastProgress.inFlight == 0);
+}
+
+void TestSynchronousAnswers(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext ctx;
+    const NodeId nodes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+    // answers from the resolver cache arrive before ResolveNodeId returns
+    ctx.resolver.mAnswerSynchronously = true;
+
+    NL_TEST_ASSERT(inSuite, ctx.updater.RefreshAddresses(nullptr, nodes, ArraySize(nodes), 1, 2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !ctx.updater.IsRefreshing());
+    NL_TEST_ASSERT(inSuite, ctx.resolver.mResolveCount == 10);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mUpdateCount == 10);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mCompleteCount == 1);
+}
+
+void TestEmptyRefresh(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext ctx;
+
+    NL_TEST_ASSERT(inSuite, ctx.updater.RefreshAddresses(nullptr, nullptr, 0, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !ctx.updater.IsRefreshing());
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mCompleteCount == 1);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mLastProgress.total == 0);
+}
+
+void TestCancel(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext ctx;
+    const NodeId nodes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+    NL_TEST_ASSERT(inSuite, ctx.updater.RefreshAddresses(nullptr, nodes, ArraySize(nodes), 1, 4) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.resolver.Answer());
+    NL_TEST_ASSERT(inSuite, ctx.resolver.Answer());
+
+    // already resolved results are reported on cancel
+    ctx.updater.CancelRefresh();
+    NL_TEST_ASSERT(inSuite, !ctx.updater.IsRefreshing());
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mUpdateCount == 2);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mCompleteCount == 1);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mLastProgress.inFlight == 0);
+
+    // late answers update devices one by one, no more nodes are resolved
+    const size_t resolveCount = ctx.resolver.mResolveCount;
+    AnswerAll(ctx);
+    NL_TEST_ASSERT(inSuite, ctx.resolver.mResolveCount == resolveCount);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mCompleteCount == 1);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mUpdateCount == 2 + 4);
+
+    ctx.updater.CancelRefresh();
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mCompleteCount == 1);
+}
+
+void TestDuplicateNodes(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext ctx;
+    const NodeId nodes[] = { 1, 2, 1, 3, 1, 5, 5 };
+
+    // the resolver answers node 1 (and 5) once for several outstanding entries
+    NL_TEST_ASSERT(inSuite, ctx.updater.RefreshAddresses(nullptr, nodes, ArraySize(nodes), 1, 4) == CHIP_NO_ERROR);
+    AnswerAll(ctx);
+
+    NL_TEST_ASSERT(inSuite, !ctx.updater.IsRefreshing());
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mUpdateCount == ArraySize(nodes));
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mResolveErrorCount == 2);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mCompleteCount == 1);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mLastProgress.updated + ctx.delegate.mLastProgress.failed == ArraySize(nodes));
+}
+
+void TestLateAnswersNotReportedTwice(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext ctx;
+    const NodeId nodes[] = { 1, 2, 3, 4 };
+
+    NL_TEST_ASSERT(inSuite, ctx.updater.RefreshAddresses(nullptr, nodes, ArraySize(nodes), 1, 2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.resolver.Answer());
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mUpdateCount == 0); // batch not full yet
+
+    // another answer for node 1 (e.g. after its entry timed out) must not report it a second time
+    ctx.resolver.AnswerNode(1);
+    AnswerAll(ctx);
+
+    NL_TEST_ASSERT(inSuite, !ctx.updater.IsRefreshing());
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mUpdateCount == ArraySize(nodes));
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mCompleteCount == 1);
+
+    // once the refresh is over, answers are reported one by one again
+    ctx.resolver.AnswerNode(1);
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mUpdateCount == ArraySize(nodes) + 1);
+}
+
+void TestResolverFull(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext ctx;
+    const NodeId nodes[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    // nodes the resolver has no room for are retried once resolutions complete
+    ctx.resolver.mMaxQueued = 2;
+
+    NL_TEST_ASSERT(inSuite, ctx.updater.RefreshAddresses(nullptr, nodes, ArraySize(nodes), 1, 4) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.resolver.mQueuedCount == 2);
+    AnswerAll(ctx);
+
+    NL_TEST_ASSERT(inSuite, !ctx.updater.IsRefreshing());
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mUpdateCount == ArraySize(nodes));
+    NL_TEST_ASSERT(inSuite, ctx.delegate.mCompleteCount == 1);
+}
+
+void TestDestructorIsSilent(nlTestSuite * inSuite, void * inContext)
+{
+    FakeResolver resolver;
+    RecordingDelegate delegate;
+    DeviceController controller;
+    const NodeId nodes[] = { 1, 2, 3 };
+
+    {
+        DeviceAddressUpdater updater;
+
+        updater.Init(&controller, &delegate, &resolver);
+        resolver.SetResolverDelegate(&updater);
+        NL_TEST_ASSERT(inSuite, updater.RefreshAddresses(nullptr, nodes, ArraySize(nodes), 1) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, resolver.Answer());
+    }
+
+    NL_TEST_ASSERT(inSuite, delegate.mUpdateCount == 0);
+    NL_TEST_ASSERT(inSuite, delegate.mProgressCount == 0);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleteCount == 0);
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestRefreshCompletes", TestRefreshCompletes),                       //
+    NL_TEST_DEF("TestSynchronousAnswers", TestSynchronousAnswers),                   //
+    NL_TEST_DEF("TestEmptyRefresh", TestEmptyRefresh),                               //
+    NL_TEST_DEF("TestCancel", TestCancel),                                           //
+    NL_TEST_DEF("TestDuplicateNodes", TestDuplicateNodes),                           //
+    NL_TEST_DEF("TestLateAnswersNotReportedTwice", TestLateAnswersNotReportedTwice), //
+    NL_TEST_DEF("TestResolverFull", TestResolverFull),                               //
+    NL_TEST_DEF("TestDestructorIsSilent", TestDestructorIsSilent),                   //
+    NL_TEST_SENTINEL()                                                               //
+};
+
+} // namespace
+
+int TestDeviceAddressUpdater(void)
+{
+    nlTestSuite theSuite = { "DeviceAddressUpdater", sTests, nullptr, nullptr };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestDeviceAddressUpdater)
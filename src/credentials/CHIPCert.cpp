@@ -37,6 +37,7 @@
 #include <core/CHIPSafeCasts.h>
 #include <core/CHIPTLV.h>
 #include <credentials/CHIPCert.h>
+#include <credentials/CHIPCertValidationCache.h>
 #include <protocols/Protocols.h>
 #include <support/CHIPMem.h>
 #include <support/CodeUtils.h>
@@ -61,6 +62,8 @@ ChipCertificateSet::ChipCertificateSet()
     mDecodeBuf           = nullptr;
     mDecodeBufSize       = 0;
     mMemoryAllocInternal = false;
+    mKeyIdIndex          = nullptr;
+    mKeyIdIndexSize      = 0;
 }
 
 ChipCertificateSet::~ChipCertificateSet()
@@ -73,6 +76,10 @@ CHIP_ERROR ChipCertificateSet::Init(uint8_t maxCertsArraySize, uint16_t decodeBu
     CHIP_ERROR err = CHIP_NO_ERROR;
 
     VerifyOrExit(maxCertsArraySize > 0, err = CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Drop what an earlier Init allocated.
+    Release();
+
     mCerts = reinterpret_cast<ChipCertificateData *>(chip::Platform::MemoryAlloc(sizeof(ChipCertificateData) * maxCertsArraySize));
     VerifyOrExit(mCerts != nullptr, err = CHIP_ERROR_NO_MEMORY);
 
@@ -80,6 +87,16 @@ CHIP_ERROR ChipCertificateSet::Init(uint8_t maxCertsArraySize, uint16_t decodeBu
     mDecodeBuf = reinterpret_cast<uint8_t *>(chip::Platform::MemoryAlloc(decodeBufSize));
     VerifyOrExit(mDecodeBuf != nullptr, err = CHIP_ERROR_NO_MEMORY);
 
+    // Size the subject key id index to keep its load factor at or below one half.
+    mKeyIdIndexSize = 1;
+    while (mKeyIdIndexSize < 2 * maxCertsArraySize)
+    {
+        mKeyIdIndexSize = static_cast<uint16_t>(mKeyIdIndexSize << 1);
+    }
+    mKeyIdIndex = reinterpret_cast<uint8_t *>(chip::Platform::MemoryAlloc(mKeyIdIndexSize));
+    VerifyOrExit(mKeyIdIndex != nullptr, err = CHIP_ERROR_NO_MEMORY);
+    memset(mKeyIdIndex, kKeyIdIndexSlotEmpty, mKeyIdIndexSize);
+
     mCertCount           = 0;
     mMaxCerts            = maxCertsArraySize;
     mDecodeBufSize       = decodeBufSize;
@@ -104,6 +121,11 @@ CHIP_ERROR ChipCertificateSet::Init(ChipCertificateData * certsArray, uint8_t ce
     VerifyOrExit(decodeBuf != nullptr, err = CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrExit(decodeBufSize > 0, err = CHIP_ERROR_INVALID_ARGUMENT);
 
+    // Drop what an earlier Init allocated. Without an index of its own, the set is searched linearly.
+    Release();
+    mKeyIdIndex     = nullptr;
+    mKeyIdIndexSize = 0;
+
     mCertCount           = 0;
     mCerts               = certsArray;
     mMaxCerts            = certsArraySize;
@@ -130,6 +152,12 @@ void ChipCertificateSet::Release()
             chip::Platform::MemoryFree(mDecodeBuf);
             mDecodeBuf = nullptr;
         }
+        if (mKeyIdIndex != nullptr)
+        {
+            chip::Platform::MemoryFree(mKeyIdIndex);
+            mKeyIdIndex     = nullptr;
+            mKeyIdIndexSize = 0;
+        }
     }
 }
 
@@ -141,6 +169,8 @@ void ChipCertificateSet::Clear()
     }
 
     mCertCount = 0;
+
+    RebuildKeyIdIndex();
 }
 
 CHIP_ERROR ChipCertificateSet::LoadCert(const uint8_t * chipCert, uint32_t chipCertLen, BitFlags<CertDecodeFlags> decodeFlags)
@@ -232,6 +262,7 @@ CHIP_ERROR ChipCertificateSet::LoadCert(TLVReader & reader, BitFlags<CertDecodeF
     err = DetermineCertType(*cert);
     SuccessOrExit(err);
 
+    AddToKeyIdIndex(mCertCount);
     mCertCount++;
 
 exit:
@@ -317,6 +348,8 @@ exit:
             mCerts[i].~ChipCertificateData();
         }
         mCertCount = initialCertCount;
+
+        RebuildKeyIdIndex();
     }
 
     return err;
@@ -353,6 +386,7 @@ CHIP_ERROR ChipCertificateSet::AddTrustedKey(uint64_t caId, OID curveOID, const
 
     cert->mKeyUsageFlags.Set(KeyUsageFlags::kKeyCertSign);
 
+    AddToKeyIdIndex(mCertCount);
     mCertCount++;
 
 exit:
@@ -361,6 +395,12 @@ exit:
 
 const ChipCertificateData * ChipCertificateSet::FindCert(const CertificateKeyId & subjectKeyId) const
 {
+    if (mKeyIdIndex != nullptr)
+    {
+        uint16_t iter = 0;
+        return FindNextCertByKeyId(subjectKeyId, iter);
+    }
+
     for (uint8_t i = 0; i < mCertCount; i++)
     {
         ChipCertificateData & cert = mCerts[i];
@@ -373,6 +413,84 @@ const ChipCertificateData * ChipCertificateSet::FindCert(const CertificateKeyId
     return nullptr;
 }
 
+static uint16_t HashKeyId(const CertificateKeyId & keyId)
+{
+    // Key ids are normally SHA-1 hashes of the public key, so their leading bytes are already well distributed.
+    uint32_t hash = keyId.mLen;
+
+    for (uint8_t i = 0; i < keyId.mLen && i < 4; i++)
+    {
+        hash = (hash << 8) | keyId.mId[i];
+    }
+
+    return static_cast<uint16_t>(hash ^ (hash >> 16));
+}
+
+void ChipCertificateSet::AddToKeyIdIndex(uint8_t certIndex)
+{
+    if (mKeyIdIndex == nullptr || mCerts[certIndex].mSubjectKeyId.IsEmpty())
+    {
+        return;
+    }
+
+    // Linear probing. The index has at least twice as many slots as the set has certificates, so a free slot always exists.
+    // Certificates sharing a key id are stored in insertion order along their probe sequence.
+    uint16_t mask = static_cast<uint16_t>(mKeyIdIndexSize - 1);
+    uint16_t slot = static_cast<uint16_t>(HashKeyId(mCerts[certIndex].mSubjectKeyId) & mask);
+
+    while (mKeyIdIndex[slot] != kKeyIdIndexSlotEmpty)
+    {
+        slot = static_cast<uint16_t>((slot + 1) & mask);
+    }
+
+    mKeyIdIndex[slot] = certIndex;
+}
+
+void ChipCertificateSet::RebuildKeyIdIndex()
+{
+    if (mKeyIdIndex == nullptr)
+    {
+        return;
+    }
+
+    memset(mKeyIdIndex, kKeyIdIndexSlotEmpty, mKeyIdIndexSize);
+
+    for (uint8_t i = 0; i < mCertCount; i++)
+    {
+        AddToKeyIdIndex(i);
+    }
+}
+
+ChipCertificateData * ChipCertificateSet::FindNextCertByKeyId(const CertificateKeyId & subjectKeyId, uint16_t & iter) const
+{
+    uint16_t mask  = static_cast<uint16_t>(mKeyIdIndexSize - 1);
+    uint16_t start = HashKeyId(subjectKeyId);
+
+    if (subjectKeyId.IsEmpty())
+    {
+        return nullptr;
+    }
+
+    for (; iter < mKeyIdIndexSize; iter++)
+    {
+        uint8_t certIndex = mKeyIdIndex[(start + iter) & mask];
+
+        if (certIndex == kKeyIdIndexSlotEmpty)
+        {
+            break;
+        }
+
+        if (mCerts[certIndex].mSubjectKeyId.IsEqual(subjectKeyId))
+        {
+            iter++;
+            return &mCerts[certIndex];
+        }
+    }
+
+    iter = mKeyIdIndexSize;
+    return nullptr;
+}
+
 bool ChipCertificateSet::IsCertInTheSet(const ChipCertificateData * cert) const
 {
     for (uint8_t i = 0; i < mCertCount; i++)
@@ -414,16 +532,14 @@ exit:
     return err;
 }
 
-CHIP_ERROR ChipCertificateSet::VerifySignature(const ChipCertificateData * cert, const ChipCertificateData * caCert)
+static CHIP_ERROR EncodeCertSignature(const ChipCertificateData * cert, P256ECDSASignature & signature)
 {
     static constexpr size_t kMaxBytesForDeferredLenList = sizeof(uint8_t *) + // size of a single pointer in the deferred list
         4 + // extra memory allocated for the deferred length field (kLengthFieldReserveSize - 1)
         3;  // the deferred length list is alligned to 32bit boundary
 
     CHIP_ERROR err;
-    P256PublicKey caPublicKey;
-    P256ECDSASignature signature;
-    uint8_t tmpBuf[signature.Capacity() + kMaxBytesForDeferredLenList];
+    uint8_t tmpBuf[kMax_ECDSA_Signature_Length + kMaxBytesForDeferredLenList];
     ASN1Writer writer;
 
     writer.Init(tmpBuf, static_cast<uint32_t>(sizeof(tmpBuf)));
@@ -450,6 +566,20 @@ CHIP_ERROR ChipCertificateSet::VerifySignature(const ChipCertificateData * cert,
     err = signature.SetLength(writer.GetLengthWritten());
     SuccessOrExit(err);
 
+exit:
+    return err;
+}
+
+CHIP_ERROR ChipCertificateSet::VerifySignature(const ChipCertificateData * cert, const ChipCertificateData * caCert)
+{
+    CHIP_ERROR err;
+    P256PublicKey caPublicKey;
+    P256ECDSASignature signature;
+
+    err = EncodeCertSignature(cert, signature);
+    SuccessOrExit(err);
+
+    VerifyOrExit(caCert->mPublicKeyLen == caPublicKey.Length(), err = CHIP_ERROR_INVALID_ARGUMENT);
     memcpy(caPublicKey, caCert->mPublicKey, caCert->mPublicKeyLen);
 
     err = caPublicKey.ECDSA_validate_hash_signature(cert->mTBSHash, chip::Crypto::kSHA256_Hash_Length, signature);
@@ -459,6 +589,50 @@ exit:
     return err;
 }
 
+CHIP_ERROR ChipCertificateSet::VerifySignature(const ChipCertificateData * cert, const ChipCertificateData * caCert,
+                                               P256ECDSAVerifier & verifier)
+{
+    CHIP_ERROR err;
+    P256PublicKey caPublicKey;
+    P256ECDSASignature signature;
+
+    err = EncodeCertSignature(cert, signature);
+    SuccessOrExit(err);
+
+    VerifyOrExit(caCert->mPublicKeyLen == caPublicKey.Length(), err = CHIP_ERROR_INVALID_ARGUMENT);
+    memcpy(caPublicKey, caCert->mPublicKey, caCert->mPublicKeyLen);
+
+    err = verifier.ECDSA_validate_hash_signature(caPublicKey, cert->mTBSHash, chip::Crypto::kSHA256_Hash_Length, signature);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+CHIP_ERROR ChipCertificateSet::AddTrustAnchorsToVerifier(P256ECDSAVerifier & verifier) const
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    P256PublicKey publicKey;
+
+    for (uint8_t i = 0; i < mCertCount; i++)
+    {
+        const ChipCertificateData & cert = mCerts[i];
+
+        if (!cert.mCertFlags.Has(CertFlags::kIsTrustAnchor) || cert.mPublicKeyLen != publicKey.Length())
+        {
+            continue;
+        }
+
+        memcpy(publicKey, cert.mPublicKey, cert.mPublicKeyLen);
+
+        err = verifier.AddTrustedKey(publicKey);
+        SuccessOrExit(err);
+    }
+
+exit:
+    return err;
+}
+
 CHIP_ERROR ChipCertificateSet::ValidateCert(const ChipCertificateData * cert, ValidationContext & context,
                                             BitFlags<CertValidateFlags> validateFlags, uint8_t depth)
 {
@@ -537,6 +711,18 @@ CHIP_ERROR ChipCertificateSet::ValidateCert(const ChipCertificateData * cert, Va
         ExitNow(err = CHIP_NO_ERROR);
     }
 
+    // If the certificate was already validated up to a trust anchor in this set, only the trust anchor and
+    // the validity period of the chain need to be checked again.
+    if (context.mValidationCache != nullptr)
+    {
+        err = ValidateCertFromCache(cert, context, validateFlags, depth);
+        if (err != CHIP_ERROR_KEY_NOT_FOUND)
+        {
+            ExitNow();
+        }
+        err = CHIP_NO_ERROR;
+    }
+
     // Otherwise we must validate the certificate by looking for a chain of valid certificates up to a trusted
     // certificate known as the 'trust anchor'.
 
@@ -566,9 +752,21 @@ CHIP_ERROR ChipCertificateSet::ValidateCert(const ChipCertificateData * cert, Va
 
     // Verify signature of the current certificate against public key of the CA certificate. If signature verification
     // succeeds, the current certificate is valid.
-    err = VerifySignature(cert, caCert);
+    if (context.mVerifier != nullptr)
+    {
+        err = VerifySignature(cert, caCert, *context.mVerifier);
+    }
+    else
+    {
+        err = VerifySignature(cert, caCert);
+    }
     SuccessOrExit(err);
 
+    if (context.mValidationCache != nullptr)
+    {
+        AddToValidationCache(cert, caCert, context, depth);
+    }
+
 exit:
     return err;
 }
@@ -588,10 +786,28 @@ CHIP_ERROR ChipCertificateSet::FindValidCert(const ChipDN & subjectDN, const Cer
         ExitNow();
     }
 
-    // For each cert in the set...
-    for (uint8_t i = 0; i < mCertCount; i++)
+    // For each cert in the set with a matching subject key id, or for each cert in the set if there is no index
+    // or no subject key id to search for...
+    for (uint16_t i = 0, iter = 0;; i++)
     {
-        ChipCertificateData * candidateCert = &mCerts[i];
+        ChipCertificateData * candidateCert;
+
+        if (mKeyIdIndex != nullptr && !subjectKeyId.IsEmpty())
+        {
+            candidateCert = FindNextCertByKeyId(subjectKeyId, iter);
+            if (candidateCert == nullptr)
+            {
+                break;
+            }
+        }
+        else
+        {
+            if (i >= mCertCount)
+            {
+                break;
+            }
+            candidateCert = &mCerts[i];
+        }
 
         // Skip the certificate if its subject DN and key id do not match the input criteria.
         if (!subjectDN.IsEmpty() && !candidateCert->mSubjectDN.IsEqual(subjectDN))
@@ -620,6 +836,59 @@ exit:
     return err;
 }
 
+CHIP_ERROR ChipCertificateSet::ValidateCertFromCache(const ChipCertificateData * cert, ValidationContext & context,
+                                                     BitFlags<CertValidateFlags> validateFlags, uint8_t depth)
+{
+    CHIP_ERROR err = CHIP_ERROR_KEY_NOT_FOUND;
+    const CertValidationCacheEntry * entry;
+
+    VerifyOrExit(cert->mCertFlags.Has(CertFlags::kTBSHashPresent), );
+
+    entry = context.mValidationCache->Find(*cert);
+    VerifyOrExit(entry != nullptr, );
+
+    // The path length constraints of the cached chain were only checked for this or greater depths.
+    VerifyOrExit(depth <= entry->mMaxDepth, );
+    VerifyOrExit(depth + entry->mTrustAnchorDistance <= UINT8_MAX, );
+
+    // Every certificate between this one and the trust anchor must still be within its validity period.
+    if (entry->mNotBeforeTime != 0 && !validateFlags.Has(CertValidateFlags::kIgnoreNotBefore))
+    {
+        VerifyOrExit(context.mEffectiveTime >= entry->mNotBeforeTime, );
+    }
+    if (entry->mNotAfterTime != 0 && !validateFlags.Has(CertValidateFlags::kIgnoreNotAfter))
+    {
+        VerifyOrExit(context.mEffectiveTime <= entry->mNotAfterTime, );
+    }
+
+    // The cached result only holds if its trust anchor is trusted by this set. Validating the trust anchor
+    // records it in the context and checks its own constraints at the depth it has in the chain.
+    for (uint8_t i = 0; i < mCertCount; i++)
+    {
+        const ChipCertificateData * trustAnchor = &mCerts[i];
+
+        if (trustAnchor->mCertFlags.Has(CertFlags::kIsTrustAnchor) &&
+            trustAnchor->mPublicKeyLen == entry->mTrustAnchorPublicKeyLen &&
+            memcmp(trustAnchor->mPublicKey, entry->mTrustAnchorPublicKey, entry->mTrustAnchorPublicKeyLen) == 0 &&
+            ValidateCert(trustAnchor, context, validateFlags, static_cast<uint8_t>(depth + entry->mTrustAnchorDistance)) ==
+                CHIP_NO_ERROR)
+        {
+            ExitNow(err = CHIP_NO_ERROR);
+        }
+    }
+
+exit:
+    return err;
+}
+
+void ChipCertificateSet::AddToValidationCache(const ChipCertificateData * cert, const ChipCertificateData * caCert,
+                                              ValidationContext & context, uint8_t depth)
+{
+    // Failing to cache the result does not affect the validation itself, e.g. the CA certificate
+    // may have been evicted from a small cache since it was validated.
+    context.mValidationCache->Add(*cert, *caCert, depth);
+}
+
 ChipCertificateData::ChipCertificateData()
 {
     Clear();
@@ -664,6 +933,8 @@ void ValidationContext::Reset()
     mRequiredKeyPurposes.ClearAll();
     mValidateFlags.ClearAll();
     mRequiredCertType = kCertType_NotSpecified;
+    mVerifier         = nullptr;
+    mValidationCache  = nullptr;
 }
 
 CHIP_ERROR DetermineCertType(ChipCertificateData & cert)
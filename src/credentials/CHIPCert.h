@@ -267,6 +267,8 @@ struct ChipCertificateData
     uint8_t mTBSHash[chip::Crypto::kSHA256_Hash_Length]; /**< Certificate TBS hash. */
 };
 
+class CertValidationCache;
+
 /**
  *  @struct ValidationContext
  *
@@ -285,6 +287,12 @@ struct ValidationContext
     BitFlags<CertValidateFlags> mValidateFlags;     /**< Certificate validation flags, specifying how a certificate
                                                        should be validated. */
     uint8_t mRequiredCertType;                      /**< Required certificate type. */
+    chip::Crypto::P256ECDSAVerifier * mVerifier;    /**< Optional long-lived signature verification context. When set,
+                                                       certificate signatures are verified through it instead of
+                                                       setting up a new curve context for every certificate. */
+    CertValidationCache * mValidationCache;         /**< Optional cache of previously validated certificates. When set,
+                                                       chain validation stops at the first certificate found in the
+                                                       cache, and newly validated certificates are added to it. */
 
     void Reset();
 };
@@ -318,6 +326,8 @@ public:
      * @brief Initialize ChipCertificateSet.
      *        This initialization method is used when all memory structures needed for operation are
      *        allocated externally and methods in this class don't need to deal with memory allocations.
+     *        Memory allocated by an earlier Init() is released; without a subject key id index, certificates
+     *        are looked up linearly.
      *
      * @param certsArray      A pointer to the array of the ChipCertificateData structures.
      * @param certsArraySize  Number of ChipCertificateData entries in the array.
@@ -478,6 +488,28 @@ public:
      **/
     static CHIP_ERROR VerifySignature(const ChipCertificateData * cert, const ChipCertificateData * caCert);
 
+    /**
+     * @brief Verify CHIP certificate signature using a long-lived verification context.
+     *
+     * @param cert      Pointer to the CHIP certificiate which signature should be validated.
+     * @param caCert    Pointer to the CA certificate of the verified certificate.
+     * @param verifier  Initialized signature verification context.
+     *
+     * @return Returns a CHIP_ERROR on validation or other error, CHIP_NO_ERROR otherwise
+     **/
+    static CHIP_ERROR VerifySignature(const ChipCertificateData * cert, const ChipCertificateData * caCert,
+                                      chip::Crypto::P256ECDSAVerifier & verifier);
+
+    /**
+     * @brief Register the public keys of all trust anchors in the set with a signature verification context,
+     *        so that signatures made by them are verified without re-parsing and re-checking the keys.
+     *
+     * @param verifier  Initialized signature verification context.
+     *
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR AddTrustAnchorsToVerifier(chip::Crypto::P256ECDSAVerifier & verifier) const;
+
 private:
     ChipCertificateData * mCerts; /**< Pointer to an array of certificate data. */
     uint8_t mCertCount;           /**< Number of certificates in mCerts
@@ -491,6 +523,51 @@ private:
     uint8_t * mDecodeBuf;         /**< Certificate decode buffer. */
     uint16_t mDecodeBufSize;      /**< Certificate decode buffer size. */
     bool mMemoryAllocInternal;    /**< Indicates whether temporary memory buffers are allocated internally. */
+    uint8_t * mKeyIdIndex;        /**< Open-addressed hash table mapping subject key ids to indices in mCerts,
+                                     or NULL if the set was initialized with external memory. */
+    uint16_t mKeyIdIndexSize;     /**< Number of slots in mKeyIdIndex, a power of two. */
+
+    static constexpr uint8_t kKeyIdIndexSlotEmpty = 0xFF; /**< Marks a free slot in mKeyIdIndex. */
+
+    /**
+     * @brief Add the certificate at the specified index in mCerts to the subject key id index.
+     **/
+    void AddToKeyIdIndex(uint8_t certIndex);
+
+    /**
+     * @brief Rebuild the subject key id index from the certificates currently in the set.
+     **/
+    void RebuildKeyIdIndex();
+
+    /**
+     * @brief Find the next certificate with the specified subject key id.
+     *
+     * @param subjectKeyId  Subject key identifier to search for.
+     * @param iter          Search state. Must be set to 0 before the first call.
+     *
+     * @return A pointer to the next matching certificate, or NULL if there are no more matches.
+     **/
+    ChipCertificateData * FindNextCertByKeyId(const CertificateKeyId & subjectKeyId, uint16_t & iter) const;
+
+    /**
+     * @brief Complete validation of a certificate using the result cached for it by an earlier validation.
+     *
+     * @param cert           Pointer to the CHIP certificiate to be validated.
+     * @param context        Certificate validation context.
+     * @param validateFlags  Certificate validation flags.
+     * @param depth          Depth of the current certificate in the certificate validation chain.
+     *
+     * @return CHIP_NO_ERROR if the cached result applies and its trust anchor is in the set,
+     *         CHIP_ERROR_KEY_NOT_FOUND if the certificate must be validated in full.
+     **/
+    CHIP_ERROR ValidateCertFromCache(const ChipCertificateData * cert, ValidationContext & context,
+                                     BitFlags<CertValidateFlags> validateFlags, uint8_t depth);
+
+    /**
+     * @brief Record a successfully validated certificate in the validation cache of the context.
+     **/
+    void AddToValidationCache(const ChipCertificateData * cert, const ChipCertificateData * caCert, ValidationContext & context,
+                              uint8_t depth);
 
     /**
      * @brief Find and validate CHIP certificate.
@@ -586,6 +663,80 @@ CHIP_ERROR ConvertX509CertToChipCert(const uint8_t * x509Cert, uint32_t x509Cert
 CHIP_ERROR ConvertChipCertToX509Cert(const uint8_t * chipCert, uint32_t chipCertLen, uint8_t * x509CertBuf,
                                      uint32_t x509CertBufSize, uint32_t & x509CertLen);
 
+/**
+ * @brief Convert standard X.509 certificate to CHIP certificate, writing the CHIP certificate
+ *        directly to a TLV writer as the X.509 certificate is parsed.
+ *
+ * @param x509Cert     Buffer containing X.509 DER encoded certificate.
+ * @param x509CertLen  The length of the X.509 DER encoded certificate.
+ * @param writer       A TLVWriter to write the CHIP certificate TLV structure to.
+ * @param tag          The tag of the CHIP certificate TLV structure.
+ *
+ * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+ **/
+CHIP_ERROR ConvertX509CertToChipCert(const uint8_t * x509Cert, uint32_t x509CertLen, chip::TLV::TLVWriter & writer, uint64_t tag);
+
+/**
+ * @brief Convert CHIP certificate to the standard X.509 DER encoded certificate, reading the CHIP
+ *        certificate directly from a TLV reader.
+ *
+ * @param reader          A TLVReader positioned at (or immediately before) the CHIP certificate TLV structure.
+ * @param x509CertBuf     Buffer to store converted certificate in X.509 DER format.
+ * @param x509CertBufSize The size of the buffer to store converted certificate.
+ * @param x509CertLen     The length of the converted certificate.
+ *
+ * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+ **/
+CHIP_ERROR ConvertChipCertToX509Cert(chip::TLV::TLVReader & reader, uint8_t * x509CertBuf, uint32_t x509CertBufSize,
+                                     uint32_t & x509CertLen);
+
+/**
+ * @brief Convert a bundle of concatenated X.509 DER encoded certificates to a TLV array of CHIP
+ *        certificates, as accepted by ChipCertificateSet::LoadCerts().
+ *
+ *        Certificates are converted one at a time and written to the TLV writer as they are parsed.
+ *        When the writer is backed by a TLVBackingStore, the bundle can be converted using a fixed
+ *        amount of memory regardless of its size.
+ *
+ * @param x509Certs     Buffer containing concatenated X.509 DER encoded certificates.
+ * @param x509CertsLen  The length of the X.509 certificates buffer.
+ * @param writer        A TLVWriter to write the TLV array of CHIP certificates to.
+ * @param tag           The tag of the TLV array. Use ProfileTag(kProtocol_OpCredentials, kTag_ChipCertificateArray)
+ *                      for a bundle to be loaded with ChipCertificateSet::LoadCerts().
+ *
+ * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+ **/
+CHIP_ERROR ConvertX509CertsToChipCerts(const uint8_t * x509Certs, uint32_t x509CertsLen, chip::TLV::TLVWriter & writer,
+                                       uint64_t tag);
+
+/**
+ * A function to be called with each certificate converted by ConvertChipCertsToX509Certs().
+ *
+ * @param context      The context pointer passed to ConvertChipCertsToX509Certs().
+ * @param x509Cert     Buffer containing the X.509 DER encoded certificate. It is only valid until the function returns.
+ * @param x509CertLen  The length of the X.509 DER encoded certificate.
+ *
+ * @return CHIP_NO_ERROR to continue the conversion, any other value to abort it and return the value to the caller.
+ **/
+typedef CHIP_ERROR (*X509CertHandler)(void * context, const uint8_t * x509Cert, uint32_t x509CertLen);
+
+/**
+ * @brief Convert a TLV array of CHIP certificates to standard X.509 DER encoded certificates.
+ *
+ *        Each certificate is converted into the same output buffer and passed to the handler before
+ *        the next certificate is read, so the buffer only needs to hold the largest certificate.
+ *
+ * @param reader           A TLVReader positioned at (or immediately before) the TLV array of CHIP certificates.
+ * @param x509CertBuf      Buffer to store each converted certificate in X.509 DER format.
+ * @param x509CertBufSize  The size of the buffer.
+ * @param handler          Function called with each converted certificate.
+ * @param context          Context pointer passed to the handler.
+ *
+ * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+ **/
+CHIP_ERROR ConvertChipCertsToX509Certs(chip::TLV::TLVReader & reader, uint8_t * x509CertBuf, uint32_t x509CertBufSize,
+                                       X509CertHandler handler, void * context);
+
 /**
  * Determine type of a CHIP certificate.
  *
@@ -498,14 +498,14 @@ exit:
     return err;
 }
 
-static CHIP_ERROR ConvertCertificate(ASN1Reader & reader, TLVWriter & writer)
+static CHIP_ERROR ConvertCertificate(ASN1Reader & reader, TLVWriter & writer, uint64_t tag)
 {
     CHIP_ERROR err;
     int64_t version;
     OID sigAlgoOID;
     TLVType containerType;
 
-    err = writer.StartContainer(ProfileTag(kProtocol_OpCredentials, kTag_ChipCertificate), kTLVType_Structure, containerType);
+    err = writer.StartContainer(tag, kTLVType_Structure, containerType);
     SuccessOrExit(err);
 
     // Certificate ::= SEQUENCE
@@ -662,7 +662,7 @@ DLL_EXPORT CHIP_ERROR ConvertX509CertToChipCert(const uint8_t * x509Cert, uint32
 
     writer.Init(chipCertBuf, chipCertBufSize);
 
-    err = ConvertCertificate(reader, writer);
+    err = ConvertCertificate(reader, writer, ProfileTag(kProtocol_OpCredentials, kTag_ChipCertificate));
     SuccessOrExit(err);
 
     err = writer.Finalize();
@@ -674,5 +674,51 @@ exit:
     return err;
 }
 
+DLL_EXPORT CHIP_ERROR ConvertX509CertToChipCert(const uint8_t * x509Cert, uint32_t x509CertLen, TLVWriter & writer, uint64_t tag)
+{
+    ASN1Reader reader;
+
+    reader.Init(x509Cert, x509CertLen);
+
+    return ConvertCertificate(reader, writer, tag);
+}
+
+DLL_EXPORT CHIP_ERROR ConvertX509CertsToChipCerts(const uint8_t * x509Certs, uint32_t x509CertsLen, TLVWriter & writer,
+                                                  uint64_t tag)
+{
+    CHIP_ERROR err;
+    ASN1Reader reader;
+    TLVType containerType;
+    const uint8_t * certStart = x509Certs;
+
+    err = writer.StartContainer(tag, kTLVType_Array, containerType);
+    SuccessOrExit(err);
+
+    // The bundle is a sequence of DER encoded certificates. Each certificate is converted and written out
+    // as soon as its end is known, so no state is kept between certificates.
+    reader.Init(x509Certs, x509CertsLen);
+
+    while ((err = reader.Next()) == ASN1_NO_ERROR)
+    {
+        const uint8_t * certEnd = reader.GetValue() + reader.GetValueLen();
+
+        VerifyOrExit(reader.GetClass() == kASN1TagClass_Universal && reader.GetTag() == kASN1UniversalTag_Sequence &&
+                         reader.IsConstructed() && !reader.IsIndefiniteLen(),
+                     err = ASN1_ERROR_INVALID_ENCODING);
+
+        err = ConvertX509CertToChipCert(certStart, static_cast<uint32_t>(certEnd - certStart), writer, AnonymousTag);
+        SuccessOrExit(err);
+
+        certStart = certEnd;
+    }
+    VerifyOrExit(err == ASN1_END, );
+
+    err = writer.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
 } // namespace Credentials
 } // namespace chip
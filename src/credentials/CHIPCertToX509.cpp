@@ -871,13 +871,20 @@ exit:
 DLL_EXPORT CHIP_ERROR ConvertChipCertToX509Cert(const uint8_t * chipCert, uint32_t chipCertLen, uint8_t * x509CertBuf,
                                                 uint32_t x509CertBufSize, uint32_t & x509CertLen)
 {
-    CHIP_ERROR err;
     TLVReader reader;
-    ASN1Writer writer;
-    ChipCertificateData certData;
 
     reader.Init(chipCert, chipCertLen);
 
+    return ConvertChipCertToX509Cert(reader, x509CertBuf, x509CertBufSize, x509CertLen);
+}
+
+DLL_EXPORT CHIP_ERROR ConvertChipCertToX509Cert(TLVReader & reader, uint8_t * x509CertBuf, uint32_t x509CertBufSize,
+                                                uint32_t & x509CertLen)
+{
+    CHIP_ERROR err;
+    ASN1Writer writer;
+    ChipCertificateData certData;
+
     writer.Init(x509CertBuf, x509CertBufSize);
 
     err = DecodeConvertCert(reader, writer, certData);
@@ -892,6 +899,46 @@ exit:
     return err;
 }
 
+DLL_EXPORT CHIP_ERROR ConvertChipCertsToX509Certs(TLVReader & reader, uint8_t * x509CertBuf, uint32_t x509CertBufSize,
+                                                  X509CertHandler handler, void * context)
+{
+    CHIP_ERROR err;
+    TLVType containerType;
+    uint32_t x509CertLen;
+
+    VerifyOrExit(handler != nullptr, err = CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (reader.GetType() == kTLVType_NotSpecified)
+    {
+        err = reader.Next();
+        SuccessOrExit(err);
+    }
+    VerifyOrExit(reader.GetType() == kTLVType_Array, err = CHIP_ERROR_WRONG_TLV_TYPE);
+
+    err = reader.EnterContainer(containerType);
+    SuccessOrExit(err);
+
+    // Each certificate is converted into the same output buffer and handed to the caller before the
+    // next one is read, so the memory needed does not depend on the number of certificates.
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        VerifyOrExit(reader.GetTag() == AnonymousTag, err = CHIP_ERROR_UNEXPECTED_TLV_ELEMENT);
+
+        err = ConvertChipCertToX509Cert(reader, x509CertBuf, x509CertBufSize, x509CertLen);
+        SuccessOrExit(err);
+
+        err = handler(context, x509CertBuf, x509CertLen);
+        SuccessOrExit(err);
+    }
+    VerifyOrExit(err == CHIP_END_OF_TLV, );
+
+    err = reader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
 CHIP_ERROR DecodeChipCert(const uint8_t * chipCert, uint32_t chipCertLen, ChipCertificateData & certData)
 {
     TLVReader reader;
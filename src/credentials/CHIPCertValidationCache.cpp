@@ -0,0 +1,297 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a least-recently-used cache of CHIP certificates
+ *      that have already been validated up to a trust anchor.
+ *
+ */
+
+#include <credentials/CHIPCertValidationCache.h>
+
+#include <support/CHIPMem.h>
+#include <support/CodeUtils.h>
+
+#include <string.h>
+
+namespace chip {
+namespace Credentials {
+
+using namespace chip::Crypto;
+
+namespace {
+
+// Narrow a chain validity window [notBefore, notAfter] by the validity period of a certificate.
+// A time value of 0 means the corresponding bound is not set.
+void IntersectValidity(uint32_t & notBefore, uint32_t & notAfter, const ChipCertificateData & cert)
+{
+    if (cert.mNotBeforeTime != 0 && cert.mNotBeforeTime > notBefore)
+    {
+        notBefore = cert.mNotBeforeTime;
+    }
+    if (cert.mNotAfterTime != 0 && (notAfter == 0 || cert.mNotAfterTime < notAfter))
+    {
+        notAfter = cert.mNotAfterTime;
+    }
+}
+
+} // namespace
+
+CertValidationCache::CertValidationCache()
+{
+    mEntries             = nullptr;
+    mMaxEntries          = 0;
+    mMemoryAllocInternal = false;
+    mUseCounter          = 0;
+    mHitCount            = 0;
+    mMissCount           = 0;
+}
+
+CertValidationCache::~CertValidationCache()
+{
+    Release();
+}
+
+CHIP_ERROR CertValidationCache::Init(uint8_t maxEntries)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    CertValidationCacheEntry * entries;
+
+    VerifyOrExit(maxEntries > 0, err = CHIP_ERROR_INVALID_ARGUMENT);
+
+    entries = reinterpret_cast<CertValidationCacheEntry *>(
+        chip::Platform::MemoryAlloc(sizeof(CertValidationCacheEntry) * maxEntries));
+    VerifyOrExit(entries != nullptr, err = CHIP_ERROR_NO_MEMORY);
+
+    err = Init(entries, maxEntries);
+    SuccessOrExit(err);
+
+    mMemoryAllocInternal = true;
+
+exit:
+    return err;
+}
+
+CHIP_ERROR CertValidationCache::Init(CertValidationCacheEntry * entries, uint8_t maxEntries)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    VerifyOrExit(entries != nullptr, err = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(maxEntries > 0, err = CHIP_ERROR_INVALID_ARGUMENT);
+
+    Release();
+
+    mEntries             = entries;
+    mMaxEntries          = maxEntries;
+    mMemoryAllocInternal = false;
+
+    Clear();
+
+exit:
+    return err;
+}
+
+void CertValidationCache::Release()
+{
+    if (mMemoryAllocInternal && mEntries != nullptr)
+    {
+        chip::Platform::MemoryFree(mEntries);
+    }
+
+    mEntries             = nullptr;
+    mMaxEntries          = 0;
+    mMemoryAllocInternal = false;
+}
+
+void CertValidationCache::Clear()
+{
+    if (mEntries != nullptr)
+    {
+        memset(mEntries, 0, sizeof(CertValidationCacheEntry) * mMaxEntries);
+    }
+
+    mUseCounter = 0;
+    mHitCount   = 0;
+    mMissCount  = 0;
+}
+
+const CertValidationCacheEntry * CertValidationCache::Find(const ChipCertificateData & cert)
+{
+    CertValidationCacheEntry * entry = nullptr;
+    uint8_t fingerprint[kSHA256_Hash_Length];
+
+    if (mEntries != nullptr && ComputeFingerprint(cert, fingerprint) == CHIP_NO_ERROR)
+    {
+        entry = FindEntry(fingerprint);
+    }
+
+    if (entry != nullptr)
+    {
+        entry->mLastUsed = NextUseStamp();
+        mHitCount++;
+    }
+    else
+    {
+        mMissCount++;
+    }
+
+    return entry;
+}
+
+CHIP_ERROR CertValidationCache::Add(const ChipCertificateData & cert, const ChipCertificateData & caCert, uint8_t depth)
+{
+    CHIP_ERROR err;
+    uint8_t fingerprint[kSHA256_Hash_Length];
+    uint8_t caFingerprint[kSHA256_Hash_Length];
+    const CertValidationCacheEntry * caEntry = nullptr;
+    CertValidationCacheEntry * entry;
+    uint32_t notBefore = 0;
+    uint32_t notAfter  = 0;
+
+    VerifyOrExit(mEntries != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+
+    err = ComputeFingerprint(cert, fingerprint);
+    SuccessOrExit(err);
+
+    // The CA certificate must either be trusted or itself chain to a trust anchor through cached results.
+    if (!caCert.mCertFlags.Has(CertFlags::kIsTrustAnchor))
+    {
+        VerifyOrExit(caCert.mCertFlags.Has(CertFlags::kTBSHashPresent), err = CHIP_ERROR_KEY_NOT_FOUND);
+
+        err = ComputeFingerprint(caCert, caFingerprint);
+        SuccessOrExit(err);
+
+        caEntry = FindEntry(caFingerprint);
+        VerifyOrExit(caEntry != nullptr, err = CHIP_ERROR_KEY_NOT_FOUND);
+        VerifyOrExit(caEntry->mTrustAnchorDistance < UINT8_MAX, err = CHIP_ERROR_CERT_PATH_TOO_LONG);
+
+        notBefore = caEntry->mNotBeforeTime;
+        notAfter  = caEntry->mNotAfterTime;
+    }
+    else
+    {
+        VerifyOrExit(caCert.mPublicKeyLen <= kP256_PublicKey_Length, err = CHIP_ERROR_INVALID_ARGUMENT);
+    }
+
+    IntersectValidity(notBefore, notAfter, cert);
+
+    // Reuse the existing entry for this certificate, if there is one. Otherwise take a free entry or,
+    // if there are none, the least recently used one.
+    entry = FindEntry(fingerprint);
+    if (entry == nullptr)
+    {
+        entry = &mEntries[0];
+        for (uint8_t i = 1; i < mMaxEntries && entry->mLastUsed != 0; i++)
+        {
+            if (mEntries[i].mLastUsed < entry->mLastUsed)
+            {
+                entry = &mEntries[i];
+            }
+        }
+    }
+
+    memcpy(entry->mCertFingerprint, fingerprint, sizeof(fingerprint));
+    if (caEntry != nullptr)
+    {
+        // If the least recently used entry is the one of the CA certificate, it already holds the trust anchor key.
+        if (caEntry != entry)
+        {
+            memcpy(entry->mTrustAnchorPublicKey, caEntry->mTrustAnchorPublicKey, caEntry->mTrustAnchorPublicKeyLen);
+            entry->mTrustAnchorPublicKeyLen = caEntry->mTrustAnchorPublicKeyLen;
+        }
+        entry->mTrustAnchorDistance = static_cast<uint8_t>(caEntry->mTrustAnchorDistance + 1);
+    }
+    else
+    {
+        memcpy(entry->mTrustAnchorPublicKey, caCert.mPublicKey, caCert.mPublicKeyLen);
+        entry->mTrustAnchorPublicKeyLen = caCert.mPublicKeyLen;
+        entry->mTrustAnchorDistance     = 1;
+    }
+    entry->mNotBeforeTime = notBefore;
+    entry->mNotAfterTime  = notAfter;
+    entry->mMaxDepth      = depth;
+    entry->mLastUsed      = NextUseStamp();
+
+exit:
+    return err;
+}
+
+CHIP_ERROR CertValidationCache::ComputeFingerprint(const ChipCertificateData & cert, uint8_t * fingerprint)
+{
+    CHIP_ERROR err;
+    Hash_SHA256_stream hash;
+
+    VerifyOrExit(cert.mCertFlags.Has(CertFlags::kTBSHashPresent), err = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(cert.mSignature.R != nullptr && cert.mSignature.S != nullptr, err = CHIP_ERROR_INVALID_ARGUMENT);
+
+    err = hash.Begin();
+    SuccessOrExit(err);
+
+    err = hash.AddData(cert.mTBSHash, sizeof(cert.mTBSHash));
+    SuccessOrExit(err);
+
+    err = hash.AddData(cert.mSignature.R, cert.mSignature.RLen);
+    SuccessOrExit(err);
+
+    err = hash.AddData(cert.mSignature.S, cert.mSignature.SLen);
+    SuccessOrExit(err);
+
+    err = hash.Finish(fingerprint);
+    SuccessOrExit(err);
+
+exit:
+    hash.Clear();
+    return err;
+}
+
+CertValidationCacheEntry * CertValidationCache::FindEntry(const uint8_t * fingerprint)
+{
+    for (uint8_t i = 0; i < mMaxEntries; i++)
+    {
+        CertValidationCacheEntry & entry = mEntries[i];
+        if (entry.mLastUsed != 0 && memcmp(entry.mCertFingerprint, fingerprint, sizeof(entry.mCertFingerprint)) == 0)
+        {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+uint32_t CertValidationCache::NextUseStamp()
+{
+    // Stamps only wrap around after 2^32 uses; when they do, restart them from 1 and accept that
+    // the recency order of the existing entries is lost once.
+    if (mUseCounter == UINT32_MAX)
+    {
+        for (uint8_t i = 0; i < mMaxEntries; i++)
+        {
+            if (mEntries[i].mLastUsed != 0)
+            {
+                mEntries[i].mLastUsed = 1;
+            }
+        }
+        mUseCounter = 1;
+    }
+
+    return ++mUseCounter;
+}
+
+} // namespace Credentials
+} // namespace chip
@@ -0,0 +1,156 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines a least-recently-used cache of CHIP certificates
+ *      that have already been validated up to a trust anchor.
+ *
+ */
+
+#pragma once
+
+#include <credentials/CHIPCert.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <support/DLLUtil.h>
+
+namespace chip {
+namespace Credentials {
+
+/**
+ *  @struct CertValidationCacheEntry
+ *
+ *  @brief
+ *    The result of a successful validation of a single certificate.
+ */
+struct CertValidationCacheEntry
+{
+    uint8_t mCertFingerprint[chip::Crypto::kSHA256_Hash_Length];         /**< Hash over TBS hash and signature of the certificate. */
+    uint8_t mTrustAnchorPublicKey[chip::Crypto::kP256_PublicKey_Length]; /**< Public key of the trust anchor. */
+    uint32_t mNotBeforeTime;          /**< Latest Not Before time in the chain below the trust anchor, 0 if none. */
+    uint32_t mNotAfterTime;           /**< Earliest Not After time in the chain below the trust anchor, 0 if none. */
+    uint32_t mLastUsed;               /**< LRU stamp, 0 for a free entry. */
+    uint8_t mTrustAnchorPublicKeyLen; /**< Length of mTrustAnchorPublicKey. */
+    uint8_t mTrustAnchorDistance;     /**< Number of links from the certificate to the trust anchor. */
+    uint8_t mMaxDepth;                /**< Depth at which the certificate was validated. */
+};
+
+/**
+ *  @class CertValidationCache
+ *
+ *  @brief
+ *    Least-recently-used cache of certificates that have been validated up to a trust anchor.
+ *
+ *    Entries are keyed on a fingerprint covering both the to-be-signed portion and the signature of
+ *    a certificate, so a certificate with the same contents but a different signature never matches.
+ *    The cache does not reference any ChipCertificateSet; a cached result is only used if its trust
+ *    anchor is present in the set performing the validation.
+ */
+class DLL_EXPORT CertValidationCache
+{
+public:
+    CertValidationCache();
+    ~CertValidationCache();
+
+    /**
+     * @brief Initialize the cache. Entry storage is allocated with chip::Platform::MemoryAlloc().
+     *
+     * @param maxEntries  Maximum number of validated certificates to remember.
+     *
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR Init(uint8_t maxEntries);
+
+    /**
+     * @brief Initialize the cache with externally allocated entry storage.
+     *
+     * @param entries     Array of entries used as cache storage.
+     * @param maxEntries  Number of entries in the array.
+     *
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR Init(CertValidationCacheEntry * entries, uint8_t maxEntries);
+
+    /**
+     * @brief Release resources allocated by this class.
+     **/
+    void Release();
+
+    /**
+     * @brief Forget all cached validation results, e.g. after the set of trusted roots changed.
+     **/
+    void Clear();
+
+    /**
+     * @brief Look up the cached validation result of a certificate and mark it as most recently used.
+     *
+     * @param cert  Certificate to look up. Must have its TBS hash computed.
+     *
+     * @return A pointer to the cache entry, or NULL if the certificate is not in the cache.
+     **/
+    const CertValidationCacheEntry * Find(const ChipCertificateData & cert);
+
+    /**
+     * @brief Record a certificate whose signature has been verified against its CA certificate, evicting the
+     *        least recently used entry if needed.
+     *
+     *        The CA certificate must either be a trust anchor or have been recorded in the cache itself.
+     *
+     * @param cert    Validated certificate. Must have its TBS hash computed.
+     * @param caCert  CA certificate that signed the certificate.
+     * @param depth   Depth at which the certificate was validated.
+     *
+     * @return CHIP_ERROR_KEY_NOT_FOUND if the CA certificate is neither a trust anchor nor in the cache,
+     *         CHIP_NO_ERROR on success, other CHIP_ERROR on error.
+     **/
+    CHIP_ERROR Add(const ChipCertificateData & cert, const ChipCertificateData & caCert, uint8_t depth);
+
+    /**
+     * @return Number of lookups that found a cached result.
+     **/
+    uint32_t GetHitCount() const { return mHitCount; }
+
+    /**
+     * @return Number of lookups that did not find a cached result.
+     **/
+    uint32_t GetMissCount() const { return mMissCount; }
+
+    /**
+     * @brief Compute the cache key of a certificate.
+     *
+     * @param cert         Certificate. Must have its TBS hash computed.
+     * @param fingerprint  Buffer of kSHA256_Hash_Length bytes receiving the key.
+     *
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    static CHIP_ERROR ComputeFingerprint(const ChipCertificateData & cert, uint8_t * fingerprint);
+
+private:
+    CertValidationCacheEntry * mEntries; /**< Pointer to an array of cache entries. */
+    uint8_t mMaxEntries;                 /**< Length of mEntries array. */
+    bool mMemoryAllocInternal;           /**< Indicates whether mEntries was allocated internally. */
+    uint32_t mUseCounter;                /**< Source of LRU stamps. */
+    uint32_t mHitCount;                  /**< Number of successful lookups. */
+    uint32_t mMissCount;                 /**< Number of failed lookups. */
+
+    CertValidationCacheEntry * FindEntry(const uint8_t * fingerprint);
+    uint32_t NextUseStamp();
+};
+
+} // namespace Credentials
+} // namespace chip
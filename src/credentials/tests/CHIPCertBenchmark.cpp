@@ -0,0 +1,174 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Benchmark measuring CHIP certificate chain validations per second,
+ *      with and without a long-lived signature verification context and
+ *      a cache of validated certificates.
+ *
+ */
+
+#include <credentials/CHIPCert.h>
+#include <credentials/CHIPCertValidationCache.h>
+#include <support/CHIPMem.h>
+#include <support/CodeUtils.h>
+#include <support/ErrorStr.h>
+#include <system/SystemClock.h>
+
+#include "CHIPCert_test_vectors.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace chip;
+using namespace chip::ASN1;
+using namespace chip::Credentials;
+using namespace chip::TestCerts;
+
+namespace {
+
+constexpr uint8_t kStandardCertsCount = 3;
+constexpr uint16_t kTestCertBufSize   = 1024;
+constexpr uint32_t kDefaultIterations = 1000;
+constexpr uint8_t kValidationCacheSize = 8;
+
+CHIP_ERROR LoadStandardCerts(ChipCertificateSet & certSet)
+{
+    CHIP_ERROR err;
+
+    err = LoadTestCert(certSet, TestCertTypes::kRoot, BitFlags<TestCertLoadFlags>(),
+                       BitFlags<CertDecodeFlags>(CertDecodeFlags::kIsTrustAnchor));
+    SuccessOrExit(err);
+
+    err = LoadTestCert(certSet, TestCertTypes::kNodeCA, BitFlags<TestCertLoadFlags>(),
+                       BitFlags<CertDecodeFlags>(CertDecodeFlags::kGenerateTBSHash));
+    SuccessOrExit(err);
+
+    err = LoadTestCert(certSet, TestCertTypes::kNode01, BitFlags<TestCertLoadFlags>(),
+                       BitFlags<CertDecodeFlags>(CertDecodeFlags::kGenerateTBSHash));
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+CHIP_ERROR RunValidations(ChipCertificateSet & certSet, ValidationContext & validContext, uint32_t iterations, const char * label)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    uint64_t start = System::Platform::Layer::GetClock_MonotonicHiRes();
+    uint64_t elapsedUs;
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        err = certSet.ValidateCert(certSet.GetLastCert(), validContext);
+        SuccessOrExit(err);
+    }
+
+    elapsedUs = System::Platform::Layer::GetClock_MonotonicHiRes() - start;
+    if (elapsedUs == 0)
+    {
+        elapsedUs = 1;
+    }
+
+    printf("%-28s %8" PRIu32 " chains in %10" PRIu64 " us: %10.1f chains/sec\n", label, iterations, elapsedUs,
+           static_cast<double>(iterations) * System::kTimerFactor_micro_per_unit / static_cast<double>(elapsedUs));
+
+exit:
+    return err;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    CHIP_ERROR err;
+    ChipCertificateSet certSet;
+    ValidationContext validContext;
+    Crypto::P256ECDSAVerifier verifier;
+    CertValidationCache cache;
+    ASN1UniversalTime effectiveTime;
+    uint32_t iterations = kDefaultIterations;
+
+    if (argc > 1)
+    {
+        iterations = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    }
+
+    err = Platform::MemoryInit();
+    SuccessOrExit(err);
+
+    err = certSet.Init(kStandardCertsCount, kTestCertBufSize);
+    SuccessOrExit(err);
+
+    err = LoadStandardCerts(certSet);
+    SuccessOrExit(err);
+
+    effectiveTime.Year   = 2021;
+    effectiveTime.Month  = 1;
+    effectiveTime.Day    = 1;
+    effectiveTime.Hour   = 0;
+    effectiveTime.Minute = 0;
+    effectiveTime.Second = 0;
+
+    validContext.Reset();
+    validContext.mRequiredKeyUsages.Set(KeyUsageFlags::kDigitalSignature);
+    validContext.mRequiredKeyPurposes.Set(KeyPurposeFlags::kServerAuth);
+    err = ASN1ToChipEpochTime(effectiveTime, validContext.mEffectiveTime);
+    SuccessOrExit(err);
+
+    err = RunValidations(certSet, validContext, iterations, "Per-signature curve setup");
+    SuccessOrExit(err);
+
+    err = verifier.Init();
+    SuccessOrExit(err);
+
+    validContext.mVerifier = &verifier;
+    err                    = RunValidations(certSet, validContext, iterations, "Verifier, no trusted keys");
+    SuccessOrExit(err);
+
+    err = certSet.AddTrustAnchorsToVerifier(verifier);
+    SuccessOrExit(err);
+
+    err = RunValidations(certSet, validContext, iterations, "Verifier, trusted root key");
+    SuccessOrExit(err);
+
+    err = cache.Init(kValidationCacheSize);
+    SuccessOrExit(err);
+
+    validContext.mValidationCache = &cache;
+    err                           = RunValidations(certSet, validContext, iterations, "Validated certificate cache");
+    SuccessOrExit(err);
+
+    printf("Validated certificate cache: %" PRIu32 " hits, %" PRIu32 " misses\n", cache.GetHitCount(), cache.GetMissCount());
+
+exit:
+    cache.Release();
+    verifier.Clear();
+    certSet.Release();
+    Platform::MemoryShutdown();
+
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Certificate validation benchmark failed: %s\n", ErrorStr(err));
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Benchmark measuring X.509 <-> CHIP certificate conversion throughput
+ *      over the certificate test vectors, one certificate at a time and as
+ *      a streamed bundle.
+ *
+ */
+
+#include <core/CHIPTLV.h>
+#include <credentials/CHIPCert.h>
+#include <protocols/Protocols.h>
+#include <support/CodeUtils.h>
+#include <support/ErrorStr.h>
+#include <system/SystemClock.h>
+
+#include "CHIPCert_test_vectors.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace chip;
+using namespace chip::Credentials;
+using namespace chip::TestCerts;
+using namespace chip::TLV;
+
+namespace {
+
+constexpr uint16_t kTestCertBufSize   = 1024;
+constexpr uint32_t kBundleBufSize     = 4 * kTestCertBufSize;
+constexpr uint32_t kDefaultIterations = 10000;
+
+const BitFlags<TestCertLoadFlags> sNullLoadFlag;
+const BitFlags<TestCertLoadFlags> sDerFormFlag(TestCertLoadFlags::kDERForm);
+
+uint8_t sX509Bundle[kBundleBufSize];
+uint32_t sX509BundleLen;
+uint8_t sChipBundle[kBundleBufSize];
+uint32_t sChipBundleLen;
+
+void PrintResult(const char * label, uint32_t certCount, uint64_t inputBytes, uint64_t startUs)
+{
+    uint64_t elapsedUs = System::Platform::Layer::GetClock_MonotonicHiRes() - startUs;
+    if (elapsedUs == 0)
+    {
+        elapsedUs = 1;
+    }
+
+    printf("%-28s %8" PRIu32 " certs in %10" PRIu64 " us: %12.1f certs/sec %10.1f KiB/sec\n", label, certCount, elapsedUs,
+           static_cast<double>(certCount) * System::kTimerFactor_micro_per_unit / static_cast<double>(elapsedUs),
+           static_cast<double>(inputBytes) * System::kTimerFactor_micro_per_unit / 1024.0 / static_cast<double>(elapsedUs));
+}
+
+CHIP_ERROR BuildBundles()
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    const uint8_t * cert;
+    uint32_t certLen;
+    TLVWriter writer;
+
+    sX509BundleLen = 0;
+    for (size_t i = 0; i < gNumTestCerts; i++)
+    {
+        err = GetTestCert(gTestCerts[i], sDerFormFlag, cert, certLen);
+        SuccessOrExit(err);
+
+        VerifyOrExit(sX509BundleLen + certLen <= sizeof(sX509Bundle), err = CHIP_ERROR_BUFFER_TOO_SMALL);
+        memcpy(&sX509Bundle[sX509BundleLen], cert, certLen);
+        sX509BundleLen += certLen;
+    }
+
+    writer.Init(sChipBundle, sizeof(sChipBundle));
+
+    err = ConvertX509CertsToChipCerts(sX509Bundle, sX509BundleLen, writer,
+                                      ProfileTag(Protocols::kProtocol_OpCredentials, kTag_ChipCertificateArray));
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+    SuccessOrExit(err);
+
+    sChipBundleLen = writer.GetLengthWritten();
+
+exit:
+    return err;
+}
+
+CHIP_ERROR RunPerCertConversions(uint32_t iterations, bool toChip)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    uint8_t outBuf[kTestCertBufSize];
+    uint32_t outLen;
+    uint64_t inputBytes = 0;
+    uint64_t start      = System::Platform::Layer::GetClock_MonotonicHiRes();
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        for (size_t j = 0; j < gNumTestCerts; j++)
+        {
+            const uint8_t * cert;
+            uint32_t certLen;
+
+            err = GetTestCert(gTestCerts[j], toChip ? sDerFormFlag : sNullLoadFlag, cert, certLen);
+            SuccessOrExit(err);
+
+            if (toChip)
+            {
+                err = ConvertX509CertToChipCert(cert, certLen, outBuf, sizeof(outBuf), outLen);
+            }
+            else
+            {
+                err = ConvertChipCertToX509Cert(cert, certLen, outBuf, sizeof(outBuf), outLen);
+            }
+            SuccessOrExit(err);
+
+            inputBytes += certLen;
+        }
+    }
+
+    PrintResult(toChip ? "X.509 -> CHIP, per cert" : "CHIP -> X.509, per cert", static_cast<uint32_t>(iterations * gNumTestCerts),
+                inputBytes, start);
+
+exit:
+    return err;
+}
+
+CHIP_ERROR RunX509BundleConversions(uint32_t iterations)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    TLVWriter writer;
+    uint64_t start = System::Platform::Layer::GetClock_MonotonicHiRes();
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        writer.Init(sChipBundle, sizeof(sChipBundle));
+
+        err = ConvertX509CertsToChipCerts(sX509Bundle, sX509BundleLen, writer,
+                                          ProfileTag(Protocols::kProtocol_OpCredentials, kTag_ChipCertificateArray));
+        SuccessOrExit(err);
+
+        err = writer.Finalize();
+        SuccessOrExit(err);
+    }
+
+    PrintResult("X.509 -> CHIP, bundle", static_cast<uint32_t>(iterations * gNumTestCerts),
+                static_cast<uint64_t>(iterations) * sX509BundleLen, start);
+
+exit:
+    return err;
+}
+
+CHIP_ERROR CountX509Cert(void * context, const uint8_t * x509Cert, uint32_t x509CertLen)
+{
+    *static_cast<uint64_t *>(context) += x509CertLen;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR RunChipBundleConversions(uint32_t iterations)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    TLVReader reader;
+    uint8_t x509CertBuf[kTestCertBufSize];
+    uint64_t outputBytes = 0;
+    uint64_t start       = System::Platform::Layer::GetClock_MonotonicHiRes();
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        reader.Init(sChipBundle, sChipBundleLen);
+
+        err = ConvertChipCertsToX509Certs(reader, x509CertBuf, sizeof(x509CertBuf), CountX509Cert, &outputBytes);
+        SuccessOrExit(err);
+    }
+
+    VerifyOrExit(outputBytes == static_cast<uint64_t>(iterations) * sX509BundleLen, err = CHIP_ERROR_INTERNAL);
+
+    PrintResult("CHIP -> X.509, bundle", static_cast<uint32_t>(iterations * gNumTestCerts),
+                static_cast<uint64_t>(iterations) * sChipBundleLen, start);
+
+exit:
+    return err;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    CHIP_ERROR err;
+    uint32_t iterations = kDefaultIterations;
+
+    if (argc > 1)
+    {
+        iterations = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    }
+
+    err = BuildBundles();
+    SuccessOrExit(err);
+
+    printf("Bundle of %u certificates: %" PRIu32 " bytes X.509, %" PRIu32 " bytes CHIP\n", static_cast<unsigned>(gNumTestCerts),
+           sX509BundleLen, sChipBundleLen);
+
+    err = RunPerCertConversions(iterations, true);
+    SuccessOrExit(err);
+
+    err = RunX509BundleConversions(iterations);
+    SuccessOrExit(err);
+
+    err = RunPerCertConversions(iterations, false);
+    SuccessOrExit(err);
+
+    err = RunChipBundleConversions(iterations);
+    SuccessOrExit(err);
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Certificate conversion benchmark failed: %s\n", ErrorStr(err));
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
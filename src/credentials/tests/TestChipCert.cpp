@@ -26,6 +26,8 @@
 
 #include <core/CHIPTLV.h>
 #include <credentials/CHIPCert.h>
+#include <credentials/CHIPCertValidationCache.h>
+#include <protocols/Protocols.h>
 #include <support/CHIPMem.h>
 #include <support/CodeUtils.h>
 #include <support/ErrorStr.h>
@@ -186,6 +188,82 @@ static void TestChipCert_X509ToChip(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+struct X509BundleCheckState
+{
+    nlTestSuite * mSuite;
+    size_t mCertIndex;
+};
+
+static CHIP_ERROR CheckBundleX509Cert(void * context, const uint8_t * x509Cert, uint32_t x509CertLen)
+{
+    X509BundleCheckState * state = static_cast<X509BundleCheckState *>(context);
+    const uint8_t * expectedCert;
+    uint32_t expectedCertLen;
+    CHIP_ERROR err;
+
+    VerifyOrExit(state->mCertIndex < gNumTestCerts, err = CHIP_ERROR_INTERNAL);
+
+    err = GetTestCert(gTestCerts[state->mCertIndex], sDerFormFlag, expectedCert, expectedCertLen);
+    SuccessOrExit(err);
+
+    NL_TEST_ASSERT(state->mSuite, x509CertLen == expectedCertLen);
+    NL_TEST_ASSERT(state->mSuite, memcmp(x509Cert, expectedCert, x509CertLen) == 0);
+
+    state->mCertIndex++;
+
+exit:
+    return err;
+}
+
+static void TestChipCert_CertBundleConversion(nlTestSuite * inSuite, void * inContext)
+{
+    CHIP_ERROR err;
+    const uint8_t * inCert;
+    uint32_t inCertLen;
+    uint8_t x509Bundle[kTestCertBufSize * 4];
+    uint32_t x509BundleLen = 0;
+    uint8_t chipBundle[kTestCertBufSize * 4];
+    uint8_t x509CertBuf[kTestCertBufSize];
+    X509BundleCheckState state = { inSuite, 0 };
+    TLVWriter writer;
+    TLVReader reader;
+    ChipCertificateSet certSet;
+
+    for (size_t i = 0; i < gNumTestCerts; i++)
+    {
+        err = GetTestCert(gTestCerts[i], sDerFormFlag, inCert, inCertLen);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, x509BundleLen + inCertLen <= sizeof(x509Bundle));
+        memcpy(&x509Bundle[x509BundleLen], inCert, inCertLen);
+        x509BundleLen += inCertLen;
+    }
+
+    writer.Init(chipBundle, sizeof(chipBundle));
+    err = ConvertX509CertsToChipCerts(x509Bundle, x509BundleLen, writer,
+                                      ProfileTag(Protocols::kProtocol_OpCredentials, kTag_ChipCertificateArray));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = writer.Finalize();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // The converted bundle must load as a certificate array.
+    err = certSet.Init(static_cast<uint8_t>(gNumTestCerts), kTestCertBufSize);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = certSet.LoadCerts(chipBundle, writer.GetLengthWritten(), sNullDecodeFlag);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, certSet.GetCertCount() == gNumTestCerts);
+    certSet.Release();
+
+    reader.Init(chipBundle, writer.GetLengthWritten());
+    err = ConvertChipCertsToX509Certs(reader, x509CertBuf, sizeof(x509CertBuf), CheckBundleX509Cert, &state);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, state.mCertIndex == gNumTestCerts);
+
+    // A truncated X.509 bundle must be rejected.
+    writer.Init(chipBundle, sizeof(chipBundle));
+    err = ConvertX509CertsToChipCerts(x509Bundle, x509BundleLen - 1, writer, AnonymousTag);
+    NL_TEST_ASSERT(inSuite, err != CHIP_NO_ERROR);
+}
+
 static void TestChipCert_CertValidation(nlTestSuite * inSuite, void * inContext)
 {
     CHIP_ERROR err;
@@ -466,6 +544,167 @@ static void TestChipCert_CertValidTime(nlTestSuite * inSuite, void * inContext)
     certSet.Release();
 }
 
+static void TestChipCert_CertValidationWithVerifier(nlTestSuite * inSuite, void * inContext)
+{
+    CHIP_ERROR err;
+    ChipCertificateSet certSet;
+    ValidationContext validContext;
+    chip::Crypto::P256ECDSAVerifier verifier;
+
+    certSet.Init(kStandardCertsCount, kTestCertBufSize);
+
+    err = LoadStandardCerts(certSet);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    err = verifier.Init();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    err = certSet.AddTrustAnchorsToVerifier(verifier);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    validContext.Reset();
+    validContext.mRequiredKeyUsages.Set(KeyUsageFlags::kDigitalSignature);
+    validContext.mRequiredKeyPurposes.Set(KeyPurposeFlags::kServerAuth);
+    validContext.mVerifier = &verifier;
+
+    err = SetEffectiveTime(validContext, 2021, 1, 1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // Validate the same chain repeatedly through the long-lived verification context.
+    for (int i = 0; i < 3; i++)
+    {
+        err = certSet.ValidateCert(certSet.GetLastCert(), validContext);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, validContext.mTrustAnchor == &certSet.GetCertSet()[0]);
+    }
+
+    // A corrupted TBS hash must still fail signature verification.
+    ChipCertificateData * leafCert = const_cast<ChipCertificateData *>(certSet.GetLastCert());
+    leafCert->mTBSHash[0]          = static_cast<uint8_t>(~leafCert->mTBSHash[0]);
+    err                            = certSet.ValidateCert(certSet.GetLastCert(), validContext);
+    NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_INVALID_SIGNATURE);
+
+    certSet.Release();
+}
+
+static void TestChipCert_FindCertByKeyId(nlTestSuite * inSuite, void * inContext)
+{
+    CHIP_ERROR err;
+    ChipCertificateSet certSet;
+
+    certSet.Init(kStandardCertsCount, kTestCertBufSize);
+
+    err = LoadStandardCerts(certSet);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    for (uint8_t i = 0; i < certSet.GetCertCount(); i++)
+    {
+        const ChipCertificateData * cert = &certSet.GetCertSet()[i];
+        NL_TEST_ASSERT(inSuite, certSet.FindCert(cert->mSubjectKeyId) == cert);
+    }
+
+    // The index must be emptied together with the set.
+    CertificateKeyId rootKeyId = certSet.GetCertSet()[0].mSubjectKeyId;
+    certSet.Clear();
+    NL_TEST_ASSERT(inSuite, certSet.FindCert(rootKeyId) == nullptr);
+
+    // Certificates loaded after clearing the set must be found again.
+    err = LoadStandardCerts(certSet);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, certSet.FindCert(certSet.GetCertSet()[0].mSubjectKeyId) == &certSet.GetCertSet()[0]);
+    NL_TEST_ASSERT(inSuite, certSet.FindCert(certSet.GetLastCert()->mSubjectKeyId) == certSet.GetLastCert());
+
+    certSet.Release();
+
+    // Re-initializing with caller provided memory drops the index sized for the earlier set.
+    ChipCertificateData certs[kStandardCertsCount];
+    uint8_t decodeBuf[kTestCertBufSize];
+
+    err = certSet.Init(1, kTestCertBufSize);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = certSet.Init(certs, kStandardCertsCount, decodeBuf, sizeof(decodeBuf));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    err = LoadStandardCerts(certSet);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    for (uint8_t i = 0; i < certSet.GetCertCount(); i++)
+    {
+        NL_TEST_ASSERT(inSuite, certSet.FindCert(certs[i].mSubjectKeyId) == &certs[i]);
+    }
+}
+
+static void TestChipCert_CertValidationWithCache(nlTestSuite * inSuite, void * inContext)
+{
+    CHIP_ERROR err;
+    ChipCertificateSet certSet;
+    ValidationContext validContext;
+    CertValidationCache cache;
+
+    certSet.Init(kStandardCertsCount, kTestCertBufSize);
+
+    err = LoadStandardCerts(certSet);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    err = cache.Init(4);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    validContext.Reset();
+    validContext.mRequiredKeyUsages.Set(KeyUsageFlags::kDigitalSignature);
+    validContext.mRequiredKeyPurposes.Set(KeyPurposeFlags::kServerAuth);
+    validContext.mValidationCache = &cache;
+
+    err = SetEffectiveTime(validContext, 2021, 1, 1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // The first validation walks the whole chain and records the leaf and CA certificates.
+    err = certSet.ValidateCert(certSet.GetLastCert(), validContext);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, validContext.mTrustAnchor == &certSet.GetCertSet()[0]);
+    NL_TEST_ASSERT(inSuite, cache.GetHitCount() == 0);
+
+    // Subsequent validations are answered from the cache.
+    for (uint32_t i = 1; i <= 3; i++)
+    {
+        validContext.mTrustAnchor = nullptr;
+        err                       = certSet.ValidateCert(certSet.GetLastCert(), validContext);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, validContext.mTrustAnchor == &certSet.GetCertSet()[0]);
+        NL_TEST_ASSERT(inSuite, cache.GetHitCount() == i);
+    }
+
+    // A cached result does not bypass the validity period of the chain.
+    err = SetEffectiveTime(validContext, 2042, 4, 25);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = certSet.ValidateCert(certSet.GetLastCert(), validContext);
+    NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_CERT_EXPIRED);
+
+    err = SetEffectiveTime(validContext, 2021, 1, 1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // A certificate with a different TBS hash does not match the cached entry and fails signature verification.
+    ChipCertificateData * leafCert = const_cast<ChipCertificateData *>(certSet.GetLastCert());
+    leafCert->mTBSHash[0]          = static_cast<uint8_t>(~leafCert->mTBSHash[0]);
+    err                            = certSet.ValidateCert(certSet.GetLastCert(), validContext);
+    NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_INVALID_SIGNATURE);
+    leafCert->mTBSHash[0] = static_cast<uint8_t>(~leafCert->mTBSHash[0]);
+
+    // A cached result is not used by a set that does not trust the root the chain was validated against.
+    certSet.Clear();
+
+    err = LoadTestCert(certSet, TestCertTypes::kRoot, sNullLoadFlag, sNullDecodeFlag);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = LoadTestCert(certSet, TestCertTypes::kNodeCA, sNullLoadFlag, sGenTBSHashFlag);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = LoadTestCert(certSet, TestCertTypes::kNode01, sNullLoadFlag, sGenTBSHashFlag);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    err = certSet.ValidateCert(certSet.GetLastCert(), validContext);
+    NL_TEST_ASSERT(inSuite, err != CHIP_NO_ERROR);
+
+    cache.Release();
+    certSet.Release();
+}
+
 static void TestChipCert_CertUsage(nlTestSuite * inSuite, void * inContext)
 {
     CHIP_ERROR err;
@@ -642,8 +881,12 @@ int TestChipCert_Teardown(void * inContext)
 static const nlTest sTests[] = {
     NL_TEST_DEF("Test CHIP Certificate CHIP to X509 Conversion", TestChipCert_ChipToX509),
     NL_TEST_DEF("Test CHIP Certificate X509 to CHIP Conversion", TestChipCert_X509ToChip),
+    NL_TEST_DEF("Test CHIP Certificate Bundle Conversion", TestChipCert_CertBundleConversion),
     NL_TEST_DEF("Test CHIP Certificate Validation", TestChipCert_CertValidation),
     NL_TEST_DEF("Test CHIP Certificate Validation time", TestChipCert_CertValidTime),
+    NL_TEST_DEF("Test CHIP Certificate Validation with verifier", TestChipCert_CertValidationWithVerifier),
+    NL_TEST_DEF("Test CHIP Certificate Lookup by Key Id", TestChipCert_FindCertByKeyId),
+    NL_TEST_DEF("Test CHIP Certificate Validation with cache", TestChipCert_CertValidationWithCache),
     NL_TEST_DEF("Test CHIP Certificate Usage", TestChipCert_CertUsage),
     NL_TEST_DEF("Test CHIP Certificate Type", TestChipCert_CertType),
     NL_TEST_SENTINEL()
@@ -21,6 +21,7 @@
  */
 
 #include "CHIPCryptoPAL.h"
+#include <core/CHIPSafeCasts.h>
 #include <string.h>
 #include <support/CodeUtils.h>
 
@@ -90,10 +91,7 @@ CHIP_ERROR Spake2p::Init(const uint8_t * context, size_t context_len)
     error = InitImpl();
     VerifyOrExit(error == CHIP_NO_ERROR, error = CHIP_ERROR_INTERNAL);
 
-    error = PointLoad(spake2p_M_p256, sizeof(spake2p_M_p256), M);
-    VerifyOrExit(error == CHIP_NO_ERROR, error = CHIP_ERROR_INTERNAL);
-
-    error = PointLoad(spake2p_N_p256, sizeof(spake2p_N_p256), N);
+    error = LoadMN();
     VerifyOrExit(error == CHIP_NO_ERROR, error = CHIP_ERROR_INTERNAL);
 
     error = InternalHash(context, context_len);
@@ -105,6 +103,21 @@ exit:
     return error;
 }
 
+CHIP_ERROR Spake2p::LoadMN()
+{
+    CHIP_ERROR error = CHIP_ERROR_INTERNAL;
+
+    error = PointLoad(spake2p_M_p256, sizeof(spake2p_M_p256), M);
+    VerifyOrExit(error == CHIP_NO_ERROR, error = CHIP_ERROR_INTERNAL);
+
+    error = PointLoad(spake2p_N_p256, sizeof(spake2p_N_p256), N);
+    VerifyOrExit(error == CHIP_NO_ERROR, error = CHIP_ERROR_INTERNAL);
+
+    error = CHIP_NO_ERROR;
+exit:
+    return error;
+}
+
 CHIP_ERROR Spake2p::WriteMN()
 {
     CHIP_ERROR error = CHIP_ERROR_INTERNAL;
@@ -440,5 +453,54 @@ exit:
     return error;
 }
 
+int P256ECDSAVerifier::FindTrustedKey(const P256PublicKey & key) const
+{
+    for (size_t i = 0; i < mTrustedKeyCount; i++)
+    {
+        if (memcmp(Uint8::to_const_uchar(mTrustedKeys[i]), Uint8::to_const_uchar(key), key.Length()) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+bool P256ECDSAVerifier::IsTrustedKey(const P256PublicKey & key) const
+{
+    return FindTrustedKey(key) >= 0;
+}
+
+CHIP_ERROR P256ECDSAVerifier::ECDSA_validate_hash_signatures(P256ECDSAVerifyRequest * requests, size_t request_count)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+
+    VerifyOrExit(requests != nullptr || request_count == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(mInitialized, error = CHIP_ERROR_INCORRECT_STATE);
+
+    for (size_t i = 0; i < request_count; i++)
+    {
+        P256ECDSAVerifyRequest & request = requests[i];
+
+        if (request.mPublicKey == nullptr || request.mSignature == nullptr)
+        {
+            request.mResult = CHIP_ERROR_INVALID_ARGUMENT;
+        }
+        else
+        {
+            request.mResult =
+                ECDSA_validate_hash_signature(*request.mPublicKey, request.mHash, request.mHashLength, *request.mSignature);
+        }
+
+        if (error == CHIP_NO_ERROR)
+        {
+            error = request.mResult;
+        }
+    }
+
+exit:
+    return error;
+}
+
 } // namespace Crypto
 } // namespace chip
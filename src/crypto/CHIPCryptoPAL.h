@@ -57,9 +57,12 @@ const size_t kP256_PublicKey_Length  = 65;
  * in a public interface file. The validity of these sizes is verified by static_assert in
  * the implementation files.
  */
-const size_t kMAX_Spake2p_Context_Size     = 1024;
-const size_t kMAX_Hash_SHA256_Context_Size = 296;
-const size_t kMAX_P256Keypair_Context_Size = 512;
+const size_t kMAX_Spake2p_Context_Size           = 1024;
+const size_t kMAX_Hash_SHA256_Context_Size       = 296;
+const size_t kMAX_P256Keypair_Context_Size       = 512;
+const size_t kMAX_P256ECDSAVerifier_Context_Size = 1024;
+
+const size_t kMax_P256ECDSAVerifier_TrustedKeys = 4;
 
 /**
  * Spake2+ parameters for P256
@@ -302,6 +305,87 @@ private:
     bool mInitialized = false;
 };
 
+/**
+ * @brief A single entry of a batched ECDSA signature verification.
+ **/
+struct P256ECDSAVerifyRequest
+{
+    const P256PublicKey * mPublicKey;      /**< Public key of the signer. */
+    const uint8_t * mHash;                 /**< SHA-256 hash of the signed data. */
+    size_t mHashLength;                    /**< Length of mHash, must be kSHA256_Hash_Length. */
+    const P256ECDSASignature * mSignature; /**< ASN.1 DER encoded signature. */
+    CHIP_ERROR mResult;                    /**< Verification result, set by the verifier. */
+};
+
+struct alignas(size_t) P256ECDSAVerifierContext
+{
+    uint8_t mBytes[kMAX_P256ECDSAVerifier_Context_Size];
+};
+
+/**
+ * @brief A long-lived P-256 ECDSA verification context.
+ *
+ *        The context loads the curve group once and keeps it, together with any precomputed
+ *        multiplication tables the underlying crypto library maintains for it, for the lifetime
+ *        of the object. Trusted public keys (e.g. root CA keys) can be registered up front so that
+ *        they are parsed and validated only once, instead of on every signature verification.
+ **/
+class P256ECDSAVerifier
+{
+public:
+    P256ECDSAVerifier() {}
+    ~P256ECDSAVerifier();
+
+    /** @brief Initialize the verifier and load the curve group.
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR Init();
+
+    /** @brief Release all resources held by the verifier, including registered trusted keys.
+     **/
+    void Clear();
+
+    /** @brief Register a public key that is expected to verify many signatures.
+     *         The key is checked once when it is added and is not re-validated later.
+     * @param key Public key to register
+     * @return Returns CHIP_ERROR_NO_MEMORY if the trusted key table is full, CHIP_ERROR_INVALID_ARGUMENT
+     *         if the key is not a valid point on the curve, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR AddTrustedKey(const P256PublicKey & key);
+
+    /** @brief Return true if the key was registered with AddTrustedKey().
+     **/
+    bool IsTrustedKey(const P256PublicKey & key) const;
+
+    /**
+     * @brief Verify an ECDSA signature over a hash using the cached curve context.
+     * @param key Public key of the signer
+     * @param hash Hash that was signed
+     * @param hash_length Length of hash
+     * @param signature ASN.1 DER encoded signature
+     * @return Returns CHIP_ERROR_INVALID_SIGNATURE if the signature does not match, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR ECDSA_validate_hash_signature(const P256PublicKey & key, const uint8_t * hash, size_t hash_length,
+                                             const P256ECDSASignature & signature);
+
+    /**
+     * @brief Verify several ECDSA signatures in one call.
+     *        Every request is processed and its mResult member is set, even if an earlier request failed.
+     * @param requests Array of verification requests
+     * @param request_count Number of entries in requests
+     * @return Returns the error of the first failed request, CHIP_NO_ERROR if all signatures are valid
+     **/
+    CHIP_ERROR ECDSA_validate_hash_signatures(P256ECDSAVerifyRequest * requests, size_t request_count);
+
+private:
+    int FindTrustedKey(const P256PublicKey & key) const;
+
+    P256PublicKey mTrustedKeys[kMax_P256ECDSAVerifier_TrustedKeys];
+    size_t mTrustedKeyCount = 0;
+    P256ECDSAVerifierContext mContext;
+    bool mInitialized = false;
+};
+
 /**
  * @brief A function that implements AES-CCM encryption
  * @param plaintext Plaintext to encrypt
@@ -341,6 +425,52 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
                            const uint8_t * tag, size_t tag_length, const uint8_t * key, size_t key_length, const uint8_t * iv,
                            size_t iv_length, uint8_t * plaintext);
 
+/**
+ * @brief One message of a batched AES-CCM operation.
+ **/
+struct AES_CCM_BatchEntry
+{
+    const uint8_t * key;   /**< Encryption key. */
+    size_t key_length;     /**< Length of the key (in bytes). */
+    const uint8_t * iv;    /**< Initial vector. */
+    size_t iv_length;      /**< Length of the initial vector. */
+    const uint8_t * aad;   /**< Additional authentication data, may be NULL if aad_length is 0. */
+    size_t aad_length;     /**< Length of the additional authentication data. */
+    const uint8_t * input; /**< Plaintext to encrypt or ciphertext to decrypt. */
+    size_t input_length;   /**< Length of the input; the output has the same length. */
+    uint8_t * output;      /**< Buffer receiving the ciphertext or plaintext. May be the same as input. */
+    uint8_t * tag;         /**< Tag written by encryption, or checked by decryption. */
+    size_t tag_length;     /**< Length of the tag. */
+    CHIP_ERROR status;     /**< Result of the operation on this message, set by the batch function. */
+};
+
+/**
+ * @brief Encrypt several independent messages with AES-CCM.
+ *
+ *        The result is the same as calling AES_CCM_encrypt() on each entry, but per-call setup is shared across
+ *        the batch, and the key schedule is reused while consecutive entries use the same key. Sorting entries by
+ *        key therefore helps, e.g. for the same group message sent to many peers.
+ *
+ *        All entries are processed even if some of them fail.
+ *
+ * @param entries Messages to encrypt. The status of each entry is updated.
+ * @param entry_count Number of entries
+ * @return CHIP_NO_ERROR if every entry was encrypted, otherwise the status of the first entry that failed
+ **/
+CHIP_ERROR AES_CCM_encrypt_batch(AES_CCM_BatchEntry * entries, size_t entry_count);
+
+/**
+ * @brief Decrypt and authenticate several independent messages with AES-CCM.
+ *
+ *        The result is the same as calling AES_CCM_decrypt() on each entry; see AES_CCM_encrypt_batch().
+ *        The output of an entry whose tag does not verify must not be used.
+ *
+ * @param entries Messages to decrypt. The status of each entry is updated.
+ * @param entry_count Number of entries
+ * @return CHIP_NO_ERROR if every entry was decrypted, otherwise the status of the first entry that failed
+ **/
+CHIP_ERROR AES_CCM_decrypt_batch(AES_CCM_BatchEntry * entries, size_t entry_count);
+
 /**
  * @brief A function that implements SHA-256 hash
  * @param data The data to hash
@@ -723,6 +853,16 @@ protected:
      **/
     virtual CHIP_ERROR InitImpl() = 0;
 
+    /**
+     * @brief Set the M and N points after InitImpl().
+     *
+     * @details The default implementation decodes spake2p_M_p256 and spake2p_N_p256 with PointLoad().
+     *          Implementations keeping decoded copies of the points may copy them instead.
+     *
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    virtual CHIP_ERROR LoadMN();
+
     /**
      * @brief Hash in_len bytes of in into the internal hash context.
      *
@@ -834,6 +974,7 @@ public:
 
 protected:
     CHIP_ERROR InitImpl() override;
+    CHIP_ERROR LoadMN() override;
     CHIP_ERROR Hash(const uint8_t * in, size_t in_len) override;
     CHIP_ERROR HashFinalize(uint8_t * out) override;
     CHIP_ERROR KDF(const uint8_t * secret, size_t secret_length, const uint8_t * salt, size_t salt_length, const uint8_t * info,
@@ -121,6 +121,105 @@ static const EVP_MD * _digestForType(DigestType digestType)
     }
 }
 
+/*
+ * Long-lived P-256 curve shared by all keypairs and Spake2p sessions.
+ *
+ * The group is built once with its generator multiples precomputed, and the SPAKE2+ M and N points
+ * are decoded once. The context is never modified after initialization, so it can be used
+ * concurrently; callers that need M or N in a mutable form must copy them. It is freed when static
+ * objects are destroyed at process exit, ahead of OpenSSL's own atexit cleanup.
+ */
+struct P256SharedCurve
+{
+    EC_GROUP * group = nullptr;
+    EC_POINT * M     = nullptr;
+    EC_POINT * N     = nullptr;
+
+    ~P256SharedCurve()
+    {
+        EC_POINT_free(N);
+        EC_POINT_free(M);
+        EC_GROUP_free(group);
+    }
+};
+
+static CHIP_ERROR _initP256SharedCurve(P256SharedCurve & curve)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 0;
+    BN_CTX * bn_ctx  = nullptr;
+
+    curve.group = EC_GROUP_new_by_curve_name(_nidForCurve(ECName::P256v1));
+    VerifyOrExit(curve.group != nullptr, error = CHIP_ERROR_INTERNAL);
+
+    bn_ctx = BN_CTX_new();
+    VerifyOrExit(bn_ctx != nullptr, error = CHIP_ERROR_NO_MEMORY);
+
+    result = EC_GROUP_precompute_mult(curve.group, bn_ctx);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    curve.M = EC_POINT_new(curve.group);
+    VerifyOrExit(curve.M != nullptr, error = CHIP_ERROR_NO_MEMORY);
+
+    result = EC_POINT_oct2point(curve.group, curve.M, Uint8::to_const_uchar(spake2p_M_p256), sizeof(spake2p_M_p256), bn_ctx);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    curve.N = EC_POINT_new(curve.group);
+    VerifyOrExit(curve.N != nullptr, error = CHIP_ERROR_NO_MEMORY);
+
+    result = EC_POINT_oct2point(curve.group, curve.N, Uint8::to_const_uchar(spake2p_N_p256), sizeof(spake2p_N_p256), bn_ctx);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+exit:
+    BN_CTX_free(bn_ctx);
+    if (error != CHIP_NO_ERROR)
+    {
+        EC_POINT_free(curve.N);
+        EC_POINT_free(curve.M);
+        EC_GROUP_free(curve.group);
+        curve.N     = nullptr;
+        curve.M     = nullptr;
+        curve.group = nullptr;
+    }
+    return error;
+}
+
+static const P256SharedCurve * _getP256SharedCurve()
+{
+    static P256SharedCurve sCurve;
+    static const bool sInitialized = (_initP256SharedCurve(sCurve) == CHIP_NO_ERROR);
+
+    return sInitialized ? &sCurve : nullptr;
+}
+
+// Decode an uncompressed P-256 public key into a point of the shared curve. Caller must free out_point.
+static CHIP_ERROR _create_point_from_binary_p256_key(const P256SharedCurve * curve, const P256PublicKey & key,
+                                                     EC_POINT ** out_point)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 0;
+    EC_POINT * point = nullptr;
+
+    VerifyOrExit(*out_point == nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(key.Type() == SupportedECPKeyTypes::ECP256R1, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    point = EC_POINT_new(curve->group);
+    VerifyOrExit(point != nullptr, error = CHIP_ERROR_NO_MEMORY);
+
+    // Decoding checks that the point is on the curve. As the cofactor of P-256 is 1, that and
+    // not being the point at infinity is a full public key validation.
+    result = EC_POINT_oct2point(curve->group, point, Uint8::to_const_uchar(key), key.Length(), nullptr);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(EC_POINT_is_at_infinity(curve->group, point) == 0, error = CHIP_ERROR_INTERNAL);
+
+    *out_point = point;
+    point      = nullptr;
+
+exit:
+    EC_POINT_free(point);
+    return error;
+}
+
 CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
                            const uint8_t * key, size_t key_length, const uint8_t * iv, size_t iv_length, uint8_t * ciphertext,
                            uint8_t * tag, size_t tag_length)
@@ -281,6 +380,145 @@ exit:
     return error;
 }
 
+static CHIP_ERROR _checkAesCcmBatchEntry(const AES_CCM_BatchEntry & entry)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+
+    VerifyOrExit(entry.input != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.input_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(CanCastTo<int>(entry.input_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.output != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.key != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(_isValidKeyLength(entry.key_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.iv != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.iv_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(CanCastTo<int>(entry.iv_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(_isValidTagLength(entry.tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.aad_length == 0 || entry.aad != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(CanCastTo<int>(entry.aad_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+
+exit:
+    return error;
+}
+
+// OpenSSL fixes the nonce and tag lengths of CCM when the key is set, so the key schedule of the
+// previous entry can only be reused if all of them match.
+static bool _canReuseAesCcmKey(const AES_CCM_BatchEntry & entry, const AES_CCM_BatchEntry * previous)
+{
+    return previous != nullptr && previous->key_length == entry.key_length && previous->iv_length == entry.iv_length &&
+        previous->tag_length == entry.tag_length && CRYPTO_memcmp(previous->key, entry.key, entry.key_length) == 0;
+}
+
+// Encrypt or decrypt one entry of a batch on a cipher context shared by the whole batch.
+static CHIP_ERROR _aesCcmBatchEntry(EVP_CIPHER_CTX * context, const AES_CCM_BatchEntry & entry, bool reuse_key, int encrypt)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int bytesOutput  = 0;
+    int result       = 1;
+
+    if (!reuse_key)
+    {
+        // 16 bytes key for AES-CCM-128
+        result = EVP_CipherInit_ex(context, (entry.key_length == 16) ? EVP_aes_128_ccm() : EVP_aes_256_ccm(), nullptr, nullptr,
+                                   nullptr, encrypt);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+        // Casts are safe because lengths were checked by _checkAesCcmBatchEntry.
+        result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_IVLEN, static_cast<int>(entry.iv_length), nullptr);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    }
+
+    // The tag is only passed in for decryption; it is needed again for each message either way.
+    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_TAG, static_cast<int>(entry.tag_length), encrypt ? nullptr : entry.tag);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    // Pass in iv, and the key unless the previous entry already set it
+    result = EVP_CipherInit_ex(context, nullptr, nullptr, reuse_key ? nullptr : Uint8::to_const_uchar(entry.key),
+                               Uint8::to_const_uchar(entry.iv), encrypt);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    // Pass in input length
+    result = EVP_CipherUpdate(context, nullptr, &bytesOutput, nullptr, static_cast<int>(entry.input_length));
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    if (entry.aad_length > 0)
+    {
+        result = EVP_CipherUpdate(context, nullptr, &bytesOutput, Uint8::to_const_uchar(entry.aad),
+                                  static_cast<int>(entry.aad_length));
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    }
+
+    // On decryption, this fails if the tag does not verify.
+    result = EVP_CipherUpdate(context, Uint8::to_uchar(entry.output), &bytesOutput, Uint8::to_const_uchar(entry.input),
+                              static_cast<int>(entry.input_length));
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(bytesOutput == static_cast<int>(entry.input_length), error = CHIP_ERROR_INTERNAL);
+
+    if (encrypt)
+    {
+        result = EVP_CipherFinal_ex(context, Uint8::to_uchar(entry.output) + bytesOutput, &bytesOutput);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+        VerifyOrExit(bytesOutput == 0, error = CHIP_ERROR_INTERNAL);
+
+        result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_GET_TAG, static_cast<int>(entry.tag_length), entry.tag);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    }
+
+exit:
+    return error;
+}
+
+static CHIP_ERROR _aesCcmBatch(AES_CCM_BatchEntry * entries, size_t entry_count, int encrypt)
+{
+    CHIP_ERROR error                     = CHIP_NO_ERROR;
+    EVP_CIPHER_CTX * context             = nullptr;
+    const AES_CCM_BatchEntry * keyedWith = nullptr;
+
+    VerifyOrExit(entries != nullptr || entry_count == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    context = EVP_CIPHER_CTX_new();
+    VerifyOrExit(context != nullptr, error = CHIP_ERROR_NO_MEMORY);
+
+    for (size_t i = 0; i < entry_count; i++)
+    {
+        AES_CCM_BatchEntry & entry = entries[i];
+
+        entry.status = _checkAesCcmBatchEntry(entry);
+        if (entry.status == CHIP_NO_ERROR)
+        {
+            entry.status = _aesCcmBatchEntry(context, entry, _canReuseAesCcmKey(entry, keyedWith), encrypt);
+
+            // After a failure the state of the context is unknown; start over with the next entry.
+            keyedWith = (entry.status == CHIP_NO_ERROR) ? &entry : nullptr;
+        }
+
+        if (entry.status != CHIP_NO_ERROR && error == CHIP_NO_ERROR)
+        {
+            error = entry.status;
+        }
+    }
+
+exit:
+    if (context != nullptr)
+    {
+        EVP_CIPHER_CTX_free(context);
+        context = nullptr;
+    }
+
+    return error;
+}
+
+CHIP_ERROR AES_CCM_encrypt_batch(AES_CCM_BatchEntry * entries, size_t entry_count)
+{
+    return _aesCcmBatch(entries, entry_count, 1);
+}
+
+CHIP_ERROR AES_CCM_decrypt_batch(AES_CCM_BatchEntry * entries, size_t entry_count)
+{
+    return _aesCcmBatch(entries, entry_count, 0);
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     CHIP_ERROR error = CHIP_NO_ERROR;
@@ -497,74 +735,20 @@ static inline const EC_KEY * to_const_EC_KEY(const P256KeypairContext * context)
 
 CHIP_ERROR P256Keypair::ECDSA_sign_msg(const uint8_t * msg, const size_t msg_length, P256ECDSASignature & out_signature)
 {
-    ERR_clear_error();
-
-    CHIP_ERROR error       = CHIP_NO_ERROR;
-    int result             = 0;
-    EVP_MD_CTX * context   = nullptr;
-    int nid                = NID_undef;
-    EC_KEY * ec_key        = nullptr;
-    EVP_PKEY * signing_key = nullptr;
-    const EVP_MD * md      = nullptr;
-    DigestType digest      = DigestType::SHA256;
-    size_t out_length      = 0;
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    uint8_t digest[kSHA256_Hash_Length];
 
     VerifyOrExit(mInitialized, error = CHIP_ERROR_INCORRECT_STATE);
     VerifyOrExit(msg != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrExit(msg_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
-    nid = _nidForCurve(MapECName(mPublicKey.Type()));
-    VerifyOrExit(nid != NID_undef, error = CHIP_ERROR_INVALID_ARGUMENT);
-    md = _digestForType(digest);
-    VerifyOrExit(md != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-
-    ec_key = to_EC_KEY(&mKeypair);
-    VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
-
-    signing_key = EVP_PKEY_new();
-    VerifyOrExit(signing_key != nullptr, error = CHIP_ERROR_INTERNAL);
-
-    result = EVP_PKEY_set1_EC_KEY(signing_key, ec_key);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    context = EVP_MD_CTX_create();
-    VerifyOrExit(context != nullptr, error = CHIP_ERROR_INTERNAL);
-
-    result = EVP_DigestSignInit(context, nullptr, md, nullptr, signing_key);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
-    result = EVP_DigestSignUpdate(context, Uint8::to_const_uchar(msg), msg_length);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    // Call the EVP_DigestSignFinal with a nullptr param to get length of the signature.
-
-    result = EVP_DigestSignFinal(context, nullptr, &out_length);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-    VerifyOrExit(out_signature.Capacity() >= out_length, error = CHIP_ERROR_INVALID_ARGUMENT);
+    error = Hash_SHA256(msg, msg_length, digest);
+    SuccessOrExit(error);
 
-    result = EVP_DigestSignFinal(context, Uint8::to_uchar(out_signature), &out_length);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-    // This should not happen due to the check above. But check this nonetheless
-    SuccessOrExit(out_signature.SetLength(out_length));
+    error = ECDSA_sign_hash(digest, sizeof(digest), out_signature);
+    SuccessOrExit(error);
 
 exit:
-    ec_key = nullptr;
-
-    if (context != nullptr)
-    {
-        EVP_MD_CTX_destroy(context);
-        context = nullptr;
-    }
-    if (signing_key != nullptr)
-    {
-        EVP_PKEY_free(signing_key);
-        signing_key = nullptr;
-    }
-
-    if (error != CHIP_NO_ERROR)
-    {
-        _logSSLError();
-    }
-
     return error;
 }
 
@@ -604,90 +788,19 @@ exit:
 CHIP_ERROR P256PublicKey::ECDSA_validate_msg_signature(const uint8_t * msg, const size_t msg_length,
                                                        const P256ECDSASignature & signature) const
 {
-    ERR_clear_error();
-    CHIP_ERROR error            = CHIP_ERROR_INTERNAL;
-    int nid                     = NID_undef;
-    const EVP_MD * md           = nullptr;
-    EC_KEY * ec_key             = nullptr;
-    EVP_PKEY * verification_key = nullptr;
-    EC_POINT * key_point        = nullptr;
-    EC_GROUP * ec_group         = nullptr;
-    int result                  = 0;
-    EVP_MD_CTX * md_context     = nullptr;
-    DigestType digest           = DigestType::SHA256;
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    uint8_t digest[kSHA256_Hash_Length];
 
     VerifyOrExit(msg != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrExit(msg_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
-    nid = _nidForCurve(MapECName(Type()));
-    VerifyOrExit(nid != NID_undef, error = CHIP_ERROR_INVALID_ARGUMENT);
-
-    md = _digestForType(digest);
-    VerifyOrExit(md != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
-
-    ec_group = EC_GROUP_new_by_curve_name(nid);
-    VerifyOrExit(ec_group != nullptr, error = CHIP_ERROR_INTERNAL);
-
-    key_point = EC_POINT_new(ec_group);
-    VerifyOrExit(key_point != nullptr, error = CHIP_ERROR_INTERNAL);
-
-    result = EC_POINT_oct2point(ec_group, key_point, Uint8::to_const_uchar(*this), Length(), nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    ec_key = EC_KEY_new_by_curve_name(nid);
-    VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    result = EC_KEY_set_public_key(ec_key, key_point);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    result = EC_KEY_check_key(ec_key);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    verification_key = EVP_PKEY_new();
-    VerifyOrExit(verification_key != nullptr, error = CHIP_ERROR_INTERNAL);
-
-    result = EVP_PKEY_set1_EC_KEY(verification_key, ec_key);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    md_context = EVP_MD_CTX_create();
-    VerifyOrExit(md_context != nullptr, error = CHIP_ERROR_INTERNAL);
-
-    result = EVP_DigestVerifyInit(md_context, nullptr, md, nullptr, verification_key);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    result = EVP_DigestVerifyUpdate(md_context, Uint8::to_const_uchar(msg), msg_length);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    error = Hash_SHA256(msg, msg_length, digest);
+    SuccessOrExit(error);
 
-    result = EVP_DigestVerifyFinal(md_context, Uint8::to_const_uchar(signature), signature.Length());
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INVALID_SIGNATURE);
-    error = CHIP_NO_ERROR;
+    error = ECDSA_validate_hash_signature(digest, sizeof(digest), signature);
+    SuccessOrExit(error);
 
 exit:
-    _logSSLError();
-    if (ec_group != nullptr)
-    {
-        EC_GROUP_free(ec_group);
-        ec_group = nullptr;
-    }
-    if (key_point != nullptr)
-    {
-        EC_POINT_clear_free(key_point);
-        key_point = nullptr;
-    }
-    if (md_context)
-    {
-        EVP_MD_CTX_destroy(md_context);
-        md_context = nullptr;
-    }
-    if (ec_key != nullptr)
-    {
-        EC_KEY_free(ec_key);
-        ec_key = nullptr;
-    }
-    if (verification_key != nullptr)
-    {
-        EVP_PKEY_free(verification_key);
-        verification_key = nullptr;
-    }
     return error;
 }
 
@@ -695,34 +808,27 @@ CHIP_ERROR P256PublicKey::ECDSA_validate_hash_signature(const uint8_t * hash, co
                                                         const P256ECDSASignature & signature) const
 {
     ERR_clear_error();
-    CHIP_ERROR error     = CHIP_ERROR_INTERNAL;
-    int nid              = NID_undef;
-    EC_KEY * ec_key      = nullptr;
-    EC_POINT * key_point = nullptr;
-    EC_GROUP * ec_group  = nullptr;
-    int result           = 0;
+    CHIP_ERROR error              = CHIP_ERROR_INTERNAL;
+    const P256SharedCurve * curve = _getP256SharedCurve();
+    EC_KEY * ec_key               = nullptr;
+    EC_POINT * key_point          = nullptr;
+    int result                    = 0;
 
     VerifyOrExit(hash != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrExit(hash_length == kSHA256_Hash_Length, error = CHIP_ERROR_INVALID_ARGUMENT);
-    nid = _nidForCurve(MapECName(Type()));
-    VerifyOrExit(nid != NID_undef, error = CHIP_ERROR_INVALID_ARGUMENT);
-
-    ec_group = EC_GROUP_new_by_curve_name(nid);
-    VerifyOrExit(ec_group != nullptr, error = CHIP_ERROR_INTERNAL);
-
-    key_point = EC_POINT_new(ec_group);
-    VerifyOrExit(key_point != nullptr, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(curve != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    result = EC_POINT_oct2point(ec_group, key_point, Uint8::to_const_uchar(*this), Length(), nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    error = _create_point_from_binary_p256_key(curve, *this, &key_point);
+    SuccessOrExit(error);
+    error = CHIP_ERROR_INTERNAL;
 
-    ec_key = EC_KEY_new_by_curve_name(nid);
+    ec_key = EC_KEY_new();
     VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    result = EC_KEY_set_public_key(ec_key, key_point);
+    result = EC_KEY_set_group(ec_key, curve->group);
     VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
-    result = EC_KEY_check_key(ec_key);
+    result = EC_KEY_set_public_key(ec_key, key_point);
     VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
     // The cast for length arguments is safe because values are small enough to fit.
@@ -733,11 +839,6 @@ CHIP_ERROR P256PublicKey::ECDSA_validate_hash_signature(const uint8_t * hash, co
 
 exit:
     _logSSLError();
-    if (ec_group != nullptr)
-    {
-        EC_GROUP_free(ec_group);
-        ec_group = nullptr;
-    }
     if (key_point != nullptr)
     {
         EC_POINT_clear_free(key_point);
@@ -751,134 +852,231 @@ exit:
     return error;
 }
 
-// helper function to populate octet key into EVP_PKEY out_evp_pkey. Caller must free out_evp_pkey
-static CHIP_ERROR _create_evp_key_from_binary_p256_key(const P256PublicKey & key, EVP_PKEY ** out_evp_pkey)
+typedef struct P256ECDSAVerifier_Context
 {
+    EC_GROUP * group;
+    BN_CTX * bn_ctx;
+    EC_POINT * scratch_point;
+    EC_KEY * scratch_key;
+    EC_KEY * trusted_keys[kMax_P256ECDSAVerifier_TrustedKeys];
+} P256ECDSAVerifier_Context;
 
-    CHIP_ERROR error = CHIP_NO_ERROR;
-    EC_KEY * ec_key  = nullptr;
-    int result       = -1;
-    EC_POINT * point = nullptr;
-    EC_GROUP * group = nullptr;
-    int nid          = NID_undef;
+nlSTATIC_ASSERT_PRINT(sizeof(P256ECDSAVerifier_Context) <= kMAX_P256ECDSAVerifier_Context_Size,
+                      "P256ECDSAVerifier context is too small");
 
-    VerifyOrExit(*out_evp_pkey == nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+static inline P256ECDSAVerifier_Context * to_inner_verifier_context(P256ECDSAVerifierContext * context)
+{
+    return SafePointerCast<P256ECDSAVerifier_Context *>(context);
+}
 
-    nid = _nidForCurve(MapECName(key.Type()));
-    VerifyOrExit(nid != NID_undef, error = CHIP_ERROR_INTERNAL);
+P256ECDSAVerifier::~P256ECDSAVerifier()
+{
+    Clear();
+}
 
-    ec_key = EC_KEY_new_by_curve_name(nid);
-    VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
+CHIP_ERROR P256ECDSAVerifier::Init()
+{
+    ERR_clear_error();
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 0;
 
-    group = EC_GROUP_new_by_curve_name(nid);
-    VerifyOrExit(group != nullptr, error = CHIP_ERROR_INTERNAL);
+    P256ECDSAVerifier_Context * context = to_inner_verifier_context(&mContext);
 
-    point = EC_POINT_new(group);
-    VerifyOrExit(point != nullptr, error = CHIP_ERROR_INTERNAL);
+    Clear();
+    memset(context, 0, sizeof(*context));
+    mInitialized = true;
 
-    result = EC_POINT_oct2point(group, point, Uint8::to_const_uchar(key), key.Length(), nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    context->group = EC_GROUP_new_by_curve_name(_nidForCurve(ECName::P256v1));
+    VerifyOrExit(context->group != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    result = EC_KEY_set_public_key(ec_key, point);
+    context->bn_ctx = BN_CTX_new();
+    VerifyOrExit(context->bn_ctx != nullptr, error = CHIP_ERROR_INTERNAL);
 
+    // Precompute the generator multiples once; every key bound to this group afterwards shares the table.
+    result = EC_GROUP_precompute_mult(context->group, context->bn_ctx);
     VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
-    *out_evp_pkey = EVP_PKEY_new();
-    VerifyOrExit(*out_evp_pkey != nullptr, error = CHIP_ERROR_INTERNAL);
+    context->scratch_point = EC_POINT_new(context->group);
+    VerifyOrExit(context->scratch_point != nullptr, error = CHIP_ERROR_INTERNAL);
+
+    context->scratch_key = EC_KEY_new();
+    VerifyOrExit(context->scratch_key != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    result = EVP_PKEY_set1_EC_KEY(*out_evp_pkey, ec_key);
+    result = EC_KEY_set_group(context->scratch_key, context->group);
     VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
 exit:
-    if (ec_key != nullptr)
+    if (error != CHIP_NO_ERROR)
     {
-        EC_KEY_free(ec_key);
-        ec_key = nullptr;
+        Clear();
     }
+    _logSSLError();
+    return error;
+}
 
-    if (error != CHIP_NO_ERROR && *out_evp_pkey)
+void P256ECDSAVerifier::Clear()
+{
+    if (!mInitialized)
     {
-        EVP_PKEY_free(*out_evp_pkey);
-        out_evp_pkey = nullptr;
+        return;
     }
 
-    if (point != nullptr)
+    P256ECDSAVerifier_Context * context = to_inner_verifier_context(&mContext);
+
+    for (size_t i = 0; i < mTrustedKeyCount; i++)
     {
-        EC_POINT_free(point);
-        point = nullptr;
+        EC_KEY_free(context->trusted_keys[i]);
+        context->trusted_keys[i] = nullptr;
     }
+    mTrustedKeyCount = 0;
 
-    if (group != nullptr)
+    if (context->scratch_key != nullptr)
     {
-        EC_GROUP_free(group);
-        group = nullptr;
+        EC_KEY_free(context->scratch_key);
+    }
+    if (context->scratch_point != nullptr)
+    {
+        EC_POINT_free(context->scratch_point);
+    }
+    if (context->bn_ctx != nullptr)
+    {
+        BN_CTX_free(context->bn_ctx);
     }
+    if (context->group != nullptr)
+    {
+        EC_GROUP_free(context->group);
+    }
+    memset(context, 0, sizeof(*context));
 
-    return error;
+    mInitialized = false;
 }
 
-CHIP_ERROR P256Keypair::ECDH_derive_secret(const P256PublicKey & remote_public_key, P256ECDHDerivedSecret & out_secret) const
+CHIP_ERROR P256ECDSAVerifier::AddTrustedKey(const P256PublicKey & key)
 {
     ERR_clear_error();
-    CHIP_ERROR error      = CHIP_NO_ERROR;
-    int result            = -1;
-    EVP_PKEY * local_key  = nullptr;
-    EVP_PKEY * remote_key = nullptr;
-
-    EVP_PKEY_CTX * context = nullptr;
-    size_t out_buf_length  = 0;
+    CHIP_ERROR error     = CHIP_NO_ERROR;
+    int result           = 0;
+    EC_KEY * ec_key      = nullptr;
+    EC_POINT * key_point = nullptr;
 
-    EC_KEY * ec_key = EC_KEY_dup(to_const_EC_KEY(&mKeypair));
-    VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
+    P256ECDSAVerifier_Context * context = to_inner_verifier_context(&mContext);
 
     VerifyOrExit(mInitialized, error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(key.Type() == SupportedECPKeyTypes::ECP256R1, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    local_key = EVP_PKEY_new();
-    VerifyOrExit(local_key != nullptr, error = CHIP_ERROR_INTERNAL);
+    // Registering the same key twice is harmless.
+    VerifyOrExit(!IsTrustedKey(key), error = CHIP_NO_ERROR);
+    VerifyOrExit(mTrustedKeyCount < kMax_P256ECDSAVerifier_TrustedKeys, error = CHIP_ERROR_NO_MEMORY);
 
-    result = EVP_PKEY_set1_EC_KEY(local_key, ec_key);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    key_point = EC_POINT_new(context->group);
+    VerifyOrExit(key_point != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    error = _create_evp_key_from_binary_p256_key(remote_public_key, &remote_key);
-    SuccessOrExit(error);
+    result = EC_POINT_oct2point(context->group, key_point, Uint8::to_const_uchar(key), key.Length(), context->bn_ctx);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    context = EVP_PKEY_CTX_new(local_key, nullptr);
-    VerifyOrExit(context != nullptr, error = CHIP_ERROR_INTERNAL);
+    ec_key = EC_KEY_new();
+    VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    result = EVP_PKEY_derive_init(context);
+    result = EC_KEY_set_group(ec_key, context->group);
     VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
-    result = EVP_PKEY_derive_set_peer(context, remote_key);
+    result = EC_KEY_set_public_key(ec_key, key_point);
     VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
-    out_buf_length = (out_secret.Length() == 0) ? out_secret.Capacity() : out_secret.Length();
-    result         = EVP_PKEY_derive(context, Uint8::to_uchar(out_secret), &out_buf_length);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-    SuccessOrExit(out_secret.SetLength(out_buf_length));
+    // Trusted keys are fully checked once here, and never again.
+    result = EC_KEY_check_key(ec_key);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    memcpy(Uint8::to_uchar(mTrustedKeys[mTrustedKeyCount]), Uint8::to_const_uchar(key), key.Length());
+    context->trusted_keys[mTrustedKeyCount] = ec_key;
+    mTrustedKeyCount++;
+    ec_key = nullptr;
 
 exit:
     if (ec_key != nullptr)
     {
         EC_KEY_free(ec_key);
-        ec_key = nullptr;
     }
-
-    if (local_key != nullptr)
+    if (key_point != nullptr)
     {
-        EVP_PKEY_free(local_key);
-        local_key = nullptr;
+        EC_POINT_free(key_point);
     }
+    _logSSLError();
+    return error;
+}
+
+CHIP_ERROR P256ECDSAVerifier::ECDSA_validate_hash_signature(const P256PublicKey & key, const uint8_t * hash,
+                                                            const size_t hash_length, const P256ECDSASignature & signature)
+{
+    ERR_clear_error();
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 0;
+    int keyIndex     = -1;
+    EC_KEY * ec_key  = nullptr;
+
+    P256ECDSAVerifier_Context * context = to_inner_verifier_context(&mContext);
+
+    VerifyOrExit(mInitialized, error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(hash != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(hash_length == kSHA256_Hash_Length, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(key.Type() == SupportedECPKeyTypes::ECP256R1, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    if (remote_key != nullptr)
+    keyIndex = FindTrustedKey(key);
+    if (keyIndex >= 0)
     {
-        EVP_PKEY_free(remote_key);
-        remote_key = nullptr;
+        ec_key = context->trusted_keys[keyIndex];
     }
+    else
+    {
+        result = EC_POINT_oct2point(context->group, context->scratch_point, Uint8::to_const_uchar(key), key.Length(),
+                                    context->bn_ctx);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    if (context != nullptr)
+        // P-256 has a cofactor of 1, so every point on the curve is in the prime order subgroup and the
+        // on-curve check is all EC_KEY_check_key() would add, minus a full scalar multiplication.
+        result = EC_POINT_is_on_curve(context->group, context->scratch_point, context->bn_ctx);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+        result = EC_KEY_set_public_key(context->scratch_key, context->scratch_point);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+        ec_key = context->scratch_key;
+    }
+
+    // The cast for length arguments is safe because values are small enough to fit.
+    result = ECDSA_verify(0, hash, static_cast<int>(hash_length), Uint8::to_const_uchar(signature),
+                          static_cast<int>(signature.Length()), ec_key);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INVALID_SIGNATURE);
+
+exit:
+    _logSSLError();
+    return error;
+}
+
+CHIP_ERROR P256Keypair::ECDH_derive_secret(const P256PublicKey & remote_public_key, P256ECDHDerivedSecret & out_secret) const
+{
+    ERR_clear_error();
+    CHIP_ERROR error              = CHIP_NO_ERROR;
+    int result                    = -1;
+    const P256SharedCurve * curve = _getP256SharedCurve();
+    EC_POINT * remote_point       = nullptr;
+    size_t out_buf_length         = (out_secret.Length() == 0) ? out_secret.Capacity() : out_secret.Length();
+
+    VerifyOrExit(mInitialized, error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(curve != nullptr, error = CHIP_ERROR_INTERNAL);
+
+    error = _create_point_from_binary_p256_key(curve, remote_public_key, &remote_point);
+    SuccessOrExit(error);
+
+    result = ECDH_compute_key(Uint8::to_uchar(out_secret), out_buf_length, remote_point, to_const_EC_KEY(&mKeypair), nullptr);
+    VerifyOrExit(result > 0, error = CHIP_ERROR_INTERNAL);
+    SuccessOrExit(out_secret.SetLength(static_cast<size_t>(result)));
+
+exit:
+    if (remote_point != nullptr)
     {
-        EVP_PKEY_CTX_free(context);
-        context = nullptr;
+        EC_POINT_free(remote_point);
+        remote_point = nullptr;
     }
 
     _logSSLError();
@@ -893,23 +1091,20 @@ void ClearSecretData(uint8_t * buf, uint32_t len)
 CHIP_ERROR P256Keypair::Initialize()
 {
     ERR_clear_error();
-    CHIP_ERROR error = CHIP_NO_ERROR;
-    int result       = 0;
-    int nid          = NID_undef;
-    EC_KEY * ec_key  = nullptr;
-    EC_GROUP * group = nullptr;
-    ECName curve     = MapECName(mPublicKey.Type());
-
-    VerifyOrExit(curve == MapECName(mPublicKey.Type()), error = CHIP_ERROR_INVALID_ARGUMENT);
+    CHIP_ERROR error              = CHIP_NO_ERROR;
+    int result                    = 0;
+    EC_KEY * ec_key               = nullptr;
+    const P256SharedCurve * curve = _getP256SharedCurve();
 
-    nid = _nidForCurve(curve);
-    VerifyOrExit(nid != NID_undef, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(mPublicKey.Type() == SupportedECPKeyTypes::ECP256R1, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(curve != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    ec_key = EC_KEY_new_by_curve_name(nid);
+    // The key gets its own copy of the shared group, which carries over the precomputed generator multiples.
+    ec_key = EC_KEY_new();
     VerifyOrExit(ec_key != nullptr, error = CHIP_ERROR_INTERNAL);
 
-    group = EC_GROUP_new_by_curve_name(nid);
-    VerifyOrExit(group != nullptr, error = CHIP_ERROR_INTERNAL);
+    result = EC_KEY_set_group(ec_key, curve->group);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
     result = EC_KEY_generate_key(ec_key);
     VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
@@ -919,7 +1114,7 @@ CHIP_ERROR P256Keypair::Initialize()
         const EC_POINT * pubkey_ecp = EC_KEY_get0_public_key(ec_key);
         VerifyOrExit(pubkey_ecp != nullptr, error = CHIP_ERROR_INTERNAL);
 
-        pubkey_size = EC_POINT_point2oct(group, pubkey_ecp, POINT_CONVERSION_UNCOMPRESSED, Uint8::to_uchar(mPublicKey),
+        pubkey_size = EC_POINT_point2oct(curve->group, pubkey_ecp, POINT_CONVERSION_UNCOMPRESSED, Uint8::to_uchar(mPublicKey),
                                          mPublicKey.Length(), nullptr);
         pubkey_ecp  = nullptr;
 
@@ -937,12 +1132,6 @@ exit:
         ec_key = nullptr;
     }
 
-    if (group != nullptr)
-    {
-        EC_GROUP_free(group);
-        group = nullptr;
-    }
-
     _logSSLError();
     return error;
 }
@@ -1173,7 +1362,7 @@ exit:
 
 typedef struct Spake2p_Context
 {
-    EC_GROUP * curve;
+    const EC_GROUP * curve;
     BN_CTX * bn_ctx;
     const EVP_MD * md_info;
 } Spake2p_Context;
@@ -1185,8 +1374,9 @@ static inline Spake2p_Context * to_inner_spake2p_context(Spake2pOpaqueContext *
 
 CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::InitInternal()
 {
-    CHIP_ERROR error  = CHIP_ERROR_INTERNAL;
-    int error_openssl = 0;
+    CHIP_ERROR error              = CHIP_ERROR_INTERNAL;
+    int error_openssl             = 0;
+    const P256SharedCurve * curve = _getP256SharedCurve();
 
     Spake2p_Context * context = to_inner_spake2p_context(&mSpake2pContext);
 
@@ -1194,8 +1384,8 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::InitInternal()
     context->bn_ctx  = nullptr;
     context->md_info = nullptr;
 
-    context->curve = EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1);
-    VerifyOrExit(context->curve != nullptr, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(curve != nullptr, error = CHIP_ERROR_INTERNAL);
+    context->curve = curve->group;
 
     G = EC_GROUP_get0_generator(context->curve);
     VerifyOrExit(G != nullptr, error = CHIP_ERROR_INTERNAL);
@@ -1231,10 +1421,8 @@ void Spake2p_P256_SHA256_HKDF_HMAC::FreeImpl()
 {
     Spake2p_Context * context = to_inner_spake2p_context(&mSpake2pContext);
 
-    if (context->curve != nullptr)
-    {
-        EC_GROUP_clear_free(context->curve);
-    }
+    // The curve is shared with other sessions and is not owned by this one.
+    context->curve = nullptr;
 
     if (context->bn_ctx != nullptr)
     {
@@ -1255,6 +1443,26 @@ void Spake2p_P256_SHA256_HKDF_HMAC::FreeImpl()
     free_bn(order);
 }
 
+CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::LoadMN()
+{
+    CHIP_ERROR error              = CHIP_ERROR_INTERNAL;
+    int error_openssl             = 0;
+    const P256SharedCurve * curve = _getP256SharedCurve();
+
+    VerifyOrExit(curve != nullptr, error = CHIP_ERROR_INTERNAL);
+
+    // M and N are inverted in place by ComputeRoundTwo, so each session works on its own copy.
+    error_openssl = EC_POINT_copy(static_cast<EC_POINT *>(M), curve->M);
+    VerifyOrExit(error_openssl == 1, error = CHIP_ERROR_INTERNAL);
+
+    error_openssl = EC_POINT_copy(static_cast<EC_POINT *>(N), curve->N);
+    VerifyOrExit(error_openssl == 1, error = CHIP_ERROR_INTERNAL);
+
+    error = CHIP_NO_ERROR;
+exit:
+    return error;
+}
+
 CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::Mac(const uint8_t * key, size_t key_len, const uint8_t * in, size_t in_len, uint8_t * out)
 {
     CHIP_ERROR error         = CHIP_ERROR_INTERNAL;
@@ -1399,8 +1607,17 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::PointMul(void * R, const void * P1, co
 
     Spake2p_Context * context = to_inner_spake2p_context(&mSpake2pContext);
 
-    error_openssl = EC_POINT_mul(context->curve, static_cast<EC_POINT *>(R), nullptr, static_cast<const EC_POINT *>(P1),
-                                 static_cast<const BIGNUM *>(fe1), context->bn_ctx);
+    if (P1 == G)
+    {
+        // Use the precomputed multiples of the generator.
+        error_openssl = EC_POINT_mul(context->curve, static_cast<EC_POINT *>(R), static_cast<const BIGNUM *>(fe1), nullptr,
+                                     nullptr, context->bn_ctx);
+    }
+    else
+    {
+        error_openssl = EC_POINT_mul(context->curve, static_cast<EC_POINT *>(R), nullptr, static_cast<const EC_POINT *>(P1),
+                                     static_cast<const BIGNUM *>(fe1), context->bn_ctx);
+    }
     VerifyOrExit(error_openssl == 1, error = CHIP_ERROR_INTERNAL);
 
     error = CHIP_NO_ERROR;
@@ -24,6 +24,7 @@
 
 #include <type_traits>
 
+#include <mbedtls/asn1.h>
 #include <mbedtls/bignum.h>
 #include <mbedtls/ccm.h>
 #include <mbedtls/ctr_drbg.h>
@@ -91,6 +92,24 @@ static bool _isValidKeyLength(size_t length)
     return false;
 }
 
+/**
+ * This function implements constant time memcmp. It's good practice
+ * to use constant time functions for cryptographic functions.
+ */
+static inline int constant_time_memcmp(const void * a, const void * b, size_t n)
+{
+    const uint8_t * A = (const uint8_t *) a;
+    const uint8_t * B = (const uint8_t *) b;
+    uint8_t diff      = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        diff |= (A[i] ^ B[i]);
+    }
+
+    return diff;
+}
+
 CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
                            const uint8_t * key, size_t key_length, const uint8_t * iv, size_t iv_length, uint8_t * ciphertext,
                            uint8_t * tag, size_t tag_length)
@@ -173,6 +192,97 @@ exit:
     return error;
 }
 
+static CHIP_ERROR _checkAesCcmBatchEntry(const AES_CCM_BatchEntry & entry)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+
+    VerifyOrExit(entry.input != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.input_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.output != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.key != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(_isValidKeyLength(entry.key_length), error = CHIP_ERROR_UNSUPPORTED_ENCRYPTION_TYPE);
+    VerifyOrExit(entry.iv != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.iv_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(_isValidTagLength(entry.tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(entry.aad_length == 0 || entry.aad != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+exit:
+    return error;
+}
+
+static CHIP_ERROR _aesCcmBatch(AES_CCM_BatchEntry * entries, size_t entry_count, bool encrypt)
+{
+    CHIP_ERROR error                     = CHIP_NO_ERROR;
+    int result                           = 0;
+    const AES_CCM_BatchEntry * keyedWith = nullptr;
+
+    mbedtls_ccm_context context;
+    mbedtls_ccm_init(&context);
+
+    VerifyOrExit(entries != nullptr || entry_count == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    for (size_t i = 0; i < entry_count; i++)
+    {
+        AES_CCM_BatchEntry & entry = entries[i];
+
+        entry.status = _checkAesCcmBatchEntry(entry);
+        if (entry.status == CHIP_NO_ERROR)
+        {
+            // The key schedule is kept while consecutive entries use the same key.
+            if (keyedWith == nullptr || keyedWith->key_length != entry.key_length ||
+                constant_time_memcmp(keyedWith->key, entry.key, entry.key_length) != 0)
+            {
+                // Cast is safe because we called _isValidKeyLength above.
+                result = mbedtls_ccm_setkey(&context, MBEDTLS_CIPHER_ID_AES, Uint8::to_const_uchar(entry.key),
+                                            static_cast<unsigned int>(entry.key_length * 8));
+                keyedWith = (result == 0) ? &entry : nullptr;
+            }
+
+            if (result == 0)
+            {
+                if (encrypt)
+                {
+                    result = mbedtls_ccm_encrypt_and_tag(&context, entry.input_length, Uint8::to_const_uchar(entry.iv),
+                                                         entry.iv_length, Uint8::to_const_uchar(entry.aad), entry.aad_length,
+                                                         Uint8::to_const_uchar(entry.input), Uint8::to_uchar(entry.output),
+                                                         Uint8::to_uchar(entry.tag), entry.tag_length);
+                }
+                else
+                {
+                    result = mbedtls_ccm_auth_decrypt(&context, entry.input_length, Uint8::to_const_uchar(entry.iv),
+                                                      entry.iv_length, Uint8::to_const_uchar(entry.aad), entry.aad_length,
+                                                      Uint8::to_const_uchar(entry.input), Uint8::to_uchar(entry.output),
+                                                      Uint8::to_const_uchar(entry.tag), entry.tag_length);
+                }
+            }
+
+            _log_mbedTLS_error(result);
+            entry.status = (result == 0) ? CHIP_NO_ERROR : CHIP_ERROR_INTERNAL;
+            result       = 0;
+        }
+
+        if (entry.status != CHIP_NO_ERROR && error == CHIP_NO_ERROR)
+        {
+            error = entry.status;
+        }
+    }
+
+exit:
+    mbedtls_ccm_free(&context);
+    return error;
+}
+
+CHIP_ERROR AES_CCM_encrypt_batch(AES_CCM_BatchEntry * entries, size_t entry_count)
+{
+    return _aesCcmBatch(entries, entry_count, true);
+}
+
+CHIP_ERROR AES_CCM_decrypt_batch(AES_CCM_BatchEntry * entries, size_t entry_count)
+{
+    return _aesCcmBatch(entries, entry_count, false);
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     CHIP_ERROR error = CHIP_NO_ERROR;
@@ -408,6 +518,72 @@ mbedtls_ecp_group_id MapECPGroupId(SupportedECPKeyTypes keyType)
     }
 }
 
+/*
+ * Long-lived P-256 group shared by all keypairs and Spake2p sessions.
+ *
+ * mbedtls_ecp_mul() stores the fixed-point comb table for the generator in the group on the first
+ * multiplication by G (MBEDTLS_ECP_FIXED_POINT_OPTIM), so that multiplication is done while setting
+ * up the context. The context is not modified after that, and the SPAKE2+ M and N points are
+ * decoded once; callers that need M or N in a mutable form must copy them.
+ */
+typedef struct P256SharedCurve
+{
+    mbedtls_ecp_group group;
+    mbedtls_ecp_point M;
+    mbedtls_ecp_point N;
+} P256SharedCurve;
+
+static CHIP_ERROR _initP256SharedCurve(P256SharedCurve & curve)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 0;
+
+    mbedtls_mpi one;
+    mbedtls_mpi_init(&one);
+
+    mbedtls_ecp_point scratch;
+    mbedtls_ecp_point_init(&scratch);
+
+    mbedtls_ecp_group_init(&curve.group);
+    mbedtls_ecp_point_init(&curve.M);
+    mbedtls_ecp_point_init(&curve.N);
+
+    result = mbedtls_ecp_group_load(&curve.group, MBEDTLS_ECP_DP_SECP256R1);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+    result = mbedtls_ecp_point_read_binary(&curve.group, &curve.M, Uint8::to_const_uchar(spake2p_M_p256), sizeof(spake2p_M_p256));
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+    result = mbedtls_ecp_point_read_binary(&curve.group, &curve.N, Uint8::to_const_uchar(spake2p_N_p256), sizeof(spake2p_N_p256));
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+    result = mbedtls_mpi_lset(&one, 1);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+    result = mbedtls_ecp_mul(&curve.group, &scratch, &one, &curve.group.G, CryptoRNG, nullptr);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+exit:
+    mbedtls_ecp_point_free(&scratch);
+    mbedtls_mpi_free(&one);
+    if (error != CHIP_NO_ERROR)
+    {
+        mbedtls_ecp_point_free(&curve.N);
+        mbedtls_ecp_point_free(&curve.M);
+        mbedtls_ecp_group_free(&curve.group);
+    }
+    _log_mbedTLS_error(result);
+    return error;
+}
+
+static P256SharedCurve * _getP256SharedCurve()
+{
+    static P256SharedCurve sCurve;
+    static const bool sInitialized = (_initP256SharedCurve(sCurve) == CHIP_NO_ERROR);
+
+    return sInitialized ? &sCurve : nullptr;
+}
+
 static inline mbedtls_ecp_keypair * to_keypair(P256KeypairContext * context)
 {
     return SafePointerCast<mbedtls_ecp_keypair *>(context);
@@ -554,14 +730,187 @@ exit:
     return error;
 }
 
+typedef struct P256ECDSAVerifier_Context
+{
+    mbedtls_ecp_group grp;
+    mbedtls_ecp_point trusted_points[kMax_P256ECDSAVerifier_TrustedKeys];
+} P256ECDSAVerifier_Context;
+
+static_assert(sizeof(P256ECDSAVerifier_Context) <= kMAX_P256ECDSAVerifier_Context_Size, "P256ECDSAVerifier context is too small");
+
+static inline P256ECDSAVerifier_Context * to_inner_verifier_context(P256ECDSAVerifierContext * context)
+{
+    return SafePointerCast<P256ECDSAVerifier_Context *>(context);
+}
+
+// Split an ASN.1 DER Ecdsa-Sig-Value into its r and s components.
+static int read_ecdsa_signature(const P256ECDSASignature & signature, mbedtls_mpi * r, mbedtls_mpi * s)
+{
+    int result          = 0;
+    size_t len          = 0;
+    unsigned char * p   = const_cast<unsigned char *>(Uint8::to_const_uchar(signature));
+    const uint8_t * end = p + signature.Length();
+
+    result = mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE);
+    VerifyOrExit(result == 0, result = MBEDTLS_ERR_ECP_BAD_INPUT_DATA);
+    VerifyOrExit(p + len == end, result = MBEDTLS_ERR_ECP_BAD_INPUT_DATA);
+
+    result = mbedtls_asn1_get_mpi(&p, end, r);
+    VerifyOrExit(result == 0, result = MBEDTLS_ERR_ECP_BAD_INPUT_DATA);
+
+    result = mbedtls_asn1_get_mpi(&p, end, s);
+    VerifyOrExit(result == 0, result = MBEDTLS_ERR_ECP_BAD_INPUT_DATA);
+
+    VerifyOrExit(p == end, result = MBEDTLS_ERR_ECP_BAD_INPUT_DATA);
+
+exit:
+    return result;
+}
+
+P256ECDSAVerifier::~P256ECDSAVerifier()
+{
+    Clear();
+}
+
+CHIP_ERROR P256ECDSAVerifier::Init()
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 0;
+
+    P256ECDSAVerifier_Context * context = to_inner_verifier_context(&mContext);
+
+    Clear();
+    memset(context, 0, sizeof(*context));
+
+    mbedtls_ecp_group_init(&context->grp);
+    for (size_t i = 0; i < kMax_P256ECDSAVerifier_TrustedKeys; i++)
+    {
+        mbedtls_ecp_point_init(&context->trusted_points[i]);
+    }
+    mInitialized = true;
+
+    // The group keeps its fixed-point comb table for the generator (MBEDTLS_ECP_FIXED_POINT_OPTIM) across
+    // verifications, so it is only computed on the first use.
+    result = mbedtls_ecp_group_load(&context->grp, MBEDTLS_ECP_DP_SECP256R1);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+exit:
+    if (error != CHIP_NO_ERROR)
+    {
+        Clear();
+    }
+    _log_mbedTLS_error(result);
+    return error;
+}
+
+void P256ECDSAVerifier::Clear()
+{
+    if (!mInitialized)
+    {
+        return;
+    }
+
+    P256ECDSAVerifier_Context * context = to_inner_verifier_context(&mContext);
+
+    for (size_t i = 0; i < kMax_P256ECDSAVerifier_TrustedKeys; i++)
+    {
+        mbedtls_ecp_point_free(&context->trusted_points[i]);
+    }
+    mbedtls_ecp_group_free(&context->grp);
+
+    mTrustedKeyCount = 0;
+    mInitialized     = false;
+}
+
+CHIP_ERROR P256ECDSAVerifier::AddTrustedKey(const P256PublicKey & key)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 0;
+
+    P256ECDSAVerifier_Context * context = to_inner_verifier_context(&mContext);
+    mbedtls_ecp_point * point           = nullptr;
+
+    VerifyOrExit(mInitialized, error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(key.Type() == SupportedECPKeyTypes::ECP256R1, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Registering the same key twice is harmless.
+    VerifyOrExit(!IsTrustedKey(key), error = CHIP_NO_ERROR);
+    VerifyOrExit(mTrustedKeyCount < kMax_P256ECDSAVerifier_TrustedKeys, error = CHIP_ERROR_NO_MEMORY);
+
+    point = &context->trusted_points[mTrustedKeyCount];
+
+    result = mbedtls_ecp_point_read_binary(&context->grp, point, Uint8::to_const_uchar(key), key.Length());
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    result = mbedtls_ecp_check_pubkey(&context->grp, point);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    memcpy(Uint8::to_uchar(mTrustedKeys[mTrustedKeyCount]), Uint8::to_const_uchar(key), key.Length());
+    mTrustedKeyCount++;
+
+exit:
+    _log_mbedTLS_error(result);
+    return error;
+}
+
+CHIP_ERROR P256ECDSAVerifier::ECDSA_validate_hash_signature(const P256PublicKey & key, const uint8_t * hash,
+                                                            const size_t hash_length, const P256ECDSASignature & signature)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 0;
+    int keyIndex     = -1;
+
+    P256ECDSAVerifier_Context * context = to_inner_verifier_context(&mContext);
+    const mbedtls_ecp_point * Q         = nullptr;
+
+    mbedtls_ecp_point untrusted_point;
+    mbedtls_ecp_point_init(&untrusted_point);
+
+    mbedtls_mpi r;
+    mbedtls_mpi_init(&r);
+
+    mbedtls_mpi s;
+    mbedtls_mpi_init(&s);
+
+    VerifyOrExit(mInitialized, error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(hash != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(hash_length == NUM_BYTES_IN_SHA256_HASH, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(key.Type() == SupportedECPKeyTypes::ECP256R1, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    keyIndex = FindTrustedKey(key);
+    if (keyIndex >= 0)
+    {
+        Q = &context->trusted_points[keyIndex];
+    }
+    else
+    {
+        result = mbedtls_ecp_point_read_binary(&context->grp, &untrusted_point, Uint8::to_const_uchar(key), key.Length());
+        VerifyOrExit(result == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+        Q = &untrusted_point;
+    }
+
+    result = read_ecdsa_signature(signature, &r, &s);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INVALID_SIGNATURE);
+
+    result = mbedtls_ecdsa_verify(&context->grp, Uint8::to_const_uchar(hash), hash_length, Q, &r, &s);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INVALID_SIGNATURE);
+
+exit:
+    mbedtls_mpi_free(&s);
+    mbedtls_mpi_free(&r);
+    mbedtls_ecp_point_free(&untrusted_point);
+    _log_mbedTLS_error(result);
+    return error;
+}
+
 CHIP_ERROR P256Keypair::ECDH_derive_secret(const P256PublicKey & remote_public_key, P256ECDHDerivedSecret & out_secret) const
 {
     CHIP_ERROR error     = CHIP_NO_ERROR;
     int result           = 0;
     size_t secret_length = (out_secret.Length() == 0) ? out_secret.Capacity() : out_secret.Length();
 
-    mbedtls_ecp_group ecp_grp;
-    mbedtls_ecp_group_init(&ecp_grp);
+    P256SharedCurve * curve = _getP256SharedCurve();
 
     mbedtls_mpi mpi_secret;
     mbedtls_mpi_init(&mpi_secret);
@@ -572,15 +921,14 @@ CHIP_ERROR P256Keypair::ECDH_derive_secret(const P256PublicKey & remote_public_k
     const mbedtls_ecp_keypair * keypair = to_const_keypair(&mKeypair);
 
     VerifyOrExit(mInitialized, error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(curve != nullptr, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(MapECPGroupId(remote_public_key.Type()) == curve->group.id, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    result = mbedtls_ecp_group_load(&ecp_grp, MapECPGroupId(remote_public_key.Type()));
-    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
-
-    result =
-        mbedtls_ecp_point_read_binary(&ecp_grp, &ecp_pubkey, Uint8::to_const_uchar(remote_public_key), remote_public_key.Length());
+    result = mbedtls_ecp_point_read_binary(&curve->group, &ecp_pubkey, Uint8::to_const_uchar(remote_public_key),
+                                           remote_public_key.Length());
     VerifyOrExit(result == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
 
-    result = mbedtls_ecdh_compute_shared(&ecp_grp, &mpi_secret, &ecp_pubkey, &keypair->d, CryptoRNG, nullptr);
+    result = mbedtls_ecdh_compute_shared(&curve->group, &mpi_secret, &ecp_pubkey, &keypair->d, CryptoRNG, nullptr);
     VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
 
     result = mbedtls_mpi_write_binary(&mpi_secret, Uint8::to_uchar(out_secret), secret_length);
@@ -589,7 +937,7 @@ CHIP_ERROR P256Keypair::ECDH_derive_secret(const P256PublicKey & remote_public_k
 
 exit:
     keypair = nullptr;
-    mbedtls_ecp_group_free(&ecp_grp);
+    curve   = nullptr;
     mbedtls_mpi_free(&mpi_secret);
     mbedtls_ecp_point_free(&ecp_pubkey);
     _log_mbedTLS_error(result);
@@ -609,11 +957,20 @@ CHIP_ERROR P256Keypair::Initialize()
     size_t pubkey_size = 0;
 
     mbedtls_ecp_group_id group = MapECPGroupId(mPublicKey.Type());
+    P256SharedCurve * curve    = _getP256SharedCurve();
 
     mbedtls_ecp_keypair * keypair = to_keypair(&mKeypair);
     mbedtls_ecp_keypair_init(keypair);
 
-    result = mbedtls_ecp_gen_key(group, keypair, CryptoRNG, nullptr);
+    VerifyOrExit(curve != nullptr, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(group == curve->group.id, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    // The keypair keeps its own group for signing; the public key is computed with the shared group,
+    // whose comb table for the generator is already in place.
+    result = mbedtls_ecp_group_load(&keypair->grp, group);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+    result = mbedtls_ecp_gen_keypair(&curve->group, &keypair->d, &keypair->Q, CryptoRNG, nullptr);
     VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
 
     result = mbedtls_ecp_point_write_binary(&keypair->grp, &keypair->Q, MBEDTLS_ECP_PF_UNCOMPRESSED, &pubkey_size,
@@ -747,7 +1104,7 @@ exit:
 
 typedef struct Spake2p_Context
 {
-    mbedtls_ecp_group curve;
+    mbedtls_ecp_group * curve;
     const mbedtls_md_info_t * md_info;
     mbedtls_ecp_point M;
     mbedtls_ecp_point N;
@@ -774,11 +1131,11 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::InitInternal(void)
     int result       = 0;
 
     Spake2p_Context * context = to_inner_spake2p_context(&mSpake2pContext);
+    P256SharedCurve * curve   = _getP256SharedCurve();
 
     memset(context, 0, sizeof(Spake2p_Context));
-    mbedtls_ecp_group_init(&context->curve);
-    result = mbedtls_ecp_group_load(&context->curve, MBEDTLS_ECP_DP_SECP256R1);
-    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(curve != nullptr, error = CHIP_ERROR_INTERNAL);
+    context->curve = &curve->group;
 
     context->md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
     VerifyOrExit(context->md_info != nullptr, error = CHIP_ERROR_INTERNAL);
@@ -807,8 +1164,8 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::InitInternal(void)
     xy     = &context->xy;
     tempbn = &context->tempbn;
 
-    G     = &context->curve.G;
-    order = &context->curve.N;
+    G     = &context->curve->G;
+    order = &context->curve->N;
 
     return error;
 
@@ -836,7 +1193,28 @@ void Spake2p_P256_SHA256_HKDF_HMAC::FreeImpl(void)
     mbedtls_mpi_free(&context->xy);
     mbedtls_mpi_free(&context->tempbn);
 
-    mbedtls_ecp_group_free(&context->curve);
+    // The curve is shared with other sessions and is not owned by this one.
+    context->curve = nullptr;
+}
+
+CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::LoadMN()
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 0;
+
+    P256SharedCurve * curve = _getP256SharedCurve();
+    VerifyOrExit(curve != nullptr, error = CHIP_ERROR_INTERNAL);
+
+    // M and N are inverted in place by ComputeRoundTwo, so each session works on its own copy.
+    result = mbedtls_ecp_copy((mbedtls_ecp_point *) M, &curve->M);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+    result = mbedtls_ecp_copy((mbedtls_ecp_point *) N, &curve->N);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+exit:
+    _log_mbedTLS_error(result);
+    return error;
 }
 
 CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::Mac(const uint8_t * key, size_t key_len, const uint8_t * in, size_t in_len, uint8_t * out)
@@ -870,24 +1248,6 @@ exit:
     return error;
 }
 
-/**
- * This function implements constant time memcmp. It's good practice
- * to use constant time functions for cryptographic functions.
- */
-static inline int constant_time_memcmp(const void * a, const void * b, size_t n)
-{
-    const uint8_t * A = (const uint8_t *) a;
-    const uint8_t * B = (const uint8_t *) b;
-    uint8_t diff      = 0;
-
-    for (size_t i = 0; i < n; i++)
-    {
-        diff |= (A[i] ^ B[i]);
-    }
-
-    return diff;
-}
-
 CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::MacVerify(const uint8_t * key, size_t key_len, const uint8_t * mac, size_t mac_len,
                                                     const uint8_t * in, size_t in_len)
 {
@@ -941,7 +1301,7 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::FEGenerate(void * fe)
 
     Spake2p_Context * context = to_inner_spake2p_context(&mSpake2pContext);
 
-    result = mbedtls_ecp_gen_privkey(&context->curve, (mbedtls_mpi *) fe, CryptoRNG, nullptr);
+    result = mbedtls_ecp_gen_privkey(context->curve, (mbedtls_mpi *) fe, CryptoRNG, nullptr);
     VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
 
 exit:
@@ -969,7 +1329,7 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::PointLoad(const uint8_t * in, size_t i
 {
     Spake2p_Context * context = to_inner_spake2p_context(&mSpake2pContext);
 
-    if (mbedtls_ecp_point_read_binary(&context->curve, (mbedtls_ecp_point *) R, Uint8::to_const_uchar(in), in_len) != 0)
+    if (mbedtls_ecp_point_read_binary(context->curve, (mbedtls_ecp_point *) R, Uint8::to_const_uchar(in), in_len) != 0)
     {
         return CHIP_ERROR_INTERNAL;
     }
@@ -984,7 +1344,7 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::PointWrite(const void * R, uint8_t * o
 
     Spake2p_Context * context = to_inner_spake2p_context(&mSpake2pContext);
 
-    if (mbedtls_ecp_point_write_binary(&context->curve, (const mbedtls_ecp_point *) R, MBEDTLS_ECP_PF_UNCOMPRESSED,
+    if (mbedtls_ecp_point_write_binary(context->curve, (const mbedtls_ecp_point *) R, MBEDTLS_ECP_PF_UNCOMPRESSED,
                                        &mbedtls_out_len, Uint8::to_uchar(out), out_len) != 0)
     {
         return CHIP_ERROR_INTERNAL;
@@ -997,7 +1357,7 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::PointMul(void * R, const void * P1, co
 {
     Spake2p_Context * context = to_inner_spake2p_context(&mSpake2pContext);
 
-    if (mbedtls_ecp_mul(&context->curve, (mbedtls_ecp_point *) R, (const mbedtls_mpi *) fe1, (const mbedtls_ecp_point *) P1,
+    if (mbedtls_ecp_mul(context->curve, (mbedtls_ecp_point *) R, (const mbedtls_mpi *) fe1, (const mbedtls_ecp_point *) P1,
                         CryptoRNG, nullptr) != 0)
     {
         return CHIP_ERROR_INTERNAL;
@@ -1011,7 +1371,7 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::PointAddMul(void * R, const void * P1,
 {
     Spake2p_Context * context = to_inner_spake2p_context(&mSpake2pContext);
 
-    if (mbedtls_ecp_muladd(&context->curve, (mbedtls_ecp_point *) R, (const mbedtls_mpi *) fe1, (const mbedtls_ecp_point *) P1,
+    if (mbedtls_ecp_muladd(context->curve, (mbedtls_ecp_point *) R, (const mbedtls_mpi *) fe1, (const mbedtls_ecp_point *) P1,
                            (const mbedtls_mpi *) fe2, (const mbedtls_ecp_point *) P2) != 0)
     {
         return CHIP_ERROR_INTERNAL;
@@ -1025,7 +1385,7 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::PointInvert(void * R)
     mbedtls_ecp_point * Rp    = (mbedtls_ecp_point *) R;
     Spake2p_Context * context = to_inner_spake2p_context(&mSpake2pContext);
 
-    if (mbedtls_mpi_sub_mpi(&Rp->Y, &context->curve.P, &Rp->Y) != 0)
+    if (mbedtls_mpi_sub_mpi(&Rp->Y, &context->curve->P, &Rp->Y) != 0)
     {
         return CHIP_ERROR_INTERNAL;
     }
@@ -1043,36 +1403,34 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::ComputeL(uint8_t * Lout, size_t * L_le
     CHIP_ERROR error = CHIP_NO_ERROR;
     int result       = 0;
 
-    mbedtls_ecp_group curve;
+    P256SharedCurve * curve = _getP256SharedCurve();
     mbedtls_mpi w1_bn;
     mbedtls_ecp_point Ltemp;
 
-    mbedtls_ecp_group_init(&curve);
     mbedtls_mpi_init(&w1_bn);
     mbedtls_ecp_point_init(&Ltemp);
 
-    result = mbedtls_ecp_group_load(&curve, MBEDTLS_ECP_DP_SECP256R1);
-    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(curve != nullptr, error = CHIP_ERROR_INTERNAL);
 
     result = mbedtls_mpi_read_binary(&w1_bn, Uint8::to_const_uchar(w1in), w1in_len);
     VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
 
-    result = mbedtls_mpi_mod_mpi(&w1_bn, &w1_bn, &curve.N);
+    result = mbedtls_mpi_mod_mpi(&w1_bn, &w1_bn, &curve->group.N);
     VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
 
-    result = mbedtls_ecp_mul(&curve, &Ltemp, &w1_bn, &curve.G, CryptoRNG, nullptr);
+    result = mbedtls_ecp_mul(&curve->group, &Ltemp, &w1_bn, &curve->group.G, CryptoRNG, nullptr);
     VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
 
     memset(Lout, 0, *L_len);
 
-    result = mbedtls_ecp_point_write_binary(&curve, &Ltemp, MBEDTLS_ECP_PF_UNCOMPRESSED, L_len, Uint8::to_uchar(Lout), *L_len);
+    result = mbedtls_ecp_point_write_binary(&curve->group, &Ltemp, MBEDTLS_ECP_PF_UNCOMPRESSED, L_len, Uint8::to_uchar(Lout),
+                                            *L_len);
     VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
 
 exit:
     _log_mbedTLS_error(result);
     mbedtls_ecp_point_free(&Ltemp);
     mbedtls_mpi_free(&w1_bn);
-    mbedtls_ecp_group_free(&curve);
 
     return error;
 }
@@ -1081,7 +1439,7 @@ CHIP_ERROR Spake2p_P256_SHA256_HKDF_HMAC::PointIsValid(void * R)
 {
     Spake2p_Context * context = to_inner_spake2p_context(&mSpake2pContext);
 
-    if (mbedtls_ecp_check_pubkey(&context->curve, (mbedtls_ecp_point *) R) != 0)
+    if (mbedtls_ecp_check_pubkey(context->curve, (mbedtls_ecp_point *) R) != 0)
     {
         return CHIP_ERROR_INTERNAL;
     }
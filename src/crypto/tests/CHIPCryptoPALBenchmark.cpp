@@ -0,0 +1,386 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Benchmark reporting operations per second for the P-256 and key
+ *      derivation primitives of the crypto PAL.
+ *
+ */
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <support/CodeUtils.h>
+#include <support/ErrorStr.h>
+#include <system/SystemClock.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace chip;
+using namespace chip::Crypto;
+
+namespace {
+
+constexpr uint32_t kDefaultIterations = 500;
+
+constexpr size_t kAesCcmBatchSize     = 32;
+constexpr size_t kAesCcmKeyLength     = 16;
+constexpr size_t kAesCcmNonceLength   = 13;
+constexpr size_t kAesCcmTagLength     = 16;
+constexpr size_t kAesCcmPayloadLength = 64;
+
+const uint8_t kMessage[]        = "Benchmark message for P-256 ECDSA signing and verification";
+const uint8_t kSpake2pContext[] = "SPAKE2+ benchmark context";
+const uint8_t kProverId[]       = "prover";
+const uint8_t kVerifierId[]     = "verifier";
+const uint8_t kHkdfSalt[]       = "salt";
+const uint8_t kHkdfInfo[]       = "info";
+
+// Arbitrary w0 and w1 values, reduced modulo the group order by the implementation.
+const uint8_t kW0[kP256_FE_Length] = { 0xe6, 0x88, 0x7c, 0xf9, 0xbd, 0xfb, 0x75, 0x79, 0xc6, 0x9b, 0xf4, 0x79, 0x28, 0xa8, 0x45,
+                                       0x14, 0xb5, 0xe3, 0x55, 0xac, 0x03, 0x48, 0x63, 0xf7, 0xff, 0xaf, 0x43, 0x90, 0xe6, 0x7d,
+                                       0x79, 0x8c };
+const uint8_t kW1[kP256_FE_Length] = { 0x24, 0xb5, 0xae, 0x4a, 0xbd, 0xa8, 0x68, 0xec, 0x93, 0x36, 0xff, 0xc3, 0xb7, 0x8e, 0xe3,
+                                       0x1c, 0x57, 0x55, 0xbe, 0xf1, 0x75, 0x92, 0x27, 0xef, 0x53, 0x72, 0xca, 0x13, 0x9b, 0x94,
+                                       0xe5, 0x12 };
+
+class Stopwatch
+{
+public:
+    Stopwatch() : mStart(System::Platform::Layer::GetClock_MonotonicHiRes()) {}
+
+    void Report(const char * label, uint32_t ops) const
+    {
+        uint64_t elapsedUs = System::Platform::Layer::GetClock_MonotonicHiRes() - mStart;
+        if (elapsedUs == 0)
+        {
+            elapsedUs = 1;
+        }
+
+        printf("%-30s %8" PRIu32 " ops in %10" PRIu64 " us: %12.1f ops/sec\n", label, ops, elapsedUs,
+               static_cast<double>(ops) * System::kTimerFactor_micro_per_unit / static_cast<double>(elapsedUs));
+    }
+
+private:
+    uint64_t mStart;
+};
+
+CHIP_ERROR RunKeypairGeneration(uint32_t iterations)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    Stopwatch stopwatch;
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        P256Keypair keypair;
+
+        err = keypair.Initialize();
+        SuccessOrExit(err);
+    }
+
+    stopwatch.Report("P256 keypair generation", iterations);
+
+exit:
+    return err;
+}
+
+CHIP_ERROR RunECDH(uint32_t iterations)
+{
+    CHIP_ERROR err;
+    P256Keypair local;
+    P256Keypair remote;
+    P256ECDHDerivedSecret secret;
+
+    err = local.Initialize();
+    SuccessOrExit(err);
+
+    err = remote.Initialize();
+    SuccessOrExit(err);
+
+    {
+        Stopwatch stopwatch;
+
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            secret.SetLength(0);
+
+            err = local.ECDH_derive_secret(remote.Pubkey(), secret);
+            SuccessOrExit(err);
+        }
+
+        stopwatch.Report("P256 ECDH", iterations);
+    }
+
+exit:
+    return err;
+}
+
+CHIP_ERROR RunECDSA(uint32_t iterations)
+{
+    CHIP_ERROR err;
+    P256Keypair keypair;
+    P256ECDSASignature signature;
+
+    err = keypair.Initialize();
+    SuccessOrExit(err);
+
+    {
+        Stopwatch stopwatch;
+
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            err = keypair.ECDSA_sign_msg(kMessage, sizeof(kMessage), signature);
+            SuccessOrExit(err);
+        }
+
+        stopwatch.Report("P256 ECDSA sign", iterations);
+    }
+
+    {
+        Stopwatch stopwatch;
+
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            err = keypair.Pubkey().ECDSA_validate_msg_signature(kMessage, sizeof(kMessage), signature);
+            SuccessOrExit(err);
+        }
+
+        stopwatch.Report("P256 ECDSA verify", iterations);
+    }
+
+exit:
+    return err;
+}
+
+CHIP_ERROR RunSpake2pExchange(const uint8_t * L, size_t L_len)
+{
+    CHIP_ERROR err;
+    Spake2p_P256_SHA256_HKDF_HMAC prover;
+    Spake2p_P256_SHA256_HKDF_HMAC verifier;
+    uint8_t X[kMAX_Point_Length];
+    size_t X_len = sizeof(X);
+    uint8_t Y[kMAX_Point_Length];
+    size_t Y_len = sizeof(Y);
+    uint8_t proverMac[kMAX_Hash_Length];
+    size_t proverMac_len = sizeof(proverMac);
+    uint8_t verifierMac[kMAX_Hash_Length];
+    size_t verifierMac_len = sizeof(verifierMac);
+
+    err = prover.Init(kSpake2pContext, sizeof(kSpake2pContext));
+    SuccessOrExit(err);
+
+    err = prover.BeginProver(kProverId, sizeof(kProverId), kVerifierId, sizeof(kVerifierId), kW0, sizeof(kW0), kW1, sizeof(kW1));
+    SuccessOrExit(err);
+
+    err = verifier.Init(kSpake2pContext, sizeof(kSpake2pContext));
+    SuccessOrExit(err);
+
+    err = verifier.BeginVerifier(kVerifierId, sizeof(kVerifierId), kProverId, sizeof(kProverId), kW0, sizeof(kW0), L, L_len);
+    SuccessOrExit(err);
+
+    err = prover.ComputeRoundOne(X, &X_len);
+    SuccessOrExit(err);
+
+    err = verifier.ComputeRoundOne(Y, &Y_len);
+    SuccessOrExit(err);
+
+    err = verifier.ComputeRoundTwo(X, X_len, verifierMac, &verifierMac_len);
+    SuccessOrExit(err);
+
+    err = prover.ComputeRoundTwo(Y, Y_len, proverMac, &proverMac_len);
+    SuccessOrExit(err);
+
+    err = prover.KeyConfirm(verifierMac, verifierMac_len);
+    SuccessOrExit(err);
+
+    err = verifier.KeyConfirm(proverMac, proverMac_len);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+CHIP_ERROR RunSpake2p(uint32_t iterations)
+{
+    CHIP_ERROR err;
+    uint8_t L[kMAX_Point_Length];
+    size_t L_len = sizeof(L);
+
+    {
+        Spake2p_P256_SHA256_HKDF_HMAC verifier;
+
+        err = verifier.Init(kSpake2pContext, sizeof(kSpake2pContext));
+        SuccessOrExit(err);
+
+        err = verifier.ComputeL(L, &L_len, kW1, sizeof(kW1));
+        SuccessOrExit(err);
+    }
+
+    {
+        Stopwatch stopwatch;
+
+        // Each exchange runs both rounds on both the prover and the verifier side.
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            err = RunSpake2pExchange(L, L_len);
+            SuccessOrExit(err);
+        }
+
+        stopwatch.Report("Spake2p exchange", iterations);
+    }
+
+exit:
+    return err;
+}
+
+CHIP_ERROR RunAesCcm(uint32_t iterations)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    uint8_t key[kAesCcmKeyLength];
+    uint8_t nonces[kAesCcmBatchSize][kAesCcmNonceLength];
+    uint8_t payloads[kAesCcmBatchSize][kAesCcmPayloadLength];
+    uint8_t tags[kAesCcmBatchSize][kAesCcmTagLength];
+    AES_CCM_BatchEntry entries[kAesCcmBatchSize];
+
+    // The same message encrypted for many peers under a shared key, as for a group command.
+    memset(key, 0x42, sizeof(key));
+    for (size_t i = 0; i < kAesCcmBatchSize; i++)
+    {
+        memset(nonces[i], static_cast<int>(i), sizeof(nonces[i]));
+        memset(payloads[i], 0x5a, sizeof(payloads[i]));
+
+        entries[i].key          = key;
+        entries[i].key_length   = sizeof(key);
+        entries[i].iv           = nonces[i];
+        entries[i].iv_length    = sizeof(nonces[i]);
+        entries[i].aad          = kHkdfInfo;
+        entries[i].aad_length   = sizeof(kHkdfInfo);
+        entries[i].input        = payloads[i];
+        entries[i].input_length = sizeof(payloads[i]);
+        entries[i].output       = payloads[i];
+        entries[i].tag          = tags[i];
+        entries[i].tag_length   = sizeof(tags[i]);
+    }
+
+    {
+        Stopwatch stopwatch;
+
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            for (size_t j = 0; j < kAesCcmBatchSize; j++)
+            {
+                err = AES_CCM_encrypt(payloads[j], sizeof(payloads[j]), kHkdfInfo, sizeof(kHkdfInfo), key, sizeof(key), nonces[j],
+                                      sizeof(nonces[j]), payloads[j], tags[j], sizeof(tags[j]));
+                SuccessOrExit(err);
+            }
+        }
+
+        stopwatch.Report("AES-CCM encrypt", static_cast<uint32_t>(iterations * kAesCcmBatchSize));
+    }
+
+    {
+        Stopwatch stopwatch;
+
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            err = AES_CCM_encrypt_batch(entries, kAesCcmBatchSize);
+            SuccessOrExit(err);
+        }
+
+        stopwatch.Report("AES-CCM encrypt batch", static_cast<uint32_t>(iterations * kAesCcmBatchSize));
+    }
+
+    {
+        Stopwatch stopwatch;
+
+        // Each round decrypts what the previous round encrypted, so every tag verifies.
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            err = AES_CCM_decrypt_batch(entries, kAesCcmBatchSize);
+            SuccessOrExit(err);
+
+            err = AES_CCM_encrypt_batch(entries, kAesCcmBatchSize);
+            SuccessOrExit(err);
+        }
+
+        stopwatch.Report("AES-CCM decrypt+encrypt batch", static_cast<uint32_t>(iterations * kAesCcmBatchSize));
+    }
+
+exit:
+    return err;
+}
+
+CHIP_ERROR RunHKDF(uint32_t iterations)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    uint8_t out[2 * kSHA256_Hash_Length];
+    Stopwatch stopwatch;
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        err = HKDF_SHA256(kW0, sizeof(kW0), kHkdfSalt, sizeof(kHkdfSalt), kHkdfInfo, sizeof(kHkdfInfo), out, sizeof(out));
+        SuccessOrExit(err);
+    }
+
+    stopwatch.Report("HKDF-SHA256", iterations);
+
+exit:
+    return err;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    CHIP_ERROR err;
+    uint32_t iterations = kDefaultIterations;
+
+    if (argc > 1)
+    {
+        iterations = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    }
+
+    err = RunKeypairGeneration(iterations);
+    SuccessOrExit(err);
+
+    err = RunECDH(iterations);
+    SuccessOrExit(err);
+
+    err = RunECDSA(iterations);
+    SuccessOrExit(err);
+
+    err = RunSpake2p(iterations);
+    SuccessOrExit(err);
+
+    err = RunAesCcm(iterations);
+    SuccessOrExit(err);
+
+    err = RunHKDF(iterations * 10);
+    SuccessOrExit(err);
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Crypto benchmark failed: %s\n", ErrorStr(err));
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
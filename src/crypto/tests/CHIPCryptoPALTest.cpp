@@ -390,6 +390,104 @@ static void TestAES_CCM_128DecryptTestVectors(nlTestSuite * inSuite, void * inCo
     NL_TEST_ASSERT(inSuite, numOfTestsRan > 0);
 }
 
+static void TestAES_CCM_128BatchTestVectors(nlTestSuite * inSuite, void * inContext)
+{
+    // Every vector appears twice in a row so that the second run reuses the key schedule of the first.
+    constexpr size_t kNumOfEntries = 2 * ArraySize(ccm_128_test_vectors);
+    constexpr size_t kMaxTextLen   = 64;
+    constexpr size_t kMaxTagLen    = 16;
+
+    AES_CCM_BatchEntry entries[kNumOfEntries];
+    uint8_t texts[kNumOfEntries][kMaxTextLen];
+    uint8_t tags[kNumOfEntries][kMaxTagLen];
+    size_t numOfEntries       = 0;
+    CHIP_ERROR expectedResult = CHIP_NO_ERROR;
+
+    for (size_t vectorIndex = 0; vectorIndex < ArraySize(ccm_128_test_vectors); vectorIndex++)
+    {
+        const ccm_128_test_vector * vector = ccm_128_test_vectors[vectorIndex];
+        if (vector->pt_len == 0)
+        {
+            continue;
+        }
+        NL_TEST_ASSERT(inSuite, vector->ct_len <= kMaxTextLen && vector->tag_len <= kMaxTagLen);
+
+        for (int copy = 0; copy < 2; copy++)
+        {
+            AES_CCM_BatchEntry & entry = entries[numOfEntries++];
+
+            entry.key          = vector->key;
+            entry.key_length   = vector->key_len;
+            entry.iv           = vector->iv;
+            entry.iv_length    = vector->iv_len;
+            entry.aad          = vector->aad;
+            entry.aad_length   = vector->aad_len;
+            entry.input        = vector->pt;
+            entry.input_length = vector->pt_len;
+            entry.output       = texts[numOfEntries - 1];
+            entry.tag          = tags[numOfEntries - 1];
+            entry.tag_length   = vector->tag_len;
+        }
+
+        if (expectedResult == CHIP_NO_ERROR)
+        {
+            expectedResult = vector->result;
+        }
+    }
+    NL_TEST_ASSERT(inSuite, numOfEntries > 0);
+
+    NL_TEST_ASSERT(inSuite, AES_CCM_encrypt_batch(entries, numOfEntries) == expectedResult);
+
+    for (size_t i = 0, vectorIndex = 0; i < numOfEntries; vectorIndex++)
+    {
+        const ccm_128_test_vector * vector = ccm_128_test_vectors[vectorIndex];
+        if (vector->pt_len == 0)
+        {
+            continue;
+        }
+
+        for (int copy = 0; copy < 2; copy++, i++)
+        {
+            NL_TEST_ASSERT(inSuite, entries[i].status == vector->result);
+            if (vector->result == CHIP_NO_ERROR)
+            {
+                NL_TEST_ASSERT(inSuite, memcmp(texts[i], vector->ct, vector->ct_len) == 0);
+                NL_TEST_ASSERT(inSuite, memcmp(tags[i], vector->tag, vector->tag_len) == 0);
+            }
+
+            // Decrypt in place what was just encrypted.
+            entries[i].input = texts[i];
+        }
+    }
+
+    // Corrupt the tag of one entry; only that entry must fail to decrypt.
+    tags[0][0] ^= 0x01;
+
+    NL_TEST_ASSERT(inSuite, AES_CCM_decrypt_batch(entries, numOfEntries) != CHIP_NO_ERROR);
+
+    for (size_t i = 0, vectorIndex = 0; i < numOfEntries; vectorIndex++)
+    {
+        const ccm_128_test_vector * vector = ccm_128_test_vectors[vectorIndex];
+        if (vector->pt_len == 0)
+        {
+            continue;
+        }
+
+        for (int copy = 0; copy < 2; copy++, i++)
+        {
+            if (i == 0)
+            {
+                NL_TEST_ASSERT(inSuite, entries[i].status != CHIP_NO_ERROR);
+            }
+            else if (vector->result == CHIP_NO_ERROR)
+            {
+                NL_TEST_ASSERT(inSuite, entries[i].status == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, memcmp(texts[i], vector->pt, vector->pt_len) == 0);
+            }
+        }
+    }
+}
+
 static void TestAES_CCM_128EncryptInvalidPlainText(nlTestSuite * inSuite, void * inContext)
 {
     int numOfTestVectors = ArraySize(ccm_128_test_vectors);
@@ -765,6 +863,58 @@ static void TestECDSA_ValidationFailIncorrectHashSignature(nlTestSuite * inSuite
     NL_TEST_ASSERT(inSuite, validation_error == CHIP_ERROR_INVALID_SIGNATURE);
 }
 
+static void TestECDSA_VerifierBatchValidation(nlTestSuite * inSuite, void * inContext)
+{
+    const uint8_t hash[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+                             0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F };
+    size_t hash_length   = sizeof(hash);
+
+    P256Keypair trustedKeypair;
+    NL_TEST_ASSERT(inSuite, trustedKeypair.Initialize() == CHIP_NO_ERROR);
+
+    P256Keypair otherKeypair;
+    NL_TEST_ASSERT(inSuite, otherKeypair.Initialize() == CHIP_NO_ERROR);
+
+    P256ECDSASignature trustedSignature;
+    NL_TEST_ASSERT(inSuite, trustedKeypair.ECDSA_sign_hash(hash, hash_length, trustedSignature) == CHIP_NO_ERROR);
+
+    P256ECDSASignature otherSignature;
+    NL_TEST_ASSERT(inSuite, otherKeypair.ECDSA_sign_hash(hash, hash_length, otherSignature) == CHIP_NO_ERROR);
+
+    P256ECDSAVerifier verifier;
+    NL_TEST_ASSERT(inSuite, verifier.AddTrustedKey(trustedKeypair.Pubkey()) == CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, verifier.Init() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, verifier.AddTrustedKey(trustedKeypair.Pubkey()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, verifier.IsTrustedKey(trustedKeypair.Pubkey()));
+    NL_TEST_ASSERT(inSuite, !verifier.IsTrustedKey(otherKeypair.Pubkey()));
+
+    // Single verifications through both the trusted and the untrusted key paths.
+    NL_TEST_ASSERT(inSuite,
+                   verifier.ECDSA_validate_hash_signature(trustedKeypair.Pubkey(), hash, hash_length, trustedSignature) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   verifier.ECDSA_validate_hash_signature(otherKeypair.Pubkey(), hash, hash_length, otherSignature) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   verifier.ECDSA_validate_hash_signature(trustedKeypair.Pubkey(), hash, hash_length, otherSignature) ==
+                       CHIP_ERROR_INVALID_SIGNATURE);
+
+    // A batch with one bad entry reports every result individually.
+    P256ECDSAVerifyRequest requests[] = {
+        { &trustedKeypair.Pubkey(), hash, hash_length, &trustedSignature, CHIP_ERROR_INTERNAL },
+        { &otherKeypair.Pubkey(), hash, hash_length, &trustedSignature, CHIP_ERROR_INTERNAL },
+        { &otherKeypair.Pubkey(), hash, hash_length, &otherSignature, CHIP_ERROR_INTERNAL },
+    };
+    NL_TEST_ASSERT(inSuite,
+                   verifier.ECDSA_validate_hash_signatures(requests, ArraySize(requests)) == CHIP_ERROR_INVALID_SIGNATURE);
+    NL_TEST_ASSERT(inSuite, requests[0].mResult == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, requests[1].mResult == CHIP_ERROR_INVALID_SIGNATURE);
+    NL_TEST_ASSERT(inSuite, requests[2].mResult == CHIP_NO_ERROR);
+
+    verifier.Clear();
+    NL_TEST_ASSERT(inSuite, !verifier.IsTrustedKey(trustedKeypair.Pubkey()));
+}
+
 static void TestECDSA_SigningMsgInvalidParams(nlTestSuite * inSuite, void * inContext)
 {
     const uint8_t * msg = reinterpret_cast<const uint8_t *>("Hello World!");
@@ -877,6 +1027,28 @@ static void TestECDH_EstablishSecret(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, signatures_match);
 }
 
+static void TestECDH_InvalidPublicKey(nlTestSuite * inSuite, void * inContext)
+{
+    P256Keypair keypair1;
+    NL_TEST_ASSERT(inSuite, keypair1.Initialize() == CHIP_NO_ERROR);
+
+    P256Keypair keypair2;
+    NL_TEST_ASSERT(inSuite, keypair2.Initialize() == CHIP_NO_ERROR);
+
+    // Flipping a bit of the Y coordinate moves the point off the curve.
+    P256PublicKey invalid_key;
+    memcpy(Uint8::to_uchar(invalid_key), Uint8::to_const_uchar(keypair2.Pubkey()), invalid_key.Length());
+    Uint8::to_uchar(invalid_key)[invalid_key.Length() - 1] ^= 0x01;
+
+    P256ECDHDerivedSecret out_secret;
+    CHIP_ERROR error = keypair1.ECDH_derive_secret(invalid_key, out_secret);
+    NL_TEST_ASSERT(inSuite, error != CHIP_NO_ERROR);
+
+    // Keys and the shared curve are still usable after the failure.
+    error = keypair1.ECDH_derive_secret(keypair2.Pubkey(), out_secret);
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+}
+
 #if CHIP_CRYPTO_OPENSSL
 static void TestAddEntropySources(nlTestSuite * inSuite, void * inContext)
 {
@@ -1363,6 +1535,7 @@ static const nlTest sTests[] = {
 
     NL_TEST_DEF("Test encrypting AES-CCM-128 test vectors", TestAES_CCM_128EncryptTestVectors),
     NL_TEST_DEF("Test decrypting AES-CCM-128 test vectors", TestAES_CCM_128DecryptTestVectors),
+    NL_TEST_DEF("Test batched AES-CCM-128 encryption and decryption", TestAES_CCM_128BatchTestVectors),
     NL_TEST_DEF("Test encrypting AES-CCM-128 invalid plain text", TestAES_CCM_128EncryptInvalidPlainText),
     NL_TEST_DEF("Test encrypting AES-CCM-128 using nil key", TestAES_CCM_128EncryptNilKey),
     NL_TEST_DEF("Test encrypting AES-CCM-128 using invalid IV", TestAES_CCM_128EncryptInvalidIVLen),
@@ -1386,6 +1559,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Test ECDSA signature validation fail - Different hash", TestECDSA_ValidationFailsDifferentHash),
     NL_TEST_DEF("Test ECDSA signature validation fail - Different msg signature", TestECDSA_ValidationFailIncorrectMsgSignature),
     NL_TEST_DEF("Test ECDSA signature validation fail - Different hash signature", TestECDSA_ValidationFailIncorrectHashSignature),
+    NL_TEST_DEF("Test ECDSA batched signature validation with a long-lived verifier", TestECDSA_VerifierBatchValidation),
     NL_TEST_DEF("Test ECDSA sign msg invalid parameters", TestECDSA_SigningMsgInvalidParams),
     NL_TEST_DEF("Test ECDSA sign hash invalid parameters", TestECDSA_SigningHashInvalidParams),
     NL_TEST_DEF("Test ECDSA msg signature validation invalid parameters", TestECDSA_ValidationMsgInvalidParam),
@@ -1396,6 +1570,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Test DRBG invalid inputs", TestDRBG_InvalidInputs),
     NL_TEST_DEF("Test DRBG output", TestDRBG_Output),
     NL_TEST_DEF("Test ECDH derive shared secret", TestECDH_EstablishSecret),
+    NL_TEST_DEF("Test ECDH derive shared secret with invalid public key", TestECDH_InvalidPublicKey),
     NL_TEST_DEF("Test adding entropy sources", TestAddEntropySources),
     NL_TEST_DEF("Test PBKDF2 SHA256", TestPBKDF2_SHA256_TestVectors),
     NL_TEST_DEF("Test P256 Keygen", TestP256_Keygen),
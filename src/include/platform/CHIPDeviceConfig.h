@@ -968,3 +968,16 @@
 #ifndef CHIP_DEVICE_CONFIG_FIRMWARE_BUILD_TIME
 #define CHIP_DEVICE_CONFIG_FIRMWARE_BUILD_TIME __TIME__
 #endif
+
+// -------------------- Data Model Configuration --------------------
+
+/**
+ * CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT
+ *
+ * The number of endpoints the application can register at runtime with emberAfSetDynamicEndpoint(),
+ * on top of the fixed endpoints generated in endpoint_config.h. A bridge uses them for the devices it
+ * exposes. The fixed and dynamic endpoints together must number less than 255.
+ */
+#ifndef CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT
+#define CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT 0
+#endif
@@ -29,6 +29,8 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <time.h>
 
 #if CHIP_SYSTEM_CONFIG_USE_SOCKETS
 #if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
@@ -56,8 +58,20 @@ INET_ERROR AsyncDNSResolverSockets::Init(InetLayer * aInet)
 
     mInet = aInet;
 
-    mAsyncDNSQueueHead = nullptr;
-    mAsyncDNSQueueTail = nullptr;
+    mAsyncDNSQueueHead   = nullptr;
+    mAsyncDNSQueueTail   = nullptr;
+    mCompletedQueueHead  = nullptr;
+    mCompletedQueueTail  = nullptr;
+    mCompletionScheduled = false;
+    mCompletionRetry     = false;
+
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+    for (DNSCacheEntry & entry : mCache)
+    {
+        entry.numAddrs = 0;
+    }
+    mCacheHitCount = 0;
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
 
     pthreadErr = pthread_cond_init(&mAsyncDNSCondVar, nullptr);
     VerifyOrDie(pthreadErr == 0);
@@ -160,6 +174,9 @@ INET_ERROR AsyncDNSResolverSockets::PrepareDNSResolver(DNSResolver & resolver, c
 /**
  *  Enqueue a DNSResolver object for asynchronous IP address resolution of a specified hostname.
  *
+ *  Host names found in the DNS cache are completed on the CHIP thread without involving a
+ *  worker thread. The completion callback is still invoked asynchronously.
+ *
  *  @param[in]  resolver    A reference to the DNSResolver object.
  *
  *  @retval #INET_NO_ERROR                   if a DNS request is queued
@@ -176,6 +193,18 @@ INET_ERROR AsyncDNSResolverSockets::EnqueueRequest(DNSResolver & resolver)
 
     AsyncMutexLock();
 
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+    if (LookupCache(resolver))
+    {
+        mCacheHitCount++;
+        AsyncMutexUnlock();
+
+        ChipLogDetail(Inet, "DNS cache hit for %s", resolver.asyncHostNameBuf);
+        NotifyChipThread(&resolver);
+        return err;
+    }
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
+
     // Add the DNSResolver object to the queue.
     if (mAsyncDNSQueueHead == nullptr)
     {
@@ -212,6 +241,31 @@ INET_ERROR AsyncDNSResolverSockets::DequeueRequest(DNSResolver ** outResolver)
     // block until there is work to do or we detect a shutdown
     while ((mAsyncDNSQueueHead == nullptr) && (mInet->State == InetLayer::kState_Initialized))
     {
+        if (mCompletionRetry)
+        {
+            // The completion event could not be posted: give the system layer some time to
+            // free a timer, then post it again for the completions still queued.
+            struct timespec deadline;
+
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += INET_CONFIG_DNS_COMPLETION_RETRY_MS * 1000000L;
+            deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+            deadline.tv_nsec %= 1000000000L;
+
+            pthreadErr = pthread_cond_timedwait(&mAsyncDNSCondVar, &mAsyncDNSMutex, &deadline);
+            VerifyOrDie(pthreadErr == 0 || pthreadErr == ETIMEDOUT);
+
+            if (mCompletionRetry && (mInet->State == InetLayer::kState_Initialized))
+            {
+                mCompletionRetry = false;
+
+                AsyncMutexUnlock();
+                ScheduleCompletionEvent();
+                AsyncMutexLock();
+            }
+            continue;
+        }
+
         pthreadErr = pthread_cond_wait(&mAsyncDNSCondVar, &mAsyncDNSMutex);
         VerifyOrDie(pthreadErr == 0);
     }
@@ -289,6 +343,13 @@ void AsyncDNSResolverSockets::Resolve(DNSResolver & resolver)
     // was successful this will copy the resultant addresses into the caller's array.
     resolver.asyncDNSResolveResult = resolver.ProcessGetAddrInfoResult(gaiReturnCode, gaiResults);
 
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+    if ((resolver.asyncDNSResolveResult == INET_NO_ERROR) && (resolver.mState != DNSResolver::kState_Canceled))
+    {
+        UpdateCache(resolver);
+    }
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
+
     // Set the DNS resolver state.
     resolver.mState = DNSResolver::kState_Complete;
 
@@ -296,24 +357,192 @@ void AsyncDNSResolverSockets::Resolve(DNSResolver & resolver)
     AsyncMutexUnlock();
 }
 
-/* Event handler function for asynchronous DNS notification */
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+/**
+ *  Complete a DNSResolver object from the DNS cache. Must be called with the mutex held.
+ *
+ *  An entry is only used if it yields exactly what getaddrinfo() would, i.e. it was stored
+ *  for the same address limit, or it holds the whole answer and that fits the request.
+ *
+ *  @retval true    if the resolver was completed from the cache.
+ */
+bool AsyncDNSResolverSockets::LookupCache(DNSResolver & resolver)
+{
+    const uint8_t addrFamily = static_cast<uint8_t>(resolver.DNSOptions & kDNSOption_AddrFamily_Mask);
+    const uint64_t nowMs     = System::Layer::GetClock_MonotonicMS();
+
+    for (DNSCacheEntry & entry : mCache)
+    {
+        if (entry.numAddrs == 0)
+        {
+            continue;
+        }
+
+        if (entry.expiryMs <= nowMs)
+        {
+            entry.numAddrs = 0;
+            continue;
+        }
+
+        if ((entry.addrFamily != addrFamily) || (strcasecmp(entry.hostName, resolver.asyncHostNameBuf) != 0))
+        {
+            continue;
+        }
+
+        if ((entry.maxAddrs != resolver.MaxAddrs) && !(entry.complete && (entry.numAddrs <= resolver.MaxAddrs)))
+        {
+            return false;
+        }
+
+        for (uint8_t i = 0; i < entry.numAddrs; i++)
+        {
+            resolver.AddrArray[i] = entry.addrs[i];
+        }
+        resolver.NumAddrs              = entry.numAddrs;
+        resolver.asyncDNSResolveResult = INET_NO_ERROR;
+        resolver.mState                = DNSResolver::kState_Complete;
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ *  Store the addresses a worker thread resolved in the DNS cache, replacing the entry that
+ *  expires first if the cache is full. Must be called with the mutex held.
+ */
+void AsyncDNSResolverSockets::UpdateCache(const DNSResolver & resolver)
+{
+    const uint8_t addrFamily = static_cast<uint8_t>(resolver.DNSOptions & kDNSOption_AddrFamily_Mask);
+    DNSCacheEntry * slot     = nullptr;
+
+    if ((resolver.NumAddrs == 0) || (resolver.NumAddrs > INET_CONFIG_MAX_DNS_ADDRS))
+    {
+        return;
+    }
+
+    for (DNSCacheEntry & entry : mCache)
+    {
+        if ((entry.numAddrs != 0) && (entry.addrFamily == addrFamily) &&
+            (strcasecmp(entry.hostName, resolver.asyncHostNameBuf) == 0))
+        {
+            slot = &entry;
+            break;
+        }
+
+        if ((slot == nullptr) || (slot->numAddrs != 0 && (entry.numAddrs == 0 || entry.expiryMs < slot->expiryMs)))
+        {
+            slot = &entry;
+        }
+    }
+
+    strcpy(slot->hostName, resolver.asyncHostNameBuf);
+    for (uint8_t i = 0; i < resolver.NumAddrs; i++)
+    {
+        slot->addrs[i] = resolver.AddrArray[i];
+    }
+    slot->addrFamily = addrFamily;
+    slot->maxAddrs   = resolver.MaxAddrs;
+    slot->numAddrs   = resolver.NumAddrs;
+    slot->complete   = (resolver.NumAddrs < resolver.MaxAddrs);
+    slot->expiryMs   = System::Layer::GetClock_MonotonicMS() + INET_CONFIG_DNS_CACHE_TTL_MS;
+}
+
+uint32_t AsyncDNSResolverSockets::GetCacheHitCount()
+{
+    uint32_t count;
+
+    AsyncMutexLock();
+    count = mCacheHitCount;
+    AsyncMutexUnlock();
+
+    return count;
+}
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
+
+/* Event handler function for asynchronous DNS notification, completes all resolvers queued so far */
 void AsyncDNSResolverSockets::DNSResultEventHandler(chip::System::Layer * aLayer, void * aAppState, chip::System::Error aError)
 {
-    DNSResolver * resolver = static_cast<DNSResolver *>(aAppState);
+    AsyncDNSResolverSockets * asyncResolver = static_cast<AsyncDNSResolverSockets *>(aAppState);
+    DNSResolver * resolver;
+
+    asyncResolver->AsyncMutexLock();
+
+    resolver                            = asyncResolver->mCompletedQueueHead;
+    asyncResolver->mCompletedQueueHead  = nullptr;
+    asyncResolver->mCompletedQueueTail  = nullptr;
+    asyncResolver->mCompletionScheduled = false;
+
+    asyncResolver->AsyncMutexUnlock();
 
-    if (resolver)
+    while (resolver != nullptr)
     {
+        // The completion releases the resolver object.
+        DNSResolver * next = resolver->pNextAsyncDNSResolver;
+
         resolver->HandleAsyncResolveComplete();
+        resolver = next;
     }
 }
 
 void AsyncDNSResolverSockets::NotifyChipThread(DNSResolver * resolver)
 {
-    // Post work item via Timer Event for the CHIP thread
-    chip::System::Layer & lSystemLayer = resolver->SystemLayer();
+    // Queue the completed resolver. Only the first completion posts a work item (waking the
+    // CHIP thread through the system layer wake event); later ones ride along with it.
+    AsyncMutexLock();
+
+    resolver->pNextAsyncDNSResolver = nullptr;
+    if (mCompletedQueueTail != nullptr)
+    {
+        mCompletedQueueTail->pNextAsyncDNSResolver = resolver;
+    }
+    else
+    {
+        mCompletedQueueHead = resolver;
+    }
+    mCompletedQueueTail = resolver;
+
+    AsyncMutexUnlock();
+
+    ScheduleCompletionEvent();
+}
+
+/* Post DNSResultEventHandler for the queued completions, unless it is already pending. */
+void AsyncDNSResolverSockets::ScheduleCompletionEvent()
+{
+    bool scheduleWork;
+    int pthreadErr;
+
+    AsyncMutexLock();
+
+    scheduleWork         = (mCompletedQueueHead != nullptr) && !mCompletionScheduled;
+    mCompletionScheduled = mCompletionScheduled || scheduleWork;
+
+    AsyncMutexUnlock();
+
+    if (!scheduleWork)
+    {
+        return;
+    }
 
     ChipLogDetail(Inet, "Posting DNS completion event to CHIP thread.");
-    lSystemLayer.ScheduleWork(AsyncDNSResolverSockets::DNSResultEventHandler, resolver);
+
+    if (mInet->SystemLayer()->ScheduleWork(AsyncDNSResolverSockets::DNSResultEventHandler, this) != CHIP_SYSTEM_NO_ERROR)
+    {
+        // Have an idle worker thread retry, so that the completions do not wait for another one.
+        ChipLogError(Inet, "Failed to post DNS completion event, retrying");
+
+        AsyncMutexLock();
+
+        mCompletionScheduled = false;
+        mCompletionRetry     = true;
+
+        pthreadErr = pthread_cond_signal(&mAsyncDNSCondVar);
+        VerifyOrDie(pthreadErr == 0);
+
+        AsyncMutexUnlock();
+    }
 }
 
 void * AsyncDNSResolverSockets::AsyncDNSThreadRun(void * args)
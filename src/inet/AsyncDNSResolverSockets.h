@@ -67,13 +67,40 @@ public:
                                   uint8_t maxAddrs, IPAddress * addrArray, DNSResolver::OnResolveCompleteFunct onComplete,
                                   void * appState);
 
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+    /* The number of resolutions completed from the DNS cache since Init. */
+    uint32_t GetCacheHitCount();
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
+
 private:
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+    /* A resolved host name, keyed on the name and the requested address family. */
+    struct DNSCacheEntry
+    {
+        char hostName[NL_DNS_HOSTNAME_MAX_LEN + 1];
+        uint8_t addrFamily; /* kDNSOption_AddrFamily_* of the request. */
+        uint8_t maxAddrs;   /* Address limit of the request. */
+        uint8_t numAddrs;   /* Number of valid entries in addrs, 0 if unused. */
+        bool complete;      /* The limit was not reached, i.e. addrs holds the whole answer. */
+        uint64_t expiryMs;  /* Monotonic time at which the entry becomes stale. */
+        IPAddress addrs[INET_CONFIG_MAX_DNS_ADDRS];
+    };
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
+
     pthread_t mAsyncDNSThreadHandle[INET_CONFIG_DNS_ASYNC_MAX_THREAD_COUNT];
-    pthread_mutex_t mAsyncDNSMutex;            /* Mutex for accessing the DNSResolver queue. */
+    pthread_mutex_t mAsyncDNSMutex;            /* Mutex for accessing the DNSResolver queues and the cache. */
     pthread_cond_t mAsyncDNSCondVar;           /* Condition Variable for thread synchronization. */
     volatile DNSResolver * mAsyncDNSQueueHead; /* The head of the asynchronous DNSResolver object queue. */
     volatile DNSResolver * mAsyncDNSQueueTail; /* The tail of the asynchronous DNSResolver object queue. */
+    DNSResolver * mCompletedQueueHead;         /* The head of the queue of completed DNSResolver objects. */
+    DNSResolver * mCompletedQueueTail;         /* The tail of the queue of completed DNSResolver objects. */
+    bool mCompletionScheduled;                 /* Whether DNSResultEventHandler is pending on the CHIP thread. */
+    bool mCompletionRetry;                     /* Whether a worker thread must post DNSResultEventHandler again. */
     InetLayer * mInet;                         /* The pointer to the InetLayer. */
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+    DNSCacheEntry mCache[INET_CONFIG_DNS_CACHE_SIZE]; /* Recently resolved host names. */
+    uint32_t mCacheHitCount;                          /* Resolutions completed from mCache. */
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
     static void
     DNSResultEventHandler(chip::System::Layer * aLayer, void * aAppState,
                           chip::System::Error aError); /* Timer event handler function for asynchronous DNS notification */
@@ -88,7 +115,15 @@ private:
 
     static void * AsyncDNSThreadRun(void * args);
 
-    static void NotifyChipThread(DNSResolver * resolver);
+    void NotifyChipThread(DNSResolver * resolver);
+
+    void ScheduleCompletionEvent();
+
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+    bool LookupCache(DNSResolver & resolver);
+
+    void UpdateCache(const DNSResolver & resolver);
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
 
     void AsyncMutexLock();
 
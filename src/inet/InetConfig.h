@@ -400,6 +400,84 @@
 #define INET_CONFIG_DNS_ASYNC_MAX_THREAD_COUNT             2
 #endif // INET_CONFIG_DNS_ASYNC_MAX_THREAD_COUNT
 
+/**
+ * @def INET_CONFIG_DNS_CACHE_SIZE
+ *
+ * @brief The number of host names whose resolved addresses are kept by
+ * the asynchronous DNS resolver, so that repeated resolutions complete
+ * without a worker thread round trip. Set to 0 to disable the cache.
+ */
+#ifndef INET_CONFIG_DNS_CACHE_SIZE
+#define INET_CONFIG_DNS_CACHE_SIZE                         8
+#endif // INET_CONFIG_DNS_CACHE_SIZE
+
+/**
+ * @def INET_CONFIG_DNS_CACHE_TTL_MS
+ *
+ * @brief How long, in milliseconds, resolved addresses are kept in the
+ * DNS cache. getaddrinfo() does not report record TTLs, so all entries
+ * use this lifetime.
+ */
+#ifndef INET_CONFIG_DNS_CACHE_TTL_MS
+#define INET_CONFIG_DNS_CACHE_TTL_MS                       60000
+#endif // INET_CONFIG_DNS_CACHE_TTL_MS
+
+/**
+ * @def INET_CONFIG_DNS_COMPLETION_RETRY_MS
+ *
+ * @brief How long, in milliseconds, the asynchronous DNS resolver waits
+ * before posting its completion event to the CHIP thread again after the
+ * system layer failed to schedule it.
+ */
+#ifndef INET_CONFIG_DNS_COMPLETION_RETRY_MS
+#define INET_CONFIG_DNS_COMPLETION_RETRY_MS                10
+#endif // INET_CONFIG_DNS_COMPLETION_RETRY_MS
+
+/**
+ * @def INET_CONFIG_ENABLE_INTERFACE_WATCHER
+ *
+ * @brief Enable (1) or disable (0) tracking of network interfaces and
+ * their addresses through netlink notifications, see InterfaceWatcher.
+ * Only available for Linux sockets.
+ */
+#ifndef INET_CONFIG_ENABLE_INTERFACE_WATCHER
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS && defined(__linux__)
+#define INET_CONFIG_ENABLE_INTERFACE_WATCHER               1
+#else
+#define INET_CONFIG_ENABLE_INTERFACE_WATCHER               0
+#endif
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
+
+/**
+ * @def INET_CONFIG_INTERFACE_WATCHER_MAX_INTERFACES
+ *
+ * @brief The number of network interfaces the interface watcher keeps
+ * track of. Further interfaces are ignored.
+ */
+#ifndef INET_CONFIG_INTERFACE_WATCHER_MAX_INTERFACES
+#define INET_CONFIG_INTERFACE_WATCHER_MAX_INTERFACES       16
+#endif // INET_CONFIG_INTERFACE_WATCHER_MAX_INTERFACES
+
+/**
+ * @def INET_CONFIG_INTERFACE_WATCHER_MAX_ADDRESSES
+ *
+ * @brief The number of interface addresses the interface watcher keeps
+ * track of. Further addresses are ignored.
+ */
+#ifndef INET_CONFIG_INTERFACE_WATCHER_MAX_ADDRESSES
+#define INET_CONFIG_INTERFACE_WATCHER_MAX_ADDRESSES        32
+#endif // INET_CONFIG_INTERFACE_WATCHER_MAX_ADDRESSES
+
+/**
+ * @def INET_CONFIG_INTERFACE_WATCHER_MAX_LISTENERS
+ *
+ * @brief The number of listeners that can be notified of interface
+ * and address changes.
+ */
+#ifndef INET_CONFIG_INTERFACE_WATCHER_MAX_LISTENERS
+#define INET_CONFIG_INTERFACE_WATCHER_MAX_LISTENERS        4
+#endif // INET_CONFIG_INTERFACE_WATCHER_MAX_LISTENERS
+
 /**
  *  @def INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
  *
@@ -287,6 +287,14 @@ INET_ERROR InetLayer::Init(chip::System::Layer & aSystemLayer, void * aContext)
     SuccessOrExit(err);
 
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+    // Not fatal: without the watcher, users enumerate the interfaces themselves
+    if (mInterfaceWatcher.Init() != INET_NO_ERROR)
+    {
+        ChipLogProgress(Inet, "Interface change tracking not available");
+    }
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 
 exit:
@@ -336,6 +344,10 @@ INET_ERROR InetLayer::Shutdown()
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER
 
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+        mInterfaceWatcher.Shutdown();
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
+
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
         // Close all raw endpoints owned by this Inet layer instance.
         for (size_t i = 0; i < RawEndPoint::sPool.Size(); i++)
@@ -1166,6 +1178,10 @@ void InetLayer::PrepareSelect(int & nfds, fd_set * readfds, fd_set * writefds, f
             lEndPoint->PrepareIO().SetFDs(lEndPoint->mSocket, nfds, readfds, writefds, exceptfds);
     }
 #endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+    mInterfaceWatcher.PrepareSelect(nfds, readfds);
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
 }
 
 /**
@@ -1272,6 +1288,10 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set * readfds, fd_set * wri
             }
         }
 #endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+        mInterfaceWatcher.HandleSelectResult(readfds);
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
     }
 }
 
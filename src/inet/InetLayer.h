@@ -77,6 +77,9 @@
 #if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 #include <inet/AsyncDNSResolverSockets.h>
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+#include <inet/InterfaceWatcher.h>
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 
 #include <system/SystemLayer.h>
@@ -217,6 +220,17 @@ public:
 #if CHIP_SYSTEM_CONFIG_USE_SOCKETS
     void PrepareSelect(int & nfds, fd_set * readfds, fd_set * writefds, fd_set * exceptfds, struct timeval & sleepTime);
     void HandleSelectResult(int selectRes, fd_set * readfds, fd_set * writefds, fd_set * exceptfds);
+
+#if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+    /// Resolver pool and cache behind ResolveHostAddress.
+    AsyncDNSResolverSockets & GetAsyncDNSResolver() { return mAsyncDNSResolver; }
+#endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+    /// Cached interface and address table. Not active if it could not be initialized,
+    /// in which case users fall back to enumerating the interfaces.
+    InterfaceWatcher & GetInterfaceWatcher() { return mInterfaceWatcher; }
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 
     static void UpdateSnapshot(chip::System::Stats::Snapshot & aSnapshot);
@@ -296,6 +310,10 @@ private:
     AsyncDNSResolverSockets mAsyncDNSResolver;
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+    InterfaceWatcher mInterfaceWatcher;
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
+
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 
     friend INET_ERROR Platform::InetLayer::WillInit(Inet::InetLayer * aLayer, void * aContext);
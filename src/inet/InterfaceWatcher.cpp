@@ -0,0 +1,659 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements InterfaceWatcher on top of a NETLINK_ROUTE socket.
+ *
+ */
+
+#include "InterfaceWatcher.h"
+
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+
+#include <support/CodeUtils.h>
+#include <support/ErrorStr.h>
+#include <support/ReturnMacros.h>
+#include <support/logging/CHIPLogging.h>
+#include <system/SystemError.h>
+
+#include <errno.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace chip {
+namespace Inet {
+namespace {
+
+constexpr int kDumpTimeoutMs          = 1000;
+constexpr size_t kReceiveBufferSize   = 8192;
+constexpr size_t kMessageHeaderSize   = NLMSG_ALIGN(sizeof(struct nlmsghdr));
+constexpr size_t kAttributeHeaderSize = RTA_ALIGN(sizeof(struct rtattr));
+
+/// Calls handler(type, data, length) for every route attribute in [data, data + length).
+template <typename Handler>
+void ForEachAttribute(const uint8_t * data, size_t length, Handler handler)
+{
+    while (length >= sizeof(struct rtattr))
+    {
+        struct rtattr attribute;
+
+        memcpy(&attribute, data, sizeof(attribute));
+        if ((attribute.rta_len < kAttributeHeaderSize) || (attribute.rta_len > length))
+        {
+            return;
+        }
+
+        handler(attribute.rta_type, data + kAttributeHeaderSize, attribute.rta_len - kAttributeHeaderSize);
+
+        const size_t alignedLength = RTA_ALIGN(attribute.rta_len);
+        if (alignedLength >= length)
+        {
+            return;
+        }
+        data += alignedLength;
+        length -= alignedLength;
+    }
+}
+
+} // namespace
+
+InterfaceWatcher::InterfaceWatcher() :
+    mSocket(-1), mSequence(0), mGeneration(0), mDumpState(DumpState::kIdle), mResyncPending(false)
+{
+    for (size_t i = 0; i < kMaxInterfaces; i++)
+    {
+        mInterfaces[i].interfaceId = 0;
+        mInterfaceSeen[i]          = false;
+    }
+    for (size_t i = 0; i < kMaxAddresses; i++)
+    {
+        mAddresses[i].interfaceId = 0;
+        mAddressSeen[i]           = false;
+    }
+    for (InterfaceChangeListener *& listener : mListeners)
+    {
+        listener = nullptr;
+    }
+}
+
+INET_ERROR InterfaceWatcher::Init()
+{
+    INET_ERROR err = INET_NO_ERROR;
+    struct sockaddr_nl address;
+
+    VerifyOrExit(mSocket < 0, err = INET_ERROR_INCORRECT_STATE);
+
+    mSocket = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    VerifyOrExit(mSocket >= 0, err = chip::System::MapErrorPOSIX(errno));
+
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+
+    VerifyOrExit(bind(mSocket, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) == 0,
+                 err = chip::System::MapErrorPOSIX(errno));
+
+    SuccessOrExit(err = StartResync());
+    SuccessOrExit(err = ReceiveDump());
+
+exit:
+    if (err != INET_NO_ERROR)
+    {
+        ChipLogError(Inet, "Interface watcher init failed: %s", ErrorStr(err));
+        Shutdown();
+    }
+    return err;
+}
+
+void InterfaceWatcher::Shutdown()
+{
+    if (mSocket >= 0)
+    {
+        close(mSocket);
+        mSocket = -1;
+    }
+    mDumpState     = DumpState::kIdle;
+    mResyncPending = false;
+
+    for (InterfaceEntry & entry : mInterfaces)
+    {
+        entry.interfaceId = 0;
+    }
+    for (AddressEntry & entry : mAddresses)
+    {
+        entry.interfaceId = 0;
+    }
+    mGeneration++;
+}
+
+INET_ERROR InterfaceWatcher::AddListener(InterfaceChangeListener * listener)
+{
+    InterfaceChangeListener ** freeSlot = nullptr;
+
+    for (InterfaceChangeListener *& slot : mListeners)
+    {
+        if (slot == listener)
+        {
+            return INET_NO_ERROR;
+        }
+        if ((slot == nullptr) && (freeSlot == nullptr))
+        {
+            freeSlot = &slot;
+        }
+    }
+
+    VerifyOrReturnError(freeSlot != nullptr, INET_ERROR_NO_MEMORY);
+    *freeSlot = listener;
+
+    return INET_NO_ERROR;
+}
+
+void InterfaceWatcher::RemoveListener(InterfaceChangeListener * listener)
+{
+    for (InterfaceChangeListener *& slot : mListeners)
+    {
+        if (slot == listener)
+        {
+            slot = nullptr;
+        }
+    }
+}
+
+void InterfaceWatcher::PrepareSelect(int & nfds, fd_set * readfds)
+{
+    if (mSocket >= 0)
+    {
+        FD_SET(mSocket, readfds);
+        if (mSocket + 1 > nfds)
+        {
+            nfds = mSocket + 1;
+        }
+    }
+}
+
+void InterfaceWatcher::HandleSelectResult(fd_set * readfds)
+{
+    if ((mSocket >= 0) && FD_ISSET(mSocket, readfds))
+    {
+        ReceiveNotifications();
+    }
+}
+
+const InterfaceWatcher::InterfaceEntry * InterfaceWatcher::FindInterface(InterfaceId interfaceId) const
+{
+    for (const InterfaceEntry & entry : mInterfaces)
+    {
+        if ((interfaceId != 0) && (entry.interfaceId == interfaceId))
+        {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+bool InterfaceWatcher::IsInterfaceUsable(InterfaceId interfaceId) const
+{
+    const InterfaceEntry * entry = FindInterface(interfaceId);
+
+    return (entry != nullptr) && entry->up && entry->multicast && !entry->loopback;
+}
+
+INET_ERROR InterfaceWatcher::RequestDump(uint16_t type)
+{
+    struct
+    {
+        struct nlmsghdr header;
+        struct rtgenmsg message;
+    } request;
+
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len     = static_cast<uint32_t>(NLMSG_LENGTH(sizeof(request.message)));
+    request.header.nlmsg_type    = type;
+    request.header.nlmsg_flags   = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq     = ++mSequence;
+    request.message.rtgen_family = AF_UNSPEC;
+
+    VerifyOrReturnError(send(mSocket, &request, request.header.nlmsg_len, 0) == static_cast<ssize_t>(request.header.nlmsg_len),
+                        chip::System::MapErrorPOSIX(errno));
+
+    return INET_NO_ERROR;
+}
+
+INET_ERROR InterfaceWatcher::ReceiveDump()
+{
+    uint8_t buffer[kReceiveBufferSize];
+    struct pollfd pollFd;
+
+    pollFd.fd     = mSocket;
+    pollFd.events = POLLIN;
+
+    // Notifications may be interleaved with the dumps, they are handled as they come
+    while (mDumpState != DumpState::kIdle)
+    {
+        pollFd.revents = 0;
+
+        int ready = poll(&pollFd, 1, kDumpTimeoutMs);
+        VerifyOrReturnError(ready >= 0, chip::System::MapErrorPOSIX(errno));
+        VerifyOrReturnError(ready > 0, INET_ERROR_IDLE_TIMEOUT);
+
+        ssize_t received = recv(mSocket, buffer, sizeof(buffer), 0);
+        if (received < 0)
+        {
+            VerifyOrReturnError(errno == EAGAIN || errno == EINTR, chip::System::MapErrorPOSIX(errno));
+            continue;
+        }
+
+        HandleMessages(buffer, static_cast<size_t>(received));
+    }
+
+    return INET_NO_ERROR;
+}
+
+void InterfaceWatcher::ReceiveNotifications()
+{
+    uint8_t buffer[kReceiveBufferSize];
+
+    while (true)
+    {
+        ssize_t received = recv(mSocket, buffer, sizeof(buffer), MSG_DONTWAIT);
+
+        if (received >= 0)
+        {
+            HandleMessages(buffer, static_cast<size_t>(received));
+            continue;
+        }
+
+        if (errno == ENOBUFS)
+        {
+            // Notifications were dropped: reload the table. The dumps are received from the
+            // select loop like the notifications, so this does not block.
+            ChipLogError(Inet, "Interface watcher overrun, reloading interfaces");
+            Resync();
+            continue;
+        }
+
+        // EAGAIN: everything pending was read
+        return;
+    }
+}
+
+void InterfaceWatcher::Resync()
+{
+    // The socket runs a single dump at a time
+    if (mDumpState != DumpState::kIdle)
+    {
+        mResyncPending = true;
+        return;
+    }
+
+    if (StartResync() != INET_NO_ERROR)
+    {
+        ChipLogError(Inet, "Interface watcher reload failed");
+    }
+}
+
+INET_ERROR InterfaceWatcher::StartResync()
+{
+    INET_ERROR err;
+
+    for (bool & seen : mInterfaceSeen)
+    {
+        seen = false;
+    }
+    for (bool & seen : mAddressSeen)
+    {
+        seen = false;
+    }
+    mResyncPending = false;
+
+    // Links first, so that addresses find their interface
+    err = RequestDump(RTM_GETLINK);
+    if (err == INET_NO_ERROR)
+    {
+        mDumpState = DumpState::kLinks;
+    }
+
+    return err;
+}
+
+void InterfaceWatcher::HandleDumpDone(bool failed)
+{
+    if (mResyncPending)
+    {
+        mDumpState = DumpState::kIdle;
+        Resync();
+        return;
+    }
+
+    if (failed)
+    {
+        // Entries missing from an incomplete dump may still exist, keep them
+        ChipLogError(Inet, "Interface watcher dump failed");
+        mDumpState = DumpState::kIdle;
+        return;
+    }
+
+    if (mDumpState == DumpState::kLinks)
+    {
+        SweepInterfaces();
+
+        mDumpState = DumpState::kAddresses;
+        if (RequestDump(RTM_GETADDR) != INET_NO_ERROR)
+        {
+            ChipLogError(Inet, "Interface watcher reload failed");
+            mDumpState = DumpState::kIdle;
+        }
+        return;
+    }
+
+    SweepAddresses();
+    mDumpState = DumpState::kIdle;
+}
+
+void InterfaceWatcher::SweepInterfaces()
+{
+    for (size_t i = 0; i < kMaxInterfaces; i++)
+    {
+        if ((mInterfaces[i].interfaceId != 0) && !mInterfaceSeen[i])
+        {
+            RemoveInterface(mInterfaces[i]);
+        }
+    }
+}
+
+void InterfaceWatcher::SweepAddresses()
+{
+    for (size_t i = 0; i < kMaxAddresses; i++)
+    {
+        if ((mAddresses[i].interfaceId != 0) && !mAddressSeen[i])
+        {
+            const InterfaceId interfaceId = mAddresses[i].interfaceId;
+
+            mAddresses[i].interfaceId = 0;
+            mGeneration++;
+            Notify(InterfaceChange::kAddressRemoved, interfaceId, mAddresses[i].address);
+        }
+    }
+}
+
+bool InterfaceWatcher::HandleMessages(const void * buffer, size_t length)
+{
+    const uint8_t * data = static_cast<const uint8_t *>(buffer);
+    bool dumpActive      = true;
+
+    while (length >= sizeof(struct nlmsghdr))
+    {
+        struct nlmsghdr header;
+
+        memcpy(&header, data, sizeof(header));
+        if ((header.nlmsg_len < kMessageHeaderSize) || (header.nlmsg_len > length))
+        {
+            break;
+        }
+
+        const uint8_t * payload    = data + kMessageHeaderSize;
+        const size_t payloadLength = header.nlmsg_len - kMessageHeaderSize;
+
+        switch (header.nlmsg_type)
+        {
+        case NLMSG_DONE:
+        case NLMSG_ERROR:
+            // Notifications may follow the end of the dump in the same datagram
+            dumpActive = false;
+            if ((mDumpState != DumpState::kIdle) && (header.nlmsg_seq == mSequence))
+            {
+                HandleDumpDone(header.nlmsg_type == NLMSG_ERROR);
+            }
+            break;
+        case RTM_NEWLINK:
+        case RTM_DELLINK:
+            HandleLink(payload, payloadLength, header.nlmsg_type == RTM_DELLINK);
+            break;
+        case RTM_NEWADDR:
+        case RTM_DELADDR:
+            HandleAddress(payload, payloadLength, header.nlmsg_type == RTM_DELADDR);
+            break;
+        default:
+            break;
+        }
+
+        const size_t alignedLength = NLMSG_ALIGN(header.nlmsg_len);
+        if (alignedLength >= length)
+        {
+            break;
+        }
+        data += alignedLength;
+        length -= alignedLength;
+    }
+
+    return dumpActive;
+}
+
+void InterfaceWatcher::HandleLink(const void * message, size_t length, bool removed)
+{
+    struct ifinfomsg info;
+    InterfaceEntry * entry = nullptr;
+    bool wasUp             = false;
+
+    VerifyOrReturn(length >= sizeof(info));
+    memcpy(&info, message, sizeof(info));
+    VerifyOrReturn(info.ifi_index > 0);
+
+    const InterfaceId interfaceId = static_cast<InterfaceId>(info.ifi_index);
+
+    entry = const_cast<InterfaceEntry *>(FindInterface(interfaceId));
+    if (removed)
+    {
+        if (entry != nullptr)
+        {
+            RemoveInterface(*entry);
+        }
+        return;
+    }
+
+    if (entry == nullptr)
+    {
+        for (InterfaceEntry & candidate : mInterfaces)
+        {
+            if (candidate.interfaceId == 0)
+            {
+                entry = &candidate;
+                break;
+            }
+        }
+        if (entry == nullptr)
+        {
+            ChipLogError(Inet, "Interface watcher table full, ignoring interface %d", info.ifi_index);
+            return;
+        }
+
+        entry->interfaceId = interfaceId;
+        entry->name[0]     = 0;
+    }
+    else
+    {
+        wasUp = entry->up;
+    }
+    mInterfaceSeen[entry - mInterfaces] = true;
+
+    ForEachAttribute(static_cast<const uint8_t *>(message) + NLMSG_ALIGN(sizeof(info)), length - NLMSG_ALIGN(sizeof(info)),
+                     [entry](unsigned short type, const uint8_t * value, size_t valueLength) {
+                         if ((type == IFLA_IFNAME) && (valueLength > 0))
+                         {
+                             const size_t nameLength = strnlen(reinterpret_cast<const char *>(value), valueLength);
+                             if (nameLength < sizeof(entry->name))
+                             {
+                                 memcpy(entry->name, value, nameLength);
+                                 entry->name[nameLength] = 0;
+                             }
+                         }
+                     });
+
+    entry->up        = (info.ifi_flags & IFF_UP) != 0;
+    entry->multicast = (info.ifi_flags & IFF_MULTICAST) != 0;
+    entry->loopback  = (info.ifi_flags & IFF_LOOPBACK) != 0;
+    mGeneration++;
+
+    if (entry->up && !wasUp)
+    {
+        Notify(InterfaceChange::kLinkUp, interfaceId, IPAddress::Any);
+    }
+    else if (!entry->up && wasUp)
+    {
+        Notify(InterfaceChange::kLinkDown, interfaceId, IPAddress::Any);
+    }
+}
+
+void InterfaceWatcher::RemoveInterface(InterfaceEntry & entry)
+{
+    const InterfaceId interfaceId = entry.interfaceId;
+    const bool wasUp              = entry.up;
+
+    for (AddressEntry & address : mAddresses)
+    {
+        if (address.interfaceId == interfaceId)
+        {
+            address.interfaceId = 0;
+            Notify(InterfaceChange::kAddressRemoved, interfaceId, address.address);
+        }
+    }
+
+    entry.interfaceId = 0;
+    mGeneration++;
+
+    if (wasUp)
+    {
+        Notify(InterfaceChange::kLinkDown, interfaceId, IPAddress::Any);
+    }
+}
+
+void InterfaceWatcher::HandleAddress(const void * message, size_t length, bool removed)
+{
+    struct ifaddrmsg info;
+    IPAddress address        = IPAddress::Any;
+    bool haveLocal           = false;
+    AddressEntry * entry     = nullptr;
+    AddressEntry * freeEntry = nullptr;
+
+    VerifyOrReturn(length >= sizeof(info));
+    memcpy(&info, message, sizeof(info));
+    VerifyOrReturn(info.ifa_index > 0);
+#if INET_CONFIG_ENABLE_IPV4
+    VerifyOrReturn(info.ifa_family == AF_INET || info.ifa_family == AF_INET6);
+#else
+    VerifyOrReturn(info.ifa_family == AF_INET6);
+#endif // INET_CONFIG_ENABLE_IPV4
+
+    // IFA_LOCAL is the local address on point-to-point links, where IFA_ADDRESS is the peer
+    ForEachAttribute(static_cast<const uint8_t *>(message) + NLMSG_ALIGN(sizeof(info)), length - NLMSG_ALIGN(sizeof(info)),
+                     [&](unsigned short type, const uint8_t * value, size_t valueLength) {
+                         if (((type != IFA_ADDRESS) && (type != IFA_LOCAL)) || (haveLocal && (type == IFA_ADDRESS)))
+                         {
+                             return;
+                         }
+                         if ((info.ifa_family == AF_INET6) && (valueLength >= sizeof(struct in6_addr)))
+                         {
+                             struct in6_addr ipv6;
+                             memcpy(&ipv6, value, sizeof(ipv6));
+                             address = IPAddress::FromIPv6(ipv6);
+                         }
+#if INET_CONFIG_ENABLE_IPV4
+                         else if ((info.ifa_family == AF_INET) && (valueLength >= sizeof(struct in_addr)))
+                         {
+                             struct in_addr ipv4;
+                             memcpy(&ipv4, value, sizeof(ipv4));
+                             address = IPAddress::FromIPv4(ipv4);
+                         }
+#endif // INET_CONFIG_ENABLE_IPV4
+                         haveLocal = haveLocal || (type == IFA_LOCAL);
+                     });
+
+    VerifyOrReturn(address != IPAddress::Any);
+
+    const InterfaceId interfaceId = static_cast<InterfaceId>(info.ifa_index);
+
+    for (AddressEntry & candidate : mAddresses)
+    {
+        if ((candidate.interfaceId == interfaceId) && (candidate.address == address))
+        {
+            entry = &candidate;
+        }
+        else if ((candidate.interfaceId == 0) && (freeEntry == nullptr))
+        {
+            freeEntry = &candidate;
+        }
+    }
+
+    if (removed)
+    {
+        if (entry != nullptr)
+        {
+            entry->interfaceId = 0;
+            mGeneration++;
+            Notify(InterfaceChange::kAddressRemoved, interfaceId, address);
+        }
+        return;
+    }
+
+    if (entry != nullptr)
+    {
+        mAddressSeen[entry - mAddresses] = true;
+        entry->prefixLength              = info.ifa_prefixlen;
+        return;
+    }
+
+    // Tentative addresses are reported again once duplicate address detection is done
+    VerifyOrReturn((info.ifa_flags & IFA_F_TENTATIVE) == 0);
+
+    if (freeEntry == nullptr)
+    {
+        ChipLogError(Inet, "Interface watcher table full, ignoring address");
+        return;
+    }
+
+    freeEntry->interfaceId               = interfaceId;
+    freeEntry->address                   = address;
+    freeEntry->prefixLength              = info.ifa_prefixlen;
+    mAddressSeen[freeEntry - mAddresses] = true;
+    mGeneration++;
+
+    Notify(InterfaceChange::kAddressAdded, interfaceId, address);
+}
+
+void InterfaceWatcher::Notify(InterfaceChange change, InterfaceId interfaceId, const IPAddress & address)
+{
+    // Listeners may remove themselves while being notified
+    for (size_t i = 0; i < kMaxListeners; i++)
+    {
+        if (mListeners[i] != nullptr)
+        {
+            mListeners[i]->OnInterfaceChanged(change, interfaceId, address);
+        }
+    }
+}
+
+} // namespace Inet
+} // namespace chip
+
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
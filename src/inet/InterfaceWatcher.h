@@ -0,0 +1,192 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines InterfaceWatcher, which keeps a table of the
+ *      network interfaces and their addresses up to date from netlink
+ *      notifications.
+ *
+ */
+
+#pragma once
+
+#include <inet/IPAddress.h>
+#include <inet/InetError.h>
+#include <inet/InetInterface.h>
+
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+
+#include <net/if.h>
+#include <sys/select.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace Inet {
+
+/**
+ * Kinds of changes reported by InterfaceWatcher.
+ */
+enum class InterfaceChange : uint8_t
+{
+    kLinkUp,         ///< The interface became usable (up), or appeared while up.
+    kLinkDown,       ///< The interface went down or was removed.
+    kAddressAdded,   ///< An address was assigned to the interface.
+    kAddressRemoved, ///< An address was removed from the interface.
+};
+
+/**
+ * Receives notifications of interface and address changes.
+ */
+class InterfaceChangeListener
+{
+public:
+    virtual ~InterfaceChangeListener() {}
+
+    /**
+     * @param[in] change       What changed.
+     * @param[in] interfaceId  The interface that changed.
+     * @param[in] address      The address for address changes, IPAddress::Any for link changes.
+     */
+    virtual void OnInterfaceChanged(InterfaceChange change, InterfaceId interfaceId, const IPAddress & address) = 0;
+};
+
+/**
+ *  @class InterfaceWatcher
+ *
+ *  @brief
+ *    Maintains a table of the system network interfaces and their addresses, kept
+ *    current by RTM_NEWLINK/RTM_DELLINK/RTM_NEWADDR/RTM_DELADDR netlink notifications.
+ *
+ *    The netlink socket is serviced from the select loop of the InetLayer that owns the
+ *    watcher, so listeners are notified on the CHIP thread. Users can read the table
+ *    instead of enumerating the interfaces with InterfaceIterator / InterfaceAddressIterator.
+ *
+ */
+class DLL_EXPORT InterfaceWatcher
+{
+public:
+    struct InterfaceEntry
+    {
+        InterfaceId interfaceId; ///< 0 if the entry is unused.
+        char name[IF_NAMESIZE];
+        bool up;
+        bool multicast;
+        bool loopback;
+    };
+
+    struct AddressEntry
+    {
+        InterfaceId interfaceId; ///< 0 if the entry is unused.
+        IPAddress address;
+        uint8_t prefixLength;
+    };
+
+    InterfaceWatcher();
+    ~InterfaceWatcher() { Shutdown(); }
+
+    /**
+     * Opens the netlink socket and loads the current interfaces and addresses. Waits for the
+     * initial dumps, so it should be called before the select loop runs.
+     */
+    INET_ERROR Init();
+
+    /**
+     * Closes the netlink socket and clears the table. Listeners are kept.
+     */
+    void Shutdown();
+
+    bool IsActive() const { return mSocket >= 0; }
+
+    INET_ERROR AddListener(InterfaceChangeListener * listener);
+    void RemoveListener(InterfaceChangeListener * listener);
+
+    void PrepareSelect(int & nfds, fd_set * readfds);
+    void HandleSelectResult(fd_set * readfds);
+
+    /**
+     * Applies a buffer of netlink messages to the table and notifies listeners of the
+     * resulting changes. Returns false if the buffer ended a multipart dump; messages
+     * following the end of the dump are applied as well.
+     *
+     * Called for every datagram read from the netlink socket; public so the message
+     * handling can be exercised without a netlink socket.
+     */
+    bool HandleMessages(const void * buffer, size_t length);
+
+    static constexpr size_t kMaxInterfaces = INET_CONFIG_INTERFACE_WATCHER_MAX_INTERFACES;
+    static constexpr size_t kMaxAddresses  = INET_CONFIG_INTERFACE_WATCHER_MAX_ADDRESSES;
+
+    /// Entries are valid if their interfaceId is not 0. Returns nullptr past the end of the table.
+    const InterfaceEntry * GetInterface(size_t index) const { return (index < kMaxInterfaces) ? &mInterfaces[index] : nullptr; }
+    const AddressEntry * GetAddress(size_t index) const { return (index < kMaxAddresses) ? &mAddresses[index] : nullptr; }
+
+    const InterfaceEntry * FindInterface(InterfaceId interfaceId) const;
+
+    /// Up, multicast capable and not a loopback interface.
+    bool IsInterfaceUsable(InterfaceId interfaceId) const;
+
+    /// Incremented on every change of the table, so users can tell when derived data is stale.
+    uint32_t GetGeneration() const { return mGeneration; }
+
+private:
+    friend class TestInterfaceWatcherAccess;
+
+    static constexpr size_t kMaxListeners = INET_CONFIG_INTERFACE_WATCHER_MAX_LISTENERS;
+
+    enum class DumpState : uint8_t
+    {
+        kIdle,
+        kLinks,     ///< Waiting for the end of the RTM_GETLINK dump.
+        kAddresses, ///< Waiting for the end of the RTM_GETADDR dump.
+    };
+
+    INET_ERROR RequestDump(uint16_t type);
+    INET_ERROR ReceiveDump();
+    void ReceiveNotifications();
+
+    // Reloading the table: every entry is marked stale, the dumps mark the entries still
+    // present, and the ones left stale at the end of a dump are removed.
+    void Resync();
+    INET_ERROR StartResync();
+    void HandleDumpDone(bool failed);
+    void SweepInterfaces();
+    void SweepAddresses();
+
+    void HandleLink(const void * message, size_t length, bool removed);
+    void HandleAddress(const void * message, size_t length, bool removed);
+    void RemoveInterface(InterfaceEntry & entry);
+    void Notify(InterfaceChange change, InterfaceId interfaceId, const IPAddress & address);
+
+    int mSocket;
+    uint32_t mSequence; // of the last dump request
+    uint32_t mGeneration;
+    DumpState mDumpState;
+    bool mResyncPending; // notifications were lost during a dump, start over once it ends
+    InterfaceEntry mInterfaces[kMaxInterfaces];
+    AddressEntry mAddresses[kMaxAddresses];
+    bool mInterfaceSeen[kMaxInterfaces]; // reported by the running dump
+    bool mAddressSeen[kMaxAddresses];
+    InterfaceChangeListener * mListeners[kMaxListeners];
+};
+
+} // namespace Inet
+} // namespace chip
+
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
@@ -401,6 +401,44 @@ static void TestDNSResolution_TextForm(nlTestSuite * testSuite, void * testConte
     // clang-format on
 }
 
+/**
+ * Test resolving the same name repeatedly, which may be answered from the DNS cache.
+ */
+static void TestDNSResolution_Repeated(nlTestSuite * testSuite, void * inContext)
+{
+#if INET_CONFIG_ENABLE_IPV4
+    const DNSResolutionTestCase testCase{ "localhost", kDNSOption_AddrFamily_IPv4Only, kMaxResults, INET_NO_ERROR, true, false };
+#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS && INET_CONFIG_DNS_CACHE_SIZE > 0
+    uint32_t cacheHits = gInet.GetAsyncDNSResolver().GetCacheHitCount();
+#endif
+
+    for (int i = 0; i < 3; i++)
+    {
+        DNSResolutionTestContext testContext{ testSuite, testCase };
+
+        StartTestCase(testContext);
+
+        // Completion is reported asynchronously, even for cached names.
+        NL_TEST_ASSERT(testSuite, testContext.callbackCalled == false);
+
+        ServiceNetworkUntilDone(DEFAULT_TEST_DURATION_MILLISECS);
+
+        NL_TEST_ASSERT(testSuite, gDone == true);
+        NL_TEST_ASSERT(testSuite, testContext.callbackCalled == true);
+        NL_TEST_ASSERT(testSuite, sNumResInProgress == 0);
+
+#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS && INET_CONFIG_DNS_CACHE_SIZE > 0
+        // Every lookup after the first one is answered from the cache.
+        if (i > 0)
+        {
+            NL_TEST_ASSERT(testSuite, gInet.GetAsyncDNSResolver().GetCacheHitCount() == cacheHits + 1);
+        }
+        cacheHits = gInet.GetAsyncDNSResolver().GetCacheHitCount();
+#endif
+    }
+#endif // INET_CONFIG_ENABLE_IPV4
+}
+
 static void TestDNSResolution_Cancel(nlTestSuite * testSuite, void * inContext)
 {
     DNSResolutionTestContext testContext{
@@ -685,6 +723,7 @@ int TestInetLayerDNSInternal()
         NL_TEST_DEF("TestDNSResolution:TextForm",          TestDNSResolution_TextForm),
         NL_TEST_DEF("TestDNSResolution:NoRecord",          TestDNSResolution_NoRecord),
         NL_TEST_DEF("TestDNSResolution:NoHostRecord",      TestDNSResolution_NoHostRecord),
+        NL_TEST_DEF("TestDNSResolution:Repeated",          TestDNSResolution_Repeated),
         NL_TEST_DEF("TestDNSResolution:Cancel",            TestDNSResolution_Cancel),
         NL_TEST_DEF("TestDNSResolution:Simultaneous",      TestDNSResolution_Simultaneous),
         NL_TEST_SENTINEL() };
@@ -0,0 +1,431 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for InterfaceWatcher, feeding
+ *      it synthetic netlink messages.
+ *
+ */
+
+#include <inet/InterfaceWatcher.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace chip {
+namespace Inet {
+
+class TestInterfaceWatcherAccess
+{
+public:
+    // Stands in for the netlink socket, so that reloads can send their dump requests
+    static void SetSocket(InterfaceWatcher & watcher, int socket) { watcher.mSocket = socket; }
+    static void Overrun(InterfaceWatcher & watcher) { watcher.Resync(); }
+    static uint32_t DumpSequence(const InterfaceWatcher & watcher) { return watcher.mSequence; }
+};
+
+} // namespace Inet
+} // namespace chip
+
+using namespace chip::Inet;
+
+namespace {
+
+constexpr InterfaceId kEth0 = 2;
+constexpr InterfaceId kWlan = 3;
+
+/// Builds netlink messages the way the kernel lays them out.
+class MessageBuilder
+{
+public:
+    MessageBuilder() { memset(mBuffer, 0, sizeof(mBuffer)); }
+
+    MessageBuilder & Link(uint16_t type, InterfaceId interfaceId, unsigned flags, const char * name)
+    {
+        struct ifinfomsg info;
+
+        memset(&info, 0, sizeof(info));
+        info.ifi_family = AF_UNSPEC;
+        info.ifi_index  = static_cast<int>(interfaceId);
+        info.ifi_flags  = flags;
+
+        StartMessage(type);
+        Append(&info, sizeof(info));
+        Attribute(IFLA_IFNAME, name, strlen(name) + 1);
+        return EndMessage();
+    }
+
+    MessageBuilder & Address(uint16_t type, InterfaceId interfaceId, const char * address, uint8_t flags = 0)
+    {
+        struct ifaddrmsg info;
+        IPAddress ipAddress;
+
+        IPAddress::FromString(address, ipAddress);
+
+        memset(&info, 0, sizeof(info));
+        info.ifa_family    = ipAddress.IsIPv4() ? AF_INET : AF_INET6;
+        info.ifa_prefixlen = ipAddress.IsIPv4() ? 24 : 64;
+        info.ifa_flags     = flags;
+        info.ifa_index     = static_cast<uint32_t>(interfaceId);
+
+        StartMessage(type);
+        Append(&info, sizeof(info));
+#if INET_CONFIG_ENABLE_IPV4
+        if (ipAddress.IsIPv4())
+        {
+            struct in_addr ipv4 = ipAddress.ToIPv4();
+            Attribute(IFA_LOCAL, &ipv4, sizeof(ipv4));
+            return EndMessage();
+        }
+#endif // INET_CONFIG_ENABLE_IPV4
+        struct in6_addr ipv6 = ipAddress.ToIPv6();
+        Attribute(IFA_ADDRESS, &ipv6, sizeof(ipv6));
+        return EndMessage();
+    }
+
+    MessageBuilder & Done(uint32_t sequence = 0)
+    {
+        StartMessage(NLMSG_DONE, sequence);
+        uint32_t status = 0;
+        Append(&status, sizeof(status));
+        return EndMessage();
+    }
+
+    const uint8_t * Data() const { return mBuffer; }
+    size_t Length() const { return mLength; }
+
+private:
+    void StartMessage(uint16_t type, uint32_t sequence = 0)
+    {
+        mMessageStart = mLength;
+        mType         = type;
+        mSequence     = sequence;
+        mLength += NLMSG_HDRLEN;
+    }
+
+    MessageBuilder & EndMessage()
+    {
+        struct nlmsghdr header;
+
+        memset(&header, 0, sizeof(header));
+        header.nlmsg_len  = static_cast<uint32_t>(mLength - mMessageStart);
+        header.nlmsg_type = mType;
+        header.nlmsg_seq  = mSequence;
+        memcpy(mBuffer + mMessageStart, &header, sizeof(header));
+        mLength = mMessageStart + NLMSG_ALIGN(header.nlmsg_len);
+        return *this;
+    }
+
+    void Attribute(uint16_t type, const void * value, size_t length)
+    {
+        struct rtattr attribute;
+
+        attribute.rta_type = type;
+        attribute.rta_len  = static_cast<unsigned short>(RTA_LENGTH(length));
+        mLength            = NLMSG_ALIGN(mLength);
+        Append(&attribute, sizeof(attribute));
+        Append(value, length);
+        mLength = RTA_ALIGN(mLength);
+    }
+
+    void Append(const void * data, size_t length)
+    {
+        memcpy(mBuffer + mLength, data, length);
+        mLength += length;
+    }
+
+    uint8_t mBuffer[1024];
+    size_t mLength       = 0;
+    size_t mMessageStart = 0;
+    uint16_t mType       = 0;
+    uint32_t mSequence   = 0;
+};
+
+class RecordingListener : public InterfaceChangeListener
+{
+public:
+    void OnInterfaceChanged(InterfaceChange change, InterfaceId interfaceId, const IPAddress & address) override
+    {
+        lastChange      = change;
+        lastInterfaceId = interfaceId;
+        lastAddress     = address;
+        count++;
+    }
+
+    InterfaceChange lastChange  = InterfaceChange::kLinkDown;
+    InterfaceId lastInterfaceId = 0;
+    IPAddress lastAddress       = IPAddress::Any;
+    unsigned count              = 0;
+};
+
+size_t CountAddresses(const InterfaceWatcher & watcher, InterfaceId interfaceId)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < InterfaceWatcher::kMaxAddresses; i++)
+    {
+        if ((watcher.GetAddress(i)->interfaceId != 0) && (watcher.GetAddress(i)->interfaceId == interfaceId))
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+void TestDump(nlTestSuite * inSuite, void * inContext)
+{
+    InterfaceWatcher watcher;
+    MessageBuilder dump;
+
+    dump.Link(RTM_NEWLINK, 1, IFF_UP | IFF_LOOPBACK | IFF_MULTICAST, "lo")
+        .Link(RTM_NEWLINK, kEth0, IFF_UP | IFF_MULTICAST, "eth0")
+        .Link(RTM_NEWLINK, kWlan, IFF_MULTICAST, "wlan0")
+        .Done();
+
+    NL_TEST_ASSERT(inSuite, !watcher.HandleMessages(dump.Data(), dump.Length()));
+
+    NL_TEST_ASSERT(inSuite, watcher.FindInterface(kEth0) != nullptr);
+    NL_TEST_ASSERT(inSuite, strcmp(watcher.FindInterface(kEth0)->name, "eth0") == 0);
+    NL_TEST_ASSERT(inSuite, watcher.IsInterfaceUsable(kEth0));
+    NL_TEST_ASSERT(inSuite, !watcher.IsInterfaceUsable(1));     // loopback
+    NL_TEST_ASSERT(inSuite, !watcher.IsInterfaceUsable(kWlan)); // down
+    NL_TEST_ASSERT(inSuite, !watcher.IsInterfaceUsable(42));    // unknown
+}
+
+void TestLinkChanges(nlTestSuite * inSuite, void * inContext)
+{
+    InterfaceWatcher watcher;
+    RecordingListener listener;
+
+    NL_TEST_ASSERT(inSuite, watcher.AddListener(&listener) == INET_NO_ERROR);
+
+    MessageBuilder down;
+    down.Link(RTM_NEWLINK, kWlan, IFF_MULTICAST, "wlan0");
+    NL_TEST_ASSERT(inSuite, watcher.HandleMessages(down.Data(), down.Length()));
+    NL_TEST_ASSERT(inSuite, listener.count == 0);
+
+    MessageBuilder up;
+    up.Link(RTM_NEWLINK, kWlan, IFF_UP | IFF_MULTICAST, "wlan0");
+    watcher.HandleMessages(up.Data(), up.Length());
+    NL_TEST_ASSERT(inSuite, listener.count == 1);
+    NL_TEST_ASSERT(inSuite, listener.lastChange == InterfaceChange::kLinkUp);
+    NL_TEST_ASSERT(inSuite, listener.lastInterfaceId == kWlan);
+
+    // no transition, no notification
+    const uint32_t generation = watcher.GetGeneration();
+    watcher.HandleMessages(up.Data(), up.Length());
+    NL_TEST_ASSERT(inSuite, listener.count == 1);
+    NL_TEST_ASSERT(inSuite, watcher.GetGeneration() != generation);
+
+    watcher.HandleMessages(down.Data(), down.Length());
+    NL_TEST_ASSERT(inSuite, listener.count == 2);
+    NL_TEST_ASSERT(inSuite, listener.lastChange == InterfaceChange::kLinkDown);
+
+    watcher.RemoveListener(&listener);
+    watcher.HandleMessages(up.Data(), up.Length());
+    NL_TEST_ASSERT(inSuite, listener.count == 2);
+}
+
+void TestAddressChanges(nlTestSuite * inSuite, void * inContext)
+{
+    InterfaceWatcher watcher;
+    RecordingListener listener;
+    IPAddress expected;
+
+    watcher.AddListener(&listener);
+
+    MessageBuilder setup;
+    setup.Link(RTM_NEWLINK, kEth0, IFF_UP | IFF_MULTICAST, "eth0").Address(RTM_NEWADDR, kEth0, "fe80::1");
+    watcher.HandleMessages(setup.Data(), setup.Length());
+
+    NL_TEST_ASSERT(inSuite, listener.lastChange == InterfaceChange::kAddressAdded);
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("fe80::1", expected) && (listener.lastAddress == expected));
+    NL_TEST_ASSERT(inSuite, CountAddresses(watcher, kEth0) == 1);
+
+    // tentative addresses are only added once duplicate address detection is done
+    const unsigned count = listener.count;
+    MessageBuilder tentative;
+    tentative.Address(RTM_NEWADDR, kEth0, "fe80::2", IFA_F_TENTATIVE);
+    watcher.HandleMessages(tentative.Data(), tentative.Length());
+    NL_TEST_ASSERT(inSuite, listener.count == count);
+    NL_TEST_ASSERT(inSuite, CountAddresses(watcher, kEth0) == 1);
+
+    // repeated notifications do not duplicate the address
+    watcher.HandleMessages(setup.Data(), setup.Length());
+    NL_TEST_ASSERT(inSuite, listener.count == count);
+    NL_TEST_ASSERT(inSuite, CountAddresses(watcher, kEth0) == 1);
+
+#if INET_CONFIG_ENABLE_IPV4
+    MessageBuilder ipv4;
+    ipv4.Address(RTM_NEWADDR, kEth0, "192.168.1.10");
+    watcher.HandleMessages(ipv4.Data(), ipv4.Length());
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("192.168.1.10", expected) && (listener.lastAddress == expected));
+    NL_TEST_ASSERT(inSuite, CountAddresses(watcher, kEth0) == 2);
+#endif // INET_CONFIG_ENABLE_IPV4
+
+    MessageBuilder removed;
+    removed.Address(RTM_DELADDR, kEth0, "fe80::1");
+    watcher.HandleMessages(removed.Data(), removed.Length());
+    NL_TEST_ASSERT(inSuite, listener.lastChange == InterfaceChange::kAddressRemoved);
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("fe80::1", expected) && (listener.lastAddress == expected));
+
+    // removing the link removes its addresses
+    MessageBuilder deleted;
+    deleted.Address(RTM_NEWADDR, kEth0, "fe80::3").Link(RTM_DELLINK, kEth0, 0, "eth0");
+    watcher.HandleMessages(deleted.Data(), deleted.Length());
+    NL_TEST_ASSERT(inSuite, listener.lastChange == InterfaceChange::kLinkDown);
+    NL_TEST_ASSERT(inSuite, CountAddresses(watcher, kEth0) == 0);
+    NL_TEST_ASSERT(inSuite, watcher.FindInterface(kEth0) == nullptr);
+}
+
+void TestMessagesAfterDumpEnd(nlTestSuite * inSuite, void * inContext)
+{
+    InterfaceWatcher watcher;
+    MessageBuilder messages;
+
+    // a notification sharing the datagram with the end of a dump is not lost
+    messages.Link(RTM_NEWLINK, kEth0, IFF_UP | IFF_MULTICAST, "eth0").Done().Link(RTM_NEWLINK, kWlan, IFF_UP, "wlan0");
+
+    NL_TEST_ASSERT(inSuite, !watcher.HandleMessages(messages.Data(), messages.Length()));
+    NL_TEST_ASSERT(inSuite, watcher.FindInterface(kEth0) != nullptr);
+    NL_TEST_ASSERT(inSuite, watcher.FindInterface(kWlan) != nullptr);
+}
+
+uint16_t ReceiveRequest(int socket)
+{
+    struct nlmsghdr header;
+
+    if (recv(socket, &header, sizeof(header), MSG_DONTWAIT) != static_cast<ssize_t>(sizeof(header)))
+    {
+        return 0;
+    }
+    return header.nlmsg_type;
+}
+
+void TestOverrunReload(nlTestSuite * inSuite, void * inContext)
+{
+    InterfaceWatcher watcher;
+    RecordingListener listener;
+    IPAddress expected;
+    int sockets[2];
+
+    NL_TEST_ASSERT(inSuite, socketpair(AF_UNIX, SOCK_DGRAM, 0, sockets) == 0);
+    TestInterfaceWatcherAccess::SetSocket(watcher, sockets[0]); // closed by the watcher
+
+    MessageBuilder setup;
+    setup.Link(RTM_NEWLINK, kEth0, IFF_UP | IFF_MULTICAST, "eth0")
+        .Link(RTM_NEWLINK, kWlan, IFF_UP | IFF_MULTICAST, "wlan0")
+        .Address(RTM_NEWADDR, kEth0, "fe80::1")
+        .Address(RTM_NEWADDR, kEth0, "fe80::2")
+        .Address(RTM_NEWADDR, kWlan, "fe80::3");
+    watcher.HandleMessages(setup.Data(), setup.Length());
+    watcher.AddListener(&listener);
+
+    // wlan0 disappeared while notifications were dropped
+    TestInterfaceWatcherAccess::Overrun(watcher);
+    NL_TEST_ASSERT(inSuite, ReceiveRequest(sockets[1]) == RTM_GETLINK);
+
+    MessageBuilder links;
+    links.Link(RTM_NEWLINK, kEth0, IFF_UP | IFF_MULTICAST, "eth0").Done(TestInterfaceWatcherAccess::DumpSequence(watcher));
+    watcher.HandleMessages(links.Data(), links.Length());
+    NL_TEST_ASSERT(inSuite, watcher.FindInterface(kWlan) == nullptr);
+    NL_TEST_ASSERT(inSuite, CountAddresses(watcher, kWlan) == 0);
+    NL_TEST_ASSERT(inSuite, listener.count == 2); // fe80::3 removed, wlan0 down
+    NL_TEST_ASSERT(inSuite, listener.lastChange == InterfaceChange::kLinkDown);
+    NL_TEST_ASSERT(inSuite, listener.lastInterfaceId == kWlan);
+    NL_TEST_ASSERT(inSuite, ReceiveRequest(sockets[1]) == RTM_GETADDR);
+
+    // another overrun during the address dump: nothing is swept, the reload starts over
+    TestInterfaceWatcherAccess::Overrun(watcher);
+
+    MessageBuilder addresses;
+    addresses.Address(RTM_NEWADDR, kEth0, "fe80::1").Done(TestInterfaceWatcherAccess::DumpSequence(watcher));
+    watcher.HandleMessages(addresses.Data(), addresses.Length());
+    NL_TEST_ASSERT(inSuite, CountAddresses(watcher, kEth0) == 2);
+    NL_TEST_ASSERT(inSuite, ReceiveRequest(sockets[1]) == RTM_GETLINK);
+
+    MessageBuilder links2;
+    links2.Link(RTM_NEWLINK, kEth0, IFF_UP | IFF_MULTICAST, "eth0").Done(TestInterfaceWatcherAccess::DumpSequence(watcher));
+    watcher.HandleMessages(links2.Data(), links2.Length());
+    NL_TEST_ASSERT(inSuite, listener.count == 2);
+    NL_TEST_ASSERT(inSuite, ReceiveRequest(sockets[1]) == RTM_GETADDR);
+
+    MessageBuilder addresses2;
+    addresses2.Address(RTM_NEWADDR, kEth0, "fe80::1").Done(TestInterfaceWatcherAccess::DumpSequence(watcher));
+    watcher.HandleMessages(addresses2.Data(), addresses2.Length());
+    NL_TEST_ASSERT(inSuite, CountAddresses(watcher, kEth0) == 1);
+    NL_TEST_ASSERT(inSuite, listener.count == 3);
+    NL_TEST_ASSERT(inSuite, listener.lastChange == InterfaceChange::kAddressRemoved);
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("fe80::2", expected) && (listener.lastAddress == expected));
+
+    // the reload is complete, a stray end of dump changes nothing
+    watcher.HandleMessages(addresses2.Data(), addresses2.Length());
+    NL_TEST_ASSERT(inSuite, ReceiveRequest(sockets[1]) == 0);
+
+    close(sockets[1]);
+}
+
+void TestMalformedMessages(nlTestSuite * inSuite, void * inContext)
+{
+    InterfaceWatcher watcher;
+    MessageBuilder messages;
+
+    messages.Link(RTM_NEWLINK, kEth0, IFF_UP | IFF_MULTICAST, "eth0");
+
+    // truncated messages are ignored
+    for (size_t length = 0; length < messages.Length(); length++)
+    {
+        NL_TEST_ASSERT(inSuite, watcher.HandleMessages(messages.Data(), length));
+        NL_TEST_ASSERT(inSuite, watcher.FindInterface(kEth0) == nullptr);
+    }
+
+    NL_TEST_ASSERT(inSuite, watcher.HandleMessages(messages.Data(), messages.Length()));
+    NL_TEST_ASSERT(inSuite, watcher.FindInterface(kEth0) != nullptr);
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestDump", TestDump),                                 //
+    NL_TEST_DEF("TestLinkChanges", TestLinkChanges),                   //
+    NL_TEST_DEF("TestAddressChanges", TestAddressChanges),             //
+    NL_TEST_DEF("TestMessagesAfterDumpEnd", TestMessagesAfterDumpEnd), //
+    NL_TEST_DEF("TestOverrunReload", TestOverrunReload),               //
+    NL_TEST_DEF("TestMalformedMessages", TestMalformedMessages),       //
+    NL_TEST_SENTINEL()                                                 //
+};
+
+} // namespace
+
+int TestInterfaceWatcher(void)
+{
+    nlTestSuite theSuite = { "InterfaceWatcher", sTests, nullptr, nullptr };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestInterfaceWatcher)
+
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
@@ -72,6 +72,36 @@ CHIPCircularTLVBuffer::CHIPCircularTLVBuffer(uint8_t * inBuffer, uint32_t inBuff
     mImplicitProfileId = kCommonProfileId;
 }
 
+/**
+ * @brief
+ *   CHIPCircularTLVBuffer constructor for a queue already holding data
+ *
+ * Used to read the tail end of another queue sharing the same backing
+ * store: with @a inHead set to the start of one of its elements and
+ * @a inDataLength to the number of bytes from there to its tail, a
+ * reader starts on that element rather than on the oldest one.
+ *
+ * @param[in] inBuffer       A pointer to the backing store for the queue
+ *
+ * @param[in] inBufferLength Length, in bytes, of the backing store
+ *
+ * @param[in] inHead         Start of the oldest element in the queue, within the backing store
+ *
+ * @param[in] inDataLength   Length, in bytes, of the data in the queue
+ */
+CHIPCircularTLVBuffer::CHIPCircularTLVBuffer(uint8_t * inBuffer, uint32_t inBufferLength, uint8_t * inHead, uint32_t inDataLength)
+{
+    mQueue       = inBuffer;
+    mQueueSize   = inBufferLength;
+    mQueueLength = inDataLength;
+    mQueueHead   = inHead;
+
+    mProcessEvictedElement = nullptr;
+    mAppData               = nullptr;
+
+    mImplicitProfileId = kCommonProfileId;
+}
+
 /**
  * @brief
  *   CHIPCircularTLVBuffer constructor
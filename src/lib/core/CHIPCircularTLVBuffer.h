@@ -59,6 +59,7 @@ class DLL_EXPORT CHIPCircularTLVBuffer : public chip::TLV::TLVBackingStore
 public:
     CHIPCircularTLVBuffer(uint8_t * inBuffer, uint32_t inBufferLength);
     CHIPCircularTLVBuffer(uint8_t * inBuffer, uint32_t inBufferLength, uint8_t * inHead);
+    CHIPCircularTLVBuffer(uint8_t * inBuffer, uint32_t inBufferLength, uint8_t * inHead, uint32_t inDataLength);
 
     inline uint8_t * QueueHead() const { return mQueueHead; }
     inline uint8_t * QueueTail() const { return mQueue + ((static_cast<size_t>(mQueueHead - mQueue) + mQueueLength) % mQueueSize); }
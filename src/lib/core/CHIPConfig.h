@@ -440,12 +440,13 @@
  *  @name chip Security Manager Memory Management Configuration
  *
  *  @brief
- *    The following definitions enable one of three potential chip
+ *    The following definitions enable one of four potential chip
  *    Security Manager memory-management options:
  *
  *      * #CHIP_CONFIG_MEMORY_MGMT_PLATFORM
  *      * #CHIP_CONFIG_MEMORY_MGMT_SIMPLE
  *      * #CHIP_CONFIG_MEMORY_MGMT_MALLOC
+ *      * #CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
  *
  *    Note that these options are mutually exclusive and only one
  *    of these options should be set.
@@ -462,8 +463,9 @@
  *    functions.
  *
  *  @note This configuration is mutual exclusive with
- *        #CHIP_CONFIG_MEMORY_MGMT_SIMPLE and
- *        #CHIP_CONFIG_MEMORY_MGMT_MALLOC.
+ *        #CHIP_CONFIG_MEMORY_MGMT_SIMPLE,
+ *        #CHIP_CONFIG_MEMORY_MGMT_MALLOC and
+ *        #CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS.
  *
  */
 #ifndef CHIP_CONFIG_MEMORY_MGMT_PLATFORM
@@ -480,8 +482,9 @@
  *    release.
  *
  *  @note This configuration is mutual exclusive with
- *        #CHIP_CONFIG_MEMORY_MGMT_PLATFORM and
- *        #CHIP_CONFIG_MEMORY_MGMT_MALLOC.
+ *        #CHIP_CONFIG_MEMORY_MGMT_PLATFORM,
+ *        #CHIP_CONFIG_MEMORY_MGMT_MALLOC and
+ *        #CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS.
  *
  */
 #ifndef CHIP_CONFIG_MEMORY_MGMT_SIMPLE
@@ -498,24 +501,47 @@
  *    functions.
  *
  *  @note This configuration is mutual exclusive with
- *        #CHIP_CONFIG_MEMORY_MGMT_PLATFORM and
- *        #CHIP_CONFIG_MEMORY_MGMT_SIMPLE.
+ *        #CHIP_CONFIG_MEMORY_MGMT_PLATFORM,
+ *        #CHIP_CONFIG_MEMORY_MGMT_SIMPLE and
+ *        #CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS.
  *
  */
 #ifndef CHIP_CONFIG_MEMORY_MGMT_MALLOC
 #define CHIP_CONFIG_MEMORY_MGMT_MALLOC 1
 #endif // CHIP_CONFIG_MEMORY_MGMT_MALLOC
 
+/**
+ *  @def CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+ *
+ *  @brief
+ *    Enable (1) or disable (0) support for a chip-provided
+ *    implementation of chip memory-management functions based on
+ *    segregated size classes with per-thread caches. Blocks are
+ *    carved from chunks obtained with the C Standard Library malloc,
+ *    allocations larger than the largest size class go to malloc
+ *    directly.
+ *
+ *  @note This configuration is mutual exclusive with
+ *        #CHIP_CONFIG_MEMORY_MGMT_PLATFORM,
+ *        #CHIP_CONFIG_MEMORY_MGMT_SIMPLE and
+ *        #CHIP_CONFIG_MEMORY_MGMT_MALLOC.
+ *
+ */
+#ifndef CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+#define CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS 0
+#endif // CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+
 /**
  *  @}
  */
 
-#if ((CHIP_CONFIG_MEMORY_MGMT_PLATFORM + CHIP_CONFIG_MEMORY_MGMT_SIMPLE + CHIP_CONFIG_MEMORY_MGMT_MALLOC) != 1)
+#if ((CHIP_CONFIG_MEMORY_MGMT_PLATFORM + CHIP_CONFIG_MEMORY_MGMT_SIMPLE + CHIP_CONFIG_MEMORY_MGMT_MALLOC +                        \
+      CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS) != 1)
 #error                                                                                                                             \
-    "Please assert exactly one of CHIP_CONFIG_MEMORY_MGMT_PLATFORM, CHIP_CONFIG_MEMORY_MGMT_SIMPLE, or CHIP_CONFIG_MEMORY_MGMT_MALLOC."
-#endif // ((CHIP_CONFIG_MEMORY_MGMT_PLATFORM + CHIP_CONFIG_MEMORY_MGMT_SIMPLE + CHIP_CONFIG_MEMORY_MGMT_MALLOC) != 1)
+    "Please assert exactly one of CHIP_CONFIG_MEMORY_MGMT_PLATFORM, CHIP_CONFIG_MEMORY_MGMT_SIMPLE, CHIP_CONFIG_MEMORY_MGMT_MALLOC, or CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS."
+#endif // exactly one CHIP_CONFIG_MEMORY_MGMT_* option
 
-#if !CHIP_CONFIG_MEMORY_MGMT_MALLOC && CHIP_SYSTEM_CONFIG_USE_BSD_IFADDRS
+#if !CHIP_CONFIG_MEMORY_MGMT_MALLOC && !CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS && CHIP_SYSTEM_CONFIG_USE_BSD_IFADDRS
 #error "!CHIP_CONFIG_MEMORY_MGMT_MALLOC but getifaddrs() uses malloc()"
 #endif
 
@@ -537,6 +563,53 @@
 #define CHIP_CONFIG_SIMPLE_ALLOCATOR_USE_SMALL_BUFFERS 0
 #endif // CHIP_CONFIG_SIMPLE_ALLOCATOR_USE_SMALL_BUFFERS
 
+/**
+ *  @def CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CHUNK_SIZE
+ *
+ *  @brief
+ *    Size, in bytes, of the chunks the size-class allocator obtains
+ *    from malloc and carves into blocks of one size class.
+ *
+ *  @note This configuration is only relevant when
+ *        #CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS is set and
+ *        ignored otherwise.
+ *
+ */
+#ifndef CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CHUNK_SIZE
+#define CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CHUNK_SIZE 16384
+#endif // CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CHUNK_SIZE
+
+/**
+ *  @def CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CACHE_BLOCKS
+ *
+ *  @brief
+ *    Number of free blocks of each size class a thread keeps for
+ *    itself. Half of them are returned to the shared free lists when
+ *    the cache overflows.
+ *
+ *  @note This configuration is only relevant when
+ *        #CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS is set and
+ *        ignored otherwise.
+ *
+ */
+#ifndef CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CACHE_BLOCKS
+#define CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CACHE_BLOCKS 32
+#endif // CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CACHE_BLOCKS
+
+/**
+ *  @def CHIP_CONFIG_MESSAGE_ARENA_SIZE
+ *
+ *  @brief
+ *    Size, in bytes, of the arena that serves transient allocations
+ *    (chip::Platform::MessageArenaAlloc) while the exchange manager
+ *    handles an inbound message. Allocations that do not fit fall back
+ *    to chip::Platform::MemoryAlloc.
+ *
+ */
+#ifndef CHIP_CONFIG_MESSAGE_ARENA_SIZE
+#define CHIP_CONFIG_MESSAGE_ARENA_SIZE 1024
+#endif // CHIP_CONFIG_MESSAGE_ARENA_SIZE
+
 /**
  *  @def CHIP_CONFIG_MEMORY_DEBUG_CHECKS
  *
@@ -1265,7 +1338,9 @@
  *  @def CHIP_CONFIG_MAX_ACTIVE_CHANNELS
  *
  *  @brief
- *    Maximum number of simultaneously active channels
+ *    Number of simultaneously active channels held in place by the
+ *    exchange manager. Further channels are allocated in slabs of
+ *    the same size with chip::Platform::MemoryAlloc.
  */
 #ifndef CHIP_CONFIG_MAX_ACTIVE_CHANNELS
 #define CHIP_CONFIG_MAX_ACTIVE_CHANNELS 16
@@ -1275,7 +1350,9 @@
  *  @def CHIP_CONFIG_MAX_CHANNEL_HANDLES
  *
  *  @brief
- *    Maximum number of channel handles
+ *    Number of channel handles held in place by the exchange
+ *    manager. Further handles are allocated in slabs of the same
+ *    size with chip::Platform::MemoryAlloc.
  */
 #ifndef CHIP_CONFIG_MAX_CHANNEL_HANDLES
 #define CHIP_CONFIG_MAX_CHANNEL_HANDLES 64
@@ -2343,6 +2420,133 @@
 #define CHIP_CONFIG_MAX_DEVICE_ADMINS 16
 #endif // CHIP_CONFIG_MAX_DEVICE_ADMINS
 
+/**
+ *  @def CHIP_IM_MAX_NUM_COMMAND_HANDLER
+ *
+ *  @brief
+ *    Number of CommandHandler objects held by the interaction model
+ *    engine, i.e. the number of invoke requests that can be served
+ *    concurrently. Requests arriving while all are busy are rejected.
+ */
+#ifndef CHIP_IM_MAX_NUM_COMMAND_HANDLER
+#define CHIP_IM_MAX_NUM_COMMAND_HANDLER 4
+#endif // CHIP_IM_MAX_NUM_COMMAND_HANDLER
+
+/**
+ *  @def CHIP_IM_MAX_NUM_COMMAND_SENDER
+ *
+ *  @brief
+ *    Number of CommandSender objects held by the interaction model
+ *    engine, shared by every client that sends invoke requests.
+ */
+#ifndef CHIP_IM_MAX_NUM_COMMAND_SENDER
+#define CHIP_IM_MAX_NUM_COMMAND_SENDER 4
+#endif // CHIP_IM_MAX_NUM_COMMAND_SENDER
+
+/**
+ *  @def CHIP_IM_MAX_NUM_READ_HANDLER
+ *
+ *  @brief
+ *    Number of ReadHandler objects held by the interaction model
+ *    engine, i.e. the number of read requests that can be served
+ *    concurrently.
+ */
+#ifndef CHIP_IM_MAX_NUM_READ_HANDLER
+#define CHIP_IM_MAX_NUM_READ_HANDLER 2
+#endif // CHIP_IM_MAX_NUM_READ_HANDLER
+
+/**
+ *  @def CHIP_IM_MAX_NUM_READ_CLIENT
+ *
+ *  @brief
+ *    Number of ReadClient objects held by the interaction model
+ *    engine, shared by every client that sends read requests.
+ */
+#ifndef CHIP_IM_MAX_NUM_READ_CLIENT
+#define CHIP_IM_MAX_NUM_READ_CLIENT 2
+#endif // CHIP_IM_MAX_NUM_READ_CLIENT
+
+/**
+ *  @def CHIP_IM_MAX_NUM_SUBSCRIPTIONS
+ *
+ *  @brief
+ *    Number of subscriptions the interaction model engine can serve
+ *    concurrently. At most 32.
+ */
+#ifndef CHIP_IM_MAX_NUM_SUBSCRIPTIONS
+#define CHIP_IM_MAX_NUM_SUBSCRIPTIONS 4
+#endif // CHIP_IM_MAX_NUM_SUBSCRIPTIONS
+
+/**
+ *  @def CHIP_IM_MAX_NUM_SUBSCRIBED_ATTRIBUTES
+ *
+ *  @brief
+ *    Number of distinct attributes that subscriptions can cover, all
+ *    subscriptions together. An attribute watched by several
+ *    subscriptions is counted once.
+ */
+#ifndef CHIP_IM_MAX_NUM_SUBSCRIBED_ATTRIBUTES
+#define CHIP_IM_MAX_NUM_SUBSCRIBED_ATTRIBUTES 64
+#endif // CHIP_IM_MAX_NUM_SUBSCRIBED_ATTRIBUTES
+
+/**
+ *  @def CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES
+ *
+ *  @brief
+ *    Number of attributes of one cluster that a report fetches ahead
+ *    in a single batch when the cluster is served by an attribute
+ *    accessor.
+ */
+#ifndef CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES
+#define CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES 8
+#endif // CHIP_IM_MAX_NUM_PREFETCHED_ATTRIBUTES
+
+/**
+ *  @def CHIP_IM_ATTRIBUTE_PREFETCH_BUFFER_SIZE
+ *
+ *  @brief
+ *    Size in bytes of the buffer holding the values of the prefetched
+ *    attributes. Attributes whose values do not fit are read one by
+ *    one when they are encoded.
+ */
+#ifndef CHIP_IM_ATTRIBUTE_PREFETCH_BUFFER_SIZE
+#define CHIP_IM_ATTRIBUTE_PREFETCH_BUFFER_SIZE 128
+#endif // CHIP_IM_ATTRIBUTE_PREFETCH_BUFFER_SIZE
+
+/**
+ *  @def CHIP_CONFIG_ATTRIBUTE_JOURNAL_SIZE
+ *
+ *  @brief
+ *    Number of attribute values the attribute persistence journal
+ *    holds before they are written to persistent storage. Repeated
+ *    writes to an attribute take a single entry.
+ */
+#ifndef CHIP_CONFIG_ATTRIBUTE_JOURNAL_SIZE
+#define CHIP_CONFIG_ATTRIBUTE_JOURNAL_SIZE 16
+#endif // CHIP_CONFIG_ATTRIBUTE_JOURNAL_SIZE
+
+/**
+ *  @def CHIP_CONFIG_ATTRIBUTE_JOURNAL_MAX_VALUE_SIZE
+ *
+ *  @brief
+ *    Size in bytes of the largest attribute value the journal holds.
+ *    Larger values are written to persistent storage right away.
+ */
+#ifndef CHIP_CONFIG_ATTRIBUTE_JOURNAL_MAX_VALUE_SIZE
+#define CHIP_CONFIG_ATTRIBUTE_JOURNAL_MAX_VALUE_SIZE 8
+#endif // CHIP_CONFIG_ATTRIBUTE_JOURNAL_MAX_VALUE_SIZE
+
+/**
+ *  @def CHIP_CONFIG_ATTRIBUTE_JOURNAL_FLUSH_INTERVAL_MS
+ *
+ *  @brief
+ *    Longest time, in milliseconds, an attribute value waits in the
+ *    journal before it is written to persistent storage.
+ */
+#ifndef CHIP_CONFIG_ATTRIBUTE_JOURNAL_FLUSH_INTERVAL_MS
+#define CHIP_CONFIG_ATTRIBUTE_JOURNAL_FLUSH_INTERVAL_MS 30000
+#endif // CHIP_CONFIG_ATTRIBUTE_JOURNAL_FLUSH_INTERVAL_MS
+
 /**
  * @def CHIP_NON_PRODUCTION_MARKER
  *
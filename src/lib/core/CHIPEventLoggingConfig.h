@@ -46,6 +46,18 @@
 #define CHIP_CONFIG_EVENT_SIZE_INCREMENT 8
 #endif /* CHIP_CONFIG_EVENT_SIZE_INCREMENT */
 
+/**
+ * @def CHIP_CONFIG_EVENT_LOGGING_INDEX_STRIDE
+ *
+ * @brief
+ *   Number of events logged in a priority buffer between two entries
+ *   of its index.  Seeking an event by number costs a binary search
+ *   of the index followed by the decoding of at most this many events.
+ */
+#ifndef CHIP_CONFIG_EVENT_LOGGING_INDEX_STRIDE
+#define CHIP_CONFIG_EVENT_LOGGING_INDEX_STRIDE 8
+#endif /* CHIP_CONFIG_EVENT_LOGGING_INDEX_STRIDE */
+
 /**
  * @def CHIP_CONFIG_EVENT_LOGGING_MAXIMUM_UPLOAD_SECONDS
  *
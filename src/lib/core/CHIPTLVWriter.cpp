@@ -32,6 +32,7 @@
 
 #include <support/CHIPMem.h>
 #include <support/CodeUtils.h>
+#include <support/MessageArena.h>
 #include <support/ReturnMacros.h>
 #include <support/SafeInt.h>
 
@@ -379,7 +380,7 @@ CHIP_ERROR TLVWriter::VPutStringF(uint64_t tag, const char * fmt, va_list ap)
 
 #else // CONFIG_HAVE_VSNPRINTF_EX
 
-    tmpBuf = static_cast<char *>(chip::Platform::MemoryAlloc(dataLen + 1));
+    tmpBuf = static_cast<char *>(chip::Platform::MessageArenaAlloc(dataLen + 1));
     VerifyOrExit(tmpBuf != nullptr, err = CHIP_ERROR_NO_MEMORY);
 
     va_copy(aq, ap);
@@ -389,7 +390,7 @@ CHIP_ERROR TLVWriter::VPutStringF(uint64_t tag, const char * fmt, va_list ap)
     va_end(aq);
 
     err = WriteData(reinterpret_cast<uint8_t *>(tmpBuf), static_cast<uint32_t>(dataLen));
-    chip::Platform::MemoryFree(tmpBuf);
+    chip::Platform::MessageArenaFree(tmpBuf);
 
 #endif // CONFIG_HAVE_VSNPRINTF_EX
 
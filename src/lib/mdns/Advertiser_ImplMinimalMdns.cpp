@@ -16,13 +16,16 @@
  */
 
 #include "Advertiser.h"
+#include "MinimalMdnsInterfaces.h"
 
 #include <inttypes.h>
 #include <stdio.h>
 
+#include <mdns/minimal/KnownAnswers.h>
 #include <mdns/minimal/ResponseSender.h>
 #include <mdns/minimal/Server.h>
 #include <mdns/minimal/core/FlatAllocatedQName.h>
+#include <mdns/minimal/core/QNameTable.h>
 #include <mdns/minimal/responders/IP.h>
 #include <mdns/minimal/responders/Ptr.h>
 #include <mdns/minimal/responders/QueryResponder.h>
@@ -93,109 +96,10 @@ void LogQuery(const QueryData & data)
 void LogQuery(const QueryData & data) {}
 #endif
 
-/// Checks if the current interface is powered on
-/// and not local loopback.
-template <typename T>
-bool IsCurrentInterfaceUsable(T & iterator)
-{
-    if (!iterator.IsUp() || !iterator.SupportsMulticast())
-    {
-        return false; // not a usable interface
-    }
-    char name[chip::Inet::InterfaceIterator::kMaxIfNameLength];
-    if (iterator.GetInterfaceName(name, sizeof(name)) != CHIP_NO_ERROR)
-    {
-        ChipLogError(Discovery, "Failed to get interface name.");
-        return false;
-    }
-
-    // TODO: need a better way to ignore local loopback interfaces/addresses
-    // We do not want to listen on local loopback even though they are up and
-    // support multicast
-    //
-    // Some way to detect 'is local looback' that is smarter (e.g. at least
-    // strict string compare on linux instead of substring) would be better.
-    //
-    // This would reject likely valid interfaces like 'lollipop' or 'lostinspace'
-    if (strncmp(name, "lo", 2) == 0)
-    {
-        /// local loopback interface is not usable by MDNS
-        return false;
-    }
-    return true;
-}
-
-class AllInterfaces : public ListenIterator
-{
-private:
-public:
-    AllInterfaces() { SkipToFirstValidInterface(); }
-
-    bool Next(chip::Inet::InterfaceId * id, chip::Inet::IPAddressType * type) override
-    {
-        if (!mIterator.HasCurrent())
-        {
-            return false;
-        }
-
-#if INET_CONFIG_ENABLE_IPV4
-        if (mState == State::kIpV4)
-        {
-            *id    = mIterator.GetInterfaceId();
-            *type  = chip::Inet::kIPAddressType_IPv4;
-            mState = State::kIpV6;
-            return true;
-        }
-#endif
-
-        *id   = mIterator.GetInterfaceId();
-        *type = chip::Inet::kIPAddressType_IPv6;
-#if INET_CONFIG_ENABLE_IPV4
-        mState = State::kIpV4;
-#endif
-
-        for (mIterator.Next(); SkipCurrentInterface(); mIterator.Next())
-        {
-        }
-        return true;
-    }
-
-private:
-    enum class State
-    {
-        kIpV4,
-        kIpV6,
-    };
-#if INET_CONFIG_ENABLE_IPV4
-    State mState = State::kIpV4;
-#else
-    State mState = State::kIpV6;
-#endif
-    chip::Inet::InterfaceIterator mIterator;
-
-    void SkipToFirstValidInterface()
-    {
-        do
-        {
-            if (!SkipCurrentInterface())
-            {
-                break;
-            }
-        } while (mIterator.Next());
-    }
-
-    bool SkipCurrentInterface()
-    {
-        if (!mIterator.HasCurrent())
-        {
-            return false; // nothing to try.
-        }
-
-        return !IsCurrentInterfaceUsable(mIterator);
-    }
-};
-
 class AdvertiserMinMdns : public ServiceAdvertiser,
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+                          public chip::Inet::InterfaceChangeListener, // follows interface changes
+#endif
                           public ServerDelegate, // gets queries
                           public ParserDelegate  // parses queries
 {
@@ -230,6 +134,12 @@ public:
     void OnResource(ResourceType type, const ResourceData & data) override {}
     void OnQuery(const QueryData & data) override;
 
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+    // InterfaceChangeListener
+    void OnInterfaceChanged(chip::Inet::InterfaceChange change, chip::Inet::InterfaceId interfaceId,
+                            const chip::Inet::IPAddress & address) override;
+#endif
+
 private:
     /// Sets the query responder to a blank state and frees up any
     /// allocated memory.
@@ -238,7 +148,13 @@ private:
     /// Advertise available records configured within the server
     ///
     /// Usable as boot-time advertisement of available SRV records.
-    void AdvertiseRecords();
+    void AdvertiseRecords(chip::Inet::InterfaceId interfaceId = INET_NULL_INTERFACEID);
+
+    /// Advertise available records from a single interface address
+    void AdvertiseRecordsOn(chip::Inet::InterfaceId interfaceId, const chip::Inet::IPAddress & address);
+
+    /// Opens the server endpoints, on the interfaces of the interface watcher table if available
+    CHIP_ERROR Listen(chip::Inet::InetLayer * inetLayer, uint16_t port);
 
     /// Determine if advertisement on the specified interface/address is ok given the
     /// interfaces on which the mDNS server is listening
@@ -306,10 +222,18 @@ private:
     static constexpr size_t kMaxRecords             = 16;
     static constexpr size_t kMaxAllocatedResponders = 16;
     static constexpr size_t kMaxAllocatedQNameData  = 8;
+    static constexpr size_t kMaxNameTableLabels     = 64;
 
     Server<kMaxEndPoints> mServer;
     QueryResponder<kMaxRecords> mQueryResponder;
     ResponseSender mResponseSender;
+    KnownAnswers mKnownAnswers;
+    QNameTable<kMaxNameTableLabels> mNameTable;
+
+    // Set by Start, used to follow interface changes
+    chip::Inet::InetLayer * mInetLayer               = nullptr;
+    uint16_t mPort                                   = kMdnsPort;
+    chip::Inet::InterfaceWatcher * mInterfaceWatcher = nullptr; // null if interfaces are enumerated
 
     // current request handling
     const chip::Inet::IPPacketInfo * mCurrentSource = nullptr;
@@ -331,11 +255,27 @@ void AdvertiserMinMdns::OnQuery(const BytesRange & data, const chip::Inet::IPPac
 #endif
 
     mCurrentSource = info;
-    if (!ParsePacket(data, this))
+
+    // Known answers follow the questions, so they are located before replying to any question
+    if (!mKnownAnswers.Init(data))
+    {
+        mKnownAnswers.Clear();
+    }
+
+    if (!ParsePacket(data, this, &mNameTable))
     {
         ChipLogError(Discovery, "Failed to parse mDNS query");
     }
+
+    mKnownAnswers.Clear();
     mCurrentSource = nullptr;
+
+#ifdef DETAIL_LOGGING
+    ChipLogDetail(Discovery,
+                  "MinMdns responses saved: %" PRIu32 " known answers, %" PRIu32 " coalesced queries, %" PRIu32 " cached replies",
+                  mResponseSender.GetStats().knownAnswersSuppressed, mResponseSender.GetStats().queriesCoalesced,
+                  mResponseSender.GetStats().cachedResponses);
+#endif
 }
 
 void AdvertiserMinMdns::OnQuery(const QueryData & data)
@@ -348,7 +288,7 @@ void AdvertiserMinMdns::OnQuery(const QueryData & data)
 
     LogQuery(data);
 
-    CHIP_ERROR err = mResponseSender.Respond(mMessageId, data, mCurrentSource);
+    CHIP_ERROR err = mResponseSender.Respond(mMessageId, data, mCurrentSource, &mKnownAnswers);
     if (err != CHIP_NO_ERROR)
     {
         ChipLogError(Discovery, "Failed to reply to query: %s", ErrorStr(err));
@@ -359,9 +299,10 @@ CHIP_ERROR AdvertiserMinMdns::Start(chip::Inet::InetLayer * inetLayer, uint16_t
 {
     mServer.Shutdown();
 
-    AllInterfaces allInterfaces;
+    // Listening interfaces (and their addresses) may have changed
+    mResponseSender.ClearResponseCache();
 
-    ReturnErrorOnFailure(mServer.Listen(inetLayer, &allInterfaces, port));
+    ReturnErrorOnFailure(Listen(inetLayer, port));
 
     ChipLogProgress(Discovery, "CHIP minimal mDNS started advertising.");
 
@@ -370,11 +311,83 @@ CHIP_ERROR AdvertiserMinMdns::Start(chip::Inet::InetLayer * inetLayer, uint16_t
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR AdvertiserMinMdns::Listen(chip::Inet::InetLayer * inetLayer, uint16_t port)
+{
+    mInetLayer = inetLayer;
+    mPort      = port;
+
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+    if (mInterfaceWatcher != nullptr)
+    {
+        mInterfaceWatcher->RemoveListener(this);
+        mInterfaceWatcher = nullptr;
+    }
+
+    chip::Inet::InterfaceWatcher & watcher = inetLayer->GetInterfaceWatcher();
+    if (watcher.IsActive() && (watcher.AddListener(this) == INET_NO_ERROR))
+    {
+        mInterfaceWatcher = &watcher;
+
+        WatchedInterfaces watchedInterfaces(watcher);
+        return mServer.Listen(inetLayer, &watchedInterfaces, port);
+    }
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
+
+    AllInterfaces allInterfaces;
+    return mServer.Listen(inetLayer, &allInterfaces, port);
+}
+
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+void AdvertiserMinMdns::OnInterfaceChanged(chip::Inet::InterfaceChange change, chip::Inet::InterfaceId interfaceId,
+                                           const chip::Inet::IPAddress & address)
+{
+    // Cached replies contain the addresses of the interface they were built for
+    mResponseSender.ClearResponseCache();
+
+    switch (change)
+    {
+    case chip::Inet::InterfaceChange::kLinkUp:
+        if ((mInterfaceWatcher == nullptr) || !mInterfaceWatcher->IsInterfaceUsable(interfaceId))
+        {
+            break;
+        }
+        {
+            CHIP_ERROR err = mServer.ListenOn(mInetLayer, interfaceId, chip::Inet::kIPAddressType_IPv6, mPort);
+#if INET_CONFIG_ENABLE_IPV4
+            if (err == CHIP_NO_ERROR)
+            {
+                err = mServer.ListenOn(mInetLayer, interfaceId, chip::Inet::kIPAddressType_IPv4, mPort);
+            }
+#endif
+            if (err != CHIP_NO_ERROR)
+            {
+                ChipLogError(Discovery, "Failed to listen on new interface: %s", ErrorStr(err));
+            }
+        }
+        AdvertiseRecords(interfaceId);
+        break;
+    case chip::Inet::InterfaceChange::kLinkDown:
+        mServer.StopListeningOn(interfaceId);
+        break;
+    case chip::Inet::InterfaceChange::kAddressAdded:
+        // Announce the new address, so that peers do not wait for their cached records to expire
+        AdvertiseRecordsOn(interfaceId, address);
+        mQueryResponder.ClearBroadcastThrottle();
+        break;
+    case chip::Inet::InterfaceChange::kAddressRemoved:
+        break;
+    }
+}
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
+
 void AdvertiserMinMdns::Clear()
 {
     // Init clears all responders, so that data can be freed
     mQueryResponder.Init();
 
+    // Cached replies refer to the old records
+    mResponseSender.ClearResponseCache();
+
     // Free all allocated data
     for (size_t i = 0; i < kMaxAllocatedResponders; i++)
     {
@@ -402,7 +415,7 @@ CHIP_ERROR AdvertiserMinMdns::Advertise(const OperationalAdvertisingParameters &
     char uniqueName[64] = "";
 
     /// need to set server name
-    size_t len = snprintf(uniqueName, sizeof(uniqueName), "%" PRIX64 "-%" PRIX64, params.GetFabricId(), params.GetNodeId());
+    size_t len = snprintf(uniqueName, sizeof(uniqueName), "%" PRIX64 "-%" PRIX64, params.GetNodeId(), params.GetFabricId());
     if (len >= sizeof(uniqueName))
     {
         ChipLogError(Discovery, "Failed to allocate QNames.");
@@ -443,7 +456,7 @@ CHIP_ERROR AdvertiserMinMdns::Advertise(const OperationalAdvertisingParameters &
         return CHIP_ERROR_NO_MEMORY;
     }
 
-    if (!AddResponder<IPv6Responder>(serverName).IsValid())
+    if (!AddResponder<IPv6Responder>(serverName, mInterfaceWatcher).IsValid())
     {
         ChipLogError(Discovery, "Failed to add IPv6 mDNS responder");
         return CHIP_ERROR_NO_MEMORY;
@@ -451,7 +464,7 @@ CHIP_ERROR AdvertiserMinMdns::Advertise(const OperationalAdvertisingParameters &
 
     if (params.IsIPv4Enabled())
     {
-        if (!AddResponder<IPv4Responder>(serverName).IsValid())
+        if (!AddResponder<IPv4Responder>(serverName, mInterfaceWatcher).IsValid())
         {
             ChipLogError(Discovery, "Failed to add IPv4 mDNS responder");
             return CHIP_ERROR_NO_MEMORY;
@@ -502,7 +515,7 @@ CHIP_ERROR AdvertiserMinMdns::Advertise(const CommissionAdvertisingParameters &
         ChipLogError(Discovery, "Failed to add SRV record mDNS responder");
         return CHIP_ERROR_NO_MEMORY;
     }
-    if (!AddResponder<IPv6Responder>(serverName).IsValid())
+    if (!AddResponder<IPv6Responder>(serverName, mInterfaceWatcher).IsValid())
     {
         ChipLogError(Discovery, "Failed to add IPv6 mDNS responder");
         return CHIP_ERROR_NO_MEMORY;
@@ -510,7 +523,7 @@ CHIP_ERROR AdvertiserMinMdns::Advertise(const CommissionAdvertisingParameters &
 
     if (params.IsIPv4Enabled())
     {
-        if (!AddResponder<IPv4Responder>(serverName).IsValid())
+        if (!AddResponder<IPv4Responder>(serverName, mInterfaceWatcher).IsValid())
         {
             ChipLogError(Discovery, "Failed to add IPv4 mDNS responder");
             return CHIP_ERROR_NO_MEMORY;
@@ -636,8 +649,30 @@ bool AdvertiserMinMdns::ShouldAdvertiseOn(const chip::Inet::InterfaceId id, cons
     return false;
 }
 
-void AdvertiserMinMdns::AdvertiseRecords()
+void AdvertiserMinMdns::AdvertiseRecords(chip::Inet::InterfaceId interfaceId)
 {
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+    if ((mInterfaceWatcher != nullptr) && mInterfaceWatcher->IsActive())
+    {
+        for (size_t i = 0; i < chip::Inet::InterfaceWatcher::kMaxAddresses; i++)
+        {
+            const chip::Inet::InterfaceWatcher::AddressEntry * entry = mInterfaceWatcher->GetAddress(i);
+
+            if ((entry->interfaceId == 0) || ((interfaceId != INET_NULL_INTERFACEID) && (entry->interfaceId != interfaceId)) ||
+                !mInterfaceWatcher->IsInterfaceUsable(entry->interfaceId))
+            {
+                continue;
+            }
+
+            AdvertiseRecordsOn(entry->interfaceId, entry->address);
+        }
+
+        // Once all automatic broadcasts are done, allow immediate replies once.
+        mQueryResponder.ClearBroadcastThrottle();
+        return;
+    }
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
+
     chip::Inet::InterfaceAddressIterator interfaceAddress;
 
     if (!interfaceAddress.Next())
@@ -647,46 +682,56 @@ void AdvertiserMinMdns::AdvertiseRecords()
 
     for (; interfaceAddress.HasCurrent(); interfaceAddress.Next())
     {
-        if (!IsCurrentInterfaceUsable(interfaceAddress))
+        if ((interfaceId != INET_NULL_INTERFACEID) && (interfaceAddress.GetInterfaceId() != interfaceId))
         {
             continue;
         }
 
-        if (!ShouldAdvertiseOn(interfaceAddress.GetInterfaceId(), interfaceAddress.GetAddress()))
+        if (!IsCurrentInterfaceUsable(interfaceAddress))
         {
             continue;
         }
 
-        chip::Inet::IPPacketInfo packetInfo;
+        AdvertiseRecordsOn(interfaceAddress.GetInterfaceId(), interfaceAddress.GetAddress());
+    }
 
-        packetInfo.Clear();
-        packetInfo.SrcAddress = interfaceAddress.GetAddress();
-        if (interfaceAddress.GetAddress().IsIPv4())
-        {
-            BroadcastIpAddresses::GetIpv4Into(packetInfo.DestAddress);
-        }
-        else
-        {
-            BroadcastIpAddresses::GetIpv6Into(packetInfo.DestAddress);
-        }
-        packetInfo.SrcPort   = kMdnsPort;
-        packetInfo.DestPort  = kMdnsPort;
-        packetInfo.Interface = interfaceAddress.GetInterfaceId();
+    // Once all automatic broadcasts are done, allow immediate replies once.
+    mQueryResponder.ClearBroadcastThrottle();
+}
 
-        QueryData queryData(QType::PTR, QClass::IN, false /* unicast */);
-        queryData.SetIsBootAdvertising(true);
+void AdvertiserMinMdns::AdvertiseRecordsOn(chip::Inet::InterfaceId interfaceId, const chip::Inet::IPAddress & address)
+{
+    if (!ShouldAdvertiseOn(interfaceId, address))
+    {
+        return;
+    }
 
-        mQueryResponder.ClearBroadcastThrottle();
+    chip::Inet::IPPacketInfo packetInfo;
 
-        CHIP_ERROR err = mResponseSender.Respond(0, queryData, &packetInfo);
-        if (err != CHIP_NO_ERROR)
-        {
-            ChipLogError(Discovery, "Failed to advertise records: %s", ErrorStr(err));
-        }
+    packetInfo.Clear();
+    packetInfo.SrcAddress = address;
+    if (address.IsIPv4())
+    {
+        BroadcastIpAddresses::GetIpv4Into(packetInfo.DestAddress);
     }
+    else
+    {
+        BroadcastIpAddresses::GetIpv6Into(packetInfo.DestAddress);
+    }
+    packetInfo.SrcPort   = kMdnsPort;
+    packetInfo.DestPort  = kMdnsPort;
+    packetInfo.Interface = interfaceId;
+
+    QueryData queryData(QType::PTR, QClass::IN, false /* unicast */);
+    queryData.SetIsBootAdvertising(true);
 
-    // Once all automatic broadcasts are done, allow immediate replies once.
     mQueryResponder.ClearBroadcastThrottle();
+
+    CHIP_ERROR err = mResponseSender.Respond(0, queryData, &packetInfo);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Discovery, "Failed to advertise records: %s", ErrorStr(err));
+    }
 }
 
 AdvertiserMinMdns gAdvertiser;
@@ -0,0 +1,295 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "BrowseTable.h"
+
+#include <string.h>
+#include <strings.h>
+
+namespace chip {
+namespace Mdns {
+namespace {
+
+/// Parses a decimal number of [length] characters. returns false on invalid characters or overflow.
+bool ParseUint16(const uint8_t * value, size_t length, uint16_t & out)
+{
+    uint32_t result = 0;
+
+    if (length == 0)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if ((value[i] < '0') || (value[i] > '9'))
+        {
+            return false;
+        }
+        result = result * 10 + static_cast<uint32_t>(value[i] - '0');
+        if (result > UINT16_MAX)
+        {
+            return false;
+        }
+    }
+
+    out = static_cast<uint16_t>(result);
+    return true;
+}
+
+bool KeyEquals(const uint8_t * key, size_t keyLength, const char * expected)
+{
+    return (keyLength == strlen(expected)) && (strncasecmp(reinterpret_cast<const char *>(key), expected, keyLength) == 0);
+}
+
+} // namespace
+
+void ParseCommissionableTxtEntry(const uint8_t * key, size_t keyLength, const uint8_t * value, size_t valueLength,
+                                 DiscoveredNodeData & nodeData)
+{
+    if (KeyEquals(key, keyLength, "D"))
+    {
+        ParseUint16(value, valueLength, nodeData.longDiscriminator);
+    }
+    else if (KeyEquals(key, keyLength, "VP"))
+    {
+        // "vendor" or "vendor+product"
+        const uint8_t * plus = static_cast<const uint8_t *>(memchr(value, '+', valueLength));
+        size_t vendorLength  = (plus == nullptr) ? valueLength : static_cast<size_t>(plus - value);
+
+        ParseUint16(value, vendorLength, nodeData.vendorId);
+        if (plus != nullptr)
+        {
+            ParseUint16(plus + 1, valueLength - vendorLength - 1, nodeData.productId);
+        }
+    }
+}
+
+void BrowseTableBase::Clear()
+{
+    for (size_t i = 0; i < mEntryCount; i++)
+    {
+        mEntries[i].expiryMs = 0;
+    }
+}
+
+BrowseTableBase::Entry * BrowseTableBase::FindEntry(const char * instanceName)
+{
+    for (size_t i = 0; i < mEntryCount; i++)
+    {
+        if ((mEntries[i].expiryMs != 0) && (strcasecmp(mEntries[i].data.instanceName, instanceName) == 0))
+        {
+            return &mEntries[i];
+        }
+    }
+
+    return nullptr;
+}
+
+const DiscoveredNodeData * BrowseTableBase::Find(const char * instanceName) const
+{
+    const Entry * entry = const_cast<BrowseTableBase *>(this)->FindEntry(instanceName);
+    return (entry == nullptr) ? nullptr : &entry->data;
+}
+
+size_t BrowseTableBase::Count() const
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < mEntryCount; i++)
+    {
+        if (mEntries[i].expiryMs != 0)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+const BrowseTableBase::Entry * BrowseTableBase::GetEntry(size_t index) const
+{
+    return ((index < mEntryCount) && (mEntries[index].expiryMs != 0)) ? &mEntries[index] : nullptr;
+}
+
+void BrowseTableBase::Notify(BrowseEvent event, const DiscoveredNodeData & data)
+{
+    if (mDelegate != nullptr)
+    {
+        mDelegate->OnNodeDiscoveryChanged(event, data);
+    }
+}
+
+void BrowseTableBase::RemoveEntry(Entry & entry)
+{
+    // Entry is free before the delegate runs, so the delegate may update the table again
+    DiscoveredNodeData removed = entry.data;
+
+    entry.expiryMs = 0;
+    Notify(BrowseEvent::kRemoved, removed);
+}
+
+CHIP_ERROR BrowseTableBase::Update(const DiscoveredNodeData & data, uint32_t ttlSeconds, uint64_t nowMs)
+{
+    Entry * entry = FindEntry(data.instanceName);
+
+    if (ttlSeconds == 0)
+    {
+        if (entry != nullptr)
+        {
+            RemoveEntry(*entry);
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    BrowseEvent event = BrowseEvent::kUpdated;
+    bool changed      = true;
+
+    if (entry == nullptr)
+    {
+        for (size_t i = 0; (i < mEntryCount) && (entry == nullptr); i++)
+        {
+            entry = (mEntries[i].expiryMs == 0) ? &mEntries[i] : nullptr;
+        }
+        if (entry == nullptr)
+        {
+            return CHIP_ERROR_NO_MEMORY;
+        }
+        event = BrowseEvent::kAdded;
+    }
+    else
+    {
+        changed = (entry->data != data);
+    }
+
+    entry->data           = data;
+    entry->ttlSeconds     = ttlSeconds;
+    entry->seenInSnapshot = true;
+
+    if (ttlSeconds == kNoExpiry)
+    {
+        entry->expiryMs  = UINT64_MAX;
+        entry->refreshMs = 0;
+    }
+    else
+    {
+        entry->expiryMs  = nowMs + ttlSeconds * 1000ULL;
+        entry->refreshMs = nowMs + ttlSeconds * 10ULL * kRefreshPercent;
+    }
+
+    if (changed)
+    {
+        Notify(event, entry->data);
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void BrowseTableBase::Refresh(const DiscoveredNodeData & data)
+{
+    Entry * entry = FindEntry(data.instanceName);
+
+    if ((entry != nullptr) && (entry->data != data))
+    {
+        entry->data = data;
+        Notify(BrowseEvent::kUpdated, entry->data);
+    }
+}
+
+void BrowseTableBase::Remove(const char * instanceName)
+{
+    Entry * entry = FindEntry(instanceName);
+
+    if (entry != nullptr)
+    {
+        RemoveEntry(*entry);
+    }
+}
+
+void BrowseTableBase::Expire(uint64_t nowMs)
+{
+    for (size_t i = 0; i < mEntryCount; i++)
+    {
+        if ((mEntries[i].expiryMs != 0) && (mEntries[i].expiryMs <= nowMs))
+        {
+            RemoveEntry(mEntries[i]);
+        }
+    }
+}
+
+void BrowseTableBase::BeginSnapshot()
+{
+    for (size_t i = 0; i < mEntryCount; i++)
+    {
+        mEntries[i].seenInSnapshot = false;
+    }
+}
+
+void BrowseTableBase::EndSnapshot()
+{
+    for (size_t i = 0; i < mEntryCount; i++)
+    {
+        if ((mEntries[i].expiryMs != 0) && !mEntries[i].seenInSnapshot)
+        {
+            RemoveEntry(mEntries[i]);
+        }
+    }
+}
+
+bool BrowseTableBase::TakeRefreshDue(uint64_t nowMs)
+{
+    bool due = false;
+
+    for (size_t i = 0; i < mEntryCount; i++)
+    {
+        Entry & entry = mEntries[i];
+
+        if ((entry.expiryMs != 0) && (entry.refreshMs != 0) && (entry.refreshMs <= nowMs))
+        {
+            entry.refreshMs = 0;
+            due             = true;
+        }
+    }
+
+    return due;
+}
+
+uint64_t BrowseTableBase::NextEventMs() const
+{
+    uint64_t next = 0;
+
+    for (size_t i = 0; i < mEntryCount; i++)
+    {
+        const Entry & entry = mEntries[i];
+
+        if ((entry.expiryMs == 0) || (entry.expiryMs == UINT64_MAX))
+        {
+            continue;
+        }
+
+        uint64_t entryNext = (entry.refreshMs != 0) ? entry.refreshMs : entry.expiryMs;
+        if ((next == 0) || (entryNext < next))
+        {
+            next = entryNext;
+        }
+    }
+
+    return next;
+}
+
+} // namespace Mdns
+} // namespace chip
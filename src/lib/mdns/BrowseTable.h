@@ -0,0 +1,123 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <core/CHIPError.h>
+#include <lib/mdns/Resolver.h>
+
+namespace chip {
+namespace Mdns {
+
+/// Fills [nodeData] from a single TXT entry of a commissionable node
+/// (e.g. "D=840" or "VP=65521+32769"). Unknown keys are ignored.
+void ParseCommissionableTxtEntry(const uint8_t * key, size_t keyLength, const uint8_t * value, size_t valueLength,
+                                 DiscoveredNodeData & nodeData);
+
+/// Keeps the set of nodes seen by a browse session and reports how it changes.
+///
+/// Backends feed the table with whatever they learn (individual records with a TTL
+/// for minimal mDNS, full browse results for platform mDNS) and the table reports
+/// add/update/remove events to the BrowseDelegate only when a node actually changed,
+/// so repeated answers for the same node are silent.
+///
+/// Nodes are removed when their TTL expires, when a TTL of 0 ('goodbye') is received,
+/// or when they are missing from a snapshot (BeginSnapshot/EndSnapshot).
+///
+/// Like ResolverCacheBase, all methods take the current monotonic time in milliseconds.
+class BrowseTableBase
+{
+public:
+    /// TTL for sources that do not report TTLs: the node stays until removed or missing from a snapshot
+    static constexpr uint32_t kNoExpiry = UINT32_MAX;
+
+    /// Records are refreshed when this percentage of their TTL elapsed (RFC 6762, section 5.2)
+    static constexpr uint32_t kRefreshPercent = 80;
+
+    struct Entry
+    {
+        DiscoveredNodeData data;
+        uint32_t ttlSeconds;
+        uint64_t expiryMs;  // 0 for unused entries
+        uint64_t refreshMs; // 0 once a refresh was requested
+        bool seenInSnapshot;
+    };
+
+    BrowseTableBase(Entry * entries, size_t entryCount) : mEntries(entries), mEntryCount(entryCount) { Clear(); }
+
+    void SetDelegate(BrowseDelegate * delegate) { mDelegate = delegate; }
+
+    /// Forgets all nodes without reporting them as removed.
+    void Clear();
+
+    /// Adds or updates a node seen with a record valid for [ttlSeconds].
+    ///
+    /// A TTL of 0 removes the node.
+    ///
+    /// returns CHIP_ERROR_NO_MEMORY if the node is new and the table is full.
+    CHIP_ERROR Update(const DiscoveredNodeData & data, uint32_t ttlSeconds, uint64_t nowMs);
+
+    /// Updates the data of an already known node (e.g. a new address) without changing its TTL.
+    void Refresh(const DiscoveredNodeData & data);
+
+    void Remove(const char * instanceName);
+
+    /// Removes all nodes whose TTL expired.
+    void Expire(uint64_t nowMs);
+
+    /// Starts a full view of the network: nodes not updated until EndSnapshot are removed.
+    void BeginSnapshot();
+    void EndSnapshot();
+
+    const DiscoveredNodeData * Find(const char * instanceName) const;
+    size_t Count() const;
+
+    /// Entry at [index] (0 to GetCapacity() - 1) or nullptr if unused.
+    const Entry * GetEntry(size_t index) const;
+    size_t GetCapacity() const { return mEntryCount; }
+
+    /// returns true (once) if any node is due for a refresh query.
+    bool TakeRefreshDue(uint64_t nowMs);
+
+    /// Time of the next refresh or expiry, 0 if there is none.
+    uint64_t NextEventMs() const;
+
+private:
+    Entry * FindEntry(const char * instanceName);
+    void Notify(BrowseEvent event, const DiscoveredNodeData & data);
+    void RemoveEntry(Entry & entry);
+
+    Entry * mEntries;
+    const size_t mEntryCount;
+    BrowseDelegate * mDelegate = nullptr;
+};
+
+template <size_t kNodeCount>
+class BrowseTable : public BrowseTableBase
+{
+public:
+    BrowseTable() : BrowseTableBase(mEntryStorage, kNodeCount) {}
+
+private:
+    Entry mEntryStorage[kNodeCount];
+};
+
+} // namespace Mdns
+} // namespace chip
@@ -17,6 +17,7 @@
 
 #include "Discovery_ImplPlatform.h"
 
+#include <algorithm>
 #include <inttypes.h>
 
 #include "lib/core/CHIPSafeCasts.h"
@@ -271,6 +272,16 @@ CHIP_ERROR DiscoveryImplPlatform::StopPublishDevice()
     return ChipMdnsStopPublish();
 }
 
+CHIP_ERROR DiscoveryImplPlatform::StartResolver(Inet::InetLayer * inetLayer, uint16_t port)
+{
+    if (!mMdnsInitialized)
+    {
+        ReturnErrorOnFailure(ChipMdnsInit(HandleMdnsInit, HandleMdnsError, this));
+        mMdnsInitialized = true;
+    }
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR DiscoveryImplPlatform::SetResolverDelegate(ResolverDelegate * delegate)
 {
     VerifyOrReturnError(delegate == nullptr || mResolverDelegate == nullptr, CHIP_ERROR_INCORRECT_STATE);
@@ -355,6 +366,114 @@ void DiscoveryImplPlatform::HandleNodeIdResolve(void * context, MdnsService * re
     }
 }
 
+CHIP_ERROR DiscoveryImplPlatform::StartCommissionableBrowse(BrowseDelegate * delegate)
+{
+    VerifyOrReturnError(delegate != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mMdnsInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mBrowseDelegate == nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    mBrowseTable.Clear();
+    mBrowseTable.SetDelegate(delegate);
+    mBrowseDelegate   = delegate;
+    mBrowseIntervalMs = kBrowseInitialIntervalMs;
+
+    HandleBrowseTimer(&DeviceLayer::SystemLayer, this, CHIP_SYSTEM_NO_ERROR);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR DiscoveryImplPlatform::StopCommissionableBrowse()
+{
+    DeviceLayer::SystemLayer.CancelTimer(HandleBrowseTimer, this);
+
+    mBrowseDelegate = nullptr;
+    mBrowseTable.SetDelegate(nullptr);
+    mBrowseTable.Clear();
+
+    return CHIP_NO_ERROR;
+}
+
+void DiscoveryImplPlatform::HandleBrowseTimer(System::Layer * systemLayer, void * appState, System::Error error)
+{
+    DiscoveryImplPlatform * mgr = static_cast<DiscoveryImplPlatform *>(appState);
+
+    if (mgr->mBrowseDelegate == nullptr)
+    {
+        return;
+    }
+
+    CHIP_ERROR err = ChipMdnsBrowse("_chipc", MdnsServiceProtocol::kMdnsProtocolUdp, Inet::kIPAddressType_Any,
+                                    INET_NULL_INTERFACEID, HandleCommissionableBrowse, mgr);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Discovery, "Failed to browse commissionable nodes: %s", chip::ErrorStr(err));
+    }
+
+    // Platform browses are one-shot: repeat them, less often as the network is known better
+    err = systemLayer->StartTimer(mgr->mBrowseIntervalMs, HandleBrowseTimer, mgr);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Discovery, "Failed to schedule commissionable browse: %s", chip::ErrorStr(err));
+    }
+    mgr->mBrowseIntervalMs = std::min(mgr->mBrowseIntervalMs * 2, kBrowseMaxIntervalMs);
+}
+
+void DiscoveryImplPlatform::HandleCommissionableBrowse(void * context, MdnsService * services, size_t servicesSize,
+                                                       CHIP_ERROR error)
+{
+    DiscoveryImplPlatform * mgr = static_cast<DiscoveryImplPlatform *>(context);
+
+    if (mgr->mBrowseDelegate == nullptr)
+    {
+        return;
+    }
+
+    if (error != CHIP_NO_ERROR)
+    {
+        // Keep the current view: a failed browse says nothing about nodes going away
+        ChipLogError(Discovery, "Commissionable browse failed with %s", chip::ErrorStr(error));
+        return;
+    }
+
+    // Each result is a full view of the network: nodes missing from it are gone
+    mgr->mBrowseTable.BeginSnapshot();
+
+    for (size_t i = 0; (i < servicesSize) && (services != nullptr); i++)
+    {
+        const MdnsService & service = services[i];
+        DiscoveredNodeData nodeData = {};
+
+        if (strlen(service.mName) > DiscoveredNodeData::kInstanceNameMaxLength)
+        {
+            continue;
+        }
+
+        strcpy(nodeData.instanceName, service.mName);
+        nodeData.port        = service.mPort;
+        nodeData.interfaceId = service.mInterface;
+        nodeData.address     = service.mAddress.ValueOr(Inet::IPAddress::Any);
+
+        for (size_t j = 0; (j < service.mTextEntrySize) && (service.mTextEntries != nullptr); j++)
+        {
+            const TextEntry & entry = service.mTextEntries[j];
+            ParseCommissionableTxtEntry(Uint8::from_const_char(entry.mKey), strlen(entry.mKey), entry.mData, entry.mDataSize,
+                                        nodeData);
+        }
+
+        if (mgr->mBrowseTable.Update(nodeData, BrowseTableBase::kNoExpiry, 0) != CHIP_NO_ERROR)
+        {
+            ChipLogError(Discovery, "Browse table full, ignoring node %s", nodeData.instanceName);
+        }
+
+        if (mgr->mBrowseDelegate == nullptr)
+        {
+            return; // stopped by the delegate
+        }
+    }
+
+    mgr->mBrowseTable.EndSnapshot();
+}
+
 DiscoveryImplPlatform & DiscoveryImplPlatform::GetInstance()
 {
     // TODO: Clean Mdns initialization order
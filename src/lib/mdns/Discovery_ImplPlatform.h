@@ -20,6 +20,7 @@
 #include <core/CHIPError.h>
 #include <inet/InetInterface.h>
 #include <lib/mdns/Advertiser.h>
+#include <lib/mdns/BrowseTable.h>
 #include <lib/mdns/Resolver.h>
 #include <lib/mdns/platform/Mdns.h>
 #include <platform/CHIPDeviceConfig.h>
@@ -41,12 +42,19 @@ public:
     /// This function stops publishing the device on mDNS.
     CHIP_ERROR StopPublishDevice();
 
+    /// Initializes the platform mDNS layer without publishing anything
+    CHIP_ERROR StartResolver(Inet::InetLayer * inetLayer, uint16_t port) override;
+
     /// Registers a resolver delegate if none has been registered before
     CHIP_ERROR SetResolverDelegate(ResolverDelegate * delegate) override;
 
     /// Requests resolution of a node ID to its address
     CHIP_ERROR ResolveNodeId(uint64_t nodeId, uint64_t fabricId, Inet::IPAddressType type) override;
 
+    /// Repeats platform browses with exponential backoff, reporting the differences between results
+    CHIP_ERROR StartCommissionableBrowse(BrowseDelegate * delegate) override;
+    CHIP_ERROR StopCommissionableBrowse() override;
+
     static DiscoveryImplPlatform & GetInstance();
 
 private:
@@ -60,6 +68,8 @@ private:
     CHIP_ERROR SetupHostname();
 
     static void HandleNodeIdResolve(void * context, MdnsService * result, CHIP_ERROR error);
+    static void HandleCommissionableBrowse(void * context, MdnsService * services, size_t servicesSize, CHIP_ERROR error);
+    static void HandleBrowseTimer(System::Layer * systemLayer, void * appState, System::Error error);
     static void HandleMdnsInit(void * context, CHIP_ERROR initError);
     static void HandleMdnsError(void * context, CHIP_ERROR initError);
     static CHIP_ERROR GenerateRotatingDeviceId(char rotatingDeviceIdHexBuffer[], size_t & rotatingDeviceIdHexBufferSize);
@@ -73,6 +83,15 @@ private:
     bool mMdnsInitialized                = false;
     ResolverDelegate * mResolverDelegate = nullptr;
 
+    // Platform browses are one-shot, so nodes that show up later are only found by the next browse
+    static constexpr size_t kMaxBrowsedNodes           = 16;
+    static constexpr uint32_t kBrowseInitialIntervalMs = 1000;
+    static constexpr uint32_t kBrowseMaxIntervalMs     = 2 * 60 * 1000;
+
+    BrowseTable<kMaxBrowsedNodes> mBrowseTable;
+    BrowseDelegate * mBrowseDelegate = nullptr;
+    uint32_t mBrowseIntervalMs       = 0;
+
     static DiscoveryImplPlatform sManager;
 };
 
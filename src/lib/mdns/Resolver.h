@@ -18,10 +18,12 @@
 #pragma once
 
 #include <cstdint>
+#include <strings.h>
 
 #include <core/CHIPError.h>
 #include <inet/IPAddress.h>
 #include <inet/InetInterface.h>
+#include <inet/InetLayer.h>
 
 namespace chip {
 namespace Mdns {
@@ -46,18 +48,73 @@ public:
     virtual void OnNodeIdResolutionFailed(uint64_t nodeId, CHIP_ERROR error) = 0;
 };
 
+/// A commissionable node seen by a browse session
+struct DiscoveredNodeData
+{
+    static constexpr size_t kInstanceNameMaxLength = 16; // 64 bit random id, hex encoded
+
+    char instanceName[kInstanceNameMaxLength + 1];
+    uint16_t longDiscriminator;
+    uint16_t vendorId;
+    uint16_t productId;
+    uint16_t port;
+    Inet::InterfaceId interfaceId;
+    Inet::IPAddress address; // IPAddress::Any until an address of the node is known
+
+    bool operator==(const DiscoveredNodeData & other) const
+    {
+        return (strcasecmp(instanceName, other.instanceName) == 0) && (longDiscriminator == other.longDiscriminator) &&
+            (vendorId == other.vendorId) && (productId == other.productId) && (port == other.port) &&
+            (interfaceId == other.interfaceId) && (address == other.address);
+    }
+    bool operator!=(const DiscoveredNodeData & other) const { return !(*this == other); }
+};
+
+enum class BrowseEvent : uint8_t
+{
+    kAdded,   // node was not known before
+    kUpdated, // node data (e.g. address or TXT values) changed
+    kRemoved, // node said goodbye, its records expired or it was not found anymore
+};
+
+/// Receives changes of the set of nodes seen by a browse session
+class BrowseDelegate
+{
+public:
+    virtual ~BrowseDelegate() = default;
+
+    /// Called for every node added, updated or removed while browsing
+    virtual void OnNodeDiscoveryChanged(BrowseEvent event, const DiscoveredNodeData & nodeData) = 0;
+};
+
 /// Interface for resolving CHIP services
 class Resolver
 {
 public:
     virtual ~Resolver() {}
 
+    /// Ensures that the resolver is started.
+    /// Must be called before any ResolveNodeId calls.
+    ///
+    /// Unusual name to allow base MDNS classes to implement both Advertiser and Resolver interfaces.
+    virtual CHIP_ERROR StartResolver(chip::Inet::InetLayer * inetLayer, uint16_t port) = 0;
+
     /// Registers a resolver delegate if none has been registered before
     virtual CHIP_ERROR SetResolverDelegate(ResolverDelegate * delegate) = 0;
 
     /// Requests resolution of a node ID to its address
     virtual CHIP_ERROR ResolveNodeId(uint64_t nodeId, uint64_t fabricId, Inet::IPAddressType type) = 0;
 
+    /// Starts a long-running browse for commissionable nodes.
+    ///
+    /// Nodes are reported to [delegate] as they appear, change or go away until
+    /// StopCommissionableBrowse is called. Queries are repeated with exponential
+    /// backoff, so a browse can be kept running for as long as needed.
+    virtual CHIP_ERROR StartCommissionableBrowse(BrowseDelegate * delegate) = 0;
+
+    /// Stops a browse started by StartCommissionableBrowse. No further events are reported.
+    virtual CHIP_ERROR StopCommissionableBrowse() = 0;
+
     /// Provides the system-wide implementation of the service resolver
     static Resolver & Instance();
 };
@@ -0,0 +1,826 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "Resolver.h"
+
+#include "Advertiser.h"
+#include "BrowseTable.h"
+#include "MinimalMdnsInterfaces.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <mdns/minimal/Parser.h>
+#include <mdns/minimal/QueryBuilder.h>
+#include <mdns/minimal/RecordData.h>
+#include <mdns/minimal/ResolverCache.h>
+#include <mdns/minimal/Server.h>
+#include <mdns/minimal/records/Ptr.h>
+#include <support/ErrorStr.h>
+#include <support/ReturnMacros.h>
+#include <support/logging/CHIPLogging.h>
+#include <system/SystemClock.h>
+
+namespace chip {
+namespace Mdns {
+namespace {
+
+using namespace mdns::Minimal;
+
+constexpr size_t kMaxQNameParts      = 8;
+constexpr uint16_t kQueryPacketSize  = 512;
+constexpr uint32_t kResolveTimeoutMs = 3000;
+
+const QNamePart kCommissionableService[]   = { "_chipc", "_udp", "local" };
+constexpr char kCommissionableServiceName[] = "_chipc._udp.local";
+
+/// Writes [name] as a dot-separated string into [buffer].
+///
+/// returns false if the name is invalid or does not fit.
+bool QNameToString(SerializedQNameIterator name, char * buffer, size_t bufferSize)
+{
+    size_t written = 0;
+
+    while (name.Next())
+    {
+        size_t partLength = strlen(name.Value());
+        size_t needed     = partLength + ((written == 0) ? 0 : 1);
+
+        if (written + needed + 1 > bufferSize)
+        {
+            return false;
+        }
+
+        if (written != 0)
+        {
+            buffer[written++] = '.';
+        }
+        memcpy(buffer + written, name.Value(), partLength);
+        written += partLength;
+    }
+
+    if (!name.IsValid() || (written == 0))
+    {
+        return false;
+    }
+
+    buffer[written] = '\0';
+    return true;
+}
+
+/// Splits a dot-separated name stored in [storage] into its QName parts.
+///
+/// [storage] is modified in place and must outlive the returned parts.
+size_t SplitQName(char * storage, QNamePart (&parts)[kMaxQNameParts])
+{
+    size_t count = 0;
+    char * part  = storage;
+
+    while ((part != nullptr) && (*part != '\0') && (count < kMaxQNameParts))
+    {
+        parts[count++] = part;
+
+        char * dot = strchr(part, '.');
+        if (dot != nullptr)
+        {
+            *dot = '\0';
+            dot++;
+        }
+        part = dot;
+    }
+
+    return (part == nullptr || *part == '\0') ? count : 0;
+}
+
+/// Extracts the instance name of a commissionable node from "<instance>._chipc._udp.local".
+bool GetCommissionableInstanceName(SerializedQNameIterator name,
+                                   char (&instanceName)[DiscoveredNodeData::kInstanceNameMaxLength + 1])
+{
+    if (!name.Next() || (strlen(name.Value()) > DiscoveredNodeData::kInstanceNameMaxLength))
+    {
+        return false;
+    }
+
+    strcpy(instanceName, name.Value());
+    return name == FullQName(kCommissionableService);
+}
+
+class CommissionableTxtParser : public TxtRecordDelegate
+{
+public:
+    explicit CommissionableTxtParser(DiscoveredNodeData & nodeData) : mNodeData(nodeData) {}
+
+    void OnRecord(const BytesRange & name, const BytesRange & value) override
+    {
+        ParseCommissionableTxtEntry(name.Start(), name.Size(), value.Start(), value.Size(), mNodeData);
+    }
+
+private:
+    DiscoveredNodeData & mNodeData;
+};
+
+class MinMdnsResolver : public Resolver,
+                        public ServerDelegate, // gets responses
+                        public ParserDelegate  // parses responses
+{
+public:
+    MinMdnsResolver() { mServer.SetDelegate(this); }
+    ~MinMdnsResolver() {}
+
+    // Resolver
+    CHIP_ERROR StartResolver(chip::Inet::InetLayer * inetLayer, uint16_t port) override;
+    CHIP_ERROR SetResolverDelegate(ResolverDelegate * delegate) override;
+    CHIP_ERROR ResolveNodeId(uint64_t nodeId, uint64_t fabricId, Inet::IPAddressType type) override;
+    CHIP_ERROR StartCommissionableBrowse(BrowseDelegate * delegate) override;
+    CHIP_ERROR StopCommissionableBrowse() override;
+
+    // ServerDelegate
+    void OnQuery(const BytesRange & data, const chip::Inet::IPPacketInfo * info) override {}
+    void OnResponse(const BytesRange & data, const chip::Inet::IPPacketInfo * info) override;
+
+    // ParserDelegate
+    void OnHeader(ConstHeaderRef & header) override {}
+    void OnQuery(const QueryData & data) override {}
+    void OnResource(ResourceType type, const ResourceData & data) override;
+
+private:
+    struct PendingResolve
+    {
+        bool active;
+        bool addressQuerySent;
+        uint64_t nodeId;
+        uint64_t fabricId;
+        Inet::IPAddressType addressType;
+        uint64_t deadlineMs;
+    };
+
+    /// What a single response packet said about a browsed node
+    struct BrowseUpdate
+    {
+        DiscoveredNodeData data;
+        uint32_t ttlSeconds;
+        bool hasTtl; // PTR or SRV seen: the node is (re)announced rather than just changed
+    };
+
+    static constexpr size_t kMaxEndPoints       = 30;
+    static constexpr size_t kMaxPendingResolves = 8;
+    static constexpr size_t kMaxCachedServices  = 16;
+    static constexpr size_t kMaxCachedAddresses = 32;
+    static constexpr size_t kMaxNameLength      = ResolverCacheBase::kMaxNameLength;
+    static constexpr size_t kMaxBrowsedNodes    = 16;
+    static constexpr size_t kMaxBrowseUpdates   = 8; // nodes described by a single response
+
+    // Browse queries back off exponentially (RFC 6762, section 5.2). The cap is well below the hour the
+    // RFC allows: a commissioner browses for minutes, and known answers keep the repeated queries small.
+    static constexpr uint32_t kBrowseInitialIntervalMs = 1000;
+    static constexpr uint32_t kBrowseMaxIntervalMs     = 2 * 60 * 1000;
+
+    static bool BuildInstanceName(uint64_t nodeId, uint64_t fabricId, char (&name)[kMaxNameLength + 1]);
+    static void HandleResolveTimeout(System::Layer * systemLayer, void * appState, System::Error error);
+
+    /// Reports pending resolves that can be answered from the cache and
+    /// asks for the host address of those that only have a SRV record.
+    void ProcessPendingResolves();
+
+    /// Fails pending resolves past their deadline and re-arms the timer for the rest.
+    void ExpirePendingResolves();
+
+    /// Reports [pending] through the delegate if the cache can answer it.
+    bool TryCompleteFromCache(PendingResolve & pending, uint64_t nowMs);
+
+    CHIP_ERROR SendQuery(const char * name, QType type);
+
+    static void HandleBrowseTimer(System::Layer * systemLayer, void * appState, System::Error error);
+
+    /// Expires browsed nodes and sends the periodic or refresh queries that are due.
+    void RunBrowse();
+    void ScheduleBrowseTimer(uint64_t nowMs);
+
+    /// Queries for commissionable nodes, listing the ones already known as known answers.
+    CHIP_ERROR SendBrowseQuery(uint64_t nowMs);
+
+    /// Remembers what a PTR, SRV or TXT record says about a commissionable node.
+    void OnBrowseResource(const ResourceData & data, uint32_t ttlSeconds);
+    BrowseUpdate * FindBrowseUpdate(const char * instanceName);
+
+    /// Applies the updates of the current response to the browse table.
+    void ApplyBrowseUpdates();
+
+    /// Sets the port and address of [nodeData] from the resolver cache, if known.
+    void FillBrowseAddress(DiscoveredNodeData & nodeData, uint64_t nowMs);
+
+    Server<kMaxEndPoints> mServer;
+    ResolverCache<kMaxCachedServices, kMaxCachedAddresses> mCache;
+    PendingResolve mPendingResolves[kMaxPendingResolves] = {};
+
+    System::Layer * mSystemLayer = nullptr;
+    ResolverDelegate * mDelegate = nullptr;
+    bool mTimerArmed             = false;
+
+    BrowseTable<kMaxBrowsedNodes> mBrowseTable;
+    BrowseUpdate mBrowseUpdates[kMaxBrowseUpdates];
+    size_t mBrowseUpdateCount        = 0;
+    BrowseDelegate * mBrowseDelegate = nullptr;
+    uint32_t mBrowseIntervalMs       = 0;
+    uint64_t mNextBrowseQueryMs      = 0;
+    bool mBrowseQuerySent            = false; // later queries are QM (RFC 6762, section 5.4)
+
+    // current response handling
+    const chip::Inet::IPPacketInfo * mCurrentSource = nullptr;
+    BytesRange mCurrentPacket;
+};
+
+bool MinMdnsResolver::BuildInstanceName(uint64_t nodeId, uint64_t fabricId, char (&name)[kMaxNameLength + 1])
+{
+    int len = snprintf(name, sizeof(name), "%" PRIX64 "-%" PRIX64 "._chip._tcp.local", nodeId, fabricId);
+    return (len > 0) && (static_cast<size_t>(len) < sizeof(name));
+}
+
+CHIP_ERROR MinMdnsResolver::StartResolver(chip::Inet::InetLayer * inetLayer, uint16_t port)
+{
+    VerifyOrReturnError(inetLayer != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mServer.Shutdown();
+
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+    if (inetLayer->GetInterfaceWatcher().IsActive())
+    {
+        WatchedInterfaces watchedInterfaces(inetLayer->GetInterfaceWatcher());
+        ReturnErrorOnFailure(mServer.Listen(inetLayer, &watchedInterfaces, port));
+    }
+    else
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
+    {
+        AllInterfaces allInterfaces;
+        ReturnErrorOnFailure(mServer.Listen(inetLayer, &allInterfaces, port));
+    }
+
+    mSystemLayer = inetLayer->SystemLayer();
+
+    ChipLogProgress(Discovery, "CHIP minimal mDNS resolver started.");
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR MinMdnsResolver::SetResolverDelegate(ResolverDelegate * delegate)
+{
+    VerifyOrReturnError(delegate == nullptr || mDelegate == nullptr, CHIP_ERROR_INCORRECT_STATE);
+    mDelegate = delegate;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR MinMdnsResolver::ResolveNodeId(uint64_t nodeId, uint64_t fabricId, Inet::IPAddressType type)
+{
+    char instanceName[kMaxNameLength + 1];
+    PendingResolve request = {};
+    PendingResolve * slot  = nullptr;
+    uint64_t nowMs         = System::Platform::Layer::GetClock_MonotonicMS();
+
+    VerifyOrReturnError(mSystemLayer != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(BuildInstanceName(nodeId, fabricId, instanceName), CHIP_ERROR_INVALID_ARGUMENT);
+
+    request.active      = true;
+    request.nodeId      = nodeId;
+    request.fabricId    = fabricId;
+    request.addressType = type;
+    request.deadlineMs  = nowMs + kResolveTimeoutMs;
+
+    // Unexpired SRV and address records answer the request without any network traffic
+    ReturnErrorCodeIf(TryCompleteFromCache(request, nowMs), CHIP_NO_ERROR);
+
+    for (size_t i = 0; i < kMaxPendingResolves; i++)
+    {
+        PendingResolve & pending = mPendingResolves[i];
+
+        if (!pending.active)
+        {
+            slot = (slot == nullptr) ? &pending : slot;
+            continue;
+        }
+
+        // Already in flight: the outstanding query will answer this request as well
+        ReturnErrorCodeIf((pending.nodeId == nodeId) && (pending.fabricId == fabricId) && (pending.addressType == type),
+                          CHIP_NO_ERROR);
+    }
+
+    VerifyOrReturnError(slot != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    *slot = request;
+
+    if (mCache.LookupHostName(instanceName, nowMs) != nullptr)
+    {
+        // Service is known, only its address expired
+        ProcessPendingResolves();
+    }
+    else
+    {
+        CHIP_ERROR err = SendQuery(instanceName, QType::SRV);
+        if (err != CHIP_NO_ERROR)
+        {
+            slot->active = false;
+            return err;
+        }
+    }
+
+    if (!mTimerArmed)
+    {
+        ReturnErrorOnFailure(mSystemLayer->StartTimer(kResolveTimeoutMs, HandleResolveTimeout, this));
+        mTimerArmed = true;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+bool MinMdnsResolver::TryCompleteFromCache(PendingResolve & pending, uint64_t nowMs)
+{
+    char instanceName[kMaxNameLength + 1];
+    CachedServiceAddress cached;
+
+    if (!BuildInstanceName(pending.nodeId, pending.fabricId, instanceName) ||
+        !mCache.Lookup(instanceName, pending.addressType, nowMs, cached))
+    {
+        return false;
+    }
+
+    pending.active = false;
+
+    ResolvedNodeData nodeData;
+    nodeData.mInterfaceId = cached.interfaceId;
+    nodeData.mAddress     = cached.address;
+    nodeData.mPort        = cached.port;
+
+    ChipLogProgress(Discovery, "Node ID resolved for %" PRIX64, pending.nodeId);
+
+    if (mDelegate != nullptr)
+    {
+        mDelegate->OnNodeIdResolved(pending.nodeId, nodeData);
+    }
+
+    return true;
+}
+
+void MinMdnsResolver::ProcessPendingResolves()
+{
+    uint64_t nowMs = System::Platform::Layer::GetClock_MonotonicMS();
+
+    for (size_t i = 0; i < kMaxPendingResolves; i++)
+    {
+        PendingResolve & pending = mPendingResolves[i];
+        char instanceName[kMaxNameLength + 1];
+
+        if (!pending.active || TryCompleteFromCache(pending, nowMs) || pending.addressQuerySent ||
+            !BuildInstanceName(pending.nodeId, pending.fabricId, instanceName))
+        {
+            continue;
+        }
+
+        const char * hostName = mCache.LookupHostName(instanceName, nowMs);
+        if (hostName == nullptr)
+        {
+            continue;
+        }
+
+        QType addressQuery = (pending.addressType == Inet::kIPAddressType_IPv4) ? QType::A : QType::AAAA;
+
+        pending.addressQuerySent = true;
+        CHIP_ERROR err           = SendQuery(hostName, addressQuery);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Discovery, "Failed to query host address: %s", ErrorStr(err));
+        }
+    }
+}
+
+void MinMdnsResolver::ExpirePendingResolves()
+{
+    uint64_t nowMs        = System::Platform::Layer::GetClock_MonotonicMS();
+    uint64_t nextDeadline = 0;
+
+    for (size_t i = 0; i < kMaxPendingResolves; i++)
+    {
+        PendingResolve & pending = mPendingResolves[i];
+
+        if (!pending.active)
+        {
+            continue;
+        }
+
+        if (pending.deadlineMs <= nowMs)
+        {
+            pending.active = false;
+
+            ChipLogError(Discovery, "Node ID resolve timed out for %" PRIX64, pending.nodeId);
+            if (mDelegate != nullptr)
+            {
+                mDelegate->OnNodeIdResolutionFailed(pending.nodeId, CHIP_ERROR_TIMEOUT);
+            }
+            continue;
+        }
+
+        if ((nextDeadline == 0) || (pending.deadlineMs < nextDeadline))
+        {
+            nextDeadline = pending.deadlineMs;
+        }
+    }
+
+    if ((nextDeadline != 0) &&
+        (mSystemLayer->StartTimer(static_cast<uint32_t>(nextDeadline - nowMs), HandleResolveTimeout, this) == CHIP_SYSTEM_NO_ERROR))
+    {
+        mTimerArmed = true;
+    }
+}
+
+void MinMdnsResolver::HandleResolveTimeout(System::Layer * systemLayer, void * appState, System::Error error)
+{
+    MinMdnsResolver * resolver = static_cast<MinMdnsResolver *>(appState);
+
+    resolver->mTimerArmed = false;
+    resolver->ExpirePendingResolves();
+}
+
+CHIP_ERROR MinMdnsResolver::SendQuery(const char * name, QType type)
+{
+    char nameStorage[kMaxNameLength + 1];
+    QNamePart parts[kMaxQNameParts];
+
+    VerifyOrReturnError(strlen(name) < sizeof(nameStorage), CHIP_ERROR_INVALID_ARGUMENT);
+    strcpy(nameStorage, name);
+
+    FullQName qName;
+    qName.names     = parts;
+    qName.nameCount = SplitQName(nameStorage, parts);
+    VerifyOrReturnError(qName.nameCount != 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    System::PacketBufferHandle buffer = System::PacketBufferHandle::New(kQueryPacketSize);
+    VerifyOrReturnError(!buffer.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    QueryBuilder builder(std::move(buffer));
+
+    // Unicast replies let the resolver listen on any port, independent of the advertiser
+    builder.AddQuery(Query(qName).SetClass(QClass::IN).SetType(type).SetAnswerViaUnicast(true));
+    VerifyOrReturnError(builder.Ok(), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    ReturnErrorOnFailure(mServer.BroadcastSend(builder.ReleasePacket(), kMdnsPort));
+
+    return CHIP_NO_ERROR;
+}
+
+void MinMdnsResolver::OnResponse(const BytesRange & data, const chip::Inet::IPPacketInfo * info)
+{
+    mCurrentSource = info;
+    mCurrentPacket = data;
+
+    if (!ParsePacket(data, this))
+    {
+        ChipLogError(Discovery, "Failed to parse mDNS response");
+    }
+
+    mCurrentSource = nullptr;
+    mCurrentPacket = BytesRange();
+
+    ProcessPendingResolves();
+
+    if (mBrowseDelegate != nullptr)
+    {
+        ApplyBrowseUpdates();
+    }
+    mBrowseUpdateCount = 0;
+}
+
+void MinMdnsResolver::OnResource(ResourceType type, const ResourceData & data)
+{
+    char name[kMaxNameLength + 1];
+    uint64_t nowMs      = System::Platform::Layer::GetClock_MonotonicMS();
+    uint32_t ttlSeconds = static_cast<uint32_t>(data.GetTtlSeconds() > UINT32_MAX ? UINT32_MAX : data.GetTtlSeconds());
+
+    if ((mCurrentSource == nullptr) || !QNameToString(data.GetName(), name, sizeof(name)))
+    {
+        return;
+    }
+
+    if (mBrowseDelegate != nullptr)
+    {
+        OnBrowseResource(data, ttlSeconds);
+    }
+
+    switch (data.GetType())
+    {
+    case QType::SRV: {
+        SrvRecord srv;
+        char hostName[kMaxNameLength + 1];
+
+        if (srv.Parse(data.GetData(), mCurrentPacket) && QNameToString(srv.GetName(), hostName, sizeof(hostName)))
+        {
+            mCache.AddSrv(name, hostName, srv.GetPort(), ttlSeconds, nowMs);
+        }
+        break;
+    }
+    case QType::TXT:
+        mCache.AddTxt(name, ttlSeconds, nowMs);
+        break;
+    case QType::AAAA: {
+        Inet::IPAddress address;
+
+        if (ParseAAAARecord(data.GetData(), &address))
+        {
+            mCache.AddAddress(name, address, mCurrentSource->Interface, ttlSeconds, nowMs);
+        }
+        break;
+    }
+#if INET_CONFIG_ENABLE_IPV4
+    case QType::A: {
+        Inet::IPAddress address;
+
+        if (ParseARecord(data.GetData(), &address))
+        {
+            mCache.AddAddress(name, address, mCurrentSource->Interface, ttlSeconds, nowMs);
+        }
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+}
+
+CHIP_ERROR MinMdnsResolver::StartCommissionableBrowse(BrowseDelegate * delegate)
+{
+    VerifyOrReturnError(delegate != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mSystemLayer != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mBrowseDelegate == nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    mBrowseTable.Clear();
+    mBrowseTable.SetDelegate(delegate);
+
+    mBrowseDelegate    = delegate;
+    mBrowseUpdateCount = 0;
+    mBrowseQuerySent   = false;
+    mBrowseIntervalMs  = kBrowseInitialIntervalMs;
+    mNextBrowseQueryMs = System::Platform::Layer::GetClock_MonotonicMS();
+
+    RunBrowse();
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR MinMdnsResolver::StopCommissionableBrowse()
+{
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(HandleBrowseTimer, this);
+    }
+
+    mBrowseDelegate = nullptr;
+    mBrowseTable.SetDelegate(nullptr);
+    mBrowseTable.Clear();
+
+    return CHIP_NO_ERROR;
+}
+
+void MinMdnsResolver::HandleBrowseTimer(System::Layer * systemLayer, void * appState, System::Error error)
+{
+    static_cast<MinMdnsResolver *>(appState)->RunBrowse();
+}
+
+void MinMdnsResolver::RunBrowse()
+{
+    uint64_t nowMs = System::Platform::Layer::GetClock_MonotonicMS();
+
+    mBrowseTable.Expire(nowMs);
+    VerifyOrReturn(mBrowseDelegate != nullptr); // stopped by the delegate
+
+    const bool refreshDue  = mBrowseTable.TakeRefreshDue(nowMs);
+    const bool periodicDue = (nowMs >= mNextBrowseQueryMs);
+
+    if (refreshDue || periodicDue)
+    {
+        CHIP_ERROR err = SendBrowseQuery(nowMs);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Discovery, "Failed to send browse query: %s", ErrorStr(err));
+        }
+    }
+
+    if (periodicDue)
+    {
+        mNextBrowseQueryMs = nowMs + mBrowseIntervalMs;
+        mBrowseIntervalMs  = std::min(mBrowseIntervalMs * 2, kBrowseMaxIntervalMs);
+    }
+
+    ScheduleBrowseTimer(nowMs);
+}
+
+void MinMdnsResolver::ScheduleBrowseTimer(uint64_t nowMs)
+{
+    uint64_t nextMs      = mNextBrowseQueryMs;
+    uint64_t tableNextMs = mBrowseTable.NextEventMs();
+
+    if ((tableNextMs != 0) && (tableNextMs < nextMs))
+    {
+        nextMs = tableNextMs;
+    }
+
+    // Re-arming replaces any pending browse timer
+    uint32_t delayMs = (nextMs > nowMs) ? static_cast<uint32_t>(nextMs - nowMs) : 0;
+    if (mSystemLayer->StartTimer(delayMs, HandleBrowseTimer, this) != CHIP_SYSTEM_NO_ERROR)
+    {
+        ChipLogError(Discovery, "Failed to schedule browse timer");
+    }
+}
+
+CHIP_ERROR MinMdnsResolver::SendBrowseQuery(uint64_t nowMs)
+{
+    System::PacketBufferHandle buffer = System::PacketBufferHandle::New(kQueryPacketSize);
+    VerifyOrReturnError(!buffer.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    QueryBuilder builder(std::move(buffer));
+
+    // Only the first query of a browse asks for unicast answers: later ones are answered via
+    // multicast, so that they also refresh the caches of other hosts and can be coalesced
+    builder.AddQuery(
+        Query(kCommissionableService).SetClass(QClass::IN).SetType(QType::PTR).SetAnswerViaUnicast(!mBrowseQuerySent));
+
+    // Known answers (RFC 6762, section 7.1): responders stay silent for nodes that are
+    // known with more than half of their TTL left
+    for (size_t i = 0; i < mBrowseTable.GetCapacity(); i++)
+    {
+        const BrowseTableBase::Entry * entry = mBrowseTable.GetEntry(i);
+
+        if ((entry == nullptr) || (entry->ttlSeconds == BrowseTableBase::kNoExpiry) || (entry->expiryMs <= nowMs))
+        {
+            continue;
+        }
+
+        uint64_t remainingMs = entry->expiryMs - nowMs;
+        if (remainingMs * 2 <= entry->ttlSeconds * 1000ULL)
+        {
+            continue;
+        }
+
+        const QNamePart instanceParts[] = { entry->data.instanceName, "_chipc", "_udp", "local" };
+        PtrResourceRecord knownAnswer(kCommissionableService, instanceParts);
+
+        knownAnswer.SetTtl(static_cast<uint32_t>(remainingMs / 1000));
+        builder.AddAnswer(knownAnswer);
+    }
+
+    VerifyOrReturnError(builder.Ok(), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    ReturnErrorOnFailure(mServer.BroadcastSend(builder.ReleasePacket(), kMdnsPort));
+    mBrowseQuerySent = true;
+
+    return CHIP_NO_ERROR;
+}
+
+MinMdnsResolver::BrowseUpdate * MinMdnsResolver::FindBrowseUpdate(const char * instanceName)
+{
+    for (size_t i = 0; i < mBrowseUpdateCount; i++)
+    {
+        if (strcasecmp(mBrowseUpdates[i].data.instanceName, instanceName) == 0)
+        {
+            return &mBrowseUpdates[i];
+        }
+    }
+
+    VerifyOrReturnError(mBrowseUpdateCount < kMaxBrowseUpdates, nullptr);
+
+    BrowseUpdate & update            = mBrowseUpdates[mBrowseUpdateCount++];
+    const DiscoveredNodeData * known = mBrowseTable.Find(instanceName);
+
+    if (known != nullptr)
+    {
+        update.data = *known;
+    }
+    else
+    {
+        update.data = DiscoveredNodeData();
+        strcpy(update.data.instanceName, instanceName);
+        update.data.interfaceId = INET_NULL_INTERFACEID;
+        update.data.address     = Inet::IPAddress::Any;
+    }
+    update.ttlSeconds = 0;
+    update.hasTtl     = false;
+
+    return &update;
+}
+
+void MinMdnsResolver::OnBrowseResource(const ResourceData & data, uint32_t ttlSeconds)
+{
+    char instanceName[DiscoveredNodeData::kInstanceNameMaxLength + 1];
+    SerializedQNameIterator instance = data.GetName();
+
+    switch (data.GetType())
+    {
+    case QType::PTR:
+        // _chipc._udp.local points to the instance name
+        if (!(data.GetName() == FullQName(kCommissionableService)) || !ParsePtrRecord(data.GetData(), mCurrentPacket, &instance))
+        {
+            return;
+        }
+        break;
+    case QType::SRV:
+    case QType::TXT:
+        break;
+    default:
+        return;
+    }
+
+    BrowseUpdate * update = nullptr;
+    if (!GetCommissionableInstanceName(instance, instanceName) || ((update = FindBrowseUpdate(instanceName)) == nullptr))
+    {
+        return;
+    }
+
+    if (data.GetType() == QType::TXT)
+    {
+        CommissionableTxtParser parser(update->data);
+        ParseTxtRecord(data.GetData(), &parser);
+        return;
+    }
+
+    // PTR and SRV records both carry the lifetime of the node: a goodbye on either removes it
+    update->ttlSeconds = update->hasTtl ? std::min(update->ttlSeconds, ttlSeconds) : ttlSeconds;
+    update->hasTtl     = true;
+}
+
+void MinMdnsResolver::FillBrowseAddress(DiscoveredNodeData & nodeData, uint64_t nowMs)
+{
+    char fullName[kMaxNameLength + 1];
+    CachedServiceAddress cached;
+
+    snprintf(fullName, sizeof(fullName), "%s.%s", nodeData.instanceName, kCommissionableServiceName);
+
+    if (mCache.Lookup(fullName, Inet::kIPAddressType_Any, nowMs, cached))
+    {
+        nodeData.port        = cached.port;
+        nodeData.interfaceId = cached.interfaceId;
+        nodeData.address     = cached.address;
+    }
+}
+
+void MinMdnsResolver::ApplyBrowseUpdates()
+{
+    uint64_t nowMs = System::Platform::Layer::GetClock_MonotonicMS();
+
+    for (size_t i = 0; (i < mBrowseUpdateCount) && (mBrowseDelegate != nullptr); i++)
+    {
+        BrowseUpdate & update = mBrowseUpdates[i];
+
+        FillBrowseAddress(update.data, nowMs);
+
+        if (!update.hasTtl)
+        {
+            mBrowseTable.Refresh(update.data);
+        }
+        else if (mBrowseTable.Update(update.data, update.ttlSeconds, nowMs) != CHIP_NO_ERROR)
+        {
+            ChipLogError(Discovery, "Browse table full, ignoring node %s", update.data.instanceName);
+        }
+    }
+
+    // Address records are also sent on their own (e.g. when a host address changes)
+    for (size_t i = 0; (i < mBrowseTable.GetCapacity()) && (mBrowseDelegate != nullptr); i++)
+    {
+        const BrowseTableBase::Entry * entry = mBrowseTable.GetEntry(i);
+
+        if (entry != nullptr)
+        {
+            DiscoveredNodeData nodeData = entry->data;
+            FillBrowseAddress(nodeData, nowMs);
+            mBrowseTable.Refresh(nodeData);
+        }
+    }
+
+    if (mBrowseDelegate != nullptr)
+    {
+        ScheduleBrowseTimer(nowMs);
+    }
+}
+
+MinMdnsResolver gResolver;
+
+} // namespace
+
+Resolver & chip::Mdns::Resolver::Instance()
+{
+    return gResolver;
+}
+
+} // namespace Mdns
+} // namespace chip
@@ -26,6 +26,8 @@ namespace {
 class NoneResolver : public Resolver
 {
 public:
+    CHIP_ERROR StartResolver(chip::Inet::InetLayer * inetLayer, uint16_t port) override { return CHIP_NO_ERROR; }
+
     CHIP_ERROR SetResolverDelegate(ResolverDelegate *) override { return CHIP_NO_ERROR; }
 
     CHIP_ERROR ResolveNodeId(uint64_t nodeId, uint64_t fabricId, Inet::IPAddressType type) override
@@ -33,6 +35,14 @@ public:
         ChipLogError(Discovery, "Failed to resolve node ID: mDNS resolving not available");
         return CHIP_ERROR_NOT_IMPLEMENTED;
     }
+
+    CHIP_ERROR StartCommissionableBrowse(BrowseDelegate * delegate) override
+    {
+        ChipLogError(Discovery, "Failed to browse commissionable nodes: mDNS resolving not available");
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    CHIP_ERROR StopCommissionableBrowse() override { return CHIP_NO_ERROR; }
 };
 
 NoneResolver gResolver;
@@ -0,0 +1,172 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "KnownAnswers.h"
+
+#include "Parser.h"
+#include "RecordData.h"
+
+#include <string.h>
+#include <strings.h>
+
+namespace mdns {
+namespace Minimal {
+namespace {
+
+// Records larger than this are never reported as known (they are just sent).
+constexpr size_t kMaxSerializedRecordSize = 256;
+
+bool SameName(SerializedQNameIterator a, SerializedQNameIterator b)
+{
+    while (true)
+    {
+        bool hasA = a.Next();
+        bool hasB = b.Next();
+
+        if (!hasA || !hasB)
+        {
+            return !hasA && !hasB && a.IsValid() && b.IsValid();
+        }
+
+        if (strcasecmp(a.Value(), b.Value()) != 0)
+        {
+            return false;
+        }
+    }
+}
+
+/// Compares record data, following name compression where the record type contains names.
+bool SameData(QType type, const ResourceData & a, const BytesRange & aPacket, const ResourceData & b, const BytesRange & bPacket)
+{
+    switch (type)
+    {
+    case QType::PTR: {
+        SerializedQNameIterator aName;
+        SerializedQNameIterator bName;
+
+        return ParsePtrRecord(a.GetData(), aPacket, &aName) && ParsePtrRecord(b.GetData(), bPacket, &bName) &&
+            SameName(aName, bName);
+    }
+    case QType::SRV: {
+        SrvRecord aSrv;
+        SrvRecord bSrv;
+
+        return aSrv.Parse(a.GetData(), aPacket) && bSrv.Parse(b.GetData(), bPacket) && (aSrv.GetPort() == bSrv.GetPort()) &&
+            (aSrv.GetPriority() == bSrv.GetPriority()) && (aSrv.GetWeight() == bSrv.GetWeight()) &&
+            SameName(aSrv.GetName(), bSrv.GetName());
+    }
+    default:
+        return (a.GetData().Size() == b.GetData().Size()) &&
+            (memcmp(a.GetData().Start(), b.GetData().Start(), a.GetData().Size()) == 0);
+    }
+}
+
+} // namespace
+
+bool KnownAnswers::Init(const BytesRange & packet)
+{
+    Clear();
+
+    if (packet.Size() < HeaderRef::kSizeBytes)
+    {
+        return false;
+    }
+
+    ConstHeaderRef header(packet.Start());
+    const uint8_t * data = packet.Start() + HeaderRef::kSizeBytes;
+
+    QueryData queryData;
+    for (uint16_t i = 0; i < header.GetQueryCount(); i++)
+    {
+        if (!queryData.Parse(packet, &data))
+        {
+            return false;
+        }
+    }
+
+    mPacket      = packet;
+    mAnswers     = data;
+    mAnswerCount = header.GetAnswerCount();
+
+    return true;
+}
+
+bool KnownAnswers::Contains(const ResourceRecord & record) const
+{
+    if (IsEmpty())
+    {
+        return false;
+    }
+
+    // Serialize the record and parse it back, so that it can be compared with the
+    // received answers the same way regardless of record type
+    uint8_t headerBuffer[HeaderRef::kSizeBytes];
+    uint8_t recordBuffer[kMaxSerializedRecordSize];
+
+    HeaderRef header(headerBuffer);
+    header.Clear();
+
+    chip::Encoding::BigEndian::BufferWriter out(recordBuffer, sizeof(recordBuffer));
+    if (!record.Append(header, ResourceType::kAnswer, out))
+    {
+        return false;
+    }
+
+    const BytesRange recordRange(recordBuffer, recordBuffer + out.Needed());
+    const uint8_t * recordStart = recordBuffer;
+    ResourceData ours;
+
+    if (!ours.Parse(recordRange, &recordStart))
+    {
+        return false;
+    }
+
+    const uint8_t * data = mAnswers;
+    ResourceData known;
+
+    for (uint16_t i = 0; i < mAnswerCount; i++)
+    {
+        if (!known.Parse(mPacket, &data))
+        {
+            return false;
+        }
+
+        // The top class bit is the cache-flush flag in resource records, not part of the class
+        if ((known.GetType() != ours.GetType()) ||
+            ((static_cast<uint16_t>(known.GetClass()) & ~kQClassUnicastAnswerFlag) != static_cast<uint16_t>(ours.GetClass())))
+        {
+            continue;
+        }
+
+        // https://tools.ietf.org/html/rfc6762#section-7.1: the known answer only
+        // counts if its TTL is at least half of the correct TTL
+        if (known.GetTtlSeconds() * 2 < ours.GetTtlSeconds())
+        {
+            continue;
+        }
+
+        if (SameName(known.GetName(), ours.GetName()) && SameData(ours.GetType(), known, mPacket, ours, recordRange))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace Minimal
+} // namespace mdns
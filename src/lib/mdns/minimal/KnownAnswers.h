@@ -0,0 +1,64 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <mdns/minimal/core/BytesRange.h>
+#include <mdns/minimal/records/ResourceRecord.h>
+
+namespace mdns {
+namespace Minimal {
+
+/// Known answers listed in the answer section of a received query.
+///
+/// Implements the check for known-answer suppression as described in
+/// https://tools.ietf.org/html/rfc6762#section-7.1: a responder must not
+/// send an answer that the querier already listed with at least half of
+/// the correct TTL remaining.
+class KnownAnswers
+{
+public:
+    KnownAnswers() {}
+
+    /// Uses the answer section of the query packet [packet] as the known answer list.
+    ///
+    /// [packet] must remain valid for as long as this object is used.
+    ///
+    /// returns false if the packet could not be parsed (known answer list is left empty).
+    bool Init(const BytesRange & packet);
+
+    /// Drops the current known answer list.
+    void Clear()
+    {
+        mPacket      = BytesRange();
+        mAnswers     = nullptr;
+        mAnswerCount = 0;
+    }
+
+    bool IsEmpty() const { return mAnswerCount == 0; }
+
+    /// Checks if [record] is listed as a known answer with at least half of its TTL.
+    bool Contains(const ResourceRecord & record) const;
+
+private:
+    BytesRange mPacket;
+    const uint8_t * mAnswers = nullptr;
+    uint16_t mAnswerCount    = 0;
+};
+
+} // namespace Minimal
+} // namespace mdns
@@ -24,7 +24,7 @@
 namespace mdns {
 namespace Minimal {
 
-bool QueryData::Parse(const BytesRange & validData, const uint8_t ** start)
+bool QueryData::Parse(const BytesRange & validData, const uint8_t ** start, QNameTableBase * nameTable)
 {
     // Structure is:
     //    QNAME
@@ -37,6 +37,15 @@ bool QueryData::Parse(const BytesRange & validData, const uint8_t ** start)
     }
 
     const uint8_t * nameEnd = nullptr;
+    QNameId nameId          = kInvalidQNameId;
+    if (nameTable != nullptr)
+    {
+        if (!nameTable->Intern(*start, &nameEnd, &nameId))
+        {
+            return false;
+        }
+    }
+    else
     {
         SerializedQNameIterator it(validData, *start);
         nameEnd = it.FindDataEnd();
@@ -60,6 +69,8 @@ bool QueryData::Parse(const BytesRange & validData, const uint8_t ** start)
     mAnswerViaUnicast = (klass & kQClassUnicastAnswerFlag) != 0;
     mClass            = static_cast<QClass>(klass & ~kQClassUnicastAnswerFlag);
     mNameIterator     = SerializedQNameIterator(validData, *start);
+    mNameTable        = nameTable;
+    mNameId           = nameId;
 
     *start = nameEnd;
 
@@ -85,7 +96,7 @@ bool QueryData::Append(HeaderRef & hdr, chip::Encoding::BigEndian::BufferWriter
     return out.Fit();
 }
 
-bool ResourceData::Parse(const BytesRange & validData, const uint8_t ** start)
+bool ResourceData::Parse(const BytesRange & validData, const uint8_t ** start, QNameTableBase * nameTable)
 {
     // Structure is:
     //    QNAME
@@ -100,7 +111,16 @@ bool ResourceData::Parse(const BytesRange & validData, const uint8_t ** start)
     }
 
     const uint8_t * nameEnd = nullptr;
+    QNameId nameId          = kInvalidQNameId;
 
+    if (nameTable != nullptr)
+    {
+        if (!nameTable->Intern(*start, &nameEnd, &nameId))
+        {
+            return false;
+        }
+    }
+    else
     {
         SerializedQNameIterator it(validData, *start);
         nameEnd = it.FindDataEnd();
@@ -129,13 +149,14 @@ bool ResourceData::Parse(const BytesRange & validData, const uint8_t ** start)
     mData = BytesRange(nameEnd, nameEnd + dataLen);
 
     mNameIterator = SerializedQNameIterator(validData, *start);
+    mNameId       = nameId;
 
     *start = nameEnd + dataLen;
 
     return true;
 }
 
-bool ParsePacket(const BytesRange & packetData, ParserDelegate * delegate)
+bool ParsePacket(const BytesRange & packetData, ParserDelegate * delegate, QNameTableBase * nameTable)
 {
     if (packetData.Size() < static_cast<ptrdiff_t>(HeaderRef::kSizeBytes))
     {
@@ -150,6 +171,11 @@ bool ParsePacket(const BytesRange & packetData, ParserDelegate * delegate)
         return false;
     }
 
+    if (nameTable != nullptr)
+    {
+        nameTable->Reset(packetData);
+    }
+
     delegate->OnHeader(header);
 
     const uint8_t * data = packetData.Start() + HeaderRef::kSizeBytes;
@@ -158,7 +184,7 @@ bool ParsePacket(const BytesRange & packetData, ParserDelegate * delegate)
         QueryData queryData;
         for (uint16_t i = 0; i < header.GetQueryCount(); i++)
         {
-            if (!queryData.Parse(packetData, &data))
+            if (!queryData.Parse(packetData, &data, nameTable))
             {
                 return false;
             }
@@ -171,7 +197,7 @@ bool ParsePacket(const BytesRange & packetData, ParserDelegate * delegate)
         ResourceData resourceData;
         for (uint16_t i = 0; i < header.GetAnswerCount(); i++)
         {
-            if (!resourceData.Parse(packetData, &data))
+            if (!resourceData.Parse(packetData, &data, nameTable))
             {
                 return false;
             }
@@ -181,7 +207,7 @@ bool ParsePacket(const BytesRange & packetData, ParserDelegate * delegate)
 
         for (uint16_t i = 0; i < header.GetAuthorityCount(); i++)
         {
-            if (!resourceData.Parse(packetData, &data))
+            if (!resourceData.Parse(packetData, &data, nameTable))
             {
                 return false;
             }
@@ -191,7 +217,7 @@ bool ParsePacket(const BytesRange & packetData, ParserDelegate * delegate)
 
         for (uint16_t i = 0; i < header.GetAdditionalCount(); i++)
         {
-            if (!resourceData.Parse(packetData, &data))
+            if (!resourceData.Parse(packetData, &data, nameTable))
             {
                 return false;
             }
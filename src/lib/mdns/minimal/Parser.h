@@ -20,6 +20,7 @@
 #include <mdns/minimal/core/Constants.h>
 #include <mdns/minimal/core/DnsHeader.h>
 #include <mdns/minimal/core/QName.h>
+#include <mdns/minimal/core/QNameTable.h>
 
 namespace mdns {
 namespace Minimal {
@@ -48,12 +49,19 @@ public:
 
     SerializedQNameIterator GetName() const { return mNameIterator; }
 
+    /// Table where the query name was interned, nullptr if not parsed with a name table.
+    QNameTableBase * GetNameTable() const { return mNameTable; }
+
+    /// Interned name id, kInvalidQNameId if the name was not interned.
+    QNameId GetNameId() const { return mNameId; }
+
     /// Parses a query structure
     ///
     /// Parses the query at [start] and updates start to the end of the structure.
+    /// If [nameTable] is provided, the query name is also interned in it.
     ///
     /// returns true on parse success, false on failure.
-    bool Parse(const BytesRange & validData, const uint8_t ** start);
+    bool Parse(const BytesRange & validData, const uint8_t ** start, QNameTableBase * nameTable = nullptr);
 
     /// Write out this query data back into an output buffer.
     bool Append(HeaderRef & hdr, chip::Encoding::BigEndian::BufferWriter & out) const;
@@ -63,6 +71,8 @@ private:
     QClass mClass          = QClass::ANY;
     bool mAnswerViaUnicast = false;
     SerializedQNameIterator mNameIterator;
+    QNameTableBase * mNameTable = nullptr;
+    QNameId mNameId             = kInvalidQNameId;
 
     /// Flag as a boot-time internal query. This allows query replies
     /// to be built accordingly.
@@ -83,16 +93,21 @@ public:
     SerializedQNameIterator GetName() const { return mNameIterator; }
     const BytesRange & GetData() const { return mData; }
 
+    /// Interned name id, kInvalidQNameId if the name was not interned.
+    QNameId GetNameId() const { return mNameId; }
+
     /// Parses a resource data structure
     ///
     /// Parses the daata at [start] and updates start to the end of the structure.
     /// Updates [out] with the parsed data on success.
+    /// If [nameTable] is provided, the record name is also interned in it.
     ///
     /// returns true on parse success, false on failure.
-    bool Parse(const BytesRange & validData, const uint8_t ** start);
+    bool Parse(const BytesRange & validData, const uint8_t ** start, QNameTableBase * nameTable = nullptr);
 
 private:
     SerializedQNameIterator mNameIterator;
+    QNameId mNameId = kInvalidQNameId;
     QType mType   = QType::ANY;
     QClass mClass = QClass::ANY;
     uint64_t mTtl = 0;
@@ -115,8 +130,12 @@ public:
 ///
 /// Calls appropriate delegate callbacks while parsing
 ///
+/// If [nameTable] is provided, it is reset and every query and record name is
+/// interned while parsing, so that delegates can match names by comparing ids
+/// (see QueryData::GetNameId) instead of re-walking compressed names.
+///
 /// returns true if packet was succesfully parsed, false otherwise
-bool ParsePacket(const BytesRange & packetData, ParserDelegate * delegate);
+bool ParsePacket(const BytesRange & packetData, ParserDelegate * delegate, QNameTableBase * nameTable = nullptr);
 
 } // namespace Minimal
 } // namespace mdns
@@ -21,6 +21,7 @@
 
 #include <mdns/minimal/Query.h>
 #include <mdns/minimal/core/DnsHeader.h>
+#include <mdns/minimal/records/ResourceRecord.h>
 
 namespace mdns {
 namespace Minimal {
@@ -80,6 +81,26 @@ public:
         return *this;
     }
 
+    /// Adds a known answer (RFC 6762, section 7.1). Must be called after all AddQuery calls.
+    ///
+    /// Known answers are optional: one that does not fit is skipped without
+    /// affecting Ok(), as leaving it out only costs a redundant response.
+    QueryBuilder & AddAnswer(const ResourceRecord & record)
+    {
+        if (!mQueryBuildOk)
+        {
+            return *this;
+        }
+
+        chip::Encoding::BigEndian::BufferWriter out(mPacket->Start() + mPacket->DataLength(), mPacket->AvailableDataLength());
+
+        if (record.Append(mHeader, ResourceType::kAnswer, out))
+        {
+            mPacket->SetDataLength(static_cast<uint16_t>(mPacket->DataLength() + out.Needed()));
+        }
+        return *this;
+    }
+
     bool Ok() const { return mQueryBuildOk; }
 
 private:
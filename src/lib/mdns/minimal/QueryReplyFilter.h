@@ -86,6 +86,13 @@ private:
             return true;
         }
 
+        // Names interned during parsing compare by id, without following compression pointers
+        QNameTableBase * nameTable = mQueryData.GetNameTable();
+        if ((nameTable != nullptr) && (mQueryData.GetNameId() != kInvalidQNameId))
+        {
+            return nameTable->Find(qname) == mQueryData.GetNameId();
+        }
+
         return (mQueryData.GetName() == qname);
     }
 
@@ -0,0 +1,291 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "ResolverCache.h"
+
+#include <string.h>
+#include <strings.h>
+
+namespace mdns {
+namespace Minimal {
+namespace {
+
+constexpr uint64_t kMillisecondsPerSecond = 1000;
+
+uint64_t ExpiryFor(uint32_t ttlSeconds, uint64_t nowMs)
+{
+    return nowMs + static_cast<uint64_t>(ttlSeconds) * kMillisecondsPerSecond;
+}
+
+bool IsLive(uint64_t expiryMs, uint64_t nowMs)
+{
+    return expiryMs > nowMs;
+}
+
+uint64_t LatestExpiry(const ResolverCacheBase::ServiceEntry & entry)
+{
+    return (entry.srvExpiryMs > entry.txtExpiryMs) ? entry.srvExpiryMs : entry.txtExpiryMs;
+}
+
+bool CopyName(char (&dest)[ResolverCacheBase::kMaxNameLength + 1], const char * src)
+{
+    size_t len = strlen(src);
+    if (len > ResolverCacheBase::kMaxNameLength)
+    {
+        return false;
+    }
+
+    memcpy(dest, src, len + 1);
+    return true;
+}
+
+bool AddressTypeMatches(const chip::Inet::IPAddress & address, chip::Inet::IPAddressType addressType)
+{
+    return (addressType == chip::Inet::kIPAddressType_Any) || (address.Type() == addressType);
+}
+
+} // namespace
+
+void ResolverCacheBase::Clear()
+{
+    for (size_t i = 0; i < mServiceCount; i++)
+    {
+        mServices[i].instanceName[0] = '\0';
+        mServices[i].hostName[0]     = '\0';
+        mServices[i].srvExpiryMs     = 0;
+        mServices[i].txtExpiryMs     = 0;
+    }
+
+    for (size_t i = 0; i < mAddressCount; i++)
+    {
+        mAddresses[i].hostName[0] = '\0';
+        mAddresses[i].expiryMs    = 0;
+    }
+}
+
+ResolverCacheBase::ServiceEntry * ResolverCacheBase::FindService(const char * instanceName)
+{
+    for (size_t i = 0; i < mServiceCount; i++)
+    {
+        if (((mServices[i].srvExpiryMs != 0) || (mServices[i].txtExpiryMs != 0)) &&
+            (strcasecmp(mServices[i].instanceName, instanceName) == 0))
+        {
+            return &mServices[i];
+        }
+    }
+
+    return nullptr;
+}
+
+const ResolverCacheBase::ServiceEntry * ResolverCacheBase::FindService(const char * instanceName, uint64_t nowMs) const
+{
+    for (size_t i = 0; i < mServiceCount; i++)
+    {
+        if ((IsLive(mServices[i].srvExpiryMs, nowMs) || IsLive(mServices[i].txtExpiryMs, nowMs)) &&
+            (strcasecmp(mServices[i].instanceName, instanceName) == 0))
+        {
+            return &mServices[i];
+        }
+    }
+
+    return nullptr;
+}
+
+ResolverCacheBase::ServiceEntry * ResolverCacheBase::FindOrAllocateService(const char * instanceName, uint64_t nowMs)
+{
+    ServiceEntry * entry = FindService(instanceName);
+    if (entry != nullptr)
+    {
+        return entry;
+    }
+
+    // Reuse an expired entry if possible, otherwise evict whatever expires first
+    for (size_t i = 0; i < mServiceCount; i++)
+    {
+        ServiceEntry & candidate = mServices[i];
+
+        if (!IsLive(LatestExpiry(candidate), nowMs))
+        {
+            entry = &candidate;
+            break;
+        }
+
+        if ((entry == nullptr) || (LatestExpiry(candidate) < LatestExpiry(*entry)))
+        {
+            entry = &candidate;
+        }
+    }
+
+    if ((entry == nullptr) || !CopyName(entry->instanceName, instanceName))
+    {
+        return nullptr;
+    }
+
+    entry->hostName[0] = '\0';
+    entry->port        = 0;
+    entry->srvExpiryMs = 0;
+    entry->txtExpiryMs = 0;
+
+    return entry;
+}
+
+void ResolverCacheBase::AddSrv(const char * instanceName, const char * hostName, uint16_t port, uint32_t ttlSeconds,
+                               uint64_t nowMs)
+{
+    if (ttlSeconds == 0)
+    {
+        ServiceEntry * entry = FindService(instanceName);
+        if (entry != nullptr)
+        {
+            entry->srvExpiryMs = 0;
+        }
+        return;
+    }
+
+    ServiceEntry * entry = FindOrAllocateService(instanceName, nowMs);
+    if ((entry == nullptr) || !CopyName(entry->hostName, hostName))
+    {
+        return;
+    }
+
+    entry->port        = port;
+    entry->srvExpiryMs = ExpiryFor(ttlSeconds, nowMs);
+}
+
+void ResolverCacheBase::AddTxt(const char * instanceName, uint32_t ttlSeconds, uint64_t nowMs)
+{
+    if (ttlSeconds == 0)
+    {
+        ServiceEntry * entry = FindService(instanceName);
+        if (entry != nullptr)
+        {
+            entry->txtExpiryMs = 0;
+        }
+        return;
+    }
+
+    ServiceEntry * entry = FindOrAllocateService(instanceName, nowMs);
+    if (entry != nullptr)
+    {
+        entry->txtExpiryMs = ExpiryFor(ttlSeconds, nowMs);
+    }
+}
+
+void ResolverCacheBase::AddAddress(const char * hostName, const chip::Inet::IPAddress & address,
+                                   chip::Inet::InterfaceId interfaceId, uint32_t ttlSeconds, uint64_t nowMs)
+{
+    AddressEntry * entry = nullptr;
+
+    for (size_t i = 0; i < mAddressCount; i++)
+    {
+        AddressEntry & candidate = mAddresses[i];
+
+        if ((candidate.expiryMs != 0) && (candidate.address == address) && (candidate.interfaceId == interfaceId) &&
+            (strcasecmp(candidate.hostName, hostName) == 0))
+        {
+            entry = &candidate;
+            break;
+        }
+    }
+
+    if (ttlSeconds == 0)
+    {
+        if (entry != nullptr)
+        {
+            entry->expiryMs = 0;
+        }
+        return;
+    }
+
+    if (entry == nullptr)
+    {
+        // Reuse an expired entry if possible, otherwise evict whatever expires first
+        for (size_t i = 0; i < mAddressCount; i++)
+        {
+            AddressEntry & candidate = mAddresses[i];
+
+            if (!IsLive(candidate.expiryMs, nowMs))
+            {
+                entry = &candidate;
+                break;
+            }
+
+            if ((entry == nullptr) || (candidate.expiryMs < entry->expiryMs))
+            {
+                entry = &candidate;
+            }
+        }
+
+        if ((entry == nullptr) || !CopyName(entry->hostName, hostName))
+        {
+            return;
+        }
+
+        entry->address     = address;
+        entry->interfaceId = interfaceId;
+    }
+
+    entry->expiryMs = ExpiryFor(ttlSeconds, nowMs);
+}
+
+bool ResolverCacheBase::Lookup(const char * instanceName, chip::Inet::IPAddressType addressType, uint64_t nowMs,
+                               CachedServiceAddress & out) const
+{
+    const ServiceEntry * service = FindService(instanceName, nowMs);
+    if ((service == nullptr) || !IsLive(service->srvExpiryMs, nowMs))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < mAddressCount; i++)
+    {
+        const AddressEntry & entry = mAddresses[i];
+
+        if (!IsLive(entry.expiryMs, nowMs) || !AddressTypeMatches(entry.address, addressType) ||
+            (strcasecmp(entry.hostName, service->hostName) != 0))
+        {
+            continue;
+        }
+
+        out.interfaceId = entry.interfaceId;
+        out.address     = entry.address;
+        out.port        = service->port;
+        return true;
+    }
+
+    return false;
+}
+
+const char * ResolverCacheBase::LookupHostName(const char * instanceName, uint64_t nowMs) const
+{
+    const ServiceEntry * service = FindService(instanceName, nowMs);
+    if ((service == nullptr) || !IsLive(service->srvExpiryMs, nowMs))
+    {
+        return nullptr;
+    }
+
+    return service->hostName;
+}
+
+bool ResolverCacheBase::HasTxt(const char * instanceName, uint64_t nowMs) const
+{
+    const ServiceEntry * service = FindService(instanceName, nowMs);
+    return (service != nullptr) && IsLive(service->txtExpiryMs, nowMs);
+}
+
+} // namespace Minimal
+} // namespace mdns
@@ -0,0 +1,129 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <inet/IPAddress.h>
+#include <inet/InetInterface.h>
+
+namespace mdns {
+namespace Minimal {
+
+/// Result of a successful cache lookup: where a service instance can be reached.
+struct CachedServiceAddress
+{
+    chip::Inet::InterfaceId interfaceId;
+    chip::Inet::IPAddress address;
+    uint16_t port;
+};
+
+/// Caches SRV, TXT and address (A/AAAA) records received in mDNS responses,
+/// honoring the TTL each record was received with.
+///
+/// Names are stored as dot-separated strings (e.g. "1234-5678._chip._tcp.local")
+/// and compared case-insensitively, as DNS names are.
+///
+/// A TTL of 0 is a 'goodbye' record (RFC 6762, section 10.1) and removes the
+/// matching cached entry. When the cache is full, expired entries are reused
+/// first and otherwise the entry closest to expiring is evicted.
+///
+/// All methods take the current monotonic time in milliseconds so that the
+/// cache has no dependency on a specific clock.
+class ResolverCacheBase
+{
+public:
+    static constexpr size_t kMaxNameLength = 96;
+
+    struct ServiceEntry
+    {
+        char instanceName[kMaxNameLength + 1];
+        char hostName[kMaxNameLength + 1];
+        uint16_t port;
+        uint64_t srvExpiryMs; // 0 if no SRV record is cached
+        uint64_t txtExpiryMs; // 0 if no TXT record is cached
+    };
+
+    struct AddressEntry
+    {
+        char hostName[kMaxNameLength + 1];
+        chip::Inet::IPAddress address;
+        chip::Inet::InterfaceId interfaceId;
+        uint64_t expiryMs; // 0 if entry is unused
+    };
+
+    ResolverCacheBase(ServiceEntry * services, size_t serviceCount, AddressEntry * addresses, size_t addressCount) :
+        mServices(services), mServiceCount(serviceCount), mAddresses(addresses), mAddressCount(addressCount)
+    {
+        Clear();
+    }
+
+    /// Drops all cached records
+    void Clear();
+
+    /// Caches the SRV record of [instanceName], pointing to [hostName]:[port].
+    void AddSrv(const char * instanceName, const char * hostName, uint16_t port, uint32_t ttlSeconds, uint64_t nowMs);
+
+    /// Caches the presence of a TXT record for [instanceName].
+    void AddTxt(const char * instanceName, uint32_t ttlSeconds, uint64_t nowMs);
+
+    /// Caches one address of [hostName], as received over [interfaceId].
+    ///
+    /// A host may have several addresses; each one is cached and expires separately.
+    void AddAddress(const char * hostName, const chip::Inet::IPAddress & address, chip::Inet::InterfaceId interfaceId,
+                    uint32_t ttlSeconds, uint64_t nowMs);
+
+    /// Finds an unexpired SRV record for [instanceName] and an unexpired address
+    /// of its target host matching [addressType] (kIPAddressType_Any matches all).
+    ///
+    /// returns true and fills [out] if both were found.
+    bool Lookup(const char * instanceName, chip::Inet::IPAddressType addressType, uint64_t nowMs, CachedServiceAddress & out) const;
+
+    /// Finds the host name an unexpired SRV record for [instanceName] points to.
+    ///
+    /// returns nullptr if no such SRV record is cached.
+    const char * LookupHostName(const char * instanceName, uint64_t nowMs) const;
+
+    /// Checks for an unexpired TXT record for [instanceName].
+    bool HasTxt(const char * instanceName, uint64_t nowMs) const;
+
+private:
+    ServiceEntry * FindService(const char * instanceName);
+    const ServiceEntry * FindService(const char * instanceName, uint64_t nowMs) const;
+    ServiceEntry * FindOrAllocateService(const char * instanceName, uint64_t nowMs);
+
+    ServiceEntry * mServices;
+    const size_t mServiceCount;
+    AddressEntry * mAddresses;
+    const size_t mAddressCount;
+};
+
+template <size_t kServiceCount, size_t kAddressCount>
+class ResolverCache : public ResolverCacheBase
+{
+public:
+    ResolverCache() : ResolverCacheBase(mServiceStorage, kServiceCount, mAddressStorage, kAddressCount) {}
+
+private:
+    ServiceEntry mServiceStorage[kServiceCount];
+    AddressEntry mAddressStorage[kAddressCount];
+};
+
+} // namespace Minimal
+} // namespace mdns
@@ -113,6 +113,9 @@ public:
     bool Ok() const { return mBuildOk; }
     bool HasPacketBuffer() const { return !mPacket.IsNull(); }
 
+    /// The packet being built (header included)
+    const chip::System::PacketBufferHandle & GetPacket() const { return mPacket; }
+
 private:
     chip::System::PacketBufferHandle mPacket;
     HeaderRef mHeader;
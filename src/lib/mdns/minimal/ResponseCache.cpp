@@ -0,0 +1,180 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "ResponseCache.h"
+
+#include <string.h>
+
+#include <support/CHIPMem.h>
+
+namespace mdns {
+namespace Minimal {
+namespace {
+
+constexpr uint16_t kMdnsStandardPort = 5353;
+
+} // namespace
+
+ResponseCache::ResponseCache()
+{
+    for (size_t i = 0; i < kMaxEntries; i++)
+    {
+        mEntries[i].data = nullptr;
+    }
+}
+
+void ResponseCache::Free(Entry & entry)
+{
+    if (entry.data != nullptr)
+    {
+        chip::Platform::MemoryFree(entry.data);
+        entry.data = nullptr;
+    }
+}
+
+void ResponseCache::Clear()
+{
+    for (size_t i = 0; i < kMaxEntries; i++)
+    {
+        Free(mEntries[i]);
+    }
+}
+
+bool ResponseCache::BuildKey(const QueryData & query, const chip::Inet::IPPacketInfo * source, Key & key)
+{
+    SerializedQNameIterator name = query.GetName();
+
+    key.nameLength = 0;
+    while (name.Next())
+    {
+        size_t partLength = strlen(name.Value());
+
+        if (key.nameLength + partLength + 1 > sizeof(key.name))
+        {
+            return false;
+        }
+
+        key.name[key.nameLength++] = static_cast<uint8_t>(partLength);
+        memcpy(key.name + key.nameLength, name.Value(), partLength);
+        key.nameLength += partLength;
+    }
+
+    key.type          = query.GetType();
+    key.klass         = query.GetClass();
+    key.unicastAnswer = query.RequestedUnicastAnswer();
+    key.legacy        = (source->SrcPort != kMdnsStandardPort);
+    key.interfaceId   = source->Interface;
+
+    return name.IsValid();
+}
+
+bool ResponseCache::Matches(const Entry & entry, const Key & key)
+{
+    return (entry.nameLength == key.nameLength) && (entry.type == key.type) && (entry.klass == key.klass) &&
+        (entry.unicastAnswer == key.unicastAnswer) && (entry.legacy == key.legacy) && (entry.interfaceId == key.interfaceId) &&
+        (memcmp(entry.data, key.name, key.nameLength) == 0);
+}
+
+bool ResponseCache::Lookup(const QueryData & query, const chip::Inet::IPPacketInfo * source, uint64_t nowMs, BytesRange & response)
+{
+    Key key;
+
+    if (!BuildKey(query, source, key))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < kMaxEntries; i++)
+    {
+        Entry & entry = mEntries[i];
+
+        if (entry.data == nullptr)
+        {
+            continue;
+        }
+
+        if (entry.storedAtMs + kMaxAgeMs <= nowMs)
+        {
+            Free(entry);
+            continue;
+        }
+
+        if (Matches(entry, key))
+        {
+            const uint8_t * start = entry.data + entry.nameLength;
+            response              = BytesRange(start, start + entry.responseLength);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ResponseCache::Store(const QueryData & query, const chip::Inet::IPPacketInfo * source, uint64_t nowMs,
+                          const BytesRange & response)
+{
+    Key key;
+    Entry * slot = nullptr;
+
+    if (!BuildKey(query, source, key) || (response.Size() > UINT16_MAX))
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < kMaxEntries; i++)
+    {
+        if ((mEntries[i].data != nullptr) && Matches(mEntries[i], key))
+        {
+            Free(mEntries[i]); // replaced by the new response
+        }
+    }
+
+    // Use a free entry if available, otherwise replace the oldest response
+    for (size_t i = 0; (i < kMaxEntries) && ((slot == nullptr) || (slot->data != nullptr)); i++)
+    {
+        if ((slot == nullptr) || (mEntries[i].data == nullptr) || (mEntries[i].storedAtMs < slot->storedAtMs))
+        {
+            slot = &mEntries[i];
+        }
+    }
+
+    Free(*slot);
+
+    slot->data = static_cast<uint8_t *>(chip::Platform::MemoryAlloc(key.nameLength + response.Size()));
+    if (slot->data == nullptr)
+    {
+        return;
+    }
+
+    memcpy(slot->data, key.name, key.nameLength);
+    if (response.Size() != 0)
+    {
+        memcpy(slot->data + key.nameLength, response.Start(), response.Size());
+    }
+
+    slot->nameLength     = static_cast<uint16_t>(key.nameLength);
+    slot->responseLength = static_cast<uint16_t>(response.Size());
+    slot->type           = key.type;
+    slot->klass          = key.klass;
+    slot->unicastAnswer  = key.unicastAnswer;
+    slot->legacy         = key.legacy;
+    slot->interfaceId    = key.interfaceId;
+    slot->storedAtMs     = nowMs;
+}
+
+} // namespace Minimal
+} // namespace mdns
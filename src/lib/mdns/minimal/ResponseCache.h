@@ -0,0 +1,104 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <inet/InetLayer.h>
+
+#include <mdns/minimal/Parser.h>
+#include <mdns/minimal/core/BytesRange.h>
+
+namespace mdns {
+namespace Minimal {
+
+/// Remembers serialized responses, so that a repeated query is answered by
+/// copying bytes instead of matching every responder and enumerating
+/// interface addresses again.
+///
+/// Only responses that depend on nothing but the query and the interface it
+/// arrived on may be stored (i.e. unicast replies to queries without known
+/// answers). Responses are keyed on the exact query name, type, class and
+/// unicast bit, the receiving interface and whether the querier is a legacy
+/// one (legacy replies repeat the query).
+///
+/// An empty response is valid and means that nothing answers the query.
+///
+/// Stored responses are copied to heap memory and kept for at most kMaxAgeMs,
+/// as interface addresses may change without notice. Users must call Clear()
+/// whenever the advertised records change.
+class ResponseCache
+{
+public:
+    static constexpr uint64_t kMaxAgeMs = 10 * 1000;
+
+    ResponseCache();
+    ~ResponseCache() { Clear(); }
+
+    /// Frees all stored responses.
+    void Clear();
+
+    /// Finds the stored response for [query] received via [source].
+    ///
+    /// [response] is valid until the next call to Store or Clear.
+    bool Lookup(const QueryData & query, const chip::Inet::IPPacketInfo * source, uint64_t nowMs, BytesRange & response);
+
+    /// Stores a copy of [response] (serialized packet, including the header) for [query] received via [source].
+    ///
+    /// The oldest response is replaced when the cache is full. Responses are silently not
+    /// stored if memory is not available.
+    void Store(const QueryData & query, const chip::Inet::IPPacketInfo * source, uint64_t nowMs, const BytesRange & response);
+
+private:
+    static constexpr size_t kMaxEntries    = 8;
+    static constexpr size_t kMaxNameLength = 255; // https://tools.ietf.org/html/rfc1035#section-2.3.4
+
+    struct Key
+    {
+        uint8_t name[kMaxNameLength]; // uncompressed, case preserved
+        size_t nameLength;
+        QType type;
+        QClass klass;
+        bool unicastAnswer;
+        bool legacy;
+        chip::Inet::InterfaceId interfaceId;
+    };
+
+    struct Entry
+    {
+        uint8_t * data; // name followed by response, nullptr if unused
+        uint16_t nameLength;
+        uint16_t responseLength;
+        QType type;
+        QClass klass;
+        bool unicastAnswer;
+        bool legacy;
+        chip::Inet::InterfaceId interfaceId;
+        uint64_t storedAtMs;
+    };
+
+    static bool BuildKey(const QueryData & query, const chip::Inet::IPPacketInfo * source, Key & key);
+    static bool Matches(const Entry & entry, const Key & key);
+    static void Free(Entry & entry);
+
+    Entry mEntries[kMaxEntries];
+};
+
+} // namespace Minimal
+} // namespace mdns
@@ -19,6 +19,10 @@
 
 #include "QueryReplyFilter.h"
 
+#include <ctype.h>
+#include <string.h>
+
+#include <support/CHIPMem.h>
 #include <support/ReturnMacros.h>
 #include <system/SystemClock.h>
 
@@ -50,7 +54,12 @@ namespace Internal {
 
 bool ResponseSendingState::SendUnicast() const
 {
-    return mQuery->RequestedUnicastAnswer() || (mSource->SrcPort != kMdnsStandardPort);
+    if (mSource->SrcPort != kMdnsStandardPort)
+    {
+        return true; // legacy queriers only receive unicast
+    }
+
+    return !mForceMulticast && mQuery->RequestedUnicastAnswer();
 }
 
 bool ResponseSendingState::IncludeQuery() const
@@ -58,11 +67,207 @@ bool ResponseSendingState::IncludeQuery() const
     return (mSource->SrcPort != kMdnsStandardPort);
 }
 
+RecentQueries::RecentQueries()
+{
+    for (size_t i = 0; i < kMaxEntries; i++)
+    {
+        mEntries[i].name = nullptr;
+    }
+}
+
+void RecentQueries::Free(Entry & entry)
+{
+    if (entry.name != nullptr)
+    {
+        chip::Platform::MemoryFree(entry.name);
+        entry.name = nullptr;
+    }
+}
+
+void RecentQueries::Clear()
+{
+    for (size_t i = 0; i < kMaxEntries; i++)
+    {
+        Free(mEntries[i]);
+    }
+}
+
+bool RecentQueries::BuildKey(const QueryData & query, const chip::Inet::IPPacketInfo * source, Key & key)
+{
+    SerializedQNameIterator name = query.GetName();
+
+    key.nameLength = 0;
+    while (name.Next())
+    {
+        size_t partLength = strlen(name.Value());
+
+        if (key.nameLength + partLength + 1 > sizeof(key.name))
+        {
+            return false;
+        }
+
+        // names are case insensitive: https://tools.ietf.org/html/rfc6762#section-16
+        key.name[key.nameLength++] = static_cast<uint8_t>(partLength);
+        for (size_t i = 0; i < partLength; i++)
+        {
+            key.name[key.nameLength++] = static_cast<uint8_t>(tolower(static_cast<uint8_t>(name.Value()[i])));
+        }
+    }
+
+    key.type        = query.GetType();
+    key.klass       = query.GetClass();
+    key.interfaceId = source->Interface;
+    key.addressType = source->DestAddress.Type();
+
+    return name.IsValid();
+}
+
+bool RecentQueries::Matches(const Entry & entry, const Key & key)
+{
+    return (entry.nameLength == key.nameLength) && (entry.type == key.type) && (entry.klass == key.klass) &&
+        (entry.interfaceId == key.interfaceId) && (entry.addressType == key.addressType) &&
+        (memcmp(entry.name, key.name, key.nameLength) == 0);
+}
+
+RecentQueries::Entry * RecentQueries::Find(const Key & key, uint64_t nowMs)
+{
+    for (size_t i = 0; i < kMaxEntries; i++)
+    {
+        Entry & entry = mEntries[i];
+
+        if (entry.name == nullptr)
+        {
+            continue;
+        }
+
+        if (entry.answeredAtMs + kCoalesceWindowMs <= nowMs)
+        {
+            Free(entry);
+            continue;
+        }
+
+        if (Matches(entry, key))
+        {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+RecentQueries::Action RecentQueries::Lookup(const QueryData & query, const chip::Inet::IPPacketInfo * source, uint64_t nowMs)
+{
+    Key key;
+
+    if (query.IsBootAdvertising() || (source->SrcPort != kMdnsStandardPort) || !BuildKey(query, source, key))
+    {
+        return Action::kRespond;
+    }
+
+    Entry * entry = Find(key, nowMs);
+
+    if (entry == nullptr)
+    {
+        return Action::kRespond;
+    }
+
+    if (!entry->multicast)
+    {
+        return Action::kRespondMulticast;
+    }
+
+    // A QU querier gets its own unicast reply: a multicast would be dropped by the rate limit anyway
+    return query.RequestedUnicastAnswer() ? Action::kRespond : Action::kSuppress;
+}
+
+void RecentQueries::Record(const QueryData & query, const chip::Inet::IPPacketInfo * source, uint64_t nowMs, bool multicast)
+{
+    Key key;
+
+    if (query.IsBootAdvertising() || (source->SrcPort != kMdnsStandardPort) || !BuildKey(query, source, key))
+    {
+        return;
+    }
+
+    Entry * slot = Find(key, nowMs);
+
+    if (slot != nullptr)
+    {
+        // An answer already sent via multicast stays valid for the rest of its window
+        if (multicast && !slot->multicast)
+        {
+            slot->answeredAtMs = nowMs;
+            slot->multicast    = true;
+        }
+        return;
+    }
+
+    // Use a free entry if available, otherwise replace the oldest one
+    for (size_t i = 0; (i < kMaxEntries) && ((slot == nullptr) || (slot->name != nullptr)); i++)
+    {
+        if ((slot == nullptr) || (mEntries[i].name == nullptr) || (mEntries[i].answeredAtMs < slot->answeredAtMs))
+        {
+            slot = &mEntries[i];
+        }
+    }
+
+    Free(*slot);
+
+    slot->name = static_cast<uint8_t *>(chip::Platform::MemoryAlloc(key.nameLength));
+    if (slot->name == nullptr)
+    {
+        return; // not remembering a query only costs a redundant reply
+    }
+
+    memcpy(slot->name, key.name, key.nameLength);
+    slot->nameLength   = static_cast<uint16_t>(key.nameLength);
+    slot->type         = key.type;
+    slot->klass        = key.klass;
+    slot->interfaceId  = key.interfaceId;
+    slot->addressType  = key.addressType;
+    slot->answeredAtMs = nowMs;
+    slot->multicast    = multicast;
+}
+
 } // namespace Internal
 
-CHIP_ERROR ResponseSender::Respond(uint32_t messageId, const QueryData & query, const chip::Inet::IPPacketInfo * querySource)
+CHIP_ERROR ResponseSender::Respond(uint32_t messageId, const QueryData & query, const chip::Inet::IPPacketInfo * querySource,
+                                   const KnownAnswers * knownAnswers)
 {
-    mSendState.Reset(messageId, query, querySource);
+    // Unicast replies only depend on the query and the receiving interface, unless the
+    // querier listed known answers: those are sent as previously serialized
+    const uint64_t kTimeNowMs = chip::System::Platform::Layer::GetClock_MonotonicMS();
+
+    mSendState.Reset(messageId, query, querySource, knownAnswers);
+
+    switch (mRecentQueries.Lookup(query, querySource, kTimeNowMs))
+    {
+    case Internal::RecentQueries::Action::kSuppress:
+        mStats.queriesCoalesced++;
+        return CHIP_NO_ERROR;
+    case Internal::RecentQueries::Action::kRespondMulticast:
+        mSendState.SetForceMulticast(true);
+        break;
+    case Internal::RecentQueries::Action::kRespond:
+        break;
+    }
+
+    if (mSendState.SendUnicast() && !query.IsBootAdvertising() && ((knownAnswers == nullptr) || knownAnswers->IsEmpty()))
+    {
+        BytesRange cachedReply;
+
+        if (mResponseCache.Lookup(query, querySource, kTimeNowMs, cachedReply))
+        {
+            mStats.cachedResponses++;
+            ReturnErrorOnFailure(SendCachedReply(cachedReply));
+            if (cachedReply.Size() != 0)
+            {
+                mRecentQueries.Record(query, querySource, kTimeNowMs, false /* multicast */);
+            }
+            return CHIP_NO_ERROR;
+        }
+        mSendState.SetCacheable(true);
+    }
 
     // Responder has a stateful 'additional replies required' that is used within the response
     // loop. 'no additionals required' is set at the start and additionals are marked as the query
@@ -71,8 +276,6 @@ CHIP_ERROR ResponseSender::Respond(uint32_t messageId, const QueryData & query,
 
     // send all 'Answer' replies
     {
-        const uint64_t kTimeNowMs = chip::System::Platform::Layer::GetClock_MonotonicMS();
-
         QueryReplyFilter queryReplyFilter(query);
         QueryResponderRecordFilter responseFilter;
 
@@ -122,7 +325,44 @@ CHIP_ERROR ResponseSender::Respond(uint32_t messageId, const QueryData & query,
         }
     }
 
-    return FlushReply();
+    if (mSendState.IsCacheable())
+    {
+        BytesRange reply; // empty: nothing answers this query
+
+        if (mResponseBuilder.HasPacketBuffer() && mResponseBuilder.HasResponseRecords())
+        {
+            const chip::System::PacketBufferHandle & packet = mResponseBuilder.GetPacket();
+            reply = BytesRange(packet->Start(), packet->Start() + packet->DataLength());
+        }
+        mResponseCache.Store(query, querySource, kTimeNowMs, reply);
+    }
+
+    ReturnErrorOnFailure(FlushReply());
+
+    // Only a reply that carried answers makes repeats of the query redundant
+    if (mSendState.AnswersSent())
+    {
+        mRecentQueries.Record(query, querySource, kTimeNowMs, !mSendState.SendUnicast());
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ResponseSender::SendCachedReply(const BytesRange & reply)
+{
+    ReturnErrorCodeIf(reply.Size() == 0, CHIP_NO_ERROR); // nothing to answer
+
+    chip::System::PacketBufferHandle buffer = chip::System::PacketBufferHandle::New(kPacketSizeBytes);
+    ReturnErrorCodeIf(buffer.IsNull(), CHIP_ERROR_NO_MEMORY);
+    ReturnErrorCodeIf(buffer->AvailableDataLength() < reply.Size(), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    memcpy(buffer->Start(), reply.Start(), reply.Size());
+    buffer->SetDataLength(static_cast<uint16_t>(reply.Size()));
+    HeaderRef(buffer->Start()).SetMessageId(static_cast<uint16_t>(mSendState.GetMessageId()));
+
+    ChipLogProgress(Discovery, "Directly sending cached mDns reply to peer on port %d", mSendState.GetSourcePort());
+    return mServer->DirectSend(std::move(buffer), mSendState.GetSourceAddress(), mSendState.GetSourcePort(),
+                               mSendState.GetSourceInterfaceId());
 }
 
 CHIP_ERROR ResponseSender::FlushReply()
@@ -144,6 +384,11 @@ CHIP_ERROR ResponseSender::FlushReply()
             ReturnErrorOnFailure(
                 mServer->BroadcastSend(mResponseBuilder.ReleasePacket(), kMdnsStandardPort, mSendState.GetSourceInterfaceId()));
         }
+
+        if (mSendState.PacketHasAnswers())
+        {
+            mSendState.SetAnswersSent();
+        }
     }
 
     return CHIP_NO_ERROR;
@@ -156,6 +401,7 @@ CHIP_ERROR ResponseSender::PrepareNewReplyPacket()
 
     mResponseBuilder.Reset(std::move(buffer));
     mResponseBuilder.Header().SetMessageId(mSendState.GetMessageId());
+    mSendState.SetPacketHasAnswers(false);
 
     if (mSendState.IncludeQuery())
     {
@@ -169,6 +415,12 @@ void ResponseSender::AddResponse(const ResourceRecord & record)
 {
     RETURN_IF_ERROR(mSendState.GetError());
 
+    if ((mSendState.GetKnownAnswers() != nullptr) && mSendState.GetKnownAnswers()->Contains(record))
+    {
+        mStats.knownAnswersSuppressed++;
+        return;
+    }
+
     if (!mResponseBuilder.HasPacketBuffer())
     {
         mSendState.SetError(PrepareNewReplyPacket());
@@ -188,6 +440,9 @@ void ResponseSender::AddResponse(const ResourceRecord & record)
     // failure, hence we can flush and try again. This allows for split replies.
     if (!mResponseBuilder.Ok())
     {
+        // Only single packet replies are cached
+        mSendState.SetCacheable(false);
+
         mResponseBuilder.Header().SetFlags(mResponseBuilder.Header().GetFlags().SetTruncated(true));
 
         RETURN_IF_ERROR(mSendState.SetError(FlushReply()));
@@ -199,8 +454,14 @@ void ResponseSender::AddResponse(const ResourceRecord & record)
             // Very much unexpected: single record addtion should fit (our records should not be that big).
             ChipLogError(Discovery, "Failed to add single record to mDNS response.");
             mSendState.SetError(CHIP_ERROR_INTERNAL);
+            return;
         }
     }
+
+    if (mSendState.GetResourceType() == ResourceType::kAnswer)
+    {
+        mSendState.SetPacketHasAnswers(true);
+    }
 }
 
 } // namespace Minimal
@@ -17,8 +17,10 @@
 
 #pragma once
 
+#include "KnownAnswers.h"
 #include "Parser.h"
 #include "ResponseBuilder.h"
+#include "ResponseCache.h"
 #include "Server.h"
 
 #include <mdns/minimal/responders/QueryResponder.h>
@@ -37,13 +39,19 @@ class ResponseSendingState
 public:
     ResponseSendingState() {}
 
-    void Reset(uint32_t messageId, const QueryData & query, const chip::Inet::IPPacketInfo * packet)
+    void Reset(uint32_t messageId, const QueryData & query, const chip::Inet::IPPacketInfo * packet,
+               const KnownAnswers * knownAnswers)
     {
-        mMessageId    = messageId;
-        mQuery        = &query;
-        mSource       = packet;
-        mSendError    = CHIP_NO_ERROR;
-        mResourceType = ResourceType::kAnswer;
+        mMessageId      = messageId;
+        mQuery          = &query;
+        mSource         = packet;
+        mKnownAnswers   = knownAnswers;
+        mSendError      = CHIP_NO_ERROR;
+        mResourceType   = ResourceType::kAnswer;
+        mForceMulticast = false;
+        mCacheable      = false;
+        mPacketAnswers  = false;
+        mAnswersSent    = false;
     }
 
     void SetResourceType(ResourceType resourceType) { mResourceType = resourceType; }
@@ -63,6 +71,24 @@ public:
     /// Check if the reply should be sent as a unicast reply
     bool SendUnicast() const;
 
+    /// Send the reply via multicast even if the query asked for a unicast reply
+    void SetForceMulticast(bool forceMulticast) { mForceMulticast = forceMulticast; }
+
+    /// Whether the reply being built can be stored in the response cache
+    void SetCacheable(bool cacheable) { mCacheable = cacheable; }
+    bool IsCacheable() const { return mCacheable; }
+
+    /// Whether the packet being built holds answers (rather than only additional records)
+    void SetPacketHasAnswers(bool hasAnswers) { mPacketAnswers = hasAnswers; }
+    bool PacketHasAnswers() const { return mPacketAnswers; }
+
+    /// Whether a packet holding answers was successfully handed to the server
+    void SetAnswersSent() { mAnswersSent = true; }
+    bool AnswersSent() const { return mAnswersSent; }
+
+    /// Answers the querier already has (may be nullptr)
+    const KnownAnswers * GetKnownAnswers() const { return mKnownAnswers; }
+
     /// Check if the original query should be included in the reply
     bool IncludeQuery() const;
 
@@ -75,13 +101,102 @@ public:
 private:
     const QueryData * mQuery                 = nullptr;               // query being replied to
     const chip::Inet::IPPacketInfo * mSource = nullptr;               // Where to send the reply (if unicast)
+    const KnownAnswers * mKnownAnswers       = nullptr;               // answers to leave out of the reply
     uint32_t mMessageId                      = 0;                     // message id for the reply
     ResourceType mResourceType               = ResourceType::kAnswer; // what is being sent right now
+    bool mForceMulticast                     = false;                 // multicast even if unicast was requested
+    bool mCacheable                          = false;                 // reply fits one packet and depends on the query only
+    bool mPacketAnswers                      = false;                 // packet being built holds answers
+    bool mAnswersSent                        = false;                 // a packet holding answers was sent
     CHIP_ERROR mSendError                    = CHIP_NO_ERROR;
 };
 
+/// Remembers recently answered queries, so that identical queries from several
+/// hosts on the same link share a single multicast response.
+///
+/// Only queries from the standard mDNS port are tracked: legacy (one-shot) queriers
+/// do not listen for multicast responses and always get their own unicast reply.
+///
+/// Queries asking for a unicast reply (QU) are never suppressed: the querier may not be
+/// listening for multicast yet (https://tools.ietf.org/html/rfc6762#section-5.4).
+///
+/// Queries are only remembered once a reply carrying answers was actually sent, so
+/// that a query which got no answer (nothing matched, all answers were known to the
+/// querier or the send failed) never silences the same query from another host.
+class RecentQueries
+{
+public:
+    /// How long a response is considered fresh for all hosts on the link.
+    ///
+    /// Matches the at-most-once-per-second multicast rate for a record from
+    /// https://tools.ietf.org/html/rfc6762#section-6
+    static constexpr uint64_t kCoalesceWindowMs = 1000;
+
+    enum class Action
+    {
+        kRespond,          // reply normally
+        kRespondMulticast, // identical query from another host: reply once via multicast
+        kSuppress,         // an identical multicast (QM) query was just answered via multicast
+    };
+
+    RecentQueries();
+    ~RecentQueries() { Clear(); }
+
+    void Clear();
+
+    /// Decides how to reply to [query] received from [source] at [nowMs].
+    Action Lookup(const QueryData & query, const chip::Inet::IPPacketInfo * source, uint64_t nowMs);
+
+    /// Remembers that a reply with answers to [query] from [source] was sent at [nowMs].
+    void Record(const QueryData & query, const chip::Inet::IPPacketInfo * source, uint64_t nowMs, bool multicast);
+
+private:
+    static constexpr size_t kMaxNameLength = 255; // https://tools.ietf.org/html/rfc1035#section-2.3.4
+
+    struct Key
+    {
+        uint8_t name[kMaxNameLength]; // uncompressed, lower case
+        size_t nameLength;
+        QType type;
+        QClass klass;
+        chip::Inet::InterfaceId interfaceId;
+        chip::Inet::IPAddressType addressType;
+    };
+
+    struct Entry
+    {
+        uint8_t * name; // lower case copy of the name, nullptr if unused
+        uint16_t nameLength;
+        QType type;
+        QClass klass;
+        chip::Inet::InterfaceId interfaceId;
+        chip::Inet::IPAddressType addressType;
+        uint64_t answeredAtMs;
+        bool multicast; // true if everyone on the link has seen the answer
+    };
+
+    static constexpr size_t kMaxEntries = 8;
+
+    static bool BuildKey(const QueryData & query, const chip::Inet::IPPacketInfo * source, Key & key);
+    static bool Matches(const Entry & entry, const Key & key);
+    static void Free(Entry & entry);
+
+    /// Finds the unexpired entry for [key], freeing expired entries on the way.
+    Entry * Find(const Key & key, uint64_t nowMs);
+
+    Entry mEntries[kMaxEntries];
+};
+
 } // namespace Internal
 
+/// Counts responses that were not sent because they were redundant.
+struct ResponseSenderStats
+{
+    uint32_t knownAnswersSuppressed = 0; // records the querier listed as already known
+    uint32_t queriesCoalesced       = 0; // queries answered by an earlier multicast response
+    uint32_t cachedResponses        = 0; // replies copied from the response cache
+};
+
 /// Sends responses to mDNS queries.
 ///
 /// Handles processing the query via a QueryResponderBase and then sending back the reply
@@ -92,7 +207,16 @@ public:
     ResponseSender(ServerBase * server, QueryResponderBase * responder) : mServer(server), mResponder(responder) {}
 
     /// Send back the response to a particular query
-    CHIP_ERROR Respond(uint32_t messageId, const QueryData & query, const chip::Inet::IPPacketInfo * querySource);
+    ///
+    /// Records listed in [knownAnswers] (if not null) are not sent back.
+    CHIP_ERROR Respond(uint32_t messageId, const QueryData & query, const chip::Inet::IPPacketInfo * querySource,
+                       const KnownAnswers * knownAnswers = nullptr);
+
+    /// Drops all cached replies. Must be called whenever the responder records change.
+    void ClearResponseCache() { mResponseCache.Clear(); }
+
+    const ResponseSenderStats & GetStats() const { return mStats; }
+    void ResetStats() { mStats = ResponseSenderStats(); }
 
     // Implementation of ResponderDelegate
     void AddResponse(const ResourceRecord & record) override;
@@ -100,6 +224,7 @@ public:
 private:
     CHIP_ERROR FlushReply();
     CHIP_ERROR PrepareNewReplyPacket();
+    CHIP_ERROR SendCachedReply(const BytesRange & reply);
 
     ServerBase * mServer;
     QueryResponderBase * mResponder;
@@ -107,6 +232,9 @@ private:
     /// Current send state
     ResponseBuilder mResponseBuilder;          // packet being built
     Internal::ResponseSendingState mSendState; // sending state
+    Internal::RecentQueries mRecentQueries;    // for coalescing identical queries
+    ResponseCache mResponseCache;              // serialized unicast replies
+    ResponseSenderStats mStats;
 };
 
 } // namespace Minimal
@@ -147,34 +147,97 @@ CHIP_ERROR ServerBase::Listen(chip::Inet::InetLayer * inetLayer, ListenIterator
     {
         ReturnErrorCodeIf(endpointIndex >= mEndpointCount, CHIP_ERROR_NO_MEMORY);
 
-        EndpointInfo * info = &mEndpoints[endpointIndex];
-        info->addressType   = addressType;
-        info->interfaceId   = interfaceId;
+        ReturnErrorOnFailure(OpenEndpoint(&mEndpoints[endpointIndex], inetLayer, interfaceId, addressType, port));
 
-        ReturnErrorOnFailure(inetLayer->NewUDPEndPoint(&info->udp));
+        endpointIndex++;
+    }
 
-        ReturnErrorOnFailure(info->udp->Bind(addressType, chip::Inet::IPAddress::Any, port, interfaceId));
+    return autoShutdown.ReturnSuccess();
+}
 
-        info->udp->AppState          = static_cast<void *>(this);
-        info->udp->OnMessageReceived = OnUdpPacketReceived;
+CHIP_ERROR ServerBase::ListenOn(chip::Inet::InetLayer * inetLayer, chip::Inet::InterfaceId interfaceId,
+                                chip::Inet::IPAddressType addressType, uint16_t port)
+{
+    EndpointInfo * freeInfo = nullptr;
 
-        ReturnErrorOnFailure(info->udp->Listen());
+    for (size_t i = 0; i < mEndpointCount; i++)
+    {
+        if ((mEndpoints[i].udp == nullptr) && (freeInfo == nullptr))
+        {
+            freeInfo = &mEndpoints[i];
+        }
+        else if ((mEndpoints[i].udp != nullptr) && (mEndpoints[i].interfaceId == interfaceId) &&
+                 (mEndpoints[i].addressType == addressType))
+        {
+            return CHIP_NO_ERROR; // already listening
+        }
+    }
 
-        CHIP_ERROR err = JoinMulticastGroup(interfaceId, info->udp, addressType);
-        if (err != CHIP_NO_ERROR)
+    ReturnErrorCodeIf(freeInfo == nullptr, CHIP_ERROR_NO_MEMORY);
+
+    CHIP_ERROR err = OpenEndpoint(freeInfo, inetLayer, interfaceId, addressType, port);
+    if ((err != CHIP_NO_ERROR) && (freeInfo->udp != nullptr))
+    {
+        freeInfo->udp->Free();
+        freeInfo->udp = nullptr;
+    }
+
+    return err;
+}
+
+void ServerBase::StopListeningOn(chip::Inet::InterfaceId interfaceId)
+{
+    for (size_t i = 0; i < mEndpointCount; i++)
+    {
+        if ((mEndpoints[i].udp != nullptr) && (mEndpoints[i].interfaceId == interfaceId))
         {
-            char interfaceName[chip::Inet::InterfaceIterator::kMaxIfNameLength];
-            chip::Inet::GetInterfaceName(interfaceId, interfaceName, sizeof(interfaceName));
+            mEndpoints[i].udp->Free();
+            mEndpoints[i].udp = nullptr;
+        }
+    }
+}
 
-            // Log only as non-fatal error. Failure to join will mean we reply to unicast queries only.
-            ChipLogError(DeviceLayer, "MDNS failed to join multicast group on %s for address type %s: %s", interfaceName,
-                         AddressTypeStr(addressType), chip::ErrorStr(err));
+bool ServerBase::IsListeningOn(chip::Inet::InterfaceId interfaceId, chip::Inet::IPAddressType addressType) const
+{
+    for (size_t i = 0; i < mEndpointCount; i++)
+    {
+        if ((mEndpoints[i].udp != nullptr) && (mEndpoints[i].interfaceId == interfaceId) &&
+            (mEndpoints[i].addressType == addressType))
+        {
+            return true;
         }
+    }
 
-        endpointIndex++;
+    return false;
+}
+
+CHIP_ERROR ServerBase::OpenEndpoint(EndpointInfo * info, chip::Inet::InetLayer * inetLayer, chip::Inet::InterfaceId interfaceId,
+                                    chip::Inet::IPAddressType addressType, uint16_t port)
+{
+    info->addressType = addressType;
+    info->interfaceId = interfaceId;
+
+    ReturnErrorOnFailure(inetLayer->NewUDPEndPoint(&info->udp));
+
+    ReturnErrorOnFailure(info->udp->Bind(addressType, chip::Inet::IPAddress::Any, port, interfaceId));
+
+    info->udp->AppState          = static_cast<void *>(this);
+    info->udp->OnMessageReceived = OnUdpPacketReceived;
+
+    ReturnErrorOnFailure(info->udp->Listen());
+
+    CHIP_ERROR err = JoinMulticastGroup(interfaceId, info->udp, addressType);
+    if (err != CHIP_NO_ERROR)
+    {
+        char interfaceName[chip::Inet::InterfaceIterator::kMaxIfNameLength];
+        chip::Inet::GetInterfaceName(interfaceId, interfaceName, sizeof(interfaceName));
+
+        // Log only as non-fatal error. Failure to join will mean we reply to unicast queries only.
+        ChipLogError(DeviceLayer, "MDNS failed to join multicast group on %s for address type %s: %s", interfaceName,
+                     AddressTypeStr(addressType), chip::ErrorStr(err));
     }
 
-    return autoShutdown.ReturnSuccess();
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR ServerBase::DirectSend(chip::System::PacketBufferHandle && data, const chip::Inet::IPAddress & addr, uint16_t port,
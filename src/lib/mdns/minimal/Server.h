@@ -106,6 +106,17 @@ public:
     /// non-loopback interfaces.
     CHIP_ERROR Listen(chip::Inet::InetLayer * inetLayer, ListenIterator * it, uint16_t port);
 
+    /// Starts listening on one more interface/address type, keeping the existing endpoints.
+    ///
+    /// Used to follow interface changes without closing and re-opening every endpoint.
+    CHIP_ERROR ListenOn(chip::Inet::InetLayer * inetLayer, chip::Inet::InterfaceId interfaceId,
+                        chip::Inet::IPAddressType addressType, uint16_t port);
+
+    /// Closes the endpoints listening on the given interface.
+    void StopListeningOn(chip::Inet::InterfaceId interfaceId);
+
+    bool IsListeningOn(chip::Inet::InterfaceId interfaceId, chip::Inet::IPAddressType addressType) const;
+
     /// Send the specified packet to a destination IP address over the specified address
     CHIP_ERROR DirectSend(chip::System::PacketBufferHandle && data, const chip::Inet::IPAddress & addr, uint16_t port,
                           chip::Inet::InterfaceId interface);
@@ -131,6 +142,9 @@ public:
     const EndpointInfo * GetEndpoints() const { return mEndpoints; }
 
 private:
+    CHIP_ERROR OpenEndpoint(EndpointInfo * info, chip::Inet::InetLayer * inetLayer, chip::Inet::InterfaceId interfaceId,
+                            chip::Inet::IPAddressType addressType, uint16_t port);
+
     static void OnUdpPacketReceived(chip::Inet::IPEndPointBasis * endPoint, chip::System::PacketBufferHandle buffer,
                                     const chip::Inet::IPPacketInfo * info);
 
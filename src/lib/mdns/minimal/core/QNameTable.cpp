@@ -0,0 +1,252 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "QNameTable.h"
+
+#include <string.h>
+#include <strings.h>
+
+namespace mdns {
+namespace Minimal {
+namespace {
+
+constexpr uint8_t kPtrMask      = 0xC0;
+constexpr size_t kMaxLabelSize  = 63;
+constexpr uint32_t kFnvPrime    = 16777619;
+constexpr uint32_t kFnvOffset   = 2166136261;
+constexpr uint8_t kAsciiCaseBit = 0x20;
+
+inline uint8_t ToLower(uint8_t c)
+{
+    return ((c >= 'A') && (c <= 'Z')) ? static_cast<uint8_t>(c | kAsciiCaseBit) : c;
+}
+
+/// FNV-1a over the case folded label
+uint32_t LabelKey(const char * label, size_t length)
+{
+    uint32_t hash = kFnvOffset;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ ToLower(static_cast<uint8_t>(label[i]))) * kFnvPrime;
+    }
+
+    return hash;
+}
+
+} // namespace
+
+void QNameTableBase::Reset(const BytesRange & packet)
+{
+    mPacket     = packet;
+    mLabelCount = 0;
+    mFoundCount = 0;
+}
+
+bool QNameTableBase::LabelEquals(QNameId id, const char * label, size_t labelLength) const
+{
+    const uint8_t * stored = mPacket.Start() + mOffsets[id];
+
+    return (*stored == labelLength) && (strncasecmp(reinterpret_cast<const char *>(stored + 1), label, labelLength) == 0);
+}
+
+bool QNameTableBase::SuffixEquals(QNameId id, const QNamePart * names, size_t nameCount) const
+{
+    for (size_t i = 0; i < nameCount; i++)
+    {
+        if ((id == kRootQNameId) || !LabelEquals(id, names[i], strlen(names[i])))
+        {
+            return false;
+        }
+        id = mSuffixes[id];
+    }
+
+    return id == kRootQNameId;
+}
+
+QNameId QNameTableBase::InternLabel(uint16_t offset, QNameId suffix)
+{
+    const uint8_t * label = mPacket.Start() + offset;
+    const char * value    = reinterpret_cast<const char *>(label + 1);
+    const uint32_t key    = LabelKey(value, *label);
+
+    for (size_t i = 0; i < mLabelCount; i++)
+    {
+        if ((mKeys[i] == key) && (mSuffixes[i] == suffix) && LabelEquals(static_cast<QNameId>(i), value, *label))
+        {
+            return static_cast<QNameId>(i);
+        }
+    }
+
+    if (mLabelCount >= mLabelCapacity)
+    {
+        return kInvalidQNameId;
+    }
+
+    mKeys[mLabelCount]     = key;
+    mSuffixes[mLabelCount] = suffix;
+    mOffsets[mLabelCount]  = offset;
+
+    return static_cast<QNameId>(mLabelCount++);
+}
+
+bool QNameTableBase::Intern(const uint8_t * position, const uint8_t ** nameEnd, QNameId * id)
+{
+    uint16_t labels[kMaxLabels];
+    size_t labelCount        = 0;
+    QNameId suffix           = kRootQNameId;
+    const uint8_t * current  = position;
+    const uint8_t * end      = nullptr;
+    size_t lookBehindMax     = static_cast<size_t>(position - mPacket.Start()); // avoid loops by limiting lookbehind
+    bool followedIndirection = false;
+
+    if (!mPacket.Contains(position))
+    {
+        return false;
+    }
+
+    while (true)
+    {
+        if (!mPacket.Contains(current))
+        {
+            return false;
+        }
+
+        const uint8_t length = *current;
+
+        if (length == 0)
+        {
+            if (!followedIndirection)
+            {
+                end = current + 1;
+            }
+            break;
+        }
+
+        if ((length & kPtrMask) == kPtrMask)
+        {
+            if (!mPacket.Contains(current + 1))
+            {
+                return false;
+            }
+
+            if (!followedIndirection)
+            {
+                end                 = current + 2;
+                followedIndirection = true;
+            }
+
+            const size_t offset = static_cast<size_t>(((length & ~kPtrMask) << 8) | *(current + 1));
+            if (offset >= lookBehindMax)
+            {
+                return false;
+            }
+            lookBehindMax = offset;
+
+            // Data at this offset may already be interned: it then fully determines the suffix
+            size_t i = 0;
+            while ((i < mLabelCount) && (mOffsets[i] != offset))
+            {
+                i++;
+            }
+            if (i < mLabelCount)
+            {
+                suffix = static_cast<QNameId>(i);
+                break;
+            }
+
+            current = mPacket.Start() + offset;
+            continue;
+        }
+
+        if ((length > kMaxLabelSize) || (labelCount >= kMaxLabels) || !mPacket.Contains(current + length))
+        {
+            return false;
+        }
+
+        labels[labelCount++] = static_cast<uint16_t>(current - mPacket.Start());
+        current += length + 1;
+    }
+
+    while ((labelCount > 0) && (suffix != kInvalidQNameId))
+    {
+        suffix = InternLabel(labels[--labelCount], suffix);
+    }
+
+    *nameEnd = end;
+    *id      = suffix;
+
+    return true;
+}
+
+void QNameTableBase::ContinueFind(FoundName & found) const
+{
+    // Labels never change once interned: a name not found so far can only start at a new label
+    const char * label = found.names[0];
+    const size_t len   = strlen(label);
+
+    for (size_t i = found.scannedCount; (i < mLabelCount) && (found.id == kInvalidQNameId); i++)
+    {
+        if ((mKeys[i] == found.key) && LabelEquals(static_cast<QNameId>(i), label, len) &&
+            SuffixEquals(mSuffixes[i], found.names + 1, found.nameCount - 1))
+        {
+            found.id = static_cast<QNameId>(i);
+        }
+    }
+
+    found.scannedCount = mLabelCount;
+}
+
+QNameId QNameTableBase::Find(const FullQName & name)
+{
+    if (name.nameCount == 0)
+    {
+        return kRootQNameId;
+    }
+
+    FoundName * found = nullptr;
+    FoundName uncached;
+
+    for (size_t i = 0; (i < mFoundCount) && (found == nullptr); i++)
+    {
+        if ((mFound[i].names == name.names) && (mFound[i].nameCount == name.nameCount))
+        {
+            found = &mFound[i];
+        }
+    }
+
+    if (found == nullptr)
+    {
+        found = (mFoundCount < mFoundCapacity) ? &mFound[mFoundCount++] : &uncached;
+
+        found->names        = name.names;
+        found->nameCount    = name.nameCount;
+        found->id           = kInvalidQNameId;
+        found->key          = LabelKey(name.names[0], strlen(name.names[0]));
+        found->scannedCount = 0;
+    }
+
+    if ((found->id == kInvalidQNameId) && (found->scannedCount < mLabelCount))
+    {
+        ContinueFind(*found);
+    }
+
+    return found->id;
+}
+
+} // namespace Minimal
+} // namespace mdns
@@ -0,0 +1,133 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <mdns/minimal/core/BytesRange.h>
+#include <mdns/minimal/core/QName.h>
+
+namespace mdns {
+namespace Minimal {
+
+/// Identifies a name interned in a QNameTable.
+///
+/// Within the same table, two names are equal (case insensitive) if and only
+/// if their ids are equal.
+using QNameId = uint16_t;
+
+constexpr QNameId kInvalidQNameId = 0xFFFF; // name could not be interned or is not known
+constexpr QNameId kRootQNameId    = 0xFFFE; // the empty name
+
+/// Interns the names of a single mDNS packet.
+///
+/// Every name is stored as a chain of labels, where each label refers to the
+/// name that follows it. A (label, suffix) pair is stored once, so names that
+/// are equal get the same id regardless of how they were compressed in the
+/// packet. The packet offset where each label was first seen is remembered,
+/// so compression pointers to already interned data are resolved without
+/// walking the labels again.
+///
+/// Label keys and offsets are kept in separate flat arrays so that lookups
+/// are straight scans over small integers.
+///
+/// Tables never allocate: once full, new names get kInvalidQNameId and users
+/// are expected to fall back to comparing serialized names.
+class QNameTableBase
+{
+public:
+    /// Forgets all names and prepares for interning names within [packet].
+    void Reset(const BytesRange & packet);
+
+    /// Interns the serialized name at [position] within the current packet.
+    ///
+    /// [nameEnd] is set to the first byte after the name (not following compression pointers)
+    /// and [id] to the interned name id, which is kInvalidQNameId if the table is full.
+    ///
+    /// returns false if the name is not valid.
+    bool Intern(const uint8_t * position, const uint8_t ** nameEnd, QNameId * id);
+
+    /// Finds the id of [name] without interning it.
+    ///
+    /// Results are remembered by the address of the name parts, so repeated lookups of
+    /// the same name (e.g. a responder name matched against every query of a packet)
+    /// only compare integers. Lookups of names not (yet) found only check labels
+    /// interned since the previous lookup.
+    ///
+    /// returns kInvalidQNameId if the name does not appear in the packet.
+    QNameId Find(const FullQName & name);
+
+    size_t GetLabelCount() const { return mLabelCount; }
+
+protected:
+    struct FoundName
+    {
+        const QNamePart * names;
+        size_t nameCount;
+        QNameId id;
+        uint32_t key;        // key of the first part of the name
+        size_t scannedCount; // labels already checked for being the first part
+    };
+
+    QNameTableBase(uint32_t * keys, QNameId * suffixes, uint16_t * offsets, size_t labelCapacity, FoundName * found,
+                   size_t foundCapacity) :
+        mKeys(keys),
+        mSuffixes(suffixes), mOffsets(offsets), mLabelCapacity(labelCapacity), mFound(found), mFoundCapacity(foundCapacity)
+    {}
+
+private:
+    // Maximum labels of a name: names are at most 255 bytes, each label takes at least 2
+    static constexpr size_t kMaxLabels = 128;
+
+    bool LabelEquals(QNameId id, const char * label, size_t labelLength) const;
+    bool SuffixEquals(QNameId id, const QNamePart * names, size_t nameCount) const;
+    QNameId InternLabel(uint16_t offset, QNameId suffix);
+    void ContinueFind(FoundName & found) const;
+
+    BytesRange mPacket;
+
+    uint32_t * mKeys;     // hash of the label
+    QNameId * mSuffixes;  // name following the label
+    uint16_t * mOffsets;  // packet offset of the label length byte
+    size_t mLabelCapacity;
+    size_t mLabelCount = 0;
+
+    FoundName * mFound;
+    size_t mFoundCapacity;
+    size_t mFoundCount = 0;
+};
+
+/// A QNameTable with storage for [kLabelCount] distinct labels.
+template <size_t kLabelCount, size_t kFoundNameCount = kLabelCount / 2>
+class QNameTable : public QNameTableBase
+{
+public:
+    static_assert(kLabelCount < kRootQNameId, "Label ids must not overlap special ids");
+
+    QNameTable() : QNameTableBase(mKeyStorage, mSuffixStorage, mOffsetStorage, kLabelCount, mFoundStorage, kFoundNameCount) {}
+
+private:
+    uint32_t mKeyStorage[kLabelCount];
+    QNameId mSuffixStorage[kLabelCount];
+    uint16_t mOffsetStorage[kLabelCount];
+    FoundName mFoundStorage[kFoundNameCount];
+};
+
+} // namespace Minimal
+} // namespace mdns
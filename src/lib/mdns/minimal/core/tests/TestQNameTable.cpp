@@ -0,0 +1,190 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <mdns/minimal/core/QNameTable.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+namespace {
+
+using namespace mdns::Minimal;
+
+// Names as they would appear inside a packet:
+//   offset  0: some.test
+//   offset 11: this.is.some.test (compressed)
+//   offset 21: SOME.TEST         (different case, not compressed)
+//   offset 32: other.test        (compressed suffix)
+//   offset 40: is.some.test      (pointer into the middle of a name)
+//   offset 42: loop              (pointer to itself)
+const uint8_t kNames[] = {
+    4,    's', 'o', 'm', 'e',      //
+    4,    't', 'e', 's', 't',      //
+    0,                             //
+    4,    't', 'h', 'i', 's',      //
+    2,    'i', 's',                //
+    0xC0, 0,                       //
+    4,    'S', 'O', 'M', 'E',      //
+    4,    'T', 'E', 'S', 'T',      //
+    0,                             //
+    5,    'o', 't', 'h', 'e', 'r', //
+    0xC0, 5,                       //
+    0xC0, 16,                      //
+    0xC0, 42,                      //
+};
+
+struct InternedName
+{
+    bool valid;
+    QNameId id;
+    size_t size;
+};
+
+InternedName Intern(QNameTableBase & table, size_t offset)
+{
+    InternedName result = { false, kInvalidQNameId, 0 };
+    const uint8_t * end = nullptr;
+
+    result.valid = table.Intern(kNames + offset, &end, &result.id);
+    if (result.valid)
+    {
+        result.size = static_cast<size_t>(end - (kNames + offset));
+    }
+
+    return result;
+}
+
+void TestEqualNamesShareIds(nlTestSuite * inSuite, void * inContext)
+{
+    QNameTable<16> table;
+    table.Reset(BytesRange(kNames, kNames + sizeof(kNames)));
+
+    InternedName some      = Intern(table, 0);
+    InternedName thisIs    = Intern(table, 11);
+    InternedName someUpper = Intern(table, 21);
+    InternedName other     = Intern(table, 32);
+    InternedName is        = Intern(table, 40);
+
+    NL_TEST_ASSERT(inSuite, some.valid && thisIs.valid && someUpper.valid && other.valid && is.valid);
+    NL_TEST_ASSERT(inSuite, some.size == 11);
+    NL_TEST_ASSERT(inSuite, thisIs.size == 10);
+    NL_TEST_ASSERT(inSuite, someUpper.size == 11);
+    NL_TEST_ASSERT(inSuite, other.size == 8);
+    NL_TEST_ASSERT(inSuite, is.size == 2);
+
+    NL_TEST_ASSERT(inSuite, some.id == someUpper.id);
+    NL_TEST_ASSERT(inSuite, some.id != thisIs.id);
+    NL_TEST_ASSERT(inSuite, some.id != other.id);
+    NL_TEST_ASSERT(inSuite, is.id != thisIs.id);
+
+    // interning again gives the same result
+    NL_TEST_ASSERT(inSuite, Intern(table, 11).id == thisIs.id);
+
+    // labels: some, test, this, is, other
+    NL_TEST_ASSERT(inSuite, table.GetLabelCount() == 5);
+}
+
+void TestFindNames(nlTestSuite * inSuite, void * inContext)
+{
+    const QNamePart kThisIs[]  = { "This", "IS", "some", "test" };
+    const QNamePart kSome[]    = { "some", "test" };
+    const QNamePart kTest[]    = { "test" };
+    const QNamePart kMissing[] = { "missing", "test" };
+    const QNamePart kLonger[]  = { "more", "this", "is", "some", "test" };
+
+    QNameTable<16> table;
+    table.Reset(BytesRange(kNames, kNames + sizeof(kNames)));
+
+    const QNameId thisIs = Intern(table, 11).id;
+    const QNameId some   = Intern(table, 0).id;
+
+    NL_TEST_ASSERT(inSuite, table.Find(FullQName(kThisIs)) == thisIs);
+    NL_TEST_ASSERT(inSuite, table.Find(FullQName(kSome)) == some);
+    NL_TEST_ASSERT(inSuite, table.Find(FullQName(kMissing)) == kInvalidQNameId);
+    NL_TEST_ASSERT(inSuite, table.Find(FullQName(kLonger)) == kInvalidQNameId);
+
+    // suffixes are interned as part of longer names
+    NL_TEST_ASSERT(inSuite, table.Find(FullQName(kTest)) != kInvalidQNameId);
+
+    // remembered lookups
+    NL_TEST_ASSERT(inSuite, table.Find(FullQName(kThisIs)) == thisIs);
+    NL_TEST_ASSERT(inSuite, table.Find(FullQName(kMissing)) == kInvalidQNameId);
+
+    // names interned after a failed lookup are found
+    const QNamePart kOther[] = { "other", "test" };
+    NL_TEST_ASSERT(inSuite, table.Find(FullQName(kOther)) == kInvalidQNameId);
+    const QNameId other = Intern(table, 32).id;
+    NL_TEST_ASSERT(inSuite, table.Find(FullQName(kOther)) == other);
+
+    table.Reset(BytesRange(kNames, kNames + sizeof(kNames)));
+    NL_TEST_ASSERT(inSuite, table.GetLabelCount() == 0);
+    NL_TEST_ASSERT(inSuite, table.Find(FullQName(kThisIs)) == kInvalidQNameId);
+}
+
+void TestTableFull(nlTestSuite * inSuite, void * inContext)
+{
+    QNameTable<2> table;
+    table.Reset(BytesRange(kNames, kNames + sizeof(kNames)));
+
+    InternedName some   = Intern(table, 0);
+    InternedName thisIs = Intern(table, 11);
+
+    NL_TEST_ASSERT(inSuite, some.valid && (some.id != kInvalidQNameId));
+
+    // name is valid and its end is known, it just does not fit
+    NL_TEST_ASSERT(inSuite, thisIs.valid);
+    NL_TEST_ASSERT(inSuite, thisIs.id == kInvalidQNameId);
+    NL_TEST_ASSERT(inSuite, thisIs.size == 10);
+}
+
+void TestInvalidNames(nlTestSuite * inSuite, void * inContext)
+{
+    QNameTable<16> table;
+
+    table.Reset(BytesRange(kNames, kNames + sizeof(kNames)));
+    NL_TEST_ASSERT(inSuite, !Intern(table, 42).valid);
+
+    // truncated name
+    table.Reset(BytesRange(kNames, kNames + 7));
+    NL_TEST_ASSERT(inSuite, !Intern(table, 0).valid);
+
+    // forward pointer
+    const uint8_t kForward[] = { 0xC0, 2, 1, 'a', 0 };
+    QNameId id;
+    const uint8_t * end;
+    table.Reset(BytesRange(kForward, kForward + sizeof(kForward)));
+    NL_TEST_ASSERT(inSuite, !table.Intern(kForward, &end, &id));
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestEqualNamesShareIds", TestEqualNamesShareIds), //
+    NL_TEST_DEF("TestFindNames", TestFindNames),                   //
+    NL_TEST_DEF("TestTableFull", TestTableFull),                   //
+    NL_TEST_DEF("TestInvalidNames", TestInvalidNames),             //
+    NL_TEST_SENTINEL()                                             //
+};
+
+} // namespace
+
+int TestQNameTable(void)
+{
+    nlTestSuite theSuite = { "QNameTable", sTests, nullptr, nullptr };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestQNameTable)
@@ -16,13 +16,51 @@
  */
 #include "IP.h"
 
+#include <inet/InetLayer.h>
 #include <mdns/minimal/records/IP.h>
 
 namespace mdns {
 namespace Minimal {
+namespace {
+
+/// Answers from the watcher table if possible. Returns false if the
+/// interface addresses need to be enumerated instead.
+bool AddWatchedResponses(const chip::Inet::InterfaceWatcher * watcher, const FullQName & qname,
+                         const chip::Inet::IPPacketInfo * source, bool ipv4, ResponderDelegate * delegate)
+{
+#if INET_CONFIG_ENABLE_INTERFACE_WATCHER
+    if ((watcher == nullptr) || !watcher->IsActive())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < chip::Inet::InterfaceWatcher::kMaxAddresses; i++)
+    {
+        const chip::Inet::InterfaceWatcher::AddressEntry * entry = watcher->GetAddress(i);
+
+        if ((entry->interfaceId == 0) || (entry->interfaceId != source->Interface) || (entry->address.IsIPv4() != ipv4))
+        {
+            continue;
+        }
+
+        delegate->AddResponse(IPResourceRecord(qname, entry->address));
+    }
+
+    return true;
+#else
+    return false;
+#endif // INET_CONFIG_ENABLE_INTERFACE_WATCHER
+}
+
+} // namespace
 
 void IPv4Responder::AddAllResponses(const chip::Inet::IPPacketInfo * source, ResponderDelegate * delegate)
 {
+    if (AddWatchedResponses(mWatcher, GetQName(), source, true /* ipv4 */, delegate))
+    {
+        return;
+    }
+
     for (chip::Inet::InterfaceAddressIterator it; it.HasCurrent(); it.Next())
     {
         if (it.GetInterfaceId() != source->Interface)
@@ -41,6 +79,11 @@ void IPv4Responder::AddAllResponses(const chip::Inet::IPPacketInfo * source, Res
 
 void IPv6Responder::AddAllResponses(const chip::Inet::IPPacketInfo * source, ResponderDelegate * delegate)
 {
+    if (AddWatchedResponses(mWatcher, GetQName(), source, false /* ipv4 */, delegate))
+    {
+        return;
+    }
+
     for (chip::Inet::InterfaceAddressIterator it; it.HasCurrent(); it.Next())
     {
         if (it.GetInterfaceId() != source->Interface)
@@ -19,23 +19,43 @@
 
 #include <mdns/minimal/responders/Responder.h>
 
+namespace chip {
+namespace Inet {
+class InterfaceWatcher;
+} // namespace Inet
+} // namespace chip
+
 namespace mdns {
 namespace Minimal {
 
+/// A/AAAA responders answer with the addresses of the interface the query arrived on.
+///
+/// When given an active interface watcher, addresses are read from its table
+/// instead of enumerating the system interface addresses for every query.
 class IPv4Responder : public Responder
 {
 public:
-    IPv4Responder(const FullQName & qname) : Responder(QType::A, qname) {}
+    IPv4Responder(const FullQName & qname, const chip::Inet::InterfaceWatcher * watcher = nullptr) :
+        Responder(QType::A, qname), mWatcher(watcher)
+    {}
 
     void AddAllResponses(const chip::Inet::IPPacketInfo * source, ResponderDelegate * delegate) override;
+
+private:
+    const chip::Inet::InterfaceWatcher * mWatcher;
 };
 
 class IPv6Responder : public Responder
 {
 public:
-    IPv6Responder(const FullQName & qname) : Responder(QType::AAAA, qname) {}
+    IPv6Responder(const FullQName & qname, const chip::Inet::InterfaceWatcher * watcher = nullptr) :
+        Responder(QType::AAAA, qname), mWatcher(watcher)
+    {}
 
     void AddAllResponses(const chip::Inet::IPPacketInfo * source, ResponderDelegate * delegate) override;
+
+private:
+    const chip::Inet::InterfaceWatcher * mWatcher;
 };
 
 } // namespace Minimal
@@ -0,0 +1,326 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Benchmark measuring minimal mDNS query parsing and reply matching
+ *      throughput over captured query packets, comparing name matching on
+ *      the serialized packet with matching on names interned while parsing.
+ *
+ */
+
+#include <mdns/minimal/Parser.h>
+#include <mdns/minimal/QueryReplyFilter.h>
+#include <mdns/minimal/core/QNameTable.h>
+#include <support/CodeUtils.h>
+#include <support/ErrorStr.h>
+#include <system/SystemClock.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace chip;
+using namespace mdns::Minimal;
+
+namespace {
+
+constexpr uint32_t kDefaultIterations = 100000;
+constexpr size_t kNameTableLabels     = 64;
+
+// Commissioning browse: subtype and service enumeration, unicast responses requested
+const uint8_t kBrowseCommissionable[] = {
+    0, 0,                                           // message id
+    0, 0,                                           // flags: standard query
+    0, 3,                                           // 3 questions
+    0, 0,                                           // 0 answers
+    0, 0,                                           // 0 authority
+    0, 0,                                           // 0 additional
+    // offset 12: question
+    6, '_', 'c', 'h', 'i', 'p', 'c',                // "_chipc"
+    4, '_', 'u', 'd', 'p',                          // "_udp"
+    5, 'l', 'o', 'c', 'a', 'l',                     // "local"
+    0,                                              //
+    0, 12,                                          // QType PTR
+    0x80, 1,                                        // QClass IN (unicast response)
+    // offset 35: question
+    5, '_', 'L', '8', '4', '0',                     // "_L840"
+    4, '_', 's', 'u', 'b',                          // "_sub"
+    0xC0, 12,                                       // -> _chipc._udp.local
+    0, 12,                                          // QType PTR
+    0x80, 1,                                        // QClass IN (unicast response)
+    // offset 52: question
+    9, '_', 's', 'e', 'r', 'v', 'i', 'c', 'e', 's', // "_services"
+    7, '_', 'd', 'n', 's', '-', 's', 'd',           // "_dns-sd"
+    0xC0, 19,                                       // -> _udp.local
+    0, 12,                                          // QType PTR
+    0x80, 1,                                        // QClass IN (unicast response)
+};
+
+// Operational node resolve: SRV/TXT for the instance and addresses of its host
+const uint8_t kResolveOperational[] = {
+    0, 0,                                                                                // message id
+    0, 0,                                                                                // flags: standard query
+    0, 4,                                                                                // 4 questions
+    0, 0,                                                                                // 0 answers
+    0, 0,                                                                                // 0 authority
+    0, 0,                                                                                // 0 additional
+    // offset 12: question
+    33,                                                                                  // "5AB4A3FA3B0C8D6E-0000000000000123"
+    '5', 'A', 'B', '4', 'A', '3', 'F', 'A', '3', 'B', '0', 'C', '8', 'D', '6', 'E', '-', //
+    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '1', '2', '3',      //
+    5, '_', 'c', 'h', 'i', 'p',                                                          // "_chip"
+    4, '_', 't', 'c', 'p',                                                               // "_tcp"
+    5, 'l', 'o', 'c', 'a', 'l',                                                          // "local"
+    0,                                                                                   //
+    0, 33,                                                                               // QType SRV
+    0, 1,                                                                                // QClass IN
+    // offset 68: question
+    0xC0, 12,                                                                            // -> instance name at offset 12
+    0, 16,                                                                               // QType TXT
+    0, 1,                                                                                // QClass IN
+    // offset 74: question
+    12, 'B', '8', 'E', '8', '5', '6', '2', 'A', '1', 'B', '2', 'C',                      // "B8E8562A1B2C"
+    0xC0, 57,                                                                            // -> local
+    0, 28,                                                                               // QType AAAA
+    0, 1,                                                                                // QClass IN
+    // offset 93: question
+    0xC0, 74,                                                                            // -> B8E8562A1B2C.local
+    0, 1,                                                                                // QType A
+    0, 1,                                                                                // QClass IN
+};
+
+// Operational browse from a controller that already knows three nodes
+const uint8_t kBrowseWithKnownAnswers[] = {
+    0, 0,                                                                                // message id
+    0, 0,                                                                                // flags: standard query
+    0, 1,                                                                                // 1 question
+    0, 3,                                                                                // 3 answers
+    0, 0,                                                                                // 0 authority
+    0, 0,                                                                                // 0 additional
+    // offset 12: question
+    5, '_', 'c', 'h', 'i', 'p',                                                          // "_chip"
+    4, '_', 't', 'c', 'p',                                                               // "_tcp"
+    5, 'l', 'o', 'c', 'a', 'l',                                                          // "local"
+    0,                                                                                   //
+    0, 12,                                                                               // QType PTR
+    0, 1,                                                                                // QClass IN
+    // offset 34: known answer
+    0xC0, 12,                                                                            // -> _chip._tcp.local
+    0, 12,                                                                               // QType PTR
+    0, 1,                                                                                // QClass IN
+    0, 0, 17, 148,                                                                       // TTL 4500
+    0, 36,                                                                               // data length
+    33,                                                                                  // "1111222233334444-0000000000000001"
+    '1', '1', '1', '1', '2', '2', '2', '2', '3', '3', '3', '3', '4', '4', '4', '4', '-', //
+    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '1',      //
+    0xC0, 12,                                                                            // -> _chip._tcp.local
+    // offset 82: known answer
+    0xC0, 12,                                                                            // -> _chip._tcp.local
+    0, 12,                                                                               // QType PTR
+    0, 1,                                                                                // QClass IN
+    0, 0, 17, 148,                                                                       // TTL 4500
+    0, 36,                                                                               // data length
+    33,                                                                                  // "AAAABBBBCCCCDDDD-0000000000000002"
+    'A', 'A', 'A', 'A', 'B', 'B', 'B', 'B', 'C', 'C', 'C', 'C', 'D', 'D', 'D', 'D', '-', //
+    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '2',      //
+    0xC0, 12,                                                                            // -> _chip._tcp.local
+    // offset 130: known answer
+    0xC0, 12,                                                                            // -> _chip._tcp.local
+    0, 12,                                                                               // QType PTR
+    0, 1,                                                                                // QClass IN
+    0, 0, 17, 148,                                                                       // TTL 4500
+    0, 36,                                                                               // data length
+    33,                                                                                  // "9999888877776666-0000000000000003"
+    '9', '9', '9', '9', '8', '8', '8', '8', '7', '7', '7', '7', '6', '6', '6', '6', '-', //
+    '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '3',      //
+    0xC0, 12,                                                                            // -> _chip._tcp.local
+};
+
+struct CapturedPacket
+{
+    const char * label;
+    const uint8_t * data;
+    size_t size;
+    uint32_t expectedMatches;
+};
+
+const CapturedPacket kPackets[] = {
+    { "commissionable browse", kBrowseCommissionable, sizeof(kBrowseCommissionable), 3 },
+    { "operational resolve", kResolveOperational, sizeof(kResolveOperational), 4 },
+    { "browse + known answers", kBrowseWithKnownAnswers, sizeof(kBrowseWithKnownAnswers), 1 },
+};
+
+// Records of a device advertising both operational and commissionable services
+const QNamePart kOperationalService[]     = { "_chip", "_tcp", "local" };
+const QNamePart kOperationalInstance[]    = { "5AB4A3FA3B0C8D6E-0000000000000123", "_chip", "_tcp", "local" };
+const QNamePart kCommissionableService[]  = { "_chipc", "_udp", "local" };
+const QNamePart kCommissionableInstance[] = { "4A8C0B1E3F2D6A7C", "_chipc", "_udp", "local" };
+const QNamePart kLongDiscriminator[]      = { "_L840", "_sub", "_chipc", "_udp", "local" };
+const QNamePart kShortDiscriminator[]     = { "_S3", "_sub", "_chipc", "_udp", "local" };
+const QNamePart kVendor[]                 = { "_V9050", "_sub", "_chipc", "_udp", "local" };
+const QNamePart kServiceListing[]         = { "_services", "_dns-sd", "_udp", "local" };
+const QNamePart kHost[]                   = { "B8E8562A1B2C", "local" };
+
+struct AdvertisedRecord
+{
+    QType type;
+    FullQName name;
+};
+
+const AdvertisedRecord kRecords[] = {
+    { QType::PTR, kServiceListing },      //
+    { QType::PTR, kOperationalService },  //
+    { QType::SRV, kOperationalInstance }, //
+    { QType::TXT, kOperationalInstance }, //
+    { QType::PTR, kCommissionableService },   //
+    { QType::PTR, kLongDiscriminator },       //
+    { QType::PTR, kShortDiscriminator },      //
+    { QType::PTR, kVendor },                  //
+    { QType::SRV, kCommissionableInstance },  //
+    { QType::TXT, kCommissionableInstance },  //
+    { QType::AAAA, kHost },                   //
+    { QType::A, kHost },                      //
+};
+
+/// Matches every query against all advertised records, as the advertiser does when replying.
+class MatchingDelegate : public ParserDelegate
+{
+public:
+    void OnHeader(ConstHeaderRef & header) override {}
+
+    void OnQuery(const QueryData & data) override
+    {
+        QueryReplyFilter filter(data);
+
+        for (const AdvertisedRecord & record : kRecords)
+        {
+            if (filter.Accept(record.type, QClass::IN, record.name))
+            {
+                mMatches++;
+            }
+        }
+    }
+
+    void OnResource(ResourceType type, const ResourceData & data) override {}
+
+    uint32_t GetMatches() const { return mMatches; }
+    void ResetMatches() { mMatches = 0; }
+
+private:
+    uint32_t mMatches = 0;
+};
+
+/// Only walks the packet structure.
+class CountingDelegate : public ParserDelegate
+{
+public:
+    void OnHeader(ConstHeaderRef & header) override {}
+    void OnQuery(const QueryData & data) override {}
+    void OnResource(ResourceType type, const ResourceData & data) override {}
+};
+
+void PrintResult(const char * label, const char * mode, uint32_t packetCount, uint64_t startUs)
+{
+    uint64_t elapsedUs = System::Platform::Layer::GetClock_MonotonicHiRes() - startUs;
+    if (elapsedUs == 0)
+    {
+        elapsedUs = 1;
+    }
+
+    printf("%-24s %-16s %8" PRIu32 " packets in %10" PRIu64 " us: %12.1f packets/sec\n", label, mode, packetCount, elapsedUs,
+           static_cast<double>(packetCount) * System::kTimerFactor_micro_per_unit / static_cast<double>(elapsedUs));
+}
+
+CHIP_ERROR RunParseOnly(const CapturedPacket & packet, uint32_t iterations, QNameTableBase * nameTable)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    CountingDelegate delegate;
+    const BytesRange data(packet.data, packet.data + packet.size);
+    uint64_t start = System::Platform::Layer::GetClock_MonotonicHiRes();
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        VerifyOrExit(ParsePacket(data, &delegate, nameTable), err = CHIP_ERROR_INVALID_ARGUMENT);
+    }
+
+    PrintResult(packet.label, (nameTable != nullptr) ? "parse, interned" : "parse", iterations, start);
+
+exit:
+    return err;
+}
+
+CHIP_ERROR RunParseAndMatch(const CapturedPacket & packet, uint32_t iterations, QNameTableBase * nameTable)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    MatchingDelegate delegate;
+    const BytesRange data(packet.data, packet.data + packet.size);
+    uint64_t start = System::Platform::Layer::GetClock_MonotonicHiRes();
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        delegate.ResetMatches();
+        VerifyOrExit(ParsePacket(data, &delegate, nameTable), err = CHIP_ERROR_INVALID_ARGUMENT);
+    }
+
+    PrintResult(packet.label, (nameTable != nullptr) ? "match, interned" : "match", iterations, start);
+
+    // both ways of matching must agree
+    VerifyOrExit(delegate.GetMatches() == packet.expectedMatches, err = CHIP_ERROR_INTERNAL);
+
+exit:
+    return err;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    CHIP_ERROR err      = CHIP_NO_ERROR;
+    uint32_t iterations = kDefaultIterations;
+    QNameTable<kNameTableLabels> nameTable;
+
+    if (argc > 1)
+    {
+        iterations = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    }
+
+    for (const CapturedPacket & packet : kPackets)
+    {
+        err = RunParseOnly(packet, iterations, nullptr);
+        SuccessOrExit(err);
+
+        err = RunParseOnly(packet, iterations, &nameTable);
+        SuccessOrExit(err);
+
+        err = RunParseAndMatch(packet, iterations, nullptr);
+        SuccessOrExit(err);
+
+        err = RunParseAndMatch(packet, iterations, &nameTable);
+        SuccessOrExit(err);
+    }
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Minimal mDNS parser benchmark failed: %s\n", ErrorStr(err));
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <mdns/minimal/KnownAnswers.h>
+#include <mdns/minimal/records/Ptr.h>
+#include <mdns/minimal/records/Srv.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+namespace {
+
+using namespace chip;
+using namespace mdns::Minimal;
+
+const QNamePart kService[]       = { "_chip", "_tcp", "local" };
+const QNamePart kInstance[]      = { "ABCD-123", "_chip", "_tcp", "local" };
+const QNamePart kInstanceLower[] = { "abcd-123", "_chip", "_tcp", "local" };
+const QNamePart kLowTtl[]        = { "EFGH-456", "_chip", "_tcp", "local" };
+const QNamePart kUnknown[]       = { "XXXX-999", "_chip", "_tcp", "local" };
+const QNamePart kHost[]          = { "host", "local" };
+
+// PTR query for _chip._tcp.local listing two known answers, using name compression
+const uint8_t kQueryWithKnownAnswers[] = {
+    0, 0,                                      // message id
+    0, 0,                                      // flags: standard query
+    0, 1,                                      // 1 question
+    0, 2,                                      // 2 answers
+    0, 0,                                      // 0 authority
+    0, 0,                                      // 0 additional
+    5, '_', 'c', 'h', 'i', 'p',                // offset 12: "_chip"
+    4, '_', 't', 'c', 'p',                     // "_tcp"
+    5, 'l', 'o', 'c', 'a', 'l',                // "local"
+    0,                                         // QNAME ends
+    0, 12,                                     // QType PTR
+    0, 1,                                      // QClass IN
+    0xC0, 12,                                  // answer 1: _chip._tcp.local
+    0, 12,                                     // QType PTR
+    0, 1,                                      // QClass IN
+    0, 0, 0, 120,                              // TTL 120
+    0, 11,                                     // data length
+    8, 'A', 'B', 'C', 'D', '-', '1', '2', '3', // "ABCD-123"
+    0xC0, 12,                                  // ._chip._tcp.local
+    0xC0, 12,                                  // answer 2: _chip._tcp.local
+    0, 12,                                     // QType PTR
+    0, 1,                                      // QClass IN
+    0, 0, 0, 30,                               // TTL 30
+    0, 11,                                     // data length
+    8, 'E', 'F', 'G', 'H', '-', '4', '5', '6', // "EFGH-456"
+    0xC0, 12,                                  // ._chip._tcp.local
+};
+
+BytesRange QueryRange()
+{
+    return BytesRange(kQueryWithKnownAnswers, kQueryWithKnownAnswers + sizeof(kQueryWithKnownAnswers));
+}
+
+void TestKnownPtrRecords(nlTestSuite * inSuite, void * inContext)
+{
+    KnownAnswers knownAnswers;
+
+    NL_TEST_ASSERT(inSuite, knownAnswers.IsEmpty());
+    NL_TEST_ASSERT(inSuite, knownAnswers.Init(QueryRange()));
+    NL_TEST_ASSERT(inSuite, !knownAnswers.IsEmpty());
+
+    // default TTL is 120: known answer with TTL 120 suppresses it
+    NL_TEST_ASSERT(inSuite, knownAnswers.Contains(PtrResourceRecord(kService, kInstance)));
+
+    // names compare case insensitive
+    NL_TEST_ASSERT(inSuite, knownAnswers.Contains(PtrResourceRecord(kService, kInstanceLower)));
+
+    NL_TEST_ASSERT(inSuite, !knownAnswers.Contains(PtrResourceRecord(kService, kUnknown)));
+    NL_TEST_ASSERT(inSuite, !knownAnswers.Contains(PtrResourceRecord(kInstance, kService)));
+}
+
+void TestKnownAnswerTtl(nlTestSuite * inSuite, void * inContext)
+{
+    KnownAnswers knownAnswers;
+    PtrResourceRecord record(kService, kLowTtl);
+
+    NL_TEST_ASSERT(inSuite, knownAnswers.Init(QueryRange()));
+
+    // TTL of 30 is less than half of 120: the querier should be refreshed
+    NL_TEST_ASSERT(inSuite, !knownAnswers.Contains(record));
+
+    record.SetTtl(60);
+    NL_TEST_ASSERT(inSuite, knownAnswers.Contains(record));
+}
+
+void TestOtherRecordTypes(nlTestSuite * inSuite, void * inContext)
+{
+    KnownAnswers knownAnswers;
+
+    NL_TEST_ASSERT(inSuite, knownAnswers.Init(QueryRange()));
+    NL_TEST_ASSERT(inSuite, !knownAnswers.Contains(SrvResourceRecord(kService, kHost, 5540)));
+
+    knownAnswers.Clear();
+    NL_TEST_ASSERT(inSuite, knownAnswers.IsEmpty());
+    NL_TEST_ASSERT(inSuite, !knownAnswers.Contains(PtrResourceRecord(kService, kInstance)));
+}
+
+void TestInvalidPacket(nlTestSuite * inSuite, void * inContext)
+{
+    KnownAnswers knownAnswers;
+
+    // truncated within the question
+    NL_TEST_ASSERT(inSuite, !knownAnswers.Init(BytesRange(kQueryWithKnownAnswers, kQueryWithKnownAnswers + 20)));
+    NL_TEST_ASSERT(inSuite, knownAnswers.IsEmpty());
+
+    // truncated within the answers: nothing is reported as known
+    NL_TEST_ASSERT(inSuite, knownAnswers.Init(BytesRange(kQueryWithKnownAnswers, kQueryWithKnownAnswers + 40)));
+    NL_TEST_ASSERT(inSuite, !knownAnswers.Contains(PtrResourceRecord(kService, kInstance)));
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestKnownPtrRecords", TestKnownPtrRecords),   //
+    NL_TEST_DEF("TestKnownAnswerTtl", TestKnownAnswerTtl),     //
+    NL_TEST_DEF("TestOtherRecordTypes", TestOtherRecordTypes), //
+    NL_TEST_DEF("TestInvalidPacket", TestInvalidPacket),       //
+    NL_TEST_SENTINEL()                                         //
+};
+
+} // namespace
+
+int TestKnownAnswers(void)
+{
+    nlTestSuite theSuite = { "KnownAnswers", sTests, nullptr, nullptr };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestKnownAnswers)
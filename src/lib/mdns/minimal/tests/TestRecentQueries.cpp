@@ -0,0 +1,205 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <mdns/minimal/ResponseSender.h>
+#include <support/CHIPMem.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+namespace {
+
+using namespace chip;
+using namespace mdns::Minimal;
+using mdns::Minimal::Internal::RecentQueries;
+
+constexpr uint16_t kMdnsPort   = 5353;
+constexpr uint16_t kLegacyPort = 12345;
+
+const uint8_t kChipName[] = {
+    5, '_', 'c', 'h', 'i', 'p', //
+    4, '_', 't', 'c', 'p',      //
+    5, 'l', 'o', 'c', 'a', 'l', //
+    0                           //
+};
+
+const uint8_t kChipNameUpper[] = {
+    5, '_', 'C', 'H', 'I', 'P', //
+    4, '_', 'T', 'C', 'P',      //
+    5, 'L', 'O', 'C', 'A', 'L', //
+    0                           //
+};
+
+const uint8_t kOtherName[] = {
+    5, '_', 'c', 'h', 'i', 'p', //
+    4, '_', 'u', 'd', 'p',      //
+    5, 'l', 'o', 'c', 'a', 'l', //
+    0                           //
+};
+
+template <size_t N>
+QueryData BuildQuery(const uint8_t (&name)[N], bool unicast)
+{
+    return QueryData(QType::PTR, QClass::IN, unicast, name, BytesRange(name, name + N));
+}
+
+Inet::IPPacketInfo BuildSource(uint16_t port)
+{
+    Inet::IPPacketInfo info;
+
+    info.Clear();
+    info.SrcPort  = port;
+    info.DestPort = kMdnsPort;
+    Inet::IPAddress::FromString("ff02::fb", info.DestAddress);
+
+    return info;
+}
+
+void TestUnicastQueriesCoalesce(nlTestSuite * inSuite, void * inContext)
+{
+    RecentQueries recent;
+    Inet::IPPacketInfo source = BuildSource(kMdnsPort);
+
+    // first querier gets its unicast answer, the second one makes it a multicast
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, true), &source, 1000) == RecentQueries::Action::kRespond);
+    recent.Record(BuildQuery(kChipName, true), &source, 1000, false);
+    NL_TEST_ASSERT(inSuite,
+                   recent.Lookup(BuildQuery(kChipNameUpper, true), &source, 1100) == RecentQueries::Action::kRespondMulticast);
+    recent.Record(BuildQuery(kChipNameUpper, true), &source, 1100, true);
+
+    // multicast queriers after that already heard the multicast answer
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, false), &source, 1300) == RecentQueries::Action::kSuppress);
+
+    // window expired
+    NL_TEST_ASSERT(inSuite,
+                   recent.Lookup(BuildQuery(kChipName, true), &source, 1100 + RecentQueries::kCoalesceWindowMs) ==
+                       RecentQueries::Action::kRespond);
+}
+
+void TestMulticastQueriesCoalesce(nlTestSuite * inSuite, void * inContext)
+{
+    RecentQueries recent;
+    Inet::IPPacketInfo source = BuildSource(kMdnsPort);
+
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, false), &source, 1000) == RecentQueries::Action::kRespond);
+    recent.Record(BuildQuery(kChipName, false), &source, 1000, true);
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, false), &source, 1500) == RecentQueries::Action::kSuppress);
+
+    // different queries are not affected
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kOtherName, false), &source, 1500) == RecentQueries::Action::kRespond);
+
+    recent.Clear();
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, false), &source, 1600) == RecentQueries::Action::kRespond);
+}
+
+void TestUnicastQueriesNotSuppressed(nlTestSuite * inSuite, void * inContext)
+{
+    RecentQueries recent;
+    Inet::IPPacketInfo source = BuildSource(kMdnsPort);
+
+    recent.Record(BuildQuery(kChipName, false), &source, 1000, true);
+
+    // a QU querier may not have heard the multicast answer: it always gets a reply of its own
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, true), &source, 1100) == RecentQueries::Action::kRespond);
+    recent.Record(BuildQuery(kChipName, true), &source, 1100, false);
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipNameUpper, true), &source, 1200) == RecentQueries::Action::kRespond);
+
+    // the unicast replies do not hide the multicast one from QM queriers
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, false), &source, 1300) == RecentQueries::Action::kSuppress);
+}
+
+void TestUnansweredQueriesNotCoalesced(nlTestSuite * inSuite, void * inContext)
+{
+    RecentQueries recent;
+    Inet::IPPacketInfo source = BuildSource(kMdnsPort);
+
+    // no reply was recorded (e.g. every answer was a known answer): another querier still gets one
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, false), &source, 1000) == RecentQueries::Action::kRespond);
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, false), &source, 1100) == RecentQueries::Action::kRespond);
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, true), &source, 1200) == RecentQueries::Action::kRespond);
+
+    // a later multicast answer restarts the window
+    recent.Record(BuildQuery(kChipName, true), &source, 1200, false);
+    recent.Record(BuildQuery(kChipName, false), &source, 1900, true);
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, false), &source, 2500) == RecentQueries::Action::kSuppress);
+}
+
+void TestNamesCompared(nlTestSuite * inSuite, void * inContext)
+{
+    RecentQueries recent;
+    Inet::IPPacketInfo source = BuildSource(kMdnsPort);
+
+    // names differing in a single label (or with labels split differently) never match
+    const uint8_t kSplitName[] = {
+        4, '_', 'c', 'h', 'i',      //
+        5, 'p', '_', 't', 'c', 'p', //
+        5, 'l', 'o', 'c', 'a', 'l', //
+        0                           //
+    };
+
+    recent.Record(BuildQuery(kChipName, false), &source, 1000, true);
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kOtherName, false), &source, 1100) == RecentQueries::Action::kRespond);
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kSplitName, false), &source, 1100) == RecentQueries::Action::kRespond);
+    NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipNameUpper, false), &source, 1100) == RecentQueries::Action::kSuppress);
+}
+
+void TestLegacyQueriesNotCoalesced(nlTestSuite * inSuite, void * inContext)
+{
+    RecentQueries recent;
+    Inet::IPPacketInfo source = BuildSource(kLegacyPort);
+
+    for (uint64_t now = 1000; now < 1010; now++)
+    {
+        NL_TEST_ASSERT(inSuite, recent.Lookup(BuildQuery(kChipName, false), &source, now) == RecentQueries::Action::kRespond);
+        recent.Record(BuildQuery(kChipName, false), &source, now, false);
+    }
+}
+
+int Setup(void * inContext)
+{
+    CHIP_ERROR error = chip::Platform::MemoryInit();
+    if (error != CHIP_NO_ERROR)
+        return FAILURE;
+    return SUCCESS;
+}
+
+int Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestUnicastQueriesCoalesce", TestUnicastQueriesCoalesce),               //
+    NL_TEST_DEF("TestMulticastQueriesCoalesce", TestMulticastQueriesCoalesce),           //
+    NL_TEST_DEF("TestUnicastQueriesNotSuppressed", TestUnicastQueriesNotSuppressed),     //
+    NL_TEST_DEF("TestUnansweredQueriesNotCoalesced", TestUnansweredQueriesNotCoalesced), //
+    NL_TEST_DEF("TestNamesCompared", TestNamesCompared),                                 //
+    NL_TEST_DEF("TestLegacyQueriesNotCoalesced", TestLegacyQueriesNotCoalesced),         //
+    NL_TEST_SENTINEL()                                                                   //
+};
+
+} // namespace
+
+int TestRecentQueries(void)
+{
+    nlTestSuite theSuite = { "RecentQueries", sTests, Setup, Teardown };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestRecentQueries)
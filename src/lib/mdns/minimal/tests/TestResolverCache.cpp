@@ -0,0 +1,153 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <mdns/minimal/ResolverCache.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+#include <string.h>
+
+namespace {
+
+using namespace chip;
+using namespace mdns::Minimal;
+
+constexpr char kInstance1[] = "1234-5678._chip._tcp.local";
+constexpr char kInstance2[] = "ABCD-5678._chip._tcp.local";
+constexpr char kHost1[]     = "host1.local";
+constexpr char kHost2[]     = "host2.local";
+
+constexpr Inet::InterfaceId kInterface = INET_NULL_INTERFACEID;
+
+Inet::IPAddress MakeAddress(const char * text)
+{
+    Inet::IPAddress address;
+    Inet::IPAddress::FromString(text, address);
+    return address;
+}
+
+void TestLookupNeedsSrvAndAddress(nlTestSuite * inSuite, void * inContext)
+{
+    ResolverCache<4, 4> cache;
+    CachedServiceAddress result;
+
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(kInstance1, Inet::kIPAddressType_Any, 0, result));
+
+    cache.AddSrv(kInstance1, kHost1, 5540, 120, 0);
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(kInstance1, Inet::kIPAddressType_Any, 0, result));
+    NL_TEST_ASSERT(inSuite, strcmp(cache.LookupHostName(kInstance1, 0), kHost1) == 0);
+
+    cache.AddAddress(kHost1, MakeAddress("fe80::1"), kInterface, 120, 0);
+    NL_TEST_ASSERT(inSuite, cache.Lookup(kInstance1, Inet::kIPAddressType_Any, 10, result));
+    NL_TEST_ASSERT(inSuite, result.port == 5540);
+    NL_TEST_ASSERT(inSuite, result.address == MakeAddress("fe80::1"));
+
+    // names are case insensitive
+    NL_TEST_ASSERT(inSuite, cache.Lookup("1234-5678._CHIP._TCP.LOCAL", Inet::kIPAddressType_Any, 10, result));
+
+    // unrelated instance and wrong address type do not match
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(kInstance2, Inet::kIPAddressType_Any, 10, result));
+#if INET_CONFIG_ENABLE_IPV4
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(kInstance1, Inet::kIPAddressType_IPv4, 10, result));
+#endif
+    NL_TEST_ASSERT(inSuite, cache.Lookup(kInstance1, Inet::kIPAddressType_IPv6, 10, result));
+}
+
+void TestRecordsExpire(nlTestSuite * inSuite, void * inContext)
+{
+    ResolverCache<4, 4> cache;
+    CachedServiceAddress result;
+
+    cache.AddSrv(kInstance1, kHost1, 5540, 120, 1000);
+    cache.AddTxt(kInstance1, 4500, 1000);
+    cache.AddAddress(kHost1, MakeAddress("fe80::1"), kInterface, 10, 1000);
+
+    NL_TEST_ASSERT(inSuite, cache.Lookup(kInstance1, Inet::kIPAddressType_Any, 10999, result));
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(kInstance1, Inet::kIPAddressType_Any, 11000, result));
+
+    // SRV is still valid after the address expired
+    NL_TEST_ASSERT(inSuite, cache.LookupHostName(kInstance1, 11000) != nullptr);
+
+    // a fresh address record makes the instance resolvable again
+    cache.AddAddress(kHost1, MakeAddress("fe80::1"), kInterface, 10, 11000);
+    NL_TEST_ASSERT(inSuite, cache.Lookup(kInstance1, Inet::kIPAddressType_Any, 11000, result));
+
+    // SRV expiry stops resolution, TXT is tracked separately
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(kInstance1, Inet::kIPAddressType_Any, 121000, result));
+    NL_TEST_ASSERT(inSuite, cache.LookupHostName(kInstance1, 121000) == nullptr);
+    NL_TEST_ASSERT(inSuite, cache.HasTxt(kInstance1, 121000));
+    NL_TEST_ASSERT(inSuite, !cache.HasTxt(kInstance1, 4501000));
+}
+
+void TestGoodbyeRemovesRecords(nlTestSuite * inSuite, void * inContext)
+{
+    ResolverCache<4, 4> cache;
+    CachedServiceAddress result;
+
+    cache.AddSrv(kInstance1, kHost1, 5540, 120, 0);
+    cache.AddAddress(kHost1, MakeAddress("fe80::1"), kInterface, 120, 0);
+    cache.AddAddress(kHost1, MakeAddress("fe80::2"), kInterface, 120, 0);
+    NL_TEST_ASSERT(inSuite, cache.Lookup(kInstance1, Inet::kIPAddressType_Any, 0, result));
+
+    // other addresses of the host remain usable
+    cache.AddAddress(kHost1, MakeAddress("fe80::1"), kInterface, 0, 0);
+    NL_TEST_ASSERT(inSuite, cache.Lookup(kInstance1, Inet::kIPAddressType_Any, 0, result));
+    NL_TEST_ASSERT(inSuite, result.address == MakeAddress("fe80::2"));
+
+    cache.AddSrv(kInstance1, kHost1, 5540, 0, 0);
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(kInstance1, Inet::kIPAddressType_Any, 0, result));
+}
+
+void TestEvictsEarliestExpiry(nlTestSuite * inSuite, void * inContext)
+{
+    ResolverCache<1, 2> cache;
+    CachedServiceAddress result;
+
+    cache.AddSrv(kInstance1, kHost1, 1111, 120, 0);
+    cache.AddSrv(kInstance2, kHost2, 2222, 120, 0);
+    NL_TEST_ASSERT(inSuite, cache.LookupHostName(kInstance1, 0) == nullptr);
+    NL_TEST_ASSERT(inSuite, cache.LookupHostName(kInstance2, 0) != nullptr);
+
+    cache.AddAddress(kHost2, MakeAddress("fe80::1"), kInterface, 10, 0);
+    cache.AddAddress(kHost2, MakeAddress("fe80::2"), kInterface, 120, 0);
+    cache.AddAddress(kHost2, MakeAddress("fe80::3"), kInterface, 60, 0);
+
+    // fe80::1 was closest to expiring and got replaced
+    NL_TEST_ASSERT(inSuite, cache.Lookup(kInstance2, Inet::kIPAddressType_Any, 0, result));
+    NL_TEST_ASSERT(inSuite, result.address != MakeAddress("fe80::1"));
+    NL_TEST_ASSERT(inSuite, result.port == 2222);
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestLookupNeedsSrvAndAddress", TestLookupNeedsSrvAndAddress), //
+    NL_TEST_DEF("TestRecordsExpire", TestRecordsExpire),                       //
+    NL_TEST_DEF("TestGoodbyeRemovesRecords", TestGoodbyeRemovesRecords),       //
+    NL_TEST_DEF("TestEvictsEarliestExpiry", TestEvictsEarliestExpiry),         //
+    NL_TEST_SENTINEL()                                                         //
+};
+
+} // namespace
+
+int TestResolverCache(void)
+{
+    nlTestSuite theSuite = { "ResolverCache", sTests, nullptr, nullptr };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestResolverCache)
@@ -0,0 +1,189 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <mdns/minimal/ResponseCache.h>
+#include <support/CHIPMem.h>
+#include <support/UnitTestRegistration.h>
+
+#include <string.h>
+
+#include <nlunit-test.h>
+
+namespace {
+
+using namespace chip;
+using namespace mdns::Minimal;
+
+constexpr uint16_t kMdnsPort   = 5353;
+constexpr uint16_t kLegacyPort = 12345;
+
+const uint8_t kChipName[] = {
+    5, '_', 'c', 'h', 'i', 'p', //
+    4, '_', 't', 'c', 'p',      //
+    5, 'l', 'o', 'c', 'a', 'l', //
+    0                           //
+};
+
+const uint8_t kChipNameUpper[] = {
+    5, '_', 'C', 'H', 'I', 'P', //
+    4, '_', 'T', 'C', 'P',      //
+    5, 'L', 'O', 'C', 'A', 'L', //
+    0                           //
+};
+
+const uint8_t kReplyA[] = { 0, 0, 0x84, 0, 0, 0, 0, 1, 0, 0, 0, 0, 'a' };
+const uint8_t kReplyB[] = { 0, 0, 0x84, 0, 0, 0, 0, 1, 0, 0, 0, 0, 'b' };
+
+template <size_t N>
+QueryData BuildQuery(const uint8_t (&name)[N], QType type = QType::PTR)
+{
+    return QueryData(type, QClass::IN, true /* unicast */, name, BytesRange(name, name + N));
+}
+
+template <size_t N>
+BytesRange Range(const uint8_t (&data)[N])
+{
+    return BytesRange(data, data + N);
+}
+
+Inet::IPPacketInfo BuildSource(uint16_t port, Inet::InterfaceId interfaceId = INET_NULL_INTERFACEID)
+{
+    Inet::IPPacketInfo info;
+
+    info.Clear();
+    info.SrcPort   = port;
+    info.DestPort  = kMdnsPort;
+    info.Interface = interfaceId;
+
+    return info;
+}
+
+bool RangeEquals(const BytesRange & range, const BytesRange & expected)
+{
+    return (range.Size() == expected.Size()) && (memcmp(range.Start(), expected.Start(), range.Size()) == 0);
+}
+
+void TestStoreAndLookup(nlTestSuite * inSuite, void * inContext)
+{
+    ResponseCache cache;
+    Inet::IPPacketInfo source = BuildSource(kMdnsPort);
+    BytesRange reply;
+
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(BuildQuery(kChipName), &source, 1000, reply));
+
+    cache.Store(BuildQuery(kChipName), &source, 1000, Range(kReplyA));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(BuildQuery(kChipName), &source, 1500, reply));
+    NL_TEST_ASSERT(inSuite, RangeEquals(reply, Range(kReplyA)));
+
+    // names must match exactly, as legacy replies repeat the query
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(BuildQuery(kChipNameUpper), &source, 1500, reply));
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(BuildQuery(kChipName, QType::SRV), &source, 1500, reply));
+
+    // storing again replaces the response
+    cache.Store(BuildQuery(kChipName), &source, 2000, Range(kReplyB));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(BuildQuery(kChipName), &source, 2000, reply));
+    NL_TEST_ASSERT(inSuite, RangeEquals(reply, Range(kReplyB)));
+
+    cache.Clear();
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(BuildQuery(kChipName), &source, 2000, reply));
+}
+
+void TestQuerySource(nlTestSuite * inSuite, void * inContext)
+{
+    ResponseCache cache;
+    Inet::IPPacketInfo standard = BuildSource(kMdnsPort);
+    Inet::IPPacketInfo legacy   = BuildSource(kLegacyPort);
+    BytesRange reply;
+
+    cache.Store(BuildQuery(kChipName), &standard, 1000, Range(kReplyA));
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(BuildQuery(kChipName), &legacy, 1000, reply));
+
+    cache.Store(BuildQuery(kChipName), &legacy, 1000, Range(kReplyB));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(BuildQuery(kChipName), &legacy, 1000, reply));
+    NL_TEST_ASSERT(inSuite, RangeEquals(reply, Range(kReplyB)));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(BuildQuery(kChipName), &standard, 1000, reply));
+    NL_TEST_ASSERT(inSuite, RangeEquals(reply, Range(kReplyA)));
+}
+
+void TestEmptyAndExpiredReplies(nlTestSuite * inSuite, void * inContext)
+{
+    ResponseCache cache;
+    Inet::IPPacketInfo source = BuildSource(kMdnsPort);
+    BytesRange reply;
+
+    // nothing answers the query
+    cache.Store(BuildQuery(kChipName), &source, 1000, BytesRange());
+    NL_TEST_ASSERT(inSuite, cache.Lookup(BuildQuery(kChipName), &source, 1000, reply));
+    NL_TEST_ASSERT(inSuite, reply.Size() == 0);
+
+    NL_TEST_ASSERT(inSuite, cache.Lookup(BuildQuery(kChipName), &source, 1000 + ResponseCache::kMaxAgeMs - 1, reply));
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(BuildQuery(kChipName), &source, 1000 + ResponseCache::kMaxAgeMs, reply));
+}
+
+void TestCacheFull(nlTestSuite * inSuite, void * inContext)
+{
+    ResponseCache cache;
+    Inet::IPPacketInfo source = BuildSource(kMdnsPort);
+    BytesRange reply;
+
+    const QType kTypes[] = { QType::A,    QType::NS,  QType::CNAME, QType::SOA, QType::NULLVALUE,
+                             QType::WKS,  QType::PTR, QType::HINFO, QType::TXT, QType::AAAA };
+
+    for (size_t i = 0; i < sizeof(kTypes) / sizeof(kTypes[0]); i++)
+    {
+        cache.Store(BuildQuery(kChipName, kTypes[i]), &source, 1000 + i, Range(kReplyA));
+    }
+
+    // oldest responses were replaced
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(BuildQuery(kChipName, QType::A), &source, 2000, reply));
+    NL_TEST_ASSERT(inSuite, !cache.Lookup(BuildQuery(kChipName, QType::NS), &source, 2000, reply));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(BuildQuery(kChipName, QType::CNAME), &source, 2000, reply));
+    NL_TEST_ASSERT(inSuite, cache.Lookup(BuildQuery(kChipName, QType::AAAA), &source, 2000, reply));
+}
+
+int Setup(void * inContext)
+{
+    CHIP_ERROR error = chip::Platform::MemoryInit();
+    if (error != CHIP_NO_ERROR)
+        return FAILURE;
+    return SUCCESS;
+}
+
+int Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestStoreAndLookup", TestStoreAndLookup),                 //
+    NL_TEST_DEF("TestQuerySource", TestQuerySource),                       //
+    NL_TEST_DEF("TestEmptyAndExpiredReplies", TestEmptyAndExpiredReplies), //
+    NL_TEST_DEF("TestCacheFull", TestCacheFull),                           //
+    NL_TEST_SENTINEL()                                                     //
+};
+
+} // namespace
+
+int TestResponseCache(void)
+{
+    nlTestSuite theSuite = { "ResponseCache", sTests, Setup, Teardown };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestResponseCache)
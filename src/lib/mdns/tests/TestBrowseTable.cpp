@@ -0,0 +1,210 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <lib/mdns/BrowseTable.h>
+#include <support/UnitTestRegistration.h>
+
+#include <string.h>
+
+#include <nlunit-test.h>
+
+namespace {
+
+using namespace chip;
+using namespace chip::Mdns;
+
+class RecordingDelegate : public BrowseDelegate
+{
+public:
+    void OnNodeDiscoveryChanged(BrowseEvent event, const DiscoveredNodeData & nodeData) override
+    {
+        mEventCount++;
+        mLastEvent = event;
+        mLastNode  = nodeData;
+    }
+
+    size_t mEventCount = 0;
+    BrowseEvent mLastEvent;
+    DiscoveredNodeData mLastNode;
+};
+
+DiscoveredNodeData MakeNode(const char * instanceName, uint16_t port)
+{
+    DiscoveredNodeData nodeData = {};
+
+    strcpy(nodeData.instanceName, instanceName);
+    nodeData.port        = port;
+    nodeData.interfaceId = INET_NULL_INTERFACEID;
+    nodeData.address     = Inet::IPAddress::Any;
+
+    return nodeData;
+}
+
+void TestAddUpdateRemove(nlTestSuite * inSuite, void * inContext)
+{
+    BrowseTable<4> table;
+    RecordingDelegate delegate;
+
+    table.SetDelegate(&delegate);
+
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("AAAA", 5540), 120, 1000) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, delegate.mEventCount == 1);
+    NL_TEST_ASSERT(inSuite, delegate.mLastEvent == BrowseEvent::kAdded);
+    NL_TEST_ASSERT(inSuite, table.Count() == 1);
+
+    // same data again is only a TTL refresh
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("aaaa", 5540), 120, 2000) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, delegate.mEventCount == 1);
+
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("AAAA", 5541), 120, 3000) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, delegate.mEventCount == 2);
+    NL_TEST_ASSERT(inSuite, delegate.mLastEvent == BrowseEvent::kUpdated);
+    NL_TEST_ASSERT(inSuite, delegate.mLastNode.port == 5541);
+
+    // refresh changes data of known nodes only
+    table.Refresh(MakeNode("BBBB", 1));
+    NL_TEST_ASSERT(inSuite, delegate.mEventCount == 2);
+    NL_TEST_ASSERT(inSuite, table.Find("BBBB") == nullptr);
+
+    // goodbye record
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("AAAA", 5541), 0, 4000) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, delegate.mEventCount == 3);
+    NL_TEST_ASSERT(inSuite, delegate.mLastEvent == BrowseEvent::kRemoved);
+    NL_TEST_ASSERT(inSuite, strcmp(delegate.mLastNode.instanceName, "AAAA") == 0);
+    NL_TEST_ASSERT(inSuite, table.Count() == 0);
+}
+
+void TestExpiryAndRefresh(nlTestSuite * inSuite, void * inContext)
+{
+    BrowseTable<4> table;
+    RecordingDelegate delegate;
+
+    table.SetDelegate(&delegate);
+    NL_TEST_ASSERT(inSuite, table.NextEventMs() == 0);
+
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("AAAA", 5540), 10, 1000) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("BBBB", 5540), 100, 1000) == CHIP_NO_ERROR);
+
+    // refresh at 80% of the TTL, once
+    NL_TEST_ASSERT(inSuite, table.NextEventMs() == 9000);
+    NL_TEST_ASSERT(inSuite, !table.TakeRefreshDue(8999));
+    NL_TEST_ASSERT(inSuite, table.TakeRefreshDue(9000));
+    NL_TEST_ASSERT(inSuite, !table.TakeRefreshDue(9001));
+    NL_TEST_ASSERT(inSuite, table.NextEventMs() == 11000);
+
+    table.Expire(10999);
+    NL_TEST_ASSERT(inSuite, table.Count() == 2);
+
+    table.Expire(11000);
+    NL_TEST_ASSERT(inSuite, table.Count() == 1);
+    NL_TEST_ASSERT(inSuite, delegate.mLastEvent == BrowseEvent::kRemoved);
+    NL_TEST_ASSERT(inSuite, table.Find("AAAA") == nullptr);
+    NL_TEST_ASSERT(inSuite, table.Find("BBBB") != nullptr);
+}
+
+void TestSnapshots(nlTestSuite * inSuite, void * inContext)
+{
+    BrowseTable<4> table;
+    RecordingDelegate delegate;
+
+    table.SetDelegate(&delegate);
+
+    table.BeginSnapshot();
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("AAAA", 1), BrowseTableBase::kNoExpiry, 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("BBBB", 2), BrowseTableBase::kNoExpiry, 0) == CHIP_NO_ERROR);
+    table.EndSnapshot();
+    NL_TEST_ASSERT(inSuite, table.Count() == 2);
+    NL_TEST_ASSERT(inSuite, delegate.mEventCount == 2);
+
+    // nodes without TTL never expire
+    table.Expire(UINT64_MAX - 1);
+    NL_TEST_ASSERT(inSuite, table.Count() == 2);
+    NL_TEST_ASSERT(inSuite, table.NextEventMs() == 0);
+
+    // BBBB went away, AAAA unchanged
+    table.BeginSnapshot();
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("AAAA", 1), BrowseTableBase::kNoExpiry, 0) == CHIP_NO_ERROR);
+    table.EndSnapshot();
+    NL_TEST_ASSERT(inSuite, table.Count() == 1);
+    NL_TEST_ASSERT(inSuite, delegate.mEventCount == 3);
+    NL_TEST_ASSERT(inSuite, delegate.mLastEvent == BrowseEvent::kRemoved);
+    NL_TEST_ASSERT(inSuite, strcmp(delegate.mLastNode.instanceName, "BBBB") == 0);
+}
+
+void TestTableFull(nlTestSuite * inSuite, void * inContext)
+{
+    BrowseTable<2> table;
+
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("AAAA", 1), 120, 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("BBBB", 1), 120, 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("CCCC", 1), 120, 0) == CHIP_ERROR_NO_MEMORY);
+
+    // known nodes can still be updated
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("AAAA", 2), 120, 0) == CHIP_NO_ERROR);
+
+    table.Remove("BBBB");
+    NL_TEST_ASSERT(inSuite, table.Update(MakeNode("CCCC", 1), 120, 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, table.GetEntry(0) != nullptr);
+    NL_TEST_ASSERT(inSuite, table.GetEntry(2) == nullptr);
+}
+
+void TestTxtEntries(nlTestSuite * inSuite, void * inContext)
+{
+    DiscoveredNodeData nodeData = MakeNode("AAAA", 1);
+
+    auto parse = [&nodeData](const char * key, const char * value) {
+        ParseCommissionableTxtEntry(reinterpret_cast<const uint8_t *>(key), strlen(key),
+                                    reinterpret_cast<const uint8_t *>(value), strlen(value), nodeData);
+    };
+
+    parse("D", "0840");
+    NL_TEST_ASSERT(inSuite, nodeData.longDiscriminator == 840);
+
+    parse("VP", "65521+32769");
+    NL_TEST_ASSERT(inSuite, nodeData.vendorId == 65521);
+    NL_TEST_ASSERT(inSuite, nodeData.productId == 32769);
+
+    parse("vp", "123");
+    NL_TEST_ASSERT(inSuite, nodeData.vendorId == 123);
+    NL_TEST_ASSERT(inSuite, nodeData.productId == 32769);
+
+    // invalid values and unknown keys are ignored
+    parse("D", "70000");
+    parse("D", "12a");
+    parse("DD", "1");
+    NL_TEST_ASSERT(inSuite, nodeData.longDiscriminator == 840);
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestAddUpdateRemove", TestAddUpdateRemove),   //
+    NL_TEST_DEF("TestExpiryAndRefresh", TestExpiryAndRefresh), //
+    NL_TEST_DEF("TestSnapshots", TestSnapshots),               //
+    NL_TEST_DEF("TestTableFull", TestTableFull),               //
+    NL_TEST_DEF("TestTxtEntries", TestTxtEntries),             //
+    NL_TEST_SENTINEL()                                         //
+};
+
+} // namespace
+
+int TestBrowseTable(void)
+{
+    nlTestSuite theSuite = { "BrowseTable", sTests, nullptr, nullptr };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestBrowseTable)
@@ -0,0 +1,604 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements heap memory allocation APIs for CHIP with
+ *      segregated size classes. This implementation is used when
+ *      #CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS is enabled (1).
+ *
+ *      Requests up to the largest size class are rounded up to a class and
+ *      served from blocks carved out of chunks obtained with malloc(). Every
+ *      thread keeps a bounded cache of free blocks per class, so the common
+ *      allocate / free pair touches no shared state. A cache that runs empty
+ *      takes a batch of blocks from the shared free list of the class, a cache
+ *      that overflows gives a batch back. The shared free lists are lock-free:
+ *      batches are pushed with a compare-and-swap and the whole list is taken
+ *      with an exchange, so a block freed on another thread than the one that
+ *      allocated it never waits for a lock.
+ *
+ *      Larger requests go to malloc() directly.
+ *
+ *      Chunks are kept until MemoryShutdown(), which releases all of them.
+ *
+ */
+
+#include <core/CHIPConfig.h>
+#include <support/CHIPMem.h>
+
+#include <atomic>
+#include <cstddef>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef NDEBUG
+#include <cstdio>
+#endif
+
+#if CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+
+namespace chip {
+namespace Platform {
+
+namespace {
+
+#ifdef NDEBUG
+
+#define VERIFY_INITIALIZED()
+#define VERIFY_POINTER(p)
+
+#else
+
+#define VERIFY_INITIALIZED() VerifyInitialized(__func__)
+
+void VerifyInitialized(const char * func);
+
+#define VERIFY_POINTER(p)                                                                                                          \
+    do                                                                                                                             \
+        if (((p) != nullptr) && (MemoryInternalCheckPointer((p), 0) == false))                                                     \
+        {                                                                                                                          \
+            fprintf(stderr, "ABORT: chip::Platform::%s() found corruption on %p\n", __func__, (p));                                \
+            abort();                                                                                                               \
+        }                                                                                                                          \
+    while (0)
+
+#endif
+
+// Payload sizes of the classes. Multiples of the header size keep every payload aligned.
+constexpr size_t kClassSizes[] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048 };
+constexpr size_t kNumClasses   = sizeof(kClassSizes) / sizeof(kClassSizes[0]);
+constexpr size_t kMaxClassSize = kClassSizes[kNumClasses - 1];
+constexpr size_t kLargeClass   = kNumClasses;
+
+constexpr size_t kCacheBlocks = CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CACHE_BLOCKS;
+constexpr size_t kBatchBlocks = (kCacheBlocks + 1) / 2;
+constexpr size_t kChunkSize   = CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CHUNK_SIZE;
+
+constexpr uint16_t kMagic = 0xC41A;
+
+static_assert(kCacheBlocks > 0, "The size-class allocator needs a cache of at least one block per class");
+
+/**
+ * Header in front of every block. The requested size is kept for the statistics and for
+ * MemoryRealloc().
+ */
+struct alignas(std::max_align_t) BlockHeader
+{
+    size_t size;
+    uint16_t sizeClass;
+    uint16_t magic;
+};
+
+constexpr size_t kGranularity = sizeof(BlockHeader);
+
+static_assert(kClassSizes[0] % kGranularity == 0, "Size classes must preserve the payload alignment");
+
+/**
+ * A free block. The link to the next block in a cache or batch lives in the payload, the
+ * first block of a batch also links to the next batch of a shared free list.
+ */
+struct FreeBlock
+{
+    FreeBlock * next;
+    FreeBlock * nextBatch;
+};
+
+static_assert(sizeof(FreeBlock) <= kClassSizes[0], "A free block must fit the smallest size class");
+
+struct Chunk
+{
+    Chunk * next;
+};
+
+constexpr size_t kChunkHeaderSize = (sizeof(Chunk) + kGranularity - 1) / kGranularity * kGranularity;
+
+std::atomic<FreeBlock *> sFreeBatches[kNumClasses];
+std::atomic<Chunk *> sChunks{ nullptr };
+
+// Incremented by every MemoryShutdown(): caches of an older generation point into released chunks.
+std::atomic<uint32_t> sGeneration{ 0 };
+
+std::atomic<size_t> sAllocationsInUse{ 0 };
+std::atomic<size_t> sBytesInUse{ 0 };
+std::atomic<size_t> sBytesInUseHighWatermark{ 0 };
+std::atomic<size_t> sBytesReserved{ 0 };
+std::atomic<size_t> sBytesReservedHighWatermark{ 0 };
+std::atomic<size_t> sChunkBytes{ 0 };
+
+#ifndef NDEBUG
+std::atomic_int sMemoryInitialized{ 0 };
+
+void VerifyInitialized(const char * func)
+{
+    if (!sMemoryInitialized)
+    {
+        fprintf(stderr, "ABORT: chip::Platform::%s() called before chip::Platform::MemoryInit()\n", func);
+        abort();
+    }
+}
+#endif
+
+// Maps (size + kGranularity - 1) / kGranularity to the smallest class that fits.
+uint8_t sClassForUnits[kMaxClassSize / kGranularity + 1];
+
+size_t SizeClassFor(size_t size)
+{
+    return (size > kMaxClassSize) ? kLargeClass : sClassForUnits[(size + kGranularity - 1) / kGranularity];
+}
+
+void Raise(std::atomic<size_t> & highWatermark, size_t value)
+{
+    size_t current = highWatermark.load(std::memory_order_relaxed);
+    while (value > current && !highWatermark.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void AddInUse(size_t size)
+{
+    sAllocationsInUse.fetch_add(1, std::memory_order_relaxed);
+    Raise(sBytesInUseHighWatermark, sBytesInUse.fetch_add(size, std::memory_order_relaxed) + size);
+}
+
+void RemoveInUse(size_t size)
+{
+    sAllocationsInUse.fetch_sub(1, std::memory_order_relaxed);
+    sBytesInUse.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void AddReserved(size_t size)
+{
+    Raise(sBytesReservedHighWatermark, sBytesReserved.fetch_add(size, std::memory_order_relaxed) + size);
+}
+
+BlockHeader * HeaderOf(void * p)
+{
+    return reinterpret_cast<BlockHeader *>(static_cast<uint8_t *>(p) - sizeof(BlockHeader));
+}
+
+void * PayloadOf(BlockHeader * header)
+{
+    return reinterpret_cast<uint8_t *>(header) + sizeof(BlockHeader);
+}
+
+/// Pushes the batch starting at [first] and ending at [last] (linked through nextBatch) on a shared free list.
+void PushBatches(size_t sizeClass, FreeBlock * first, FreeBlock * last)
+{
+    FreeBlock * head = sFreeBatches[sizeClass].load(std::memory_order_relaxed);
+    do
+    {
+        last->nextBatch = head;
+    } while (!sFreeBatches[sizeClass].compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/// Takes one batch from a shared free list. The list is taken as a whole, so a block cannot be popped twice.
+FreeBlock * PopBatch(size_t sizeClass)
+{
+    FreeBlock * batch = sFreeBatches[sizeClass].exchange(nullptr, std::memory_order_acquire);
+
+    if ((batch != nullptr) && (batch->nextBatch != nullptr))
+    {
+        FreeBlock * last = batch->nextBatch;
+        while (last->nextBatch != nullptr)
+        {
+            last = last->nextBatch;
+        }
+        PushBatches(sizeClass, batch->nextBatch, last);
+    }
+
+    return batch;
+}
+
+/**
+ * Free blocks kept by one thread.
+ */
+class ThreadCache
+{
+public:
+    ~ThreadCache()
+    {
+        if (mGeneration != sGeneration.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        for (size_t sizeClass = 0; sizeClass < kNumClasses; sizeClass++)
+        {
+            while (mCounts[sizeClass] > 0)
+            {
+                ReleaseBatch(sizeClass);
+            }
+        }
+    }
+
+    void * Alloc(size_t sizeClass)
+    {
+        Revalidate();
+
+        if (mBlocks[sizeClass] == nullptr && !Refill(sizeClass))
+        {
+            return nullptr;
+        }
+
+        FreeBlock * block  = mBlocks[sizeClass];
+        mBlocks[sizeClass] = block->next;
+        mCounts[sizeClass]--;
+
+        return block;
+    }
+
+    void Free(size_t sizeClass, void * p)
+    {
+        Revalidate();
+
+        if (mCounts[sizeClass] == kCacheBlocks)
+        {
+            ReleaseBatch(sizeClass);
+        }
+
+        FreeBlock * block  = static_cast<FreeBlock *>(p);
+        block->next        = mBlocks[sizeClass];
+        mBlocks[sizeClass] = block;
+        mCounts[sizeClass]++;
+    }
+
+private:
+    void Revalidate()
+    {
+        const uint32_t generation = sGeneration.load(std::memory_order_acquire);
+
+        if (mGeneration != generation)
+        {
+            memset(mBlocks, 0, sizeof(mBlocks));
+            memset(mCounts, 0, sizeof(mCounts));
+            mGeneration = generation;
+        }
+    }
+
+    /// Gives up to kBatchBlocks cached blocks back to the shared free list.
+    void ReleaseBatch(size_t sizeClass)
+    {
+        FreeBlock * first = mBlocks[sizeClass];
+        FreeBlock * last  = first;
+        size_t count      = 1;
+
+        for (; count < kBatchBlocks && last->next != nullptr; count++)
+        {
+            last = last->next;
+        }
+
+        mBlocks[sizeClass] = last->next;
+        last->next         = nullptr;
+        first->nextBatch   = nullptr;
+
+        mCounts[sizeClass] -= count;
+
+        PushBatches(sizeClass, first, first);
+    }
+
+    bool Refill(size_t sizeClass)
+    {
+        FreeBlock * batch = PopBatch(sizeClass);
+        if (batch == nullptr)
+        {
+            batch = Carve(sizeClass);
+            if (batch == nullptr)
+            {
+                return false;
+            }
+        }
+
+        mBlocks[sizeClass] = batch;
+        for (FreeBlock * block = batch; block != nullptr; block = block->next)
+        {
+            mCounts[sizeClass]++;
+        }
+
+        return true;
+    }
+
+    /// Carves a new chunk into blocks: one batch for this cache, the rest for the shared free list.
+    FreeBlock * Carve(size_t sizeClass)
+    {
+        const size_t stride    = sizeof(BlockHeader) + kClassSizes[sizeClass];
+        const size_t numBlocks = (kChunkSize > kChunkHeaderSize + stride) ? (kChunkSize - kChunkHeaderSize) / stride : 1;
+        const size_t chunkSize = kChunkHeaderSize + numBlocks * stride;
+
+        Chunk * chunk = static_cast<Chunk *>(malloc(chunkSize));
+        if (chunk == nullptr)
+        {
+            return nullptr;
+        }
+
+        chunk->next = sChunks.load(std::memory_order_relaxed);
+        while (!sChunks.compare_exchange_weak(chunk->next, chunk, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        sChunkBytes.fetch_add(chunkSize, std::memory_order_relaxed);
+        AddReserved(chunkSize);
+
+        uint8_t * cursor   = reinterpret_cast<uint8_t *>(chunk) + kChunkHeaderSize;
+        FreeBlock * mine   = nullptr;
+        FreeBlock * shared = nullptr;
+        FreeBlock * batch  = nullptr;
+        size_t inBatch     = 0;
+
+        for (size_t i = 0; i < numBlocks; i++, cursor += stride)
+        {
+            BlockHeader * header = reinterpret_cast<BlockHeader *>(cursor);
+            header->size         = 0;
+            header->sizeClass    = static_cast<uint16_t>(sizeClass);
+            header->magic        = kMagic;
+
+            FreeBlock * block = static_cast<FreeBlock *>(PayloadOf(header));
+            block->next       = batch;
+            block->nextBatch  = nullptr;
+            batch             = block;
+
+            if (++inBatch == kBatchBlocks || i + 1 == numBlocks)
+            {
+                if (mine == nullptr)
+                {
+                    mine = batch;
+                }
+                else
+                {
+                    batch->nextBatch = shared;
+                    shared           = batch;
+                }
+                batch   = nullptr;
+                inBatch = 0;
+            }
+        }
+
+        if (shared != nullptr)
+        {
+            FreeBlock * last = shared;
+            while (last->nextBatch != nullptr)
+            {
+                last = last->nextBatch;
+            }
+            PushBatches(sizeClass, shared, last);
+        }
+
+        return mine;
+    }
+
+    FreeBlock * mBlocks[kNumClasses] = {};
+    size_t mCounts[kNumClasses]      = {};
+    uint32_t mGeneration             = 0;
+};
+
+thread_local ThreadCache tCache;
+
+} // namespace
+
+CHIP_ERROR MemoryAllocatorInit(void * buf, size_t bufSize)
+{
+#ifndef NDEBUG
+    if (sMemoryInitialized++ > 0)
+    {
+        fprintf(stderr, "ABORT: chip::Platform::MemoryInit() called twice.\n");
+        abort();
+    }
+#endif
+
+    size_t sizeClass = 0;
+    for (size_t units = 0; units < sizeof(sClassForUnits); units++)
+    {
+        while (units * kGranularity > kClassSizes[sizeClass])
+        {
+            sizeClass++;
+        }
+        sClassForUnits[units] = static_cast<uint8_t>(sizeClass);
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void MemoryAllocatorShutdown()
+{
+#ifndef NDEBUG
+    if (--sMemoryInitialized < 0)
+    {
+        fprintf(stderr, "ABORT: chip::Platform::MemoryShutdown() called twice.\n");
+        abort();
+    }
+#endif
+
+    sGeneration.fetch_add(1, std::memory_order_acq_rel);
+
+    for (std::atomic<FreeBlock *> & batches : sFreeBatches)
+    {
+        batches.store(nullptr, std::memory_order_relaxed);
+    }
+
+    Chunk * chunk = sChunks.exchange(nullptr, std::memory_order_acquire);
+    while (chunk != nullptr)
+    {
+        Chunk * next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    // Large blocks still in use stay reserved.
+    sBytesReserved.fetch_sub(sChunkBytes.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void * MemoryAlloc(size_t size)
+{
+    VERIFY_INITIALIZED();
+    return MemoryAlloc(size, false);
+}
+
+void * MemoryAlloc(size_t size, bool isLongTermAlloc)
+{
+    VERIFY_INITIALIZED();
+
+    const size_t sizeClass = SizeClassFor(size);
+    BlockHeader * header   = nullptr;
+
+    if (sizeClass == kLargeClass)
+    {
+        if (size > SIZE_MAX - sizeof(BlockHeader))
+        {
+            return nullptr;
+        }
+
+        header = static_cast<BlockHeader *>(malloc(sizeof(BlockHeader) + size));
+        if (header == nullptr)
+        {
+            return nullptr;
+        }
+        header->sizeClass = static_cast<uint16_t>(kLargeClass);
+        header->magic     = kMagic;
+        AddReserved(sizeof(BlockHeader) + size);
+    }
+    else
+    {
+        void * p = tCache.Alloc(sizeClass);
+        if (p == nullptr)
+        {
+            return nullptr;
+        }
+        header = HeaderOf(p);
+    }
+
+    header->size = size;
+    AddInUse(size);
+
+    return PayloadOf(header);
+}
+
+void * MemoryCalloc(size_t num, size_t size)
+{
+    VERIFY_INITIALIZED();
+
+    if ((size != 0) && (num > SIZE_MAX / size))
+    {
+        return nullptr;
+    }
+
+    void * p = MemoryAlloc(num * size);
+    if (p != nullptr)
+    {
+        memset(p, 0, num * size);
+    }
+
+    return p;
+}
+
+void * MemoryRealloc(void * p, size_t size)
+{
+    VERIFY_INITIALIZED();
+    VERIFY_POINTER(p);
+
+    if (p == nullptr)
+    {
+        return MemoryAlloc(size);
+    }
+
+    BlockHeader * header = HeaderOf(p);
+
+    // Stay in place while the block still fits its class.
+    if ((header->sizeClass != kLargeClass) && (SizeClassFor(size) == header->sizeClass))
+    {
+        RemoveInUse(header->size);
+        AddInUse(size);
+        header->size = size;
+        return p;
+    }
+
+    void * moved = MemoryAlloc(size);
+    if (moved != nullptr)
+    {
+        memcpy(moved, p, (header->size < size) ? header->size : size);
+        MemoryFree(p);
+    }
+
+    return moved;
+}
+
+void MemoryFree(void * p)
+{
+    VERIFY_INITIALIZED();
+    VERIFY_POINTER(p);
+
+    if (p == nullptr)
+    {
+        return;
+    }
+
+    BlockHeader * header = HeaderOf(p);
+    RemoveInUse(header->size);
+
+    if (header->sizeClass == kLargeClass)
+    {
+        sBytesReserved.fetch_sub(sizeof(BlockHeader) + header->size, std::memory_order_relaxed);
+        free(header);
+    }
+    else
+    {
+        tCache.Free(header->sizeClass, p);
+    }
+}
+
+bool MemoryInternalCheckPointer(const void * p, size_t min_size)
+{
+    if (p == nullptr)
+    {
+        return false;
+    }
+
+    const BlockHeader * header = reinterpret_cast<const BlockHeader *>(static_cast<const uint8_t *>(p) - sizeof(BlockHeader));
+    return (header->magic == kMagic) && (header->sizeClass <= kLargeClass) && (header->size >= min_size);
+}
+
+void MemoryGetStats(MemoryStats & stats)
+{
+    stats.allocationsInUse           = sAllocationsInUse.load(std::memory_order_relaxed);
+    stats.bytesInUse                 = sBytesInUse.load(std::memory_order_relaxed);
+    stats.bytesInUseHighWatermark    = sBytesInUseHighWatermark.load(std::memory_order_relaxed);
+    stats.bytesReserved              = sBytesReserved.load(std::memory_order_relaxed);
+    stats.bytesReservedHighWatermark = sBytesReservedHighWatermark.load(std::memory_order_relaxed);
+}
+
+} // namespace Platform
+} // namespace chip
+
+#endif // CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <core/CHIPError.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include <new>
@@ -153,6 +154,39 @@ extern void * MemoryRealloc(void * p, size_t size);
  */
 extern void MemoryFree(void * p);
 
+#if CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+
+/**
+ * Heap usage reported by the size-class allocator.
+ */
+struct MemoryStats
+{
+    size_t allocationsInUse;           ///< Blocks handed out and not yet freed.
+    size_t bytesInUse;                 ///< Bytes requested by the blocks in use.
+    size_t bytesInUseHighWatermark;    ///< Largest value of bytesInUse.
+    size_t bytesReserved;              ///< Bytes obtained from the system: size-class chunks and large blocks.
+    size_t bytesReservedHighWatermark; ///< Largest value of bytesReserved.
+
+    /// Share of the reserved memory that does not hold requested bytes: rounding up to a size
+    /// class, block headers and free blocks kept in caches and free lists.
+    uint8_t FragmentationPercent() const
+    {
+        return (bytesReserved == 0 || bytesInUse >= bytesReserved)
+            ? 0
+            : static_cast<uint8_t>((bytesReserved - bytesInUse) * 100 / bytesReserved);
+    }
+};
+
+/**
+ * This function reports the current heap usage of the allocator.
+ *
+ * @param[out] stats            Filled with the current usage and high-water marks.
+ *
+ */
+extern void MemoryGetStats(MemoryStats & stats);
+
+#endif // CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+
 /**
  * This function wraps the operator `new` with placement-new using MemoryAlloc().
  * Instead of
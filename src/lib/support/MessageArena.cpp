@@ -0,0 +1,173 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the per-message bump allocator.
+ *
+ */
+
+#include "MessageArena.h"
+
+#include <string.h>
+
+namespace chip {
+namespace Platform {
+namespace {
+
+constexpr size_t kAlignment = alignof(std::max_align_t);
+
+constexpr size_t AlignUp(size_t value)
+{
+    return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+} // namespace
+
+thread_local MessageArena * MessageArena::sCurrent = nullptr;
+MessageArena * MessageArena::sArenas               = nullptr;
+
+MessageArena::MessageArena(uint8_t * buffer, size_t size) : mBuffer(buffer), mSize(size), mNext(sArenas)
+{
+    sArenas = this;
+}
+
+MessageArena::~MessageArena()
+{
+    for (MessageArena ** arena = &sArenas; *arena != nullptr; arena = &(*arena)->mNext)
+    {
+        if (*arena == this)
+        {
+            *arena = mNext;
+            break;
+        }
+    }
+
+    if (sCurrent == this)
+    {
+        sCurrent = nullptr;
+    }
+}
+
+void * MessageArena::Alloc(size_t size)
+{
+    // mUsed is kept aligned, so every allocation starts aligned
+    if ((size == 0) || (size > mSize - mUsed))
+    {
+        return nullptr;
+    }
+
+    mLastOffset = mUsed;
+    mUsed       = mUsed + AlignUp(size);
+    if (mUsed > mSize)
+    {
+        mUsed = mSize;
+    }
+
+    mStats.allocations++;
+    if (mUsed > mStats.highWatermark)
+    {
+        mStats.highWatermark = mUsed;
+    }
+
+    return mBuffer + mLastOffset;
+}
+
+void MessageArena::Free(void * ptr)
+{
+    if ((ptr == mBuffer + mLastOffset) && (mUsed > mLastOffset))
+    {
+        mUsed = mLastOffset;
+    }
+}
+
+void MessageArena::Reset()
+{
+    mUsed       = 0;
+    mLastOffset = 0;
+}
+
+MessageArena * MessageArena::FindOwner(const void * ptr)
+{
+    for (MessageArena * arena = sArenas; arena != nullptr; arena = arena->mNext)
+    {
+        if (arena->Owns(ptr))
+        {
+            return arena;
+        }
+    }
+
+    return nullptr;
+}
+
+void * MessageArenaAlloc(size_t size)
+{
+    MessageArena * arena = MessageArena::sCurrent;
+
+    if (arena != nullptr)
+    {
+        void * ptr = arena->Alloc(size);
+        if (ptr != nullptr)
+        {
+            return ptr;
+        }
+        arena->mStats.fallbacks++;
+    }
+
+    return MemoryAlloc(size);
+}
+
+void MessageArenaFree(void * ptr)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    MessageArena * arena = MessageArena::FindOwner(ptr);
+    if (arena == nullptr)
+    {
+        MemoryFree(ptr);
+    }
+    else if (arena == MessageArena::GetCurrent())
+    {
+        arena->Free(ptr);
+    }
+}
+
+namespace Impl {
+
+void * MessageArenaMemoryManagement::MemoryCalloc(size_t num, size_t size)
+{
+    if ((size != 0) && (num > SIZE_MAX / size))
+    {
+        return nullptr;
+    }
+
+    void * ptr = MessageArenaAlloc(num * size);
+    if (ptr != nullptr)
+    {
+        memset(ptr, 0, num * size);
+    }
+
+    return ptr;
+}
+
+} // namespace Impl
+
+} // namespace Platform
+} // namespace chip
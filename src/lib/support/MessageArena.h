@@ -0,0 +1,192 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Defines a bump allocator for memory that only lives while one
+ *      inbound message is being handled.
+ *
+ */
+
+#pragma once
+
+#include <support/ScopedBuffer.h>
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace chip {
+namespace Platform {
+
+/**
+ * Bump allocator over a fixed buffer.
+ *
+ * Allocations only move a cursor forward; individual frees are no-ops except for
+ * the most recent allocation, which is given back. All memory is reclaimed at once
+ * by Reset(), which ScopedMessageArena calls when the handling of a message ends.
+ *
+ * Use MessageArenaAlloc / MessageArenaFree (or ScopedArenaBuffer) rather than
+ * calling Alloc directly: they fall back to chip::Platform::MemoryAlloc when no
+ * arena is active or the arena is exhausted.
+ *
+ * The current arena is per thread: code running on other threads than the one
+ * handling the message (e.g. TLVWriter users) gets heap memory.
+ *
+ * Arenas must be created and destroyed on the CHIP thread only (usually once, at
+ * startup and shutdown). The list of arenas that FindOwner walks is not locked:
+ * other threads may free memory while no arena is being created or destroyed.
+ */
+class MessageArena
+{
+public:
+    struct Stats
+    {
+        uint32_t allocations; ///< Allocations served by the arena.
+        uint32_t fallbacks;   ///< Allocations that did not fit and went to the heap.
+        size_t highWatermark; ///< Largest number of bytes in use at once.
+    };
+
+    MessageArena(uint8_t * buffer, size_t size);
+    ~MessageArena();
+
+    MessageArena(const MessageArena &) = delete;
+    MessageArena & operator=(const MessageArena &) = delete;
+
+    /// Returns nullptr if [size] bytes do not fit in the remaining space.
+    void * Alloc(size_t size);
+
+    /// Gives the memory back if [ptr] is the most recent allocation, otherwise does nothing.
+    void Free(void * ptr);
+
+    bool Owns(const void * ptr) const { return (ptr >= mBuffer) && (ptr < mBuffer + mSize); }
+
+    /// Reclaims every allocation.
+    void Reset();
+
+    size_t GetUsed() const { return mUsed; }
+    size_t GetSize() const { return mSize; }
+    const Stats & GetStats() const { return mStats; }
+
+    /// The arena of the message being handled by the calling thread, nullptr outside message handling.
+    static MessageArena * GetCurrent() { return sCurrent; }
+
+    /// Finds the arena that [ptr] was allocated from, active or not. Safe from any thread, see above.
+    static MessageArena * FindOwner(const void * ptr);
+
+private:
+    friend class ScopedMessageArena;
+    friend void * MessageArenaAlloc(size_t size);
+
+    uint8_t * const mBuffer;
+    const size_t mSize;
+    size_t mUsed       = 0;
+    size_t mLastOffset = 0; // start of the most recent allocation
+    Stats mStats       = {};
+    MessageArena * mNext;
+
+    static thread_local MessageArena * sCurrent;
+    static MessageArena * sArenas;
+};
+
+/**
+ * A MessageArena with inline storage.
+ */
+template <size_t kSize>
+class MessageArenaStorage : public MessageArena
+{
+public:
+    MessageArenaStorage() : MessageArena(mStorage, kSize) {}
+
+private:
+    alignas(std::max_align_t) uint8_t mStorage[kSize];
+};
+
+/**
+ * Makes [arena] the current arena for the lifetime of the object, then resets it.
+ *
+ * Nested scopes keep the outer arena: memory handed out while handling an outer
+ * message must outlive any message handled from within it.
+ */
+class ScopedMessageArena
+{
+public:
+    explicit ScopedMessageArena(MessageArena & arena) : mArena(nullptr)
+    {
+        if (MessageArena::sCurrent == nullptr)
+        {
+            mArena                 = &arena;
+            MessageArena::sCurrent = &arena;
+        }
+    }
+
+    ~ScopedMessageArena()
+    {
+        if (mArena != nullptr)
+        {
+            MessageArena::sCurrent = nullptr;
+            mArena->Reset();
+        }
+    }
+
+    ScopedMessageArena(const ScopedMessageArena &) = delete;
+    ScopedMessageArena & operator=(const ScopedMessageArena &) = delete;
+
+private:
+    MessageArena * mArena;
+};
+
+/**
+ * Allocates transient memory from the current message arena, or from
+ * chip::Platform::MemoryAlloc if there is none or it is full.
+ *
+ * The memory must be released with MessageArenaFree, and must not be used after
+ * the handling of the current message ends.
+ */
+void * MessageArenaAlloc(size_t size);
+
+/**
+ * Releases memory from MessageArenaAlloc.
+ */
+void MessageArenaFree(void * ptr);
+
+namespace Impl {
+
+/**
+ * Forwards ScopedMemoryBuffer memory management to the current message arena.
+ */
+class MessageArenaMemoryManagement
+{
+public:
+    static void MemoryFree(void * p) { MessageArenaFree(p); }
+    static void * MemoryAlloc(size_t size) { return MessageArenaAlloc(size); }
+    static void * MemoryAlloc(size_t size, bool longTerm)
+    {
+        return longTerm ? chip::Platform::MemoryAlloc(size, longTerm) : MessageArenaAlloc(size);
+    }
+    static void * MemoryCalloc(size_t num, size_t size);
+};
+
+} // namespace Impl
+
+/**
+ * Scoped buffer for transient data of the message being handled.
+ */
+template <typename T>
+using ScopedArenaBuffer = ScopedMemoryBuffer<T, Impl::MessageArenaMemoryManagement>;
+
+} // namespace Platform
+} // namespace chip
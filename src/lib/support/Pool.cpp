@@ -26,7 +26,7 @@ namespace chip {
 StaticAllocatorBitmap::StaticAllocatorBitmap(void * storage, std::atomic<tBitChunkType> * usage, size_t capacity,
                                              size_t elementSize) :
     StaticAllocatorBase(capacity),
-    mElements(storage), mElementSize(elementSize), mUsage(usage)
+    mElements(storage), mElementSize(elementSize), mUsage(usage), mHint(0)
 {
     for (size_t word = 0; word * kBitChunkSize < Capacity(); ++word)
     {
@@ -36,24 +36,27 @@ StaticAllocatorBitmap::StaticAllocatorBitmap(void * storage, std::atomic<tBitChu
 
 void * StaticAllocatorBitmap::Allocate()
 {
-    for (size_t word = 0; word * kBitChunkSize < Capacity(); ++word)
+    const size_t words = WordCount();
+    const size_t start = mHint.load(std::memory_order_relaxed);
+
+    // start at the hinted word and wrap around, skipping full words with a single load
+    for (size_t i = 0; i < words; ++i)
     {
-        auto & usage = mUsage[word];
-        auto value   = usage.load(std::memory_order_relaxed);
-        for (size_t offset = 0; offset < kBitChunkSize && offset + word * kBitChunkSize < Capacity(); ++offset)
+        const size_t word = (start + i < words) ? start + i : start + i - words;
+        auto & usage      = mUsage[word];
+        auto value        = usage.load(std::memory_order_relaxed);
+        auto available    = ~value & WordMask(word);
+
+        while (available != 0)
         {
-            if ((value & (kBit1 << offset)) == 0)
+            const size_t offset = LowestSetBit(available);
+            if (usage.compare_exchange_weak(value, value | (kBit1 << offset)))
             {
-                if (usage.compare_exchange_strong(value, value | (kBit1 << offset)))
-                {
-                    mAllocated++;
-                    return At(word * kBitChunkSize + offset);
-                }
-                else
-                {
-                    value = usage.load(std::memory_order_relaxed); // if there is a race, update new usage
-                }
+                mAllocated.fetch_add(1, std::memory_order_relaxed);
+                mHint.store(word, std::memory_order_relaxed);
+                return At(word * kBitChunkSize + offset);
             }
+            available = ~value & WordMask(word); // if there is a race, value holds the new usage
         }
     }
     return nullptr;
@@ -70,7 +73,8 @@ void StaticAllocatorBitmap::Deallocate(void * element)
 
     auto value = mUsage[word].fetch_and(~(kBit1 << offset));
     nlASSERT((value & (kBit1 << offset)) != 0); // assert fail when free an unused slot
-    mAllocated--;
+    mAllocated.fetch_sub(1, std::memory_order_relaxed);
+    mHint.store(word, std::memory_order_relaxed);
 }
 
 } // namespace chip
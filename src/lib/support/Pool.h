@@ -23,6 +23,8 @@
 
 #pragma once
 
+#include <support/CHIPMem.h>
+
 #include <array>
 #include <assert.h>
 #include <atomic>
@@ -38,11 +40,11 @@ public:
     StaticAllocatorBase(size_t capacity) : mAllocated(0), mCapacity(capacity) {}
 
     size_t Capacity() const { return mCapacity; }
-    size_t Allocated() const { return mAllocated; }
-    bool Exhausted() const { return mAllocated == mCapacity; }
+    size_t Allocated() const { return mAllocated.load(std::memory_order_relaxed); }
+    bool Exhausted() const { return Allocated() == mCapacity; }
 
 protected:
-    size_t mAllocated;
+    std::atomic<size_t> mAllocated;
     const size_t mCapacity;
 };
 
@@ -63,6 +65,11 @@ public:
     void * Allocate();
     void Deallocate(void * element);
 
+    bool Owns(const void * element) const
+    {
+        return (element >= mElements) && (element < static_cast<const uint8_t *>(mElements) + mElementSize * Capacity());
+    }
+
 protected:
     void * At(size_t index) { return static_cast<uint8_t *>(mElements) + mElementSize * index; }
     size_t IndexOf(void * element)
@@ -75,10 +82,63 @@ protected:
         return index;
     }
 
+    size_t WordCount() const { return (Capacity() + kBitChunkSize - 1) / kBitChunkSize; }
+
+    /// The bits of [word] that map to elements: all of them but in a partial last word.
+    tBitChunkType WordMask(size_t word) const
+    {
+        const size_t remaining = Capacity() - word * kBitChunkSize;
+        return (remaining >= kBitChunkSize) ? ~tBitChunkType(0) : (kBit1 << remaining) - 1;
+    }
+
+    /// Index of the lowest set bit, [value] must not be zero.
+    static size_t LowestSetBit(tBitChunkType value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzl(value));
+#else
+        size_t offset = 0;
+        while ((value & kBit1) == 0)
+        {
+            value >>= 1;
+            offset++;
+        }
+        return offset;
+#endif
+    }
+
+    /**
+     * Calls [f] with the index of every element in use. Words without elements in use cost one load.
+     * [f] may allocate and release elements: elements released before being reached are skipped.
+     */
+    template <typename F>
+    bool ForEachActiveIndex(F f)
+    {
+        for (size_t word = 0; word < WordCount(); ++word)
+        {
+            auto value = mUsage[word].load(std::memory_order_relaxed);
+
+            while (value != 0)
+            {
+                const size_t offset     = LowestSetBit(value);
+                const tBitChunkType bit = kBit1 << offset;
+                value &= value - 1;
+
+                if ((mUsage[word].load(std::memory_order_relaxed) & bit) == 0)
+                    continue;
+
+                if (!f(word * kBitChunkSize + offset))
+                    return false;
+            }
+        }
+        return true;
+    }
+
 private:
     void * mElements;
     const size_t mElementSize;
     std::atomic<tBitChunkType> * mUsage;
+    std::atomic<size_t> mHint; // word most likely to have a free bit: the last one released or allocated from
 };
 
 /**
@@ -129,25 +189,162 @@ public:
     template <typename F>
     bool ForEachActiveObject(F f)
     {
-        for (size_t word = 0; word * kBitChunkSize < Capacity(); ++word)
+        return ForEachActiveIndex([&](size_t index) { return f(static_cast<T *>(At(index))); });
+    }
+
+private:
+    std::atomic<tBitChunkType> mUsage[(N + kBitChunkSize - 1) / kBitChunkSize];
+    alignas(alignof(T)) uint8_t mMemory[N * sizeof(T)];
+};
+
+/**
+ *  @brief
+ *   A BitMapObjectPool that grows when its static capacity runs out.
+ *
+ *   Objects are created in the inline pool first; once it is exhausted, slabs of N more objects
+ *   are allocated with chip::Platform::MemoryAlloc and chained. Slabs are kept until the pool
+ *   is destroyed, so a burst is only paid for once.
+ *
+ *  @tparam     T   a subclass of element to be allocated.
+ *  @tparam     N   a positive integer number of elements in the inline pool and in each slab.
+ */
+template <class T, size_t N>
+class DynamicBitMapObjectPool
+{
+public:
+    DynamicBitMapObjectPool() = default;
+    ~DynamicBitMapObjectPool()
+    {
+        Slab * slab = mSlabs.exchange(nullptr);
+        while (slab != nullptr)
+        {
+            Slab * next = slab->mNext;
+            Platform::Delete(slab);
+            slab = next;
+        }
+    }
+
+    DynamicBitMapObjectPool(const DynamicBitMapObjectPool &) = delete;
+    DynamicBitMapObjectPool & operator=(const DynamicBitMapObjectPool &) = delete;
+
+    /// Number of objects available without allocating a slab.
+    static size_t Size() { return N; }
+
+    size_t Capacity() const
+    {
+        size_t capacity = mPool.Capacity();
+        for (Slab * slab = mSlabs.load(std::memory_order_acquire); slab != nullptr; slab = slab->mNext)
+        {
+            capacity += slab->mPool.Capacity();
+        }
+        return capacity;
+    }
+
+    size_t Allocated() const
+    {
+        size_t allocated = mPool.Allocated();
+        for (Slab * slab = mSlabs.load(std::memory_order_acquire); slab != nullptr; slab = slab->mNext)
         {
-            auto & usage = mUsage[word];
-            auto value   = usage.load(std::memory_order_relaxed);
-            for (size_t offset = 0; offset < kBitChunkSize && offset + word * kBitChunkSize < Capacity(); ++offset)
+            allocated += slab->mPool.Allocated();
+        }
+        return allocated;
+    }
+
+    size_t SlabCount() const
+    {
+        size_t count = 0;
+        for (Slab * slab = mSlabs.load(std::memory_order_acquire); slab != nullptr; slab = slab->mNext)
+        {
+            count++;
+        }
+        return count;
+    }
+
+    template <typename... Args>
+    T * CreateObject(Args &&... args)
+    {
+        T * element = mPool.CreateObject(std::forward<Args>(args)...);
+        if (element != nullptr)
+            return element;
+
+        Slab * head = mSlabs.load(std::memory_order_acquire);
+        for (Slab * slab = head; slab != nullptr; slab = slab->mNext)
+        {
+            element = slab->mPool.CreateObject(std::forward<Args>(args)...);
+            if (element != nullptr)
+                return element;
+        }
+
+        Slab * slab = Platform::New<Slab>();
+        if (slab == nullptr)
+            return nullptr;
+
+        // a slab chained by a concurrent caller is kept as well
+        slab->mNext = head;
+        while (!mSlabs.compare_exchange_weak(slab->mNext, slab, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+
+        return slab->mPool.CreateObject(std::forward<Args>(args)...);
+    }
+
+    void ReleaseObject(T * element)
+    {
+        if (element == nullptr)
+            return;
+
+        if (mPool.Owns(element))
+        {
+            mPool.ReleaseObject(element);
+            return;
+        }
+
+        for (Slab * slab = mSlabs.load(std::memory_order_acquire); slab != nullptr; slab = slab->mNext)
+        {
+            if (slab->mPool.Owns(element))
             {
-                if ((value & (kBit1 << offset)) != 0)
-                {
-                    if (!f(static_cast<T *>(At(word * kBitChunkSize + offset))))
-                        return false;
-                }
+                slab->mPool.ReleaseObject(element);
+                return;
             }
         }
+
+        assert(false); // the element is not from this pool
+    }
+
+    /**
+     * @brief
+     *   Run a functor for each active object in the pool
+     *
+     *  @param     f    The functor of type `bool (*)(T*)`, return false to break the iteration
+     *  @return    bool Returns false if broke during iteration
+     *
+     * caution
+     *   this function is not thread-safe, make sure all usage of the
+     *   pool is protected by a lock, or else avoid using this function
+     */
+    template <typename F>
+    bool ForEachActiveObject(F f)
+    {
+        if (!mPool.ForEachActiveObject(f))
+            return false;
+
+        for (Slab * slab = mSlabs.load(std::memory_order_acquire); slab != nullptr; slab = slab->mNext)
+        {
+            if (!slab->mPool.ForEachActiveObject(f))
+                return false;
+        }
         return true;
     }
 
 private:
-    std::atomic<tBitChunkType> mUsage[(N + kBitChunkSize - 1) / kBitChunkSize];
-    alignas(alignof(T)) uint8_t mMemory[N * sizeof(T)];
+    struct Slab
+    {
+        BitMapObjectPool<T, N> mPool;
+        Slab * mNext = nullptr;
+    };
+
+    BitMapObjectPool<T, N> mPool;
+    std::atomic<Slab *> mSlabs{ nullptr };
 };
 
 } // namespace chip
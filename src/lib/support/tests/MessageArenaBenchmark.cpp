@@ -0,0 +1,214 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Benchmark comparing the transient allocations made while handling
+ *      an inbound message when served by chip::Platform::MemoryAlloc and
+ *      by the per-message arena: heap allocation count and per-message
+ *      latency percentiles.
+ *
+ */
+
+#include <core/CHIPConfig.h>
+#include <support/CHIPMem.h>
+#include <support/CodeUtils.h>
+#include <support/ErrorStr.h>
+#include <support/MessageArena.h>
+#include <support/ReturnMacros.h>
+#include <system/SystemClock.h>
+
+#include <algorithm>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace chip;
+
+namespace {
+
+constexpr uint32_t kDefaultMessages = 200000;
+constexpr uint32_t kBatchSize       = 100; // messages per latency sample, the clock has microsecond resolution
+constexpr size_t kMaxSamples        = 4096;
+
+// Transient allocations of an invoke request: command path, TLV scratch, argument
+// copies, response scratch. The large pattern adds a buffer that does not fit a
+// default size arena.
+constexpr size_t kSmallPattern[] = { 48, 128, 24, 256, 64, 32 };
+constexpr size_t kLargePattern[] = { 48, 128, 24, 256, 64, 32, 2048 };
+
+struct Pattern
+{
+    const char * label;
+    const size_t * sizes;
+    size_t count;
+};
+
+const Pattern kPatterns[] = {
+    { "invoke", kSmallPattern, sizeof(kSmallPattern) / sizeof(kSmallPattern[0]) },
+    { "invoke + large", kLargePattern, sizeof(kLargePattern) / sizeof(kLargePattern[0]) },
+};
+
+struct Result
+{
+    uint64_t heapAllocations;
+    uint64_t samples[kMaxSamples];
+    size_t sampleCount;
+};
+
+/// Simulates the handling of one message: allocates every buffer of the pattern, touches it and
+/// releases it, partly out of order as handlers do.
+template <typename AllocFn, typename FreeFn>
+CHIP_ERROR HandleMessage(const Pattern & pattern, AllocFn alloc, FreeFn release)
+{
+    void * buffers[sizeof(kLargePattern) / sizeof(kLargePattern[0])];
+
+    for (size_t i = 0; i < pattern.count; i++)
+    {
+        buffers[i] = alloc(pattern.sizes[i]);
+        VerifyOrReturnError(buffers[i] != nullptr, CHIP_ERROR_NO_MEMORY);
+        memset(buffers[i], static_cast<int>(i), pattern.sizes[i]);
+    }
+
+    // scratch buffers are released early, the rest when the handler returns
+    release(buffers[1]);
+    for (size_t i = pattern.count; i > 0; i--)
+    {
+        if (i - 1 != 1)
+        {
+            release(buffers[i - 1]);
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+uint64_t Percentile(Result & result, unsigned percent)
+{
+    if (result.sampleCount == 0)
+    {
+        return 0;
+    }
+
+    std::sort(result.samples, result.samples + result.sampleCount);
+    return result.samples[(result.sampleCount - 1) * percent / 100];
+}
+
+void PrintResult(const char * label, const char * mode, uint32_t messages, Result & result)
+{
+    // samples are microseconds per batch: report nanoseconds per message
+    const uint64_t p50 = Percentile(result, 50) * 1000 / kBatchSize;
+    const uint64_t p99 = Percentile(result, 99) * 1000 / kBatchSize;
+
+    printf("%-16s %-6s %8" PRIu32 " messages: %10" PRIu64 " heap allocations, p50 %6" PRIu64 " ns, p99 %6" PRIu64
+           " ns per message\n",
+           label, mode, messages, result.heapAllocations, p50, p99);
+}
+
+template <typename AllocFn, typename FreeFn, typename ScopeFn>
+CHIP_ERROR Run(const Pattern & pattern, uint32_t messages, Result & result, AllocFn alloc, FreeFn release, ScopeFn scope)
+{
+    size_t batch = 0;
+
+    for (uint32_t done = 0; done < messages; done += kBatchSize, batch++)
+    {
+        uint64_t start = System::Platform::Layer::GetClock_MonotonicHiRes();
+
+        for (uint32_t i = 0; i < kBatchSize; i++)
+        {
+            ReturnErrorOnFailure(scope([&]() { return HandleMessage(pattern, alloc, release); }));
+        }
+
+        // keep the most recent samples
+        result.samples[batch % kMaxSamples] = System::Platform::Layer::GetClock_MonotonicHiRes() - start;
+    }
+
+    result.sampleCount = std::min(batch, kMaxSamples);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR RunHeap(const Pattern & pattern, uint32_t messages)
+{
+    Result result = {};
+
+    ReturnErrorOnFailure(Run(
+        pattern, messages, result,
+        [&](size_t size) {
+            result.heapAllocations++;
+            return Platform::MemoryAlloc(size);
+        },
+        [](void * ptr) { Platform::MemoryFree(ptr); }, [](auto handle) { return handle(); }));
+
+    PrintResult(pattern.label, "heap", messages, result);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR RunArena(const Pattern & pattern, uint32_t messages)
+{
+    Result result = {};
+    Platform::MessageArenaStorage<CHIP_CONFIG_MESSAGE_ARENA_SIZE> arena;
+
+    ReturnErrorOnFailure(Run(
+        pattern, messages, result, [](size_t size) { return Platform::MessageArenaAlloc(size); },
+        [](void * ptr) { Platform::MessageArenaFree(ptr); },
+        [&](auto handle) {
+            Platform::ScopedMessageArena scope(arena);
+            return handle();
+        }));
+
+    result.heapAllocations = arena.GetStats().fallbacks;
+    PrintResult(pattern.label, "arena", messages, result);
+    return CHIP_NO_ERROR;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    CHIP_ERROR err    = CHIP_NO_ERROR;
+    uint32_t messages = kDefaultMessages;
+
+    if (argc > 1)
+    {
+        messages = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    }
+
+    err = Platform::MemoryInit();
+    SuccessOrExit(err);
+
+    for (const Pattern & pattern : kPatterns)
+    {
+        err = RunHeap(pattern, messages);
+        SuccessOrExit(err);
+
+        err = RunArena(pattern, messages);
+        SuccessOrExit(err);
+    }
+
+exit:
+    Platform::MemoryShutdown();
+
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Message arena benchmark failed: %s\n", ErrorStr(err));
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -34,6 +34,10 @@
 #include <support/CodeUtils.h>
 #include <support/UnitTestRegistration.h>
 
+#if CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+#include <thread>
+#endif
+
 using namespace chip;
 using namespace chip::Logging;
 using namespace chip::Platform;
@@ -95,12 +99,122 @@ static void TestMemAlloc_Realloc(nlTestSuite * inSuite, void * inContext)
     chip::Platform::MemoryFree(pb);
 }
 
+#if CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+
+static void TestMemAlloc_SizeClassStats(nlTestSuite * inSuite, void * inContext)
+{
+    MemoryStats before;
+    MemoryStats stats;
+
+    MemoryGetStats(before);
+
+    void * small = MemoryAlloc(40);
+    void * large = MemoryAlloc(8192);
+    NL_TEST_ASSERT(inSuite, small != nullptr && large != nullptr);
+    NL_TEST_ASSERT(inSuite, MemoryInternalCheckPointer(small, 40) && !MemoryInternalCheckPointer(small, 41));
+
+    MemoryGetStats(stats);
+    NL_TEST_ASSERT(inSuite, stats.allocationsInUse == before.allocationsInUse + 2);
+    NL_TEST_ASSERT(inSuite, stats.bytesInUse == before.bytesInUse + 40 + 8192);
+    NL_TEST_ASSERT(inSuite, stats.bytesInUseHighWatermark >= stats.bytesInUse);
+    NL_TEST_ASSERT(inSuite, stats.bytesReserved >= before.bytesReserved + 8192);
+    NL_TEST_ASSERT(inSuite, stats.FragmentationPercent() < 100);
+
+    // growing within the size class keeps the block
+    NL_TEST_ASSERT(inSuite, MemoryRealloc(small, 48) == small);
+
+    MemoryFree(small);
+    MemoryFree(large);
+
+    MemoryGetStats(stats);
+    NL_TEST_ASSERT(inSuite, stats.allocationsInUse == before.allocationsInUse);
+    NL_TEST_ASSERT(inSuite, stats.bytesInUse == before.bytesInUse);
+    NL_TEST_ASSERT(inSuite, stats.bytesInUseHighWatermark >= before.bytesInUse + 40 + 8192);
+}
+
+static void TestMemAlloc_SizeClassReuse(nlTestSuite * inSuite, void * inContext)
+{
+    // a freed block is the next one handed out for its class
+    void * p1 = MemoryAlloc(100);
+    MemoryFree(p1);
+    void * p2 = MemoryAlloc(120);
+    NL_TEST_ASSERT(inSuite, p1 == p2);
+    MemoryFree(p2);
+
+    // more blocks than a cache holds go through the shared free list
+    constexpr size_t kCount = CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CACHE_BLOCKS * 4;
+    void * blocks[kCount];
+    for (size_t i = 0; i < kCount; i++)
+    {
+        blocks[i] = MemoryAlloc(64);
+        NL_TEST_ASSERT(inSuite, blocks[i] != nullptr);
+        memset(blocks[i], static_cast<int>(i), 64);
+    }
+    for (size_t i = 0; i < kCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, static_cast<uint8_t *>(blocks[i])[63] == static_cast<uint8_t>(i));
+        MemoryFree(blocks[i]);
+    }
+}
+
+static void TestMemAlloc_SizeClassCrossThreadFree(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kCount = CHIP_CONFIG_SIZE_CLASS_ALLOCATOR_CACHE_BLOCKS * 2;
+    void * blocks[kCount];
+    MemoryStats before;
+    MemoryStats stats;
+
+    MemoryGetStats(before);
+
+    for (size_t i = 0; i < kCount; i++)
+    {
+        blocks[i] = MemoryAlloc(256);
+    }
+    MemoryGetStats(stats);
+    const size_t reserved = stats.bytesReserved;
+
+    // freed by another thread, the blocks are given back to the shared free list when it exits
+    std::thread releaser([&]() {
+        for (void * block : blocks)
+        {
+            MemoryFree(block);
+        }
+    });
+    releaser.join();
+
+    MemoryGetStats(stats);
+    NL_TEST_ASSERT(inSuite, stats.allocationsInUse == before.allocationsInUse);
+    NL_TEST_ASSERT(inSuite, stats.bytesInUse == before.bytesInUse);
+
+    for (size_t i = 0; i < kCount; i++)
+    {
+        blocks[i] = MemoryAlloc(256);
+        NL_TEST_ASSERT(inSuite, blocks[i] != nullptr);
+    }
+    for (void * block : blocks)
+    {
+        MemoryFree(block);
+    }
+
+    // served from the blocks given back, without new chunks
+    MemoryGetStats(stats);
+    NL_TEST_ASSERT(inSuite, stats.bytesReserved == reserved);
+}
+
+#endif // CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+
 /**
  *   Test Suite. It lists all the test functions.
  */
 static const nlTest sTests[] = { NL_TEST_DEF("Test MemAlloc::Malloc", TestMemAlloc_Malloc),
                                  NL_TEST_DEF("Test MemAlloc::Calloc", TestMemAlloc_Calloc),
-                                 NL_TEST_DEF("Test MemAlloc::Realloc", TestMemAlloc_Realloc), NL_TEST_SENTINEL() };
+                                 NL_TEST_DEF("Test MemAlloc::Realloc", TestMemAlloc_Realloc),
+#if CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+                                 NL_TEST_DEF("Test MemAlloc::SizeClassStats", TestMemAlloc_SizeClassStats),
+                                 NL_TEST_DEF("Test MemAlloc::SizeClassReuse", TestMemAlloc_SizeClassReuse),
+                                 NL_TEST_DEF("Test MemAlloc::SizeClassCrossThreadFree", TestMemAlloc_SizeClassCrossThreadFree),
+#endif // CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+                                 NL_TEST_SENTINEL() };
 
 /**
  *  Set up the test suite.
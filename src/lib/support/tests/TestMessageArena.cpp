@@ -0,0 +1,187 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the per-message arena.
+ *
+ */
+
+#include <support/MessageArena.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+#include <stdint.h>
+#include <string.h>
+
+using namespace chip::Platform;
+
+namespace {
+
+constexpr size_t kArenaSize = 256;
+
+bool IsAligned(const void * ptr)
+{
+    return (reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t)) == 0;
+}
+
+void TestAlloc(nlTestSuite * inSuite, void * inContext)
+{
+    MessageArenaStorage<kArenaSize> arena;
+
+    void * first  = arena.Alloc(3);
+    void * second = arena.Alloc(17);
+
+    NL_TEST_ASSERT(inSuite, first != nullptr && second != nullptr);
+    NL_TEST_ASSERT(inSuite, IsAligned(first) && IsAligned(second));
+    NL_TEST_ASSERT(inSuite, arena.Owns(first) && arena.Owns(second));
+    NL_TEST_ASSERT(inSuite, static_cast<uint8_t *>(second) >= static_cast<uint8_t *>(first) + 3);
+
+    // only the most recent allocation is given back
+    const size_t used = arena.GetUsed();
+    arena.Free(first);
+    NL_TEST_ASSERT(inSuite, arena.GetUsed() == used);
+    arena.Free(second);
+    NL_TEST_ASSERT(inSuite, arena.GetUsed() < used);
+    NL_TEST_ASSERT(inSuite, arena.Alloc(17) == second);
+
+    NL_TEST_ASSERT(inSuite, arena.Alloc(kArenaSize) == nullptr);
+    NL_TEST_ASSERT(inSuite, arena.Alloc(0) == nullptr);
+
+    arena.Reset();
+    NL_TEST_ASSERT(inSuite, arena.GetUsed() == 0);
+    NL_TEST_ASSERT(inSuite, arena.Alloc(kArenaSize) == first);
+    NL_TEST_ASSERT(inSuite, arena.GetStats().highWatermark == kArenaSize);
+}
+
+void TestScope(nlTestSuite * inSuite, void * inContext)
+{
+    MessageArenaStorage<kArenaSize> arena;
+    MessageArenaStorage<kArenaSize> nested;
+
+    NL_TEST_ASSERT(inSuite, MessageArena::GetCurrent() == nullptr);
+
+    {
+        ScopedMessageArena scope(arena);
+        NL_TEST_ASSERT(inSuite, MessageArena::GetCurrent() == &arena);
+
+        void * ptr = MessageArenaAlloc(32);
+        NL_TEST_ASSERT(inSuite, arena.Owns(ptr));
+
+        {
+            // messages handled from within a handler keep using the outer arena
+            ScopedMessageArena nestedScope(nested);
+            NL_TEST_ASSERT(inSuite, MessageArena::GetCurrent() == &arena);
+            NL_TEST_ASSERT(inSuite, arena.Owns(MessageArenaAlloc(32)));
+        }
+
+        NL_TEST_ASSERT(inSuite, MessageArena::GetCurrent() == &arena);
+        NL_TEST_ASSERT(inSuite, arena.GetUsed() != 0);
+    }
+
+    NL_TEST_ASSERT(inSuite, MessageArena::GetCurrent() == nullptr);
+    NL_TEST_ASSERT(inSuite, arena.GetUsed() == 0);
+    NL_TEST_ASSERT(inSuite, arena.GetStats().allocations == 2);
+}
+
+void TestFallback(nlTestSuite * inSuite, void * inContext)
+{
+    MessageArenaStorage<kArenaSize> arena;
+
+    // no active arena: heap memory
+    void * heap = MessageArenaAlloc(16);
+    NL_TEST_ASSERT(inSuite, heap != nullptr && MessageArena::FindOwner(heap) == nullptr);
+    MessageArenaFree(heap);
+
+    {
+        ScopedMessageArena scope(arena);
+
+        void * inArena = MessageArenaAlloc(kArenaSize / 2);
+        void * tooBig  = MessageArenaAlloc(kArenaSize);
+
+        NL_TEST_ASSERT(inSuite, MessageArena::FindOwner(inArena) == &arena);
+        NL_TEST_ASSERT(inSuite, tooBig != nullptr && MessageArena::FindOwner(tooBig) == nullptr);
+        NL_TEST_ASSERT(inSuite, arena.GetStats().fallbacks == 1);
+
+        MessageArenaFree(tooBig);
+        MessageArenaFree(inArena);
+        NL_TEST_ASSERT(inSuite, arena.GetUsed() == 0);
+
+        // late release of arena memory is harmless
+        inArena = MessageArenaAlloc(8);
+        arena.Reset();
+        MessageArenaFree(inArena);
+    }
+}
+
+void TestScopedArenaBuffer(nlTestSuite * inSuite, void * inContext)
+{
+    MessageArenaStorage<kArenaSize> arena;
+    ScopedMessageArena scope(arena);
+
+    {
+        ScopedArenaBuffer<uint32_t> buffer;
+
+        NL_TEST_ASSERT(inSuite, buffer.Calloc(8));
+        NL_TEST_ASSERT(inSuite, arena.Owns(buffer.Get()));
+        for (size_t i = 0; i < 8; i++)
+        {
+            NL_TEST_ASSERT(inSuite, buffer[i] == 0);
+        }
+
+        // long term allocations never come from the arena
+        ScopedArenaBuffer<uint8_t> longTerm;
+        NL_TEST_ASSERT(inSuite, longTerm.LongTermAlloc(8));
+        NL_TEST_ASSERT(inSuite, !arena.Owns(longTerm.Get()));
+    }
+
+    NL_TEST_ASSERT(inSuite, arena.GetUsed() == 0);
+}
+
+int Setup(void * inContext)
+{
+    CHIP_ERROR error = chip::Platform::MemoryInit();
+    if (error != CHIP_NO_ERROR)
+        return FAILURE;
+    return SUCCESS;
+}
+
+int Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestAlloc", TestAlloc),                         //
+    NL_TEST_DEF("TestScope", TestScope),                         //
+    NL_TEST_DEF("TestFallback", TestFallback),                   //
+    NL_TEST_DEF("TestScopedArenaBuffer", TestScopedArenaBuffer), //
+    NL_TEST_SENTINEL()                                           //
+};
+
+} // namespace
+
+int TestMessageArena(void)
+{
+    nlTestSuite theSuite = { "MessageArena", sTests, Setup, Teardown };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestMessageArena)
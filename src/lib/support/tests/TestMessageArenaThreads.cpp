@@ -0,0 +1,86 @@
+/*
+ *
+ *    Copyright (c) 2021 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the per-message arena
+ *      when used from several threads. It needs std::thread, so it is
+ *      only built for hosts.
+ *
+ */
+
+#include <support/MessageArena.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+#include <thread>
+
+using namespace chip::Platform;
+
+namespace {
+
+constexpr size_t kArenaSize = 256;
+
+void TestOtherThreads(nlTestSuite * inSuite, void * inContext)
+{
+    MessageArenaStorage<kArenaSize> arena;
+    ScopedMessageArena scope(arena);
+
+    // the arena only serves the thread handling the message
+    std::thread other([&]() {
+        NL_TEST_ASSERT(inSuite, MessageArena::GetCurrent() == nullptr);
+
+        void * ptr = MessageArenaAlloc(16);
+        NL_TEST_ASSERT(inSuite, ptr != nullptr && MessageArena::FindOwner(ptr) == nullptr);
+        MessageArenaFree(ptr);
+    });
+    other.join();
+
+    NL_TEST_ASSERT(inSuite, MessageArena::GetCurrent() == &arena);
+    NL_TEST_ASSERT(inSuite, arena.GetUsed() == 0);
+}
+
+int Setup(void * inContext)
+{
+    CHIP_ERROR error = chip::Platform::MemoryInit();
+    if (error != CHIP_NO_ERROR)
+        return FAILURE;
+    return SUCCESS;
+}
+
+int Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("TestOtherThreads", TestOtherThreads), //
+    NL_TEST_SENTINEL()                                 //
+};
+
+} // namespace
+
+int TestMessageArenaThreads(void)
+{
+    nlTestSuite theSuite = { "MessageArenaThreads", sTests, Setup, Teardown };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestMessageArenaThreads)
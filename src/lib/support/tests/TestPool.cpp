@@ -25,6 +25,7 @@
 
 #include <set>
 
+#include <support/CHIPMem.h>
 #include <support/Pool.h>
 #include <support/UnitTestRegistration.h>
 
@@ -32,8 +33,8 @@
 
 namespace chip {
 
-template <class T, size_t N>
-size_t GetNumObjectsInUse(BitMapObjectPool<T, N> & pool)
+template <class Pool>
+size_t GetNumObjectsInUse(Pool & pool)
 {
     size_t count = 0;
     pool.ForEachActiveObject([&count](void *) {
@@ -129,13 +130,165 @@ void TestCreateReleaseStruct(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+void TestHintAfterRelease(nlTestSuite * inSuite, void * inContext)
+{
+    // spans several bitmap words and ends in a partial one
+    constexpr const size_t size = 200;
+    BitMapObjectPool<uint32_t, size> pool;
+    uint32_t * obj[size];
+    for (size_t i = 0; i < size; ++i)
+    {
+        obj[i] = pool.CreateObject(static_cast<uint32_t>(i));
+        NL_TEST_ASSERT(inSuite, obj[i] != nullptr);
+    }
+    NL_TEST_ASSERT(inSuite, pool.CreateObject() == nullptr);
+
+    // released slots are found again wherever they are
+    const size_t released[] = { 3, 130, 199 };
+    for (size_t index : released)
+    {
+        pool.ReleaseObject(obj[index]);
+    }
+    for (size_t i = 0; i < sizeof(released) / sizeof(released[0]); ++i)
+    {
+        uint32_t * again = pool.CreateObject();
+        NL_TEST_ASSERT(inSuite, again == obj[3] || again == obj[130] || again == obj[199]);
+    }
+    NL_TEST_ASSERT(inSuite, pool.CreateObject() == nullptr);
+    NL_TEST_ASSERT(inSuite, pool.Allocated() == size);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        pool.ReleaseObject(obj[i]);
+    }
+    NL_TEST_ASSERT(inSuite, pool.Allocated() == 0);
+}
+
+void TestForEachActiveObject(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr const size_t size = 200;
+    BitMapObjectPool<uint32_t, size> pool;
+    uint32_t * obj[size];
+    for (size_t i = 0; i < size; ++i)
+    {
+        obj[i] = pool.CreateObject(static_cast<uint32_t>(i));
+    }
+
+    // leave a few objects, including whole empty words between them
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (i != 1 && i != 150 && i != 199)
+        {
+            pool.ReleaseObject(obj[i]);
+        }
+    }
+
+    uint32_t sum = 0;
+    NL_TEST_ASSERT(inSuite, pool.ForEachActiveObject([&](uint32_t * value) {
+        sum += *value;
+        return true;
+    }));
+    NL_TEST_ASSERT(inSuite, sum == 1 + 150 + 199);
+
+    // objects may be released while iterating, ones not reached yet are skipped
+    size_t visited = 0;
+    NL_TEST_ASSERT(inSuite, pool.ForEachActiveObject([&](uint32_t * value) {
+        if (*value == 1)
+        {
+            pool.ReleaseObject(obj[150]);
+        }
+        pool.ReleaseObject(value);
+        visited++;
+        return true;
+    }));
+    NL_TEST_ASSERT(inSuite, visited == 2);
+    NL_TEST_ASSERT(inSuite, pool.Allocated() == 0);
+    NL_TEST_ASSERT(inSuite, GetNumObjectsInUse(pool) == 0);
+}
+
+void TestForEachActiveObjectAllocating(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr const size_t size = 200;
+    BitMapObjectPool<uint32_t, size> pool;
+    uint32_t * obj[size];
+    for (size_t i = 0; i < size; ++i)
+    {
+        obj[i] = pool.CreateObject(static_cast<uint32_t>(i));
+    }
+
+    // keep 1, 150 and 199; releasing 151 last makes its word the next one allocated from
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (i != 1 && i != 150 && i != 151 && i != 199)
+        {
+            pool.ReleaseObject(obj[i]);
+        }
+    }
+    pool.ReleaseObject(obj[151]);
+
+    // objects allocated while iterating do not end the iteration early
+    uint32_t * created = nullptr;
+    bool visitedLast   = false;
+    NL_TEST_ASSERT(inSuite, pool.ForEachActiveObject([&](uint32_t * value) {
+        if (created == nullptr)
+        {
+            created = pool.CreateObject(static_cast<uint32_t>(size));
+        }
+        visitedLast = visitedLast || (value == obj[199]);
+        return true;
+    }));
+    NL_TEST_ASSERT(inSuite, created != nullptr);
+    NL_TEST_ASSERT(inSuite, visitedLast);
+
+    pool.ReleaseObject(created);
+    pool.ReleaseObject(obj[1]);
+    pool.ReleaseObject(obj[150]);
+    pool.ReleaseObject(obj[199]);
+    NL_TEST_ASSERT(inSuite, pool.Allocated() == 0);
+}
+
+void TestDynamicPool(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr const size_t size = 10;
+    DynamicBitMapObjectPool<uint32_t, size> pool;
+    uint32_t * obj[size * 3];
+
+    for (size_t i = 0; i < size * 3; ++i)
+    {
+        obj[i] = pool.CreateObject(static_cast<uint32_t>(i));
+        NL_TEST_ASSERT(inSuite, obj[i] != nullptr);
+    }
+    NL_TEST_ASSERT(inSuite, pool.SlabCount() == 2);
+    NL_TEST_ASSERT(inSuite, pool.Capacity() == size * 3);
+    NL_TEST_ASSERT(inSuite, pool.Allocated() == size * 3);
+    NL_TEST_ASSERT(inSuite, GetNumObjectsInUse(pool) == size * 3);
+
+    // slabs are kept and reused
+    pool.ReleaseObject(obj[25]);
+    pool.ReleaseObject(obj[2]);
+    NL_TEST_ASSERT(inSuite, pool.CreateObject() == obj[2]);
+    NL_TEST_ASSERT(inSuite, pool.CreateObject() == obj[25]);
+    NL_TEST_ASSERT(inSuite, pool.SlabCount() == 2);
+
+    size_t visited = 0;
+    NL_TEST_ASSERT(inSuite, !pool.ForEachActiveObject([&](uint32_t *) { return ++visited < size + 1; }));
+    NL_TEST_ASSERT(inSuite, visited == size + 1);
+
+    for (size_t i = 0; i < size * 3; ++i)
+    {
+        pool.ReleaseObject(obj[i]);
+    }
+    NL_TEST_ASSERT(inSuite, pool.Allocated() == 0);
+}
+
 int Setup(void * inContext)
 {
-    return SUCCESS;
+    return (chip::Platform::MemoryInit() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
 }
 
 int Teardown(void * inContext)
 {
+    chip::Platform::MemoryShutdown();
     return SUCCESS;
 }
 
@@ -145,8 +298,10 @@ int Teardown(void * inContext)
 /**
  *   Test Suite. It lists all the test functions.
  */
-static const nlTest sTests[] = { NL_TEST_DEF_FN(TestReleaseNull), NL_TEST_DEF_FN(TestCreateReleaseObject),
-                                 NL_TEST_DEF_FN(TestCreateReleaseStruct), NL_TEST_SENTINEL() };
+static const nlTest sTests[] = { NL_TEST_DEF_FN(TestReleaseNull),         NL_TEST_DEF_FN(TestCreateReleaseObject),
+                                 NL_TEST_DEF_FN(TestCreateReleaseStruct), NL_TEST_DEF_FN(TestHintAfterRelease),
+                                 NL_TEST_DEF_FN(TestForEachActiveObject), NL_TEST_DEF_FN(TestForEachActiveObjectAllocating),
+                                 NL_TEST_DEF_FN(TestDynamicPool),         NL_TEST_SENTINEL() };
 
 int TestPool()
 {
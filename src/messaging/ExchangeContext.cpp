@@ -76,6 +76,21 @@ void ExchangeContext::SetResponseTimeout(Timeout timeout)
     mResponseTimeout = timeout;
 }
 
+CHIP_ERROR ExchangeContext::ExpectResponse()
+{
+    VerifyOrReturnError(mExchangeMgr != nullptr, CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(!IsResponseExpected(), CHIP_ERROR_INCORRECT_STATE);
+
+    // Arm the response timer if a timeout has been specified.
+    if (mResponseTimeout > 0)
+    {
+        ReturnErrorOnFailure(StartResponseTimer());
+    }
+    SetResponseExpected(true);
+
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR ExchangeContext::SendMessage(uint16_t protocolId, uint8_t msgType, PacketBufferHandle msgBuf,
                                         const SendFlags & sendFlags)
 {
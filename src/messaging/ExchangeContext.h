@@ -185,6 +185,15 @@ public:
 
     void SetResponseTimeout(Timeout timeout);
 
+    /**
+     *  Wait for another message from the peer without sending one, e.g. for the next chunk of a
+     *  chunked response. The response timeout is armed as for a message sent with kExpectResponse.
+     *
+     *  @retval  #CHIP_ERROR_INCORRECT_STATE                if a response is already expected.
+     *  @retval  #CHIP_NO_ERROR                             if the response is now expected.
+     */
+    CHIP_ERROR ExpectResponse();
+
 private:
     enum class ExFlagValues : uint16_t
     {
@@ -233,6 +233,9 @@ void ExchangeManager::OnMessageReceived(const PacketHeader & packetHeader, const
     UnsolicitedMessageHandler * matchingUMH = nullptr;
     bool sendAckAndCloseExchange            = false;
 
+    // Transient allocations made by the handlers of this message are released all at once on return
+    Platform::ScopedMessageArena messageArena(mMessageArena);
+
     if (!IsMsgCounterSyncMessage(payloadHeader) && packetHeader.IsPeerGroupMsgIdNotSynchronized())
     {
         Transport::PeerConnectionState * state = mSessionMgr->GetPeerConnectionState(session);
@@ -421,6 +424,8 @@ void ExchangeManager::OnConnectionExpired(SecureSessionHandle session, SecureSes
 void ExchangeManager::OnMessageReceived(const PacketHeader & header, const Transport::PeerAddress & source,
                                         System::PacketBufferHandle msgBuf)
 {
+    Platform::ScopedMessageArena messageArena(mMessageArena);
+
     auto peer = header.GetSourceNodeId();
     if (!peer.HasValue())
     {
@@ -338,6 +338,19 @@ bool ReliableMessageMgr::CheckAndRemRetransTable(ReliableMessageContext * rc, ui
     return false;
 }
 
+bool ReliableMessageMgr::HasRetransEntries(const ReliableMessageContext * rc) const
+{
+    for (const RetransTableEntry & entry : mRetransTable)
+    {
+        if (entry.rc == rc)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 CHIP_ERROR ReliableMessageMgr::SendFromRetransTable(RetransTableEntry * entry)
 {
     CHIP_ERROR err              = CHIP_NO_ERROR;
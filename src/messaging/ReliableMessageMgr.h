@@ -157,6 +157,15 @@ public:
      */
     bool CheckAndRemRetransTable(ReliableMessageContext * rc, uint32_t msgId);
 
+    /**
+     *  Check whether messages sent on the specified ExchangeContext are waiting for an acknowledgment.
+     *
+     *  @param[in]    rc        A pointer to the ExchangeContext object.
+     *
+     *  @retval  true if the retransmission table holds a message of the ExchangeContext.
+     */
+    bool HasRetransEntries(const ReliableMessageContext * rc) const;
+
     /**
      *  Send the specified entry from the retransmission table.
      *
@@ -133,10 +133,13 @@ void CheckAddClearRetrans(nlTestSuite * inSuite, void * inContext)
 
     ReliableMessageMgr::RetransTableEntry * entry;
 
+    NL_TEST_ASSERT(inSuite, !rm->HasRetransEntries(rc));
     rm->AddToRetransTable(rc, &entry);
     NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == 1);
+    NL_TEST_ASSERT(inSuite, rm->HasRetransEntries(rc));
     rm->ClearRetransTable(*entry);
     NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == 0);
+    NL_TEST_ASSERT(inSuite, !rm->HasRetransEntries(rc));
 }
 
 void CheckFailRetrans(nlTestSuite * inSuite, void * inContext)
@@ -91,6 +91,10 @@ void UpdateSnapshot(Snapshot & aSnapshot)
                                        aSnapshot.mHighWatermarks[kSystemLayer_NumTimers]);
 
     SYSTEM_STATS_UPDATE_LWIP_PBUF_COUNTS();
+
+#if CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+    chip::Platform::MemoryGetStats(aSnapshot.mHeap);
+#endif // CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
 }
 
 bool Difference(Snapshot & result, Snapshot & after, Snapshot & before)
@@ -36,6 +36,10 @@
 // Include dependent headers
 #include <support/DLLUtil.h>
 
+#if CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+#include <support/CHIPMem.h>
+#endif // CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
 #include <lwip/mem.h>
 #include <lwip/opt.h>
@@ -89,6 +93,10 @@ class Snapshot
 public:
     count_t mResourcesInUse[kNumEntries];
     count_t mHighWatermarks[kNumEntries];
+#if CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
+    // Byte counts do not fit count_t; the heap is reported separately.
+    chip::Platform::MemoryStats mHeap;
+#endif // CHIP_CONFIG_MEMORY_MGMT_SIZE_CLASS
 };
 
 bool Difference(Snapshot & result, Snapshot & after, Snapshot & before);